@@ -236,6 +236,11 @@ void ezResource::SetPriority(ezResourcePriority priority)
 
   m_Priority = priority;
 
+  if (ezResourceManager::IsQueuedForLoading(this))
+  {
+    ezResourceManager::UpdateLoadingPriority(this);
+  }
+
   ezResourceEvent e;
   e.m_pResource = this;
   e.m_Type = ezResourceEvent::Type::ResourcePriorityChanged;
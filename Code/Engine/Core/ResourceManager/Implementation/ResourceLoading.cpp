@@ -34,15 +34,17 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
   // if we are already loading this resource, early out
   if (IsQueuedForLoading(pResource))
   {
-    // however, if it now has highest priority and is still in the loading queue (so not yet started)
-    // move it to the front of the queue
+    // however, if it is still in the loading queue (so not yet started), move it to the position that matches its current priority,
+    // the resource was just requested, so it is more urgent now than when it was queued
+    // if it is not in the queue anymore, it has already been started by some thread
     if (bHighestPriority)
     {
-      // if it is not in the queue anymore, it has already been started by some thread
-      if (RemoveFromLoadingQueue(pResource).Succeeded())
-      {
-        AddToLoadingQueue(pResource, bHighestPriority);
-      }
+      pResource->SetPriority(ezResourcePriority::Critical);
+      s_State->s_LoadingQueue.UpdatePriority(pResource, 0.0f);
+    }
+    else
+    {
+      s_State->s_LoadingQueue.UpdatePriority(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate));
     }
 
     return;
@@ -53,7 +55,13 @@ void ezResourceManager::InternalPreloadResource(ezResource* pResource, bool bHig
 
     if (bHighestPriority && ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      // this thread is going to wait for the resource and might block one of the data load tasks in flight,
+      // so launch an additional one, even if that exceeds the limit
+      if (!s_State->s_bShutdown)
+      {
+        SetupWorkerTasks();
+        LaunchDataLoadTask();
+      }
     }
 
     RunWorkerTask(pResource);
@@ -68,7 +76,7 @@ void ezResourceManager::SetupWorkerTasks()
     ezStringBuilder s;
 
     {
-      static const ezUInt32 InitialDataLoadTasks = 4;
+      static const ezUInt32 InitialDataLoadTasks = 16;
 
       for (ezUInt32 i = 0; i < InitialDataLoadTasks; ++i)
       {
@@ -84,10 +92,7 @@ void ezResourceManager::SetupWorkerTasks()
 
       for (ezUInt32 i = 0; i < InitialUpdateContentTasks; ++i)
       {
-        s.Format("Resource Content Updater {0}", i);
-        auto& data = s_State->s_WorkerTasksUpdateContent.ExpandAndGetRef();
-        data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerUpdateContent);
-        data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+        s_State->s_WorkerTasksUpdateContent.ExpandAndGetRef().CreateTasks(i);
       }
     }
   }
@@ -102,52 +107,67 @@ void ezResourceManager::RunWorkerTask(ezResource* pResource)
 
   SetupWorkerTasks();
 
-  if (s_State->s_bAllowLaunchDataLoadTask && !s_State->s_LoadingQueue.IsEmpty())
-  {
-    s_State->s_bAllowLaunchDataLoadTask = false;
+  const ezUInt32 uiMaxTasks = s_State->s_uiMaxConcurrentDataLoads;
 
-    for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
-    {
-      if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
-      {
-        s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask.Borrow(), ezTaskPriority::FileAccess);
-        return;
-      }
-    }
+  // every task picks the most important resource from the queue once it runs, so there is no point in launching more tasks than
+  // there are queued resources
+  ezUInt32 uiTasksToLaunch = s_State->s_LoadingQueue.GetCount();
 
-    // could not find any unused task -> need to create a new one
-    {
-      ezStringBuilder s;
-      s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
-      auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
-      data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
-      data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
-      data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask.Borrow(), ezTaskPriority::FileAccess);
-    }
+  while (uiTasksToLaunch > 0 && s_State->s_uiDataLoadTasksInFlight < uiMaxTasks)
+  {
+    LaunchDataLoadTask();
+    --uiTasksToLaunch;
   }
 }
 
-void ezResourceManager::ReverseBubbleSortStep(ezDeque<LoadingInfo>& data)
+void ezResourceManager::LaunchDataLoadTask()
 {
-  // Yep, it's really bubble sort!
-  // This will move the entry with the smallest value to the front and move all other values closer to their correct position,
-  // which is exactly what we need for the priority queue.
-  // We do this once a frame, which gives us nice iterative sorting, with relatively deterministic performance characteristics.
-
   EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
 
-  const ezUInt32 uiCount = data.GetCount();
+  ++s_State->s_uiDataLoadTasksInFlight;
 
-  for (ezUInt32 i = uiCount; i > 1; --i)
+  for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
   {
-    const ezUInt32 idx2 = i - 1;
-    const ezUInt32 idx1 = i - 2;
-
-    if (data[idx1].m_fPriority > data[idx1].m_fPriority)
+    if (s_State->s_WorkerTasksDataLoad[i].m_pTask->IsTaskFinished())
     {
-      ezMath::Swap(data[idx1], data[idx2]);
+      s_State->s_WorkerTasksDataLoad[i].m_GroupId = ezTaskSystem::StartSingleTask(s_State->s_WorkerTasksDataLoad[i].m_pTask.Borrow(), ezTaskPriority::FileAccess);
+      return;
     }
   }
+
+  // could not find any unused task -> need to create a new one
+  {
+    ezStringBuilder s;
+    s.Format("Resource Data Loader {0}", s_State->s_WorkerTasksDataLoad.GetCount());
+    auto& data = s_State->s_WorkerTasksDataLoad.ExpandAndGetRef();
+    data.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDataLoad);
+    data.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+    data.m_GroupId = ezTaskSystem::StartSingleTask(data.m_pTask.Borrow(), ezTaskPriority::FileAccess);
+  }
+}
+
+void ezResourceManager::SetMaxConcurrentDataLoads(ezUInt32 uiMaxTasks)
+{
+  EZ_LOCK(s_ResourceMutex);
+  s_State->s_uiMaxConcurrentDataLoads = ezMath::Max(uiMaxTasks, 1u);
+
+  // if the limit was raised, make use of it right away
+  RunWorkerTask(nullptr);
+}
+
+ezUInt32 ezResourceManager::GetMaxConcurrentDataLoads()
+{
+  return s_State->s_uiMaxConcurrentDataLoads;
+}
+
+ezResourceManager::LoadingStats ezResourceManager::GetLoadingStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  LoadingStats stats = s_State->s_LoadingStats;
+  stats.m_uiNumQueued = s_State->s_LoadingQueue.GetCount();
+  stats.m_uiNumDataLoadsInFlight = s_State->s_uiDataLoadTasksInFlight;
+  return stats;
 }
 
 void ezResourceManager::UpdateLoadingDeadlines()
@@ -159,6 +179,11 @@ void ezResourceManager::UpdateLoadingDeadlines()
 
   EZ_PROFILE_SCOPE("UpdateLoadingDeadlines");
 
+  // The priorities slowly change over time, so they are re-evaluated a few at a time in a round-robin fashion.
+  // Requests that need a resource urgently update its position in the queue directly, see InternalPreloadResource().
+  // Re-positioning an entry in the heap may move other entries across the round-robin index, which means that occasionally
+  // an entry is updated twice or is skipped for one round. That is fine, the next round will catch up.
+
   const ezUInt32 uiCount = s_State->s_LoadingQueue.GetCount();
   s_State->s_uiLastResourcePriorityUpdateIdx = ezMath::Min(s_State->s_uiLastResourcePriorityUpdateIdx, uiCount);
 
@@ -167,29 +192,24 @@ void ezResourceManager::UpdateLoadingDeadlines()
   if (uiUpdateCount == 0)
   {
     s_State->s_uiLastResourcePriorityUpdateIdx = 0;
-    uiUpdateCount = ezMath::Min(50u, uiCount - s_State->s_uiLastResourcePriorityUpdateIdx);
+    uiUpdateCount = ezMath::Min(50u, uiCount);
   }
 
-  if (uiUpdateCount > 0)
-  {
-    {
-      EZ_PROFILE_SCOPE("EvalLoadingDeadlines");
+  const ezTime tNow = ezTime::Now();
 
-      const ezTime tNow = ezTime::Now();
+  for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
+  {
+    ezResource* pResource = s_State->s_LoadingQueue.GetResource(s_State->s_uiLastResourcePriorityUpdateIdx);
+    s_State->s_LoadingQueue.UpdatePriority(pResource, pResource->GetLoadingPriority(tNow));
+    ++s_State->s_uiLastResourcePriorityUpdateIdx;
+  }
+}
 
-      for (ezUInt32 i = 0; i < uiUpdateCount; ++i)
-      {
-        auto& element = s_State->s_LoadingQueue[s_State->s_uiLastResourcePriorityUpdateIdx];
-        element.m_fPriority = element.m_pResource->GetLoadingPriority(tNow);
-        ++s_State->s_uiLastResourcePriorityUpdateIdx;
-      }
-    }
+void ezResourceManager::UpdateLoadingPriority(ezResource* pResource)
+{
+  EZ_LOCK(s_ResourceMutex);
 
-    {
-      EZ_PROFILE_SCOPE("SortLoadingDeadlines");
-      ReverseBubbleSortStep(s_State->s_LoadingQueue);
-    }
-  }
+  s_State->s_LoadingQueue.UpdatePriority(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate));
 }
 
 void ezResourceManager::PreloadResource(ezResource* pResource)
@@ -220,10 +240,7 @@ ezResult ezResourceManager::RemoveFromLoadingQueue(ezResource* pResource)
   if (!IsQueuedForLoading(pResource))
     return EZ_SUCCESS;
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
-  if (s_State->s_LoadingQueue.RemoveAndSwap(li))
+  if (s_State->s_LoadingQueue.Remove(pResource))
   {
     pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     return EZ_SUCCESS;
@@ -239,19 +256,14 @@ void ezResourceManager::AddToLoadingQueue(ezResource* pResource, bool bHighestPr
 
   pResource->m_Flags.Add(ezResourceFlags::IsQueuedForLoading);
 
-  LoadingInfo li;
-  li.m_pResource = pResource;
-
   if (bHighestPriority)
   {
     pResource->SetPriority(ezResourcePriority::Critical);
-    li.m_fPriority = 0.0f;
-    s_State->s_LoadingQueue.PushFront(li);
+    s_State->s_LoadingQueue.Insert(pResource, 0.0f);
   }
   else
   {
-    li.m_fPriority = pResource->GetLoadingPriority(s_State->s_LastFrameUpdate);
-    s_State->s_LoadingQueue.PushBack(li);
+    s_State->s_LoadingQueue.Insert(pResource, pResource->GetLoadingPriority(s_State->s_LastFrameUpdate));
   }
 }
 
@@ -284,10 +296,7 @@ bool ezResourceManager::ReloadResource(ezResource* pResource, bool bForce)
   {
     bAllowPreloading = false;
 
-    LoadingInfo li;
-    li.m_pResource = pResource;
-
-    if (s_State->s_LoadingQueue.IndexOf(li) == ezInvalidIndex)
+    if (!s_State->s_LoadingQueue.Contains(pResource))
     {
       // the resource is marked as 'loading' but it is not in the queue anymore
       // that means some task is already working on loading it
@@ -0,0 +1,143 @@
+#include <CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceLoadingQueue.h>
+#include <Core/ResourceManager/Resource.h>
+
+bool ezResourceLoadingQueue::Contains(const ezResource* pResource) const
+{
+  return pResource->m_uiLoadingQueueIndex != ezInvalidIndex;
+}
+
+void ezResourceLoadingQueue::Insert(ezResource* pResource, float fPriority)
+{
+  EZ_ASSERT_DEBUG(!Contains(pResource), "Resource '{0}' is already in the loading queue", pResource->GetResourceID());
+
+  const ezUInt32 uiIndex = m_Heap.GetCount();
+  m_Heap.ExpandAndGetRef();
+  SetEntry(uiIndex, {fPriority, pResource});
+
+  SiftUp(uiIndex);
+}
+
+bool ezResourceLoadingQueue::Remove(ezResource* pResource)
+{
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  if (uiIndex == ezInvalidIndex)
+    return false;
+
+  EZ_ASSERT_DEBUG(m_Heap[uiIndex].m_pResource == pResource, "Loading queue index of resource '{0}' is corrupted", pResource->GetResourceID());
+
+  pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  const ezUInt32 uiLastIndex = m_Heap.GetCount() - 1;
+  if (uiIndex != uiLastIndex)
+  {
+    // move the last entry into the gap, it may have to go either way from there
+    const float fRemovedPriority = m_Heap[uiIndex].m_fPriority;
+    SetEntry(uiIndex, m_Heap[uiLastIndex]);
+    m_Heap.PopBack();
+
+    if (m_Heap[uiIndex].m_fPriority < fRemovedPriority)
+      SiftUp(uiIndex);
+    else
+      SiftDown(uiIndex);
+  }
+  else
+  {
+    m_Heap.PopBack();
+  }
+
+  return true;
+}
+
+bool ezResourceLoadingQueue::UpdatePriority(ezResource* pResource, float fPriority)
+{
+  const ezUInt32 uiIndex = pResource->m_uiLoadingQueueIndex;
+  if (uiIndex == ezInvalidIndex)
+    return false;
+
+  const float fOldPriority = m_Heap[uiIndex].m_fPriority;
+  m_Heap[uiIndex].m_fPriority = fPriority;
+
+  if (fPriority < fOldPriority)
+    SiftUp(uiIndex);
+  else if (fPriority > fOldPriority)
+    SiftDown(uiIndex);
+
+  return true;
+}
+
+ezResource* ezResourceLoadingQueue::PeekFront() const
+{
+  return m_Heap.IsEmpty() ? nullptr : m_Heap[0].m_pResource;
+}
+
+ezResource* ezResourceLoadingQueue::PopFront()
+{
+  if (m_Heap.IsEmpty())
+    return nullptr;
+
+  ezResource* pResource = m_Heap[0].m_pResource;
+  Remove(pResource);
+  return pResource;
+}
+
+void ezResourceLoadingQueue::Clear()
+{
+  for (const Entry& entry : m_Heap)
+  {
+    entry.m_pResource->m_uiLoadingQueueIndex = ezInvalidIndex;
+  }
+
+  m_Heap.Clear();
+}
+
+EZ_ALWAYS_INLINE void ezResourceLoadingQueue::SetEntry(ezUInt32 uiIndex, const Entry& entry)
+{
+  m_Heap[uiIndex] = entry;
+  entry.m_pResource->m_uiLoadingQueueIndex = uiIndex;
+}
+
+void ezResourceLoadingQueue::SiftUp(ezUInt32 uiIndex)
+{
+  const Entry entry = m_Heap[uiIndex];
+
+  while (uiIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiIndex - 1) / 2;
+    if (!(entry.m_fPriority < m_Heap[uiParent].m_fPriority))
+      break;
+
+    SetEntry(uiIndex, m_Heap[uiParent]);
+    uiIndex = uiParent;
+  }
+
+  SetEntry(uiIndex, entry);
+}
+
+void ezResourceLoadingQueue::SiftDown(ezUInt32 uiIndex)
+{
+  const Entry entry = m_Heap[uiIndex];
+  const ezUInt32 uiCount = m_Heap.GetCount();
+
+  while (true)
+  {
+    ezUInt32 uiChild = uiIndex * 2 + 1;
+    if (uiChild >= uiCount)
+      break;
+
+    if (uiChild + 1 < uiCount && m_Heap[uiChild + 1].m_fPriority < m_Heap[uiChild].m_fPriority)
+      ++uiChild;
+
+    if (!(m_Heap[uiChild].m_fPriority < entry.m_fPriority))
+      break;
+
+    SetEntry(uiIndex, m_Heap[uiChild]);
+    uiIndex = uiChild;
+  }
+
+  SetEntry(uiIndex, entry);
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceLoadingQueue);
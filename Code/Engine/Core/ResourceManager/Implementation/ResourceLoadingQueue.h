@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Core/CoreInternal.h>
+EZ_CORE_INTERNAL_HEADER
+
+#include <Foundation/Containers/DynamicArray.h>
+
+class ezResource;
+
+/// \brief The queue of resources that wait for a data load task, ordered by their loading priority.
+///
+/// This is an indexed binary min-heap, resources with the lowest priority value are loaded first.
+/// Every resource stores its current position in the heap, so removing a resource or changing its priority
+/// does not require a search and is O(log n), just like insertion.
+/// All functions must be called while holding the resource manager mutex.
+class ezResourceLoadingQueue
+{
+public:
+  EZ_ALWAYS_INLINE bool IsEmpty() const { return m_Heap.IsEmpty(); }
+  EZ_ALWAYS_INLINE ezUInt32 GetCount() const { return m_Heap.GetCount(); }
+
+  /// \brief Returns whether the resource is in the queue, i.e. no task has picked it up for loading yet.
+  bool Contains(const ezResource* pResource) const;
+
+  void Insert(ezResource* pResource, float fPriority);
+
+  /// \brief Returns false if the resource is not in the queue.
+  bool Remove(ezResource* pResource);
+
+  /// \brief Moves the resource to the position that corresponds to the new priority. Returns false if the resource is not in the queue.
+  bool UpdatePriority(ezResource* pResource, float fPriority);
+
+  /// \brief Returns the resource with the lowest priority value.
+  ezResource* PeekFront() const;
+
+  /// \brief Removes and returns the resource with the lowest priority value.
+  ezResource* PopFront();
+
+  void Clear();
+
+  /// \brief Allows to iterate over all queued resources. The order is that of the heap, not the loading order.
+  EZ_ALWAYS_INLINE ezResource* GetResource(ezUInt32 uiIndex) const { return m_Heap[uiIndex].m_pResource; }
+
+private:
+  struct Entry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    float m_fPriority;
+    ezResource* m_pResource;
+  };
+
+  void SetEntry(ezUInt32 uiIndex, const Entry& entry);
+  void SiftUp(ezUInt32 uiIndex);
+  void SiftDown(ezUInt32 uiIndex);
+
+  ezDynamicArray<Entry> m_Heap;
+};
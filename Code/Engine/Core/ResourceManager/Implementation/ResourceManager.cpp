@@ -6,6 +6,7 @@
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
 
 /// \todo Do not unload resources while they are acquired
 /// \todo Resource Type Memory Thresholds
@@ -403,6 +404,7 @@ ezResult ezResourceManager::DeallocateResource(ezResource* pResource)
   }
 
   pResource->CallUnloadData(ezResource::Unload::AllQualityLevels);
+  RemoveFromResidency(pResource);
 
   EZ_ASSERT_DEBUG(pResource->GetLoadingState() <= ezResourceState::LoadedResourceMissing,
     "Resource '{0}' should be in an unloaded state now.", pResource->GetResourceID());
@@ -503,6 +505,39 @@ void ezResourceManager::PerFrameUpdate()
   {
     FreeUnusedResources(s_State->m_AutoFreeUnusedTimeout, s_State->m_AutoFreeUnusedThreshold);
   }
+
+  EnforceMemoryBudgets();
+
+  PublishLoadingStats();
+  PublishResidencyStats();
+}
+
+void ezResourceManager::PublishLoadingStats()
+{
+  const LoadingStats stats = GetLoadingStats();
+
+  ezStats::SetStat("ResourceManager/Loading/Queued", stats.m_uiNumQueued);
+  ezStats::SetStat("ResourceManager/Loading/Reads In Flight", stats.m_uiNumDataLoadsInFlight);
+  ezStats::SetStat("ResourceManager/Loading/Updates In Flight", stats.m_uiNumUpdateContentInFlight);
+  ezStats::SetStat("ResourceManager/Loading/Resources Read", stats.m_uiNumResourcesRead);
+  ezStats::SetStat("ResourceManager/Loading/Content Updates", stats.m_uiNumContentUpdates);
+  ezStats::SetStat("ResourceManager/Loading/Resources Decoded", stats.m_uiNumResourcesDecoded);
+  ezStats::SetStat("ResourceManager/Loading/Read Time", stats.m_ReadTime);
+  ezStats::SetStat("ResourceManager/Loading/Decode Time", stats.m_DecodeTime);
+  ezStats::SetStat("ResourceManager/Loading/Update Content Time", stats.m_UpdateContentTime);
+
+  // the read throughput is averaged over one second to not jitter too much
+  const ezTime tNow = ezTime::Now();
+  const ezTime tElapsed = tNow - s_State->s_LastPublishedStatsTime;
+
+  if (tElapsed.GetSeconds() >= 1.0)
+  {
+    const double fMegaBytes = (stats.m_uiNumBytesRead - s_State->s_uiLastPublishedBytesRead) / (1024.0 * 1024.0);
+    ezStats::SetStat("ResourceManager/Loading/Read Throughput (MB per sec)", fMegaBytes / tElapsed.GetSeconds());
+
+    s_State->s_uiLastPublishedBytesRead = stats.m_uiNumBytesRead;
+    s_State->s_LastPublishedStatsTime = tNow;
+  }
 }
 
 const ezEvent<const ezResourceEvent&, ezMutex>& ezResourceManager::GetResourceEvents()
@@ -542,7 +577,7 @@ void ezResourceManager::OnCoreStartup()
   s_State = EZ_DEFAULT_NEW(ezResourceManagerState);
 
   EZ_LOCK(s_ResourceMutex);
-  s_State->s_bAllowLaunchDataLoadTask = true;
+  s_State->s_uiDataLoadTasksInFlight = 0;
   s_State->s_bShutdown = false;
 
   ezPlugin::s_PluginEvents.AddEventHandler(PluginEventHandler);
@@ -559,8 +594,7 @@ void ezResourceManager::EngineAboutToShutdown()
       return;
     }
 
-    s_State->s_bAllowLaunchDataLoadTask = false; // prevent a new one from starting
-    s_State->s_bShutdown = true;
+    s_State->s_bShutdown = true; // prevents new data load tasks from starting
   }
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksDataLoad.GetCount(); ++i)
@@ -570,15 +604,17 @@ void ezResourceManager::EngineAboutToShutdown()
 
   for (ezUInt32 i = 0; i < s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
   {
+    // a canceled decode task is fine, the update content task decodes the data itself, if it still runs
+    ezTaskSystem::CancelTask(s_State->s_WorkerTasksUpdateContent[i].m_pDecodeTask.Borrow());
     ezTaskSystem::CancelTask(s_State->s_WorkerTasksUpdateContent[i].m_pTask.Borrow());
   }
 
   {
     EZ_LOCK(s_ResourceMutex);
 
-    for (auto entry : s_State->s_LoadingQueue)
+    for (ezUInt32 i = 0; i < s_State->s_LoadingQueue.GetCount(); ++i)
     {
-      entry.m_pResource->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
+      s_State->s_LoadingQueue.GetResource(i)->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     }
 
     s_State->s_LoadingQueue.Clear();
@@ -883,6 +919,8 @@ void ezResourceManager::SetResourceLowResData(const ezTypelessResourceHandle& hR
 
     pResource->m_MemoryUsage = MemUsage;
   }
+
+  UpdateResidency(pResource);
 }
 
 ezResourceTypeLoader* ezResourceManager::GetDefaultResourceLoader()
@@ -3,6 +3,7 @@
 #include <Core/CoreInternal.h>
 EZ_CORE_INTERNAL_HEADER
 
+#include <Core/ResourceManager/Implementation/ResourceLoadingQueue.h>
 #include <Core/ResourceManager/ResourceManager.h>
 
 class ezResourceManagerState
@@ -37,7 +38,10 @@ private:
   struct TaskDataUpdateContent
   {
     ezUniquePtr<ezResourceManagerWorkerUpdateContent> m_pTask;
+    ezUniquePtr<ezResourceManagerWorkerDecodeData> m_pDecodeTask;
     ezTaskGroupID m_GroupId;
+
+    void CreateTasks(ezUInt32 uiIndex);
   };
 
   struct TaskDataDataLoad
@@ -51,13 +55,20 @@ private:
   ezUInt32 s_uiForceNoFallbackAcquisition = 0;
 
   // resources in this queue are waiting for a task to load them
-  ezDeque<ezResourceManager::LoadingInfo> s_LoadingQueue;
+  ezResourceLoadingQueue s_LoadingQueue;
 
   ezHashTable<const ezRTTI*, ezResourceManager::LoadedResources> s_LoadedResources;
 
-  bool s_bAllowLaunchDataLoadTask = true;
+  // data load tasks that have been started and did not finish yet, each one reads one resource
+  // only as many of them run at a time as there are file access threads, the others wait in the task queue
+  ezUInt32 s_uiDataLoadTasksInFlight = 0;
+  ezUInt32 s_uiMaxConcurrentDataLoads = 16;
   bool s_bShutdown = false;
 
+  ezResourceManager::LoadingStats s_LoadingStats;
+  ezUInt64 s_uiLastPublishedBytesRead = 0;
+  ezTime s_LastPublishedStatsTime;
+
   ezHybridArray<TaskDataUpdateContent, 24> s_WorkerTasksUpdateContent;
   ezHybridArray<TaskDataDataLoad, 8> s_WorkerTasksDataLoad;
 
@@ -101,5 +112,23 @@ private:
   ezTime m_AutoFreeUnusedTimeout = ezTime::Zero();
   ezTime m_AutoFreeUnusedThreshold = ezTime::Zero();
 
+  // Memory budgets
+  ezUInt64 m_uiMemoryBudgetCPU = 0;
+  ezUInt64 m_uiMemoryBudgetGPU = 0;
+  ezTime m_EvictionMinTimeSinceLastAcquire = ezTime::Seconds(1);
+  bool m_bMemoryBudgetsActive = false;
+  ezResourceManager::ResidencyStats m_ResidencyStats;
+
+  struct ResidencyClockEntry
+  {
+    ezResource* m_pResource = nullptr;
+    ezResource::MemoryUsage m_AccountedUsage; ///< The part of the per type and global memory usage that comes from this resource.
+    ezTime m_LastVisit;                       ///< Frame time when the clock hand passed this entry the last time.
+  };
+
+  // all resources whose memory usage is accounted for, EnforceMemoryBudgets() goes round them like the hand of a clock
+  ezDynamicArray<ResidencyClockEntry> m_ResidencyClock;
+  ezUInt32 m_uiResidencyClockHand = 0;
+
   ezMap<const ezRTTI*, ezResourceManager::ResourceTypeInfo> m_TypeInfo;
 };
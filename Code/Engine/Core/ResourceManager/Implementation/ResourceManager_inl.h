@@ -83,6 +83,8 @@ ezTypedResourceHandle<ResourceType> ezResourceManager::CreateResource(
     pResource->VerifyAfterCreateResource(ld);
   }
 
+  UpdateResidency(pResource);
+
   EZ_ASSERT_DEV(pResource->GetLoadingState() != ezResourceState::Unloaded, "CreateResource did not set the loading state properly.");
 
   EndAcquireResource(pResource);
@@ -0,0 +1,265 @@
+#include <CorePCH.h>
+
+#include <Core/ResourceManager/Implementation/ResourceManagerState.h>
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Utilities/Stats.h>
+
+namespace
+{
+  EZ_ALWAYS_INLINE bool IsOverBudget(ezUInt64 uiUsage, ezUInt64 uiBudget)
+  {
+    return uiBudget > 0 && uiUsage > uiBudget;
+  }
+
+  EZ_ALWAYS_INLINE void SubtractMemory(ezUInt64& ref_uiUsage, ezUInt64 uiFreed)
+  {
+    ref_uiUsage -= ezMath::Min(ref_uiUsage, uiFreed);
+  }
+} // namespace
+
+void ezResourceManager::SetMemoryBudget(ezUInt64 uiMaxMemoryCPU, ezUInt64 uiMaxMemoryGPU, ezTime minTimeSinceLastAcquire)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  s_State->m_uiMemoryBudgetCPU = uiMaxMemoryCPU;
+  s_State->m_uiMemoryBudgetGPU = uiMaxMemoryGPU;
+  s_State->m_EvictionMinTimeSinceLastAcquire = minTimeSinceLastAcquire;
+}
+
+void ezResourceManager::SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, ezUInt64 uiMaxMemoryCPU, ezUInt64 uiMaxMemoryGPU)
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  ResourceTypeInfo& typeInfo = GetResourceTypeInfo(pResourceType);
+  typeInfo.m_uiMemoryBudgetCPU = uiMaxMemoryCPU;
+  typeInfo.m_uiMemoryBudgetGPU = uiMaxMemoryGPU;
+}
+
+ezResourceManager::ResidencyStats ezResourceManager::GetResidencyStats()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  return s_State->m_ResidencyStats;
+}
+
+void ezResourceManager::UpdateResidency(ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  const ezResource::MemoryUsage& memUsage = pResource->GetMemoryUsage();
+
+  if (pResource->m_uiResidencyClockIndex == ezInvalidIndex)
+  {
+    if (memUsage.m_uiMemoryCPU + memUsage.m_uiMemoryGPU == 0)
+      return;
+
+    // new resources are inserted right behind the clock hand, so they are visited last
+    pResource->m_uiResidencyClockIndex = s_State->m_ResidencyClock.GetCount();
+
+    auto& entry = s_State->m_ResidencyClock.ExpandAndGetRef();
+    entry.m_pResource = pResource;
+    entry.m_LastVisit = GetLastFrameUpdate();
+  }
+
+  AccountMemoryUsage(pResource, s_State->m_ResidencyClock[pResource->m_uiResidencyClockIndex].m_AccountedUsage, memUsage);
+}
+
+void ezResourceManager::RemoveFromResidency(ezResource* pResource)
+{
+  EZ_ASSERT_DEBUG(s_ResourceMutex.IsLocked(), "Calling code must acquire s_ResourceMutex");
+
+  const ezUInt32 uiIndex = pResource->m_uiResidencyClockIndex;
+
+  if (uiIndex == ezInvalidIndex)
+    return;
+
+  auto& clock = s_State->m_ResidencyClock;
+
+  AccountMemoryUsage(pResource, clock[uiIndex].m_AccountedUsage, ezResource::MemoryUsage());
+
+  clock[uiIndex] = clock.PeekBack();
+  clock[uiIndex].m_pResource->m_uiResidencyClockIndex = uiIndex;
+  clock.PopBack();
+
+  pResource->m_uiResidencyClockIndex = ezInvalidIndex;
+}
+
+void ezResourceManager::AccountMemoryUsage(const ezResource* pResource, ezResource::MemoryUsage& ref_accountedUsage, const ezResource::MemoryUsage& newUsage)
+{
+  const ezResource::MemoryUsage& oldUsage = ref_accountedUsage;
+
+  if (oldUsage.m_uiMemoryCPU == newUsage.m_uiMemoryCPU && oldUsage.m_uiMemoryGPU == newUsage.m_uiMemoryGPU)
+    return;
+
+  ResidencyStats& stats = s_State->m_ResidencyStats;
+  ResourceTypeInfo& typeInfo = GetResourceTypeInfo(pResource->GetDynamicRTTI());
+
+  SubtractMemory(stats.m_uiMemoryCPU, oldUsage.m_uiMemoryCPU);
+  SubtractMemory(stats.m_uiMemoryGPU, oldUsage.m_uiMemoryGPU);
+  SubtractMemory(typeInfo.m_uiMemoryUsageCPU, oldUsage.m_uiMemoryCPU);
+  SubtractMemory(typeInfo.m_uiMemoryUsageGPU, oldUsage.m_uiMemoryGPU);
+
+  stats.m_uiMemoryCPU += newUsage.m_uiMemoryCPU;
+  stats.m_uiMemoryGPU += newUsage.m_uiMemoryGPU;
+  typeInfo.m_uiMemoryUsageCPU += newUsage.m_uiMemoryCPU;
+  typeInfo.m_uiMemoryUsageGPU += newUsage.m_uiMemoryGPU;
+
+  const bool bWasResident = oldUsage.m_uiMemoryCPU + oldUsage.m_uiMemoryGPU > 0;
+  const bool bIsResident = newUsage.m_uiMemoryCPU + newUsage.m_uiMemoryGPU > 0;
+
+  if (bWasResident && !bIsResident)
+    --stats.m_uiNumResidentResources;
+  else if (!bWasResident && bIsResident)
+    ++stats.m_uiNumResidentResources;
+
+  ref_accountedUsage = newUsage;
+}
+
+bool ezResourceManager::IsAnyMemoryBudgetExceeded()
+{
+  const ResidencyStats& stats = s_State->m_ResidencyStats;
+
+  if (IsOverBudget(stats.m_uiMemoryCPU, s_State->m_uiMemoryBudgetCPU) || IsOverBudget(stats.m_uiMemoryGPU, s_State->m_uiMemoryBudgetGPU))
+    return true;
+
+  for (auto it = s_State->m_TypeInfo.GetIterator(); it.IsValid(); ++it)
+  {
+    const ResourceTypeInfo& typeInfo = it.Value();
+
+    if (IsOverBudget(typeInfo.m_uiMemoryUsageCPU, typeInfo.m_uiMemoryBudgetCPU) || IsOverBudget(typeInfo.m_uiMemoryUsageGPU, typeInfo.m_uiMemoryBudgetGPU))
+      return true;
+  }
+
+  return false;
+}
+
+ezUInt32 ezResourceManager::EnforceMemoryBudgets()
+{
+  EZ_LOCK(s_ResourceMutex);
+
+  bool bAnyBudget = s_State->m_uiMemoryBudgetCPU > 0 || s_State->m_uiMemoryBudgetGPU > 0;
+
+  for (auto it = s_State->m_TypeInfo.GetIterator(); it.IsValid() && !bAnyBudget; ++it)
+  {
+    bAnyBudget = it.Value().m_uiMemoryBudgetCPU > 0 || it.Value().m_uiMemoryBudgetGPU > 0;
+  }
+
+  s_State->m_bMemoryBudgetsActive = bAnyBudget;
+
+  if (!bAnyBudget || !IsAnyMemoryBudgetExceeded())
+    return 0;
+
+  EZ_PROFILE_SCOPE("EnforceMemoryBudgets");
+
+  ResidencyStats& stats = s_State->m_ResidencyStats;
+  auto& clock = s_State->m_ResidencyClock;
+  ezUInt32& uiHand = s_State->m_uiResidencyClockHand;
+
+  const ezTime tNow = ezTime::Now();
+  const ezTime tFrame = GetLastFrameUpdate();
+
+  ezUInt32 uiNumEvicted = 0;
+  bool bOverBudget = true;
+
+  // every resource gets visited at most twice, once to use up its second chance and once more to be evicted
+  for (ezUInt32 uiVisitsLeft = 2 * clock.GetCount(); uiVisitsLeft > 0 && bOverBudget && !clock.IsEmpty(); --uiVisitsLeft)
+  {
+    if (uiHand >= clock.GetCount())
+      uiHand = 0;
+
+    auto& entry = clock[uiHand];
+    ezResource* pResource = entry.m_pResource;
+
+    // resources that were acquired since the hand came by the last time get a second chance
+    const bool bAcquiredSinceLastVisit = pResource->GetLastAcquireTime() > entry.m_LastVisit;
+    entry.m_LastVisit = tFrame;
+
+    const ezRTTI* pType = pResource->GetDynamicRTTI();
+    ResourceTypeInfo& typeInfo = GetResourceTypeInfo(pType);
+    const ezResource::MemoryUsage memBefore = pResource->GetMemoryUsage();
+
+    bool bEvict = !bAcquiredSinceLastVisit && typeInfo.m_bIncrementalUnload && memBefore.m_uiMemoryCPU + memBefore.m_uiMemoryGPU > 0;
+
+    bEvict = bEvict && pResource->m_iLockCount == 0 && tNow - pResource->GetLastAcquireTime() >= s_State->m_EvictionMinTimeSinceLastAcquire;
+    bEvict = bEvict && !IsQueuedForLoading(pResource) && !pResource->m_Flags.IsAnySet(ezResourceFlags::IsCreatedResource | ezResourceFlags::PreventFileReload);
+
+    // referenced resources are only unloaded, so they must have data to unload and be able to load it again
+    bEvict = bEvict && (pResource->GetReferenceCount() == 0 ||
+                         (pResource->GetLoadingState() != ezResourceState::Unloaded && pResource->m_Flags.IsSet(ezResourceFlags::IsReloadable)));
+
+    if (bEvict)
+    {
+      const bool bCPUOverBudget = IsOverBudget(stats.m_uiMemoryCPU, s_State->m_uiMemoryBudgetCPU) ||
+                                  IsOverBudget(typeInfo.m_uiMemoryUsageCPU, typeInfo.m_uiMemoryBudgetCPU);
+      const bool bGPUOverBudget = IsOverBudget(stats.m_uiMemoryGPU, s_State->m_uiMemoryBudgetGPU) ||
+                                  IsOverBudget(typeInfo.m_uiMemoryUsageGPU, typeInfo.m_uiMemoryBudgetGPU);
+
+      // only evict resources that actually help to get back into the exceeded budgets
+      bEvict = (bCPUOverBudget && memBefore.m_uiMemoryCPU > 0) || (bGPUOverBudget && memBefore.m_uiMemoryGPU > 0);
+    }
+
+    if (!bEvict)
+    {
+      ++uiHand;
+      continue;
+    }
+
+    ezResource::MemoryUsage memAfter;
+
+    if (pResource->GetReferenceCount() == 0)
+    {
+      const ezTempHashedString sResourceID(pResource->GetResourceID().GetData());
+
+      // this also removes the resource from the clock, the last entry is moved to the position of the hand and is visited next
+      if (DeallocateResource(pResource).Failed())
+      {
+        ++uiHand;
+        continue;
+      }
+
+      s_State->s_LoadedResources[pType].m_Resources.Remove(sResourceID);
+    }
+    else
+    {
+      // keep the lower quality levels around as long as possible, such that the resource stays usable
+      pResource->CallUnloadData(pResource->GetNumQualityLevelsDiscardable() > 1 ? ezResource::Unload::OneQualityLevel : ezResource::Unload::AllQualityLevels);
+      pResource->m_Flags.Add(ezResourceFlags::WasEvicted);
+
+      memAfter = memBefore;
+      pResource->UpdateMemoryUsage(memAfter);
+      pResource->m_MemoryUsage = memAfter;
+      UpdateResidency(pResource);
+
+      ++uiHand;
+    }
+
+    const ezUInt64 uiFreedCPU = memBefore.m_uiMemoryCPU - ezMath::Min(memBefore.m_uiMemoryCPU, memAfter.m_uiMemoryCPU);
+    const ezUInt64 uiFreedGPU = memBefore.m_uiMemoryGPU - ezMath::Min(memBefore.m_uiMemoryGPU, memAfter.m_uiMemoryGPU);
+
+    stats.m_uiNumEvictions++;
+    stats.m_uiNumEvictedBytes += uiFreedCPU + uiFreedGPU;
+    ++uiNumEvicted;
+
+    bOverBudget = IsAnyMemoryBudgetExceeded();
+  }
+
+  return uiNumEvicted;
+}
+
+void ezResourceManager::PublishResidencyStats()
+{
+  if (!s_State->m_bMemoryBudgetsActive)
+    return;
+
+  const ResidencyStats stats = GetResidencyStats();
+
+  ezStats::SetStat("ResourceManager/Residency/Resident Resources", stats.m_uiNumResidentResources);
+  ezStats::SetStat("ResourceManager/Residency/Memory CPU", stats.m_uiMemoryCPU);
+  ezStats::SetStat("ResourceManager/Residency/Memory GPU", stats.m_uiMemoryGPU);
+  ezStats::SetStat("ResourceManager/Residency/Evictions", stats.m_uiNumEvictions);
+  ezStats::SetStat("ResourceManager/Residency/Evicted Bytes", stats.m_uiNumEvictedBytes);
+  ezStats::SetStat("ResourceManager/Residency/Reloads After Eviction", stats.m_uiNumReloadsAfterEviction);
+}
+
+EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_ResourceResidency);
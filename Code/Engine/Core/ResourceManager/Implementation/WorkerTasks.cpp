@@ -21,15 +21,13 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
     if (ezResourceManager::s_State->s_LoadingQueue.IsEmpty())
     {
-      ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+      --ezResourceManager::s_State->s_uiDataLoadTasksInFlight;
       return;
     }
 
     ezResourceManager::UpdateLoadingDeadlines();
 
-    auto it = ezResourceManager::s_State->s_LoadingQueue.PeekFront();
-    pResourceToLoad = it.m_pResource;
-    ezResourceManager::s_State->s_LoadingQueue.PopFront();
+    pResourceToLoad = ezResourceManager::s_State->s_LoadingQueue.PopFront();
 
     if (pResourceToLoad->m_Flags.IsSet(ezResourceFlags::HasCustomDataLoader))
     {
@@ -48,16 +46,27 @@ void ezResourceManagerWorkerDataLoad::Execute()
 
   EZ_ASSERT_DEV(pLoader != nullptr, "No Loader function available for Resource Type '{0}'", pResourceToLoad->GetDynamicRTTI()->GetTypeName());
 
+  const ezTime tReadStart = ezTime::Now();
   ezResourceLoadData LoaderData = pLoader->OpenDataStream(pResourceToLoad);
+  const ezTime tReadDuration = ezTime::Now() - tReadStart;
 
   // we need this info later to do some work in a lock, all the directly following code is outside the lock
   const bool bResourceIsLoadedOnMainThread = pResourceToLoad->GetBaseResourceFlags().IsAnySet(ezResourceFlags::UpdateOnMainThread);
 
   ezResourceManagerWorkerUpdateContent* pUpdateContentTask = nullptr;
+  ezResourceManagerWorkerDecodeData* pUpdateContentDecodeTask = nullptr;
   ezTaskGroupID* pUpdateContentGroup = nullptr;
 
   EZ_LOCK(ezResourceManager::s_ResourceMutex);
 
+  {
+    ezResourceManager::LoadingStats& stats = ezResourceManager::s_State->s_LoadingStats;
+    stats.m_uiNumResourcesRead++;
+    stats.m_uiNumBytesRead += LoaderData.m_uiDataSize;
+    stats.m_ReadTime += tReadDuration;
+    stats.m_uiNumUpdateContentInFlight++;
+  }
+
   // try to find an update content task that has finished and can be reused
   for (ezUInt32 i = 0; i < ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount(); ++i)
   {
@@ -66,6 +75,7 @@ void ezResourceManagerWorkerDataLoad::Execute()
     if (ezTaskSystem::IsTaskGroupFinished(td.m_GroupId))
     {
       pUpdateContentTask = td.m_pTask.Borrow();
+      pUpdateContentDecodeTask = td.m_pDecodeTask.Borrow();
       pUpdateContentGroup = &td.m_GroupId;
       break;
     }
@@ -74,14 +84,13 @@ void ezResourceManagerWorkerDataLoad::Execute()
   // if no such task could be found, we must allocate a new one
   if (pUpdateContentTask == nullptr)
   {
-    ezStringBuilder s;
-    s.Format("Resource Content Updater {0}", ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount());
+    const ezUInt32 uiIndex = ezResourceManager::s_State->s_WorkerTasksUpdateContent.GetCount();
 
     auto& td = ezResourceManager::s_State->s_WorkerTasksUpdateContent.ExpandAndGetRef();
-    td.m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerUpdateContent);
-    td.m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+    td.CreateTasks(uiIndex);
 
     pUpdateContentTask = td.m_pTask.Borrow();
+    pUpdateContentDecodeTask = td.m_pDecodeTask.Borrow();
     pUpdateContentGroup = &td.m_GroupId;
   }
 
@@ -92,11 +101,27 @@ void ezResourceManagerWorkerDataLoad::Execute()
     pUpdateContentTask->m_pCustomLoader = std::move(pCustomLoader);
     pUpdateContentTask->m_pResourceToLoad = pResourceToLoad;
 
-    // schedule the task to run, either on the main thread or on some other thread
-    *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, bResourceIsLoadedOnMainThread ? ezTaskPriority::SomeFrameMainThread : ezTaskPriority::LateNextFrame);
+    if (bResourceIsLoadedOnMainThread)
+    {
+      if (LoaderData.m_bNeedsDecoding)
+      {
+        // decoding is CPU heavy and should neither block the main thread nor the file access threads
+        const ezTaskGroupID decodeGroup = ezTaskSystem::StartSingleTask(pUpdateContentDecodeTask, ezTaskPriority::LateNextFrame);
+        *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, ezTaskPriority::SomeFrameMainThread, decodeGroup);
+      }
+      else
+      {
+        *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, ezTaskPriority::SomeFrameMainThread);
+      }
+    }
+    else
+    {
+      // the update content task decodes the data itself, it runs on a worker thread anyway
+      *pUpdateContentGroup = ezTaskSystem::StartSingleTask(pUpdateContentTask, ezTaskPriority::LateNextFrame);
+    }
 
-    // restart the next loading task (this one is about to finish)
-    ezResourceManager::s_State->s_bAllowLaunchDataLoadTask = true;
+    // replace this task with the next loading task (this one is about to finish)
+    --ezResourceManager::s_State->s_uiDataLoadTasksInFlight;
     ezResourceManager::RunWorkerTask(nullptr);
 
     pCustomLoader.Clear();
@@ -111,6 +136,11 @@ ezResourceManagerWorkerUpdateContent::~ezResourceManagerWorkerUpdateContent() =
 
 void ezResourceManagerWorkerUpdateContent::Execute()
 {
+  // only does anything, if the decode task was skipped
+  DecodeData();
+
+  const ezTime tStart = ezTime::Now();
+
   if (!m_LoaderData.m_sResourceDescription.IsEmpty())
     m_pResourceToLoad->SetResourceDescription(m_LoaderData.m_sResourceDescription);
 
@@ -129,16 +159,14 @@ void ezResourceManagerWorkerUpdateContent::Execute()
   EZ_ASSERT_DEV(m_pResourceToLoad->GetLoadingState() != ezResourceState::Unloaded, "The resource should have changed its loading state.");
 
   // Update Memory Usage
+  ezResource::MemoryUsage MemUsage;
   {
-    ezResource::MemoryUsage MemUsage;
     MemUsage.m_uiMemoryCPU = 0xFFFFFFFF;
     MemUsage.m_uiMemoryGPU = 0xFFFFFFFF;
     m_pResourceToLoad->UpdateMemoryUsage(MemUsage);
 
     EZ_ASSERT_DEV(MemUsage.m_uiMemoryCPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its CPU memory usage", m_pResourceToLoad->GetResourceID());
     EZ_ASSERT_DEV(MemUsage.m_uiMemoryGPU != 0xFFFFFFFF, "Resource '{0}' did not properly update its GPU memory usage", m_pResourceToLoad->GetResourceID());
-
-    m_pResourceToLoad->m_MemoryUsage = MemUsage;
   }
 
   m_pLoader->CloseDataStream(m_pResourceToLoad, m_LoaderData);
@@ -148,11 +176,72 @@ void ezResourceManagerWorkerUpdateContent::Execute()
     EZ_ASSERT_DEV(ezResourceManager::IsQueuedForLoading(m_pResourceToLoad), "Multi-threaded access detected");
     m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::IsQueuedForLoading);
     m_pResourceToLoad->m_LastAcquire = ezResourceManager::GetLastFrameUpdate();
+
+    // the memory usage is read by EnforceMemoryBudgets() on the main thread, so it may only change inside the lock
+    m_pResourceToLoad->m_MemoryUsage = MemUsage;
+    ezResourceManager::UpdateResidency(m_pResourceToLoad);
+
+    ezResourceManager::LoadingStats& stats = ezResourceManager::s_State->s_LoadingStats;
+    stats.m_uiNumUpdateContentInFlight--;
+    stats.m_uiNumContentUpdates++;
+    stats.m_UpdateContentTime += ezTime::Now() - tStart;
+
+    if (m_pResourceToLoad->m_Flags.IsSet(ezResourceFlags::WasEvicted))
+    {
+      m_pResourceToLoad->m_Flags.Remove(ezResourceFlags::WasEvicted);
+      ezResourceManager::s_State->m_ResidencyStats.m_uiNumReloadsAfterEviction++;
+    }
   }
 
   m_pLoader = nullptr;
   m_pResourceToLoad = nullptr;
 }
 
+void ezResourceManagerWorkerUpdateContent::DecodeData()
+{
+  if (!m_LoaderData.m_bNeedsDecoding)
+    return;
+
+  EZ_PROFILE_SCOPE("DecodeResourceData");
+
+  const ezTime tStart = ezTime::Now();
+  m_pLoader->DecodeData(m_pResourceToLoad, m_LoaderData);
+  m_LoaderData.m_bNeedsDecoding = false;
+
+  EZ_LOCK(ezResourceManager::s_ResourceMutex);
+
+  ezResourceManager::LoadingStats& stats = ezResourceManager::s_State->s_LoadingStats;
+  stats.m_uiNumResourcesDecoded++;
+  stats.m_DecodeTime += ezTime::Now() - tStart;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+
+ezResourceManagerWorkerDecodeData::ezResourceManagerWorkerDecodeData() = default;
+ezResourceManagerWorkerDecodeData::~ezResourceManagerWorkerDecodeData() = default;
+
+void ezResourceManagerWorkerDecodeData::Execute()
+{
+  m_pUpdateContentTask->DecodeData();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+
+void ezResourceManagerState::TaskDataUpdateContent::CreateTasks(ezUInt32 uiIndex)
+{
+  ezStringBuilder s;
+
+  s.Format("Resource Content Updater {0}", uiIndex);
+  m_pTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerUpdateContent);
+  m_pTask->ConfigureTask(s, ezTaskNesting::Maybe);
+
+  s.Format("Resource Data Decoder {0}", uiIndex);
+  m_pDecodeTask = EZ_DEFAULT_NEW(ezResourceManagerWorkerDecodeData);
+  m_pDecodeTask->ConfigureTask(s, ezTaskNesting::Maybe);
+  m_pDecodeTask->m_pUpdateContentTask = m_pTask.Borrow();
+}
+
 
 EZ_STATICLINK_FILE(Core, Core_ResourceManager_Implementation_WorkerTasks);
@@ -38,7 +38,29 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerState;
   friend class ezResourceManagerWorkerDataLoad;
+  friend class ezResourceManagerWorkerDecodeData;
   ezResourceManagerWorkerUpdateContent();
 
   virtual void Execute() override;
+
+  /// \brief Calls ezResourceTypeLoader::DecodeData(), if the loader data still needs decoding.
+  void DecodeData();
+};
+
+/// \brief [internal] Worker task for decoding the data of resources that get updated on the main thread.
+/// Always runs on a worker thread, the update content task that belongs to it waits for it to finish.
+class EZ_CORE_DLL ezResourceManagerWorkerDecodeData final : public ezTask
+{
+public:
+  ~ezResourceManagerWorkerDecodeData();
+
+private:
+  friend class ezResourceManager;
+  friend class ezResourceManagerState;
+  friend class ezResourceManagerWorkerDataLoad;
+  ezResourceManagerWorkerDecodeData();
+
+  virtual void Execute() override;
+
+  ezResourceManagerWorkerUpdateContent* m_pUpdateContentTask = nullptr;
 };
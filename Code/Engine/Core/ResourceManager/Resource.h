@@ -135,6 +135,7 @@ private:
   friend class ezResourceManager;
   friend class ezResourceManagerWorkerDataLoad;
   friend class ezResourceManagerWorkerUpdateContent;
+  friend class ezResourceLoadingQueue;
 
   /// \brief Called by ezResourceManager shortly after resource creation.
   void SetUniqueID(const char* szUniqueID, bool bIsReloadable);
@@ -229,6 +230,12 @@ private:
   ezResourcePriority m_Priority = ezResourcePriority::Medium;
   ezTimestamp m_LoadedFileModificationTime;
 
+  /// \brief Position in the loading queue heap, ezInvalidIndex while the resource is not waiting in the queue.
+  ezUInt32 m_uiLoadingQueueIndex = ezInvalidIndex;
+
+  /// \brief Position in the eviction clock of the resource manager, ezInvalidIndex while no memory usage is accounted for the resource.
+  ezUInt32 m_uiResidencyClockIndex = ezInvalidIndex;
+
 private:
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   static const ezResource* GetCurrentlyUpdatingContent();
@@ -65,6 +65,37 @@ public:
   /// \brief Checks whether any resource loading is in progress
   static bool IsAnyLoadingInProgress();
 
+  /// \brief Sets how many data load tasks may be in flight at the same time. The default is 16, values below 1 are clamped to 1.
+  ///
+  /// Every data load task reads one resource on a file access worker thread and hands the data over to a separate task for the
+  /// content update. The limit is independent of the number of file access threads (see ezTaskSystem::SetWorkerThreadCount()).
+  /// Tasks beyond that number wait in the file access task queue without occupying a thread, and each of them picks the most
+  /// important queued resource once a thread becomes available, so a thread that finishes a read can start the next one right away.
+  static void SetMaxConcurrentDataLoads(ezUInt32 uiMaxTasks);
+
+  /// \brief Returns the value set through SetMaxConcurrentDataLoads().
+  static ezUInt32 GetMaxConcurrentDataLoads();
+
+  /// \brief Counters for the different stages of the resource loading pipeline.
+  ///
+  /// The counters are also published as ezStats under 'ResourceManager/Loading/...' in PerFrameUpdate().
+  struct LoadingStats
+  {
+    ezUInt32 m_uiNumQueued = 0;                 ///< Resources that wait in the loading queue for a data load task.
+    ezUInt32 m_uiNumDataLoadsInFlight = 0;      ///< Data load tasks that are queued or running and did not finish yet.
+    ezUInt32 m_uiNumUpdateContentInFlight = 0;  ///< Resources whose data has been read, but whose content was not updated yet.
+    ezUInt64 m_uiNumResourcesRead = 0;          ///< Total number of resources whose data was read by a resource type loader.
+    ezUInt64 m_uiNumBytesRead = 0;              ///< Total number of bytes reported through ezResourceLoadData::m_uiDataSize.
+    ezUInt64 m_uiNumResourcesDecoded = 0;       ///< Total number of resources whose data was decoded, see ezResourceTypeLoader::DecodeData().
+    ezUInt64 m_uiNumContentUpdates = 0;         ///< Total number of finished content updates.
+    ezTime m_ReadTime;                          ///< Time spent in ezResourceTypeLoader::OpenDataStream(), summed over all threads.
+    ezTime m_DecodeTime;                        ///< Time spent in ezResourceTypeLoader::DecodeData(), summed over all threads.
+    ezTime m_UpdateContentTime;                 ///< Time spent updating the resource content, summed over all threads.
+  };
+
+  /// \brief Returns a snapshot of the current loading counters.
+  static LoadingStats GetLoadingStats();
+
   /// \brief Generates a unique resource ID with the given prefix.
   ///
   /// Provide a prefix that is preferably not used anywhere else (i.e., closely related to your code).
@@ -188,6 +219,51 @@ public:
   /// \brief If timeout is not zero, FreeUnusedResources() is called once every frame with the given parameters.
   static void SetAutoFreeUnused(ezTime timeout, ezTime lastAcquireThreshold);
 
+  /// \brief Sets the global memory budgets (in bytes) for all resources combined. Zero means unlimited.
+  ///
+  /// If any budget is set, EnforceMemoryBudgets() is called once every frame.
+  /// Resources that were acquired within \a minTimeSinceLastAcquire are never evicted, to prevent loading them again right away.
+  static void SetMemoryBudget(ezUInt64 uiMaxMemoryCPU, ezUInt64 uiMaxMemoryGPU, ezTime minTimeSinceLastAcquire = ezTime::Seconds(1));
+
+  /// \brief Sets the memory budgets (in bytes) for all resources of exactly the given type. Zero means unlimited.
+  template <typename ResourceType>
+  static void SetMemoryBudgetForResourceType(ezUInt64 uiMaxMemoryCPU, ezUInt64 uiMaxMemoryGPU)
+  {
+    SetMemoryBudgetForResourceType(ezGetStaticRTTI<ResourceType>(), uiMaxMemoryCPU, uiMaxMemoryGPU);
+  }
+
+  /// \brief Sets the memory budgets (in bytes) for all resources of exactly the given type. Zero means unlimited.
+  static void SetMemoryBudgetForResourceType(const ezRTTI* pResourceType, ezUInt64 uiMaxMemoryCPU, ezUInt64 uiMaxMemoryGPU);
+
+  /// \brief Evicts the least recently used resources until all memory budgets are met again. Returns the number of evicted resources.
+  ///
+  /// The memory usage is taken from ezResource::GetMemoryUsage() and summed up whenever a resource's content changes, so as long as all
+  /// budgets are met, this does not need to look at any resource. Otherwise it goes round all resources in a clock-like fashion and evicts
+  /// those that were not acquired since the last time it came by, so the least recently used ones are evicted first.
+  /// Resources that are not referenced anymore are deallocated.
+  /// Referenced resources first discard one quality level at a time, as long as they have more than one loaded,
+  /// and are unloaded completely after that, so they get loaded again the next time they are acquired.
+  /// Resources that are currently acquired, queued for loading, created from code or of a type that has incremental unloading
+  /// disabled (see SetIncrementalUnloadForResourceType()) are never evicted.
+  /// Since resources may only be unloaded on the main thread, this must be called on the main thread as well.
+  static ezUInt32 EnforceMemoryBudgets();
+
+  /// \brief Memory footprint of the resources and counters for the evictions done by EnforceMemoryBudgets().
+  ///
+  /// The stats are also published as ezStats under 'ResourceManager/Residency/...' in PerFrameUpdate().
+  struct ResidencyStats
+  {
+    ezUInt32 m_uiNumResidentResources = 0;     ///< Resources that use any memory.
+    ezUInt64 m_uiMemoryCPU = 0;                ///< CPU memory of all resources.
+    ezUInt64 m_uiMemoryGPU = 0;                ///< GPU memory of all resources.
+    ezUInt64 m_uiNumEvictions = 0;             ///< Total number of evictions (deallocations, discarded quality levels and unloads).
+    ezUInt64 m_uiNumEvictedBytes = 0;          ///< Total CPU and GPU memory that was freed by evictions.
+    ezUInt64 m_uiNumReloadsAfterEviction = 0;  ///< Total number of evicted resources that had to be loaded again, i.e. the eviction churn.
+  };
+
+  /// \brief Returns a snapshot of the residency counters.
+  static ResidencyStats GetResidencyStats();
+
   /// \brief If set to 'false' resources of the given type will not be incrementally unloaded in the background, when they are not referenced anymore.
   template <typename ResourceType>
   static void SetIncrementalUnloadForResourceType(bool bActive);
@@ -420,14 +496,6 @@ private:
     ezHashTable<ezTempHashedString, ezResource*> m_Resources;
   };
 
-  struct LoadingInfo
-  {
-    float m_fPriority = 0;
-    ezResource* m_pResource = nullptr;
-
-    EZ_ALWAYS_INLINE bool operator==(const LoadingInfo& rhs) const { return m_pResource == rhs.m_pResource; }
-    EZ_ALWAYS_INLINE bool operator<(const LoadingInfo& rhs) const { return m_fPriority < rhs.m_fPriority; }
-  };
   static void EnsureResourceLoadingState(ezResource* pResource, const ezResourceState RequestedState);
   static void PreloadResource(ezResource* pResource);
   static void InternalPreloadResource(ezResource* pResource, bool bHighestPriority);
@@ -436,11 +504,14 @@ private:
   static ResourceType* GetResource(const char* szResourceID, bool bIsReloadable);
   static ezResource* GetResource(const ezRTTI* pRtti, const char* szResourceID, bool bIsReloadable);
   static void RunWorkerTask(ezResource* pResource);
+  static void LaunchDataLoadTask();
   static void UpdateLoadingDeadlines();
-  static void ReverseBubbleSortStep(ezDeque<LoadingInfo>& data);
+  static void UpdateLoadingPriority(ezResource* pResource);
   static bool ReloadResource(ezResource* pResource, bool bForce);
 
   static void SetupWorkerTasks();
+  static void PublishLoadingStats();
+  static void PublishResidencyStats();
   static ezTime GetLastFrameUpdate();
   static ezHashTable<const ezRTTI*, LoadedResources>& GetLoadedResources();
   static ezDynamicArray<ezResource*>& GetLoadedResourceOfTypeTempContainer();
@@ -454,11 +525,22 @@ private:
     bool m_bIncrementalUnload = true;
     bool m_bAllowNestedAcquireCached = false;
 
+    ezUInt64 m_uiMemoryBudgetCPU = 0;
+    ezUInt64 m_uiMemoryBudgetGPU = 0;
+    ezUInt64 m_uiMemoryUsageCPU = 0;
+    ezUInt64 m_uiMemoryUsageGPU = 0;
+
     ezHybridArray<const ezRTTI*, 8> m_NestedTypes;
   };
 
   static ResourceTypeInfo& GetResourceTypeInfo(const ezRTTI* pRtti);
 
+  /// \brief Adds the current memory usage of the resource to the residency bookkeeping, see EnforceMemoryBudgets().
+  static void UpdateResidency(ezResource* pResource);
+  static void RemoveFromResidency(ezResource* pResource);
+  static void AccountMemoryUsage(const ezResource* pResource, ezResource::MemoryUsage& ref_accountedUsage, const ezResource::MemoryUsage& newUsage);
+  static bool IsAnyMemoryBudgetExceeded();
+
   // Type loaders
 private:
   static ezResourceTypeLoader* GetResourceTypeLoader(const ezRTTI* pRTTI);
@@ -19,12 +19,19 @@ struct EZ_CORE_DLL ezResourceLoadData
 
   /// Custom loader data, e.g. a pointer to a custom memory block, that needs to be freed when the resource is done updating.
   void* m_pCustomLoaderData = nullptr;
+
+  /// Optional number of bytes that the loader has read. Only used for the loading statistics, see ezResourceManager::GetLoadingStats().
+  ezUInt64 m_uiDataSize = 0;
+
+  /// Set this in ezResourceTypeLoader::OpenDataStream() to have ezResourceTypeLoader::DecodeData() called before the resource is updated.
+  bool m_bNeedsDecoding = false;
 };
 
 /// \brief Base class for all resource loaders.
 ///
 /// A resource loader handles preparing the data before the resource is updated with the data.
-/// Resource loaders are always executed on a separate thread.
+/// Resource loaders are always executed on a separate thread. Reading (OpenDataStream()) and decoding (DecodeData()) are separate
+/// stages, which run on different threads.
 class EZ_CORE_DLL ezResourceTypeLoader
 {
 public:
@@ -40,6 +47,14 @@ public:
   /// \sa ezResourceLoadData
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) = 0;
 
+  /// \brief Override this function to decode the data that OpenDataStream() has read, e.g. to decompress or convert it.
+  ///
+  /// OpenDataStream() runs on the file access threads, which should only wait for I/O, so that as many reads as possible are in flight.
+  /// CPU heavy work should therefore be moved into this function, which runs on a regular worker thread instead.
+  /// It is only called if OpenDataStream() has set ezResourceLoadData::m_bNeedsDecoding. On failure, set \a inout_LoaderData.m_pDataStream
+  /// to nullptr, the same as OpenDataStream() would do.
+  virtual void DecodeData(const ezResource* pResource, ezResourceLoadData& inout_LoaderData) {}
+
   /// \brief This function is called when the resource has been updated with the data from the resource loader and the loader can deallocate
   /// any temporary memory.
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) = 0;
@@ -463,6 +463,10 @@ private:
 
   void UpdateGlobalTransformAndBoundsRecursive();
 
+  // Flags a dynamic object so that its global transform and bounds are recomputed in the next world update.
+  void MarkTransformDirty();
+  void MarkTransformDirtyInternal();
+
   void OnMsgDeleteGameObject(ezMsgDeleteGameObject& msg);
 
   void AddComponent(ezComponent* pComponent);
@@ -502,7 +506,16 @@ private:
     ezSpatialDataHandle m_hSpatialData;
     ezUInt32 m_uiSpatialDataCategoryBitmask;
 
-    ezUInt32 m_uiPadding2[2];
+    ezUInt32 m_uiBlockIndex; // index of the data block within the hierarchy level, see WorldData::Hierarchy::m_DirtyBlocks
+    ezUInt8 m_uiDirtyFrames; // number of world updates in which the global transform and bounds still have to be recomputed
+    ezUInt8 m_uiPadding2[3];
+
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+    // The object has to be updated once more after it stopped moving, so that its velocity drops back to zero.
+    static constexpr ezUInt8 DirtyFrames = 2;
+#else
+    static constexpr ezUInt8 DirtyFrames = 1;
+#endif
 
     void UpdateLocalTransform();
 
@@ -204,6 +204,9 @@ void ezGameObject::UpdateGlobalTransformAndBoundsRecursive()
     ezLog::Error("Static object '{0}' was moved during runtime.", GetName());
   }
 
+  // This is also called for dynamic children of a moved static object, whose velocity is only computed in the next world update.
+  MarkTransformDirty();
+
   ezSimdTransform oldGlobalTransform = GetGlobalTransformSimd();
 
   if (m_pTransformationData->m_pParentData != nullptr)
@@ -239,6 +242,11 @@ void ezGameObject::UpdateGlobalTransformAndBoundsRecursive()
   }
 }
 
+void ezGameObject::MarkTransformDirtyInternal()
+{
+  GetWorld()->m_Data.MarkTransformationDataDirty(m_pTransformationData, m_uiHierarchyLevel);
+}
+
 void ezGameObject::ConstChildIterator::Next()
 {
   m_pObject = m_pWorld->GetObjectUnchecked(m_pObject->m_NextSiblingIndex);
@@ -641,6 +649,10 @@ void ezGameObject::UpdateLocalBounds()
       m_pTransformationData->UpdateGlobalBounds();
     }
   }
+  else
+  {
+    MarkTransformDirty();
+  }
 }
 
 void ezGameObject::UpdateGlobalTransformAndBounds()
@@ -246,9 +246,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalPosition(const ezSimdVec4f& position
 {
   m_pTransformationData->m_localPosition = position;
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    MarkTransformDirty();
   }
 }
 
@@ -262,9 +269,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalRotation(const ezSimdQuat& rotation,
 {
   m_pTransformationData->m_localRotation = rotation;
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    MarkTransformDirty();
   }
 }
 
@@ -280,9 +294,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalScaling(const ezSimdVec4f& scaling,
   m_pTransformationData->m_localScaling = scaling;
   m_pTransformationData->m_localScaling.SetW(uniformScale);
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    MarkTransformDirty();
   }
 }
 
@@ -296,9 +317,16 @@ EZ_ALWAYS_INLINE void ezGameObject::SetLocalUniformScaling(const ezSimdFloat& sc
 {
   m_pTransformationData->m_localScaling.SetW(scaling);
 
-  if (IsStatic() && updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+  if (IsStatic())
   {
-    UpdateGlobalTransformAndBoundsRecursive();
+    if (updateBehavior == UpdateBehaviorIfStatic::UpdateImmediately)
+    {
+      UpdateGlobalTransformAndBoundsRecursive();
+    }
+  }
+  else
+  {
+    MarkTransformDirty();
   }
 }
 
@@ -324,6 +352,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalPosition(const ezSimdVec4f& positio
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    MarkTransformDirty();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetGlobalPositionSimd() const
@@ -342,6 +374,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalRotation(const ezSimdQuat& rotation
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    MarkTransformDirty();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdQuat& ezGameObject::GetGlobalRotationSimd() const
@@ -360,6 +396,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalScaling(const ezSimdVec4f& scaling)
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    MarkTransformDirty();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdVec4f& ezGameObject::GetGlobalScalingSimd() const
@@ -382,6 +422,10 @@ EZ_ALWAYS_INLINE void ezGameObject::SetGlobalTransform(const ezSimdTransform& tr
   {
     UpdateGlobalTransformAndBoundsRecursive();
   }
+  else
+  {
+    MarkTransformDirty();
+  }
 }
 
 EZ_ALWAYS_INLINE const ezSimdTransform& ezGameObject::GetGlobalTransformSimd() const
@@ -393,6 +437,8 @@ EZ_ALWAYS_INLINE const ezSimdTransform& ezGameObject::GetGlobalTransformSimd() c
 EZ_ALWAYS_INLINE void ezGameObject::SetVelocity(const ezVec3& vVelocity)
 {
   m_pTransformationData->m_velocity = ezSimdVec4f(vVelocity.x, vVelocity.y, vVelocity.z, 1.0f);
+
+  MarkTransformDirty();
 }
 
 EZ_ALWAYS_INLINE ezVec3 ezGameObject::GetVelocity() const
@@ -401,6 +447,15 @@ EZ_ALWAYS_INLINE ezVec3 ezGameObject::GetVelocity() const
 }
 #endif
 
+EZ_ALWAYS_INLINE void ezGameObject::MarkTransformDirty()
+{
+  // the block of an object that is already fully dirty is flagged as well, so only the first call per frame has to do any work
+  if (IsDynamic() && m_pTransformationData->m_uiDirtyFrames != TransformationData::DirtyFrames)
+  {
+    MarkTransformDirtyInternal();
+  }
+}
+
 EZ_ALWAYS_INLINE void ezGameObject::UpdateGlobalTransform()
 {
   m_pTransformationData->ConditionalUpdateGlobalTransform();
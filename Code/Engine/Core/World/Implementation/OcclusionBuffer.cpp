@@ -0,0 +1,267 @@
+#include <CorePCH.h>
+
+#include <Core/World/OcclusionBuffer.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  // vertices with a smaller w are considered to be on or behind the near plane
+  static const float s_fMinW = 1e-5f;
+
+  // two triangles per face, indices into the corners as returned by ezBoundingBox::GetCorners()
+  static const ezUInt8 s_BoxIndices[36] = {
+    0, 1, 3, 0, 3, 2, // -x
+    4, 6, 7, 4, 7, 5, // +x
+    0, 4, 5, 0, 5, 1, // -y
+    2, 3, 7, 2, 7, 6, // +y
+    0, 2, 6, 0, 6, 4, // -z
+    1, 5, 7, 1, 7, 3, // +z
+  };
+
+  struct EdgeFunction
+  {
+    float m_fA;
+    float m_fB;
+    float m_fC;
+
+    // positive for points to the left of the edge from p to q
+    EZ_ALWAYS_INLINE void Setup(const ezVec4& p, const ezVec4& q)
+    {
+      m_fA = p.y - q.y;
+      m_fB = q.x - p.x;
+      m_fC = -m_fA * p.x - m_fB * p.y;
+    }
+  };
+} // namespace
+
+ezOcclusionBuffer::ezOcclusionBuffer(ezUInt32 uiWidth /*= 256*/, ezUInt32 uiHeight /*= 128*/)
+{
+  EZ_ASSERT_DEV(uiWidth > 0 && uiHeight > 0, "Invalid occlusion buffer size {0}x{1}", uiWidth, uiHeight);
+
+  // the rasterizer always processes four horizontally adjacent pixels at once
+  m_uiWidth = ezMemoryUtils::AlignSize(uiWidth, 4u);
+  m_uiHeight = uiHeight;
+
+  m_Depth.SetCountUninitialized(m_uiWidth * m_uiHeight);
+
+  m_vScreenScale.Set(m_uiWidth * 0.5f, m_uiHeight * -0.5f, 1.0f, 0.0f);
+  m_vScreenOffset.Set(m_uiWidth * 0.5f, m_uiHeight * 0.5f, 0.0f, 0.0f);
+
+  Clear(ezMat4::IdentityMatrix());
+}
+
+ezOcclusionBuffer::~ezOcclusionBuffer() = default;
+
+void ezOcclusionBuffer::Clear(const ezMat4& viewProjection)
+{
+  m_ViewProjection = ezSimdConversion::ToMat4(viewProjection);
+  m_uiNumRasterizedTriangles = 0;
+
+  const ezSimdVec4f vFar(ezMath::MaxValue<float>());
+  float* pDepth = m_Depth.GetData();
+
+  for (ezUInt32 i = 0; i < m_Depth.GetCount(); i += 4)
+  {
+    vFar.Store<4>(pDepth + i);
+  }
+}
+
+void ezOcclusionBuffer::RasterizeOccluder(ezArrayPtr<const ezVec3> triangles, const ezSimdTransform& transform)
+{
+  EZ_ASSERT_DEV(triangles.GetCount() % 3 == 0, "Occluder triangle list must contain three vertices per triangle");
+
+  const ezSimdMat4f mTransform = m_ViewProjection * transform.GetAsMat4();
+
+  for (ezUInt32 i = 0; i < triangles.GetCount(); i += 3)
+  {
+    const ezSimdVec4f v0 = mTransform.TransformPosition(ezSimdConversion::ToVec3(triangles[i + 0]));
+    const ezSimdVec4f v1 = mTransform.TransformPosition(ezSimdConversion::ToVec3(triangles[i + 1]));
+    const ezSimdVec4f v2 = mTransform.TransformPosition(ezSimdConversion::ToVec3(triangles[i + 2]));
+
+    RasterizeTriangle(v0, v1, v2);
+  }
+}
+
+void ezOcclusionBuffer::RasterizeOccluder(const ezBoundingBox& localBox, const ezSimdTransform& transform)
+{
+  const ezSimdMat4f mTransform = m_ViewProjection * transform.GetAsMat4();
+
+  ezVec3 corners[8];
+  localBox.GetCorners(corners);
+
+  ezSimdVec4f clipCorners[8];
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    clipCorners[i] = mTransform.TransformPosition(ezSimdConversion::ToVec3(corners[i]));
+  }
+
+  for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(s_BoxIndices); i += 3)
+  {
+    RasterizeTriangle(clipCorners[s_BoxIndices[i + 0]], clipCorners[s_BoxIndices[i + 1]], clipCorners[s_BoxIndices[i + 2]]);
+  }
+}
+
+bool ezOcclusionBuffer::IsVisible(const ezSimdBBox& box) const
+{
+  if (!HasOccluders())
+    return true;
+
+  ezSimdVec4f vMin(ezMath::MaxValue<float>());
+  ezSimdVec4f vMax(-ezMath::MaxValue<float>());
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    const ezSimdVec4b selectMax((i & 4) != 0, (i & 2) != 0, (i & 1) != 0, true);
+    const ezSimdVec4f vCorner = m_ViewProjection.TransformPosition(ezSimdVec4f::Select(selectMax, box.m_Max, box.m_Min));
+
+    const ezSimdFloat fW = vCorner.w();
+    if (fW < ezSimdFloat(s_fMinW))
+      return true;
+
+    const ezSimdVec4f vScreen = vCorner.CompMul(ezSimdVec4f(fW).GetReciprocal()).CompMul(m_vScreenScale) + m_vScreenOffset;
+    vMin = vMin.CompMin(vScreen);
+    vMax = vMax.CompMax(vScreen);
+  }
+
+  const ezVec4 screenMin = ezSimdConversion::ToVec4(vMin);
+  const ezVec4 screenMax = ezSimdConversion::ToVec4(vMax);
+
+  // huge boxes may not project to finite coordinates
+  if (!screenMin.IsValid() || !screenMax.IsValid())
+    return true;
+
+  // boxes that are off screen can't be occluded by anything in the buffer, that case is left to the frustum culling
+  if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= m_uiWidth || screenMin.y >= m_uiHeight)
+    return true;
+
+  const ezUInt32 uiMinX = static_cast<ezUInt32>(ezMath::Max(screenMin.x, 0.0f)) & ~3u;
+  const ezUInt32 uiMinY = static_cast<ezUInt32>(ezMath::Max(screenMin.y, 0.0f));
+  const ezUInt32 uiMaxX = static_cast<ezUInt32>(ezMath::Min(screenMax.x, m_uiWidth - 1.0f));
+  const ezUInt32 uiMaxY = static_cast<ezUInt32>(ezMath::Min(screenMax.y, m_uiHeight - 1.0f));
+
+  const ezSimdVec4f vBoxDepth(screenMin.z);
+
+  for (ezUInt32 y = uiMinY; y <= uiMaxY; ++y)
+  {
+    const float* pRow = m_Depth.GetData() + y * m_uiWidth;
+
+    for (ezUInt32 x = uiMinX; x <= uiMaxX; x += 4)
+    {
+      ezSimdVec4f vDepth;
+      vDepth.Load<4>(pRow + x);
+
+      // any pixel where the box is in front of the closest occluder makes it visible
+      if ((vBoxDepth <= vDepth).AnySet())
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void ezOcclusionBuffer::RasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2)
+{
+  // Clipping against the near plane is not worth it for occluders, skipping the triangle only makes the result more conservative.
+  if (v0.w() < ezSimdFloat(s_fMinW) || v1.w() < ezSimdFloat(s_fMinW) || v2.w() < ezSimdFloat(s_fMinW))
+    return;
+
+  ezVec4 p[3];
+  p[0] = ezSimdConversion::ToVec4(v0.CompMul(v0.Get<ezSwizzle::WWWW>().GetReciprocal()).CompMul(m_vScreenScale) + m_vScreenOffset);
+  p[1] = ezSimdConversion::ToVec4(v1.CompMul(v1.Get<ezSwizzle::WWWW>().GetReciprocal()).CompMul(m_vScreenScale) + m_vScreenOffset);
+  p[2] = ezSimdConversion::ToVec4(v2.CompMul(v2.Get<ezSwizzle::WWWW>().GetReciprocal()).CompMul(m_vScreenScale) + m_vScreenOffset);
+
+  float fArea = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+  if (ezMath::Abs(fArea) < 1e-6f)
+    return;
+
+  // occluders are rendered two-sided, so just bring every triangle into the same winding order
+  if (fArea < 0.0f)
+  {
+    ezMath::Swap(p[1], p[2]);
+    fArea = -fArea;
+  }
+
+  const float fMinX = ezMath::Min(p[0].x, p[1].x, p[2].x);
+  const float fMinY = ezMath::Min(p[0].y, p[1].y, p[2].y);
+  const float fMaxX = ezMath::Max(p[0].x, p[1].x, p[2].x);
+  const float fMaxY = ezMath::Max(p[0].y, p[1].y, p[2].y);
+
+  if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= m_uiWidth || fMinY >= m_uiHeight)
+    return;
+
+  const ezUInt32 uiMinX = static_cast<ezUInt32>(ezMath::Max(fMinX, 0.0f)) & ~3u;
+  const ezUInt32 uiMinY = static_cast<ezUInt32>(ezMath::Max(fMinY, 0.0f));
+  const ezUInt32 uiMaxX = static_cast<ezUInt32>(ezMath::Min(fMaxX, m_uiWidth - 1.0f));
+  const ezUInt32 uiMaxY = static_cast<ezUInt32>(ezMath::Min(fMaxY, m_uiHeight - 1.0f));
+
+  // each edge function is weighted with the vertex opposite to it
+  EdgeFunction edges[3];
+  edges[0].Setup(p[1], p[2]);
+  edges[1].Setup(p[2], p[0]);
+  edges[2].Setup(p[0], p[1]);
+
+  // the depth plane z(x, y) = a * x + b * y + c, from the barycentric interpolation of the vertex depths
+  const float fInvArea = 1.0f / fArea;
+  float fDepthA = 0.0f;
+  float fDepthB = 0.0f;
+  float fDepthC = 0.0f;
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const float fWeight = p[i].z * fInvArea;
+    fDepthA += edges[i].m_fA * fWeight;
+    fDepthB += edges[i].m_fB * fWeight;
+    fDepthC += edges[i].m_fC * fWeight;
+  }
+
+  const ezSimdVec4f vPixelOffsets(0.5f, 1.5f, 2.5f, 3.5f);
+  const ezSimdVec4f vStartX = vPixelOffsets + ezSimdVec4f(static_cast<float>(uiMinX));
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+
+  const ezSimdVec4f vEdgeStep0(edges[0].m_fA * 4.0f);
+  const ezSimdVec4f vEdgeStep1(edges[1].m_fA * 4.0f);
+  const ezSimdVec4f vEdgeStep2(edges[2].m_fA * 4.0f);
+  const ezSimdVec4f vDepthStep(fDepthA * 4.0f);
+
+  bool bTouchedBuffer = false;
+
+  for (ezUInt32 y = uiMinY; y <= uiMaxY; ++y)
+  {
+    const float fY = y + 0.5f;
+
+    ezSimdVec4f vEdge0 = vStartX * ezSimdFloat(edges[0].m_fA) + ezSimdVec4f(edges[0].m_fB * fY + edges[0].m_fC);
+    ezSimdVec4f vEdge1 = vStartX * ezSimdFloat(edges[1].m_fA) + ezSimdVec4f(edges[1].m_fB * fY + edges[1].m_fC);
+    ezSimdVec4f vEdge2 = vStartX * ezSimdFloat(edges[2].m_fA) + ezSimdVec4f(edges[2].m_fB * fY + edges[2].m_fC);
+    ezSimdVec4f vDepth = vStartX * ezSimdFloat(fDepthA) + ezSimdVec4f(fDepthB * fY + fDepthC);
+
+    float* pRow = m_Depth.GetData() + y * m_uiWidth;
+
+    for (ezUInt32 x = uiMinX; x <= uiMaxX; x += 4)
+    {
+      const ezSimdVec4b inside = (vEdge0 >= vZero) && (vEdge1 >= vZero) && (vEdge2 >= vZero);
+
+      if (inside.AnySet())
+      {
+        ezSimdVec4f vBufferDepth;
+        vBufferDepth.Load<4>(pRow + x);
+
+        vBufferDepth = ezSimdVec4f::Select(inside, vBufferDepth.CompMin(vDepth), vBufferDepth);
+        vBufferDepth.Store<4>(pRow + x);
+
+        bTouchedBuffer = true;
+      }
+
+      vEdge0 += vEdgeStep0;
+      vEdge1 += vEdgeStep1;
+      vEdge2 += vEdgeStep2;
+      vDepth += vDepthStep;
+    }
+  }
+
+  if (bTouchedBuffer)
+  {
+    ++m_uiNumRasterizedTriangles;
+  }
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_OcclusionBuffer);
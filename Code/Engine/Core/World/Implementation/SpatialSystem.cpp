@@ -1,6 +1,11 @@
 #include <CorePCH.h>
 
+#include <Core/World/OcclusionBuffer.h>
 #include <Core/World/SpatialSystem.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 
 // clang-format off
@@ -113,6 +118,78 @@ void ezSpatialSystem::UpdateSpatialData(const ezSpatialDataHandle& hData, const
   }
 }
 
+void ezSpatialSystem::UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates)
+{
+  EZ_PROFILE_SCOPE("UpdateSpatialDataBatch");
+
+  struct DeferredChange
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdBBoxSphere m_OldBounds;
+    ezSpatialData* m_pData;
+    ezUInt32 m_uiOldCategoryBitmask;
+  };
+
+  ezMutex deferredChangesMutex;
+  ezDynamicArray<DeferredChange> deferredChanges;
+
+  ezParallelForParams params;
+  params.uiBinSize = 256;
+  params.partitioning = ezParallelForPartitioning::Adaptive;
+
+  ezTaskSystem::ParallelFor<const SpatialDataUpdate>(
+    updates,
+    [&](ezArrayPtr<const SpatialDataUpdate> updatesSlice) {
+      ezHybridArray<DeferredChange, 64> localDeferredChanges;
+
+      for (const SpatialDataUpdate& update : updatesSlice)
+      {
+        // the data table is not modified during the batch, so lookups are safe from multiple threads
+        ezSpatialData* pData = nullptr;
+        if (!m_DataTable.TryGetValue(update.m_hData.GetInternalID(), pData))
+          continue;
+
+        pData->m_pObject = update.m_pObject;
+
+        if (pData->m_Flags.IsSet(ezSpatialData::Flags::AlwaysVisible))
+        {
+          pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+          continue;
+        }
+
+        const ezUInt32 uiOldCategoryBitmask = pData->m_uiCategoryBitmask;
+        const ezSimdBBoxSphere oldBounds = pData->m_Bounds;
+
+        pData->m_uiCategoryBitmask = update.m_uiCategoryBitmask;
+        pData->m_Bounds = update.m_Bounds;
+
+        if (update.m_uiCategoryBitmask != uiOldCategoryBitmask || update.m_Bounds != oldBounds)
+        {
+          if (!SpatialDataChangedInPlace(pData, oldBounds, uiOldCategoryBitmask))
+          {
+            auto& change = localDeferredChanges.ExpandAndGetRef();
+            change.m_OldBounds = oldBounds;
+            change.m_pData = pData;
+            change.m_uiOldCategoryBitmask = uiOldCategoryBitmask;
+          }
+        }
+      }
+
+      if (!localDeferredChanges.IsEmpty())
+      {
+        EZ_LOCK(deferredChangesMutex);
+        deferredChanges.PushBackRange(localDeferredChanges);
+      }
+    },
+    "UpdateSpatialDataBatch", params);
+
+  for (const DeferredChange& change : deferredChanges)
+  {
+    SpatialDataChanged(change.m_pData, change.m_OldBounds, change.m_uiOldCategoryBitmask);
+  }
+}
+
 void ezSpatialSystem::FindObjectsInSphere(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, ezDynamicArray<ezGameObject*>& out_Objects,
   QueryStats* pStats /*= nullptr*/) const
 {
@@ -182,7 +259,7 @@ void ezSpatialSystem::FindObjectsInBox(const ezBoundingBox& box, ezUInt32 uiCate
 }
 
 void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-  QueryStats* pStats /*= nullptr*/) const
+  QueryStats* pStats /*= nullptr*/, const ezOcclusionBuffer* pOcclusionBuffer /*= nullptr*/) const
 {
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezStopwatch timer;
@@ -195,7 +272,12 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
   }
 #endif
 
-  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats);
+  if (pOcclusionBuffer != nullptr && !pOcclusionBuffer->HasOccluders())
+  {
+    pOcclusionBuffer = nullptr;
+  }
+
+  FindVisibleObjectsInternal(frustum, uiCategoryBitmask, out_Objects, pStats, pOcclusionBuffer);
 
   for (auto pData : m_DataAlwaysVisible)
   {
@@ -213,6 +295,80 @@ void ezSpatialSystem::FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCa
 #endif
 }
 
+void ezSpatialSystem::FindVisibleObjects(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats /*= nullptr*/) const
+{
+  EZ_ASSERT_DEV(frusta.GetCount() <= 32, "At most 32 frusta can be tested at once, got {0}", frusta.GetCount());
+
+  if (frusta.IsEmpty())
+    return;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezStopwatch timer;
+
+  if (pStats != nullptr)
+  {
+    pStats->m_uiTotalNumObjects = m_DataTable.GetCount();
+    pStats->m_uiNumObjectsTested += m_DataAlwaysVisible.GetCount();
+    pStats->m_uiNumObjectsPassed += m_DataAlwaysVisible.GetCount();
+  }
+#endif
+
+  FindVisibleObjectsBatchInternal(frusta, uiCategoryBitmask, out_Objects, out_VisibilityMasks, pStats);
+
+  const ezUInt32 uiAllFrustaMask = frusta.GetCount() == 32 ? 0xFFFFFFFF : (1u << frusta.GetCount()) - 1;
+
+  for (auto pData : m_DataAlwaysVisible)
+  {
+    if ((pData->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      out_Objects.PushBack(pData->m_pObject);
+      out_VisibilityMasks.PushBack(uiAllFrustaMask);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_TimeTaken = timer.GetRunningTotal();
+  }
+#endif
+}
+
+void ezSpatialSystem::FindVisibleObjectsBatchInternal(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats) const
+{
+  ezHashTable<const ezGameObject*, ezUInt32> objectToIndex;
+  ezDynamicArray<const ezGameObject*> visibleObjects;
+
+  for (ezUInt32 uiFrustum = 0; uiFrustum < frusta.GetCount(); ++uiFrustum)
+  {
+    visibleObjects.Clear();
+    FindVisibleObjectsInternal(frusta[uiFrustum], uiCategoryBitmask, visibleObjects, nullptr, nullptr);
+
+    for (const ezGameObject* pObject : visibleObjects)
+    {
+      ezUInt32 uiIndex = ezInvalidIndex;
+      if (!objectToIndex.TryGetValue(pObject, uiIndex))
+      {
+        uiIndex = out_Objects.GetCount();
+        objectToIndex.Insert(pObject, uiIndex);
+
+        out_Objects.PushBack(pObject);
+        out_VisibilityMasks.PushBack(0);
+      }
+
+      out_VisibilityMasks[uiIndex] |= EZ_BIT(uiFrustum);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsPassed += objectToIndex.GetCount();
+  }
+#endif
+}
 
 
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem);
@@ -0,0 +1,925 @@
+#include <CorePCH.h>
+
+#include <Core/World/OcclusionBuffer.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+
+namespace
+{
+  enum
+  {
+    MAX_DEPTH = 20
+  };
+
+  EZ_ALWAYS_INLINE ezUInt32 GetLaneMask(const ezSimdVec4b& b)
+  {
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE
+    return static_cast<ezUInt32>(_mm_movemask_ps(b.m_v));
+#else
+    return (b.x() ? 1u : 0u) | (b.y() ? 2u : 0u) | (b.z() ? 4u : 0u) | (b.w() ? 8u : 0u);
+#endif
+  }
+
+  EZ_ALWAYS_INLINE ezSimdFloat GetMaxHalfExtent(const ezSimdBBoxSphere& bounds)
+  {
+    return bounds.m_BoxHalfExtents.HorizontalMax<3>();
+  }
+
+  struct FrustumPlanes
+  {
+    ezSimdVec4f m_x[6];
+    ezSimdVec4f m_y[6];
+    ezSimdVec4f m_z[6];
+    ezSimdVec4f m_w[6];
+
+    // plane normal and distance for the node tests, which are done one node at a time
+    ezVec4 m_Planes[6];
+    float m_fAbsNormalSum[6];
+  };
+
+  void ComputeFrustumPlanes(const ezFrustum& frustum, FrustumPlanes& out_Planes)
+  {
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      const ezPlane& plane = frustum.GetPlane(i);
+
+      out_Planes.m_x[i] = ezSimdVec4f(plane.m_vNormal.x);
+      out_Planes.m_y[i] = ezSimdVec4f(plane.m_vNormal.y);
+      out_Planes.m_z[i] = ezSimdVec4f(plane.m_vNormal.z);
+      out_Planes.m_w[i] = ezSimdVec4f(plane.m_fNegDistance);
+
+      out_Planes.m_Planes[i].Set(plane.m_vNormal.x, plane.m_vNormal.y, plane.m_vNormal.z, plane.m_fNegDistance);
+      out_Planes.m_fAbsNormalSum[i] = ezMath::Abs(plane.m_vNormal.x) + ezMath::Abs(plane.m_vNormal.y) + ezMath::Abs(plane.m_vNormal.z);
+    }
+  }
+
+  // returns which of the four spheres intersect the frustum
+  EZ_FORCE_INLINE ezSimdVec4b SpheresFrustumIntersect(
+    const ezSimdVec4f& x, const ezSimdVec4f& y, const ezSimdVec4f& z, const ezSimdVec4f& r, const FrustumPlanes& planes)
+  {
+    ezSimdVec4b inside(true);
+
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      ezSimdVec4f fDist = ezSimdVec4f::MulAdd(x, planes.m_x[i], planes.m_w[i]);
+      fDist = ezSimdVec4f::MulAdd(y, planes.m_y[i], fDist);
+      fDist = ezSimdVec4f::MulAdd(z, planes.m_z[i], fDist);
+
+      inside = inside && (fDist <= r);
+    }
+
+    return inside;
+  }
+
+  enum class NodeFrustumResult
+  {
+    Outside,
+    Intersecting,
+    Inside
+  };
+
+  NodeFrustumResult TestNodeAgainstFrustum(const ezSimdVec4f& centerAndHalfSize, const FrustumPlanes& planes)
+  {
+    const ezVec4 center = ezSimdConversion::ToVec4(centerAndHalfSize);
+
+    // the loose bounds of a node extend by half the node size in every direction
+    const float fLooseHalfSize = center.w * 2.0f;
+
+    NodeFrustumResult result = NodeFrustumResult::Inside;
+
+    for (ezUInt32 i = 0; i < 6; ++i)
+    {
+      const ezVec4& plane = planes.m_Planes[i];
+      const float fDist = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+      const float fRadius = fLooseHalfSize * planes.m_fAbsNormalSum[i];
+
+      if (fDist > fRadius)
+        return NodeFrustumResult::Outside;
+
+      if (fDist > -fRadius)
+        result = NodeFrustumResult::Intersecting;
+    }
+
+    return result;
+  }
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::SpatialUserData
+{
+  Node* m_pNode = nullptr;
+  ezUInt32 m_uiDataIndex = 0;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+/// Four bounding spheres in SoA layout. Unused entries have a category bitmask of zero and thus never pass a query.
+struct ezSpatialSystem_LooseOctree::SpherePacket
+{
+  EZ_DECLARE_POD_TYPE();
+
+  float m_x[4];
+  float m_y[4];
+  float m_z[4];
+  float m_r[4];
+  ezUInt32 m_uiCategoryBitmask[4];
+
+  EZ_ALWAYS_INLINE ezSimdVec4i GetCategoryBitmasks() const
+  {
+    return ezSimdVec4i(static_cast<ezInt32>(m_uiCategoryBitmask[0]), static_cast<ezInt32>(m_uiCategoryBitmask[1]),
+      static_cast<ezInt32>(m_uiCategoryBitmask[2]), static_cast<ezInt32>(m_uiCategoryBitmask[3]));
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+struct ezSpatialSystem_LooseOctree::Node
+{
+  Node(ezAllocatorBase* pAllocator)
+    : m_Packets(pAllocator)
+    , m_DataPointers(pAllocator)
+  {
+  }
+
+  EZ_FORCE_INLINE void AddData(ezSpatialData* pData)
+  {
+    const ezUInt32 uiDataIndex = m_DataPointers.GetCount();
+    if (uiDataIndex % 4 == 0)
+    {
+      ezMemoryUtils::ZeroFill(&m_Packets.ExpandAndGetRef(), 1);
+    }
+
+    m_DataPointers.PushBack(pData);
+    UpdateData(pData, uiDataIndex);
+
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+    EZ_ASSERT_DEBUG(pUserData->m_pNode == nullptr, "Data can't be in multiple nodes");
+    pUserData->m_pNode = this;
+    pUserData->m_uiDataIndex = uiDataIndex;
+
+    m_uiCategoryBitmask |= pData->m_uiCategoryBitmask;
+
+    for (Node* pNode = this; pNode != nullptr; pNode = pNode->m_pParent)
+    {
+      pNode->m_uiSubtreeCategoryBitmask |= pData->m_uiCategoryBitmask;
+    }
+  }
+
+  EZ_FORCE_INLINE void RemoveData(ezSpatialData* pData)
+  {
+    auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+    EZ_ASSERT_DEBUG(pUserData->m_pNode == this, "Implementation error");
+
+    const ezUInt32 uiDataIndex = pUserData->m_uiDataIndex;
+    const ezUInt32 uiLastIndex = m_DataPointers.GetCount() - 1;
+
+    if (uiDataIndex != uiLastIndex)
+    {
+      ezSpatialData* pLastData = m_DataPointers[uiLastIndex];
+      m_DataPointers[uiDataIndex] = pLastData;
+      UpdateData(pLastData, uiDataIndex);
+
+      reinterpret_cast<SpatialUserData*>(&pLastData->m_uiUserData[0])->m_uiDataIndex = uiDataIndex;
+    }
+
+    m_Packets[uiLastIndex / 4].m_uiCategoryBitmask[uiLastIndex % 4] = 0;
+    m_DataPointers.PopBack();
+
+    if (uiLastIndex % 4 == 0)
+    {
+      m_Packets.PopBack();
+    }
+
+    if (m_DataPointers.IsEmpty())
+    {
+      m_uiCategoryBitmask = 0;
+    }
+
+    pUserData->m_pNode = nullptr;
+    pUserData->m_uiDataIndex = ezInvalidIndex;
+  }
+
+  // Only writes the packet entry of this data, so different data may be updated concurrently.
+  EZ_FORCE_INLINE void UpdateData(const ezSpatialData* pData, ezUInt32 uiDataIndex)
+  {
+    SpherePacket& packet = m_Packets[uiDataIndex / 4];
+    const ezUInt32 uiLane = uiDataIndex % 4;
+
+    const ezSimdVec4f& centerAndRadius = pData->m_Bounds.m_CenterAndRadius;
+    packet.m_x[uiLane] = centerAndRadius.x();
+    packet.m_y[uiLane] = centerAndRadius.y();
+    packet.m_z[uiLane] = centerAndRadius.z();
+    packet.m_r[uiLane] = centerAndRadius.w();
+    packet.m_uiCategoryBitmask[uiLane] = pData->m_uiCategoryBitmask;
+  }
+
+  EZ_ALWAYS_INLINE bool IsEmpty() const { return m_DataPointers.IsEmpty() && m_uiNumChildren == 0; }
+
+  EZ_ALWAYS_INLINE ezSimdBBox GetLooseBox() const
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(m_CenterAndHalfSize, m_CenterAndHalfSize.Get<ezSwizzle::WWWW>() * 2.0f);
+    return box;
+  }
+
+  ezSimdVec4f m_CenterAndHalfSize; // w = half the edge length of the node without the loose border
+
+  Node* m_pParent = nullptr;
+  Node* m_Children[8] = {};
+  ezUInt32 m_uiChildIndex = 0;
+  ezUInt32 m_uiNumChildren = 0;
+  ezUInt32 m_uiDepth = 0;
+
+  ezUInt32 m_uiCategoryBitmask = 0;        // categories of the data in this node, may contain categories that have been removed
+  ezUInt32 m_uiSubtreeCategoryBitmask = 0; // same for this node and all its children
+
+  ezDynamicArray<SpherePacket> m_Packets;
+  ezDynamicArray<ezSpatialData*> m_DataPointers;
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename Functor>
+EZ_FORCE_INLINE void ezSpatialSystem_LooseOctree::ForEachNode(const ezSimdBBox& box, ezUInt32 uiCategoryBitmask, Functor func) const
+{
+  ezHybridArray<const Node*, 64> nodeStack;
+  nodeStack.PushBack(m_pRoot);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const Node* pNode = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    if ((pNode->m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0 || !pNode->GetLooseBox().Overlaps(box))
+      continue;
+
+    if ((pNode->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      if (func(*pNode) == ezVisitorExecution::Stop)
+        return;
+    }
+
+    for (const Node* pChild : pNode->m_Children)
+    {
+      if (pChild != nullptr)
+      {
+        nodeStack.PushBack(pChild);
+      }
+    }
+  }
+
+  if ((m_pOverflowNode->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+  {
+    func(*m_pOverflowNode);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// clang-format off
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSpatialSystem_LooseOctree, 1, ezRTTINoAllocator)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+// clang-format on
+
+ezSpatialSystem_LooseOctree::ezSpatialSystem_LooseOctree(float fWorldSize /*= 65536.0f*/, float fMinNodeSize /*= 32.0f*/)
+  : m_AlignedAllocator("Spatial System Aligned", ezFoundation::GetAlignedAllocator())
+  , m_fRootHalfSize(fWorldSize * 0.5f)
+  , m_uiMaxDepth(0)
+{
+  EZ_CHECK_AT_COMPILETIME(sizeof(ezSpatialSystem_LooseOctree::SpatialUserData) <= sizeof(ezSpatialData::m_uiUserData));
+
+  float fNodeSize = fWorldSize;
+  while (fNodeSize * 0.5f >= fMinNodeSize && m_uiMaxDepth < MAX_DEPTH)
+  {
+    fNodeSize *= 0.5f;
+    ++m_uiMaxDepth;
+  }
+
+  m_pRoot = CreateNode(nullptr, 0);
+
+  m_pOverflowNode = CreateNode(nullptr, 0);
+  m_pOverflowNode->m_CenterAndHalfSize.Set(0.0f, 0.0f, 0.0f, ezMath::MaxValue<float>() * 0.25f);
+}
+
+ezSpatialSystem_LooseOctree::~ezSpatialSystem_LooseOctree()
+{
+  DeleteNode(m_pRoot);
+  DeleteNode(m_pOverflowNode);
+}
+
+ezResult ezSpatialSystem_LooseOctree::GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const
+{
+  ezSpatialData* pData;
+  if (!m_DataTable.TryGetValue(hData.GetInternalID(), pData))
+    return EZ_FAILURE;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (pUserData->m_pNode != nullptr && pUserData->m_pNode != m_pOverflowNode)
+  {
+    out_BoundingBox = ezSimdConversion::ToBBox(pUserData->m_pNode->GetLooseBox());
+    return EZ_SUCCESS;
+  }
+
+  return EZ_FAILURE;
+}
+
+void ezSpatialSystem_LooseOctree::GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory) const
+{
+  const ezUInt32 uiCategoryBitmask = filterCategory == ezInvalidSpatialDataCategory ? 0xFFFFFFFF : filterCategory.GetBitmask();
+
+  ezHybridArray<const Node*, 64> nodeStack;
+  nodeStack.PushBack(m_pRoot);
+
+  while (!nodeStack.IsEmpty())
+  {
+    const Node* pNode = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    if ((pNode->m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    if (!pNode->m_DataPointers.IsEmpty() && (pNode->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      out_BoundingBoxes.ExpandAndGetRef() = ezSimdConversion::ToBBox(pNode->GetLooseBox());
+    }
+
+    for (const Node* pChild : pNode->m_Children)
+    {
+      if (pChild != nullptr)
+      {
+        nodeStack.PushBack(pChild);
+      }
+    }
+  }
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+  QueryStats* pStats) const
+{
+  ezSimdBSphere simdSphere(ezSimdConversion::ToVec3(sphere.m_vCenter), sphere.m_fRadius);
+  ezSimdBBox simdBox;
+  simdBox.SetCenterAndHalfExtents(simdSphere.m_CenterAndRadius, simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>());
+
+  const ezSimdVec4f sphereX = simdSphere.m_CenterAndRadius.Get<ezSwizzle::XXXX>();
+  const ezSimdVec4f sphereY = simdSphere.m_CenterAndRadius.Get<ezSwizzle::YYYY>();
+  const ezSimdVec4f sphereZ = simdSphere.m_CenterAndRadius.Get<ezSwizzle::ZZZZ>();
+  const ezSimdVec4f sphereR = simdSphere.m_CenterAndRadius.Get<ezSwizzle::WWWW>();
+  const ezSimdVec4i queryCategories(static_cast<ezInt32>(uiCategoryBitmask));
+
+  ForEachNode(simdBox, uiCategoryBitmask, [&](const Node& node) {
+    const ezUInt32 uiNumData = node.m_DataPointers.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += uiNumData;
+    }
+#endif
+
+    for (ezUInt32 uiPacket = 0; uiPacket < node.m_Packets.GetCount(); ++uiPacket)
+    {
+      const SpherePacket& packet = node.m_Packets[uiPacket];
+
+      ezSimdVec4f x, y, z, r;
+      x.Load<4>(packet.m_x);
+      y.Load<4>(packet.m_y);
+      z.Load<4>(packet.m_z);
+      r.Load<4>(packet.m_r);
+
+      const ezSimdVec4f dx = x - sphereX;
+      const ezSimdVec4f dy = y - sphereY;
+      const ezSimdVec4f dz = z - sphereZ;
+      const ezSimdVec4f fRadiusSum = r + sphereR;
+
+      ezSimdVec4f fDistSquared = dx.CompMul(dx);
+      fDistSquared = ezSimdVec4f::MulAdd(dy, dy, fDistSquared);
+      fDistSquared = ezSimdVec4f::MulAdd(dz, dz, fDistSquared);
+
+      const ezSimdVec4b hit = (fDistSquared <= fRadiusSum.CompMul(fRadiusSum)) && ((packet.GetCategoryBitmasks() & queryCategories) != ezSimdVec4i::ZeroVector());
+
+      ezUInt32 uiMask = GetLaneMask(hit);
+      while (uiMask > 0)
+      {
+        const ezUInt32 uiLane = ezMath::FirstBitLow(uiMask);
+        uiMask &= uiMask - 1;
+
+        const ezSpatialData* pData = node.m_DataPointers[uiPacket * 4 + uiLane];
+
+        if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        if (pStats != nullptr)
+        {
+          pStats->m_uiNumObjectsPassed++;
+        }
+#endif
+      }
+    }
+
+    return ezVisitorExecution::Continue;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const
+{
+  ezSimdBBox simdBox(ezSimdConversion::ToVec3(box.m_vMin), ezSimdConversion::ToVec3(box.m_vMax));
+
+  const ezSimdVec4f boxMinX = simdBox.m_Min.Get<ezSwizzle::XXXX>();
+  const ezSimdVec4f boxMinY = simdBox.m_Min.Get<ezSwizzle::YYYY>();
+  const ezSimdVec4f boxMinZ = simdBox.m_Min.Get<ezSwizzle::ZZZZ>();
+  const ezSimdVec4f boxMaxX = simdBox.m_Max.Get<ezSwizzle::XXXX>();
+  const ezSimdVec4f boxMaxY = simdBox.m_Max.Get<ezSwizzle::YYYY>();
+  const ezSimdVec4f boxMaxZ = simdBox.m_Max.Get<ezSwizzle::ZZZZ>();
+  const ezSimdVec4i queryCategories(static_cast<ezInt32>(uiCategoryBitmask));
+
+  ForEachNode(simdBox, uiCategoryBitmask, [&](const Node& node) {
+    const ezUInt32 uiNumData = node.m_DataPointers.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    if (pStats != nullptr)
+    {
+      pStats->m_uiNumObjectsTested += uiNumData;
+    }
+#endif
+
+    for (ezUInt32 uiPacket = 0; uiPacket < node.m_Packets.GetCount(); ++uiPacket)
+    {
+      const SpherePacket& packet = node.m_Packets[uiPacket];
+
+      ezSimdVec4f x, y, z, r;
+      x.Load<4>(packet.m_x);
+      y.Load<4>(packet.m_y);
+      z.Load<4>(packet.m_z);
+      r.Load<4>(packet.m_r);
+
+      // distance from the sphere centers to the closest point in the box
+      const ezSimdVec4f dx = x - x.CompMax(boxMinX).CompMin(boxMaxX);
+      const ezSimdVec4f dy = y - y.CompMax(boxMinY).CompMin(boxMaxY);
+      const ezSimdVec4f dz = z - z.CompMax(boxMinZ).CompMin(boxMaxZ);
+
+      ezSimdVec4f fDistSquared = dx.CompMul(dx);
+      fDistSquared = ezSimdVec4f::MulAdd(dy, dy, fDistSquared);
+      fDistSquared = ezSimdVec4f::MulAdd(dz, dz, fDistSquared);
+
+      const ezSimdVec4b hit = (fDistSquared <= r.CompMul(r)) && ((packet.GetCategoryBitmasks() & queryCategories) != ezSimdVec4i::ZeroVector());
+
+      ezUInt32 uiMask = GetLaneMask(hit);
+      while (uiMask > 0)
+      {
+        const ezUInt32 uiLane = ezMath::FirstBitLow(uiMask);
+        uiMask &= uiMask - 1;
+
+        const ezSpatialData* pData = node.m_DataPointers[uiPacket * 4 + uiLane];
+        if (!simdBox.Overlaps(pData->m_Bounds.GetBox()))
+          continue;
+
+        if (callback(pData->m_pObject) == ezVisitorExecution::Stop)
+          return ezVisitorExecution::Stop;
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        if (pStats != nullptr)
+        {
+          pStats->m_uiNumObjectsPassed++;
+        }
+#endif
+      }
+    }
+
+    return ezVisitorExecution::Continue;
+  });
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+  QueryStats* pStats, const ezOcclusionBuffer* pOcclusionBuffer) const
+{
+  FrustumPlanes planes;
+  ComputeFrustumPlanes(frustum, planes);
+
+  const ezSimdVec4i queryCategories(static_cast<ezInt32>(uiCategoryBitmask));
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumObjectsOccluded = 0;
+#endif
+
+  auto CollectObjects = [&](const Node& node, bool bFullyInside) {
+    // if the whole node is occluded the objects still go through the frustum test, so the stats stay exact
+    const bool bNodeOccluded = pOcclusionBuffer != nullptr && &node != m_pOverflowNode && !pOcclusionBuffer->IsVisible(node.GetLooseBox());
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    uiNumObjectsTested += node.m_DataPointers.GetCount();
+#endif
+
+    for (ezUInt32 uiPacket = 0; uiPacket < node.m_Packets.GetCount(); ++uiPacket)
+    {
+      const SpherePacket& packet = node.m_Packets[uiPacket];
+
+      ezSimdVec4b hit = (packet.GetCategoryBitmasks() & queryCategories) != ezSimdVec4i::ZeroVector();
+
+      if (!bFullyInside)
+      {
+        ezSimdVec4f x, y, z, r;
+        x.Load<4>(packet.m_x);
+        y.Load<4>(packet.m_y);
+        z.Load<4>(packet.m_z);
+        r.Load<4>(packet.m_r);
+
+        hit = hit && SpheresFrustumIntersect(x, y, z, r, planes);
+      }
+
+      ezUInt32 uiMask = GetLaneMask(hit);
+      while (uiMask > 0)
+      {
+        const ezUInt32 uiLane = ezMath::FirstBitLow(uiMask);
+        uiMask &= uiMask - 1;
+
+        const ezSpatialData* pData = node.m_DataPointers[uiPacket * 4 + uiLane];
+
+        if (bNodeOccluded || (pOcclusionBuffer != nullptr && !pOcclusionBuffer->IsVisible(pData->m_Bounds.GetBox())))
+        {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+          uiNumObjectsOccluded++;
+#endif
+          continue;
+        }
+
+        out_Objects.PushBack(pData->m_pObject);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        uiNumObjectsPassed++;
+#endif
+      }
+    }
+  };
+
+  struct StackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const Node* m_pNode;
+    bool m_bFullyInside;
+  };
+
+  ezHybridArray<StackEntry, 64> nodeStack;
+  nodeStack.PushBack({m_pRoot, false});
+
+  while (!nodeStack.IsEmpty())
+  {
+    const StackEntry entry = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const Node& node = *entry.m_pNode;
+    if ((node.m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    bool bFullyInside = entry.m_bFullyInside;
+    if (!bFullyInside)
+    {
+      const NodeFrustumResult result = TestNodeAgainstFrustum(node.m_CenterAndHalfSize, planes);
+      if (result == NodeFrustumResult::Outside)
+        continue;
+
+      bFullyInside = (result == NodeFrustumResult::Inside);
+    }
+
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      CollectObjects(node, bFullyInside);
+    }
+
+    for (const Node* pChild : node.m_Children)
+    {
+      if (pChild != nullptr)
+      {
+        nodeStack.PushBack({pChild, bFullyInside});
+      }
+    }
+  }
+
+  if ((m_pOverflowNode->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+  {
+    CollectObjects(*m_pOverflowNode, false);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested = uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumObjectsOccluded = uiNumObjectsOccluded;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::FindVisibleObjectsBatchInternal(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask,
+  ezDynamicArray<const ezGameObject*>& out_Objects, ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats) const
+{
+  const ezUInt32 uiNumFrusta = frusta.GetCount();
+
+  ezDynamicArray<FrustumPlanes, ezAlignedAllocatorWrapper> planes;
+  planes.SetCount(uiNumFrusta);
+
+  for (ezUInt32 i = 0; i < uiNumFrusta; ++i)
+  {
+    ComputeFrustumPlanes(frusta[i], planes[i]);
+  }
+
+  const ezSimdVec4i queryCategories(static_cast<ezInt32>(uiCategoryBitmask));
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+#endif
+
+  // uiTestMask contains the frusta that intersect the node and need to be tested per object,
+  // uiInsideMask the frusta that contain the node completely
+  auto CollectObjects = [&](const Node& node, ezUInt32 uiTestMask, ezUInt32 uiInsideMask) {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    uiNumObjectsTested += node.m_DataPointers.GetCount();
+#endif
+
+    for (ezUInt32 uiPacket = 0; uiPacket < node.m_Packets.GetCount(); ++uiPacket)
+    {
+      const SpherePacket& packet = node.m_Packets[uiPacket];
+
+      const ezUInt32 uiCategoryMask = GetLaneMask((packet.GetCategoryBitmasks() & queryCategories) != ezSimdVec4i::ZeroVector());
+      if (uiCategoryMask == 0)
+        continue;
+
+      ezUInt32 uiVisibilityMasks[4] = {uiInsideMask, uiInsideMask, uiInsideMask, uiInsideMask};
+
+      if (uiTestMask != 0)
+      {
+        ezSimdVec4f x, y, z, r;
+        x.Load<4>(packet.m_x);
+        y.Load<4>(packet.m_y);
+        z.Load<4>(packet.m_z);
+        r.Load<4>(packet.m_r);
+
+        ezUInt32 frustumMask = uiTestMask;
+        while (frustumMask > 0)
+        {
+          const ezUInt32 uiFrustum = ezMath::FirstBitLow(frustumMask);
+          frustumMask &= frustumMask - 1;
+
+          const ezUInt32 uiLaneMask = GetLaneMask(SpheresFrustumIntersect(x, y, z, r, planes[uiFrustum]));
+          for (ezUInt32 uiLane = 0; uiLane < 4; ++uiLane)
+          {
+            uiVisibilityMasks[uiLane] |= ((uiLaneMask >> uiLane) & 1) << uiFrustum;
+          }
+        }
+      }
+
+      ezUInt32 uiMask = uiCategoryMask;
+      while (uiMask > 0)
+      {
+        const ezUInt32 uiLane = ezMath::FirstBitLow(uiMask);
+        uiMask &= uiMask - 1;
+
+        if (uiVisibilityMasks[uiLane] == 0)
+          continue;
+
+        out_Objects.PushBack(node.m_DataPointers[uiPacket * 4 + uiLane]->m_pObject);
+        out_VisibilityMasks.PushBack(uiVisibilityMasks[uiLane]);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+        uiNumObjectsPassed++;
+#endif
+      }
+    }
+  };
+
+  struct StackEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const Node* m_pNode;
+    ezUInt32 m_uiTestMask;
+    ezUInt32 m_uiInsideMask;
+  };
+
+  const ezUInt32 uiAllFrustaMask = uiNumFrusta == 32 ? 0xFFFFFFFF : EZ_BIT(uiNumFrusta) - 1;
+
+  ezHybridArray<StackEntry, 64> nodeStack;
+  nodeStack.PushBack({m_pRoot, uiAllFrustaMask, 0});
+
+  while (!nodeStack.IsEmpty())
+  {
+    const StackEntry entry = nodeStack.PeekBack();
+    nodeStack.PopBack();
+
+    const Node& node = *entry.m_pNode;
+    if ((node.m_uiSubtreeCategoryBitmask & uiCategoryBitmask) == 0)
+      continue;
+
+    ezUInt32 uiTestMask = entry.m_uiTestMask;
+    ezUInt32 uiInsideMask = entry.m_uiInsideMask;
+
+    ezUInt32 frustumMask = entry.m_uiTestMask;
+    while (frustumMask > 0)
+    {
+      const ezUInt32 uiFrustum = ezMath::FirstBitLow(frustumMask);
+      frustumMask &= frustumMask - 1;
+
+      const NodeFrustumResult result = TestNodeAgainstFrustum(node.m_CenterAndHalfSize, planes[uiFrustum]);
+      if (result != NodeFrustumResult::Intersecting)
+      {
+        uiTestMask &= ~EZ_BIT(uiFrustum);
+
+        if (result == NodeFrustumResult::Inside)
+        {
+          uiInsideMask |= EZ_BIT(uiFrustum);
+        }
+      }
+    }
+
+    if ((uiTestMask | uiInsideMask) == 0)
+      continue;
+
+    if ((node.m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+    {
+      CollectObjects(node, uiTestMask, uiInsideMask);
+    }
+
+    for (const Node* pChild : node.m_Children)
+    {
+      if (pChild != nullptr)
+      {
+        nodeStack.PushBack({pChild, uiTestMask, uiInsideMask});
+      }
+    }
+  }
+
+  if ((m_pOverflowNode->m_uiCategoryBitmask & uiCategoryBitmask) != 0)
+  {
+    CollectObjects(*m_pOverflowNode, uiAllFrustaMask, 0);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
+  }
+#endif
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataAdded(ezSpatialData* pData)
+{
+  Node* pNode = GetOrCreateNode(pData->m_Bounds);
+  pNode->AddData(pData);
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataRemoved(ezSpatialData* pData)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+  if (Node* pNode = pUserData->m_pNode)
+  {
+    pNode->RemoveData(pData);
+    RemoveEmptyNodes(pNode);
+  }
+}
+
+void ezSpatialSystem_LooseOctree::SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  if (SpatialDataChangedInPlace(pData, oldBounds, uiOldCategoryBitmask))
+    return;
+
+  // the packet entries don't depend on the old category bitmask, so the data can simply be removed and added again
+  SpatialDataRemoved(pData);
+
+  if (pData->m_uiCategoryBitmask != 0)
+  {
+    SpatialDataAdded(pData);
+  }
+}
+
+bool ezSpatialSystem_LooseOctree::SpatialDataChangedInPlace(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  if (pData->m_uiCategoryBitmask != uiOldCategoryBitmask)
+    return false;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+  Node* pNode = pUserData->m_pNode;
+  if (pNode == nullptr || !IsBestNode(pNode, pData->m_Bounds))
+    return false;
+
+  pNode->UpdateData(pData, pUserData->m_uiDataIndex);
+  return true;
+}
+
+void ezSpatialSystem_LooseOctree::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
+{
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
+  if (Node* pNode = pUserData->m_pNode)
+  {
+    pNode->m_DataPointers[pUserData->m_uiDataIndex] = pNewPtr;
+  }
+}
+
+ezSpatialSystem_LooseOctree::Node* ezSpatialSystem_LooseOctree::CreateNode(Node* pParent, ezUInt32 uiChildIndex)
+{
+  Node* pNode = EZ_NEW(&m_AlignedAllocator, Node, &m_Allocator);
+
+  if (pParent != nullptr)
+  {
+    const ezSimdFloat fHalfSize = pParent->m_CenterAndHalfSize.w() * ezSimdFloat(0.5f);
+    const ezSimdVec4f vOffset((uiChildIndex & 1) ? 1.0f : -1.0f, (uiChildIndex & 2) ? 1.0f : -1.0f, (uiChildIndex & 4) ? 1.0f : -1.0f, 0.0f);
+
+    pNode->m_CenterAndHalfSize = pParent->m_CenterAndHalfSize + vOffset * fHalfSize;
+    pNode->m_CenterAndHalfSize.SetW(fHalfSize);
+    pNode->m_pParent = pParent;
+    pNode->m_uiChildIndex = uiChildIndex;
+    pNode->m_uiDepth = pParent->m_uiDepth + 1;
+
+    pParent->m_Children[uiChildIndex] = pNode;
+    pParent->m_uiNumChildren++;
+  }
+  else
+  {
+    pNode->m_CenterAndHalfSize.Set(0.0f, 0.0f, 0.0f, m_fRootHalfSize);
+  }
+
+  return pNode;
+}
+
+void ezSpatialSystem_LooseOctree::DeleteNode(Node* pNode)
+{
+  for (Node* pChild : pNode->m_Children)
+  {
+    if (pChild != nullptr)
+    {
+      DeleteNode(pChild);
+    }
+  }
+
+  EZ_DELETE(&m_AlignedAllocator, pNode);
+}
+
+void ezSpatialSystem_LooseOctree::RemoveEmptyNodes(Node* pNode)
+{
+  while (pNode->m_pParent != nullptr && pNode->IsEmpty())
+  {
+    Node* pParent = pNode->m_pParent;
+    pParent->m_Children[pNode->m_uiChildIndex] = nullptr;
+    pParent->m_uiNumChildren--;
+
+    DeleteNode(pNode);
+    pNode = pParent;
+  }
+}
+
+bool ezSpatialSystem_LooseOctree::IsBestNode(const Node* pNode, const ezSimdBBoxSphere& bounds) const
+{
+  const ezSimdFloat fMaxHalfExtent = GetMaxHalfExtent(bounds);
+
+  if (pNode == m_pOverflowNode)
+  {
+    const bool bFitsIntoRoot = (bounds.m_CenterAndRadius.Abs() <= ezSimdVec4f(m_fRootHalfSize)).AllSet<3>() && fMaxHalfExtent <= m_fRootHalfSize;
+    return !bFitsIntoRoot;
+  }
+
+  const ezSimdFloat fHalfSize = pNode->m_CenterAndHalfSize.w();
+
+  if (!((bounds.m_CenterAndRadius - pNode->m_CenterAndHalfSize).Abs() <= ezSimdVec4f(fHalfSize)).AllSet<3>() || fMaxHalfExtent > fHalfSize)
+    return false;
+
+  // the data would be stored in a child node, if it fits into one
+  return pNode->m_uiDepth == m_uiMaxDepth || fMaxHalfExtent > fHalfSize * ezSimdFloat(0.5f);
+}
+
+ezSpatialSystem_LooseOctree::Node* ezSpatialSystem_LooseOctree::GetOrCreateNode(const ezSimdBBoxSphere& bounds)
+{
+  const ezSimdFloat fMaxHalfExtent = GetMaxHalfExtent(bounds);
+
+  if (!(bounds.m_CenterAndRadius.Abs() <= ezSimdVec4f(m_fRootHalfSize)).AllSet<3>() || fMaxHalfExtent > m_fRootHalfSize)
+  {
+    return m_pOverflowNode;
+  }
+
+  Node* pNode = m_pRoot;
+
+  while (pNode->m_uiDepth < m_uiMaxDepth && fMaxHalfExtent <= pNode->m_CenterAndHalfSize.w() * ezSimdFloat(0.5f))
+  {
+    const ezUInt32 uiChildIndex = GetLaneMask(bounds.m_CenterAndRadius >= pNode->m_CenterAndHalfSize) & 7;
+
+    Node* pChild = pNode->m_Children[uiChildIndex];
+    if (pChild == nullptr)
+    {
+      pChild = CreateNode(pNode, uiChildIndex);
+    }
+
+    pNode = pChild;
+  }
+
+  return pNode;
+}
+
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_SpatialSystem_LooseOctree);
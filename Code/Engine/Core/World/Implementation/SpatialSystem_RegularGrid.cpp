@@ -1,5 +1,6 @@
 #include <CorePCH.h>
 
+#include <Core/World/OcclusionBuffer.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Containers/HashSet.h>
 #include <Foundation/SimdMath/SimdConversion.h>
@@ -119,6 +120,48 @@ namespace
 
     return result;
   }
+
+  ezSimdBBox ComputeFrustumBoundingBox(const ezFrustum& frustum)
+  {
+    ezVec3 cornerPoints[8];
+    frustum.ComputeCornerPoints(cornerPoints);
+
+    ezSimdVec4f simdCornerPoints[8];
+    for (ezUInt32 i = 0; i < 8; ++i)
+    {
+      simdCornerPoints[i] = ezSimdConversion::ToVec3(cornerPoints[i]);
+    }
+
+    ezSimdBBox simdBox;
+    simdBox.SetFromPoints(simdCornerPoints, 8);
+    return simdBox;
+  }
+
+  void ComputePlaneData(const ezFrustum& frustum, PlaneData& out_PlaneData)
+  {
+    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
+    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
+    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
+    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
+    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
+    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
+    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+
+    ezSimdMat4f helperMat;
+    helperMat.SetRows(plane0, plane1, plane2, plane3);
+
+    out_PlaneData.m_x0x1x2x3 = helperMat.m_col0;
+    out_PlaneData.m_y0y1y2y3 = helperMat.m_col1;
+    out_PlaneData.m_z0z1z2z3 = helperMat.m_col2;
+    out_PlaneData.m_w0w1w2w3 = helperMat.m_col3;
+
+    helperMat.SetRows(plane4, plane5, plane4, plane5);
+
+    out_PlaneData.m_x4x5x4x5 = helperMat.m_col0;
+    out_PlaneData.m_y4y5y4y5 = helperMat.m_col1;
+    out_PlaneData.m_z4z5z4z5 = helperMat.m_col2;
+    out_PlaneData.m_w4w5w4w5 = helperMat.m_col3;
+  }
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -450,56 +493,45 @@ void ezSpatialSystem_RegularGrid::FindObjectsInBoxInternal(const ezBoundingBox&
 }
 
 void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
-  QueryStats* pStats) const
+  QueryStats* pStats, const ezOcclusionBuffer* pOcclusionBuffer) const
 {
-  ezVec3 cornerPoints[8];
-  frustum.ComputeCornerPoints(cornerPoints);
-
-  ezSimdVec4f simdCornerPoints[8];
-  for (ezUInt32 i = 0; i < 8; ++i)
-  {
-    simdCornerPoints[i] = ezSimdConversion::ToVec3(cornerPoints[i]);
-  }
-
-  ezSimdBBox simdBox;
-  simdBox.SetFromPoints(simdCornerPoints, 8);
+  const ezSimdBBox simdBox = ComputeFrustumBoundingBox(frustum);
 
   PlaneData planeData;
-  {
-    // Compiler is too stupid to properly unroll a constant loop so we do it by hand
-    ezSimdVec4f plane0 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(0).m_vNormal.x)));
-    ezSimdVec4f plane1 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(1).m_vNormal.x)));
-    ezSimdVec4f plane2 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(2).m_vNormal.x)));
-    ezSimdVec4f plane3 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(3).m_vNormal.x)));
-    ezSimdVec4f plane4 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(4).m_vNormal.x)));
-    ezSimdVec4f plane5 = ezSimdConversion::ToVec4(*reinterpret_cast<const ezVec4*>(&(frustum.GetPlane(5).m_vNormal.x)));
+  ComputePlaneData(frustum, planeData);
 
-    ezSimdMat4f helperMat;
-    helperMat.SetRows(plane0, plane1, plane2, plane3);
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+  ezUInt32 uiNumObjectsOccluded = 0;
+#endif
 
-    planeData.m_x0x1x2x3 = helperMat.m_col0;
-    planeData.m_y0y1y2y3 = helperMat.m_col1;
-    planeData.m_z0z1z2z3 = helperMat.m_col2;
-    planeData.m_w0w1w2w3 = helperMat.m_col3;
+  bool bCellOccluded = false;
 
-    helperMat.SetRows(plane4, plane5, plane4, plane5);
+  auto AddObject = [&](const ezSpatialData* pData) {
+    if (bCellOccluded || (pOcclusionBuffer != nullptr && !pOcclusionBuffer->IsVisible(pData->m_Bounds.GetBox())))
+    {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      uiNumObjectsOccluded++;
+#endif
+      return;
+    }
 
-    planeData.m_x4x5x4x5 = helperMat.m_col0;
-    planeData.m_y4y5y4y5 = helperMat.m_col1;
-    planeData.m_z4z5z4z5 = helperMat.m_col2;
-    planeData.m_w4w5w4w5 = helperMat.m_col3;
-  }
+    out_Objects.PushBack(pData->m_pObject);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  ezUInt32 uiNumObjectsTested = 0;
-  ezUInt32 uiNumObjectsPassed = 0;
+    uiNumObjectsPassed++;
 #endif
+  };
 
   ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
     ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
     if (!SphereFrustumIntersect(cellSphere, planeData))
       return;
 
+    // if the whole cell is occluded the objects still go through the frustum test, so the stats stay exact
+    bCellOccluded = pOcclusionBuffer != nullptr && !pOcclusionBuffer->IsVisible(cell.m_Bounds.GetBox());
+
     ezUInt32 filteredMask = uiFilteredCategoryBitmask;
     while (filteredMask > 0)
     {
@@ -535,12 +567,7 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
             ezUInt32 i = ezMath::FirstBitLow(mask);
             mask &= mask - 1;
 
-            ezSpatialData* pData = dataPointers[currentIndex + i];
-            out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-            uiNumObjectsPassed++;
-#endif
+            AddObject(dataPointers[currentIndex + i]);
           }
 
           currentIndex += 32;
@@ -554,12 +581,7 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
           if (!SphereFrustumIntersect(objectSphere, planeData))
             continue;
 
-          ezSpatialData* pData = dataPointers[i];
-          out_Objects.PushBack(pData->m_pObject);
-
-#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-          uiNumObjectsPassed++;
-#endif
+          AddObject(dataPointers[i]);
         }
       }
     }
@@ -570,6 +592,173 @@ void ezSpatialSystem_RegularGrid::FindVisibleObjectsInternal(const ezFrustum& fr
   {
     pStats->m_uiNumObjectsTested = uiNumObjectsTested;
     pStats->m_uiNumObjectsPassed = uiNumObjectsPassed;
+    pStats->m_uiNumObjectsOccluded = uiNumObjectsOccluded;
+  }
+#endif
+}
+
+void ezSpatialSystem_RegularGrid::FindVisibleObjectsBatchInternal(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask,
+  ezDynamicArray<const ezGameObject*>& out_Objects, ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats) const
+{
+  const ezUInt32 uiNumFrusta = frusta.GetCount();
+
+  ezDynamicArray<PlaneData, ezAlignedAllocatorWrapper> planeData;
+  planeData.SetCount(uiNumFrusta);
+
+  ezDynamicArray<ezSimdBBox, ezAlignedAllocatorWrapper> frustumBoxes;
+  frustumBoxes.SetCount(uiNumFrusta);
+
+  ezSimdBBox simdBox;
+  simdBox.SetInvalid();
+
+  for (ezUInt32 i = 0; i < uiNumFrusta; ++i)
+  {
+    ComputePlaneData(frusta[i], planeData[i]);
+    frustumBoxes[i] = ComputeFrustumBoundingBox(frusta[i]);
+    simdBox.ExpandToInclude(frustumBoxes[i]);
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  ezUInt32 uiNumObjectsTested = 0;
+  ezUInt32 uiNumObjectsPassed = 0;
+#endif
+
+  auto AddObject = [&](const ezSpatialData* pData, ezUInt32 uiVisibilityMask) {
+    out_Objects.PushBack(pData->m_pObject);
+    out_VisibilityMasks.PushBack(uiVisibilityMask);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    uiNumObjectsPassed++;
+#endif
+  };
+
+  auto ProcessCell = [&](const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+    // only the frusta that intersect the cell need to be tested against its objects
+    const ezSimdBBox cellBox = cell.m_Bounds.GetBox();
+    const ezSimdBSphere cellSphere = cell.m_Bounds.GetSphere();
+
+    ezUInt32 uiCellFrustumMask = 0;
+    for (ezUInt32 i = 0; i < uiNumFrusta; ++i)
+    {
+      if (cellBox.Overlaps(frustumBoxes[i]) && SphereFrustumIntersect(cellSphere, planeData[i]))
+      {
+        uiCellFrustumMask |= EZ_BIT(i);
+      }
+    }
+
+    if (uiCellFrustumMask == 0)
+      return;
+
+    ezUInt32 filteredMask = uiFilteredCategoryBitmask;
+    while (filteredMask > 0)
+    {
+      ezUInt32 category = ezMath::FirstBitLow(filteredMask);
+      filteredMask &= filteredMask - 1;
+
+      auto& boundingSpheres = cell.m_BoundingSpheres[category];
+      auto& dataPointers = cell.m_DataPointers[category];
+
+      const ezUInt32 numSpheres = boundingSpheres.GetCount();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      uiNumObjectsTested += numSpheres;
+#endif
+
+      ezUInt32 currentIndex = 0;
+
+      for (; currentIndex + 1 < numSpheres; currentIndex += 2)
+      {
+        auto& objectSphereA = boundingSpheres[currentIndex + 0];
+        auto& objectSphereB = boundingSpheres[currentIndex + 1];
+
+        ezUInt32 uiMaskA = 0;
+        ezUInt32 uiMaskB = 0;
+
+        ezUInt32 frustumMask = uiCellFrustumMask;
+        while (frustumMask > 0)
+        {
+          const ezUInt32 uiFrustum = ezMath::FirstBitLow(frustumMask);
+          frustumMask &= frustumMask - 1;
+
+          const ezUInt32 result = SphereFrustumIntersect(objectSphereA, objectSphereB, planeData[uiFrustum]);
+          uiMaskA |= (result & 1) << uiFrustum;
+          uiMaskB |= (result >> 1) << uiFrustum;
+        }
+
+        if (uiMaskA != 0)
+        {
+          AddObject(dataPointers[currentIndex + 0], uiMaskA);
+        }
+
+        if (uiMaskB != 0)
+        {
+          AddObject(dataPointers[currentIndex + 1], uiMaskB);
+        }
+      }
+
+      if (currentIndex < numSpheres)
+      {
+        auto& objectSphere = boundingSpheres[currentIndex];
+
+        ezUInt32 uiMask = 0;
+
+        ezUInt32 frustumMask = uiCellFrustumMask;
+        while (frustumMask > 0)
+        {
+          const ezUInt32 uiFrustum = ezMath::FirstBitLow(frustumMask);
+          frustumMask &= frustumMask - 1;
+
+          if (SphereFrustumIntersect(objectSphere, planeData[uiFrustum]))
+          {
+            uiMask |= EZ_BIT(uiFrustum);
+          }
+        }
+
+        if (uiMask != 0)
+        {
+          AddObject(dataPointers[currentIndex], uiMask);
+        }
+      }
+    }
+  };
+
+  // Frusta that are far apart, e.g. the faces of several point light shadows, span a large box with mostly empty cells.
+  // In that case it is cheaper to visit all existing cells instead of looking up every cell index in the box.
+  const ezSimdVec4i minIndex = ToVec3I32((simdBox.m_Min - m_fOverlapSize) * m_fInvCellSize);
+  const ezSimdVec4i maxIndex = ToVec3I32((simdBox.m_Max + m_fOverlapSize) * m_fInvCellSize);
+  const ezSimdVec4i diff = maxIndex - minIndex + ezSimdVec4i(1);
+  const ezUInt64 uiNumCellsInBox = ezUInt64(diff.x()) * ezUInt64(diff.y()) * ezUInt64(diff.z());
+
+  if (uiNumCellsInBox <= m_Cells.GetCount())
+  {
+    ForEachCellInBox(simdBox, uiCategoryBitmask, [&](const ezSimdVec4i& cellIndex, ezUInt64 cellKey, const Cell& cell, ezUInt32 uiFilteredCategoryBitmask) {
+      ProcessCell(cell, uiFilteredCategoryBitmask);
+    });
+  }
+  else
+  {
+    for (auto it = m_Cells.GetIterator(); it.IsValid(); ++it)
+    {
+      const Cell& cell = *it.Value();
+      const ezUInt32 uiFilteredCategoryBitmask = cell.m_uiCategoryBitmask & uiCategoryBitmask;
+      if (uiFilteredCategoryBitmask != 0)
+      {
+        ProcessCell(cell, uiFilteredCategoryBitmask);
+      }
+    }
+
+    const ezUInt32 uiFilteredCategoryBitmask = m_pOverflowCell->m_uiCategoryBitmask & uiCategoryBitmask;
+    if (uiFilteredCategoryBitmask != 0)
+    {
+      ProcessCell(*m_pOverflowCell, uiFilteredCategoryBitmask);
+    }
+  }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (pStats != nullptr)
+  {
+    pStats->m_uiNumObjectsTested += uiNumObjectsTested;
+    pStats->m_uiNumObjectsPassed += uiNumObjectsPassed;
   }
 #endif
 }
@@ -631,6 +820,23 @@ void ezSpatialSystem_RegularGrid::SpatialDataChanged(ezSpatialData* pData, const
   }
 }
 
+bool ezSpatialSystem_RegularGrid::SpatialDataChangedInPlace(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask)
+{
+  if (pData->m_uiCategoryBitmask != uiOldCategoryBitmask)
+    return false;
+
+  auto pUserData = reinterpret_cast<SpatialUserData*>(&pData->m_uiUserData[0]);
+
+  // As long as the data stays in its cell, only its own bounding sphere entries in that cell are written,
+  // which does not conflict with other data in the same cell. Moving to another cell changes the arrays of both cells though.
+  Cell* pCell = pUserData->m_pCell;
+  if (pCell == nullptr || !pCell->m_Bounds.GetBox().Contains(pData->m_Bounds.GetBox()))
+    return false;
+
+  pCell->UpdateData(pData);
+  return true;
+}
+
 void ezSpatialSystem_RegularGrid::FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr)
 {
   auto pUserData = reinterpret_cast<SpatialUserData*>(&pNewPtr->m_uiUserData[0]);
@@ -229,6 +229,7 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
 
   // link the transformation data to the game object
   pNewObject->m_pTransformationData = pTransformationData;
+  pNewObject->MarkTransformDirty();
 
   // fix links
   LinkToParent(pNewObject);
@@ -1274,6 +1275,7 @@ void ezWorld::PatchHierarchyData(ezGameObject* pObject, ezGameObject::TransformP
   RecreateHierarchyData(pObject, pObject->IsDynamic());
 
   pObject->m_pTransformationData->m_pParentData = pParent != nullptr ? pParent->m_pTransformationData : nullptr;
+  pObject->MarkTransformDirty();
 
   if (preserve == ezGameObject::TransformPreservation::PreserveGlobal)
   {
@@ -1305,10 +1307,14 @@ void ezWorld::RecreateHierarchyData(ezGameObject* pObject, bool bWasDynamic)
     ezGameObject::TransformationData* pOldTransformationData = pObject->m_pTransformationData;
 
     ezGameObject::TransformationData* pNewTransformationData = m_Data.CreateTransformationData(bIsDynamic, uiNewHierarchyLevel);
+    const ezUInt32 uiNewBlockIndex = pNewTransformationData->m_uiBlockIndex;
     ezMemoryUtils::Copy(pNewTransformationData, pOldTransformationData, 1);
+    pNewTransformationData->m_uiBlockIndex = uiNewBlockIndex;
+    pNewTransformationData->m_uiDirtyFrames = 0;
 
     pObject->m_uiHierarchyLevel = uiNewHierarchyLevel;
     pObject->m_pTransformationData = pNewTransformationData;
+    pObject->MarkTransformDirty();
 
     // fix parent transform data for children as well
     for (auto it = pObject->GetChildren(); it.IsValid(); ++it)
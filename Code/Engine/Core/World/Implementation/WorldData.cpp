@@ -1,9 +1,11 @@
 #include <CorePCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
 
 #include <Foundation/Time/DefaultTimeStepSmoothing.h>
+#include <Foundation/Utilities/Stats.h>
 
 namespace ezInternal
 {
@@ -90,7 +92,14 @@ namespace ezInternal
 
     if (m_pSpatialSystem == nullptr && desc.m_bAutoCreateSpatialSystem)
     {
-      m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      if (desc.m_SpatialSystemType == ezSpatialSystemType::LooseOctree)
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_LooseOctree);
+      }
+      else
+      {
+        m_pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+      }
     }
 
     if (m_pCoordinateSystemProvider == nullptr)
@@ -123,6 +132,7 @@ namespace ezInternal
           m_BlockAllocator.DeallocateBlock((*blocks)[j]);
         }
         EZ_DELETE(&m_Allocator, blocks);
+        EZ_DELETE(&m_Allocator, hierarchy.m_DirtyBlocks[i]);
       }
     }
 
@@ -162,6 +172,7 @@ namespace ezInternal
     while (uiHierarchyLevel >= hierarchy.m_Data.GetCount())
     {
       hierarchy.m_Data.PushBack(EZ_NEW(&m_Allocator, Hierarchy::DataBlockArray, &m_Allocator));
+      hierarchy.m_DirtyBlocks.PushBack(EZ_NEW(&m_Allocator, Hierarchy::DirtyBlockBits, &m_Allocator));
     }
 
     Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[uiHierarchyLevel];
@@ -176,9 +187,20 @@ namespace ezInternal
     {
       blocks.PushBack(m_BlockAllocator.AllocateBlock<ezGameObject::TransformationData>());
       pBlock = &blocks.PeekBack();
+
+      Hierarchy::DirtyBlockBits& dirtyBlocks = *hierarchy.m_DirtyBlocks[uiHierarchyLevel];
+      const ezUInt32 uiNumDirtyBlockWords = (blocks.GetCount() + 31) / 32;
+      if (dirtyBlocks.GetCount() < uiNumDirtyBlockWords)
+      {
+        dirtyBlocks.SetCount(uiNumDirtyBlockWords, 0);
+      }
     }
 
-    return pBlock->ReserveBack();
+    ezGameObject::TransformationData* pData = pBlock->ReserveBack();
+    pData->m_uiBlockIndex = blocks.GetCount() - 1;
+    pData->m_uiDirtyFrames = 0;
+
+    return pData;
   }
 
   void WorldData::DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData)
@@ -191,9 +213,16 @@ namespace ezInternal
 
     if (pData != pLast)
     {
+      const ezUInt32 uiBlockIndex = pData->m_uiBlockIndex;
       ezMemoryUtils::Copy(pData, pLast, 1);
+      pData->m_uiBlockIndex = uiBlockIndex;
       pData->m_pObject->m_pTransformationData = pData;
 
+      if (pData->m_uiDirtyFrames > 0)
+      {
+        MarkBlockDirty(*hierarchy.m_DirtyBlocks[uiHierarchyLevel], uiBlockIndex);
+      }
+
       // fix parent transform data for children as well
       auto it = pData->m_pObject->GetChildren();
       while (it.IsValid())
@@ -211,6 +240,13 @@ namespace ezInternal
     }
   }
 
+  void WorldData::MarkTransformationDataDirty(ezGameObject::TransformationData* pData, ezUInt32 uiHierarchyLevel)
+  {
+    pData->m_uiDirtyFrames = ezGameObject::TransformationData::DirtyFrames;
+
+    MarkBlockDirty(*m_Hierarchies[HierarchyType::Dynamic].m_DirtyBlocks[uiHierarchyLevel], pData->m_uiBlockIndex);
+  }
+
   void WorldData::TraverseBreadthFirst(VisitorFunc& func)
   {
     struct Helper
@@ -280,82 +316,349 @@ namespace ezInternal
     return ezVisitorExecution::Continue;
   }
 
-  void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
+  namespace
   {
-    struct UserData
+    /// Transposes four AoS vectors, so that out_x holds the x components of a, b, c and d and so on.
+    EZ_ALWAYS_INLINE void Transpose4(const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c, const ezSimdVec4f& d, ezSimdVec4f& out_x, ezSimdVec4f& out_y, ezSimdVec4f& out_z, ezSimdVec4f& out_w)
     {
-      ezSimdFloat m_fInvDt;
-      ezSpatialSystem* m_pSpatialSystem;
-    };
+      ezSimdMat4f m(a, b, c, d);
+      m.Transpose();
 
-    UserData userData;
-    userData.m_fInvDt = fInvDeltaSeconds;
-    userData.m_pSpatialSystem = m_pSpatialSystem.Borrow();
+      out_x = m.m_col0;
+      out_y = m.m_col1;
+      out_z = m.m_col2;
+      out_w = m.m_col3;
+    }
+  } // namespace
 
-    struct RootLevel
+  // static
+  template <bool WithParent>
+  void WorldData::UpdateGlobalTransformsAndBounds4(ezGameObject::TransformationData* const* pData)
+  {
+    // Same math as TransformationData::UpdateGlobalTransformWithParent() and UpdateGlobalBounds(), but for four objects at once.
+    // Especially the bounds transformation profits, since the rotation matrix and its column lengths don't need any shuffles.
+    ezSimdVec4f posX, posY, posZ, posW;
+    ezSimdVec4f rotX, rotY, rotZ, rotW;
+    ezSimdVec4f scaleX, scaleY, scaleZ, scaleW;
+
+    Transpose4(pData[0]->m_localPosition, pData[1]->m_localPosition, pData[2]->m_localPosition, pData[3]->m_localPosition, posX, posY, posZ, posW);
+    Transpose4(pData[0]->m_localRotation.m_v, pData[1]->m_localRotation.m_v, pData[2]->m_localRotation.m_v, pData[3]->m_localRotation.m_v, rotX, rotY, rotZ, rotW);
+    Transpose4(pData[0]->m_localScaling * pData[0]->m_localScaling.w(), pData[1]->m_localScaling * pData[1]->m_localScaling.w(),
+      pData[2]->m_localScaling * pData[2]->m_localScaling.w(), pData[3]->m_localScaling * pData[3]->m_localScaling.w(), scaleX, scaleY, scaleZ, scaleW);
+
+    if (WithParent)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      ezSimdVec4f pPosX, pPosY, pPosZ, pPosW;
+      ezSimdVec4f pRotX, pRotY, pRotZ, pRotW;
+      ezSimdVec4f pScaleX, pScaleY, pScaleZ, pScaleW;
+
+      Transpose4(pData[0]->m_pParentData->m_globalTransform.m_Position, pData[1]->m_pParentData->m_globalTransform.m_Position,
+        pData[2]->m_pParentData->m_globalTransform.m_Position, pData[3]->m_pParentData->m_globalTransform.m_Position, pPosX, pPosY, pPosZ, pPosW);
+      Transpose4(pData[0]->m_pParentData->m_globalTransform.m_Rotation.m_v, pData[1]->m_pParentData->m_globalTransform.m_Rotation.m_v,
+        pData[2]->m_pParentData->m_globalTransform.m_Rotation.m_v, pData[3]->m_pParentData->m_globalTransform.m_Rotation.m_v, pRotX, pRotY, pRotZ, pRotW);
+      Transpose4(pData[0]->m_pParentData->m_globalTransform.m_Scale, pData[1]->m_pParentData->m_globalTransform.m_Scale,
+        pData[2]->m_pParentData->m_globalTransform.m_Scale, pData[3]->m_pParentData->m_globalTransform.m_Scale, pScaleX, pScaleY, pScaleZ, pScaleW);
+
+      // position = parentRotation * (localPosition * parentScale) + parentPosition
       {
-        WorldData::UpdateGlobalTransform(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        const ezSimdVec4f vX = posX.CompMul(pScaleX);
+        const ezSimdVec4f vY = posY.CompMul(pScaleY);
+        const ezSimdVec4f vZ = posZ.CompMul(pScaleZ);
+
+        // t = 2 * cross(q, v), v' = v + t * q.w + cross(q, t)
+        ezSimdVec4f tX = pRotY.CompMul(vZ) - pRotZ.CompMul(vY);
+        ezSimdVec4f tY = pRotZ.CompMul(vX) - pRotX.CompMul(vZ);
+        ezSimdVec4f tZ = pRotX.CompMul(vY) - pRotY.CompMul(vX);
+        tX += tX;
+        tY += tY;
+        tZ += tZ;
+
+        posX = vX + tX.CompMul(pRotW) + (pRotY.CompMul(tZ) - pRotZ.CompMul(tY)) + pPosX;
+        posY = vY + tY.CompMul(pRotW) + (pRotZ.CompMul(tX) - pRotX.CompMul(tZ)) + pPosY;
+        posZ = vZ + tZ.CompMul(pRotW) + (pRotX.CompMul(tY) - pRotY.CompMul(tX)) + pPosZ;
+        posW = posW.CompMul(pScaleW) + pPosW;
       }
-    };
 
-    struct WithParent
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
+      // rotation = parentRotation * localRotation
       {
-        WorldData::UpdateGlobalTransformWithParent(pData, static_cast<UserData*>(pUserData)->m_fInvDt);
-        return ezVisitorExecution::Continue;
+        const ezSimdVec4f qX = rotW.CompMul(pRotX) + pRotW.CompMul(rotX) + (pRotY.CompMul(rotZ) - pRotZ.CompMul(rotY));
+        const ezSimdVec4f qY = rotW.CompMul(pRotY) + pRotW.CompMul(rotY) + (pRotZ.CompMul(rotX) - pRotX.CompMul(rotZ));
+        const ezSimdVec4f qZ = rotW.CompMul(pRotZ) + pRotW.CompMul(rotZ) + (pRotX.CompMul(rotY) - pRotY.CompMul(rotX));
+        rotW = pRotW.CompMul(rotW) - (pRotX.CompMul(rotX) + pRotY.CompMul(rotY) + pRotZ.CompMul(rotZ));
+        rotX = qX;
+        rotY = qY;
+        rotZ = qZ;
       }
-    };
 
-    struct RootLevelWithSpatialData
-    {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
-      }
-    };
+      scaleX = pScaleX.CompMul(scaleX);
+      scaleY = pScaleY.CompMul(scaleY);
+      scaleZ = pScaleZ.CompMul(scaleZ);
+      scaleW = pScaleW.CompMul(scaleW);
+    }
 
-    struct WithParentWithSpatialData
+    // the rotation matrix of the global transform, with the scale applied to its columns, see ezSimdQuat::GetAsMat4()
+    const ezSimdVec4f one(1.0f);
+    const ezSimdVec4f x2 = rotX + rotX;
+    const ezSimdVec4f y2 = rotY + rotY;
+    const ezSimdVec4f z2 = rotZ + rotZ;
+    const ezSimdVec4f xx2 = rotX.CompMul(x2);
+    const ezSimdVec4f yy2 = rotY.CompMul(y2);
+    const ezSimdVec4f zz2 = rotZ.CompMul(z2);
+    const ezSimdVec4f xy2 = rotX.CompMul(y2);
+    const ezSimdVec4f yz2 = rotY.CompMul(z2);
+    const ezSimdVec4f xz2 = rotX.CompMul(z2);
+    const ezSimdVec4f wx2 = rotW.CompMul(x2);
+    const ezSimdVec4f wy2 = rotW.CompMul(y2);
+    const ezSimdVec4f wz2 = rotW.CompMul(z2);
+
+    const ezSimdVec4f c0X = (one - (yy2 + zz2)).CompMul(scaleX);
+    const ezSimdVec4f c0Y = (xy2 + wz2).CompMul(scaleX);
+    const ezSimdVec4f c0Z = (xz2 - wy2).CompMul(scaleX);
+    const ezSimdVec4f c1X = (xy2 - wz2).CompMul(scaleY);
+    const ezSimdVec4f c1Y = (one - (xx2 + zz2)).CompMul(scaleY);
+    const ezSimdVec4f c1Z = (yz2 + wx2).CompMul(scaleY);
+    const ezSimdVec4f c2X = (xz2 + wy2).CompMul(scaleZ);
+    const ezSimdVec4f c2Y = (yz2 - wx2).CompMul(scaleZ);
+    const ezSimdVec4f c2Z = (one - (xx2 + yy2)).CompMul(scaleZ);
+
+    ezSimdVec4f centerX, centerY, centerZ, radius;
+    ezSimdVec4f extentsX, extentsY, extentsZ, extentsW;
+    Transpose4(pData[0]->m_localBounds.m_CenterAndRadius, pData[1]->m_localBounds.m_CenterAndRadius, pData[2]->m_localBounds.m_CenterAndRadius,
+      pData[3]->m_localBounds.m_CenterAndRadius, centerX, centerY, centerZ, radius);
+    Transpose4(pData[0]->m_localBounds.m_BoxHalfExtents, pData[1]->m_localBounds.m_BoxHalfExtents, pData[2]->m_localBounds.m_BoxHalfExtents,
+      pData[3]->m_localBounds.m_BoxHalfExtents, extentsX, extentsY, extentsZ, extentsW);
+
+    // see ezSimdBBoxSphere::Transform()
+    const ezSimdVec4f newCenterX = c0X.CompMul(centerX) + c1X.CompMul(centerY) + c2X.CompMul(centerZ) + posX;
+    const ezSimdVec4f newCenterY = c0Y.CompMul(centerX) + c1Y.CompMul(centerY) + c2Y.CompMul(centerZ) + posY;
+    const ezSimdVec4f newCenterZ = c0Z.CompMul(centerX) + c1Z.CompMul(centerY) + c2Z.CompMul(centerZ) + posZ;
+
+    const ezSimdVec4f lengthSqr0 = c0X.CompMul(c0X) + c0Y.CompMul(c0Y) + c0Z.CompMul(c0Z);
+    const ezSimdVec4f lengthSqr1 = c1X.CompMul(c1X) + c1Y.CompMul(c1Y) + c1Z.CompMul(c1Z);
+    const ezSimdVec4f lengthSqr2 = c2X.CompMul(c2X) + c2Y.CompMul(c2Y) + c2Z.CompMul(c2Z);
+    const ezSimdVec4f newRadius = radius.CompMul(lengthSqr0.CompMax(lengthSqr1).CompMax(lengthSqr2).GetSqrt());
+
+    const ezSimdVec4f newExtentsX = (c0X.Abs().CompMul(extentsX) + c1X.Abs().CompMul(extentsY) + c2X.Abs().CompMul(extentsZ)).CompMin(newRadius);
+    const ezSimdVec4f newExtentsY = (c0Y.Abs().CompMul(extentsX) + c1Y.Abs().CompMul(extentsY) + c2Y.Abs().CompMul(extentsZ)).CompMin(newRadius);
+    const ezSimdVec4f newExtentsZ = (c0Z.Abs().CompMul(extentsX) + c1Z.Abs().CompMul(extentsY) + c2Z.Abs().CompMul(extentsZ)).CompMin(newRadius);
+
+    // transpose back into the AoS layout of the transformation data
+    ezSimdVec4f position[4], rotation[4], scale[4], centerAndRadius[4], halfExtents[4];
+    Transpose4(posX, posY, posZ, posW, position[0], position[1], position[2], position[3]);
+    Transpose4(rotX, rotY, rotZ, rotW, rotation[0], rotation[1], rotation[2], rotation[3]);
+    Transpose4(scaleX, scaleY, scaleZ, scaleW, scale[0], scale[1], scale[2], scale[3]);
+    Transpose4(newCenterX, newCenterY, newCenterZ, newRadius, centerAndRadius[0], centerAndRadius[1], centerAndRadius[2], centerAndRadius[3]);
+    // the w component keeps the 'always visible' flag of the local bounds
+    Transpose4(newExtentsX, newExtentsY, newExtentsZ, extentsW, halfExtents[0], halfExtents[1], halfExtents[2], halfExtents[3]);
+
+    for (ezUInt32 i = 0; i < 4; ++i)
     {
-      EZ_ALWAYS_INLINE static ezVisitorExecution::Enum Visit(ezGameObject::TransformationData* pData, void* pUserData)
-      {
-        WorldData::UpdateGlobalTransformWithParentAndSpatialData(pData, static_cast<UserData*>(pUserData)->m_fInvDt,
-          *static_cast<UserData*>(pUserData)->m_pSpatialSystem);
-        return ezVisitorExecution::Continue;
-      }
-    };
+      ezGameObject::TransformationData* pCurrentData = pData[i];
+      pCurrentData->m_globalTransform.m_Position = position[i];
+      pCurrentData->m_globalTransform.m_Rotation.m_v = rotation[i];
+      pCurrentData->m_globalTransform.m_Scale = scale[i];
+      pCurrentData->m_globalBounds.m_CenterAndRadius = centerAndRadius[i];
+      pCurrentData->m_globalBounds.m_BoxHalfExtents = halfExtents[i];
+    }
+  }
+
+  // static
+  template <bool WithParent>
+  void WorldData::UpdateGlobalTransformsOfLevel(Hierarchy::DataBlockArray& blocks, Hierarchy::DirtyBlockBits& dirtyBlocks,
+    Hierarchy::DirtyBlockBits* pChildDirtyBlocks, const ezSimdFloat& fInvDeltaSeconds, DeferredSpatialDataUpdates* pSpatialDataUpdates,
+    TransformUpdateStats& stats)
+  {
+    ezParallelForParams parallelForParams;
+    parallelForParams.uiBinSize = 4;
+    parallelForParams.partitioning = ezParallelForPartitioning::Adaptive;
+
+    ezTaskSystem::ParallelForIndexed(0, blocks.GetCount(),
+      [&](ezUInt32 uiStartBlock, ezUInt32 uiEndBlock) {
+        ezHybridArray<ezSpatialSystem::SpatialDataUpdate, 64> localUpdates;
+        ezHybridArray<DeferredSpatialData, 16> localRecreate;
+        ezUInt32 uiNumUpdated = 0;
+        ezUInt32 uiNumSkipped = 0;
+
+        // dirty objects are collected in batches of four, whose transforms and bounds are computed together
+        ezGameObject::TransformationData* batch[4];
+        ezSimdBBoxSphere batchOldBounds[4];
+        ezUInt32 uiBatchCount = 0;
+
+        auto processBatch = [&]() {
+          // pad an incomplete batch by repeating the last object, which just computes the same result twice
+          for (ezUInt32 i = uiBatchCount; i < 4; ++i)
+          {
+            batch[i] = batch[uiBatchCount - 1];
+          }
+
+          UpdateGlobalTransformsAndBounds4<WithParent>(batch);
+
+          for (ezUInt32 i = 0; i < uiBatchCount; ++i)
+          {
+            ezGameObject::TransformationData* pCurrentData = batch[i];
+            pCurrentData->UpdateVelocity(fInvDeltaSeconds);
+
+            if (pSpatialDataUpdates == nullptr)
+              continue;
+
+            const ezSimdBBoxSphere& oldGlobalBounds = batchOldBounds[i];
+
+            // Can't use ezSimdBBoxSphere::operator != because we want to include the w component of m_BoxHalfExtents
+            if (!(pCurrentData->m_globalBounds.m_CenterAndRadius != oldGlobalBounds.m_CenterAndRadius ||
+                    pCurrentData->m_globalBounds.m_BoxHalfExtents != oldGlobalBounds.m_BoxHalfExtents)
+                   .AnySet<4>())
+              continue;
+
+            const bool bWasAlwaysVisible = oldGlobalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+            const bool bIsAlwaysVisible = pCurrentData->m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+
+            if (!bWasAlwaysVisible && !bIsAlwaysVisible && !pCurrentData->m_hSpatialData.IsInvalidated() && pCurrentData->m_globalBounds.IsValid())
+            {
+              auto& update = localUpdates.ExpandAndGetRef();
+              update.m_Bounds = pCurrentData->m_globalBounds;
+              update.m_hData = pCurrentData->m_hSpatialData;
+              update.m_pObject = pCurrentData->m_pObject;
+              update.m_uiCategoryBitmask = pCurrentData->m_uiSpatialDataCategoryBitmask;
+            }
+            else
+            {
+              auto& recreate = localRecreate.ExpandAndGetRef();
+              recreate.m_pData = pCurrentData;
+              recreate.m_bWasAlwaysVisible = bWasAlwaysVisible;
+            }
+          }
+
+          uiBatchCount = 0;
+        };
+
+        for (ezUInt32 uiBlockIndex = uiStartBlock; uiBlockIndex < uiEndBlock; ++uiBlockIndex)
+        {
+          WorldData::Hierarchy::DataBlock& block = blocks[uiBlockIndex];
+          const ezInt32 iBlockBit = static_cast<ezInt32>(1u << (uiBlockIndex % 32));
+
+          if ((ezAtomicUtils::Read(dirtyBlocks[uiBlockIndex / 32]) & iBlockBit) == 0)
+          {
+            uiNumSkipped += block.m_uiCount;
+            continue;
+          }
+
+          bool bBlockStillDirty = false;
+
+          ezGameObject::TransformationData* pCurrentData = block.m_pData;
+          ezGameObject::TransformationData* pEndData = block.m_pData + block.m_uiCount;
+
+          for (; pCurrentData < pEndData; ++pCurrentData)
+          {
+            const ezUInt8 uiDirtyFrames = pCurrentData->m_uiDirtyFrames;
+            if (uiDirtyFrames == 0)
+            {
+              ++uiNumSkipped;
+              continue;
+            }
+
+            ++uiNumUpdated;
+            pCurrentData->m_uiDirtyFrames = uiDirtyFrames - 1;
+            bBlockStillDirty |= uiDirtyFrames > 1;
+
+            // The children are on the next hierarchy level, which is only processed once this level is done.
+            // Every child has exactly one parent, so nobody else writes to its dirty frames in the mean time.
+            ezGameObject* pObject = pCurrentData->m_pObject;
+            if (pChildDirtyBlocks != nullptr && pObject->m_ChildCount > 0)
+            {
+              for (auto it = pObject->GetChildren(); it.IsValid(); ++it)
+              {
+                ezGameObject::TransformationData* pChildData = it->m_pTransformationData;
+                if (pChildData->m_uiDirtyFrames < uiDirtyFrames)
+                {
+                  pChildData->m_uiDirtyFrames = uiDirtyFrames;
+                  MarkBlockDirty(*pChildDirtyBlocks, pChildData->m_uiBlockIndex);
+                }
+              }
+            }
+
+            batchOldBounds[uiBatchCount] = pCurrentData->m_globalBounds;
+            batch[uiBatchCount] = pCurrentData;
+
+            if (++uiBatchCount == 4)
+            {
+              processBatch();
+            }
+          }
+
+          // blocks of the same level may be processed by other threads, which share the same bit field word
+          if (!bBlockStillDirty)
+          {
+            ezAtomicUtils::And(dirtyBlocks[uiBlockIndex / 32], ~iBlockBit);
+          }
+        }
+
+        if (uiBatchCount > 0)
+        {
+          processBatch();
+        }
+
+        stats.m_iNumUpdated.Add(uiNumUpdated);
+        stats.m_iNumSkipped.Add(uiNumSkipped);
+
+        if (!localUpdates.IsEmpty() || !localRecreate.IsEmpty())
+        {
+          EZ_LOCK(pSpatialDataUpdates->m_Mutex);
+          pSpatialDataUpdates->m_Updates.PushBackRange(localUpdates);
+          pSpatialDataUpdates->m_Recreate.PushBackRange(localRecreate);
+        }
+      },
+      "World Transform And Bounds Update Task", parallelForParams);
+  }
+
+  void WorldData::UpdateGlobalTransforms(float fInvDeltaSeconds)
+  {
+    const ezSimdFloat fInvDt = fInvDeltaSeconds;
+    TransformUpdateStats stats;
 
     Hierarchy& hierarchy = m_Hierarchies[HierarchyType::Dynamic];
     if (!hierarchy.m_Data.IsEmpty())
     {
+      // The spatial system can't be modified from multiple threads, so the transforms and bounds are computed in parallel
+      // and the resulting spatial data changes are applied in one batch afterwards.
+      DeferredSpatialDataUpdates* pDeferred = nullptr;
+      if (m_pSpatialSystem != nullptr)
+      {
+        pDeferred = &m_DeferredSpatialDataUpdates;
+        pDeferred->m_Updates.Clear();
+        pDeferred->m_Recreate.Clear();
+      }
+
+      const ezUInt32 uiNumLevels = hierarchy.m_Data.GetCount();
       auto dataPtr = hierarchy.m_Data.GetData();
+      auto dirtyPtr = hierarchy.m_DirtyBlocks.GetData();
 
-      // If we have no spatial system, we perform multi-threaded update as we do not
-      // have to acquire a write lock in the process.
-      if (m_pSpatialSystem == nullptr)
-      {
-        TraverseHierarchyLevelMultiThreaded<RootLevel>(*dataPtr[0], &userData);
+      UpdateGlobalTransformsOfLevel<false>(*dataPtr[0], *dirtyPtr[0], uiNumLevels > 1 ? dirtyPtr[1] : nullptr, fInvDt, pDeferred, stats);
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
-        {
-          TraverseHierarchyLevelMultiThreaded<WithParent>(*dataPtr[i], &userData);
-        }
-      }
-      else
+      for (ezUInt32 i = 1; i < uiNumLevels; ++i)
       {
-        TraverseHierarchyLevel<RootLevelWithSpatialData>(*dataPtr[0], &userData);
+        UpdateGlobalTransformsOfLevel<true>(*dataPtr[i], *dirtyPtr[i], i + 1 < uiNumLevels ? dirtyPtr[i + 1] : nullptr, fInvDt, pDeferred, stats);
+      }
 
-        for (ezUInt32 i = 1; i < hierarchy.m_Data.GetCount(); ++i)
+      if (pDeferred != nullptr)
+      {
+        for (const DeferredSpatialData& recreate : pDeferred->m_Recreate)
         {
-          TraverseHierarchyLevel<WithParentWithSpatialData>(*dataPtr[i], &userData);
+          const bool bIsAlwaysVisible = recreate.m_pData->m_globalBounds.m_BoxHalfExtents.w() != ezSimdFloat::Zero();
+          recreate.m_pData->UpdateSpatialData(*m_pSpatialSystem, recreate.m_bWasAlwaysVisible, bIsAlwaysVisible);
         }
+
+        m_pSpatialSystem->UpdateSpatialDataBatch(pDeferred->m_Updates);
       }
     }
+
+    {
+      ezStringBuilder sStatName;
+      sStatName.Format("World Update/{0}/Transforms Updated", m_sName);
+      ezStats::SetStat(sStatName, static_cast<ezInt32>(stats.m_iNumUpdated));
+
+      sStatName.Format("World Update/{0}/Transforms Skipped", m_sName);
+      ezStats::SetStat(sStatName, static_cast<ezInt32>(stats.m_iNumSkipped));
+    }
   }
 
 } // namespace ezInternal
@@ -5,9 +5,11 @@
 #include <Foundation/Math/Random.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Time/Clock.h>
 
 #include <Core/World/GameObject.h>
+#include <Core/World/SpatialSystem.h>
 #include <Core/World/WorldDesc.h>
 #include <Foundation/Types/SharedPtr.h>
 
@@ -18,6 +20,7 @@ namespace ezInternal
   private:
     friend class ::ezWorld;
     friend class ::ezComponentManagerBase;
+    friend class ::ezGameObject;
 
     WorldData(ezWorldDesc& desc);
     ~WorldData();
@@ -98,8 +101,12 @@ namespace ezInternal
     {
       typedef ezDataBlock<ezGameObject::TransformationData, ezInternal::DEFAULT_BLOCK_SIZE> DataBlock;
       typedef ezDynamicArray<DataBlock> DataBlockArray;
+      typedef ezDynamicArray<ezInt32> DirtyBlockBits;
 
       ezHybridArray<DataBlockArray*, 8, ezLocalAllocatorWrapper> m_Data;
+
+      /// One bit per block in m_Data, set if any transformation data in that block has to be updated. Only used by the dynamic hierarchy.
+      ezHybridArray<DirtyBlockBits*, 8, ezLocalAllocatorWrapper> m_DirtyBlocks;
     };
 
     struct HierarchyType
@@ -120,6 +127,9 @@ namespace ezInternal
 
     void DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData);
 
+    void MarkTransformationDataDirty(ezGameObject::TransformationData* pData, ezUInt32 uiHierarchyLevel);
+    static void MarkBlockDirty(Hierarchy::DirtyBlockBits& dirtyBlocks, ezUInt32 uiBlockIndex);
+
     template <typename VISITOR>
     static ezVisitorExecution::Enum TraverseHierarchyLevel(Hierarchy::DataBlockArray& blocks, void* pUserData = nullptr);
     template <typename VISITOR>
@@ -130,13 +140,47 @@ namespace ezInternal
     void TraverseDepthFirst(VisitorFunc& func);
     static ezVisitorExecution::Enum TraverseObjectDepthFirst(ezGameObject* pObject, VisitorFunc& func);
 
-    static void UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
-    static void UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds);
+    void UpdateGlobalTransforms(float fInvDeltaSeconds);
 
-    static void UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
-    static void UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem);
+    // Spatial data changes that are collected while the transforms are updated in parallel and applied afterwards
+    struct DeferredSpatialData
+    {
+      EZ_DECLARE_POD_TYPE();
 
-    void UpdateGlobalTransforms(float fInvDeltaSeconds);
+      ezGameObject::TransformationData* m_pData;
+      bool m_bWasAlwaysVisible;
+    };
+
+    struct DeferredSpatialDataUpdates
+    {
+      ezMutex m_Mutex;
+
+      /// Bounds changes that the spatial system can apply with UpdateSpatialDataBatch()
+      ezDynamicArray<ezSpatialSystem::SpatialDataUpdate> m_Updates;
+
+      /// Objects whose spatial data has to be created, deleted or recreated, which has to be done serially
+      ezDynamicArray<DeferredSpatialData> m_Recreate;
+    };
+
+    DeferredSpatialDataUpdates m_DeferredSpatialDataUpdates;
+
+    struct TransformUpdateStats
+    {
+      ezAtomicInteger32 m_iNumUpdated;
+      ezAtomicInteger32 m_iNumSkipped;
+    };
+
+    /// Computes the global transforms and global bounds of four objects of the same hierarchy level at once.
+    /// The data is transposed into structure-of-arrays form, so that every SIMD lane processes one object.
+    template <bool WithParent>
+    static void UpdateGlobalTransformsAndBounds4(ezGameObject::TransformationData* const* pData);
+
+    /// Updates the dirty transformation data of one hierarchy level and flags the children of changed objects in \a pChildDirtyBlocks.
+    /// The spatial data changes are only collected if \a pSpatialDataUpdates is not null.
+    template <bool WithParent>
+    static void UpdateGlobalTransformsOfLevel(Hierarchy::DataBlockArray& blocks, Hierarchy::DirtyBlockBits& dirtyBlocks,
+      Hierarchy::DirtyBlockBits* pChildDirtyBlocks, const ezSimdFloat& fInvDeltaSeconds, DeferredSpatialDataUpdates* pSpatialDataUpdates,
+      TransformUpdateStats& stats);
 
     // game object lookups
     ezHashTable<ezUInt32, ezGameObjectId, ezHashHelper<ezUInt32>, ezLocalAllocatorWrapper> m_GlobalKeyToIdTable;
@@ -57,36 +57,9 @@ namespace ezInternal
   }
 
   // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransform(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
+  EZ_ALWAYS_INLINE void WorldData::MarkBlockDirty(Hierarchy::DirtyBlockBits& dirtyBlocks, ezUInt32 uiBlockIndex)
   {
-    pData->UpdateGlobalTransform();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
-
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParent(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds)
-  {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBounds();
-  }
-
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds,
-    ezSpatialSystem& spatialSystem)
-  {
-    pData->UpdateGlobalTransform();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
-  }
-
-  // static
-  EZ_FORCE_INLINE void WorldData::UpdateGlobalTransformWithParentAndSpatialData(ezGameObject::TransformationData* pData, const ezSimdFloat& fInvDeltaSeconds, ezSpatialSystem& spatialSystem)
-  {
-    pData->UpdateGlobalTransformWithParent();
-    pData->UpdateVelocity(fInvDeltaSeconds);
-    pData->UpdateGlobalBoundsAndSpatialData(spatialSystem);
+    ezAtomicUtils::Or(dirtyBlocks[uiBlockIndex / 32], static_cast<ezInt32>(1u << (uiBlockIndex % 32)));
   }
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Mat4.h>
+#include <Foundation/SimdMath/SimdBBox.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+
+/// \brief A small software depth buffer that is used to cull objects which are hidden behind designated occluders.
+///
+/// Occluders are rasterized on the CPU with SIMD, four pixels at a time. Every pixel stores the normalized device depth (z / w) of the
+/// closest occluder. A bounding box is considered occluded if its closest point is further away than the occluders in every pixel
+/// its screen space rectangle covers. Since the buffer does not need a GPU it also works in headless applications and tests.
+///
+/// The projection must map larger depth values to points further away from the camera, i.e. inverted depth is not supported.
+/// Occluder triangles that cross the near plane are skipped and boxes that cross it are always reported as visible,
+/// so the test errs on the side of visibility.
+class EZ_CORE_DLL ezOcclusionBuffer
+{
+public:
+  /// \brief The width is rounded up to a multiple of four.
+  ezOcclusionBuffer(ezUInt32 uiWidth = 256, ezUInt32 uiHeight = 128);
+  ~ezOcclusionBuffer();
+
+  ezUInt32 GetWidth() const { return m_uiWidth; }
+  ezUInt32 GetHeight() const { return m_uiHeight; }
+
+  /// \brief Removes all occluders and sets the view projection matrix that is used for all following operations.
+  void Clear(const ezMat4& viewProjection);
+
+  /// \brief Rasterizes a triangle list, three vertices per triangle, after transforming it with the given transform.
+  void RasterizeOccluder(ezArrayPtr<const ezVec3> triangles, const ezSimdTransform& transform);
+
+  /// \brief Rasterizes the given box after transforming it with the given transform.
+  void RasterizeOccluder(const ezBoundingBox& localBox, const ezSimdTransform& transform);
+
+  /// \brief Returns whether any occluder has been rasterized since the last Clear().
+  bool HasOccluders() const { return m_uiNumRasterizedTriangles > 0; }
+
+  /// \brief Returns the number of triangles that actually touched the buffer since the last Clear(). Useful for stats.
+  ezUInt32 GetNumRasterizedTriangles() const { return m_uiNumRasterizedTriangles; }
+
+  /// \brief Returns false if the box is completely hidden behind the rasterized occluders.
+  bool IsVisible(const ezSimdBBox& box) const;
+
+  /// \brief Returns the stored depth of a single pixel. Pixels that are not covered by any occluder return ezMath::MaxValue<float>().
+  float GetDepth(ezUInt32 x, ezUInt32 y) const { return m_Depth[y * m_uiWidth + x]; }
+
+private:
+  void RasterizeTriangle(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdVec4f& v2);
+
+  ezUInt32 m_uiWidth;
+  ezUInt32 m_uiHeight;
+  ezUInt32 m_uiNumRasterizedTriangles = 0;
+
+  ezSimdMat4f m_ViewProjection;
+  ezSimdVec4f m_vScreenScale;
+  ezSimdVec4f m_vScreenOffset;
+
+  ezDynamicArray<float, ezAlignedAllocatorWrapper> m_Depth;
+};
@@ -68,6 +68,7 @@ struct EZ_CORE_DLL ezDefaultSpatialDataCategories
 {
   static ezSpatialData::Category RenderStatic;
   static ezSpatialData::Category RenderDynamic;
+  static ezSpatialData::Category Occluder; ///< Used by the software occlusion culling, see ezOcclusionBuffer.
 };
 
 #define ezInvalidSpatialDataCategory ezSpatialData::Category()
@@ -5,6 +5,8 @@
 #include <Foundation/Math/Frustum.h>
 #include <Foundation/Memory/CommonAllocators.h>
 
+class ezOcclusionBuffer;
+
 class EZ_CORE_DLL ezSpatialSystem : public ezReflectedClass
 {
   EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem, ezReflectedClass);
@@ -25,6 +27,22 @@ public:
 
   void UpdateSpatialData(const ezSpatialDataHandle& hData, const ezSimdBBoxSphere& bounds, ezGameObject* pObject, ezUInt32 uiCategoryBitmask);
 
+  struct SpatialDataUpdate
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezSimdBBoxSphere m_Bounds;
+    ezSpatialDataHandle m_hData;
+    ezGameObject* m_pObject;
+    ezUInt32 m_uiCategoryBitmask;
+  };
+
+  /// \brief Same as calling UpdateSpatialData() for every entry, but the updates are distributed across the worker threads.
+  ///
+  /// Only changes that the implementation can apply in place (see SpatialDataChangedInPlace()) are done in parallel,
+  /// everything else is applied afterwards on the calling thread.
+  void UpdateSpatialDataBatch(ezArrayPtr<const SpatialDataUpdate> updates);
+
   ///@}
   /// \name Simple Queries
   ///@{
@@ -33,16 +51,18 @@ public:
 
   struct QueryStats
   {
-    ezUInt32 m_uiTotalNumObjects;  ///< The total number of spatial objects in this system.
-    ezUInt32 m_uiNumObjectsTested; ///< Number of objects tested for the query condition.
-    ezUInt32 m_uiNumObjectsPassed; ///< Number of objects that passed the query condition.
-    ezTime m_TimeTaken;            ///< Time taken to execute the query
+    ezUInt32 m_uiTotalNumObjects;    ///< The total number of spatial objects in this system.
+    ezUInt32 m_uiNumObjectsTested;   ///< Number of objects tested for the query condition.
+    ezUInt32 m_uiNumObjectsPassed;   ///< Number of objects that passed the query condition.
+    ezUInt32 m_uiNumObjectsOccluded; ///< Number of objects that passed the frustum test but were rejected by the occlusion test.
+    ezTime m_TimeTaken;              ///< Time taken to execute the query
 
     EZ_ALWAYS_INLINE QueryStats()
     {
       m_uiTotalNumObjects = 0;
       m_uiNumObjectsTested = 0;
       m_uiNumObjectsPassed = 0;
+      m_uiNumObjectsOccluded = 0;
     }
   };
 
@@ -56,18 +76,41 @@ public:
   /// \name Visibility Queries
   ///@{
 
-  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr) const;
+  /// \brief Finds all objects inside the frustum.
+  ///
+  /// If an occlusion buffer is given, objects that are completely hidden behind the occluders rasterized into it are skipped as well.
+  /// The buffer must have been set up with the same view projection as the frustum.
+  void FindVisibleObjects(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats = nullptr,
+    const ezOcclusionBuffer* pOcclusionBuffer = nullptr) const;
+
+  /// \brief Tests several frusta at once, e.g. for the cascades of a directional light or the faces of a point light shadow, with a single traversal.
+  ///
+  /// out_Objects receives every object that is visible in at least one of the frusta and out_VisibilityMasks one bitmask per object,
+  /// in which bit i is set if the object is visible in frusta[i]. At most 32 frusta can be tested with one call.
+  void FindVisibleObjects(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats = nullptr) const;
 
   ///@}
 
 protected:
   virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
   virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats) const = 0;
-  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats) const = 0;
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects, QueryStats* pStats,
+    const ezOcclusionBuffer* pOcclusionBuffer) const = 0;
+
+  /// \brief The default implementation queries every frustum separately and merges the results.
+  virtual void FindVisibleObjectsBatchInternal(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats) const;
 
   virtual void SpatialDataAdded(ezSpatialData* pData) = 0;
   virtual void SpatialDataRemoved(ezSpatialData* pData) = 0;
   virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) = 0;
+
+  /// \brief Called by UpdateSpatialDataBatch() concurrently from multiple threads, but never for the same data twice.
+  ///
+  /// Implementations may only modify memory that belongs to this particular spatial data and must return false if the change
+  /// requires modifications of shared structures. SpatialDataChanged() is then called for it afterwards on the calling thread.
+  virtual bool SpatialDataChangedInPlace(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) { return false; }
   virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) = 0;
 
   ezProxyAllocator m_Allocator;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Core/World/SpatialSystem.h>
+
+/// \brief A spatial system that sorts the spatial data into a loose octree.
+///
+/// Every node covers a cube of the world, but accepts all data whose center lies inside that cube and whose size is at most the
+/// size of the cube. The loose bounds of a node thus extend by half its size in every direction. Large objects automatically end
+/// up in nodes close to the root and small ones further down, so mixed object sizes don't degrade the queries as much as with a
+/// regular grid. The node of a spatial data can be computed directly from its bounds, so there is no refitting necessary.
+///
+/// The bounding spheres of each node are stored in packets of four (SoA), which are tested against the query shapes with SIMD.
+/// Data outside of the world bounds is kept in an overflow node which is always tested.
+class EZ_CORE_DLL ezSpatialSystem_LooseOctree : public ezSpatialSystem
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezSpatialSystem_LooseOctree, ezSpatialSystem);
+
+public:
+  /// \brief The root node covers a cube with the edge length \a fWorldSize around the origin.
+  /// Nodes are not subdivided any further once their edge length drops below \a fMinNodeSize.
+  ezSpatialSystem_LooseOctree(float fWorldSize = 65536.0f, float fMinNodeSize = 32.0f);
+  ~ezSpatialSystem_LooseOctree();
+
+  /// \brief Returns the loose bounding box of the node associated with the given spatial data. Useful for debug visualizations.
+  ezResult GetNodeBoxForSpatialData(const ezSpatialDataHandle& hData, ezBoundingBox& out_BoundingBox) const;
+
+  /// \brief Returns the loose bounding boxes of all nodes that contain data.
+  void GetAllNodeBoxes(ezHybridArray<ezBoundingBox, 16>& out_BoundingBoxes, ezSpatialData::Category filterCategory = ezInvalidSpatialDataCategory) const;
+
+private:
+  // ezSpatialSystem implementation
+  virtual void FindObjectsInSphereInternal(const ezBoundingSphere& sphere, ezUInt32 uiCategoryBitmask, QueryCallback callback,
+    QueryStats* pStats = nullptr) const override;
+  virtual void FindObjectsInBoxInternal(const ezBoundingBox& box, ezUInt32 uiCategoryBitmask, QueryCallback callback, QueryStats* pStats = nullptr) const override;
+
+  virtual void FindVisibleObjectsInternal(const ezFrustum& frustum, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    QueryStats* pStats, const ezOcclusionBuffer* pOcclusionBuffer) const override;
+  virtual void FindVisibleObjectsBatchInternal(ezArrayPtr<const ezFrustum> frusta, ezUInt32 uiCategoryBitmask, ezDynamicArray<const ezGameObject*>& out_Objects,
+    ezDynamicArray<ezUInt32>& out_VisibilityMasks, QueryStats* pStats) const override;
+
+  virtual void SpatialDataAdded(ezSpatialData* pData) override;
+  virtual void SpatialDataRemoved(ezSpatialData* pData) override;
+  virtual void SpatialDataChanged(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual bool SpatialDataChangedInPlace(ezSpatialData* pData, const ezSimdBBoxSphere& oldBounds, ezUInt32 uiOldCategoryBitmask) override;
+  virtual void FixSpatialDataPointer(ezSpatialData* pOldPtr, ezSpatialData* pNewPtr) override;
+
+  ezProxyAllocator m_AlignedAllocator;
+  float m_fRootHalfSize;
+  ezUInt32 m_uiMaxDepth;
+
+  struct SpatialUserData;
+  struct SpherePacket;
+  struct Node;
+
+  Node* m_pRoot = nullptr;
+  Node* m_pOverflowNode = nullptr;
+
+  Node* CreateNode(Node* pParent, ezUInt32 uiChildIndex);
+  void DeleteNode(Node* pNode);
+  void RemoveEmptyNodes(Node* pNode);
+
+  bool IsBestNode(const Node* pNode, const ezSimdBBoxSphere& bounds) const;
+  Node* GetOrCreateNode(const ezSimdBBoxSphere& bounds);
+
+  template <typename Functor>
+  void ForEachNode(const ezSimdBBox& box, ezUInt32 uiCategoryBitmask, Functor func) const;
+};
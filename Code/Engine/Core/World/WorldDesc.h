@@ -9,6 +9,18 @@
 
 class ezTimeStepSmoothing;
 
+/// \brief The type of spatial system that is created for a world if none is set explicitly.
+struct ezSpatialSystemType
+{
+  enum Enum
+  {
+    RegularGrid, ///< ezSpatialSystem_RegularGrid, fast for objects of similar size
+    LooseOctree, ///< ezSpatialSystem_LooseOctree, handles mixed object sizes and sparse worlds better
+
+    Default = RegularGrid
+  };
+};
+
 /// \brief Describes the initial state of a world.
 struct ezWorldDesc
 {
@@ -24,6 +36,7 @@ struct ezWorldDesc
 
   ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
   bool m_bAutoCreateSpatialSystem = true; ///< automatically create a default spatial system if none is set
+  ezSpatialSystemType::Enum m_SpatialSystemType = ezSpatialSystemType::Default; ///< the type of the automatically created spatial system
 
   ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
   ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing; ///< if nullptr, ezDefaultTimeStepSmoothing will be used
@@ -34,12 +34,18 @@ ezResult ezProcessingStreamSpawnerZeroInitialized::UpdateStreamBindings()
 
 void ezProcessingStreamSpawnerZeroInitialized::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  const ezUInt64 uiElementSize = m_pStream->GetElementSize();
+  const ezUInt32 uiNumComponentArrays = m_pStream->GetNumComponentArrays();
+  const ezUInt64 uiElementSize = m_pStream->GetElementSize() / uiNumComponentArrays;
   const ezUInt64 uiElementStride = m_pStream->GetElementStride();
 
-  for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+  for (ezUInt32 uiComponent = 0; uiComponent < uiNumComponentArrays; ++uiComponent)
   {
-    ezMemoryUtils::ZeroFill<ezUInt8>(static_cast<ezUInt8*>(ezMemoryUtils::AddByteOffset(m_pStream->GetWritableData(), static_cast<ptrdiff_t>(i * uiElementStride))), static_cast<size_t>(uiElementSize));
+    void* pData = m_pStream->GetWritableComponentData(uiComponent);
+
+    for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
+    {
+      ezMemoryUtils::ZeroFill<ezUInt8>(static_cast<ezUInt8*>(ezMemoryUtils::AddByteOffset(pData, static_cast<ptrdiff_t>(i * uiElementStride))), static_cast<size_t>(uiElementSize));
+    }
   }
 }
 
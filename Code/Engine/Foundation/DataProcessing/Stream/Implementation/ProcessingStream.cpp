@@ -8,6 +8,7 @@ ezProcessingStream::ezProcessingStream(const char* szName, ezProcessingStream::D
     , m_uiAlignment(uiAlignment)
     , m_uiNumElements(0)
     , m_uiTypeSize(GetDataTypeSize(Type))
+    , m_uiComponentStride(0)
     , m_Type(Type)
     , m_Name()
 {
@@ -31,19 +32,32 @@ void ezProcessingStream::SetSize(ezUInt64 uiNumElements)
     return;
   }
 
+  // the component arrays of SoA streams are padded, such that each one starts at a 16 byte boundary and can be processed in packets of four
+  const ezUInt32 uiNumComponentArrays = GetNumComponentArrays();
+  const ezUInt64 uiNumAllocatedElements = uiNumComponentArrays > 1 ? ezMemoryUtils::AlignSize<ezUInt64>(uiNumElements, 4) : uiNumElements;
+  const ezUInt64 uiDataSize = uiNumAllocatedElements * GetDataTypeSize(m_Type);
+
+  m_uiComponentStride = uiDataSize / uiNumComponentArrays;
+
   /// \todo Allow to reuse memory from a pool ?
   if (m_uiAlignment > 0)
   {
-    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)),
-                                                            static_cast<size_t>(m_uiAlignment));
+    m_pData = ezFoundation::GetAlignedAllocator()->Allocate(static_cast<size_t>(uiDataSize), static_cast<size_t>(m_uiAlignment));
   }
   else
   {
-    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(static_cast<size_t>(uiNumElements * GetDataTypeSize(m_Type)), 0);
+    m_pData = ezFoundation::GetDefaultAllocator()->Allocate(static_cast<size_t>(uiDataSize), 0);
   }
 
   EZ_ASSERT_DEV(m_pData != nullptr, "Allocating {0} elements of {1} bytes each, with {2} bytes alignment, failed", uiNumElements,
                 ((ezUInt32)GetDataTypeSize(m_Type)), m_uiAlignment);
+
+  // SoA streams are processed in whole packets, so elements that were never initialized must still hold valid values
+  if (uiNumComponentArrays > 1)
+  {
+    ezMemoryUtils::ZeroFill<ezUInt8>(static_cast<ezUInt8*>(m_pData), static_cast<size_t>(uiDataSize));
+  }
+
   m_uiNumElements = uiNumElements;
 }
 
@@ -95,6 +109,7 @@ size_t ezProcessingStream::GetDataTypeSize(DataType Type)
 
     case DataType::Float3:
     case DataType::Int3:
+    case DataType::Float3SoA:
       return 12;
 
     case DataType::Float4:
@@ -110,6 +125,18 @@ size_t ezProcessingStream::GetDataTypeSize(DataType Type)
   return 0;
 }
 
+ezUInt32 ezProcessingStream::GetNumComponentArrays(DataType Type)
+{
+  switch (Type)
+  {
+    case DataType::Float3SoA:
+      return 3;
+
+    default:
+      return 1;
+  }
+}
+
 
 
 EZ_STATICLINK_FILE(Foundation, Foundation_DataProcessing_Stream_Implementation_ProcessingStream);
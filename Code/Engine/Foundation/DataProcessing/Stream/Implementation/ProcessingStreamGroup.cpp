@@ -216,15 +216,20 @@ void ezProcessingStreamGroup::RunPendingDeletions()
       }
     }
 
-    // Move the data
+    // Move the data, SoA streams have one part of the element in each of their component arrays
     for (ezProcessingStream* pStream : m_DataStreams)
     {
       const ezUInt64 uiStreamElementStride = pStream->GetElementStride();
-      const ezUInt64 uiStreamElementSize = pStream->GetElementSize();
-      const void* pSourceData = ezMemoryUtils::AddByteOffset(pStream->GetData(), static_cast<ptrdiff_t>(uiLastActiveElementIndex * uiStreamElementStride));
-      void* pTargetData = ezMemoryUtils::AddByteOffset(pStream->GetWritableData(), static_cast<ptrdiff_t>(uiElementToRemove * uiStreamElementStride));
+      const ezUInt32 uiNumComponentArrays = pStream->GetNumComponentArrays();
+      const ezUInt64 uiStreamElementSize = pStream->GetElementSize() / uiNumComponentArrays;
 
-      ezMemoryUtils::Copy<ezUInt8>(static_cast<ezUInt8*>(pTargetData), static_cast<const ezUInt8*>(pSourceData), static_cast<size_t>(uiStreamElementSize));
+      for (ezUInt32 uiComponent = 0; uiComponent < uiNumComponentArrays; ++uiComponent)
+      {
+        const void* pSourceData = ezMemoryUtils::AddByteOffset(pStream->GetComponentData(uiComponent), static_cast<ptrdiff_t>(uiLastActiveElementIndex * uiStreamElementStride));
+        void* pTargetData = ezMemoryUtils::AddByteOffset(pStream->GetWritableComponentData(uiComponent), static_cast<ptrdiff_t>(uiElementToRemove * uiStreamElementStride));
+
+        ezMemoryUtils::Copy<ezUInt8>(static_cast<ezUInt8*>(pTargetData), static_cast<const ezUInt8*>(pSourceData), static_cast<size_t>(uiStreamElementSize));
+      }
     }
 
     // And decrease the size since we swapped the last element to the location of the element we just removed
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Foundation/Basics.h>
+#include <Foundation/Memory/MemoryUtils.h>
 #include <Foundation/Strings/HashedString.h>
 
 /// \brief A single stream in a stream group holding contiguous data of a given type.
@@ -39,7 +40,9 @@ public:
     Int,
     Int2,
     Int3,
-    Int4
+    Int4,
+
+    Float3SoA, // 3x float, stored as three separate arrays of floats, see GetComponentData()
   };
 
   /// \brief Returns a const pointer to the data casted to the type T, note that no type check is done!
@@ -62,6 +65,33 @@ public:
   /// \brief Returns a non-const pointer to the start of the data block.
   void* GetWritableData() const { return m_pData; }
 
+  /// \brief Returns a const pointer to the array that holds the given component of all elements.
+  ///
+  /// Streams with a SoA data type store each component in a separate array. The arrays are padded to a multiple of four elements,
+  /// so SIMD code may always process four elements at once. For all other streams only component 0 exists, which is the whole data.
+  template <typename T>
+  const T* GetComponentData(ezUInt32 uiComponent) const
+  {
+    return static_cast<const T*>(GetComponentData(uiComponent));
+  }
+
+  /// \brief Returns a const pointer to the start of the array that holds the given component of all elements.
+  const void* GetComponentData(ezUInt32 uiComponent) const { return GetWritableComponentData(uiComponent); }
+
+  /// \brief Returns a non-const pointer to the array that holds the given component of all elements, see GetComponentData().
+  template <typename T>
+  T* GetWritableComponentData(ezUInt32 uiComponent) const
+  {
+    return static_cast<T*>(GetWritableComponentData(uiComponent));
+  }
+
+  /// \brief Returns a non-const pointer to the start of the array that holds the given component of all elements.
+  void* GetWritableComponentData(ezUInt32 uiComponent) const
+  {
+    EZ_ASSERT_DEBUG(uiComponent < GetNumComponentArrays(), "Invalid component index {0}", uiComponent);
+    return ezMemoryUtils::AddByteOffset(m_pData, static_cast<ptrdiff_t>(uiComponent * m_uiComponentStride));
+  }
+
   /// \brief Returns the name of the stream
   const ezHashedString& GetName() const { return m_Name; }
 
@@ -75,14 +105,20 @@ public:
   ezUInt64 GetElementSize() const { return m_uiTypeSize; }
 
   /// \brief Returns the stride between two elements of the stream.
+  ///
+  /// For SoA streams this is the stride between two elements within one of the component arrays.
   ezUInt64 GetElementStride() const
   {
-    // For now this is the type size, but this method will help with introduction of interleaved streams etc.
-    return m_uiTypeSize;
+    return m_uiTypeSize / GetNumComponentArrays();
   }
 
+  /// \brief Returns the number of arrays the elements are split into. This is one, unless the stream has a SoA data type.
+  ezUInt32 GetNumComponentArrays() const { return GetNumComponentArrays(m_Type); }
+
   static size_t GetDataTypeSize(DataType Type);
 
+  static ezUInt32 GetNumComponentArrays(DataType Type);
+
 protected:
   friend class ezProcessingStreamGroup;
 
@@ -100,6 +136,8 @@ protected:
 
   ezUInt64 m_uiTypeSize;
 
+  ezUInt64 m_uiComponentStride;
+
   DataType m_Type;
 
   ezHashedString m_Name;
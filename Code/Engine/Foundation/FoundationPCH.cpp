@@ -111,6 +111,7 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_MemoryUtils);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Implementation_PageAllocator);
   EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_GuardedAllocation);
+  EZ_STATICLINK_REFERENCE(Foundation_Memory_Policies_ThreadCachingAllocation);
   EZ_STATICLINK_REFERENCE(Foundation_Profiling_Implementation_Profiling);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyAttributes);
   EZ_STATICLINK_REFERENCE(Foundation_Reflection_Implementation_PropertyPath);
@@ -148,12 +149,15 @@ EZ_STATICLINK_LIBRARY(Foundation)
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_OSThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ParallelFor);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Task);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskFiber);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskGroup);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystem);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemFibers);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemGroups);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemTasks);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemThreads);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskSystemUtils);
+  EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkStealingDeque);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_TaskWorkerThread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_Thread);
   EZ_STATICLINK_REFERENCE(Foundation_Threading_Implementation_ThreadSignal);
@@ -9,6 +9,7 @@
 #include <Foundation/Memory/Policies/GuardedAllocation.h>
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Memory/Policies/ProxyAllocation.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
 
 
 /// \brief Default heap allocator
@@ -23,3 +24,6 @@ typedef ezAllocator<ezMemoryPolicies::ezGuardedAllocation> ezGuardedAllocator;
 /// \brief Proxy allocator
 typedef ezAllocator<ezMemoryPolicies::ezProxyAllocation> ezProxyAllocator;
 
+/// \brief Small-object allocator with per-thread caches
+typedef ezAllocator<ezMemoryPolicies::ezThreadCachingAllocation> ezThreadCachingAllocator;
+
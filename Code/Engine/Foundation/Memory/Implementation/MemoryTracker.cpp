@@ -7,6 +7,7 @@
 #include <Foundation/Memory/Policies/HeapAllocation.h>
 #include <Foundation/Strings/String.h>
 #include <Foundation/System/StackTracer.h>
+#include <Foundation/Threading/AtomicInteger.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
@@ -27,30 +28,80 @@ namespace
   };
 
 
+  typedef ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> AllocationTable;
+
+  /// \brief Part of the live allocations of one allocator, selected by the address. Allocations on different threads rarely end
+  /// up in the same shard, so they don't wait for each other.
+  struct AllocationShard
+  {
+    ezMutex m_Mutex;
+    AllocationTable m_Allocations;
+
+    /// Changes since the stats of the allocator were set the last time
+    ezAllocatorBase::Stats m_Stats;
+  };
+
   struct AllocatorData
   {
+    static constexpr ezUInt32 s_uiNumShards = 32;
+
     EZ_ALWAYS_INLINE AllocatorData() {}
 
+    EZ_ALWAYS_INLINE AllocationShard& GetShard(const void* ptr)
+    {
+      // allocations are at least 8 byte aligned, large ones are often page aligned
+      const size_t uiAddress = reinterpret_cast<size_t>(ptr);
+      return m_Shards[((uiAddress >> 4) ^ (uiAddress >> 12) ^ (uiAddress >> 20)) % s_uiNumShards];
+    }
+
+    ezAllocatorBase::Stats CombineStats()
+    {
+      ezAllocatorBase::Stats stats = m_Stats;
+
+      for (AllocationShard& shard : m_Shards)
+      {
+        EZ_LOCK(shard.m_Mutex);
+
+        // the allocation size of a single shard may wrap around if its stats were reset while it had live allocations,
+        // the sum is still correct
+        stats.m_uiNumAllocations += shard.m_Stats.m_uiNumAllocations;
+        stats.m_uiNumDeallocations += shard.m_Stats.m_uiNumDeallocations;
+        stats.m_uiAllocationSize += shard.m_Stats.m_uiAllocationSize;
+        stats.m_uiPerFrameAllocationSize += shard.m_Stats.m_uiPerFrameAllocationSize;
+        stats.m_PerFrameAllocationTime += shard.m_Stats.m_PerFrameAllocationTime;
+      }
+
+      return stats;
+    }
+
+    ezAllocatorId m_Id;
     ezHybridString<32, TrackerDataAllocatorWrapper> m_sName;
     ezBitflags<ezMemoryTrackingFlags> m_Flags;
 
     ezAllocatorId m_ParentId;
 
-    ezAllocatorBase::Stats m_Stats;
+    ezAllocatorBase::Stats m_Stats;         ///< Stats that were set with SetAllocatorStats, the shards track the changes since then
 
-    ezHashTable<const void*, ezMemoryTracker::AllocationInfo, ezHashHelper<const void*>, TrackerDataAllocatorWrapper> m_Allocations;
+    AllocationShard m_Shards[s_uiNumShards];
   };
 
   struct TrackerData
   {
+    static constexpr ezUInt32 s_uiLookupBlockSize = 4096;
+    static constexpr ezUInt32 s_uiNumLookupBlocks = (1u << 24) / s_uiLookupBlockSize; // ezAllocatorId has a 24 bit instance index
+
     EZ_ALWAYS_INLINE void Lock() { m_Mutex.Lock(); }
     EZ_ALWAYS_INLINE void Unlock() { m_Mutex.Unlock(); }
 
     ezMutex m_Mutex;
 
-    typedef ezIdTable<ezAllocatorId, AllocatorData, TrackerDataAllocatorWrapper> AllocatorTable;
+    typedef ezIdTable<ezAllocatorId, AllocatorData*, TrackerDataAllocatorWrapper> AllocatorTable;
     AllocatorTable m_AllocatorData;
 
+    /// Maps the instance index of an allocator id to its data without locking m_Mutex. Entries are only written during
+    /// registration, before any other thread can know the id, and the blocks are never freed.
+    AllocatorData** m_AllocatorLookup[s_uiNumLookupBlocks] = {};
+
     ezAllocatorId m_StaticAllocatorId;
   };
 
@@ -58,6 +109,36 @@ namespace
   static bool s_bIsInitialized = false;
   static bool s_bIsInitializing = false;
 
+  // the sampling rate minus one, so that the zero initialization records a stack trace for every allocation even before
+  // dynamic initialization has run
+  static ezAtomicInteger32 s_iAllocationsBetweenStackTraces;
+  thread_local ezUInt32 tl_uiAllocationsUntilStackTrace = 0;
+
+  EZ_ALWAYS_INLINE AllocatorData& GetAllocatorData(ezAllocatorId allocatorId)
+  {
+    const ezUInt32 uiIndex = allocatorId.m_InstanceIndex;
+    AllocatorData** pBlock = s_pTrackerData->m_AllocatorLookup[uiIndex / TrackerData::s_uiLookupBlockSize];
+    EZ_ASSERT_DEBUG(pBlock != nullptr, "Invalid allocator id");
+
+    AllocatorData* pData = pBlock[uiIndex % TrackerData::s_uiLookupBlockSize];
+    EZ_ASSERT_DEBUG(pData != nullptr && pData->m_Id == allocatorId, "Invalid allocator id");
+
+    return *pData;
+  }
+
+  EZ_ALWAYS_INLINE bool ShouldRecordStackTrace()
+  {
+    // counted per thread, so that allocations don't compete for a shared counter
+    if (tl_uiAllocationsUntilStackTrace == 0)
+    {
+      tl_uiAllocationsUntilStackTrace = static_cast<ezUInt32>(static_cast<ezInt32>(s_iAllocationsBetweenStackTraces));
+      return true;
+    }
+
+    --tl_uiAllocationsUntilStackTrace;
+    return false;
+  }
+
   static void Initialize()
   {
     if (s_bIsInitialized)
@@ -111,17 +192,19 @@ ezAllocatorId ezMemoryTracker::Iterator::Id() const
 
 const char* ezMemoryTracker::Iterator::Name() const
 {
-  return CAST_ITER(m_pData)->Value().m_sName.GetData();
+  return CAST_ITER(m_pData)->Value()->m_sName.GetData();
 }
 
 ezAllocatorId ezMemoryTracker::Iterator::ParentId() const
 {
-  return CAST_ITER(m_pData)->Value().m_ParentId;
+  return CAST_ITER(m_pData)->Value()->m_ParentId;
 }
 
-const ezAllocatorBase::Stats& ezMemoryTracker::Iterator::Stats() const
+ezAllocatorBase::Stats ezMemoryTracker::Iterator::Stats() const
 {
-  return CAST_ITER(m_pData)->Value().m_Stats;
+  EZ_LOCK(*s_pTrackerData);
+
+  return CAST_ITER(m_pData)->Value()->CombineStats();
 }
 
 void ezMemoryTracker::Iterator::Next()
@@ -149,14 +232,24 @@ ezAllocatorId ezMemoryTracker::RegisterAllocator(const char* szName, ezBitflags<
 
   EZ_LOCK(*s_pTrackerData);
 
-  AllocatorData data;
-  data.m_sName = szName;
-  data.m_Flags = flags;
-  data.m_ParentId = parentId;
+  AllocatorData* pData = EZ_NEW(s_pTrackerDataAllocator, AllocatorData);
+  pData->m_sName = szName;
+  pData->m_Flags = flags;
+  pData->m_ParentId = parentId;
 
-  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(data);
+  ezAllocatorId id = s_pTrackerData->m_AllocatorData.Insert(pData);
+  pData->m_Id = id;
 
-  if (data.m_sName == EZ_STATIC_ALLOCATOR_NAME)
+  AllocatorData**& pBlock = s_pTrackerData->m_AllocatorLookup[id.m_InstanceIndex / TrackerData::s_uiLookupBlockSize];
+  if (pBlock == nullptr)
+  {
+    pBlock = EZ_NEW_RAW_BUFFER(s_pTrackerDataAllocator, AllocatorData*, TrackerData::s_uiLookupBlockSize);
+    ezMemoryUtils::ZeroFill(pBlock, TrackerData::s_uiLookupBlockSize);
+  }
+
+  pBlock[id.m_InstanceIndex % TrackerData::s_uiLookupBlockSize] = pData;
+
+  if (pData->m_sName == EZ_STATIC_ALLOCATOR_NAME)
   {
     s_pTrackerData->m_StaticAllocatorId = id;
   }
@@ -169,30 +262,40 @@ void ezMemoryTracker::DeregisterAllocator(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+  AllocatorData* pData = &GetAllocatorData(allocatorId);
 
-  ezUInt32 uiLiveAllocations = data.m_Allocations.GetCount();
-  if (uiLiveAllocations != 0)
+  ezUInt32 uiLiveAllocations = 0;
+  for (AllocationShard& shard : pData->m_Shards)
   {
-    for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    EZ_LOCK(shard.m_Mutex);
+
+    uiLiveAllocations += shard.m_Allocations.GetCount();
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
     {
-      DumpLeak(it.Value(), data.m_sName.GetData());
+      DumpLeak(it.Value(), pData->m_sName.GetData());
     }
+  }
 
-    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", data.m_sName.GetData(), uiLiveAllocations);
+  if (uiLiveAllocations != 0)
+  {
+    EZ_REPORT_FAILURE("Allocator '{0}' leaked {1} allocation(s)", pData->m_sName.GetData(), uiLiveAllocations);
   }
 
   s_pTrackerData->m_AllocatorData.Remove(allocatorId);
+  s_pTrackerData->m_AllocatorLookup[allocatorId.m_InstanceIndex / TrackerData::s_uiLookupBlockSize]
+                                   [allocatorId.m_InstanceIndex % TrackerData::s_uiLookupBlockSize] = nullptr;
+
+  EZ_DELETE(s_pTrackerDataAllocator, pData);
 }
 
 // static
 void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemoryTrackingFlags> flags, const void* ptr, size_t uiSize, size_t uiAlign,
   ezTime allocationTime)
 {
-  EZ_ASSERT_DEV(uiAlign < 0xFFFF, "Alignment too big");
+  EZ_ASSERT_DEV(uiAlign <= 0xFFFFFFFF, "Alignment too big");
 
   ezArrayPtr<void*> stackTrace;
-  if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace))
+  if (flags.IsSet(ezMemoryTrackingFlags::EnableStackTrace) && ShouldRecordStackTrace())
   {
     void* pBuffer[64];
     ezArrayPtr<void*> tempTrace(pBuffer);
@@ -202,19 +305,21 @@ void ezMemoryTracker::AddAllocation(ezAllocatorId allocatorId, ezBitflags<ezMemo
     ezMemoryUtils::Copy(stackTrace.GetPtr(), pBuffer, uiNumTraces);
   }
 
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
+
   {
-    EZ_LOCK(*s_pTrackerData);
+    AllocationShard& shard = data.GetShard(ptr);
+    EZ_LOCK(shard.m_Mutex);
 
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-    data.m_Stats.m_uiNumAllocations++;
-    data.m_Stats.m_uiAllocationSize += uiSize;
-    data.m_Stats.m_uiPerFrameAllocationSize += uiSize;
-    data.m_Stats.m_PerFrameAllocationTime += allocationTime;
+    shard.m_Stats.m_uiNumAllocations++;
+    shard.m_Stats.m_uiAllocationSize += uiSize;
+    shard.m_Stats.m_uiPerFrameAllocationSize += uiSize;
+    shard.m_Stats.m_PerFrameAllocationTime += allocationTime;
 
-    EZ_ASSERT_DEBUG(data.m_Flags == flags, "Given flags have to be identical to allocator flags");
-    auto pInfo = &data.m_Allocations[ptr];
+    auto pInfo = &shard.m_Allocations[ptr];
     pInfo->m_uiSize = uiSize;
-    pInfo->m_uiAlignment = (ezUInt16)uiAlign;
+    pInfo->m_uiAlignment = (ezUInt32)uiAlign;
     pInfo->SetStackTrace(stackTrace);
   }
 }
@@ -225,15 +330,14 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
   ezArrayPtr<void*> stackTrace;
 
   {
-    EZ_LOCK(*s_pTrackerData);
-
-    AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
+    AllocationShard& shard = GetAllocatorData(allocatorId).GetShard(ptr);
+    EZ_LOCK(shard.m_Mutex);
 
     AllocationInfo info;
-    if (data.m_Allocations.Remove(ptr, &info))
+    if (shard.m_Allocations.Remove(ptr, &info))
     {
-      data.m_Stats.m_uiNumDeallocations++;
-      data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+      shard.m_Stats.m_uiNumDeallocations++;
+      shard.m_Stats.m_uiAllocationSize -= info.m_uiSize;
 
       stackTrace = info.GetStackTrace();
     }
@@ -249,17 +353,21 @@ void ezMemoryTracker::RemoveAllocation(ezAllocatorId allocatorId, const void* pt
 // static
 void ezMemoryTracker::RemoveAllAllocations(ezAllocatorId allocatorId)
 {
-  EZ_LOCK(*s_pTrackerData);
-  AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
-  for (auto it = data.m_Allocations.GetIterator(); it.IsValid(); ++it)
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  for (AllocationShard& shard : data.m_Shards)
   {
-    auto& info = it.Value();
-    data.m_Stats.m_uiNumDeallocations++;
-    data.m_Stats.m_uiAllocationSize -= info.m_uiSize;
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto it = shard.m_Allocations.GetIterator(); it.IsValid(); ++it)
+    {
+      auto& info = it.Value();
+      shard.m_Stats.m_uiNumDeallocations++;
+      shard.m_Stats.m_uiAllocationSize -= info.m_uiSize;
 
-    EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+      EZ_DELETE_ARRAY(s_pTrackerDataAllocator, info.GetStackTrace());
+    }
+    shard.m_Allocations.Clear();
   }
-  data.m_Allocations.Clear();
 }
 
 // static
@@ -267,7 +375,14 @@ void ezMemoryTracker::SetAllocatorStats(ezAllocatorId allocatorId, const ezAlloc
 {
   EZ_LOCK(*s_pTrackerData);
 
-  s_pTrackerData->m_AllocatorData[allocatorId].m_Stats = stats;
+  AllocatorData& data = GetAllocatorData(allocatorId);
+  data.m_Stats = stats;
+
+  for (AllocationShard& shard : data.m_Shards)
+  {
+    EZ_LOCK(shard.m_Mutex);
+    shard.m_Stats = ezAllocatorBase::Stats();
+  }
 }
 
 // static
@@ -277,9 +392,16 @@ void ezMemoryTracker::ResetPerFrameAllocatorStats()
 
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    AllocatorData& data = it.Value();
+    AllocatorData& data = *it.Value();
     data.m_Stats.m_uiPerFrameAllocationSize = 0;
     data.m_Stats.m_PerFrameAllocationTime.SetZero();
+
+    for (AllocationShard& shard : data.m_Shards)
+    {
+      EZ_LOCK(shard.m_Mutex);
+      shard.m_Stats.m_uiPerFrameAllocationSize = 0;
+      shard.m_Stats.m_PerFrameAllocationTime.SetZero();
+    }
   }
 }
 
@@ -288,15 +410,15 @@ const char* ezMemoryTracker::GetAllocatorName(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_sName.GetData();
+  return GetAllocatorData(allocatorId).m_sName.GetData();
 }
 
 // static
-const ezAllocatorBase::Stats& ezMemoryTracker::GetAllocatorStats(ezAllocatorId allocatorId)
+ezAllocatorBase::Stats ezMemoryTracker::GetAllocatorStats(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_Stats;
+  return GetAllocatorData(allocatorId).CombineStats();
 }
 
 // static
@@ -304,17 +426,17 @@ ezAllocatorId ezMemoryTracker::GetAllocatorParentId(ezAllocatorId allocatorId)
 {
   EZ_LOCK(*s_pTrackerData);
 
-  return s_pTrackerData->m_AllocatorData[allocatorId].m_ParentId;
+  return GetAllocatorData(allocatorId).m_ParentId;
 }
 
 // static
 const ezMemoryTracker::AllocationInfo& ezMemoryTracker::GetAllocationInfo(ezAllocatorId allocatorId, const void* ptr)
 {
-  EZ_LOCK(*s_pTrackerData);
+  AllocationShard& shard = GetAllocatorData(allocatorId).GetShard(ptr);
+  EZ_LOCK(shard.m_Mutex);
 
-  const AllocatorData& data = s_pTrackerData->m_AllocatorData[allocatorId];
   const AllocationInfo* info = nullptr;
-  if (data.m_Allocations.TryGetValue(ptr, info))
+  if (shard.m_Allocations.TryGetValue(ptr, info))
   {
     return *info;
   }
@@ -350,15 +472,20 @@ void ezMemoryTracker::DumpMemoryLeaks()
   // first collect all leaks
   for (auto it = s_pTrackerData->m_AllocatorData.GetIterator(); it.IsValid(); ++it)
   {
-    const AllocatorData& data = it.Value();
-    for (auto it2 = data.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+    AllocatorData& data = *it.Value();
+    for (AllocationShard& shard : data.m_Shards)
     {
-      LeakInfo leak;
-      leak.m_AllocatorId = it.Id();
-      leak.m_uiSize = it2.Value().m_uiSize;
-      leak.m_pParentLeak = nullptr;
+      EZ_LOCK(shard.m_Mutex);
 
-      leakTable.Insert(it2.Key(), leak);
+      for (auto it2 = shard.m_Allocations.GetIterator(); it2.IsValid(); ++it2)
+      {
+        LeakInfo leak;
+        leak.m_AllocatorId = it.Id();
+        leak.m_uiSize = it2.Value().m_uiSize;
+        leak.m_pParentLeak = nullptr;
+
+        leakTable.Insert(it2.Key(), leak);
+      }
     }
   }
 
@@ -402,9 +529,13 @@ void ezMemoryTracker::DumpMemoryLeaks()
                      "\n--------------------------------------------------------------------\n\n");
       }
 
-      const AllocatorData& data = s_pTrackerData->m_AllocatorData[leak.m_AllocatorId];
+      AllocatorData& data = GetAllocatorData(leak.m_AllocatorId);
       ezMemoryTracker::AllocationInfo info;
-      data.m_Allocations.TryGetValue(ptr, info);
+      AllocationShard& shard = data.GetShard(ptr);
+      {
+        EZ_LOCK(shard.m_Mutex);
+        shard.m_Allocations.TryGetValue(ptr, info);
+      }
 
       DumpLeak(info, data.m_sName.GetData());
 
@@ -423,6 +554,19 @@ void ezMemoryTracker::DumpMemoryLeaks()
   }
 }
 
+// static
+void ezMemoryTracker::SetStackTraceSamplingRate(ezUInt32 uiRate)
+{
+  EZ_ASSERT_DEV(uiRate > 0, "Sampling rate must be at least 1");
+  s_iAllocationsBetweenStackTraces = static_cast<ezInt32>(uiRate - 1);
+}
+
+// static
+ezUInt32 ezMemoryTracker::GetStackTraceSamplingRate()
+{
+  return static_cast<ezUInt32>(static_cast<ezInt32>(s_iAllocationsBetweenStackTraces)) + 1;
+}
+
 // static
 ezMemoryTracker::Iterator ezMemoryTracker::GetIterator()
 {
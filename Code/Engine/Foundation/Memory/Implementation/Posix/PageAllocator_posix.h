@@ -2,12 +2,12 @@
 #include <Foundation/Time/Time.h>
 
 // static
-void* ezPageAllocator::AllocatePage(size_t uiSize)
+void* ezPageAllocator::AllocatePage(size_t uiSize, size_t uiAlign)
 {
   ezTime fAllocationTime = ezTime::Now();
 
   void* ptr = nullptr;
-  size_t uiAlign = ezSystemInformation::Get().GetMemoryPageSize();
+  uiAlign = ezMath::Max<size_t>(uiAlign, ezSystemInformation::Get().GetMemoryPageSize());
   const int res = posix_memalign(&ptr, uiAlign, uiSize);
   EZ_ASSERT_DEBUG(res == 0, "Failed to align pointer");
   EZ_IGNORE_UNUSED(res);
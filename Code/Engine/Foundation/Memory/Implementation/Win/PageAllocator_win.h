@@ -5,14 +5,17 @@ EZ_FOUNDATION_INTERNAL_HEADER
 #include <Foundation/Time/Time.h>
 
 // static
-void* ezPageAllocator::AllocatePage(size_t uiSize)
+void* ezPageAllocator::AllocatePage(size_t uiSize, size_t uiAlign)
 {
+  // VirtualAlloc reserves memory at multiples of the allocation granularity, which is 64 KB
+  EZ_ASSERT_DEV(uiAlign <= 64 * 1024, "Page alignment of {0} bytes is not supported", uiAlign);
+
   ezTime fAllocationTime = ezTime::Now();
 
   void* ptr = ::VirtualAlloc(nullptr, uiSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
   EZ_ASSERT_DEV(ptr != nullptr, "Could not allocate memory pages. Error Code '{0}'", ezArgErrorCode(::GetLastError()));
 
-  size_t uiAlign = ezSystemInformation::Get().GetMemoryPageSize();
+  uiAlign = ezMath::Max<size_t>(uiAlign, ezSystemInformation::Get().GetMemoryPageSize());
   EZ_CHECK_ALIGNMENT(ptr, uiAlign);
 
   ezMemoryTracker::AddAllocation(GetPageAllocatorId(), ezMemoryTrackingFlags::Default, ptr, uiSize, uiAlign, ezTime::Now() - fAllocationTime);
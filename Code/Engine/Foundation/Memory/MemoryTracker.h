@@ -56,7 +56,7 @@ public:
 
     void** m_pStackTrace;
     size_t m_uiSize;
-    ezUInt16 m_uiAlignment;
+    ezUInt32 m_uiAlignment;
     ezUInt16 m_uiStackTraceLength;
 
     EZ_ALWAYS_INLINE const ezArrayPtr<void*> GetStackTrace() const
@@ -82,7 +82,7 @@ public:
     ezAllocatorId Id() const;
     const char* Name() const;
     ezAllocatorId ParentId() const;
-    const ezAllocatorBase::Stats& Stats() const;
+    ezAllocatorBase::Stats Stats() const;
 
     void Next();
     bool IsValid() const;
@@ -112,12 +112,20 @@ public:
   static void ResetPerFrameAllocatorStats();
 
   static const char* GetAllocatorName(ezAllocatorId allocatorId);
-  static const ezAllocatorBase::Stats& GetAllocatorStats(ezAllocatorId allocatorId);
+  static ezAllocatorBase::Stats GetAllocatorStats(ezAllocatorId allocatorId);
   static ezAllocatorId GetAllocatorParentId(ezAllocatorId allocatorId);
   static const AllocationInfo& GetAllocationInfo(ezAllocatorId allocatorId, const void* ptr);
 
   static void DumpMemoryLeaks();
 
+  /// \brief Only records a stack trace for every n-th allocation of allocators that have ezMemoryTrackingFlags::EnableStackTrace set.
+  ///
+  /// Capturing the stack trace is by far the most expensive part of tracking an allocation. The allocations in between are still
+  /// tracked, but leaks are reported without a stack trace. The default rate of 1 records a stack trace for every allocation.
+  /// The allocations are counted per thread. The rate can be changed at any time, threads pick it up with their next stack trace.
+  static void SetStackTraceSamplingRate(ezUInt32 uiRate);
+  static ezUInt32 GetStackTraceSamplingRate();
+
   static Iterator GetIterator();
 };
 
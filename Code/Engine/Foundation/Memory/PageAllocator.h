@@ -6,7 +6,10 @@
 class EZ_FOUNDATION_DLL ezPageAllocator
 {
 public:
-  static void* AllocatePage(size_t uiSize);
+  /// \brief Allocates uiSize bytes of whole pages. The memory is aligned to the page size or to uiAlign, whichever is larger.
+  ///
+  /// Alignments of up to 64 KB are supported on all platforms.
+  static void* AllocatePage(size_t uiSize, size_t uiAlign = 0);
   static void DeallocatePage(void* ptr);
 
   static ezAllocatorId GetId();
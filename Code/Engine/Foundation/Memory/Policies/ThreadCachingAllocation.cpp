@@ -0,0 +1,645 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Memory/AllocatorWrapper.h>
+#include <Foundation/Memory/PageAllocator.h>
+#include <Foundation/Memory/Policies/ThreadCachingAllocation.h>
+#include <Foundation/Threading/AtomicUtils.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/Mutex.h>
+
+namespace
+{
+  constexpr size_t s_uiSpanSize = 64 * 1024;
+  constexpr size_t s_uiSpanHeaderSize = 64;
+  constexpr ezUInt32 s_uiNumSpansPerChunk = 16;
+
+  constexpr size_t s_uiMaxSmallSize = 8 * 1024;
+  constexpr ezUInt32 s_uiNumSizeClasses = 32;
+
+  // Size classes are 16 bytes apart up to 128 bytes and four per power of two above that,
+  // which keeps the wasted memory per block below 25%.
+  EZ_ALWAYS_INLINE ezUInt32 GetSizeClass(size_t uiSize)
+  {
+    if (uiSize <= 128)
+      return static_cast<ezUInt32>((uiSize + 15) / 16) - 1;
+
+    const ezUInt32 uiLog2 = ezMath::FirstBitHigh(static_cast<ezUInt32>(uiSize - 1));
+    return 8 + (uiLog2 - 7) * 4 + static_cast<ezUInt32>((uiSize - 1) >> (uiLog2 - 2)) - 4;
+  }
+
+  EZ_ALWAYS_INLINE ezUInt32 GetClassSize(ezUInt32 uiSizeClass)
+  {
+    if (uiSizeClass < 8)
+      return (uiSizeClass + 1) * 16;
+
+    const ezUInt32 uiGroup = (uiSizeClass - 8) / 4;
+    return (128u << uiGroup) + ((uiSizeClass - 8) % 4 + 1) * (32u << uiGroup);
+  }
+
+  // The number of blocks that a thread cache fetches from or returns to the central free list at once
+  EZ_ALWAYS_INLINE ezUInt32 GetBatchSize(ezUInt32 uiSizeClass)
+  {
+    return ezMath::Clamp(16 * 1024 / GetClassSize(uiSizeClass), 4u, 64u);
+  }
+
+  struct FreeBlock
+  {
+    FreeBlock* m_pNext;
+  };
+
+  struct Chunk;
+
+  /// \brief Header at the start of every span, the blocks of one size class follow after s_uiSpanHeaderSize bytes.
+  struct Span
+  {
+    /// \brief Leaves m_pChunk untouched, it is set once by the depot.
+    void Init(ezUInt32 uiSizeClass)
+    {
+      m_uiSizeClass = uiSizeClass;
+      m_uiNumUsedBlocks = 0;
+      m_uiNumUncarvedBlocks = static_cast<ezUInt32>((s_uiSpanSize - s_uiSpanHeaderSize) / GetClassSize(uiSizeClass));
+      m_pFreeBlocks = nullptr;
+      m_pNextUncarvedBlock = reinterpret_cast<ezUInt8*>(this) + s_uiSpanHeaderSize;
+      m_pPrev = nullptr;
+      m_pNext = nullptr;
+    }
+
+    bool HasAvailableBlocks() const { return m_pFreeBlocks != nullptr || m_uiNumUncarvedBlocks > 0; }
+
+    FreeBlock* PopBlock()
+    {
+      ++m_uiNumUsedBlocks;
+
+      if (m_pFreeBlocks != nullptr)
+      {
+        FreeBlock* pBlock = m_pFreeBlocks;
+        m_pFreeBlocks = pBlock->m_pNext;
+        return pBlock;
+      }
+
+      // Blocks are carved on demand, so that memory of a fresh span is only touched when it is needed
+      FreeBlock* pBlock = reinterpret_cast<FreeBlock*>(m_pNextUncarvedBlock);
+      m_pNextUncarvedBlock += GetClassSize(m_uiSizeClass);
+      --m_uiNumUncarvedBlocks;
+      return pBlock;
+    }
+
+    void PushBlock(FreeBlock* pBlock)
+    {
+      pBlock->m_pNext = m_pFreeBlocks;
+      m_pFreeBlocks = pBlock;
+      --m_uiNumUsedBlocks;
+    }
+
+    ezUInt32 m_uiSizeClass;
+    ezUInt32 m_uiNumUsedBlocks;     ///< Blocks that are owned by thread caches or by the user.
+    ezUInt32 m_uiNumUncarvedBlocks; ///< Blocks at the end of the span that were never handed out.
+    FreeBlock* m_pFreeBlocks;
+    ezUInt8* m_pNextUncarvedBlock;
+
+    // Links in the list of spans with available blocks of the central free list
+    Span* m_pPrev;
+    Span* m_pNext;
+
+    Chunk* m_pChunk;
+  };
+
+  EZ_CHECK_AT_COMPILETIME(sizeof(Span) <= s_uiSpanHeaderSize);
+
+  EZ_ALWAYS_INLINE Span* GetSpan(void* ptr)
+  {
+    return static_cast<Span*>(ezMemoryUtils::Align(ptr, s_uiSpanSize));
+  }
+
+  /// \brief Remembers which spans belong to the allocator, so that Deallocate can tell them apart from large allocations.
+  ///
+  /// The first level covers a 48 bit address space, the leaves are allocated on demand and hold one bit per span.
+  /// Leaves are never freed. They come from the static allocator, so that the memory tracker doesn't report them as leaks.
+  class SpanMap
+  {
+  public:
+    bool Contains(const void* ptr) const
+    {
+      const ezUInt64 uiSpanIndex = reinterpret_cast<size_t>(ptr) / s_uiSpanSize;
+      const ezUInt64 uiLeafIndex = uiSpanIndex >> s_uiLeafBits;
+      if (uiLeafIndex >= s_uiNumLeaves)
+        return false;
+
+      const ezInt32* pLeaf = m_pLeaves[uiLeafIndex];
+      if (pLeaf == nullptr)
+        return false;
+
+      const ezUInt32 uiBit = static_cast<ezUInt32>(uiSpanIndex) & (s_uiSpansPerLeaf - 1);
+      return (pLeaf[uiBit / 32] & static_cast<ezInt32>(1u << (uiBit % 32))) != 0;
+    }
+
+    /// \brief Only called by the depot while its mutex is locked. Fails for addresses outside the covered range.
+    bool Add(const void* pSpan)
+    {
+      const ezUInt64 uiSpanIndex = reinterpret_cast<size_t>(pSpan) / s_uiSpanSize;
+      const ezUInt64 uiLeafIndex = uiSpanIndex >> s_uiLeafBits;
+      if (uiLeafIndex >= s_uiNumLeaves)
+        return false;
+
+      if (m_pLeaves[uiLeafIndex] == nullptr)
+      {
+        ezInt32* pLeaf = EZ_NEW_RAW_BUFFER(ezStaticAllocatorWrapper::GetAllocator(), ezInt32, s_uiSpansPerLeaf / 32);
+        ezMemoryUtils::ZeroFill(pLeaf, s_uiSpansPerLeaf / 32);
+        m_pLeaves[uiLeafIndex] = pLeaf;
+      }
+
+      // Other threads may read the same word concurrently
+      const ezUInt32 uiBit = static_cast<ezUInt32>(uiSpanIndex) & (s_uiSpansPerLeaf - 1);
+      ezAtomicUtils::Or(m_pLeaves[uiLeafIndex][uiBit / 32], static_cast<ezInt32>(1u << (uiBit % 32)));
+      return true;
+    }
+
+    /// \brief Only called by the depot while its mutex is locked, before the memory of the span is released.
+    void Remove(const void* pSpan)
+    {
+      const ezUInt64 uiSpanIndex = reinterpret_cast<size_t>(pSpan) / s_uiSpanSize;
+      const ezUInt32 uiBit = static_cast<ezUInt32>(uiSpanIndex) & (s_uiSpansPerLeaf - 1);
+      ezAtomicUtils::And(m_pLeaves[uiSpanIndex >> s_uiLeafBits][uiBit / 32], ~static_cast<ezInt32>(1u << (uiBit % 32)));
+    }
+
+  private:
+    static constexpr ezUInt32 s_uiLeafBits = 20;
+    static constexpr ezUInt32 s_uiSpansPerLeaf = 1u << s_uiLeafBits;
+    static constexpr ezUInt32 s_uiNumLeaves = 1u << (48 - 16 - s_uiLeafBits);
+
+    EZ_CHECK_AT_COMPILETIME(s_uiSpanSize == (1u << 16));
+
+    ezInt32* volatile m_pLeaves[s_uiNumLeaves] = {};
+  };
+
+  /// \brief Bookkeeping of s_uiNumSpansPerChunk consecutive spans that were allocated from the page allocator at once.
+  struct Chunk
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt8* m_pMemory;
+    Span* m_pFreeSpans;
+    ezUInt32 m_uiNumFreeSpans;
+
+    // Links in the list of chunks with free spans of the depot
+    Chunk* m_pPrev;
+    Chunk* m_pNext;
+  };
+
+  /// \brief Hands out unused spans and allocates new chunks of spans from the page allocator.
+  ///
+  /// Chunks whose spans are all unused are given back to the page allocator, except for one that is kept to avoid allocating and
+  /// releasing a chunk over and over when the number of used spans goes up and down around a chunk boundary.
+  class SpanDepot
+  {
+  public:
+    Span* AllocateSpan(ezUInt32 uiSizeClass)
+    {
+      Span* pSpan = nullptr;
+
+      {
+        EZ_LOCK(m_Mutex);
+
+        if (m_pChunks == nullptr)
+        {
+          AllocateChunk();
+        }
+
+        // The empty chunk is only used when no other chunk has free spans, so that partially used chunks fill up first
+        Chunk* pChunk = m_pChunks;
+        if (pChunk == m_pEmptyChunk && pChunk != nullptr && pChunk->m_pNext != nullptr)
+        {
+          pChunk = pChunk->m_pNext;
+        }
+
+        if (pChunk != nullptr)
+        {
+          pSpan = pChunk->m_pFreeSpans;
+          pChunk->m_pFreeSpans = pSpan->m_pNext;
+
+          if (pChunk == m_pEmptyChunk)
+          {
+            m_pEmptyChunk = nullptr;
+          }
+
+          if (--pChunk->m_uiNumFreeSpans == 0)
+          {
+            Unlink(pChunk);
+          }
+        }
+      }
+
+      if (pSpan != nullptr)
+      {
+        pSpan->Init(uiSizeClass);
+      }
+
+      return pSpan;
+    }
+
+    void DeallocateSpan(Span* pSpan)
+    {
+      EZ_LOCK(m_Mutex);
+
+      Chunk* pChunk = pSpan->m_pChunk;
+
+      pSpan->m_pNext = pChunk->m_pFreeSpans;
+      pChunk->m_pFreeSpans = pSpan;
+
+      if (pChunk->m_uiNumFreeSpans++ == 0)
+      {
+        Link(pChunk);
+      }
+
+      if (pChunk->m_uiNumFreeSpans == s_uiNumSpansPerChunk)
+      {
+        if (m_pEmptyChunk == nullptr)
+        {
+          m_pEmptyChunk = pChunk;
+        }
+        else
+        {
+          Unlink(pChunk);
+          DeallocateChunk(pChunk);
+        }
+      }
+    }
+
+    EZ_ALWAYS_INLINE bool Contains(const void* ptr) const { return m_SpanMap.Contains(ptr); }
+
+  private:
+    void AllocateChunk()
+    {
+      const size_t uiChunkSize = s_uiSpanSize * s_uiNumSpansPerChunk;
+
+      // Aligned to the span size, so that every span of the chunk can be used
+      ezUInt8* pMemory = static_cast<ezUInt8*>(ezPageAllocator::AllocatePage(uiChunkSize, s_uiSpanSize));
+      if (pMemory == nullptr)
+        return;
+
+      for (ezUInt32 i = 0; i < s_uiNumSpansPerChunk; ++i)
+      {
+        if (!m_SpanMap.Add(pMemory + i * s_uiSpanSize))
+        {
+          // All allocations will go to the heap instead
+          for (ezUInt32 j = 0; j < i; ++j)
+          {
+            m_SpanMap.Remove(pMemory + j * s_uiSpanSize);
+          }
+
+          ezPageAllocator::DeallocatePage(pMemory);
+          return;
+        }
+      }
+
+      // The static allocator uses malloc, and the memory tracker treats chunks that are referenced by a static allocation as not leaked
+      Chunk* pChunk = EZ_NEW(ezStaticAllocatorWrapper::GetAllocator(), Chunk);
+      pChunk->m_pMemory = pMemory;
+      pChunk->m_pFreeSpans = nullptr;
+      pChunk->m_uiNumFreeSpans = s_uiNumSpansPerChunk;
+
+      for (ezUInt32 i = s_uiNumSpansPerChunk; i > 0; --i)
+      {
+        Span* pSpan = reinterpret_cast<Span*>(pMemory + (i - 1) * s_uiSpanSize);
+        pSpan->m_pChunk = pChunk;
+        pSpan->m_pNext = pChunk->m_pFreeSpans;
+        pChunk->m_pFreeSpans = pSpan;
+      }
+
+      Link(pChunk);
+      m_pEmptyChunk = pChunk;
+    }
+
+    void DeallocateChunk(Chunk* pChunk)
+    {
+      // Deallocate only sees pointers of live allocations, none of them can be inside the chunk anymore
+      for (ezUInt32 i = 0; i < s_uiNumSpansPerChunk; ++i)
+      {
+        m_SpanMap.Remove(pChunk->m_pMemory + i * s_uiSpanSize);
+      }
+
+      ezPageAllocator::DeallocatePage(pChunk->m_pMemory);
+      EZ_DELETE(ezStaticAllocatorWrapper::GetAllocator(), pChunk);
+    }
+
+    void Link(Chunk* pChunk)
+    {
+      pChunk->m_pPrev = nullptr;
+      pChunk->m_pNext = m_pChunks;
+
+      if (m_pChunks != nullptr)
+      {
+        m_pChunks->m_pPrev = pChunk;
+      }
+
+      m_pChunks = pChunk;
+    }
+
+    void Unlink(Chunk* pChunk)
+    {
+      if (pChunk->m_pPrev != nullptr)
+        pChunk->m_pPrev->m_pNext = pChunk->m_pNext;
+      else
+        m_pChunks = pChunk->m_pNext;
+
+      if (pChunk->m_pNext != nullptr)
+      {
+        pChunk->m_pNext->m_pPrev = pChunk->m_pPrev;
+      }
+
+      pChunk->m_pPrev = nullptr;
+      pChunk->m_pNext = nullptr;
+    }
+
+    ezMutex m_Mutex;
+    Chunk* m_pChunks = nullptr;     ///< Chunks that have at least one free span.
+    Chunk* m_pEmptyChunk = nullptr; ///< The one chunk without any used spans that is kept.
+    SpanMap m_SpanMap;
+  };
+
+  /// \brief Exchanges blocks of one size class with the thread caches. Keeps a list of all spans that have blocks available.
+  class CentralFreeList
+  {
+  public:
+    /// \brief Returns a list of up to uiCount blocks and the number of blocks in it.
+    ezUInt32 FetchBlocks(SpanDepot& depot, ezUInt32 uiSizeClass, ezUInt32 uiCount, FreeBlock*& out_pBlocks)
+    {
+      EZ_LOCK(m_Mutex);
+
+      FreeBlock* pBlocks = nullptr;
+      ezUInt32 uiNumBlocks = 0;
+
+      while (uiNumBlocks < uiCount)
+      {
+        if (m_pSpans == nullptr)
+        {
+          Span* pNewSpan = depot.AllocateSpan(uiSizeClass);
+          if (pNewSpan == nullptr)
+            break;
+
+          Link(pNewSpan);
+        }
+
+        Span* pSpan = m_pSpans;
+
+        FreeBlock* pBlock = pSpan->PopBlock();
+        pBlock->m_pNext = pBlocks;
+        pBlocks = pBlock;
+        ++uiNumBlocks;
+
+        if (!pSpan->HasAvailableBlocks())
+        {
+          Unlink(pSpan);
+        }
+      }
+
+      out_pBlocks = pBlocks;
+      return uiNumBlocks;
+    }
+
+    /// \brief Gives a list of blocks back to their spans. Spans that become unused go back to the depot.
+    void ReturnBlocks(SpanDepot& depot, FreeBlock* pBlocks)
+    {
+      EZ_LOCK(m_Mutex);
+
+      while (pBlocks != nullptr)
+      {
+        FreeBlock* pBlock = pBlocks;
+        pBlocks = pBlock->m_pNext;
+
+        Span* pSpan = GetSpan(pBlock);
+        const bool bWasFull = !pSpan->HasAvailableBlocks();
+
+        pSpan->PushBlock(pBlock);
+
+        if (bWasFull)
+        {
+          Link(pSpan);
+        }
+
+        // Keep the last span of the size class, so that a single allocation that is freed over and over doesn't go to the depot every time
+        if (pSpan->m_uiNumUsedBlocks == 0 && (pSpan->m_pPrev != nullptr || pSpan->m_pNext != nullptr))
+        {
+          Unlink(pSpan);
+          depot.DeallocateSpan(pSpan);
+        }
+      }
+    }
+
+  private:
+    void Link(Span* pSpan)
+    {
+      pSpan->m_pPrev = nullptr;
+      pSpan->m_pNext = m_pSpans;
+
+      if (m_pSpans != nullptr)
+      {
+        m_pSpans->m_pPrev = pSpan;
+      }
+
+      m_pSpans = pSpan;
+    }
+
+    void Unlink(Span* pSpan)
+    {
+      if (pSpan->m_pPrev != nullptr)
+        pSpan->m_pPrev->m_pNext = pSpan->m_pNext;
+      else
+        m_pSpans = pSpan->m_pNext;
+
+      if (pSpan->m_pNext != nullptr)
+      {
+        pSpan->m_pNext->m_pPrev = pSpan->m_pPrev;
+      }
+
+      pSpan->m_pPrev = nullptr;
+      pSpan->m_pNext = nullptr;
+    }
+
+    ezMutex m_Mutex;
+    Span* m_pSpans = nullptr;
+  };
+
+  struct ThreadCachingHeap
+  {
+    SpanDepot m_Depot;
+    CentralFreeList m_CentralFreeLists[s_uiNumSizeClasses];
+  };
+
+  EZ_ALIGN_VARIABLE(static ezUInt8 s_HeapBuffer[sizeof(ThreadCachingHeap)], EZ_ALIGNMENT_OF(ThreadCachingHeap));
+
+  ThreadCachingHeap& GetHeap()
+  {
+    // Never destroyed, memory may still be freed by static destructors during shutdown
+    static ThreadCachingHeap* s_pHeap = new (s_HeapBuffer) ThreadCachingHeap();
+    return *s_pHeap;
+  }
+
+  struct ThreadCache
+  {
+    struct FreeList
+    {
+      FreeBlock* m_pBlocks = nullptr;
+      ezUInt32 m_uiNumBlocks = 0;
+    };
+
+    ~ThreadCache();
+
+    FreeList m_FreeLists[s_uiNumSizeClasses];
+  };
+
+  thread_local ThreadCache tl_ThreadCache;
+
+  // Set once tl_ThreadCache is destroyed, memory that is freed by other thread_local destructors afterwards goes straight to the
+  // central free lists
+  thread_local bool tl_bThreadCacheDestroyed = false;
+
+  ThreadCache::~ThreadCache()
+  {
+    ThreadCachingHeap& heap = GetHeap();
+
+    for (ezUInt32 uiSizeClass = 0; uiSizeClass < s_uiNumSizeClasses; ++uiSizeClass)
+    {
+      FreeList& freeList = m_FreeLists[uiSizeClass];
+      if (freeList.m_pBlocks != nullptr)
+      {
+        heap.m_CentralFreeLists[uiSizeClass].ReturnBlocks(heap.m_Depot, freeList.m_pBlocks);
+        freeList = FreeList();
+      }
+    }
+
+    tl_bThreadCacheDestroyed = true;
+  }
+
+  void* AllocateSmall(ezUInt32 uiSizeClass)
+  {
+    ThreadCachingHeap& heap = GetHeap();
+
+    if (tl_bThreadCacheDestroyed)
+    {
+      FreeBlock* pBlock = nullptr;
+      heap.m_CentralFreeLists[uiSizeClass].FetchBlocks(heap.m_Depot, uiSizeClass, 1, pBlock);
+      return pBlock;
+    }
+
+    ThreadCache::FreeList& freeList = tl_ThreadCache.m_FreeLists[uiSizeClass];
+
+    if (freeList.m_pBlocks == nullptr)
+    {
+      freeList.m_uiNumBlocks =
+        heap.m_CentralFreeLists[uiSizeClass].FetchBlocks(heap.m_Depot, uiSizeClass, GetBatchSize(uiSizeClass), freeList.m_pBlocks);
+
+      if (freeList.m_pBlocks == nullptr)
+        return nullptr;
+    }
+
+    FreeBlock* pBlock = freeList.m_pBlocks;
+    freeList.m_pBlocks = pBlock->m_pNext;
+    --freeList.m_uiNumBlocks;
+
+    return pBlock;
+  }
+
+  void DeallocateSmall(ThreadCachingHeap& heap, FreeBlock* pBlock)
+  {
+    const ezUInt32 uiSizeClass = GetSpan(pBlock)->m_uiSizeClass;
+
+    if (tl_bThreadCacheDestroyed)
+    {
+      pBlock->m_pNext = nullptr;
+      heap.m_CentralFreeLists[uiSizeClass].ReturnBlocks(heap.m_Depot, pBlock);
+      return;
+    }
+
+    ThreadCache::FreeList& freeList = tl_ThreadCache.m_FreeLists[uiSizeClass];
+
+    pBlock->m_pNext = freeList.m_pBlocks;
+    freeList.m_pBlocks = pBlock;
+    ++freeList.m_uiNumBlocks;
+
+    // Threads that free more than they allocate, e.g. consumers of data produced on other threads, return their surplus in batches
+    const ezUInt32 uiBatchSize = GetBatchSize(uiSizeClass);
+    if (freeList.m_uiNumBlocks > 2 * uiBatchSize)
+    {
+      FreeBlock* pBatch = freeList.m_pBlocks;
+      FreeBlock* pLast = pBatch;
+      for (ezUInt32 i = 1; i < uiBatchSize; ++i)
+      {
+        pLast = pLast->m_pNext;
+      }
+
+      freeList.m_pBlocks = pLast->m_pNext;
+      freeList.m_uiNumBlocks -= uiBatchSize;
+      pLast->m_pNext = nullptr;
+
+      heap.m_CentralFreeLists[uiSizeClass].ReturnBlocks(heap.m_Depot, pBatch);
+    }
+  }
+} // namespace
+
+namespace ezMemoryPolicies
+{
+  void* ezThreadCachingAllocation::Allocate(size_t uiSize, size_t uiAlign)
+  {
+    // Blocks are 16 byte aligned, but large allocations have no alignment guarantees beyond those of malloc.
+    // Use an aligned allocator for types that need more than 8 bytes, e.g. ezAlignedAllocatorWrapper.
+    EZ_ASSERT_DEBUG(
+      uiAlign <= 8, "This allocator does not guarantee alignments larger than 8. Use an aligned allocator to allocate the desired data type.");
+
+    if (uiSize <= s_uiMaxSmallSize)
+    {
+      if (void* ptr = AllocateSmall(GetSizeClass(ezMath::Max<size_t>(uiSize, 1))))
+        return ptr;
+    }
+
+    void* ptr = malloc(uiSize);
+    EZ_CHECK_ALIGNMENT(ptr, uiAlign);
+
+    return ptr;
+  }
+
+  void* ezThreadCachingAllocation::Reallocate(void* currentPtr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign)
+  {
+    ThreadCachingHeap& heap = GetHeap();
+
+    if (!heap.m_Depot.Contains(currentPtr))
+    {
+      if (uiNewSize > s_uiMaxSmallSize)
+      {
+        void* ptr = realloc(currentPtr, uiNewSize);
+        EZ_CHECK_ALIGNMENT(ptr, uiAlign);
+
+        return ptr;
+      }
+    }
+    else if (uiNewSize <= s_uiMaxSmallSize && GetSizeClass(ezMath::Max<size_t>(uiNewSize, 1)) == GetSpan(currentPtr)->m_uiSizeClass)
+    {
+      return currentPtr;
+    }
+
+    void* pNewPtr = Allocate(uiNewSize, uiAlign);
+    ezMemoryUtils::RawByteCopy(pNewPtr, currentPtr, ezMath::Min(uiCurrentSize, uiNewSize));
+    Deallocate(currentPtr);
+
+    return pNewPtr;
+  }
+
+  void ezThreadCachingAllocation::Deallocate(void* ptr)
+  {
+    if (ptr == nullptr)
+      return;
+
+    ThreadCachingHeap& heap = GetHeap();
+
+    if (heap.m_Depot.Contains(ptr))
+    {
+      DeallocateSmall(heap, static_cast<FreeBlock*>(ptr));
+    }
+    else
+    {
+      free(ptr);
+    }
+  }
+} // namespace ezMemoryPolicies
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Memory_Policies_ThreadCachingAllocation);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <Foundation/Basics.h>
+
+namespace ezMemoryPolicies
+{
+  /// \brief Small-object allocation policy with per-thread caches.
+  ///
+  /// Allocations of up to 8 KB are rounded up to one of 32 size classes and served from free lists of the calling thread
+  /// without taking any locks. The thread caches fetch and return blocks in batches from a central free list per size class,
+  /// which carves them out of 64 KB spans. The spans come from a depot that allocates them in chunks of 16 with ezPageAllocator.
+  /// Memory that is freed on another thread goes into the cache of the freeing thread and flows back through the central free lists.
+  /// Larger allocations are forwarded to malloc.
+  ///
+  /// All instances share the same caches and spans. Spans that are completely unused go back to the depot and can be reused
+  /// for any size class. Chunks whose spans are all unused are returned to ezPageAllocator, except for one.
+  ///
+  /// \see ezAllocator
+  class EZ_FOUNDATION_DLL ezThreadCachingAllocation
+  {
+  public:
+    EZ_ALWAYS_INLINE ezThreadCachingAllocation(ezAllocatorBase* pParent) {}
+    EZ_ALWAYS_INLINE ~ezThreadCachingAllocation() {}
+
+    void* Allocate(size_t uiSize, size_t uiAlign);
+    void* Reallocate(void* currentPtr, size_t uiCurrentSize, size_t uiNewSize, size_t uiAlign);
+    void Deallocate(void* ptr);
+
+    EZ_ALWAYS_INLINE ezAllocatorBase* GetParent() const { return nullptr; }
+  };
+} // namespace ezMemoryPolicies
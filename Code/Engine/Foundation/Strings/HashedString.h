@@ -14,7 +14,9 @@ class ezTempHashedString;
 /// (it's a pointer comparison).\n
 /// Copying ezHashedString objects around and assigning between them is very fast as well.\n
 /// \n
-/// Assigning from some other string type is rather slow though, as it requires thread synchronization.\n
+/// Assigning from some other string type is rather slow though, as it requires thread synchronization. The central storage is split
+/// into shards by hash though, so threads only contend when they create strings that end up in the same shard. For string literals
+/// use EZ_HASHED_STRING, which computes the hash at compile time and only accesses the storage once per call site.\n
 /// You can also get access to the actual string data via GetString().\n
 /// \n
 /// You should use ezHashedString whenever the size of the encapsulating object is important and when changes to the string itself
@@ -79,6 +81,11 @@ public:
   template <size_t N>
   void Assign(char (&szString)[N]) = delete;
 
+  /// \brief Creates a hashed string from a string constant whose hash was already computed at compile time. Use EZ_HASHED_STRING instead
+  /// of calling this directly.
+  template <ezUInt32 uiHash, size_t N>
+  static ezHashedString MakeFromLiteral(const char (&szString)[N]);
+
   /// \brief Assigning a new string from a non-hashed string is a very slow operation, this should be used rarely.
   ///
   /// If you need to create an object to compare ezHashedString objects against, prefer to use ezTempHashedString. It will only compute
@@ -143,6 +150,16 @@ private:
 template <size_t N>
 ezHashedString ezMakeHashedString(const char (&szString)[N]);
 
+/// \brief Evaluates to a const reference to the ezHashedString for the given string literal.
+///
+/// The hash is computed at compile time and the central storage is only accessed the first time a call site is executed, afterwards
+/// it is just the read of a static variable. Prefer this over ezMakeHashedString and Assign for literals in frequently executed code.
+#define EZ_HASHED_STRING(szLiteral)                                                                                                         \
+  ([]() -> const ezHashedString& {                                                                                                         \
+    static const ezHashedString s_sHashedLiteral = ezHashedString::MakeFromLiteral<ezHashingUtils::MurmurHash32String(szLiteral)>(szLiteral); \
+    return s_sHashedLiteral;                                                                                                               \
+  }())
+
 
 /// \brief A class to use together with ezHashedString for quick comparisons with temporary strings that need not be stored further.
 ///
@@ -4,13 +4,33 @@
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/Mutex.h>
 
-struct HashedStringData
+// Strings are distributed over the shards by their hash, so threads that create different strings rarely wait for each other.
+// Every shard sits on its own cache line to keep the mutexes of neighboring shards from false sharing.
+struct EZ_ALIGN(HashedStringShard, 64)
 {
   ezMutex m_Mutex;
   ezHashedString::StringStorage m_Storage;
+};
+
+struct HashedStringData
+{
+  enum
+  {
+    NumShards = 64
+  };
+
+  EZ_ALWAYS_INLINE HashedStringShard& GetShard(ezUInt32 uiHash)
+  {
+    // the upper bits of the murmur hash are just as well distributed as the lower ones
+    return m_Shards[uiHash >> 26];
+  }
+
+  HashedStringShard m_Shards[NumShards];
   ezHashedString::HashedType m_Empty;
 };
 
+EZ_CHECK_AT_COMPILETIME_MSG(HashedStringData::NumShards == (1 << (32 - 26)), "GetShard() needs to be adjusted to the number of shards");
+
 static HashedStringData* s_pHSData;
 
 EZ_MSVC_ANALYSIS_WARNING_PUSH
@@ -22,11 +42,12 @@ ezHashedString::HashedType ezHashedString::AddHashedString(const char* szString,
   if (s_pHSData == nullptr)
     InitHashedString();
 
-  EZ_LOCK(s_pHSData->m_Mutex);
+  HashedStringShard& shard = s_pHSData->GetShard(uiHash);
+  EZ_LOCK(shard.m_Mutex);
 
   // try to find the existing string
   bool bExisted = false;
-  auto ret = s_pHSData->m_Storage.FindOrAdd(uiHash, &bExisted);
+  auto ret = shard.m_Storage.FindOrAdd(uiHash, &bExisted);
 
   // if it already exists, just increase the refcount
   if (bExisted)
@@ -70,19 +91,22 @@ void ezHashedString::InitHashedString()
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
 ezUInt32 ezHashedString::ClearUnusedStrings()
 {
-  EZ_LOCK(s_pHSData->m_Mutex);
-
   ezUInt32 uiDeleted = 0;
 
-  for (auto it = s_pHSData->m_Storage.GetIterator(); it.IsValid();)
+  for (HashedStringShard& shard : s_pHSData->m_Shards)
   {
-    if (it.Value().m_iRefCount == 0)
+    EZ_LOCK(shard.m_Mutex);
+
+    for (auto it = shard.m_Storage.GetIterator(); it.IsValid();)
     {
-      it = s_pHSData->m_Storage.Remove(it);
-      ++uiDeleted;
+      if (it.Value().m_iRefCount == 0)
+      {
+        it = shard.m_Storage.Remove(it);
+        ++uiDeleted;
+      }
+      else
+        ++it;
     }
-    else
-      ++it;
   }
 
   return uiDeleted;
@@ -69,6 +69,20 @@ EZ_FORCE_INLINE void ezHashedString::Assign(const char (&szString)[N])
 #endif
 }
 
+template <ezUInt32 uiHash, size_t N>
+ezHashedString ezHashedString::MakeFromLiteral(const char (&szString)[N])
+{
+  EZ_ASSERT_DEBUG(uiHash == ezHashingUtils::MurmurHash32String(szString), "The hash does not belong to the string");
+
+  ezHashedString sResult;
+#if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
+  sResult.m_Data.Value().m_iRefCount.Decrement();
+#endif
+  // this function will already increase the refcount as needed
+  sResult.m_Data = AddHashedString(szString, uiHash);
+  return sResult;
+}
+
 EZ_FORCE_INLINE void ezHashedString::Assign(ezHashingUtils::StringWrapper szString)
 {
 #if EZ_ENABLED(EZ_HASHED_STRING_REF_COUNTING)
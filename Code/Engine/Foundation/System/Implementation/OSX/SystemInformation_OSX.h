@@ -81,6 +81,9 @@ void ezSystemInformation::Initialize()
     strcpy(s_SystemInformation.m_sHostName, "");
   }
 
+  // OSX does not expose the assignment of logical CPUs to cores and there is no NUMA
+  InitializeDefaultCPUTopology();
+
   s_SystemInformation.m_bIsInitialized = true;
 }
 
@@ -99,6 +102,11 @@ ezUInt64 ezSystemInformation::GetAvailableMainMemory() const
   return static_cast<ezUInt64>(s_SystemInformation.m_uiMemoryPageSize) * static_cast<ezUInt64>(vmt.t_free);
 }
 
+ezInt32 ezSystemInformation::GetNumaNodeOfAddress(const void* pAddress) const
+{
+  return 0;
+}
+
 float ezSystemInformation::GetCPUUtilization() const
 {
   EZ_ASSERT_NOT_IMPLEMENTED;
@@ -1,8 +1,132 @@
 #include <Foundation/FoundationInternal.h>
 EZ_FOUNDATION_INTERNAL_HEADER
 
+#include <stdio.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
+static bool ezReadSysFile(const char* szPath, char* szBuffer, ezUInt32 uiBufferSize)
+{
+  FILE* pFile = fopen(szPath, "r");
+  if (pFile == nullptr)
+    return false;
+
+  const size_t uiRead = fread(szBuffer, 1, uiBufferSize - 1, pFile);
+  fclose(pFile);
+
+  szBuffer[uiRead] = '\0';
+  return uiRead > 0;
+}
+
+static bool ezReadSysFileUInt(const char* szPath, ezUInt32& out_uiValue)
+{
+  char szBuffer[32];
+  if (!ezReadSysFile(szPath, szBuffer, sizeof(szBuffer)))
+    return false;
+
+  char* szEnd = nullptr;
+  const long iValue = strtol(szBuffer, &szEnd, 10);
+
+  // some platforms report -1 for unknown values
+  if (szEnd == szBuffer || iValue < 0)
+    return false;
+
+  out_uiValue = static_cast<ezUInt32>(iValue);
+  return true;
+}
+
+// Calls func for every index in a list like "0-3,8-11", which is the format that sysfs uses for sets of CPUs or nodes.
+template <typename Func>
+static void ezForEachInSysList(const char* szList, Func func)
+{
+  const char* szCur = szList;
+
+  while (true)
+  {
+    char* szEnd = nullptr;
+    const ezUInt32 uiFirst = static_cast<ezUInt32>(strtoul(szCur, &szEnd, 10));
+    if (szEnd == szCur)
+      return;
+
+    ezUInt32 uiLast = uiFirst;
+    szCur = szEnd;
+
+    if (*szCur == '-')
+    {
+      ++szCur;
+      uiLast = static_cast<ezUInt32>(strtoul(szCur, &szEnd, 10));
+      if (szEnd == szCur)
+        return;
+
+      szCur = szEnd;
+    }
+
+    for (ezUInt32 i = uiFirst; i <= uiLast; ++i)
+    {
+      func(i);
+    }
+
+    if (*szCur != ',')
+      return;
+
+    ++szCur;
+  }
+}
+
+// Reads the package, core and NUMA node of all online CPUs from sysfs. Returns the number of CPUs that were found.
+static ezUInt32 ezReadCPUTopology(ezSystemInformation::LogicalCPU* pCPUs, ezUInt32 uiMaxCPUs)
+{
+  char szBuffer[4096];
+  char szPath[128];
+  ezUInt32 uiValue = 0;
+
+  if (!ezReadSysFile("/sys/devices/system/cpu/online", szBuffer, sizeof(szBuffer)))
+    return 0;
+
+  ezUInt32 uiNumCPUs = 0;
+
+  ezForEachInSysList(szBuffer, [&](ezUInt32 uiCPU) {
+    if (uiNumCPUs >= uiMaxCPUs || uiCPU > 0xFFFF)
+      return;
+
+    ezSystemInformation::LogicalCPU& cpu = pCPUs[uiNumCPUs++];
+    cpu.m_uiCPUIndex = static_cast<ezUInt16>(uiCPU);
+    cpu.m_uiPhysicalCore = static_cast<ezUInt16>(uiCPU);
+    cpu.m_uiSMTIndex = 0;
+    cpu.m_uiPackage = 0;
+    cpu.m_uiNumaNode = 0;
+
+    snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", uiCPU);
+    if (ezReadSysFileUInt(szPath, uiValue))
+      cpu.m_uiPackage = static_cast<ezUInt8>(ezMath::Min(uiValue, 255u));
+
+    snprintf(szPath, sizeof(szPath), "/sys/devices/system/cpu/cpu%u/topology/core_id", uiCPU);
+    if (ezReadSysFileUInt(szPath, uiValue))
+      cpu.m_uiPhysicalCore = static_cast<ezUInt16>(uiValue & 0xFFFF);
+  });
+
+  // every node directory lists the CPUs that belong to it, node directories only exist on kernels with NUMA support
+  for (ezUInt32 uiNode = 0; uiNode < ezSystemInformation::MaxNumaNodes; ++uiNode)
+  {
+    snprintf(szPath, sizeof(szPath), "/sys/devices/system/node/node%u/cpulist", uiNode);
+    if (!ezReadSysFile(szPath, szBuffer, sizeof(szBuffer)))
+      continue;
+
+    ezForEachInSysList(szBuffer, [&](ezUInt32 uiCPU) {
+      for (ezUInt32 i = 0; i < uiNumCPUs; ++i)
+      {
+        if (pCPUs[i].m_uiCPUIndex == uiCPU)
+        {
+          pCPUs[i].m_uiNumaNode = static_cast<ezUInt8>(uiNode);
+          break;
+        }
+      }
+    });
+  }
+
+  return uiNumCPUs;
+}
+
 bool ezSystemInformation::IsDebuggerAttached()
 {
   //TODO: No simple way to test without massive overhead.
@@ -54,6 +178,14 @@ void ezSystemInformation::Initialize()
     strcpy(s_SystemInformation.m_sHostName, "");
   }
 
+  InitializeDefaultCPUTopology();
+
+  if (const ezUInt32 uiNumCPUs = ezReadCPUTopology(s_SystemInformation.m_LogicalCPUs, MaxLogicalCPUs))
+  {
+    s_SystemInformation.m_uiNumLogicalCPUs = uiNumCPUs;
+    FinalizeCPUTopology();
+  }
+
   s_SystemInformation.m_bIsInitialized = true;
 }
 
@@ -62,6 +194,25 @@ ezUInt64 ezSystemInformation::GetAvailableMainMemory() const
   return static_cast<ezUInt64>(sysconf(_SC_AVPHYS_PAGES)) * static_cast<ezUInt64>(sysconf(_SC_PAGESIZE));
 }
 
+ezInt32 ezSystemInformation::GetNumaNodeOfAddress(const void* pAddress) const
+{
+  if (m_uiNumNumaNodes <= 1)
+    return 0;
+
+#if defined(SYS_get_mempolicy)
+  // MPOL_F_NODE | MPOL_F_ADDR: return the node on which the page at pAddress is allocated, see get_mempolicy(2)
+  const unsigned long uiFlags = (1 << 0) | (1 << 1);
+
+  int iNode = -1;
+  if (syscall(SYS_get_mempolicy, &iNode, nullptr, 0, pAddress, uiFlags) != 0)
+    return -1;
+
+  return (iNode >= 0 && iNode < static_cast<int>(MaxNumaNodes)) ? iNode : -1;
+#else
+  return -1;
+#endif
+}
+
 float ezSystemInformation::GetCPUUtilization() const
 {
   EZ_ASSERT_NOT_IMPLEMENTED;
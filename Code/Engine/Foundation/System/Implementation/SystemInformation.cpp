@@ -16,6 +16,70 @@ ezSystemInformation ezSystemInformation::s_SystemInformation;
 #error "System configuration functions are not implemented on current platform"
 #endif
 
+void ezSystemInformation::InitializeDefaultCPUTopology()
+{
+  ezSystemInformation& info = s_SystemInformation;
+
+  info.m_uiNumLogicalCPUs = ezMath::Clamp(info.m_uiCPUCoreCount, 1u, MaxLogicalCPUs);
+
+  for (ezUInt32 i = 0; i < info.m_uiNumLogicalCPUs; ++i)
+  {
+    LogicalCPU& cpu = info.m_LogicalCPUs[i];
+    cpu.m_uiCPUIndex = static_cast<ezUInt16>(i);
+    cpu.m_uiPhysicalCore = static_cast<ezUInt16>(i);
+    cpu.m_uiSMTIndex = 0;
+    cpu.m_uiPackage = 0;
+    cpu.m_uiNumaNode = 0;
+  }
+
+  FinalizeCPUTopology();
+}
+
+void ezSystemInformation::FinalizeCPUTopology()
+{
+  ezSystemInformation& info = s_SystemInformation;
+
+  // the platform code stores OS specific core ids in m_uiPhysicalCore, which are only unique per package
+  // here they get replaced by a dense index over all packages
+  ezUInt32 uiCoreKeys[MaxLogicalCPUs];
+  ezUInt32 uiNumCores = 0;
+
+  info.m_uiNumPackages = 1;
+  info.m_uiNumNumaNodes = 1;
+
+  for (ezUInt32 i = 0; i < info.m_uiNumLogicalCPUs; ++i)
+  {
+    LogicalCPU& cpu = info.m_LogicalCPUs[i];
+    cpu.m_uiNumaNode = static_cast<ezUInt8>(ezMath::Min<ezUInt32>(cpu.m_uiNumaNode, MaxNumaNodes - 1));
+
+    const ezUInt32 uiKey = (static_cast<ezUInt32>(cpu.m_uiPackage) << 16) | cpu.m_uiPhysicalCore;
+
+    ezUInt32 uiCore = 0;
+    while (uiCore < uiNumCores && uiCoreKeys[uiCore] != uiKey)
+      ++uiCore;
+
+    if (uiCore == uiNumCores)
+    {
+      uiCoreKeys[uiNumCores++] = uiKey;
+    }
+
+    // count the siblings on the same core that came before this one
+    cpu.m_uiSMTIndex = 0;
+    for (ezUInt32 j = 0; j < i; ++j)
+    {
+      if (info.m_LogicalCPUs[j].m_uiPhysicalCore == uiCore)
+        ++cpu.m_uiSMTIndex;
+    }
+
+    cpu.m_uiPhysicalCore = static_cast<ezUInt16>(uiCore);
+
+    info.m_uiNumPackages = ezMath::Max<ezUInt32>(info.m_uiNumPackages, cpu.m_uiPackage + 1u);
+    info.m_uiNumNumaNodes = ezMath::Max<ezUInt32>(info.m_uiNumNumaNodes, cpu.m_uiNumaNode + 1u);
+  }
+
+  info.m_uiNumPhysicalCores = ezMath::Max(uiNumCores, 1u);
+}
+
 
 EZ_STATICLINK_FILE(Foundation, Foundation_System_Implementation_SystemInformation);
 
@@ -30,6 +30,73 @@ bool Is64BitWindows()
 #endif
 }
 
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+// Fills in the package, core and NUMA node of the logical processors of the current processor group. Returns the number of CPUs that were found.
+static ezUInt32 ReadCPUTopology(ezSystemInformation::LogicalCPU* pCPUs, ezUInt32 uiMaxCPUs)
+{
+  // this may run before the allocators are set up, so use a fixed size buffer
+  SYSTEM_LOGICAL_PROCESSOR_INFORMATION infos[256];
+  DWORD uiBufferSize = sizeof(infos);
+
+  if (!GetLogicalProcessorInformation(infos, &uiBufferSize))
+    return 0;
+
+  const ezUInt32 uiNumInfos = uiBufferSize / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+
+  const ezUInt32 uiNumCPUs = ezMath::Min<ezUInt32>(uiMaxCPUs, sizeof(ULONG_PTR) * 8);
+
+  for (ezUInt32 i = 0; i < uiNumCPUs; ++i)
+  {
+    pCPUs[i].m_uiCPUIndex = static_cast<ezUInt16>(i);
+    pCPUs[i].m_uiPhysicalCore = static_cast<ezUInt16>(i);
+    pCPUs[i].m_uiSMTIndex = 0;
+    pCPUs[i].m_uiPackage = 0;
+    pCPUs[i].m_uiNumaNode = 0;
+  }
+
+  ezUInt32 uiNumActiveCPUs = 0;
+  ezUInt16 uiCore = 0;
+  ezUInt8 uiPackage = 0;
+
+  for (ezUInt32 uiInfo = 0; uiInfo < uiNumInfos; ++uiInfo)
+  {
+    const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info = infos[uiInfo];
+
+    for (ezUInt32 i = 0; i < uiNumCPUs; ++i)
+    {
+      if ((info.ProcessorMask & (static_cast<ULONG_PTR>(1) << i)) == 0)
+        continue;
+
+      switch (info.Relationship)
+      {
+        case RelationProcessorCore:
+          pCPUs[i].m_uiPhysicalCore = uiCore;
+          uiNumActiveCPUs = ezMath::Max(uiNumActiveCPUs, i + 1);
+          break;
+
+        case RelationProcessorPackage:
+          pCPUs[i].m_uiPackage = uiPackage;
+          break;
+
+        case RelationNumaNode:
+          pCPUs[i].m_uiNumaNode = static_cast<ezUInt8>(info.NumaNode.NodeNumber);
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    if (info.Relationship == RelationProcessorCore)
+      ++uiCore;
+    else if (info.Relationship == RelationProcessorPackage)
+      ++uiPackage;
+  }
+
+  return uiNumActiveCPUs;
+}
+#endif
+
 /// \endcond
 
 bool ezSystemInformation::IsDebuggerAttached()
@@ -109,6 +176,16 @@ void ezSystemInformation::Initialize()
   GetComputerNameA(s_SystemInformation.m_sHostName, &bufCharCount);
 #endif
 
+  InitializeDefaultCPUTopology();
+
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+  if (const ezUInt32 uiNumCPUs = ReadCPUTopology(s_SystemInformation.m_LogicalCPUs, MaxLogicalCPUs))
+  {
+    s_SystemInformation.m_uiNumLogicalCPUs = uiNumCPUs;
+    FinalizeCPUTopology();
+  }
+#endif
+
   s_SystemInformation.m_bIsInitialized = true;
 }
 
@@ -121,6 +198,14 @@ ezUInt64 ezSystemInformation::GetAvailableMainMemory() const
   return statex.ullAvailPhys;
 }
 
+ezInt32 ezSystemInformation::GetNumaNodeOfAddress(const void* pAddress) const
+{
+  if (m_uiNumNumaNodes <= 1)
+    return 0;
+
+  return -1;
+}
+
 float ezSystemInformation::GetCPUUtilization() const
 {
 #if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
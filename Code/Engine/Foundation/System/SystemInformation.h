@@ -31,6 +31,44 @@ public:
 
   inline const char* GetBuildConfiguration() const { return m_szBuildConfiguration; }
 
+  /// \name CPU Topology
+  ///@{
+
+  static constexpr ezUInt32 MaxLogicalCPUs = 256;
+  static constexpr ezUInt32 MaxNumaNodes = 16;
+
+  /// \brief Describes where a logical CPU (hardware thread) is located in the system.
+  struct LogicalCPU
+  {
+    ezUInt16 m_uiCPUIndex;     ///< The index that the OS uses for this CPU, e.g. for thread affinities.
+    ezUInt16 m_uiPhysicalCore; ///< Logical CPUs that share the same physical core (SMT siblings) have the same value, range [0; GetPhysicalCPUCoreCount()[
+    ezUInt8 m_uiSMTIndex;      ///< 0 for the first logical CPU of a physical core, 1 for its first sibling, and so on.
+    ezUInt8 m_uiPackage;       ///< The physical CPU package (socket).
+    ezUInt8 m_uiNumaNode;      ///< The NUMA node that the CPU belongs to, range [0; GetNumaNodeCount()[
+  };
+
+  /// \brief Returns the number of logical CPUs for which topology information is available. Typically the same as GetCPUCoreCount().
+  inline ezUInt32 GetLogicalCPUCount() const { return m_uiNumLogicalCPUs; }
+
+  /// \brief Returns the topology information of the logical CPU with the given index, range [0; GetLogicalCPUCount()[
+  inline const LogicalCPU& GetLogicalCPU(ezUInt32 uiIndex) const { return m_LogicalCPUs[uiIndex]; }
+
+  /// \brief Returns the number of physical cores. Smaller than the number of logical CPUs when the CPU supports SMT (hyper-threading).
+  inline ezUInt32 GetPhysicalCPUCoreCount() const { return m_uiNumPhysicalCores; }
+
+  /// \brief Returns the number of physical CPU packages (sockets).
+  inline ezUInt32 GetCPUPackageCount() const { return m_uiNumPackages; }
+
+  /// \brief Returns the number of NUMA nodes. This is 1 on systems with uniform memory access or when the topology is unknown.
+  inline ezUInt32 GetNumaNodeCount() const { return m_uiNumNumaNodes; }
+
+  /// \brief Returns the NUMA node whose memory holds the given address, or -1 if that is unknown.
+  ///
+  /// The memory page has to be touched (committed) already. Only implemented on Linux.
+  ezInt32 GetNumaNodeOfAddress(const void* pAddress) const;
+
+  ///@}
+
 public:
   /// \brief Returns whether a debugger is currently attached to this process.
   static bool IsDebuggerAttached();
@@ -54,9 +92,20 @@ private:
   bool m_b64BitOS;
   bool m_bIsInitialized;
 
+  ezUInt32 m_uiNumLogicalCPUs;
+  ezUInt32 m_uiNumPhysicalCores;
+  ezUInt32 m_uiNumPackages;
+  ezUInt32 m_uiNumNumaNodes;
+  LogicalCPU m_LogicalCPUs[MaxLogicalCPUs];
 
   static void Initialize();
 
+  /// \brief Sets up a topology where every logical CPU is a separate core on a single package and NUMA node.
+  static void InitializeDefaultCPUTopology();
+
+  /// \brief Computes the dense physical core indices, SMT indices and the counts from the raw topology data.
+  static void FinalizeCPUTopology();
+
   static ezSystemInformation s_SystemInformation;
 };
 
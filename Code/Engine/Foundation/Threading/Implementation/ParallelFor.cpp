@@ -1,5 +1,6 @@
 #include <FoundationPCH.h>
 
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 /// \brief This is a helper class that splits up task items via index ranges.
@@ -36,6 +37,137 @@ private:
   ezParallelForIndexedFunction m_TaskCallback;
 };
 
+/// \brief Helper class for ezParallelForPartitioning::Adaptive.
+///
+/// Every invocation owns one range of items, which is stored as begin and end index in a single atomic.
+/// The owner takes chunks from the front of its range, once it runs out of items it splits off the back half
+/// of the largest remaining range of any other invocation. Ranges are thus only split when some invocation would
+/// otherwise be idle, and an invocation that starts late (or is slowed down by expensive items) gets relieved of its work.
+class AdaptiveRangeTask final : public ezTask
+{
+public:
+  AdaptiveRangeTask(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezUInt32 uiNumRanges, ezUInt32 uiMinChunkSize, ezParallelForRangeFunction taskCallback)
+    : m_uiMinChunkSize(ezMath::Max(uiMinChunkSize, 1u))
+    , m_TaskCallback(std::move(taskCallback))
+  {
+    m_Ranges.SetCount(uiNumRanges);
+
+    for (ezUInt32 i = 0; i < uiNumRanges; ++i)
+    {
+      const ezUInt32 uiBegin = uiStartIndex + static_cast<ezUInt32>((static_cast<ezUInt64>(uiNumItems) * i) / uiNumRanges);
+      const ezUInt32 uiEnd = uiStartIndex + static_cast<ezUInt32>((static_cast<ezUInt64>(uiNumItems) * (i + 1)) / uiNumRanges);
+      m_Ranges[i] = PackRange(uiBegin, uiEnd);
+    }
+
+    // cheap items are taken in larger chunks as long as nobody is idle, but never so large that the tail of a range can't be balanced anymore
+    m_uiMaxChunkSize = ezMath::Max(m_uiMinChunkSize, uiNumItems / (uiNumRanges * 8));
+  }
+
+  void Execute() override { ExecuteWithMultiplicity(0); }
+
+  void ExecuteWithMultiplicity(ezUInt32 uiRange) const override
+  {
+    ezUInt32 uiChunkSize = m_uiMinChunkSize;
+    ezUInt32 uiBegin, uiEnd;
+
+    while (true)
+    {
+      while (TakeChunk(uiRange, uiChunkSize, uiBegin, uiEnd))
+      {
+        m_TaskCallback(uiRange, uiBegin, uiEnd);
+
+        if (m_iNumIdleRanges > 0)
+          uiChunkSize = m_uiMinChunkSize;
+        else
+          uiChunkSize = ezMath::Min(uiChunkSize * 2, m_uiMaxChunkSize);
+      }
+
+      if (!StealHalfRange(uiRange))
+        return;
+    }
+  }
+
+private:
+  static ezInt64 PackRange(ezUInt32 uiBegin, ezUInt32 uiEnd) { return static_cast<ezInt64>((static_cast<ezUInt64>(uiEnd) << 32) | uiBegin); }
+  static ezUInt32 GetBegin(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) & 0xFFFFFFFFu); }
+  static ezUInt32 GetEnd(ezInt64 iRange) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iRange) >> 32); }
+
+  bool TakeChunk(ezUInt32 uiRange, ezUInt32 uiChunkSize, ezUInt32& out_uiBegin, ezUInt32& out_uiEnd) const
+  {
+    while (true)
+    {
+      const ezInt64 iRange = m_Ranges[uiRange];
+      const ezUInt32 uiBegin = GetBegin(iRange);
+      const ezUInt32 uiEnd = GetEnd(iRange);
+
+      if (uiBegin >= uiEnd)
+        return false;
+
+      const ezUInt32 uiNewBegin = uiBegin + ezMath::Min(uiChunkSize, uiEnd - uiBegin);
+
+      // other invocations may have split off the back half in the mean time
+      if (m_Ranges[uiRange].CompareAndSwap(iRange, PackRange(uiNewBegin, uiEnd)) == iRange)
+      {
+        out_uiBegin = uiBegin;
+        out_uiEnd = uiNewBegin;
+        return true;
+      }
+    }
+  }
+
+  bool StealHalfRange(ezUInt32 uiRange) const
+  {
+    m_iNumIdleRanges.Increment();
+
+    bool bStolen = false;
+
+    while (!bStolen)
+    {
+      ezUInt32 uiVictim = ezInvalidIndex;
+      ezUInt32 uiMaxRemaining = m_uiMinChunkSize;
+      ezInt64 iVictimRange = 0;
+
+      for (ezUInt32 i = 0; i < m_Ranges.GetCount(); ++i)
+      {
+        const ezInt64 iRange = m_Ranges[i];
+        const ezUInt32 uiBegin = GetBegin(iRange);
+        const ezUInt32 uiEnd = GetEnd(iRange);
+
+        // not worth splitting, the owner will be done with it soon enough
+        if (uiBegin < uiEnd && uiEnd - uiBegin > uiMaxRemaining)
+        {
+          uiVictim = i;
+          uiMaxRemaining = uiEnd - uiBegin;
+          iVictimRange = iRange;
+        }
+      }
+
+      if (uiVictim == ezInvalidIndex)
+        break;
+
+      const ezUInt32 uiBegin = GetBegin(iVictimRange);
+      const ezUInt32 uiEnd = GetEnd(iVictimRange);
+      const ezUInt32 uiMiddle = uiBegin + (uiEnd - uiBegin + 1) / 2;
+
+      if (m_Ranges[uiVictim].CompareAndSwap(iVictimRange, PackRange(uiBegin, uiMiddle)) == iVictimRange)
+      {
+        // our own range is empty, so nobody else modifies it
+        m_Ranges[uiRange] = PackRange(uiMiddle, uiEnd);
+        bStolen = true;
+      }
+    }
+
+    m_iNumIdleRanges.Decrement();
+    return bStolen;
+  }
+
+  ezUInt32 m_uiMinChunkSize;
+  ezUInt32 m_uiMaxChunkSize;
+  mutable ezHybridArray<ezAtomicInteger64, 32> m_Ranges;
+  mutable ezAtomicInteger32 m_iNumIdleRanges;
+  ezParallelForRangeFunction m_TaskCallback;
+};
+
 ezUInt32 ezParallelForParams::DetermineMultiplicity(ezUInt32 uiNumTaskItems) const
 {
   // If we have not exceeded the threading threshold we will indicate to use serial execution.
@@ -82,13 +214,55 @@ ezUInt32 ezParallelForParams::DetermineItemsPerInvocation(ezUInt32 uiNumTaskItem
   return uiItemsPerInvocation;
 }
 
+ezUInt32 ezParallelForParams::DetermineNumAdaptiveRanges(ezUInt32 uiNumTaskItems) const
+{
+  // If we have not exceeded the threading threshold we will indicate to use serial execution.
+  if (uiNumTaskItems < uiBinSize || uiNumTaskItems == 0)
+  {
+    return 0;
+  }
+
+  // One range for every worker plus the thread that waits for the result, which helps out in the mean time.
+  // More are not needed, as ranges get split on demand.
+  const ezUInt32 uiNumWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiMaxRanges = (uiNumTaskItems + ezMath::Max(uiBinSize, 1u) - 1) / ezMath::Max(uiBinSize, 1u);
+
+  return ezMath::Clamp(uiNumWorkers + 1, 1u, uiMaxRanges);
+}
+
+void ezTaskSystem::ParallelForAdaptive(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezUInt32 uiNumRanges, ezParallelForRangeFunction taskCallback, const char* taskName, const ezParallelForParams& params)
+{
+  AdaptiveRangeTask adaptiveTask(uiStartIndex, uiNumItems, ezMath::Max(uiNumRanges, 1u), params.uiBinSize, std::move(taskCallback));
+  adaptiveTask.ConfigureTask(taskName ? taskName : "Generic Adaptive Task", params.nestingMode);
+
+  if (uiNumRanges <= 1)
+  {
+    EZ_PROFILE_SCOPE(adaptiveTask.m_sTaskName);
+    adaptiveTask.Execute();
+  }
+  else
+  {
+    adaptiveTask.SetMultiplicity(uiNumRanges);
+    ezTaskGroupID taskGroupId = ezTaskSystem::StartSingleTask(&adaptiveTask, ezTaskPriority::EarlyThisFrame);
+    ezTaskSystem::WaitForGroup(taskGroupId);
+  }
+}
+
 void ezTaskSystem::ParallelForIndexed(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezParallelForIndexedFunction taskCallback, const char* taskName, const ezParallelForParams& params)
 {
+  if (params.partitioning == ezParallelForPartitioning::Adaptive)
+  {
+    auto rangeCallback = [&taskCallback](ezUInt32 /*uiRange*/, ezUInt32 uiBegin, ezUInt32 uiEnd) { taskCallback(uiBegin, uiEnd); };
+
+    ParallelForAdaptive(uiStartIndex, uiNumItems, params.DetermineNumAdaptiveRanges(uiNumItems), rangeCallback, taskName ? taskName : "Generic Indexed Task", params);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = params.DetermineMultiplicity(uiNumItems);
   const ezUInt32 uiItemsPerInvocation = params.DetermineItemsPerInvocation(uiNumItems, uiMultiplicity);
 
   IndexedTask indexedTask(uiStartIndex, uiNumItems, std::move(taskCallback), uiItemsPerInvocation);
-  indexedTask.ConfigureTask(taskName ? taskName : "Generic Indexed Task", ezTaskNesting::Never);
+  indexedTask.ConfigureTask(taskName ? taskName : "Generic Indexed Task", params.nestingMode);
 
   if (uiMultiplicity == 0)
   {
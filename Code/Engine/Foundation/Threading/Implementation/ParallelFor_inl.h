@@ -1,15 +1,18 @@
 #pragma once
 
+#include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/System/SystemInformation.h>
 
 template <typename ElemType>
 class ArrayPtrTask final : public ezTask
 {
 public:
-  ArrayPtrTask(ezArrayPtr<ElemType> payload, ezParallelForFunction<ElemType> taskCallback, ezUInt32 uiItemsPerInvocation)
+  ArrayPtrTask(ezArrayPtr<ElemType> payload, ezParallelForFunction<ElemType> taskCallback, ezUInt32 uiItemsPerInvocation, bool bPreferNumaNodeOfData)
     : m_Payload(payload)
     , m_uiItemsPerInvocation(uiItemsPerInvocation)
+    , m_bPreferNumaNodeOfData(bPreferNumaNodeOfData)
     , m_TaskCallback(std::move(taskCallback))
   {
   }
@@ -35,19 +38,40 @@ public:
     }
   }
 
+  ezInt32 GetPreferredNumaNode(ezUInt32 uiInvocation) const override
+  {
+    const ezUInt32 uiSliceStartIndex = uiInvocation * m_uiItemsPerInvocation;
+
+    if (!m_bPreferNumaNodeOfData || uiSliceStartIndex >= m_Payload.GetCount())
+      return ezTask::GetPreferredNumaNode(uiInvocation);
+
+    return ezSystemInformation::Get().GetNumaNodeOfAddress(m_Payload.GetPtr() + uiSliceStartIndex);
+  }
+
 private:
   ezArrayPtr<ElemType> m_Payload;
   ezUInt32 m_uiItemsPerInvocation;
+  bool m_bPreferNumaNodeOfData;
   ezParallelForFunction<ElemType> m_TaskCallback;
 };
 
 template <typename ElemType>
 void ezTaskSystem::ParallelForInternal(ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config)
 {
+  if (config.partitioning == ezParallelForPartitioning::Adaptive)
+  {
+    auto rangeCallback = [taskItems, &taskCallback](ezUInt32 /*uiRange*/, ezUInt32 uiBegin, ezUInt32 uiEnd) {
+      taskCallback(uiBegin, taskItems.GetSubArray(uiBegin, uiEnd - uiBegin));
+    };
+
+    ParallelForAdaptive(0, taskItems.GetCount(), config.DetermineNumAdaptiveRanges(taskItems.GetCount()), rangeCallback, taskName ? taskName : "Generic ArrayPtr Task", config);
+    return;
+  }
+
   const ezUInt32 uiMultiplicity = config.DetermineMultiplicity(taskItems.GetCount());
   const ezUInt32 uiItemsPerInvocation = config.DetermineItemsPerInvocation(taskItems.GetCount(), uiMultiplicity);
 
-  ArrayPtrTask<ElemType> arrayPtrTask(taskItems, std::move(taskCallback), uiItemsPerInvocation);
+  ArrayPtrTask<ElemType> arrayPtrTask(taskItems, std::move(taskCallback), uiItemsPerInvocation, config.bPreferNumaNodeOfData);
   arrayPtrTask.ConfigureTask(taskName ? taskName : "Generic ArrayPtr Task", config.nestingMode);
 
   if (uiMultiplicity == 0)
@@ -100,3 +124,108 @@ void ezTaskSystem::ParallelForSingleIndex(ezArrayPtr<ElemType> taskItems, Callba
 
   ParallelForInternal<ElemType>(taskItems, ezParallelForFunction<ElemType>(std::move(wrappedCallback), ezFrameAllocator::GetCurrentAllocator()), taskName, params);
 }
+
+template <typename ResultType, typename ElemType, typename RangeCallback, typename CombineCallback>
+ResultType ezTaskSystem::ParallelReduce(ezArrayPtr<ElemType> taskItems, const ResultType& identity, RangeCallback rangeCallback, CombineCallback combineCallback, const char* taskName, const ezParallelForParams& params)
+{
+  const ezUInt32 uiNumRanges = params.DetermineNumAdaptiveRanges(taskItems.GetCount());
+
+  // one partial result per range, items of the same range are never processed concurrently
+  ezHybridArray<ResultType, 32> partialResults;
+  partialResults.SetCount(ezMath::Max(uiNumRanges, 1u), identity);
+
+  auto wrappedCallback = [taskItems, &partialResults, &rangeCallback](ezUInt32 uiRange, ezUInt32 uiBegin, ezUInt32 uiEnd) {
+    // accumulate into a local copy, to not write to memory that is shared with other threads for every item
+    ResultType result = partialResults[uiRange];
+    rangeCallback(taskItems.GetSubArray(uiBegin, uiEnd - uiBegin), result);
+    partialResults[uiRange] = result;
+  };
+
+  ParallelForAdaptive(0, taskItems.GetCount(), uiNumRanges, ezParallelForRangeFunction(std::move(wrappedCallback), ezFrameAllocator::GetCurrentAllocator()), taskName ? taskName : "Generic Reduce Task", params);
+
+  // every partial result already starts out as 'identity', so it must not be combined in once more
+  ResultType result = partialResults[0];
+  for (ezUInt32 i = 1; i < partialResults.GetCount(); ++i)
+  {
+    result = combineCallback(result, partialResults[i]);
+  }
+
+  return result;
+}
+
+template <typename ElemType, typename InputType, typename CombineCallback>
+void ezTaskSystem::ParallelPrefixSum(ezArrayPtr<InputType> input, ezArrayPtr<ElemType> out_Result, const typename ezArrayPtr<ElemType>::ValueType& identity, CombineCallback combineCallback, const char* taskName, const ezParallelForParams& params)
+{
+  EZ_ASSERT_DEV(input.GetCount() == out_Result.GetCount(), "Input and output of a prefix sum must have the same size ({} != {})", input.GetCount(), out_Result.GetCount());
+
+  const ezUInt32 uiNumItems = input.GetCount();
+  const ezUInt32 uiNumRanges = params.DetermineNumAdaptiveRanges(uiNumItems);
+
+  if (uiNumRanges <= 1)
+  {
+    EZ_PROFILE_SCOPE(taskName ? taskName : "Generic Prefix Sum Task");
+
+    ElemType sum = identity;
+    for (ezUInt32 i = 0; i < uiNumItems; ++i)
+    {
+      sum = combineCallback(sum, input[i]);
+      out_Result[i] = sum;
+    }
+
+    return;
+  }
+
+  // The items are split into fixed blocks, so that the blocks can be summed up independently. The first pass computes the sum of every block,
+  // the second pass then computes the prefix sum of each block, starting with the sum of all previous blocks.
+  // There are several blocks per range, so that the adaptive partitioning can still balance the work.
+  const ezUInt32 uiNumBlocks = ezMath::Min(uiNumRanges * 4, (uiNumItems + ezMath::Max(params.uiBinSize, 1u) - 1) / ezMath::Max(params.uiBinSize, 1u));
+  const ezUInt32 uiItemsPerBlock = (uiNumItems + uiNumBlocks - 1) / uiNumBlocks;
+
+  ezHybridArray<ElemType, 128> blockSums;
+  blockSums.SetCount(uiNumBlocks, identity);
+
+  ezParallelForParams blockParams = params;
+  blockParams.uiBinSize = 1;
+
+  auto sumBlocks = [&](ezUInt32 /*uiRange*/, ezUInt32 uiBeginBlock, ezUInt32 uiEndBlock) {
+    for (ezUInt32 block = uiBeginBlock; block < uiEndBlock; ++block)
+    {
+      const ezUInt32 uiEnd = ezMath::Min(uiNumItems, (block + 1) * uiItemsPerBlock);
+
+      ElemType sum = identity;
+      for (ezUInt32 i = block * uiItemsPerBlock; i < uiEnd; ++i)
+      {
+        sum = combineCallback(sum, input[i]);
+      }
+
+      blockSums[block] = sum;
+    }
+  };
+
+  ParallelForAdaptive(0, uiNumBlocks, blockParams.DetermineNumAdaptiveRanges(uiNumBlocks), ezParallelForRangeFunction(std::move(sumBlocks), ezFrameAllocator::GetCurrentAllocator()), taskName ? taskName : "Generic Prefix Sum Task", blockParams);
+
+  // turn the block sums into the sum of all previous blocks
+  ElemType offset = identity;
+  for (ezUInt32 block = 0; block < uiNumBlocks; ++block)
+  {
+    const ElemType blockSum = blockSums[block];
+    blockSums[block] = offset;
+    offset = combineCallback(offset, blockSum);
+  }
+
+  auto scanBlocks = [&](ezUInt32 /*uiRange*/, ezUInt32 uiBeginBlock, ezUInt32 uiEndBlock) {
+    for (ezUInt32 block = uiBeginBlock; block < uiEndBlock; ++block)
+    {
+      const ezUInt32 uiEnd = ezMath::Min(uiNumItems, (block + 1) * uiItemsPerBlock);
+
+      ElemType sum = blockSums[block];
+      for (ezUInt32 i = block * uiItemsPerBlock; i < uiEnd; ++i)
+      {
+        sum = combineCallback(sum, input[i]);
+        out_Result[i] = sum;
+      }
+    }
+  };
+
+  ParallelForAdaptive(0, uiNumBlocks, blockParams.DetermineNumAdaptiveRanges(uiNumBlocks), ezParallelForRangeFunction(std::move(scanBlocks), ezFrameAllocator::GetCurrentAllocator()), taskName ? taskName : "Generic Prefix Sum Task", blockParams);
+}
@@ -0,0 +1,72 @@
+#include <Foundation/FoundationInternal.h>
+EZ_FOUNDATION_INTERNAL_HEADER
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+struct ezTaskFiberData
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ucontext_t m_Context;
+  ucontext_t m_ResumedFrom;
+};
+
+bool ezTaskFiber::IsSupported()
+{
+  return true;
+}
+
+ezTaskFiber::ezTaskFiber(EntryFunction entry, ezUInt32 uiStackSize)
+  : m_Entry(entry)
+{
+  // the stack grows downwards, so the page below it is made inaccessible to catch overflows
+  const ezUInt32 uiPageSize = static_cast<ezUInt32>(sysconf(_SC_PAGESIZE));
+  uiStackSize = ezMemoryUtils::AlignSize(uiStackSize, uiPageSize);
+
+  void* pMemory = mmap(nullptr, uiPageSize + uiStackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  EZ_ASSERT_ALWAYS(pMemory != MAP_FAILED, "Failed to allocate the stack of a task fiber.");
+  EZ_VERIFY(mprotect(pMemory, uiPageSize, PROT_NONE) == 0, "Failed to protect the guard page of a task fiber.");
+
+  m_Stack = ezArrayPtr<ezUInt8>(static_cast<ezUInt8*>(pMemory) + uiPageSize, uiStackSize);
+  m_pData = EZ_DEFAULT_NEW(ezTaskFiberData);
+
+  EZ_VERIFY(getcontext(&m_pData->m_Context) == 0, "getcontext failed");
+
+  m_pData->m_Context.uc_stack.ss_sp = m_Stack.GetPtr();
+  m_pData->m_Context.uc_stack.ss_size = m_Stack.GetCount();
+  m_pData->m_Context.uc_link = nullptr;
+
+  // makecontext only passes int arguments, so the pointer has to be split up
+  const ezUInt64 uiFiberPtr = reinterpret_cast<ezUInt64>(this);
+  makecontext(&m_pData->m_Context, reinterpret_cast<void (*)()>(&ezTaskFiber::Trampoline), 2, static_cast<int>(uiFiberPtr & 0xFFFFFFFF), static_cast<int>(uiFiberPtr >> 32));
+}
+
+ezTaskFiber::~ezTaskFiber()
+{
+  EZ_DEFAULT_DELETE(m_pData);
+
+  const ezUInt32 uiPageSize = static_cast<ezUInt32>(sysconf(_SC_PAGESIZE));
+  munmap(m_Stack.GetPtr() - uiPageSize, uiPageSize + m_Stack.GetCount());
+}
+
+void ezTaskFiber::Trampoline(int iFiberPtrLow, int iFiberPtrHigh)
+{
+  const ezUInt64 uiFiberPtr = (static_cast<ezUInt64>(static_cast<ezUInt32>(iFiberPtrHigh)) << 32) | static_cast<ezUInt32>(iFiberPtrLow);
+  ezTaskFiber* pFiber = reinterpret_cast<ezTaskFiber*>(uiFiberPtr);
+
+  pFiber->m_Entry(pFiber);
+
+  EZ_REPORT_FAILURE("The entry function of a task fiber must never return.");
+}
+
+void ezTaskFiber::Resume()
+{
+  swapcontext(&m_pData->m_ResumedFrom, &m_pData->m_Context);
+}
+
+void ezTaskFiber::Suspend()
+{
+  swapcontext(&m_pData->m_Context, &m_pData->m_ResumedFrom);
+}
@@ -8,6 +8,7 @@
 // Posix implementation of thread helper functions
 
 #include <pthread.h>
+#include <sched.h>
 
 static pthread_t g_MainThread = (pthread_t)0;
 
@@ -49,3 +50,29 @@ bool ezThreadUtils::IsMainThread()
   return pthread_self() == g_MainThread;
 }
 
+ezResult ezThreadUtils::SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalCPUs)
+{
+#if EZ_ENABLED(EZ_PLATFORM_LINUX) || EZ_ENABLED(EZ_PLATFORM_ANDROID)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+
+  for (ezUInt32 uiCPU : logicalCPUs)
+  {
+    if (uiCPU < CPU_SETSIZE)
+      CPU_SET(uiCPU, &cpuSet);
+  }
+
+  if (CPU_COUNT(&cpuSet) == 0)
+  {
+    for (ezUInt32 uiCPU = 0; uiCPU < CPU_SETSIZE; ++uiCPU)
+      CPU_SET(uiCPU, &cpuSet);
+  }
+
+  // on Linux a pid of zero refers to the calling thread, not the whole process
+  return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0 ? EZ_SUCCESS : EZ_FAILURE;
+#else
+  // OSX only supports affinity hints between threads, not binding to specific CPUs
+  return EZ_FAILURE;
+#endif
+}
+
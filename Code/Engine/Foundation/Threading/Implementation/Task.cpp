@@ -9,6 +9,7 @@ ezTask::~ezTask() = default;
 void ezTask::Reset()
 {
   m_iRemainingRuns = (int)ezMath::Max(1u, m_uiMultiplicity);
+  m_iStartedRuns = 0;
   m_bCancelExecution = false;
   m_bTaskIsScheduled = false;
   m_bUsesMultiplicity = m_uiMultiplicity > 0;
@@ -31,6 +32,24 @@ void ezTask::SetMultiplicity(ezUInt32 uiMultiplicity)
 
 void ezTask::Run(ezUInt32 uiInvocation)
 {
+  // claim the invocation, unless CancelTask() prevented the task from starting while it was still in a worker's deque
+  ezInt32 iStartedRuns = m_iStartedRuns;
+  while (iStartedRuns >= 0)
+  {
+    const ezInt32 iPrevStartedRuns = m_iStartedRuns.CompareAndSwap(iStartedRuns, iStartedRuns + 1);
+    if (iPrevStartedRuns == iStartedRuns)
+      break;
+
+    iStartedRuns = iPrevStartedRuns;
+  }
+
+  if (iStartedRuns < 0)
+  {
+    // every scheduled invocation still ends up here once, the last one marks the task as finished
+    m_iRemainingRuns.Decrement();
+    return;
+  }
+
   // actually this should not be possible to happen
   if (m_iRemainingRuns == 0 || m_bCancelExecution)
   {
@@ -56,7 +56,20 @@ public:
   /// \brief Can be used inside an overridden 'Execute' function to terminate execution prematurely.
   bool HasBeenCanceled() const { return m_bCancelExecution; } // [tested]
 
+  /// \brief Sets the NUMA node whose worker threads should preferably execute this task. -1 means no preference.
+  ///
+  /// This is only a hint and is ignored unless ezTaskSystem::SetUseNumaNodeQueues() is enabled.
+  /// Typically this is the node that holds the data that the task works on, see ezSystemInformation::GetNumaNodeOfAddress().
+  void SetPreferredNumaNode(ezInt32 iNode) { m_iPreferredNumaNode = static_cast<ezInt8>(iNode); }
+
 protected:
+  /// \brief Returns the NUMA node that the given invocation prefers to run on, or -1.
+  ///
+  /// By default this returns the value that was set through SetPreferredNumaNode(). Tasks with multiplicity may override this,
+  /// to have every invocation prefer the node of the data that it works on.
+  /// Only called when the task gets scheduled and ezTaskSystem::SetUseNumaNodeQueues() is enabled.
+  virtual ezInt32 GetPreferredNumaNode(ezUInt32 uiInvocation) const { return m_iPreferredNumaNode; }
+
   /// \brief Override this to implement the task's supposed functionality.
   ///
   /// This function is called for tasks that do not use multiplicity.
@@ -87,6 +100,9 @@ private:
   /// \brief Decremented when a task is finished, set to zero when canceled.
   ezAtomicInteger32 m_iRemainingRuns;
 
+  /// \brief Number of invocations that started executing. Set to -1 by CancelTask(), if it got there before the first invocation.
+  ezAtomicInteger32 m_iStartedRuns;
+
   /// \brief Set to true when the task is SUPPOSED to cancel. Whether the task is able to do that, depends on its implementation.
   bool m_bCancelExecution = false;
 
@@ -101,6 +117,9 @@ private:
   /// \brief Whether this task may wait (indirectly) on other tasks. See ezTaskNesting.
   ezTaskNesting m_NestingMode = ezTaskNesting::Maybe;
 
+  /// \brief See SetPreferredNumaNode().
+  ezInt8 m_iPreferredNumaNode = -1;
+
   /// \brief Optional callback to be fired when the task has finished or was canceled.
   ezOnTaskFinishedCallback m_OnTaskFinished;
 
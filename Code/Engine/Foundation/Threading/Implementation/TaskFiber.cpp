@@ -0,0 +1,42 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskFiber.h>
+
+// Fibers are only implemented through ucontext on Linux. OSX has deprecated ucontext and Android does not provide it.
+#if EZ_ENABLED(EZ_PLATFORM_LINUX)
+#  include <Foundation/Threading/Implementation/Posix/TaskFiber_posix.h>
+#else
+
+struct ezTaskFiberData
+{
+};
+
+bool ezTaskFiber::IsSupported()
+{
+  return false;
+}
+
+ezTaskFiber::ezTaskFiber(EntryFunction entry, ezUInt32 uiStackSize)
+  : m_Entry(entry)
+{
+  EZ_REPORT_FAILURE("Task fibers are not supported on this platform.");
+}
+
+ezTaskFiber::~ezTaskFiber() = default;
+
+void ezTaskFiber::Trampoline(int iFiberPtrLow, int iFiberPtrHigh) {}
+
+void ezTaskFiber::Resume()
+{
+  EZ_REPORT_FAILURE("Task fibers are not supported on this platform.");
+}
+
+void ezTaskFiber::Suspend()
+{
+  EZ_REPORT_FAILURE("Task fibers are not supported on this platform.");
+}
+
+#endif
+
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskFiber);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Foundation/Threading/TaskSystem.h>
+
+struct ezTaskFiberData;
+
+/// \internal A cooperatively scheduled execution context with its own stack, used for ezTaskWaitMode::SuspendOnFibers.
+///
+/// A worker thread enters the fiber through Resume(). The fiber runs until it calls Suspend(), which makes Resume() return.
+/// The task system always continues a suspended fiber on the worker thread that suspended it, see m_pWorkerThread.
+class ezTaskFiber
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskFiber);
+
+public:
+  using EntryFunction = void (*)(ezTaskFiber* pFiber);
+
+  /// \brief Allocates the stack and prepares the fiber to call \a entry on the first Resume(). \a entry must never return.
+  ///
+  /// Where supported, the stack is followed by a guard page, so that a stack overflow crashes right away instead of corrupting memory.
+  ezTaskFiber(EntryFunction entry, ezUInt32 uiStackSize);
+  ~ezTaskFiber();
+
+  /// \brief Returns whether fibers are implemented on this platform.
+  static bool IsSupported();
+
+  /// \brief Switches from the calling thread into the fiber. Returns once the fiber calls Suspend().
+  void Resume();
+
+  /// \brief Must be called from inside the fiber. Switches back to the thread that called Resume().
+  void Suspend();
+
+  enum class State : ezUInt8
+  {
+    Idle,     ///< In the pool of unused fibers.
+    Running,  ///< Currently executing a task.
+    Waiting,  ///< Suspended until m_WaitingForGroup has finished.
+    Finished, ///< The task has finished, the fiber can be put back into the pool.
+  };
+
+  State m_State = State::Idle;
+
+  /// The worker thread that picked up the task. Only this thread may continue the fiber, otherwise ezMutex ownership
+  /// and thread local state would change underneath the task, when it waits for a group while holding them.
+  ezTaskWorkerThread* m_pWorkerThread = nullptr;
+
+  /// The task that is executed on this fiber.
+  ezTaskSystem::TaskData m_Task;
+
+  /// The group that the fiber waits for, while in the 'Waiting' state.
+  ezTaskGroupID m_WaitingForGroup;
+
+  /// Links the fibers that wait for the same task group, see ezTaskGroup::m_pWaitingFibers.
+  ezTaskFiber* m_pNextWaitingFiber = nullptr;
+
+private:
+  static void Trampoline(int iFiberPtrLow, int iFiberPtrHigh);
+
+  EntryFunction m_Entry = nullptr;
+  ezArrayPtr<ezUInt8> m_Stack;
+  ezTaskFiberData* m_pData = nullptr;
+};
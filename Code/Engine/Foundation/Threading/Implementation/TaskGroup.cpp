@@ -26,7 +26,8 @@ void ezTaskGroup::Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCall
   m_uiGroupCounter += 2; // even if it wraps around, it will never be zero, thus zero stays an invalid group counter
   m_Tasks.Clear();
   m_DependsOnGroups.Clear();
-  m_OthersDependingOnMe.Clear();
+  m_DependencyLinks.Clear();
+  m_iOthersDependingOnMe = MakeDependentsHead(m_uiGroupCounter, s_uiNoLink);
   m_Priority = priority;
   m_OnFinishedCallback = callback;
 }
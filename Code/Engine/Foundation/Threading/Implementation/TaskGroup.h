@@ -26,16 +26,49 @@ private:
   void WaitForFinish(ezTaskGroupID group) const;
   void Reuse(ezTaskPriority::Enum priority, ezOnTaskGroupFinishedCallback callback);
 
-  bool m_bInUse = true;
+  // Links into a list of dependent groups are encoded as (group index << 16 | index into m_DependencyLinks)
+  static constexpr ezUInt32 s_uiNoLink = 0xFFFFFFFF;
+  static constexpr ezUInt32 s_uiClosedLink = 0xFFFFFFFE;
+
+  // Index of groups that were allocated on the heap, because all indices that a link can encode are taken.
+  // Such groups can't be linked into the lists of dependent groups, they are kept in m_OverflowDependents instead.
+  static constexpr ezUInt16 s_uiNoIndex = 0xFFFF;
+
+  /// \brief Packs a generation (group counter) and the first link of the list of dependent groups into one atomically modifiable value.
+  static ezInt64 MakeDependentsHead(ezUInt32 uiGeneration, ezUInt32 uiFirstLink) { return static_cast<ezInt64>((static_cast<ezUInt64>(uiGeneration) << 32) | uiFirstLink); }
+  static ezUInt32 GetHeadGeneration(ezInt64 iHead) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iHead) >> 32); }
+  static ezUInt32 GetHeadLink(ezInt64 iHead) { return static_cast<ezUInt32>(static_cast<ezUInt64>(iHead) & 0xFFFFFFFF); }
+
+  bool m_bInUse = false;
   bool m_bStartedByUser = false;
-  ezUInt16 m_uiTaskGroupIndex = 0xFFFF; // only there as a debugging aid
+  ezUInt16 m_uiTaskGroupIndex = 0xFFFF;
   ezUInt32 m_uiGroupCounter = 1;
   ezHybridArray<ezTask*, 16> m_Tasks;
   ezHybridArray<ezTaskGroupID, 4> m_DependsOnGroups;
-  ezHybridArray<ezTaskGroupID, 8> m_OthersDependingOnMe;
+
+  // One entry per dependency in m_DependsOnGroups, holding the next link in the list of groups that depend on that other group.
+  // Only written in StartTaskGroup(), so the array never reallocates while it is linked into other lists.
+  ezHybridArray<ezUInt32, 4> m_DependencyLinks;
+
+  // Lock-free list of all the groups that wait for this group to finish. The upper 32 bits store the generation (m_uiGroupCounter)
+  // the list belongs to, which prevents stale ezTaskGroupIDs from linking into the list of a reused group.
+  // Once the group is finished, the list is closed with s_uiClosedLink.
+  ezAtomicInteger64 m_iOthersDependingOnMe;
+
+  // Groups without an index that wait for this group to finish. Guarded by ezTaskSystemState::m_OverflowTaskGroupsMutex.
+  // m_bHasOverflowDependents is set before such a group checks whether the list above is still open, so that the finishing group
+  // only needs to lock the mutex, if there are any.
+  ezDynamicArray<ezTaskGroup*> m_OverflowDependents;
+  ezAtomicBool m_bHasOverflowDependents;
+
+  // index + 1 of the next group in the free list of ezTaskSystemState, zero for the end of the list
+  volatile ezUInt32 m_uiNextFreeGroup = 0;
   ezAtomicInteger32 m_iNumActiveDependencies;
   ezAtomicInteger32 m_iNumRemainingTasks;
   ezOnTaskGroupFinishedCallback m_OnFinishedCallback;
   ezTaskPriority::Enum m_Priority = ezTaskPriority::ThisFrame;
   mutable ezConditionVariable m_CondVarGroupFinished;
+
+  // Suspended fibers that wait for this group to finish, linked through ezTaskFiber::m_pNextWaitingFiber. Guarded by m_CondVarGroupFinished.
+  ezTaskFiber* m_pWaitingFibers = nullptr;
 };
@@ -43,6 +43,17 @@ void ezTaskSystem::Startup()
 void ezTaskSystem::Shutdown()
 {
   StopWorkerThreads();
+  DestroyFibers();
+
+  for (ezUInt32 i = 0; i < (ezUInt32)s_State->m_iNumTaskGroupBlocks; ++i)
+  {
+    EZ_DEFAULT_DELETE_ARRAY(s_State->m_TaskGroupBlocks[i]);
+  }
+
+  for (ezTaskGroup* pGroup : s_State->m_OverflowTaskGroups)
+  {
+    EZ_DEFAULT_DELETE(pGroup);
+  }
 
   s_State.Clear();
   s_ThreadState.Clear();
@@ -7,8 +7,10 @@
 #include <Foundation/Types/UniquePtr.h>
 
 class ezTask;
+class ezTaskFiber;
 class ezTaskGroup;
 class ezTaskWorkerThread;
+class ezTaskWorkStealingDeque;
 class ezTaskSystemState;
 class ezTaskSystemThreadState;
 class ezDGMLGraph;
@@ -23,7 +25,8 @@ class ezDGMLGraph;
 /// Once 'ezTaskSystem::FinishFrameTasks' is called, all those tasks will be moved into the 'XYZThisFrame' categories.\n
 /// For tasks that run over a longer period (e.g. path searches, procedural data creation), use 'LongRunning'.
 /// Only use 'LongRunningHighPriority' for tasks that occur rarely, otherwise 'LongRunning' tasks might not get processed, at all.\n
-/// For tasks that need to access files, prefer to use 'FileAccess', this way all file accesses get executed sequentially.\n
+/// For tasks that need to access files, prefer to use 'FileAccess', this way only a limited number of file accesses get executed
+/// concurrently (see ezTaskSystem::SetWorkerThreadCount()).\n
 /// Use 'FileAccessHighPriority' to get very important file accesses done sooner. For example writing out a save-game should finish
 /// quickly.\n For tasks that need to execute on the main thread (e.g. uploading GPU resources) use 'ThisFrameMainThread' or
 /// 'SomeFrameMainThread' depending on how urgent it is. 'SomeFrameMainThread' tasks might get delayed for quite a while, depending on the
@@ -56,10 +59,10 @@ struct ezTaskPriority
     LongRunningHighPriority,  ///< Tasks that might take a while, but should be preferred over 'LongRunning' tasks. Use this priority only
                               ///< rarely, otherwise 'LongRunning' tasks might never get executed.
     LongRunning,              ///< Use this priority for tasks that might run for a while.
-    FileAccessHighPriority,   ///< For tasks that require file access (e.g. resource loading). They run on one dedicated thread, such that
-                              ///< file accesses are done sequentially and never in parallel.
-    FileAccess,               ///< For tasks that require file access (e.g. resource loading). They run on one dedicated thread, such that file accesses
-                              ///< are done sequentially and never in parallel.
+    FileAccessHighPriority,   ///< For tasks that require file access (e.g. resource loading). They run on dedicated threads (by default
+                              ///< two to four), such that the number of concurrent file accesses is limited.
+    FileAccess,               ///< For tasks that require file access (e.g. resource loading). They run on dedicated threads (by default two to four),
+                              ///< such that the number of concurrent file accesses is limited.
     ThisFrameMainThread,      ///< Tasks that need to be executed this frame, but in the main thread. This is mostly intended for resource
                               ///< creation.
     SomeFrameMainThread,      ///< Tasks that have no hard deadline but need to be executed in the main thread. This is mostly intended for
@@ -80,6 +83,50 @@ struct ezOnTaskRunning
   };
 };
 
+/// \brief Selects how the ezTaskSystem distributes scheduled tasks to its worker threads.
+struct ezTaskSchedulerMode
+{
+  enum Enum : ezUInt8
+  {
+    SharedQueues, ///< All tasks are stored in one set of per-priority lists that are guarded by a single mutex.
+    WorkStealing, ///< Each worker thread owns lock-free per-priority deques. Idle workers steal tasks from other workers.
+                  ///< The shared lists are only used for tasks scheduled from non-worker threads and for priorities that get
+                  ///< re-prioritized at the end of each frame.
+
+    Default = SharedQueues
+  };
+};
+
+/// \brief Selects what a worker thread does while a task waits for a task group in ezTaskSystem::WaitForGroup().
+struct ezTaskWaitMode
+{
+  enum Enum : ezUInt8
+  {
+    HelpExecuting,   ///< The waiting thread executes other suitable tasks on top of its stack or goes to sleep until the group is finished.
+    SuspendOnFibers, ///< Worker threads execute each task on a fiber. A task that waits is suspended and its thread picks up other work.
+                     ///< Once the group has finished, the task is continued by any worker thread of the same type.
+                     ///< Only supported on Linux, elsewhere 'HelpExecuting' is used.
+
+    Default = HelpExecuting
+  };
+};
+
+/// \brief Selects on which logical CPUs the short and long task worker threads of the ezTaskSystem may run.
+///
+/// See ezSystemInformation for the CPU topology that these decisions are based on.
+struct ezTaskWorkerAffinity
+{
+  enum Enum : ezUInt8
+  {
+    None,         ///< The OS decides where worker threads run.
+    NumaNode,     ///< Workers are distributed round-robin across the NUMA nodes and may run on any logical CPU of their node.
+    PhysicalCore, ///< Every worker is pinned to a single logical CPU. Consecutive workers are placed on different NUMA nodes
+                  ///< and only share a physical core (SMT siblings) once every physical core has a worker.
+
+    Default = None
+  };
+};
+
 /// \internal Enum that lists the different task worker thread types.
 struct ezWorkerThreadType
 {
@@ -155,6 +202,19 @@ enum class ezTaskNesting
   Never,
 };
 
+/// \brief How ezTaskSystem::ParallelFor distributes the task items across the task invocations.
+struct ezParallelForPartitioning
+{
+  enum Enum
+  {
+    Static,   ///< The items are split into equally sized slices up front. Best when all items take about the same time.
+    Adaptive, ///< Every invocation starts with an equal range, but invocations that run out of work split off half of the remaining
+              ///< range of another one. Best when the cost per item varies a lot, as no invocation is left with a long tail of work.
+
+    Default = Static
+  };
+};
+
 /// \brief Settings for ezTaskSystem::ParallelFor invocations.
 struct EZ_FOUNDATION_DLL ezParallelForParams
 {
@@ -175,6 +235,14 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
 
   ezTaskNesting nestingMode = ezTaskNesting::Never;
 
+  /// How the items are distributed. With ezParallelForPartitioning::Adaptive, uiBinSize is the smallest number of items
+  /// that is split off at once and uiMaxTasksPerThread is ignored.
+  ezParallelForPartitioning::Enum partitioning = ezParallelForPartitioning::Default;
+
+  /// If ezTaskSystem::SetUseNumaNodeQueues() is enabled, every chunk of items prefers to be processed by a worker
+  /// on the NUMA node whose memory holds the items. Only used by the ParallelFor variants that take an array of items.
+  bool bPreferNumaNodeOfData = false;
+
   /// Returns the multiplicity to use for the given task. If 0 is returned,
   /// serial execution is to be performed.
   ezUInt32 DetermineMultiplicity(ezUInt32 uiNumTaskItems) const;
@@ -182,6 +250,10 @@ struct EZ_FOUNDATION_DLL ezParallelForParams
   /// Returns the number of task items to work on per invocation (multiplicity).
   /// This is aligned with the multiplicity, i.e., multiplicity * bin_size >= # task items.
   ezUInt32 DetermineItemsPerInvocation(ezUInt32 uiNumTaskItems, ezUInt32 uiMultiplicity) const;
+
+  /// Returns the number of ranges that adaptive partitioning starts with. If 0 is returned,
+  /// serial execution is to be performed.
+  ezUInt32 DetermineNumAdaptiveRanges(ezUInt32 uiNumTaskItems) const;
 };
 
 using ezParallelForIndexedFunction = ezDelegate<void(ezUInt32, ezUInt32), 48>;
@@ -189,6 +261,10 @@ using ezParallelForIndexedFunction = ezDelegate<void(ezUInt32, ezUInt32), 48>;
 template <typename ElemType>
 using ezParallelForFunction = ezDelegate<void(ezUInt32, ezArrayPtr<ElemType>), 48>;
 
+/// \brief Callback for adaptive partitioning: range index, start index and (exclusive) end index of the items to process.
+/// All items that are passed with the same range index are processed one after another, never concurrently.
+using ezParallelForRangeFunction = ezDelegate<void(ezUInt32, ezUInt32, ezUInt32), 48>;
+
 enum class ezTaskWorkerState
 {
   Active = 0,
@@ -0,0 +1,234 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskFiber.h>
+#include <Foundation/Threading/Implementation/TaskGroup.h>
+#include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+// A suspended fiber is always continued by the worker thread that suspended it. Otherwise a task that holds an ezMutex
+// while waiting for a group would unlock it from another thread, and thread local state would change in the middle of a function.
+// The thread local state of the task system itself is only touched in RunFiber(), which always runs on the worker's own stack.
+
+void ezTaskSystem::SetTaskWaitMode(ezTaskWaitMode::Enum mode)
+{
+  if (mode == ezTaskWaitMode::SuspendOnFibers && !ezTaskFiber::IsSupported())
+  {
+    mode = ezTaskWaitMode::HelpExecuting;
+  }
+
+  s_State->m_TaskWaitMode = mode;
+}
+
+ezTaskWaitMode::Enum ezTaskSystem::GetTaskWaitMode()
+{
+  return s_State->m_TaskWaitMode;
+}
+
+bool ezTaskSystem::ExecuteTaskOnFiber(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, ezAtomicInteger32* pWorkerState)
+{
+  ezTaskWorkerThread* pWorkerThread = tl_TaskWorkerInfo.m_pWorkerThread;
+
+  // continuing a suspended task is preferred over starting a new one, others are likely waiting for it already
+  ezTaskFiber* pFiber = PopReadyFiber(pWorkerThread);
+
+  if (pFiber == nullptr)
+  {
+    TaskData td = GetNextTask(FirstPriority, LastPriority, false, ezTaskGroupID(), pWorkerState);
+
+    if (td.m_pTask == nullptr)
+    {
+      // A fiber may have become ready after we looked, but before GetNextTask() switched this worker to the idle state,
+      // in which case nobody is going to wake us up for it.
+      if (pWorkerThread->m_iNumReadyFibers == 0)
+        return false;
+
+      // if revoking the idle state fails, someone else has woken us up already and WaitForWork() needs to consume the signal
+      if (pWorkerState->CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) != (int)ezTaskWorkerState::Idle)
+        return false;
+
+      pFiber = PopReadyFiber(pWorkerThread);
+
+      if (pFiber == nullptr)
+      {
+        EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+        return false;
+      }
+    }
+    else
+    {
+      pFiber = AcquireFiber();
+      pFiber->m_Task = td;
+      pFiber->m_pWorkerThread = pWorkerThread;
+    }
+  }
+
+  RunFiber(pFiber);
+  return true;
+}
+
+void ezTaskSystem::RunFiber(ezTaskFiber* pFiber)
+{
+  EZ_ASSERT_DEV(pFiber->m_pWorkerThread == tl_TaskWorkerInfo.m_pWorkerThread, "A fiber must only be continued by the worker thread that started it.");
+
+  while (true)
+  {
+    // the task pointer is only valid until the task has finished, so everything needed from it is read before switching to the fiber
+    tl_TaskWorkerInfo.m_pCurrentFiber = pFiber;
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = pFiber->m_Task.m_pTask->m_NestingMode != ezTaskNesting::Never;
+    tl_TaskWorkerInfo.m_szTaskName = pFiber->m_Task.m_pTask->m_sTaskName;
+
+    pFiber->m_State = ezTaskFiber::State::Running;
+    pFiber->Resume();
+
+    tl_TaskWorkerInfo.m_pCurrentFiber = nullptr;
+    tl_TaskWorkerInfo.m_bAllowNestedTasks = true;
+    tl_TaskWorkerInfo.m_szTaskName = nullptr;
+
+    if (pFiber->m_State == ezTaskFiber::State::Finished)
+    {
+      ReleaseFiber(pFiber);
+      return;
+    }
+
+    EZ_ASSERT_DEBUG(pFiber->m_State == ezTaskFiber::State::Waiting, "Invalid fiber state");
+
+    // The fiber can only be registered as waiting once it has fully switched away, otherwise another thread might try to continue it
+    // while it is still running here. If the group has finished in the mean time, just continue right away.
+    if (AddWaitingFiber(pFiber))
+      return;
+  }
+}
+
+void ezTaskSystem::FiberMain(ezTaskFiber* pFiber)
+{
+  while (true)
+  {
+    const TaskData td = pFiber->m_Task;
+
+    td.m_pTask->Run(td.m_uiInvocation);
+
+    // notify the group, that a task is finished, which might trigger other tasks to be executed
+    TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+
+    pFiber->m_State = ezTaskFiber::State::Finished;
+    pFiber->Suspend();
+  }
+}
+
+void ezTaskSystem::SuspendFiberUntilFinished(ezTaskFiber* pFiber, const ezTaskGroupID& Group)
+{
+  pFiber->m_WaitingForGroup = Group;
+  pFiber->m_State = ezTaskFiber::State::Waiting;
+  pFiber->Suspend();
+
+  EZ_ASSERT_DEBUG(pFiber->m_pWorkerThread == tl_TaskWorkerInfo.m_pWorkerThread, "The fiber was continued on another thread.");
+  pFiber->m_WaitingForGroup.Invalidate();
+}
+
+bool ezTaskSystem::AddWaitingFiber(ezTaskFiber* pFiber)
+{
+  const ezTaskGroupID& Group = pFiber->m_WaitingForGroup;
+  ezTaskGroup* pGroup = Group.m_pTaskGroup;
+
+  // see TaskHasFinished(), the group counter is only modified while holding this lock
+  EZ_LOCK(pGroup->m_CondVarGroupFinished);
+
+  if (pGroup->m_uiGroupCounter != Group.m_uiGroupCounter)
+    return false;
+
+  pFiber->m_pNextWaitingFiber = pGroup->m_pWaitingFibers;
+  pGroup->m_pWaitingFibers = pFiber;
+  return true;
+}
+
+void ezTaskSystem::ScheduleReadyFibers(ezTaskFiber* pFirstFiber)
+{
+  ezHybridArray<ezTaskWorkerThread*, 16> wakeUp;
+
+  {
+    EZ_LOCK(s_State->m_FiberMutex);
+
+    while (pFirstFiber != nullptr)
+    {
+      ezTaskFiber* pFiber = pFirstFiber;
+      pFirstFiber = pFiber->m_pNextWaitingFiber;
+      pFiber->m_pNextWaitingFiber = nullptr;
+
+      ezTaskWorkerThread* pWorkerThread = pFiber->m_pWorkerThread;
+      pWorkerThread->m_ReadyFibers.PushBack(pFiber);
+
+      if (pWorkerThread->m_iNumReadyFibers.Increment() == 1)
+      {
+        wakeUp.PushBack(pWorkerThread);
+      }
+    }
+  }
+
+  // only the thread that suspended a fiber can continue it, so exactly that thread has to be woken up
+  for (ezTaskWorkerThread* pWorkerThread : wakeUp)
+  {
+    pWorkerThread->WakeUpIfIdle();
+  }
+}
+
+ezTaskFiber* ezTaskSystem::PopReadyFiber(ezTaskWorkerThread* pWorkerThread)
+{
+  if (pWorkerThread->m_iNumReadyFibers == 0)
+    return nullptr;
+
+  EZ_LOCK(s_State->m_FiberMutex);
+
+  if (pWorkerThread->m_ReadyFibers.IsEmpty())
+    return nullptr;
+
+  ezTaskFiber* pFiber = pWorkerThread->m_ReadyFibers.PeekFront();
+  pWorkerThread->m_ReadyFibers.PopFront();
+  pWorkerThread->m_iNumReadyFibers.Decrement();
+  return pFiber;
+}
+
+ezTaskFiber* ezTaskSystem::AcquireFiber()
+{
+  EZ_LOCK(s_State->m_FiberMutex);
+
+  if (!s_State->m_FreeFibers.IsEmpty())
+  {
+    ezTaskFiber* pFiber = s_State->m_FreeFibers.PeekBack();
+    s_State->m_FreeFibers.PopBack();
+    return pFiber;
+  }
+
+  ezTaskFiber* pFiber = EZ_DEFAULT_NEW(ezTaskFiber, &ezTaskSystem::FiberMain, ezTaskSystemState::FiberStackSize);
+  s_State->m_AllFibers.PushBack(pFiber);
+  return pFiber;
+}
+
+void ezTaskSystem::ReleaseFiber(ezTaskFiber* pFiber)
+{
+  pFiber->m_State = ezTaskFiber::State::Idle;
+  pFiber->m_Task = TaskData();
+  pFiber->m_pWorkerThread = nullptr;
+
+  EZ_LOCK(s_State->m_FiberMutex);
+  s_State->m_FreeFibers.PushBack(pFiber);
+}
+
+void ezTaskSystem::DestroyFibers()
+{
+  EZ_LOCK(s_State->m_FiberMutex);
+
+  EZ_ASSERT_DEV(s_State->m_FreeFibers.GetCount() == s_State->m_AllFibers.GetCount(), "{} tasks are still suspended on fibers.", s_State->m_AllFibers.GetCount() - s_State->m_FreeFibers.GetCount());
+
+  for (ezTaskFiber* pFiber : s_State->m_AllFibers)
+  {
+    EZ_DEFAULT_DELETE(pFiber);
+  }
+
+  s_State->m_AllFibers.Clear();
+  s_State->m_FreeFibers.Clear();
+}
+
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskSystemFibers);
@@ -4,6 +4,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
@@ -11,31 +12,139 @@
 
 ezTaskGroupID ezTaskSystem::CreateTaskGroup(ezTaskPriority::Enum Priority, ezOnTaskGroupFinishedCallback callback)
 {
-  EZ_LOCK(s_TaskSystemMutex);
+  ezTaskGroup* pGroup = AcquireTaskGroup();
+  pGroup->Reuse(Priority, callback);
 
-  ezUInt32 i = 0;
+  ezTaskGroupID id;
+  id.m_pTaskGroup = pGroup;
+  id.m_uiGroupCounter = pGroup->m_uiGroupCounter;
+  return id;
+}
 
-  // this search could be speed up with a stack of free groups
-  for (; i < s_State->m_TaskGroups.GetCount(); ++i)
+ezTaskGroup* ezTaskSystem::AcquireTaskGroup()
+{
+  while (true)
   {
-    if (!s_State->m_TaskGroups[i].m_bInUse)
+    const ezInt64 iHead = s_State->m_iFreeTaskGroups;
+    const ezUInt32 uiFirstFree = static_cast<ezUInt32>(static_cast<ezUInt64>(iHead) & 0xFFFFFFFF);
+
+    if (uiFirstFree == 0)
+    {
+      if (!AllocateTaskGroupBlock())
+        return AcquireOverflowTaskGroup();
+
+      continue;
+    }
+
+    ezTaskGroup* pGroup = GetTaskGroupByIndex(uiFirstFree - 1);
+
+    // m_uiNextFreeGroup may already be outdated, if another thread took this group in the meantime
+    // in that case the ABA counter has changed as well and the swap fails
+    const ezUInt64 uiAbaCounter = (static_cast<ezUInt64>(iHead) >> 32) + 1;
+    const ezInt64 iNewHead = static_cast<ezInt64>((uiAbaCounter << 32) | pGroup->m_uiNextFreeGroup);
+
+    if (s_State->m_iFreeTaskGroups.TestAndSet(iHead, iNewHead))
     {
-      goto foundtaskgroup;
+      pGroup->m_bInUse = true;
+      return pGroup;
     }
   }
+}
 
-  // no free group found, create a new one
-  s_State->m_TaskGroups.ExpandAndGetRef();
-  s_State->m_TaskGroups[i].m_uiTaskGroupIndex = static_cast<ezUInt16>(i);
+ezTaskGroup* ezTaskSystem::AcquireOverflowTaskGroup()
+{
+  EZ_LOCK(s_State->m_OverflowTaskGroupsMutex);
 
-foundtaskgroup:
+  ezTaskGroup* pGroup = nullptr;
 
-  s_State->m_TaskGroups[i].Reuse(Priority, callback);
+  if (!s_State->m_FreeOverflowTaskGroups.IsEmpty())
+  {
+    pGroup = s_State->m_FreeOverflowTaskGroups.PeekBack();
+    s_State->m_FreeOverflowTaskGroups.PopBack();
+  }
+  else
+  {
+    pGroup = EZ_DEFAULT_NEW(ezTaskGroup);
+    s_State->m_OverflowTaskGroups.PushBack(pGroup);
+  }
 
-  ezTaskGroupID id;
-  id.m_pTaskGroup = &s_State->m_TaskGroups[i];
-  id.m_uiGroupCounter = s_State->m_TaskGroups[i].m_uiGroupCounter;
-  return id;
+  pGroup->m_bInUse = true;
+  return pGroup;
+}
+
+void ezTaskSystem::ReleaseTaskGroup(ezTaskGroup* pGroup)
+{
+  pGroup->m_bInUse = false;
+
+  if (pGroup->m_uiTaskGroupIndex == ezTaskGroup::s_uiNoIndex)
+  {
+    EZ_LOCK(s_State->m_OverflowTaskGroupsMutex);
+    s_State->m_FreeOverflowTaskGroups.PushBack(pGroup);
+    return;
+  }
+
+  while (true)
+  {
+    const ezInt64 iHead = s_State->m_iFreeTaskGroups;
+    pGroup->m_uiNextFreeGroup = static_cast<ezUInt32>(static_cast<ezUInt64>(iHead) & 0xFFFFFFFF);
+
+    const ezUInt64 uiAbaCounter = (static_cast<ezUInt64>(iHead) >> 32) + 1;
+    const ezInt64 iNewHead = static_cast<ezInt64>((uiAbaCounter << 32) | (pGroup->m_uiTaskGroupIndex + 1u));
+
+    if (s_State->m_iFreeTaskGroups.TestAndSet(iHead, iNewHead))
+      return;
+  }
+}
+
+bool ezTaskSystem::AllocateTaskGroupBlock()
+{
+  // growing the pool is rare, so it is fine to use the mutex here
+  EZ_LOCK(s_TaskSystemMutex);
+
+  // another thread may have allocated a block while we waited for the lock
+  if ((static_cast<ezUInt64>(s_State->m_iFreeTaskGroups) & 0xFFFFFFFF) != 0)
+    return true;
+
+  const ezUInt32 uiBlock = s_State->m_iNumTaskGroupBlocks;
+
+  // the links between groups can't encode more indices, further groups are allocated one by one without an index
+  if (uiBlock >= ezTaskSystemState::MaxTaskGroupBlocks)
+    return false;
+
+  ezArrayPtr<ezTaskGroup> groups = EZ_DEFAULT_NEW_ARRAY(ezTaskGroup, ezTaskSystemState::TaskGroupBlockSize);
+
+  const ezUInt32 uiFirstIndex = uiBlock * ezTaskSystemState::TaskGroupBlockSize;
+
+  // the last block contains one group less, see ezTaskSystemState::MaxTaskGroups
+  const ezUInt32 uiNumGroups = ezMath::Min(ezTaskSystemState::TaskGroupBlockSize, ezTaskSystemState::MaxTaskGroups - uiFirstIndex);
+
+  for (ezUInt32 i = 0; i < uiNumGroups; ++i)
+  {
+    groups[i].m_uiTaskGroupIndex = static_cast<ezUInt16>(uiFirstIndex + i);
+    groups[i].m_uiNextFreeGroup = uiFirstIndex + i + 2; // index + 1 of the next group
+  }
+
+  // make the block accessible through GetTaskGroupByIndex() before any of its groups can be taken from the free list
+  s_State->m_TaskGroupBlocks[uiBlock] = groups;
+  s_State->m_iNumTaskGroupBlocks.Increment();
+
+  // push the whole chain of new groups onto the free list
+  while (true)
+  {
+    const ezInt64 iHead = s_State->m_iFreeTaskGroups;
+    groups[uiNumGroups - 1].m_uiNextFreeGroup = static_cast<ezUInt32>(static_cast<ezUInt64>(iHead) & 0xFFFFFFFF);
+
+    const ezUInt64 uiAbaCounter = (static_cast<ezUInt64>(iHead) >> 32) + 1;
+    const ezInt64 iNewHead = static_cast<ezInt64>((uiAbaCounter << 32) | (uiFirstIndex + 1));
+
+    if (s_State->m_iFreeTaskGroups.TestAndSet(iHead, iNewHead))
+      return true;
+  }
+}
+
+ezTaskGroup* ezTaskSystem::GetTaskGroupByIndex(ezUInt32 uiIndex)
+{
+  return &s_State->m_TaskGroupBlocks[uiIndex / ezTaskSystemState::TaskGroupBlockSize][uiIndex % ezTaskSystemState::TaskGroupBlockSize];
 }
 
 void ezTaskSystem::AddTaskToGroup(ezTaskGroupID groupID, ezTask* pTask)
@@ -81,52 +190,136 @@ void ezTaskSystem::StartTaskGroup(ezTaskGroupID groupID)
 
   ezTaskGroup::DebugCheckTaskGroup(groupID, s_TaskSystemMutex);
 
-  ezInt32 iActiveDependencies = 0;
+  ezTaskGroup& tg = *groupID.m_pTaskGroup;
 
-  {
-    EZ_LOCK(s_TaskSystemMutex);
+  tg.m_bStartedByUser = true;
 
-    ezTaskGroup& tg = *groupID.m_pTaskGroup;
+  const ezUInt32 uiNumDependencies = tg.m_DependsOnGroups.GetCount();
+  EZ_ASSERT_DEV(uiNumDependencies < 0xFFFF, "Too many dependencies on a single task group.");
 
-    tg.m_bStartedByUser = true;
+  if (uiNumDependencies > 0)
+  {
+    tg.m_DependencyLinks.SetCountUninitialized(uiNumDependencies);
 
-    for (ezUInt32 i = 0; i < tg.m_DependsOnGroups.GetCount(); ++i)
+    // count one additional dependency, so that the group cannot get scheduled by a finishing dependency,
+    // while we are still linking it into the lists of the other dependencies
+    tg.m_iNumActiveDependencies = uiNumDependencies + 1;
+
+    for (ezUInt32 i = 0; i < uiNumDependencies; ++i)
     {
-      if (!IsTaskGroupFinished(tg.m_DependsOnGroups[i]))
+      // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
+      if (!AddDependentGroup(tg.m_DependsOnGroups[i], &tg, i))
       {
-        ezTaskGroup& Dependency = *tg.m_DependsOnGroups[i].m_pTaskGroup;
-
-        // add this task group to the list of dependencies, such that when that group finishes, this task group can get woken up
-        Dependency.m_OthersDependingOnMe.PushBack(groupID);
-
-        // count how many other groups need to finish before this task group can be executed
-        ++iActiveDependencies;
+        // that group has already finished
+        tg.m_iNumActiveDependencies.Decrement();
       }
     }
 
-    if (iActiveDependencies != 0)
-    {
-      // atomic integers are quite slow, so do not use them in the loop, where they are not yet needed
-      tg.m_iNumActiveDependencies = iActiveDependencies;
-    }
+    if (tg.m_iNumActiveDependencies.Decrement() != 0)
+      return;
   }
 
-  if (iActiveDependencies == 0)
-  {
-    ScheduleGroupTasks(groupID.m_pTaskGroup, false);
-  }
+  ScheduleGroupTasks(groupID.m_pTaskGroup, false);
 }
 
 void ezTaskSystem::StartTaskGroupBatch(ezArrayPtr<const ezTaskGroupID> batch)
 {
-  EZ_LOCK(s_TaskSystemMutex);
-
   for (const ezTaskGroupID& group : batch)
   {
     StartTaskGroup(group);
   }
 }
 
+bool ezTaskSystem::AddDependentGroup(const ezTaskGroupID& Dependency, ezTaskGroup* pDependent, ezUInt32 uiDependencyIndex)
+{
+  ezTaskGroup* pDependency = Dependency.m_pTaskGroup;
+
+  if (pDependency == nullptr)
+    return false;
+
+  if (pDependent->m_uiTaskGroupIndex == ezTaskGroup::s_uiNoIndex)
+    return AddOverflowDependentGroup(Dependency, pDependent);
+
+  const ezUInt32 uiLink = (static_cast<ezUInt32>(pDependent->m_uiTaskGroupIndex) << 16) | uiDependencyIndex;
+
+  while (true)
+  {
+    const ezInt64 iHead = pDependency->m_iOthersDependingOnMe;
+
+    // the generation check also catches groups that have finished and already got reused
+    if (ezTaskGroup::GetHeadGeneration(iHead) != Dependency.m_uiGroupCounter || ezTaskGroup::GetHeadLink(iHead) == ezTaskGroup::s_uiClosedLink)
+      return false;
+
+    pDependent->m_DependencyLinks[uiDependencyIndex] = ezTaskGroup::GetHeadLink(iHead);
+
+    if (pDependency->m_iOthersDependingOnMe.TestAndSet(iHead, ezTaskGroup::MakeDependentsHead(Dependency.m_uiGroupCounter, uiLink)))
+      return true;
+  }
+}
+
+bool ezTaskSystem::AddOverflowDependentGroup(const ezTaskGroupID& Dependency, ezTaskGroup* pDependent)
+{
+  ezTaskGroup* pDependency = Dependency.m_pTaskGroup;
+
+  auto IsOpen = [&]() {
+    const ezInt64 iHead = pDependency->m_iOthersDependingOnMe;
+    return ezTaskGroup::GetHeadGeneration(iHead) == Dependency.m_uiGroupCounter && ezTaskGroup::GetHeadLink(iHead) != ezTaskGroup::s_uiClosedLink;
+  };
+
+  EZ_LOCK(s_State->m_OverflowTaskGroupsMutex);
+
+  if (!IsOpen())
+    return false;
+
+  pDependency->m_OverflowDependents.PushBack(pDependent);
+  pDependency->m_bHasOverflowDependents = true;
+
+  // NotifyDependentGroups() closes the list first and checks the flag afterwards, so if the list is still open now,
+  // the finishing group is guaranteed to see the flag and to pick up the entry, once we release the mutex
+  if (!IsOpen())
+  {
+    pDependency->m_OverflowDependents.PopBack();
+    return false;
+  }
+
+  return true;
+}
+
+void ezTaskSystem::NotifyDependentGroups(ezTaskGroup* pGroup, ezUInt32 uiGroupCounter)
+{
+  // close the list, nobody can add themselves anymore, after this
+  const ezInt64 iHead = pGroup->m_iOthersDependingOnMe.Set(ezTaskGroup::MakeDependentsHead(uiGroupCounter, ezTaskGroup::s_uiClosedLink));
+
+  ezUInt32 uiLink = ezTaskGroup::GetHeadLink(iHead);
+
+  while (uiLink != ezTaskGroup::s_uiNoLink)
+  {
+    ezTaskGroup* pDependent = GetTaskGroupByIndex(uiLink >> 16);
+
+    // read the next link before notifying the dependent group, it may run, finish and get reused right away
+    uiLink = pDependent->m_DependencyLinks[uiLink & 0xFFFF];
+
+    DependencyHasFinished(pDependent);
+  }
+
+  if (pGroup->m_bHasOverflowDependents)
+  {
+    ezHybridArray<ezTaskGroup*, 16> overflowDependents;
+
+    {
+      EZ_LOCK(s_State->m_OverflowTaskGroupsMutex);
+      overflowDependents = pGroup->m_OverflowDependents;
+      pGroup->m_OverflowDependents.Clear();
+      pGroup->m_bHasOverflowDependents = false;
+    }
+
+    for (ezTaskGroup* pDependent : overflowDependents)
+    {
+      DependencyHasFinished(pDependent);
+    }
+  }
+}
+
 bool ezTaskSystem::IsTaskGroupFinished(ezTaskGroupID Group)
 {
   // if the counters differ, the task group has been reused since the GroupID was created, so that group has finished
@@ -146,6 +339,31 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
   ezInt32 iRemainingTasks = 0;
 
+  // in work-stealing mode, worker threads put the tasks into their own deques, from where other workers may steal them
+  ezTaskWorkStealingDeque* pLocalTasks = nullptr;
+  if (s_State->m_SchedulerMode == ezTaskSchedulerMode::WorkStealing && tl_TaskWorkerInfo.m_pLocalTasks != nullptr && tl_TaskWorkerInfo.m_pLocalTasks[pGroup->m_Priority].IsEnabled())
+  {
+    pLocalTasks = &tl_TaskWorkerInfo.m_pLocalTasks[pGroup->m_Priority];
+  }
+
+  // Tasks that prefer a NUMA node go into the queue of that node, where the worker threads of that node look first.
+  // Determining the node may require a syscall per invocation (see ezSystemInformation::GetNumaNodeOfAddress()),
+  // so this is done before taking the lock that every scheduling and worker thread contends on.
+  const ezInt32 iNumNumaNodes = s_State->m_bUseNumaNodeQueues ? ezMath::Min((ezInt32)ezSystemInformation::Get().GetNumaNodeCount(), (ezInt32)ezSystemInformation::MaxNumaNodes) : 0;
+  ezHybridArray<ezInt8, 64> preferredNodes;
+
+  if (iNumNumaNodes > 1)
+  {
+    for (auto pTask : pGroup->m_Tasks)
+    {
+      for (ezUInt32 mult = 0; mult < ezMath::Max(1u, pTask->m_uiMultiplicity); ++mult)
+      {
+        const ezInt32 iNode = pTask->GetPreferredNumaNode(mult);
+        preferredNodes.PushBack((iNode >= 0 && iNode < iNumNumaNodes) ? static_cast<ezInt8>(iNode) : -1);
+      }
+    }
+  }
+
   // add all the tasks to the task list, so that they will be processed
   {
     EZ_LOCK(s_TaskSystemMutex);
@@ -161,6 +379,7 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
 
     pGroup->m_iNumRemainingTasks = iRemainingTasks;
 
+    ezUInt32 uiInvocationIdx = 0;
 
     for (ezUInt32 task = 0; task < pGroup->m_Tasks.GetCount(); ++task)
     {
@@ -174,6 +393,26 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
         td.m_pTask->m_bTaskIsScheduled = true;
         td.m_uiInvocation = mult;
 
+        // SetUseNumaNodeQueues() may have disabled the node queues in the mean time
+        if (!preferredNodes.IsEmpty())
+        {
+          const ezInt32 iNode = preferredNodes[uiInvocationIdx++];
+
+          if (iNode >= 0 && s_State->m_bUseNumaNodeQueues)
+          {
+            if (bHighPriority)
+              s_State->m_NodeTasks[iNode][pGroup->m_Priority].PushFront(td);
+            else
+              s_State->m_NodeTasks[iNode][pGroup->m_Priority].PushBack(td);
+
+            continue;
+          }
+        }
+
+        // if the deque is full, the task goes into the shared list instead
+        if (pLocalTasks != nullptr && pLocalTasks->PushBottom(td))
+          continue;
+
         if (bHighPriority)
           s_State->m_Tasks[pGroup->m_Priority].PushFront(td);
         else
@@ -181,6 +420,8 @@ void ezTaskSystem::ScheduleGroupTasks(ezTaskGroup* pGroup, bool bHighPriority)
       }
     }
 
+    s_State->UpdateNumSharedTasks(pGroup->m_Priority);
+
     // send the proper thread signal, to make sure one of the correct worker threads is awake
     switch (pGroup->m_Priority)
     {
@@ -274,10 +515,21 @@ ezResult ezTaskSystem::CancelGroup(ezTaskGroupID Group, ezOnTaskRunning::Enum On
 
 void ezTaskSystem::WaitForGroup(ezTaskGroupID Group)
 {
-  EZ_PROFILE_SCOPE("WaitForGroup");
-
   EZ_ASSERT_DEV(tl_TaskWorkerInfo.m_bAllowNestedTasks, "The executing task '{}' is flagged to never wait for other tasks but does so anyway. Remove the flag or remove the wait-dependency.", tl_TaskWorkerInfo.m_szTaskName);
 
+  if (ezTaskFiber* pFiber = tl_TaskWorkerInfo.m_pCurrentFiber)
+  {
+    // running on a fiber, let this worker do something else until the group is finished
+    if (!IsTaskGroupFinished(Group))
+    {
+      SuspendFiberUntilFinished(pFiber, Group);
+    }
+
+    return;
+  }
+
+  EZ_PROFILE_SCOPE("WaitForGroup");
+
   const auto ThreadTaskType = tl_TaskWorkerInfo.m_WorkerType;
   const bool bAllowSleep = ThreadTaskType != ezWorkerThreadType::MainThread;
 
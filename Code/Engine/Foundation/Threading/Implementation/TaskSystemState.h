@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/System/SystemInformation.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 class ezTaskSystemThreadState
@@ -16,6 +18,12 @@ private:
 
   // the maximum number of worker threads that should be non-idle (and not blocked) at any time
   ezUInt32 m_uiMaxWorkersToUse[ezWorkerThreadType::ENUM_COUNT] = {};
+
+  // On which CPUs the short and long task workers run
+  ezTaskWorkerAffinity::Enum m_WorkerAffinity = ezTaskWorkerAffinity::Default;
+
+  // Indices into the ezSystemInformation logical CPUs, in the order in which ezTaskWorkerAffinity::PhysicalCore assigns them to workers
+  ezDynamicArray<ezUInt32> m_WorkerCPUOrder;
 };
 
 class ezTaskSystemState
@@ -26,9 +34,61 @@ private:
   // The target frame time used by FinishFrameTasks()
   ezTime m_TargetFrameTime = ezTime::Seconds(1.0 / 40.0); // => 25 ms
 
-  // The deque can grow without relocating existing data, therefore the ezTaskGroupID's can store pointers directly to the data
-  ezDeque<ezTaskGroup> m_TaskGroups;
+  static constexpr ezUInt32 TaskGroupBlockSize = 256;
+  static constexpr ezUInt32 MaxTaskGroupBlocks = 256; // ezTaskGroup::m_uiTaskGroupIndex is 16 bit
+
+  // The group index 0xFFFF is never handed out, a link to it could look like ezTaskGroup::s_uiNoLink or ezTaskGroup::s_uiClosedLink
+  static constexpr ezUInt32 MaxTaskGroups = 0xFFFF;
+
+  // Task groups are allocated in blocks that never move, therefore the ezTaskGroupID's can store pointers directly to the data
+  // and the free list can reference groups by index without locking
+  ezArrayPtr<ezTaskGroup> m_TaskGroupBlocks[MaxTaskGroupBlocks];
+  ezAtomicInteger32 m_iNumTaskGroupBlocks;
+
+  // Lock-free stack of unused task groups. Lower 32 bits: index + 1 of the first free group. Upper 32 bits: ABA counter
+  ezAtomicInteger64 m_iFreeTaskGroups;
+
+  // Once all MaxTaskGroups groups are in use, further groups are allocated on the heap. They have no index (ezTaskGroup::s_uiNoIndex)
+  // and are never deleted before Shutdown(), since ezTaskGroupID's point to them. The mutex also guards ezTaskGroup::m_OverflowDependents.
+  ezMutex m_OverflowTaskGroupsMutex;
+  ezDynamicArray<ezTaskGroup*> m_OverflowTaskGroups;
+  ezDynamicArray<ezTaskGroup*> m_FreeOverflowTaskGroups;
 
   // The lists of all scheduled tasks, for each priority.
   ezList<ezTaskSystem::TaskData> m_Tasks[ezTaskPriority::ENUM_COUNT];
+
+  // Tasks that prefer to be executed on a certain NUMA node, only used when m_bUseNumaNodeQueues is set
+  ezList<ezTaskSystem::TaskData> m_NodeTasks[ezSystemInformation::MaxNumaNodes][ezTaskPriority::ENUM_COUNT];
+  bool m_bUseNumaNodeQueues = false;
+
+  // Mirrors the number of tasks in m_Tasks[i] and all m_NodeTasks[n][i], so that work-stealing workers can skip empty lists without locking the mutex
+  ezAtomicInteger32 m_iNumSharedTasks[ezTaskPriority::ENUM_COUNT];
+
+  /// \brief Updates m_iNumSharedTasks[priority]. Expects the task system mutex to be locked.
+  void UpdateNumSharedTasks(ezUInt32 uiPriority)
+  {
+    ezUInt32 uiCount = m_Tasks[uiPriority].GetCount();
+
+    for (ezUInt32 node = 0; node < ezSystemInformation::MaxNumaNodes; ++node)
+    {
+      uiCount += m_NodeTasks[node][uiPriority].GetCount();
+    }
+
+    m_iNumSharedTasks[uiPriority] = uiCount;
+  }
+
+  // How tasks are distributed to the worker threads
+  ezTaskSchedulerMode::Enum m_SchedulerMode = ezTaskSchedulerMode::Default;
+
+  // What worker threads do while a task waits for a group
+  ezTaskWaitMode::Enum m_TaskWaitMode = ezTaskWaitMode::Default;
+
+  static constexpr ezUInt32 FiberStackSize = 256 * 1024;
+
+  // Guards the fiber pool and the ready lists of the worker threads
+  ezMutex m_FiberMutex;
+
+  // All fibers that have been created so far and the ones that are currently unused
+  ezDynamicArray<ezTaskFiber*> m_AllFibers;
+  ezDynamicArray<ezTaskFiber*> m_FreeFibers;
 };
@@ -3,6 +3,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Threading/Implementation/TaskGroup.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
@@ -39,6 +40,7 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
     // If this was the last task that had to be finished from this group, make sure all dependent groups are started
 
     ezUInt32 groupCounter = 0;
+    ezTaskFiber* pWaitingFibers = nullptr;
     {
       // see ezTaskGroup::WaitForFinish() for why we need this lock here
       // without it, there would be a race condition between these two places, reading and writing m_uiGroupCounter and waiting/signaling m_CondVarGroupFinished
@@ -47,20 +49,22 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
       groupCounter = pGroup->m_uiGroupCounter;
       // set this task group to be finished such that no one tries to append further dependencies
       pGroup->m_uiGroupCounter += 2;
+
+      pWaitingFibers = pGroup->m_pWaitingFibers;
+      pGroup->m_pWaitingFibers = nullptr;
     }
 
     // wake up all threads that are waiting for this group
     pGroup->m_CondVarGroupFinished.SignalAll();
 
+    // and continue all tasks that were suspended while waiting for it
+    if (pWaitingFibers != nullptr)
     {
-      EZ_LOCK(s_TaskSystemMutex);
-
-      for (ezUInt32 dep = 0; dep < pGroup->m_OthersDependingOnMe.GetCount(); ++dep)
-      {
-        DependencyHasFinished(pGroup->m_OthersDependingOnMe[dep].m_pTaskGroup);
-      }
+      ScheduleReadyFibers(pWaitingFibers);
     }
 
+    NotifyDependentGroups(pGroup, groupCounter);
+
     if (pGroup->m_OnFinishedCallback.IsValid())
     {
       ezTaskGroupID id;
@@ -70,7 +74,7 @@ void ezTaskSystem::TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup)
     }
 
     // set this task available for reuse
-    pGroup->m_bInUse = false;
+    ReleaseTaskGroup(pGroup);
   }
 }
 
@@ -80,35 +84,238 @@ ezTaskSystem::TaskData ezTaskSystem::GetNextTask(ezTaskPriority::Enum FirstPrior
 
   EZ_ASSERT_DEV(FirstPriority >= ezTaskPriority::EarlyThisFrame && LastPriority < ezTaskPriority::ENUM_COUNT, "Priority Range is invalid: {0} to {1}", FirstPriority, LastPriority);
 
+  if (s_State->m_SchedulerMode == ezTaskSchedulerMode::WorkStealing)
+  {
+    return GetNextTaskWorkStealing(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, pWorkerState);
+  }
+
   EZ_LOCK(s_TaskSystemMutex);
 
   // go through all the task lists that this thread is willing to work on
   for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
   {
-    for (auto it = s_State->m_Tasks[prio].GetIterator(); it.IsValid(); ++it)
+    TaskData td;
+    if (GetNextSharedTask(static_cast<ezTaskPriority::Enum>(prio), bOnlyTasksThatNeverWait, WaitingForGroup, td))
+    {
+      return td;
+    }
+  }
+
+  if (pWorkerState)
+  {
+    EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+  }
+
+  return TaskData();
+}
+
+bool ezTaskSystem::GetNextSharedTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  auto TakeFrom = [&](ezList<TaskData>& list) {
+    if (!TakeTaskFromList(list, bOnlyTasksThatNeverWait, WaitingForGroup, out_Task))
+      return false;
+
+    s_State->m_iNumSharedTasks[Priority].Decrement();
+    return true;
+  };
+
+  if (!s_State->m_bUseNumaNodeQueues)
+  {
+    return TakeFrom(s_State->m_Tasks[Priority]);
+  }
+
+  // tasks that prefer the node of this thread come first, their data is closest
+  const ezInt32 iOwnNode = tl_TaskWorkerInfo.m_iNumaNode;
+  if (iOwnNode >= 0 && TakeFrom(s_State->m_NodeTasks[iOwnNode][Priority]))
+    return true;
+
+  if (TakeFrom(s_State->m_Tasks[Priority]))
+    return true;
+
+  // rather execute tasks of other nodes than being idle
+  for (ezUInt32 node = 0; node < ezSystemInformation::MaxNumaNodes; ++node)
+  {
+    if (static_cast<ezInt32>(node) != iOwnNode && TakeFrom(s_State->m_NodeTasks[node][Priority]))
+      return true;
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::TakeTaskFromList(ezList<TaskData>& list, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task)
+{
+  for (auto it = list.GetIterator(); it.IsValid(); ++it)
+  {
+    if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
     {
-      if (!bOnlyTasksThatNeverWait || (it->m_pTask->m_NestingMode == ezTaskNesting::Never) || it->m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup)
+      out_Task = *it;
+
+      list.Remove(it);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+ezTaskSystem::TaskData ezTaskSystem::GetNextTaskWorkStealing(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
+{
+  ezTaskWorkStealingDeque* pLocalTasks = tl_TaskWorkerInfo.m_pLocalTasks;
+
+  // while waiting for a group, a thread may only pick up tasks that never wait themselves, or that belong to that group
+  auto IsAllowed = [&](const TaskData& td) { return !bOnlyTasksThatNeverWait || (td.m_pTask->m_NestingMode == ezTaskNesting::Never) || td.m_pBelongsToGroup == WaitingForGroup.m_pTaskGroup; };
+
+  bool bRechecked = false;
+
+  while (true)
+  {
+    TaskData td;
+
+    for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+    {
+      const ezTaskPriority::Enum priority = static_cast<ezTaskPriority::Enum>(prio);
+
+      // the tasks that this thread scheduled itself are the cheapest to get and most likely still in the cache
+      if (pLocalTasks != nullptr)
+      {
+        ezTaskWorkStealingDeque& localTasks = pLocalTasks[prio];
+
+        if (!bOnlyTasksThatNeverWait)
+        {
+          if (localTasks.PopBottom(td))
+            return td;
+        }
+        else if (localTasks.PeekBottom(td) && IsAllowed(td) && localTasks.PopBottom(td))
+        {
+          return td;
+        }
+      }
+
+      if (s_State->m_iNumSharedTasks[prio] > 0)
       {
-        TaskData td = *it;
+        EZ_LOCK(s_TaskSystemMutex);
+
+        if (GetNextSharedTask(priority, bOnlyTasksThatNeverWait, WaitingForGroup, td))
+        {
+          // move a fair share of the remaining tasks into our own deque
+          // that way the other workers can steal them from us, instead of having to lock the mutex for every single task
+          if (!bOnlyTasksThatNeverWait && pLocalTasks != nullptr && pLocalTasks[prio].IsEnabled())
+          {
+            const ezUInt32 uiNumWorkers = ezMath::Max(1u, s_ThreadState->m_uiMaxWorkersToUse[tl_TaskWorkerInfo.m_WorkerType]);
+            ezUInt32 uiBatchSize = ezMath::Min(s_State->m_Tasks[prio].GetCount() / uiNumWorkers, 32u);
 
-        s_State->m_Tasks[prio].Remove(it);
+            while (uiBatchSize > 0 && pLocalTasks[prio].PushBottom(s_State->m_Tasks[prio].PeekFront()))
+            {
+              s_State->m_Tasks[prio].PopFront();
+              --uiBatchSize;
+            }
+
+            s_State->UpdateNumSharedTasks(prio);
+          }
+
+          return td;
+        }
+      }
+
+      // stolen tasks cannot be given back, so only steal when any task is acceptable
+      if (!bOnlyTasksThatNeverWait && IsWorkStealingPriority(priority) && StealTask(priority, td))
+      {
         return td;
       }
     }
-  }
 
-  if (pWorkerState)
-  {
+    if (pWorkerState == nullptr)
+      break;
+
     EZ_VERIFY(pWorkerState->Set((int)ezTaskWorkerState::Idle) == (int)ezTaskWorkerState::Active, "Corrupt Worker State");
+
+    if (bRechecked)
+      break;
+
+    bRechecked = true;
+
+    // Tasks are pushed into the deques without locking the mutex, so a task may have been pushed after we looked at that deque,
+    // but before we switched to the idle state, in which case nobody is going to wake us up for it.
+    // Therefore check once more, after announcing that we are idle.
+    bool bWorkAvailable = false;
+    for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority && !bWorkAvailable; ++prio)
+    {
+      bWorkAvailable = s_State->m_iNumSharedTasks[prio] > 0 || (pLocalTasks != nullptr && !pLocalTasks[prio].IsEmpty());
+
+      if (!bWorkAvailable && IsWorkStealingPriority(static_cast<ezTaskPriority::Enum>(prio)))
+      {
+        const ezWorkerThreadType::Enum stealFrom = (prio <= ezTaskPriority::LateThisFrame) ? ezWorkerThreadType::ShortTasks : ezWorkerThreadType::LongTasks;
+        const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[stealFrom];
+
+        for (ezUInt32 i = 0; i < uiNumWorkers && !bWorkAvailable; ++i)
+        {
+          bWorkAvailable = !s_ThreadState->m_Workers[stealFrom][i]->GetLocalTasks(static_cast<ezTaskPriority::Enum>(prio)).IsEmpty();
+        }
+      }
+    }
+
+    if (!bWorkAvailable)
+      break;
+
+    // revoke the idle state, if that fails, someone else has woken us up already and raised the wake-up signal
+    // in that case return without a task, so that the signal gets consumed by the worker's WaitForWork() right away
+    if (pWorkerState->CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) != (int)ezTaskWorkerState::Idle)
+      break;
   }
 
   return TaskData();
 }
 
+bool ezTaskSystem::StealTask(ezTaskPriority::Enum Priority, TaskData& out_Task)
+{
+  const ezWorkerThreadType::Enum stealFrom = (Priority <= ezTaskPriority::LateThisFrame) ? ezWorkerThreadType::ShortTasks : ezWorkerThreadType::LongTasks;
+  const ezUInt32 uiNumWorkers = s_ThreadState->m_iAllocatedWorkers[stealFrom];
+
+  if (uiNumWorkers == 0)
+    return false;
+
+  // start with a different victim on every thread, to spread the contention
+  const ezUInt32 uiFirstVictim = static_cast<ezUInt32>(tl_TaskWorkerInfo.m_iWorkerIndex + 1);
+
+  for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
+  {
+    ezTaskWorkerThread* pVictim = s_ThreadState->m_Workers[stealFrom][(uiFirstVictim + i) % uiNumWorkers];
+
+    if (pVictim->GetLocalTasks(Priority).Steal(out_Task))
+      return true;
+  }
+
+  return false;
+}
+
+bool ezTaskSystem::IsWorkStealingPriority(ezTaskPriority::Enum Priority)
+{
+  // 'next frame' and 'in N frames' tasks need to stay in the shared lists, so that FinishFrameTasks() can re-prioritize them
+  // main thread and file access tasks are only ever executed by a single thread, so there is nobody to steal them
+  switch (Priority)
+  {
+    case ezTaskPriority::EarlyThisFrame:
+    case ezTaskPriority::ThisFrame:
+    case ezTaskPriority::LateThisFrame:
+    case ezTaskPriority::LongRunningHighPriority:
+    case ezTaskPriority::LongRunning:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
 bool ezTaskSystem::ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState)
 {
   //const ezWorkerThreadType::Enum workerType = (tl_TaskWorkerInfo.m_WorkerType == ezWorkerThreadType::Unknown) ? ezWorkerThreadType::ShortTasks : tl_TaskWorkerInfo.m_WorkerType;
 
+  // only the main loop of the worker threads passes in its state, all other callers help out while waiting for something
+  if (pWorkerState != nullptr && s_State->m_TaskWaitMode == ezTaskWaitMode::SuspendOnFibers)
+  {
+    return ExecuteTaskOnFiber(FirstPriority, LastPriority, pWorkerState);
+  }
+
   ezTaskSystem::TaskData td = GetNextTask(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, pWorkerState);
 
   if (td.m_pTask == nullptr)
@@ -160,30 +367,53 @@ ezResult ezTaskSystem::CancelTask(ezTask* pTask, ezOnTaskRunning::Enum OnTaskRun
     // check if the task has already been scheduled for execution
     // if so, remove it from the work queue
     {
-      for (ezUInt32 i = 0; i < ezTaskPriority::ENUM_COUNT; ++i)
-      {
-        auto it = s_State->m_Tasks[i].GetIterator();
-
-        while (it.IsValid())
+      auto RemoveFromList = [pTask](ezList<TaskData>& list, ezUInt32 uiPriority) {
+        for (auto it = list.GetIterator(); it.IsValid(); ++it)
         {
           if (it->m_pTask == pTask)
           {
-            s_State->m_Tasks[i].Remove(it);
+            const TaskData td = *it;
+            list.Remove(it);
+            s_State->m_iNumSharedTasks[uiPriority].Decrement();
 
             // we set the task to finished, even though it was not executed
             pTask->m_iRemainingRuns = 0;
 
             // tell the system that one task of that group is 'finished', to ensure its dependencies will get scheduled
-            TaskHasFinished(it->m_pTask, it->m_pBelongsToGroup);
-            return EZ_SUCCESS;
+            TaskHasFinished(td.m_pTask, td.m_pBelongsToGroup);
+            return true;
           }
+        }
+
+        return false;
+      };
+
+      for (ezUInt32 i = 0; i < ezTaskPriority::ENUM_COUNT; ++i)
+      {
+        if (RemoveFromList(s_State->m_Tasks[i], i))
+          return EZ_SUCCESS;
 
-          ++it;
+        for (ezUInt32 node = 0; node < ezSystemInformation::MaxNumaNodes; ++node)
+        {
+          if (RemoveFromList(s_State->m_NodeTasks[node][i], i))
+            return EZ_SUCCESS;
         }
       }
     }
   }
 
+  // Tasks in the deques of the workers can't be removed from there. Instead, if no invocation has started yet,
+  // the task is marked such that the workers skip it when they pop it. It counts as finished once all invocations were skipped.
+  if (pTask->m_iStartedRuns.TestAndSet(0, -1))
+  {
+    if (OnTaskRunning == ezOnTaskRunning::WaitTillFinished)
+    {
+      WaitForCondition([pTask]() { return pTask->IsTaskFinished(); });
+    }
+
+    return EZ_SUCCESS;
+  }
+
   // if we made it here, the task was already running
   // thus we just wait for it to finish
 
@@ -207,58 +437,73 @@ bool ezTaskSystem::HelpExecutingTasks(const ezTaskGroupID& WaitingForGroup)
   return ExecuteTask(FirstPriority, LastPriority, bOnlyTasksThatNeverWait, WaitingForGroup, nullptr);
 }
 
-void ezTaskSystem::ReprioritizeFrameTasks()
+static void MoveFrameTasks(ezList<ezTaskSystem::TaskData>* pTasks)
 {
   // There should usually be no 'this frame tasks' left at this time
   // however, while we waited to enter the lock, such tasks might have appeared
   // In this case we move them into the highest-priority 'this frame' queue, to ensure they will be executed asap
   for (ezUInt32 i = (ezUInt32)ezTaskPriority::ThisFrame; i <= (ezUInt32)ezTaskPriority::LateThisFrame; ++i)
   {
-    auto it = s_State->m_Tasks[i].GetIterator();
+    auto it = pTasks[i].GetIterator();
 
     // move all 'this frame' tasks into the 'early this frame' queue
     while (it.IsValid())
     {
-      s_State->m_Tasks[ezTaskPriority::EarlyThisFrame].PushBack(*it);
+      pTasks[ezTaskPriority::EarlyThisFrame].PushBack(*it);
 
       ++it;
     }
 
     // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    pTasks[i].Clear();
   }
 
   for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyNextFrame; i <= (ezUInt32)ezTaskPriority::LateNextFrame; ++i)
   {
-    auto it = s_State->m_Tasks[i].GetIterator();
+    auto it = pTasks[i].GetIterator();
 
     // move all 'next frame' tasks into the 'this frame' queues
     while (it.IsValid())
     {
-      s_State->m_Tasks[i - 3].PushBack(*it);
+      pTasks[i - 3].PushBack(*it);
 
       ++it;
     }
 
     // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    pTasks[i].Clear();
   }
 
   for (ezUInt32 i = (ezUInt32)ezTaskPriority::In2Frames; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
   {
-    auto it = s_State->m_Tasks[i].GetIterator();
+    auto it = pTasks[i].GetIterator();
 
     // move all 'in N frames' tasks into the 'in N-1 frames' queues
     // moves 'In2Frames' into 'LateNextFrame'
     while (it.IsValid())
     {
-      s_State->m_Tasks[i - 1].PushBack(*it);
+      pTasks[i - 1].PushBack(*it);
 
       ++it;
     }
 
     // remove the tasks from their current queue
-    s_State->m_Tasks[i].Clear();
+    pTasks[i].Clear();
+  }
+}
+
+void ezTaskSystem::ReprioritizeFrameTasks()
+{
+  MoveFrameTasks(s_State->m_Tasks);
+
+  for (ezUInt32 node = 0; node < ezSystemInformation::MaxNumaNodes; ++node)
+  {
+    MoveFrameTasks(s_State->m_NodeTasks[node]);
+  }
+
+  for (ezUInt32 i = (ezUInt32)ezTaskPriority::EarlyThisFrame; i <= (ezUInt32)ezTaskPriority::In9Frames; ++i)
+  {
+    s_State->UpdateNumSharedTasks(i);
   }
 }
 
@@ -2,8 +2,11 @@
 
 #include <Foundation/Logging/Log.h>
 #include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/Implementation/TaskFiber.h>
 #include <Foundation/Threading/Implementation/TaskSystemState.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 #include <Foundation/Threading/Implementation/TaskWorkerThread.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
 
 ezUInt32 ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::Enum type)
@@ -16,9 +19,9 @@ ezUInt32 ezTaskSystem::GetNumAllocatedWorkerThreads(ezWorkerThreadType::Enum typ
   return s_ThreadState->m_iAllocatedWorkers[type];
 }
 
-void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
+void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks, ezInt8 iFileAccessTasks)
 {
-  ezSystemInformation info = ezSystemInformation::Get();
+  const ezSystemInformation& info = ezSystemInformation::Get();
 
   // these settings are supposed to be a sensible default for most applications
   // an app can of course change that to optimize for its own usage
@@ -33,15 +36,20 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
   if (iLongTasks <= 0)
     iLongTasks = ezMath::Clamp<ezInt8>(iCpuCores - 2, 2, 8);
 
-  // plus there is always one additional 'file access' thread
+  // plus the 'file access' threads, 2 up to four cores, 4 on eight cores and up
+  // they mostly wait for I/O, but with several of them, multiple reads are in flight at the same time
   // and the main thread, of course
+  if (iFileAccessTasks <= 0)
+    iFileAccessTasks = ezMath::Clamp<ezInt8>(iCpuCores / 2, 2, 4);
 
   iShortTasks = ezMath::Max<ezInt8>(iShortTasks, 1);
   iLongTasks = ezMath::Max<ezInt8>(iLongTasks, 1);
+  iFileAccessTasks = ezMath::Min<ezInt8>(iFileAccessTasks, 64);
 
   // if nothing has changed, do nothing
   if (s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] == iShortTasks &&
-      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == iLongTasks)
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] == iLongTasks &&
+      s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] == iFileAccessTasks)
     return;
 
   StopWorkerThreads();
@@ -53,13 +61,181 @@ void ezTaskSystem::SetWorkerThreadCount(ezInt8 iShortTasks, ezInt8 iLongTasks)
 
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] = iShortTasks;
   s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks] = iLongTasks;
-  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = 1;
+  s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess] = iFileAccessTasks;
 
   AllocateThreads(ezWorkerThreadType::ShortTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks]);
   AllocateThreads(ezWorkerThreadType::LongTasks, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks]);
   AllocateThreads(ezWorkerThreadType::FileAccess, s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess]);
 }
 
+void ezTaskSystem::SetSchedulerMode(ezTaskSchedulerMode::Enum mode)
+{
+  if (s_State->m_SchedulerMode == mode)
+    return;
+
+  const ezUInt32 uiShortTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiLongTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks];
+  const ezUInt32 uiFileAccessTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess];
+
+  // the worker threads allocate their deques depending on the mode, so they all need to be recreated
+  StopWorkerThreads();
+
+  s_State->m_SchedulerMode = mode;
+
+  // if no threads were started yet, the default configuration is set up once the first task is started
+  if (uiShortTasks > 0)
+  {
+    SetWorkerThreadCount(static_cast<ezInt8>(uiShortTasks), static_cast<ezInt8>(uiLongTasks), static_cast<ezInt8>(uiFileAccessTasks));
+  }
+}
+
+ezTaskSchedulerMode::Enum ezTaskSystem::GetSchedulerMode()
+{
+  return s_State->m_SchedulerMode;
+}
+
+void ezTaskSystem::SetWorkerThreadAffinity(ezTaskWorkerAffinity::Enum affinity)
+{
+  if (s_ThreadState->m_WorkerAffinity == affinity)
+    return;
+
+  const ezUInt32 uiShortTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks];
+  const ezUInt32 uiLongTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::LongTasks];
+  const ezUInt32 uiFileAccessTasks = s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::FileAccess];
+
+  // the worker threads apply their affinity when they start, so they all need to be recreated
+  StopWorkerThreads();
+
+  s_ThreadState->m_WorkerAffinity = affinity;
+  ComputeWorkerCPUOrder();
+
+  // if no threads were started yet, the default configuration is set up once the first task is started
+  if (uiShortTasks > 0)
+  {
+    SetWorkerThreadCount(static_cast<ezInt8>(uiShortTasks), static_cast<ezInt8>(uiLongTasks), static_cast<ezInt8>(uiFileAccessTasks));
+  }
+}
+
+ezTaskWorkerAffinity::Enum ezTaskSystem::GetWorkerThreadAffinity()
+{
+  return s_ThreadState->m_WorkerAffinity;
+}
+
+void ezTaskSystem::SetUseNumaNodeQueues(bool bEnable)
+{
+  EZ_LOCK(s_TaskSystemMutex);
+
+  if (!bEnable)
+  {
+    // hand the remaining tasks over to the regular lists
+    for (ezUInt32 node = 0; node < ezSystemInformation::MaxNumaNodes; ++node)
+    {
+      for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+      {
+        for (auto it = s_State->m_NodeTasks[node][prio].GetIterator(); it.IsValid(); ++it)
+        {
+          s_State->m_Tasks[prio].PushBack(*it);
+        }
+
+        s_State->m_NodeTasks[node][prio].Clear();
+      }
+    }
+  }
+
+  s_State->m_bUseNumaNodeQueues = bEnable;
+}
+
+bool ezTaskSystem::GetUseNumaNodeQueues()
+{
+  return s_State->m_bUseNumaNodeQueues;
+}
+
+void ezTaskSystem::ComputeWorkerCPUOrder()
+{
+  const ezSystemInformation& info = ezSystemInformation::Get();
+  const ezUInt32 uiNumCPUs = info.GetLogicalCPUCount();
+
+  // for every CPU count how many CPUs with the same SMT index come before it on the same node
+  ezDynamicArray<ezUInt32> rankInNode;
+  rankInNode.SetCount(uiNumCPUs);
+
+  ezDynamicArray<ezUInt32>& order = s_ThreadState->m_WorkerCPUOrder;
+  order.SetCount(uiNumCPUs);
+
+  for (ezUInt32 i = 0; i < uiNumCPUs; ++i)
+  {
+    const ezSystemInformation::LogicalCPU& cpu = info.GetLogicalCPU(i);
+
+    for (ezUInt32 j = 0; j < i; ++j)
+    {
+      const ezSystemInformation::LogicalCPU& other = info.GetLogicalCPU(j);
+      if (other.m_uiNumaNode == cpu.m_uiNumaNode && other.m_uiSMTIndex == cpu.m_uiSMTIndex)
+        ++rankInNode[i];
+    }
+
+    order[i] = i;
+  }
+
+  // first one CPU of every physical core, alternating between the nodes, then the SMT siblings in the same fashion
+  order.Sort([&](ezUInt32 a, ezUInt32 b) -> bool {
+    const ezSystemInformation::LogicalCPU& cpuA = info.GetLogicalCPU(a);
+    const ezSystemInformation::LogicalCPU& cpuB = info.GetLogicalCPU(b);
+
+    if (cpuA.m_uiSMTIndex != cpuB.m_uiSMTIndex)
+      return cpuA.m_uiSMTIndex < cpuB.m_uiSMTIndex;
+
+    if (rankInNode[a] != rankInNode[b])
+      return rankInNode[a] < rankInNode[b];
+
+    return cpuA.m_uiNumaNode < cpuB.m_uiNumaNode;
+  });
+}
+
+ezInt32 ezTaskSystem::DetermineWorkerPlacement(ezWorkerThreadType::Enum ThreadType, ezUInt32 uiWorkerIndex, ezDynamicArray<ezUInt32>& out_CPUs)
+{
+  out_CPUs.Clear();
+
+  // file access threads mostly wait for I/O, there is no point in restricting them
+  if (ThreadType != ezWorkerThreadType::ShortTasks && ThreadType != ezWorkerThreadType::LongTasks)
+    return -1;
+
+  const ezSystemInformation& info = ezSystemInformation::Get();
+
+  switch (s_ThreadState->m_WorkerAffinity)
+  {
+    case ezTaskWorkerAffinity::NumaNode:
+    {
+      const ezUInt32 uiNode = uiWorkerIndex % info.GetNumaNodeCount();
+
+      for (ezUInt32 i = 0; i < info.GetLogicalCPUCount(); ++i)
+      {
+        if (info.GetLogicalCPU(i).m_uiNumaNode == uiNode)
+          out_CPUs.PushBack(info.GetLogicalCPU(i).m_uiCPUIndex);
+      }
+
+      return static_cast<ezInt32>(uiNode);
+    }
+
+    case ezTaskWorkerAffinity::PhysicalCore:
+    {
+      const ezDynamicArray<ezUInt32>& order = s_ThreadState->m_WorkerCPUOrder;
+
+      if (order.IsEmpty())
+        return -1;
+
+      // long task workers continue where the short task workers end, so that both types only share CPUs when there are not enough of them
+      const ezUInt32 uiFirstSlot = (ThreadType == ezWorkerThreadType::LongTasks) ? s_ThreadState->m_uiMaxWorkersToUse[ezWorkerThreadType::ShortTasks] : 0;
+      const ezSystemInformation::LogicalCPU& cpu = info.GetLogicalCPU(order[(uiFirstSlot + uiWorkerIndex) % order.GetCount()]);
+
+      out_CPUs.PushBack(cpu.m_uiCPUIndex);
+      return cpu.m_uiNumaNode;
+    }
+
+    default:
+      return -1;
+  }
+}
+
 void ezTaskSystem::StopWorkerThreads()
 {
   bool bWorkersStillRunning = true;
@@ -93,6 +269,37 @@ void ezTaskSystem::StopWorkerThreads()
     for (ezUInt32 i = 0; i < uiNumWorkers; ++i)
     {
       s_ThreadState->m_Workers[type][i]->Join();
+
+      // tasks that are still queued in a worker's deque must not get lost, put them back into the shared lists
+      {
+        EZ_LOCK(s_TaskSystemMutex);
+
+        for (ezUInt32 prio = 0; prio < ezTaskPriority::ENUM_COUNT; ++prio)
+        {
+          ezTaskWorkStealingDeque& localTasks = s_ThreadState->m_Workers[type][i]->GetLocalTasks(static_cast<ezTaskPriority::Enum>(prio));
+
+          TaskData td;
+          while (localTasks.PopBottom(td))
+          {
+            s_State->m_Tasks[prio].PushFront(td);
+          }
+
+          s_State->UpdateNumSharedTasks(prio);
+        }
+      }
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      {
+        // suspended fibers can only be continued by the worker that suspended them
+        EZ_LOCK(s_State->m_FiberMutex);
+
+        for (const ezTaskFiber* pFiber : s_State->m_AllFibers)
+        {
+          EZ_ASSERT_DEV(pFiber->m_pWorkerThread != s_ThreadState->m_Workers[type][i], "Worker threads must not be stopped while tasks are suspended on their fibers.");
+        }
+      }
+#endif
+
       EZ_DEFAULT_DELETE(s_ThreadState->m_Workers[type][i]);
     }
 
@@ -187,7 +394,12 @@ double ezTaskSystem::GetThreadUtilization(ezWorkerThreadType::Enum Type, ezUInt3
 
 void ezTaskSystem::DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority)
 {
-  switch (tl_TaskWorkerInfo.m_WorkerType)
+  DetermineTasksToExecuteForWorkerType(tl_TaskWorkerInfo.m_WorkerType, out_FirstPriority, out_LastPriority);
+}
+
+void ezTaskSystem::DetermineTasksToExecuteForWorkerType(ezWorkerThreadType::Enum ThreadType, ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority)
+{
+  switch (ThreadType)
   {
     case ezWorkerThreadType::MainThread:
     {
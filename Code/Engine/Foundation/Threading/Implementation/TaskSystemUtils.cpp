@@ -72,9 +72,27 @@ void ezTaskSystem::WriteStateSnapshotToDGML(ezDGMLGraph& graph)
   szTaskPriorityNames[ezTaskPriority::ThisFrameMainThread] = "ThisFrameMainThread";
   szTaskPriorityNames[ezTaskPriority::SomeFrameMainThread] = "SomeFrameMainThread";
 
-  for (ezUInt32 g = 0; g < s_State->m_TaskGroups.GetCount(); ++g)
+  ezDynamicArray<const ezTaskGroup*> taskGroups;
+
+  const ezUInt32 uiNumTaskGroups = s_State->m_iNumTaskGroupBlocks * ezTaskSystemState::TaskGroupBlockSize;
+
+  for (ezUInt32 g = 0; g < uiNumTaskGroups; ++g)
+  {
+    taskGroups.PushBack(GetTaskGroupByIndex(g));
+  }
+
+  {
+    EZ_LOCK(s_State->m_OverflowTaskGroupsMutex);
+
+    for (const ezTaskGroup* pGroup : s_State->m_OverflowTaskGroups)
+    {
+      taskGroups.PushBack(pGroup);
+    }
+  }
+
+  for (ezUInt32 g = 0; g < taskGroups.GetCount(); ++g)
   {
-    const ezTaskGroup& tg = s_State->m_TaskGroups[g];
+    const ezTaskGroup& tg = *taskGroups[g];
 
     if (!tg.m_bInUse)
       continue;
@@ -106,9 +124,9 @@ void ezTaskSystem::WriteStateSnapshotToDGML(ezDGMLGraph& graph)
     }
   }
 
-  for (ezUInt32 g = 0; g < s_State->m_TaskGroups.GetCount(); ++g)
+  for (const ezTaskGroup* pGroup : taskGroups)
   {
-    const ezTaskGroup& tg = s_State->m_TaskGroups[g];
+    const ezTaskGroup& tg = *pGroup;
 
     if (!tg.m_bInUse)
       continue;
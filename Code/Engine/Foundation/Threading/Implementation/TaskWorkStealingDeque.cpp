@@ -0,0 +1,133 @@
+#include <FoundationPCH.h>
+
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
+
+// This is the classic Chase-Lev deque. All ezAtomicInteger operations are full memory barriers,
+// which gives us the sequentially consistent ordering between 'bottom' and 'top' that the algorithm relies on.
+
+ezTaskWorkStealingDeque::ezTaskWorkStealingDeque() = default;
+ezTaskWorkStealingDeque::~ezTaskWorkStealingDeque() = default;
+
+void ezTaskWorkStealingDeque::SetCapacity(ezUInt32 uiCapacity)
+{
+  EZ_ASSERT_DEV(IsEmpty(), "The capacity of a work-stealing deque can only be changed while it is empty.");
+
+  m_iTop = 0;
+  m_iBottom = 0;
+
+  if (uiCapacity == 0)
+  {
+    m_uiMask = 0;
+    m_Slots.Clear();
+    m_Slots.Compact();
+    return;
+  }
+
+  uiCapacity = ezMath::PowerOfTwo_Ceil(uiCapacity);
+
+  m_Slots.Clear();
+  m_Slots.SetCount(uiCapacity);
+  m_uiMask = uiCapacity - 1;
+}
+
+bool ezTaskWorkStealingDeque::IsEmpty() const
+{
+  return m_iBottom <= m_iTop;
+}
+
+bool ezTaskWorkStealingDeque::PushBottom(const ezTaskSystem::TaskData& task)
+{
+  const ezInt64 b = m_iBottom;
+  const ezInt64 t = m_iTop;
+
+  // also fails when the deque is disabled, since the mask is zero then
+  if (b - t > static_cast<ezInt64>(m_uiMask) || m_uiMask == 0)
+    return false;
+
+  Slot& slot = m_Slots[static_cast<ezUInt32>(b & m_uiMask)];
+
+  // a thief that claimed the previous task in this slot may not have copied it yet
+  if (slot.m_bReserved)
+    return false;
+
+  slot.m_Task = task;
+  slot.m_bReserved = true;
+
+  // publish the task only after it has been written
+  m_iBottom.Set(b + 1);
+  return true;
+}
+
+bool ezTaskWorkStealingDeque::PopBottom(ezTaskSystem::TaskData& out_Task)
+{
+  if (m_uiMask == 0)
+    return false;
+
+  const ezInt64 b = m_iBottom - 1;
+  m_iBottom.Set(b);
+
+  const ezInt64 t = m_iTop;
+
+  if (t > b)
+  {
+    // the deque was empty, restore it
+    m_iBottom.Set(b + 1);
+    return false;
+  }
+
+  Slot& slot = m_Slots[static_cast<ezUInt32>(b & m_uiMask)];
+
+  if (t < b)
+  {
+    // more than one task was left, no thief can interfere with this one
+    out_Task = slot.m_Task;
+    slot.m_bReserved = false;
+    return true;
+  }
+
+  // this was the last task, race against the thieves for it
+  const bool bWon = m_iTop.TestAndSet(t, t + 1);
+  m_iBottom.Set(b + 1);
+
+  if (!bWon)
+    return false;
+
+  out_Task = slot.m_Task;
+  slot.m_bReserved = false;
+  return true;
+}
+
+bool ezTaskWorkStealingDeque::PeekBottom(ezTaskSystem::TaskData& out_Task) const
+{
+  const ezInt64 b = m_iBottom - 1;
+  const ezInt64 t = m_iTop;
+
+  if (m_uiMask == 0 || t > b)
+    return false;
+
+  // only the owner writes the tasks into the slots, so this can't observe a partially written task
+  out_Task = m_Slots[static_cast<ezUInt32>(b & m_uiMask)].m_Task;
+  return true;
+}
+
+bool ezTaskWorkStealingDeque::Steal(ezTaskSystem::TaskData& out_Task)
+{
+  const ezInt64 t = m_iTop;
+  const ezInt64 b = m_iBottom;
+
+  if (t >= b)
+    return false;
+
+  if (!m_iTop.TestAndSet(t, t + 1))
+    return false;
+
+  // the slot belongs to us now, it stays reserved until the task has been copied, so the owner can't overwrite it in the meantime,
+  // even if it already pushed enough tasks to wrap around
+  Slot& slot = m_Slots[static_cast<ezUInt32>(t & m_uiMask)];
+  out_Task = slot.m_Task;
+  slot.m_bReserved = false;
+  return true;
+}
+
+
+EZ_STATICLINK_FILE(Foundation, Foundation_Threading_Implementation_TaskWorkStealingDeque);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+/// \internal A fixed-capacity Chase-Lev work-stealing deque of scheduled tasks.
+///
+/// Exactly one thread (the owner) may call PushBottom(), PopBottom() and PeekBottom().
+/// Any thread may call Steal() concurrently, which takes tasks from the opposite end of the deque.
+/// The deque never grows. If it is full, PushBottom() fails and the caller has to put the task somewhere else.
+///
+/// A slot is only read by the thread that claimed it through 'top' or 'bottom', and it stays reserved until that thread has copied the
+/// task out of it. The owner never overwrites a reserved slot, so a thief that got delayed after claiming a slot can't read a task
+/// that is being written at the same time.
+class ezTaskWorkStealingDeque
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezTaskWorkStealingDeque);
+
+public:
+  ezTaskWorkStealingDeque();
+  ~ezTaskWorkStealingDeque();
+
+  /// \brief Allocates storage for \a uiCapacity tasks (rounded up to a power of two). Zero disables the deque.
+  ///
+  /// Must only be called while no other thread accesses the deque and the deque is empty.
+  void SetCapacity(ezUInt32 uiCapacity);
+
+  /// \brief Returns whether the deque has any storage, i.e. whether tasks can be pushed at all.
+  bool IsEnabled() const { return m_uiMask != 0; }
+
+  /// \brief Returns whether the deque appears to be empty. The result may be outdated by the time the function returns.
+  bool IsEmpty() const;
+
+  /// \brief Owner only: Adds a task at the bottom of the deque. Returns false, if the deque is full (or disabled),
+  /// or if the slot is still reserved by a thief that hasn't finished copying the task that it stole.
+  bool PushBottom(const ezTaskSystem::TaskData& task);
+
+  /// \brief Owner only: Removes the most recently pushed task. Returns false, if the deque is empty or the last task was stolen.
+  bool PopBottom(ezTaskSystem::TaskData& out_Task);
+
+  /// \brief Owner only: Returns the task that PopBottom() would return, without removing it.
+  ///
+  /// A subsequent call to PopBottom() either returns this task or fails, because it got stolen in between.
+  bool PeekBottom(ezTaskSystem::TaskData& out_Task) const;
+
+  /// \brief Any thread: Removes the oldest task from the deque. Returns false, if the deque is empty or another thread was faster.
+  bool Steal(ezTaskSystem::TaskData& out_Task);
+
+private:
+  // top and bottom are modified by different threads, keep them on separate cache lines to prevent false sharing
+  ezAtomicInteger64 m_iTop;
+  ezUInt8 m_Padding0[64 - sizeof(ezAtomicInteger64)];
+  ezAtomicInteger64 m_iBottom;
+  ezUInt8 m_Padding1[64 - sizeof(ezAtomicInteger64)];
+
+  struct Slot
+  {
+    ezTaskSystem::TaskData m_Task;
+    ezAtomicBool m_bReserved; ///< Set by the owner when it writes the task, cleared by whoever took the task once it has been copied.
+  };
+
+  ezUInt64 m_uiMask = 0;
+  ezDynamicArray<Slot> m_Slots;
+};
@@ -18,6 +18,22 @@ ezTaskWorkerThread::ezTaskWorkerThread(ezWorkerThreadType::Enum ThreadType, ezUI
 {
   m_WorkerType = ThreadType;
   m_uiWorkerThreadNumber = uiThreadNumber & 0xFFFF;
+  m_iNumaNode = ezTaskSystem::DetermineWorkerPlacement(m_WorkerType, uiThreadNumber, m_AffinityCPUs);
+
+  if (ezTaskSystem::GetSchedulerMode() == ezTaskSchedulerMode::WorkStealing)
+  {
+    ezTaskPriority::Enum FirstPriority;
+    ezTaskPriority::Enum LastPriority;
+    ezTaskSystem::DetermineTasksToExecuteForWorkerType(m_WorkerType, FirstPriority, LastPriority);
+
+    for (ezUInt32 prio = FirstPriority; prio <= (ezUInt32)LastPriority; ++prio)
+    {
+      if (ezTaskSystem::IsWorkStealingPriority(static_cast<ezTaskPriority::Enum>(prio)))
+      {
+        m_LocalTasks[prio].SetCapacity(256);
+      }
+    }
+  }
 }
 
 ezTaskWorkerThread::~ezTaskWorkerThread() = default;
@@ -47,6 +63,15 @@ ezUInt32 ezTaskWorkerThread::Run()
   tl_TaskWorkerInfo.m_WorkerType = m_WorkerType;
   tl_TaskWorkerInfo.m_iWorkerIndex = m_uiWorkerThreadNumber;
   tl_TaskWorkerInfo.m_pWorkerState = &m_WorkerState;
+  tl_TaskWorkerInfo.m_pLocalTasks = m_LocalTasks;
+  tl_TaskWorkerInfo.m_iNumaNode = m_iNumaNode;
+  tl_TaskWorkerInfo.m_pWorkerThread = this;
+
+  if (!m_AffinityCPUs.IsEmpty() && ezThreadUtils::SetCurrentThreadAffinity(m_AffinityCPUs).Failed())
+  {
+    // not fatal, the thread just runs wherever the OS puts it
+    m_AffinityCPUs.Clear();
+  }
 
   const bool bIsReserve = m_uiWorkerThreadNumber >= ezTaskSystem::s_ThreadState->m_uiMaxWorkersToUse[m_WorkerType];
 
@@ -83,6 +108,11 @@ ezUInt32 ezTaskWorkerThread::Run()
         // to the front of the list, because of the way ezTaskSystem::WakeUpThreads() works
         ezTaskSystem::WakeUpThreads(m_WorkerType, 1);
 
+        // a suspended fiber that only this thread can continue may have become ready while it was still active,
+        // in that case nobody is going to wake it up for it
+        if (m_iNumReadyFibers > 0 && m_WorkerState.CompareAndSwap((int)ezTaskWorkerState::Idle, (int)ezTaskWorkerState::Active) == (int)ezTaskWorkerState::Idle)
+          continue;
+
         WaitForWork();
       }
     }
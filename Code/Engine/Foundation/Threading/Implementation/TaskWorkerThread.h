@@ -1,6 +1,8 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
 #include <Foundation/Threading/Implementation/TaskSystemDeclarations.h>
+#include <Foundation/Threading/Implementation/TaskWorkStealingDeque.h>
 
 #include <Foundation/Threading/Thread.h>
 #include <Foundation/Threading/ThreadSignal.h>
@@ -31,6 +33,12 @@ private:
   // For display purposes.
   ezUInt16 m_uiWorkerThreadNumber = 0xFFFF;
 
+  // The NUMA node that this thread belongs to according to the worker affinity, -1 if none.
+  ezInt32 m_iNumaNode = -1;
+
+  // The logical CPUs that the thread is restricted to, empty if it may run anywhere.
+  ezDynamicArray<ezUInt32> m_AffinityCPUs;
+
   ///@}
 
   /// \name Thread Utilization
@@ -77,6 +85,34 @@ private:
   ezAtomicInteger32 m_WorkerState; // ezTaskWorkerState
 
   ///@}
+
+  /// \name Work Stealing
+  ///@{
+
+public:
+  /// \brief Returns the deque that holds the tasks of the given priority that were scheduled on this thread.
+  ezTaskWorkStealingDeque& GetLocalTasks(ezTaskPriority::Enum priority) { return m_LocalTasks[priority]; }
+
+private:
+  // only has storage in ezTaskSchedulerMode::WorkStealing and only for the priorities that this thread executes
+  ezTaskWorkStealingDeque m_LocalTasks[ezTaskPriority::ENUM_COUNT];
+
+  ///@}
+
+  /// \name Fibers
+  ///@{
+
+private:
+  friend class ezTaskSystem;
+
+  // Suspended fibers that this thread has to continue, because their group has finished. Guarded by ezTaskSystemState::m_FiberMutex.
+  // A fiber is always continued by the thread that suspended it, see ezTaskSystem::SetTaskWaitMode().
+  ezDeque<ezTaskFiber*> m_ReadyFibers;
+
+  // Mirrors m_ReadyFibers.GetCount(), so that the thread can skip the mutex when there is nothing to continue
+  ezAtomicInteger32 m_iNumReadyFibers;
+
+  ///@}
 };
 
 /// \internal Thread local state used by the task system (and for better debugging)
@@ -87,6 +123,10 @@ struct ezTaskWorkerInfo
   bool m_bAllowNestedTasks = true;
   const char* m_szTaskName = nullptr;
   ezAtomicInteger32* m_pWorkerState = nullptr;
+  ezTaskWorkStealingDeque* m_pLocalTasks = nullptr; // one deque per ezTaskPriority, only set on worker threads
+  ezTaskFiber* m_pCurrentFiber = nullptr;           // the fiber that is currently executing a task on this thread (ezTaskWaitMode::SuspendOnFibers)
+  ezTaskWorkerThread* m_pWorkerThread = nullptr;    // only set on worker threads
+  ezInt32 m_iNumaNode = -1;                         // the NUMA node that this worker belongs to, see ezTaskWorkerAffinity
 };
 
 extern thread_local ezTaskWorkerInfo tl_TaskWorkerInfo;
@@ -38,3 +38,28 @@ bool ezThreadUtils::IsMainThread()
   return GetCurrentThreadID() == g_uiMainThreadID;
 }
 
+ezResult ezThreadUtils::SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalCPUs)
+{
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+  // only the CPUs of the first processor group are addressable this way
+  DWORD_PTR uiMask = 0;
+
+  for (ezUInt32 uiCPU : logicalCPUs)
+  {
+    if (uiCPU < sizeof(DWORD_PTR) * 8)
+      uiMask |= static_cast<DWORD_PTR>(1) << uiCPU;
+  }
+
+  if (uiMask == 0)
+  {
+    DWORD_PTR uiSystemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &uiMask, &uiSystemMask))
+      return EZ_FAILURE;
+  }
+
+  return SetThreadAffinityMask(GetCurrentThread(), uiMask) != 0 ? EZ_SUCCESS : EZ_FAILURE;
+#else
+  return EZ_FAILURE;
+#endif
+}
+
@@ -87,6 +87,24 @@ private:
   /// \brief Executes some task of priority between \a FirstPriority and \a LastPriority (inclusive). Returns true, if any such task was available.
   static bool ExecuteTask(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
 
+  /// \brief Work-stealing counterpart of GetNextTask(). Prefers the calling worker's own deques, then the shared lists and finally steals from other workers.
+  static TaskData GetNextTaskWorkStealing(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, ezAtomicInteger32* pWorkerState);
+
+  /// \brief Searches the shared task lists of the given priority. Expects s_TaskSystemMutex to be locked.
+  ///
+  /// With per NUMA node queues, the list of the calling thread's node is searched first, then the list of tasks without a preference
+  /// and finally the lists of all other nodes.
+  static bool GetNextSharedTask(ezTaskPriority::Enum Priority, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Removes the first task from \a list that the calling thread may execute. Expects s_TaskSystemMutex to be locked.
+  static bool TakeTaskFromList(ezList<TaskData>& list, bool bOnlyTasksThatNeverWait, const ezTaskGroupID& WaitingForGroup, TaskData& out_Task);
+
+  /// \brief Tries to steal a task of the given priority from the deque of any worker thread.
+  static bool StealTask(ezTaskPriority::Enum Priority, TaskData& out_Task);
+
+  /// \brief Returns whether tasks of the given priority may be put into per-worker deques in ezTaskSchedulerMode::WorkStealing.
+  static bool IsWorkStealingPriority(ezTaskPriority::Enum Priority);
+
   /// \brief Called whenever a task has been finished/canceled. Makes sure that groups are marked as finished when all tasks are done.
   static void TaskHasFinished(ezTask* pTask, ezTaskGroup* pGroup);
 
@@ -101,6 +119,39 @@ private:
 
   ///@}
 
+  /// \name Fibers
+  ///@{
+
+private:
+  /// \brief Worker thread counterpart of ExecuteTask() for ezTaskWaitMode::SuspendOnFibers. Prefers continuing suspended tasks over starting new ones.
+  static bool ExecuteTaskOnFiber(ezTaskPriority::Enum FirstPriority, ezTaskPriority::Enum LastPriority, ezAtomicInteger32* pWorkerState);
+
+  /// \brief Switches into \a pFiber until its task finishes or waits. Then returns the fiber to the pool or registers it as waiting.
+  static void RunFiber(ezTaskFiber* pFiber);
+
+  /// \brief The entry function of all fibers. Executes one task after the other, suspending the fiber in between.
+  static void FiberMain(ezTaskFiber* pFiber);
+
+  /// \brief Called from inside a fiber by WaitForGroup(). Suspends the fiber until \a Group is finished.
+  static void SuspendFiberUntilFinished(ezTaskFiber* pFiber, const ezTaskGroupID& Group);
+
+  /// \brief Adds the suspended \a pFiber to the waiting fibers of its group. Returns false, if the group has already finished.
+  static bool AddWaitingFiber(ezTaskFiber* pFiber);
+
+  /// \brief Puts a list of fibers, linked through m_pNextWaitingFiber, into the ready lists and wakes up workers to continue them.
+  static void ScheduleReadyFibers(ezTaskFiber* pFirstFiber);
+
+  /// \brief Returns a suspended fiber that the given worker thread has to continue, or nullptr.
+  static ezTaskFiber* PopReadyFiber(ezTaskWorkerThread* pWorkerThread);
+
+  static ezTaskFiber* AcquireFiber();
+  static void ReleaseFiber(ezTaskFiber* pFiber);
+
+  /// \brief Deletes all fibers. Must only be called once all worker threads are stopped.
+  static void DestroyFibers();
+
+  ///@}
+
   /// \name Managing Task Groups
   ///@{
 
@@ -171,6 +222,30 @@ private:
   /// \brief Is called whenever a dependency of pGroup has finished. Once all dependencies are finished, the group's tasks will get scheduled.
   static void DependencyHasFinished(ezTaskGroup* pGroup);
 
+  /// \brief Links \a pDependent into the list of groups waiting for \a Dependency. Returns false, if \a Dependency has already finished.
+  static bool AddDependentGroup(const ezTaskGroupID& Dependency, ezTaskGroup* pDependent, ezUInt32 uiDependencyIndex);
+
+  /// \brief Same as AddDependentGroup(), for groups without an index, which can't be linked into the lock-free list.
+  static bool AddOverflowDependentGroup(const ezTaskGroupID& Dependency, ezTaskGroup* pDependent);
+
+  /// \brief Closes the list of dependent groups of the finished \a pGroup and notifies all groups that were in it.
+  static void NotifyDependentGroups(ezTaskGroup* pGroup, ezUInt32 uiGroupCounter);
+
+  /// \brief Pops an unused group from the lock-free free list. Allocates another block of groups, if none is available.
+  static ezTaskGroup* AcquireTaskGroup();
+
+  /// \brief Returns an unused group without an index, once all indices are taken. Allocates it on the heap, if necessary.
+  static ezTaskGroup* AcquireOverflowTaskGroup();
+
+  /// \brief Puts a finished group back onto the free list.
+  static void ReleaseTaskGroup(ezTaskGroup* pGroup);
+
+  /// \brief Allocates another block of groups and puts them onto the free list. Returns false, if all indices are taken already.
+  static bool AllocateTaskGroupBlock();
+
+  /// \brief Returns the group with the given ezTaskGroup::m_uiTaskGroupIndex.
+  static ezTaskGroup* GetTaskGroupByIndex(ezUInt32 uiIndex);
+
   ///@}
 
   /// \name Thread Management
@@ -180,15 +255,17 @@ public:
   /// \brief Sets the number of threads to use for the different task categories.
   ///
   /// \a uiShortTasks and \a uiLongTasks must be at least 1 and should not exceed the number of available CPU cores.
-  /// There will always be exactly one additional thread for file access tasks (ezTaskPriority::FileAccess).
+  /// There will always be at least one additional thread for file access tasks (ezTaskPriority::FileAccess).
+  /// By default two to four such threads are used, such that several reads can be in flight at the same time, which is what storage
+  /// like NVMe drives needs to reach its bandwidth. Set \a iFileAccessTasks to 1 to do all file accesses sequentially.
   ///
-  /// If \a uiShortTasks or \a uiLongTasks is smaller than 1, a default number of threads will be used for that type of work.
+  /// If \a uiShortTasks, \a uiLongTasks or \a iFileAccessTasks is smaller than 1, a default number of threads will be used for that type of work.
   /// This number of threads depends on the number of available CPU cores.
   /// If SetWorkThreadCount is never called, at all, the first time any task is started the number of worker threads is set to
   /// this default configuration.
   /// Unless you have a good idea how to set up the number of worker threads to make good use of the available cores,
   /// it is a good idea to just use the default settings.
-  static void SetWorkerThreadCount(ezInt8 iShortTasks = -1, ezInt8 iLongTasks = -1); // [tested]
+  static void SetWorkerThreadCount(ezInt8 iShortTasks = -1, ezInt8 iLongTasks = -1, ezInt8 iFileAccessTasks = -1); // [tested]
 
   /// \brief Returns the maximum number of threads that should work on the given type of task at the same time.
   static ezUInt32 GetWorkerThreadCount(ezWorkerThreadType::Enum type);
@@ -200,6 +277,52 @@ public:
   /// at runtime to prevent deadlocks and it can grow very, very large.
   static ezUInt32 GetNumAllocatedWorkerThreads(ezWorkerThreadType::Enum type);
 
+  /// \brief Switches between the shared, mutex-guarded task lists and per-worker work-stealing deques.
+  ///
+  /// This restarts all worker threads (keeping the configured number of threads), so it should only be called
+  /// at a time where no tasks are running, typically once at application startup.
+  /// In ezTaskSchedulerMode::WorkStealing, CancelTask() cannot remove tasks that already sit in a worker's deque.
+  /// It prevents their execution instead, the workers skip them once they get to them.
+  static void SetSchedulerMode(ezTaskSchedulerMode::Enum mode);
+
+  /// \brief Returns the mode that was set through SetSchedulerMode().
+  static ezTaskSchedulerMode::Enum GetSchedulerMode();
+
+  /// \brief Selects whether tasks on worker threads that wait for a group help executing other tasks or get suspended.
+  ///
+  /// With ezTaskWaitMode::SuspendOnFibers, worker threads run every task on a fiber with its own stack. When such a task calls
+  /// WaitForGroup(), the fiber is suspended and the worker continues with other tasks, instead of executing them recursively
+  /// on top of the waiting task or blocking. Once the group is finished, the waiting task is continued by the same worker thread
+  /// that suspended it, so locks that the task holds and thread local state stay valid across the call to WaitForGroup().
+  /// A worker only continues a suspended task once it finishes or suspends the task that it is currently executing.
+  /// The main thread and non-worker threads always use ezTaskWaitMode::HelpExecuting.
+  ///
+  /// If fibers are not supported on the current platform, the mode stays at ezTaskWaitMode::HelpExecuting.
+  /// This should only be called at a time where no tasks are running, typically once at application startup.
+  static void SetTaskWaitMode(ezTaskWaitMode::Enum mode);
+
+  /// \brief Returns the wait mode that is actually in use, see SetTaskWaitMode().
+  static ezTaskWaitMode::Enum GetTaskWaitMode();
+
+  /// \brief Selects on which CPUs the short and long task worker threads run. See ezTaskWorkerAffinity.
+  ///
+  /// This restarts all worker threads (keeping the configured number of threads), so it should only be called
+  /// at a time where no tasks are running, typically once at application startup.
+  static void SetWorkerThreadAffinity(ezTaskWorkerAffinity::Enum affinity);
+
+  /// \brief Returns the affinity that was set through SetWorkerThreadAffinity().
+  static ezTaskWorkerAffinity::Enum GetWorkerThreadAffinity();
+
+  /// \brief Enables separate task queues per NUMA node, for tasks that have a preferred node (see ezTask::SetPreferredNumaNode()).
+  ///
+  /// Worker threads that belong to a NUMA node (see SetWorkerThreadAffinity()) prefer tasks of their own node over
+  /// the tasks without a preference and only take tasks of other nodes when there is nothing else to do.
+  /// Tasks with a preferred node never go into the work-stealing deques of ezTaskSchedulerMode::WorkStealing.
+  static void SetUseNumaNodeQueues(bool bEnable);
+
+  /// \brief Returns whether per NUMA node task queues are used, see SetUseNumaNodeQueues().
+  static bool GetUseNumaNodeQueues();
+
   /// \brief Returns the (thread local) type of tasks that would be executed on this thread
   static ezWorkerThreadType::Enum GetCurrentThreadWorkerType();
 
@@ -224,6 +347,15 @@ private:
   /// \brief Uses a thread local variable to know the current thread type and to decide the range of task priorities that it may execute
   static void DetermineTasksToExecuteOnThread(ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority);
 
+  /// \brief Returns the range of task priorities that threads of the given type may execute
+  static void DetermineTasksToExecuteForWorkerType(ezWorkerThreadType::Enum ThreadType, ezTaskPriority::Enum& out_FirstPriority, ezTaskPriority::Enum& out_LastPriority);
+
+  /// \brief Returns the NUMA node of the given worker (or -1) according to the worker thread affinity and fills out the CPUs that it may run on.
+  static ezInt32 DetermineWorkerPlacement(ezWorkerThreadType::Enum ThreadType, ezUInt32 uiWorkerIndex, ezDynamicArray<ezUInt32>& out_CPUs);
+
+  /// \brief Sorts the logical CPUs into the order in which ezTaskWorkerAffinity::PhysicalCore assigns them to workers.
+  static void ComputeWorkerCPUOrder();
+
 private:
   static ezUniquePtr<ezTaskSystemThreadState> s_ThreadState;
 
@@ -257,10 +389,28 @@ public:
   template <typename ElemType, typename Callback>
   static void ParallelForSingleIndex(ezArrayPtr<ElemType> taskItems, Callback taskCallback, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
 
+  /// A helper function to combine all task items into a single value in a parallel fashion.
+  /// Every slice of items is accumulated into a partial result that starts out as 'identity', the partial results are then merged
+  /// with 'combineCallback'. Slices are handed out in no particular order, so the combination has to be associative and commutative.
+  /// The items are always distributed with ezParallelForPartitioning::Adaptive.
+  ///   - ParallelReduce(taskItems, identity, [](ezArrayPtr<ElemType> taskItemSlice, ResultType& inout_Result) { }, [](const ResultType& a, const ResultType& b) -> ResultType { });
+  template <typename ResultType, typename ElemType, typename RangeCallback, typename CombineCallback>
+  static ResultType ParallelReduce(ezArrayPtr<ElemType> taskItems, const ResultType& identity, RangeCallback rangeCallback, CombineCallback combineCallback, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
+
+  /// A helper function to compute the inclusive prefix sum of 'input' in a parallel fashion, i.e. out_Result[i] = input[0] + ... + input[i],
+  /// with 'combineCallback' taking the place of the addition. The combination has to be associative and 'identity' must not change a value.
+  /// 'input' and 'out_Result' must have the same size and may be the same array. 'input' may be a const or non-const array.
+  ///   - ParallelPrefixSum(input, output, identity, [](const ElemType& sum, const InputType& item) -> ElemType { });
+  template <typename ElemType, typename InputType, typename CombineCallback>
+  static void ParallelPrefixSum(ezArrayPtr<InputType> input, ezArrayPtr<ElemType> out_Result, const typename ezArrayPtr<ElemType>::ValueType& identity, CombineCallback combineCallback, const char* taskName = nullptr, const ezParallelForParams& params = ezParallelForParams());
+
 private:
   template <typename ElemType>
   static void ParallelForInternal(ezArrayPtr<ElemType> taskItems, ezParallelForFunction<ElemType> taskCallback, const char* taskName, const ezParallelForParams& config);
 
+  /// \brief Processes the items with ezParallelForPartitioning::Adaptive, starting out with uiNumRanges ranges (see ezParallelForParams::DetermineNumAdaptiveRanges()).
+  static void ParallelForAdaptive(ezUInt32 uiStartIndex, ezUInt32 uiNumItems, ezUInt32 uiNumRanges, ezParallelForRangeFunction taskCallback, const char* taskName, const ezParallelForParams& config);
+
   ///@}
 
   /// \name Utilities
@@ -25,6 +25,11 @@ public:
   /// \brief Returns an identifier for the currently running thread.
   static ezThreadID GetCurrentThreadID();
 
+  /// \brief Restricts the current thread to run only on the given logical CPUs (see ezSystemInformation::LogicalCPU::m_uiCPUIndex).
+  ///
+  /// An empty list allows the thread to run on all CPUs again. Returns failure, if thread affinities are not supported on this platform.
+  static ezResult SetCurrentThreadAffinity(ezArrayPtr<const ezUInt32> logicalCPUs);
+
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(Foundation, ThreadUtils);
 
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <Core/World/World.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+struct ezMsgUpdateLocalBounds;
+
+typedef ezComponentManager<class ezOccluderComponent, ezBlockStorageType::Compact> ezOccluderComponentManager;
+
+/// \brief Marks a box shaped volume as a software occluder.
+///
+/// Occluders in the view frustum are rasterized into a small CPU depth buffer before the visibility culling,
+/// and objects that are completely hidden behind them are skipped. The box should thus lie fully inside solid geometry,
+/// e.g. inside of a large wall or building, otherwise objects may be culled although parts of them would be visible.
+class EZ_RENDERERCORE_DLL ezOccluderComponent : public ezComponent
+{
+  EZ_DECLARE_COMPONENT_TYPE(ezOccluderComponent, ezComponent, ezOccluderComponentManager);
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezComponent
+
+public:
+  virtual void SerializeComponent(ezWorldWriter& stream) const override;
+  virtual void DeserializeComponent(ezWorldReader& stream) override;
+
+protected:
+  virtual void OnActivated() override;
+  virtual void OnDeactivated() override;
+
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezOccluderComponent
+
+public:
+  ezOccluderComponent();
+  ~ezOccluderComponent();
+
+  void SetExtents(const ezVec3& value); // [ property ]
+  const ezVec3& GetExtents() const;     // [ property ]
+
+  /// \brief Returns the box of the occluder in the local space of the owner object.
+  ezBoundingBox GetLocalBox() const;
+
+protected:
+  void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) const;
+
+  ezVec3 m_vExtents = ezVec3(1.0f);
+};
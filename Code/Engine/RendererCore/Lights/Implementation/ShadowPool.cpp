@@ -500,10 +500,11 @@ ezUInt32 ezShadowPool::AddDirectionalLight(const ezDirectionalLightComponent* pD
 
       camera.MoveLocally(0.0f, offset.x, offset.y);
     }
-
-    ezRenderWorld::AddViewToRender(shadowView.m_hView);
   }
 
+  // all cascades are culled together
+  ezRenderWorld::AddViewsToRender(pData->m_Views);
+
   return pData->m_uiPackedDataOffset;
 }
 
@@ -565,10 +566,11 @@ ezUInt32 ezShadowPool::AddPointLight(const ezPointLightComponent* pPointLight, f
       camera.LookAt(vPosition, vPosition + vForward, vUp);
       camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, fFov, fNearPlane, fFarPlane);
     }
-
-    ezRenderWorld::AddViewToRender(shadowView.m_hView);
   }
 
+  // all faces are culled together
+  ezRenderWorld::AddViewsToRender(pData->m_Views);
+
   return pData->m_uiPackedDataOffset;
 }
 
@@ -12,6 +12,9 @@ public:
 
   ezExtractedRenderData();
 
+  /// \brief Allocates the render data arrays from the given allocator, e.g. the frame allocator for temporary per-thread buffers.
+  explicit ezExtractedRenderData(ezAllocatorBase* pAllocator);
+
   EZ_ALWAYS_INLINE void SetCamera(const ezCamera& camera)
   {
     m_Camera = camera;
@@ -65,6 +68,15 @@ public:
   void AddRenderData(const ezRenderData* pRenderData, ezRenderData::Category category);
   void AddFrameData(const ezRenderData* pFrameData);
 
+  /// \brief Appends all render data of \a other as if it had been added to this one directly. Frame data is not merged.
+  ///
+  /// Used to combine the buffers that render data was extracted into on several threads. The sorting keys are taken over as they are,
+  /// so \a other needs to use the same camera.
+  void MergeRenderData(const ezExtractedRenderData& other);
+
+  /// \brief Sorts the render data of every category by sorting key and batch id and groups it into batches.
+  ///
+  /// Large categories are sorted with a radix sort and several categories are processed in parallel.
   void SortAndBatch();
 
   void Clear();
@@ -81,12 +93,42 @@ private:
 
   const ezRenderData* GetFrameData(const ezRTTI* pRtti) const;
 
+  struct SortKey
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt64 m_uiSortingKey;
+    ezUInt32 m_uiBatchId;
+    ezUInt32 m_uiIndex; ///< Index into DataPerCategory::m_AddedRenderData
+  };
+
+  struct AddedRenderData
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const ezRenderData* m_pRenderData;
+    const ezRTTI* m_pRenderDataType;
+  };
+
   struct DataPerCategory
   {
+    DataPerCategory(ezAllocatorBase* pAllocator);
+
     ezDynamicArray< ezRenderDataBatch > m_Batches;
-    ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData;
+    ezDynamicArray< ezRenderDataBatch::SortableRenderData > m_SortableRenderData; ///< In sorted order, referenced by the batches.
+
+    ezDynamicArray< AddedRenderData > m_AddedRenderData; ///< In the order the data was added.
+    ezDynamicArray< SortKey > m_SortKeys;
+    ezDynamicArray< SortKey > m_SortKeysScratch;
   };
 
+  DataPerCategory& GetDataPerCategory(ezRenderData::Category category);
+
+  static void SortAndBatchCategory(DataPerCategory& dataPerCategory);
+  static void RadixSort(ezDynamicArray<SortKey>& keys, ezDynamicArray<SortKey>& scratch);
+
+  ezAllocatorBase* m_pAllocator;
+
   ezCamera m_Camera;
   ezViewData m_ViewData;
   ezTime m_WorldTime;
@@ -2,6 +2,7 @@
 
 #include <RendererCore/Pipeline/RenderData.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/AtomicInteger.h>
 
 class EZ_RENDERERCORE_DLL ezExtractor : public ezReflectedClass
 {
@@ -30,6 +31,8 @@ protected:
   bool FilterByViewTags(const ezView& view, const ezGameObject* pObject) const;
 
   /// \brief extracts the render data for the given object.
+  ///
+  /// Can be called from several threads at once as long as every thread uses its own \a msg and \a extractedRenderData.
   void ExtractRenderData(const ezView& view, const ezGameObject* pObject, ezMsgExtractRenderData& msg, ezExtractedRenderData& extractedRenderData) const;
 
 private:
@@ -43,8 +46,8 @@ protected:
   ezHybridArray<ezHashedString, 4> m_DependsOn;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  mutable ezUInt32 m_uiNumCachedRenderData;
-  mutable ezUInt32 m_uiNumUncachedRenderData;
+  mutable ezAtomicInteger32 m_NumCachedRenderData;
+  mutable ezAtomicInteger32 m_NumUncachedRenderData;
 #endif
 };
 
@@ -55,8 +58,17 @@ class EZ_RENDERERCORE_DLL ezVisibleObjectsExtractor : public ezExtractor
 public:
   ezVisibleObjectsExtractor(const char* szName = "VisibleObjectsExtractor");
 
+  /// \brief Extracts the render data of all visible objects.
+  ///
+  /// When the CVar r_ParallelExtraction is enabled, large numbers of objects are split into chunks that are extracted in parallel, each
+  /// into its own buffer allocated from the frame allocator. The buffers are merged into \a extractedRenderData in chunk order afterwards,
+  /// so the result is the same as with serial extraction. This requires all ezMsgExtractRenderData handlers to be thread-safe, which is
+  /// why it is disabled by default. Debug visualization is always done on the calling thread.
   virtual void Extract(const ezView& view, const ezDynamicArray<const ezGameObject*>& visibleObjects,
     ezExtractedRenderData& extractedRenderData) override;
+
+private:
+  void ExtractObjects(const ezView& view, ezArrayPtr<const ezGameObject* const> objects, ezExtractedRenderData& extractedRenderData) const;
 };
 
 class EZ_RENDERERCORE_DLL ezSelectedObjectsExtractor : public ezExtractor
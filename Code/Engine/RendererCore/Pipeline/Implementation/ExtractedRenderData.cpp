@@ -1,17 +1,41 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
-ezExtractedRenderData::ezExtractedRenderData() {}
+ezExtractedRenderData::DataPerCategory::DataPerCategory(ezAllocatorBase* pAllocator)
+  : m_Batches(pAllocator)
+  , m_SortableRenderData(pAllocator)
+  , m_AddedRenderData(pAllocator)
+  , m_SortKeys(pAllocator)
+  , m_SortKeysScratch(pAllocator)
+{
+}
+
+ezExtractedRenderData::ezExtractedRenderData()
+  : m_pAllocator(ezFoundation::GetDefaultAllocator())
+{
+}
+
+ezExtractedRenderData::ezExtractedRenderData(ezAllocatorBase* pAllocator)
+  : m_pAllocator(pAllocator)
+{
+}
 
 void ezExtractedRenderData::AddRenderData(const ezRenderData* pRenderData, ezRenderData::Category category)
 {
-  m_DataPerCategory.EnsureCount(category.m_uiValue + 1);
+  auto& dataPerCategory = GetDataPerCategory(category);
+
+  auto& sortKey = dataPerCategory.m_SortKeys.ExpandAndGetRef();
+  sortKey.m_uiSortingKey = pRenderData->GetCategorySortingKey(category, m_Camera);
+  sortKey.m_uiBatchId = pRenderData->m_uiBatchId;
+  sortKey.m_uiIndex = dataPerCategory.m_AddedRenderData.GetCount();
 
-  auto& sortableRenderData = m_DataPerCategory[category.m_uiValue].m_SortableRenderData.ExpandAndGetRef();
-  sortableRenderData.m_pRenderData = pRenderData;
-  sortableRenderData.m_uiSortingKey = pRenderData->GetCategorySortingKey(category, m_Camera);
+  // the type is needed to split the batches, querying it here keeps the batching loop free of virtual calls
+  auto& addedRenderData = dataPerCategory.m_AddedRenderData.ExpandAndGetRef();
+  addedRenderData.m_pRenderData = pRenderData;
+  addedRenderData.m_pRenderDataType = pRenderData->GetDynamicRTTI();
 }
 
 void ezExtractedRenderData::AddFrameData(const ezRenderData* pFrameData)
@@ -19,54 +43,187 @@ void ezExtractedRenderData::AddFrameData(const ezRenderData* pFrameData)
   m_FrameData.PushBack(pFrameData);
 }
 
+void ezExtractedRenderData::MergeRenderData(const ezExtractedRenderData& other)
+{
+  for (ezUInt32 uiCategory = 0; uiCategory < other.m_DataPerCategory.GetCount(); ++uiCategory)
+  {
+    const auto& otherData = other.m_DataPerCategory[uiCategory];
+    if (otherData.m_SortKeys.IsEmpty())
+      continue;
+
+    auto& dataPerCategory = GetDataPerCategory(ezRenderData::Category(static_cast<ezUInt16>(uiCategory)));
+
+    const ezUInt32 uiIndexOffset = dataPerCategory.m_AddedRenderData.GetCount();
+    dataPerCategory.m_AddedRenderData.PushBackRange(otherData.m_AddedRenderData.GetArrayPtr());
+
+    const ezUInt32 uiFirstKey = dataPerCategory.m_SortKeys.GetCount();
+    dataPerCategory.m_SortKeys.PushBackRange(otherData.m_SortKeys.GetArrayPtr());
+
+    for (ezUInt32 i = uiFirstKey; i < dataPerCategory.m_SortKeys.GetCount(); ++i)
+    {
+      dataPerCategory.m_SortKeys[i].m_uiIndex += uiIndexOffset;
+    }
+  }
+}
+
 void ezExtractedRenderData::SortAndBatch()
 {
   EZ_PROFILE_SCOPE("SortAndBatch");
 
-  struct RenderDataComparer
+  ezUInt32 uiNumRenderData = 0;
+  ezUInt32 uiNumCategoriesWithData = 0;
+
+  for (auto& dataPerCategory : m_DataPerCategory)
   {
-    EZ_FORCE_INLINE bool Less(const ezRenderDataBatch::SortableRenderData& a, const ezRenderDataBatch::SortableRenderData& b) const
+    if (!dataPerCategory.m_SortKeys.IsEmpty())
     {
-      if (a.m_uiSortingKey == b.m_uiSortingKey)
-      {
-        return a.m_pRenderData->m_uiBatchId < b.m_pRenderData->m_uiBatchId;
-      }
+      uiNumRenderData += dataPerCategory.m_SortKeys.GetCount();
+      ++uiNumCategoriesWithData;
+    }
+  }
+
+  // spreading the categories over several threads only pays off if there is enough work
+  static const ezUInt32 uiMinRenderDataForParallelSort = 4096;
 
-      return a.m_uiSortingKey < b.m_uiSortingKey;
+  if (uiNumCategoriesWithData > 1 && uiNumRenderData >= uiMinRenderDataForParallelSort)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.partitioning = ezParallelForPartitioning::Adaptive;
+
+    ezTaskSystem::ParallelForSingle(m_DataPerCategory.GetArrayPtr(), [](DataPerCategory& dataPerCategory) { SortAndBatchCategory(dataPerCategory); },
+      "SortAndBatch", params);
+  }
+  else
+  {
+    for (auto& dataPerCategory : m_DataPerCategory)
+    {
+      SortAndBatchCategory(dataPerCategory);
     }
-  };
+  }
+}
 
-  for (auto& dataPerCategory : m_DataPerCategory)
+void ezExtractedRenderData::SortAndBatchCategory(DataPerCategory& dataPerCategory)
+{
+  auto& keys = dataPerCategory.m_SortKeys;
+  if (keys.IsEmpty())
+    return;
+
+  // below this size the histogram passes of the radix sort cost more than they save
+  static const ezUInt32 uiMinRenderDataForRadixSort = 256;
+
+  if (keys.GetCount() < uiMinRenderDataForRadixSort)
   {
-    if (dataPerCategory.m_SortableRenderData.IsEmpty())
-      continue;
+    // same order as the stable radix sort
+    keys.Sort([](const SortKey& a, const SortKey& b) -> bool {
+      if (a.m_uiSortingKey != b.m_uiSortingKey)
+        return a.m_uiSortingKey < b.m_uiSortingKey;
+
+      if (a.m_uiBatchId != b.m_uiBatchId)
+        return a.m_uiBatchId < b.m_uiBatchId;
+
+      return a.m_uiIndex < b.m_uiIndex;
+    });
+  }
+  else
+  {
+    RadixSort(keys, dataPerCategory.m_SortKeysScratch);
+  }
 
-    auto& data = dataPerCategory.m_SortableRenderData;
+  // Gather the render data in sorted order and find batches. Only the sort keys and the cached types are accessed here,
+  // the render data itself is not touched.
+  const ezUInt32 uiCount = keys.GetCount();
+  const AddedRenderData* pAddedRenderData = dataPerCategory.m_AddedRenderData.GetData();
 
-    // Sort
-    data.Sort(RenderDataComparer());
+  auto& data = dataPerCategory.m_SortableRenderData;
+  data.SetCountUninitialized(uiCount);
+
+  ezUInt32 uiCurrentBatchId = keys[0].m_uiBatchId;
+  ezUInt32 uiCurrentBatchStartIndex = 0;
+  const ezRTTI* pCurrentBatchType = pAddedRenderData[keys[0].m_uiIndex].m_pRenderDataType;
+
+  for (ezUInt32 i = 0; i < uiCount; ++i)
+  {
+    const SortKey& key = keys[i];
+    const AddedRenderData& addedRenderData = pAddedRenderData[key.m_uiIndex];
 
-    // Find batches
-    ezUInt32 uiCurrentBatchId = data[0].m_pRenderData->m_uiBatchId;
-    ezUInt32 uiCurrentBatchStartIndex = 0;
-    const ezRTTI* pCurrentBatchType = data[0].m_pRenderData->GetDynamicRTTI();
+    data[i].m_pRenderData = addedRenderData.m_pRenderData;
+    data[i].m_uiSortingKey = key.m_uiSortingKey;
 
-    for (ezUInt32 i = 1; i < data.GetCount(); ++i)
+    if (key.m_uiBatchId != uiCurrentBatchId || addedRenderData.m_pRenderDataType != pCurrentBatchType)
     {
-      auto pRenderData = data[i].m_pRenderData;
+      dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
 
-      if (pRenderData->m_uiBatchId != uiCurrentBatchId || pRenderData->GetDynamicRTTI() != pCurrentBatchType)
-      {
-        dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], i - uiCurrentBatchStartIndex);
+      uiCurrentBatchId = key.m_uiBatchId;
+      uiCurrentBatchStartIndex = i;
+      pCurrentBatchType = addedRenderData.m_pRenderDataType;
+    }
+  }
 
-        uiCurrentBatchId = pRenderData->m_uiBatchId;
-        uiCurrentBatchStartIndex = i;
-        pCurrentBatchType = pRenderData->GetDynamicRTTI();
-      }
+  dataPerCategory.m_Batches.ExpandAndGetRef().m_Data = ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], uiCount - uiCurrentBatchStartIndex);
+}
+
+void ezExtractedRenderData::RadixSort(ezDynamicArray<SortKey>& keys, ezDynamicArray<SortKey>& scratch)
+{
+  // LSD radix sort over the 96 bit key (sorting key, batch id) with 8 bit digits, least significant digits of the batch id first
+  static const ezUInt32 uiNumPasses = 12;
+
+  auto GetDigit = [](const SortKey& key, ezUInt32 uiPass) -> ezUInt32 {
+    if (uiPass < 4)
+      return (key.m_uiBatchId >> (uiPass * 8)) & 0xFF;
+
+    return static_cast<ezUInt32>(key.m_uiSortingKey >> ((uiPass - 4) * 8)) & 0xFF;
+  };
+
+  const ezUInt32 uiCount = keys.GetCount();
+
+  // all histograms are built in a single pass over the data
+  ezUInt32 histograms[uiNumPasses][256];
+  ezMemoryUtils::ZeroFill(&histograms[0][0], uiNumPasses * 256);
+
+  for (const SortKey& key : keys)
+  {
+    for (ezUInt32 uiPass = 0; uiPass < uiNumPasses; ++uiPass)
+    {
+      ++histograms[uiPass][GetDigit(key, uiPass)];
     }
+  }
+
+  scratch.SetCountUninitialized(uiCount);
 
-    dataPerCategory.m_Batches.ExpandAndGetRef().m_Data =
-        ezMakeArrayPtr(&data[uiCurrentBatchStartIndex], data.GetCount() - uiCurrentBatchStartIndex);
+  SortKey* pSrc = keys.GetData();
+  SortKey* pDst = scratch.GetData();
+  bool bResultInScratch = false;
+
+  for (ezUInt32 uiPass = 0; uiPass < uiNumPasses; ++uiPass)
+  {
+    ezUInt32* pHistogram = histograms[uiPass];
+
+    // typically most of the digits are the same for all keys, e.g. the upper bytes of small batch ids
+    if (pHistogram[GetDigit(pSrc[0], uiPass)] == uiCount)
+      continue;
+
+    // convert the histogram into start offsets
+    ezUInt32 uiOffset = 0;
+    for (ezUInt32 uiDigit = 0; uiDigit < 256; ++uiDigit)
+    {
+      const ezUInt32 uiDigitCount = pHistogram[uiDigit];
+      pHistogram[uiDigit] = uiOffset;
+      uiOffset += uiDigitCount;
+    }
+
+    for (ezUInt32 i = 0; i < uiCount; ++i)
+    {
+      pDst[pHistogram[GetDigit(pSrc[i], uiPass)]++] = pSrc[i];
+    }
+
+    ezMath::Swap(pSrc, pDst);
+    bResultInScratch = !bResultInScratch;
+  }
+
+  if (bResultInScratch)
+  {
+    keys.Swap(scratch);
   }
 }
 
@@ -76,6 +233,8 @@ void ezExtractedRenderData::Clear()
   {
     dataPerCategory.m_Batches.Clear();
     dataPerCategory.m_SortableRenderData.Clear();
+    dataPerCategory.m_AddedRenderData.Clear();
+    dataPerCategory.m_SortKeys.Clear();
   }
 
   m_FrameData.Clear();
@@ -83,6 +242,17 @@ void ezExtractedRenderData::Clear()
   // TODO: intelligent compact
 }
 
+ezExtractedRenderData::DataPerCategory& ezExtractedRenderData::GetDataPerCategory(ezRenderData::Category category)
+{
+  // not EnsureCount, the arrays of new categories have to use our allocator
+  while (m_DataPerCategory.GetCount() <= category.m_uiValue)
+  {
+    m_DataPerCategory.PushBack(DataPerCategory(m_pAllocator));
+  }
+
+  return m_DataPerCategory[category.m_uiValue];
+}
+
 ezRenderDataBatchList ezExtractedRenderData::GetRenderDataBatchesWithCategory(ezRenderData::Category category,
                                                                               ezRenderDataBatch::Filter filter) const
 {
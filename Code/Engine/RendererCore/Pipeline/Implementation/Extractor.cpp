@@ -5,10 +5,16 @@
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <Core/World/World.h>
+#include <Core/World/SpatialSystem_LooseOctree.h>
 #include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Foundation/Configuration/CVar.h>
+#include <Foundation/Memory/FrameAllocator.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
+ezCVarBool CVarParallelExtraction("r_ParallelExtraction", false, ezCVarFlags::Default, "Extracts the render data of many visible objects on several threads. All extract message handlers must be thread-safe when this is enabled.");
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezCVarBool CVarVisBounds("r_VisBounds", false, ezCVarFlags::Default, "Enables debug visualization of object bounds");
   ezCVarBool CVarVisLocalBBox("r_VisLocalBBox", false, ezCVarFlags::Default, "Enables debug visualization of object local bounding box");
@@ -22,23 +28,30 @@
 
 namespace
 {
+  // small enough to balance the load between the threads, large enough to keep the merge cheap
+  static const ezUInt32 s_uiNumObjectsPerExtractionChunk = 512;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   void VisualizeSpatialData(const ezView& view)
   {
     if (CVarVisSpatialData && CVarVisObjectName.GetValue().IsEmpty() && !CVarVisObjectSelection)
     {
       const ezSpatialSystem& spatialSystem = *view.GetWorld()->GetSpatialSystem();
+      ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
+      ezHybridArray<ezBoundingBox, 16> boxes;
+
       if (auto pSpatialSystemGrid = ezDynamicCast<const ezSpatialSystem_RegularGrid*>(&spatialSystem))
       {
-        ezSpatialData::Category filterCategory = ezSpatialData::FindCategory(CVarVisSpatialCategory.GetValue());
-
-        ezHybridArray<ezBoundingBox, 16> boxes;
         pSpatialSystemGrid->GetAllCellBoxes(boxes, filterCategory);
+      }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        pSpatialSystemOctree->GetAllNodeBoxes(boxes, filterCategory);
+      }
 
-        for (auto& box : boxes)
-        {
-          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
-        }
+      for (auto& box : boxes)
+      {
+        ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
       }
     }
   }
@@ -70,13 +83,21 @@ namespace
     if (CVarVisSpatialData && CVarVisSpatialCategory.GetValue().IsEmpty())
     {
       const ezSpatialSystem& spatialSystem = *view.GetWorld()->GetSpatialSystem();
+      ezBoundingBox box;
+      ezResult res = EZ_FAILURE;
+
       if (auto pSpatialSystemGrid = ezDynamicCast<const ezSpatialSystem_RegularGrid*>(&spatialSystem))
       {
-        ezBoundingBox box;
-        if (pSpatialSystemGrid->GetCellBoxForSpatialData(pObject->GetSpatialData(), box).Succeeded())
-        {
-          ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
-        }
+        res = pSpatialSystemGrid->GetCellBoxForSpatialData(pObject->GetSpatialData(), box);
+      }
+      else if (auto pSpatialSystemOctree = ezDynamicCast<const ezSpatialSystem_LooseOctree*>(&spatialSystem))
+      {
+        res = pSpatialSystemOctree->GetNodeBoxForSpatialData(pObject->GetSpatialData(), box);
+      }
+
+      if (res.Succeeded())
+      {
+        ezDebugRenderer::DrawLineBox(view.GetHandle(), box, ezColor::Cyan);
       }
     }
   }
@@ -107,8 +128,8 @@ ezExtractor::ezExtractor(const char* szName)
   m_sName.Assign(szName);
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  m_uiNumCachedRenderData = 0;
-  m_uiNumUncachedRenderData = 0;
+  m_NumCachedRenderData = 0;
+  m_NumUncachedRenderData = 0;
 #endif
 }
 
@@ -234,8 +255,11 @@ void ezExtractor::ExtractRenderData(const ezView& view, const ezGameObject* pObj
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-  m_uiNumCachedRenderData += msg.m_ExtractedRenderData.GetCount() - uiNumUncachedRenderData;
-  m_uiNumUncachedRenderData += uiNumUncachedRenderData;
+  const ezUInt32 uiNumCachedRenderData = msg.m_ExtractedRenderData.GetCount() - uiNumUncachedRenderData;
+  if (uiNumCachedRenderData > 0)
+    m_NumCachedRenderData.Add(uiNumCachedRenderData);
+  if (uiNumUncachedRenderData > 0)
+    m_NumUncachedRenderData.Add(uiNumUncachedRenderData);
 #endif
 }
 
@@ -263,35 +287,76 @@ ezVisibleObjectsExtractor::ezVisibleObjectsExtractor(const char* szName)
 void ezVisibleObjectsExtractor::Extract(const ezView& view, const ezDynamicArray<const ezGameObject*>& visibleObjects,
   ezExtractedRenderData& extractedRenderData)
 {
-  ezMsgExtractRenderData msg;
-  msg.m_pView = &view;
-
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
   #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
     VisualizeSpatialData(view);
 
-    m_uiNumCachedRenderData = 0;
-    m_uiNumUncachedRenderData = 0;
+    m_NumCachedRenderData = 0;
+    m_NumUncachedRenderData = 0;
   #endif
 
-  for (auto pObject : visibleObjects)
+  const ezUInt32 uiNumObjects = visibleObjects.GetCount();
+  const ezUInt32 uiNumChunks = (uiNumObjects + s_uiNumObjectsPerExtractionChunk - 1) / s_uiNumObjectsPerExtractionChunk;
+
+  if (uiNumChunks <= 1 || !CVarParallelExtraction)
   {
-    ExtractRenderData(view, pObject, msg, extractedRenderData);
+    ExtractObjects(view, visibleObjects.GetArrayPtr(), extractedRenderData);
+  }
+  else
+  {
+    EZ_PROFILE_SCOPE("Parallel Extraction");
 
-    #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
-      if (CVarVisBounds || CVarVisLocalBBox || CVarVisSpatialData)
-      {
-        if ((CVarVisObjectName.GetValue().IsEmpty() || ezStringUtils::FindSubString_NoCase(pObject->GetName(), CVarVisObjectName.GetValue()) != nullptr) &&
-          !CVarVisObjectSelection)
+    // The read marker of the world is held by this thread for the whole time, the workers only read from the world.
+    // Every chunk gets its own buffer, so neither the message nor the render data arrays are shared between threads.
+    // The remaining shared state is the frame allocator and ezRenderWorld::CacheRenderData which both lock internally.
+    ezAllocatorBase* pAllocator = ezFrameAllocator::GetCurrentAllocator();
+    ezDynamicArray<ezExtractedRenderData*> chunkRenderData(pAllocator);
+    chunkRenderData.SetCount(uiNumChunks);
+
+    for (ezUInt32 uiChunk = 0; uiChunk < uiNumChunks; ++uiChunk)
+    {
+      chunkRenderData[uiChunk] = EZ_NEW(pAllocator, ezExtractedRenderData, pAllocator);
+      chunkRenderData[uiChunk]->SetCamera(extractedRenderData.GetCamera());
+    }
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.partitioning = ezParallelForPartitioning::Adaptive;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumChunks,
+      [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+        for (ezUInt32 uiChunk = uiStartChunk; uiChunk < uiEndChunk; ++uiChunk)
         {
-          VisualizeObject(view, pObject);
+          const ezUInt32 uiFirstObject = uiChunk * s_uiNumObjectsPerExtractionChunk;
+          const ezUInt32 uiChunkSize = ezMath::Min(s_uiNumObjectsPerExtractionChunk, uiNumObjects - uiFirstObject);
+
+          ExtractObjects(view, visibleObjects.GetArrayPtr().GetSubArray(uiFirstObject, uiChunkSize), *chunkRenderData[uiChunk]);
         }
-      }
-    #endif
+      },
+      "Extract Render Data", params);
+
+    for (ezExtractedRenderData* pChunkRenderData : chunkRenderData)
+    {
+      extractedRenderData.MergeRenderData(*pChunkRenderData);
+      EZ_DELETE(pAllocator, pChunkRenderData);
+    }
   }
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  // The debug visualization is always done on this thread, it reads the spatial system which is not meant to be used from workers
+  if (CVarVisBounds || CVarVisLocalBBox || CVarVisSpatialData)
+  {
+    for (auto pObject : visibleObjects)
+    {
+      if ((CVarVisObjectName.GetValue().IsEmpty() || ezStringUtils::FindSubString_NoCase(pObject->GetName(), CVarVisObjectName.GetValue()) != nullptr) &&
+        !CVarVisObjectSelection)
+      {
+        VisualizeObject(view, pObject);
+      }
+    }
+  }
+
   const bool bIsMainView = (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
 
   if (CVarExtractionStats && bIsMainView)
@@ -302,15 +367,27 @@ void ezVisibleObjectsExtractor::Extract(const ezView& view, const ezDynamicArray
 
     ezDebugRenderer::Draw2DText(hView, "Extraction Stats", ezVec2I32(10, 200), ezColor::LimeGreen);
 
-    sb.Format("Num Cached Render Data: {0}", m_uiNumCachedRenderData);
+    sb.Format("Num Cached Render Data: {0}", (ezInt32)m_NumCachedRenderData);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 220), ezColor::LimeGreen);
 
-    sb.Format("Num Uncached Render Data: {0}", m_uiNumUncachedRenderData);
+    sb.Format("Num Uncached Render Data: {0}", (ezInt32)m_NumUncachedRenderData);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 240), ezColor::LimeGreen);
   }
 #endif
 }
 
+void ezVisibleObjectsExtractor::ExtractObjects(const ezView& view, ezArrayPtr<const ezGameObject* const> objects,
+  ezExtractedRenderData& extractedRenderData) const
+{
+  ezMsgExtractRenderData msg;
+  msg.m_pView = &view;
+
+  for (auto pObject : objects)
+  {
+    ExtractRenderData(view, pObject, msg, extractedRenderData);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezSelectedObjectsExtractor, 1, ezRTTINoAllocator)
@@ -1,7 +1,9 @@
 #include <RendererCorePCH.h>
 
+#include <Core/World/OcclusionBuffer.h>
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
+#include <RendererCore/Components/OccluderComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/GPUResourcePool/GPUResourcePool.h>
 #include <RendererCore/Pipeline/Extractor.h>
@@ -20,6 +22,8 @@ ezCVarBool ezRenderPipeline::s_DebugCulling("r_DebugCulling", false, ezCVarFlags
 ezCVarBool CVarCullingStats("r_CullingStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
 #endif
 
+ezCVarBool CVarOcclusionCulling("r_OcclusionCulling", true, ezCVarFlags::Default, "Enables the software occlusion culling with occluder components");
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -876,13 +880,21 @@ void ezRenderPipeline::ExtractData(const ezView& view)
   if (m_uiLastExtractionFrame == ezRenderWorld::GetFrameCounter())
   {
     EZ_REPORT_FAILURE("View '{0}' is extracted multiple times", view.GetName());
+    m_bVisibleObjectsPrecomputed = false;
     return;
   }
 
   m_uiLastExtractionFrame = ezRenderWorld::GetFrameCounter();
 
-  // Determine visible objects
-  FindVisibleObjects(view);
+  // Determine visible objects, unless this has already been done together with other views
+  if (m_bVisibleObjectsPrecomputed)
+  {
+    m_bVisibleObjectsPrecomputed = false;
+  }
+  else
+  {
+    FindVisibleObjects(view);
+  }
 
   // Extract and sort data
   auto& data = m_Data[ezRenderWorld::GetDataIndexForExtraction()];
@@ -934,14 +946,16 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
   EZ_LOCK(view.GetWorld()->GetReadMarker());
 
+  const ezOcclusionBuffer* pOcclusionBuffer = RasterizeOccluders(view, frustum);
+  const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   const bool bIsMainView =
     (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
   const bool bRecordStats = CVarCullingStats && bIsMainView;
   ezSpatialSystem::QueryStats stats;
 
-  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
-  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr, pOcclusionBuffer);
 
   ezViewHandle hView = view.GetHandle();
 
@@ -965,17 +979,101 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
     sb.Format("Num Objects Passed: {0}", stats.m_uiNumObjectsPassed);
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 260), ezColor::LimeGreen);
 
+    sb.Format("Num Objects Occluded: {0} (Occluders: {1})", stats.m_uiNumObjectsOccluded, pOcclusionBuffer != nullptr ? m_visibleOccluders.GetCount() : 0);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
     // Exponential moving average for better readability.
     m_AverageCullingTime = ezMath::Lerp(m_AverageCullingTime, stats.m_TimeTaken, 0.05f);
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
-    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+    ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr, pOcclusionBuffer);
 #endif
 }
 
+const ezOcclusionBuffer* ezRenderPipeline::RasterizeOccluders(const ezView& view, const ezFrustum& frustum)
+{
+  if (!CVarOcclusionCulling)
+    return nullptr;
+
+  EZ_PROFILE_SCOPE("Rasterize Occluders");
+
+  m_visibleOccluders.Clear();
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, ezDefaultSpatialDataCategories::Occluder.GetBitmask(), m_visibleOccluders);
+
+  if (m_visibleOccluders.IsEmpty())
+    return nullptr;
+
+  if (m_pOcclusionBuffer == nullptr)
+  {
+    m_pOcclusionBuffer = EZ_DEFAULT_NEW(ezOcclusionBuffer);
+  }
+
+  ezMat4 viewProjection;
+  view.ComputeCullingViewProjection(viewProjection);
+  m_pOcclusionBuffer->Clear(viewProjection);
+
+  for (const ezGameObject* pObject : m_visibleOccluders)
+  {
+    const ezOccluderComponent* pOccluder = nullptr;
+    if (pObject->TryGetComponentOfBaseType(pOccluder) && pOccluder->IsActive())
+    {
+      m_pOcclusionBuffer->RasterizeOccluder(pOccluder->GetLocalBox(), pObject->GetGlobalTransformSimd());
+    }
+  }
+
+  return m_pOcclusionBuffer.Borrow();
+}
+
+// static
+void ezRenderPipeline::FindVisibleObjects(ezArrayPtr<const ezView*> views, ezArrayPtr<ezRenderPipeline*> pipelines)
+{
+  EZ_PROFILE_SCOPE("Batched Visibility Culling");
+
+  EZ_ASSERT_DEV(views.GetCount() == pipelines.GetCount(), "Every view needs a render pipeline");
+  EZ_ASSERT_DEV(views.GetCount() <= 32, "Too many views for a single batched query");
+
+  const ezWorld* pWorld = views[0]->GetWorld();
+
+  ezHybridArray<ezFrustum, 8> frusta;
+  for (const ezView* pView : views)
+  {
+    EZ_ASSERT_DEV(pView->GetWorld() == pWorld, "All views of a batched query must show the same world");
+    pView->ComputeCullingFrustum(frusta.ExpandAndGetRef());
+  }
+
+  ezDynamicArray<const ezGameObject*> visibleObjects;
+  ezDynamicArray<ezUInt32> visibilityMasks;
+
+  {
+    EZ_LOCK(pWorld->GetReadMarker());
+
+    const ezUInt32 uiCategoryBitmask =
+      ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+    pWorld->GetSpatialSystem()->FindVisibleObjects(frusta, uiCategoryBitmask, visibleObjects, visibilityMasks);
+  }
+
+  for (ezRenderPipeline* pPipeline : pipelines)
+  {
+    pPipeline->m_visibleObjects.Clear();
+    pPipeline->m_bVisibleObjectsPrecomputed = true;
+  }
+
+  for (ezUInt32 i = 0; i < visibleObjects.GetCount(); ++i)
+  {
+    ezUInt32 uiMask = visibilityMasks[i];
+    while (uiMask > 0)
+    {
+      const ezUInt32 uiViewIndex = ezMath::FirstBitLow(uiMask);
+      uiMask &= uiMask - 1;
+
+      pipelines[uiViewIndex]->m_visibleObjects.PushBack(visibleObjects[i]);
+    }
+  }
+}
+
 void ezRenderPipeline::Render(ezRenderContext* pRenderContext)
 {
   EZ_PROFILE_AND_MARKER(pRenderContext->GetGALContext(), m_sName.GetData());
@@ -8,6 +8,7 @@
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
 class ezProfilingId;
+class ezOcclusionBuffer;
 class ezView;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
@@ -80,6 +81,14 @@ private:
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
 
+  /// \brief Rasterizes all occluders inside the culling frustum of the view into the occlusion buffer of this pipeline.
+  /// Returns nullptr if occlusion culling is disabled or there are no occluders in view.
+  const ezOcclusionBuffer* RasterizeOccluders(const ezView& view, const ezFrustum& frustum);
+
+  /// \brief Determines the visible objects of several views of the same world with one batched spatial query.
+  /// The following ExtractData() calls of these pipelines then skip their own visibility culling.
+  static void FindVisibleObjects(ezArrayPtr<const ezView*> views, ezArrayPtr<ezRenderPipeline*> pipelines);
+
   void Render(ezRenderContext* pRenderer);
 
 private: // Member data
@@ -90,6 +99,9 @@ private: // Member data
   // Pipeline render data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
+  bool m_bVisibleObjectsPrecomputed = false;
+  ezUniquePtr<ezOcclusionBuffer> m_pOcclusionBuffer;
+  ezDynamicArray<const ezGameObject*> m_visibleOccluders;
 
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
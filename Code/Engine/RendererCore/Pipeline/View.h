@@ -101,6 +101,9 @@ public:
   /// \brief Returns the frustum that should be used for determine visible objects for this view.
   void ComputeCullingFrustum(ezFrustum& out_Frustum) const;
 
+  /// \brief Returns the view projection matrix of the culling camera, i.e. the matrix the culling frustum is built from.
+  void ComputeCullingViewProjection(ezMat4& out_ViewProjection) const;
+
   void SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
   void SetExtractorProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
 
@@ -1,5 +1,6 @@
 #include <RendererCorePCH.h>
 
+#include <Core/World/World.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/Memory/CommonAllocators.h>
@@ -90,6 +91,7 @@ namespace ezInternal
 
     ezStaticArray<NewEntryPerComponent, MaxNumNewCacheEntries> m_NewEntriesPerComponent;
     ezAtomicInteger32 m_NewEntriesCount;
+    ezMutex m_NewEntriesMutex;
   };
 
 #if EZ_ENABLED(EZ_PLATFORM_64BIT)
@@ -105,9 +107,18 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RenderWorld)
     "Core"
   END_SUBSYSTEM_DEPENDENCIES
 
+  ON_CORESYSTEMS_STARTUP
+  {
+    ezRenderWorld::OnCoreStartup();
+  }
+
+  ON_CORESYSTEMS_SHUTDOWN
+  {
+    ezRenderWorld::OnCoreShutdown();
+  }
+
   ON_HIGHLEVELSYSTEMS_STARTUP
   {
-    ezRenderWorld::OnEngineStartup();
   }
 
   ON_HIGHLEVELSYSTEMS_SHUTDOWN
@@ -233,19 +244,24 @@ void ezRenderWorld::CacheRenderData(const ezView& view, const ezGameObjectHandle
 {
   if (CVarCacheRenderData)
   {
-    ezUInt32 uiNewEntriesCount = view.m_pRenderDataCache->m_NewEntriesCount;
-    if (uiNewEntriesCount >= MaxNumNewCacheEntries)
+    // cheap early out, so that extraction threads don't have to take the lock once all slots are taken
+    if (view.m_pRenderDataCache->m_NewEntriesCount >= MaxNumNewCacheEntries)
     {
       return;
     }
 
-    uiNewEntriesCount = view.m_pRenderDataCache->m_NewEntriesCount.Increment();
-    if (uiNewEntriesCount <= MaxNumNewCacheEntries)
+    // Several extraction threads may get here at once. Copying the entries allocates, so the whole slot is written under the lock.
+    EZ_LOCK(view.m_pRenderDataCache->m_NewEntriesMutex);
+
+    ezUInt32 uiNewEntriesCount = view.m_pRenderDataCache->m_NewEntriesCount;
+    if (uiNewEntriesCount < MaxNumNewCacheEntries)
     {
-      auto& newEntry = view.m_pRenderDataCache->m_NewEntriesPerComponent[uiNewEntriesCount - 1];
+      auto& newEntry = view.m_pRenderDataCache->m_NewEntriesPerComponent[uiNewEntriesCount];
       newEntry.m_hOwnerObject = hOwnerObject;
       newEntry.m_hOwnerComponent = hOwnerComponent;
       newEntry.m_CacheEntries = cacheEntries;
+
+      view.m_pRenderDataCache->m_NewEntriesCount.Increment();
     }
   }
 }
@@ -343,42 +359,93 @@ ezArrayPtr<ezInternal::RenderDataCacheEntry> ezRenderWorld::GetCachedRenderData(
 
 void ezRenderWorld::AddViewToRender(const ezViewHandle& hView)
 {
-  ezView* pView = nullptr;
-  if (!TryGetView(hView, pView))
-    return;
+  AddViewsToRender(ezMakeArrayPtr(&hView, 1));
+}
 
-  if (!pView->IsValid())
-    return;
+void ezRenderWorld::AddViewsToRender(ezArrayPtr<const ezViewHandle> views)
+{
+  ezHybridArray<ezView*, 8> newViews;
 
   {
     EZ_LOCK(s_ViewsToRenderMutex);
     EZ_ASSERT_DEV(s_bInExtract, "Render views need to be collected during extraction");
 
-    // make sure the view is put at the end of the array, if it is already there, reorder it
-    // this ensures that the views that have been referenced by the last other view, get rendered first
-    ezUInt32 uiIndex = s_ViewsToRender.IndexOf(pView);
-    if (uiIndex != ezInvalidIndex)
+    for (const ezViewHandle& hView : views)
     {
-      s_ViewsToRender.RemoveAtAndCopy(uiIndex);
+      ezView* pView = nullptr;
+      if (!TryGetView(hView, pView))
+        continue;
+
+      if (!pView->IsValid())
+        continue;
+
+      // make sure the view is put at the end of the array, if it is already there, reorder it
+      // this ensures that the views that have been referenced by the last other view, get rendered first
+      ezUInt32 uiIndex = s_ViewsToRender.IndexOf(pView);
+      if (uiIndex != ezInvalidIndex)
+      {
+        s_ViewsToRender.RemoveAtAndCopy(uiIndex);
+        s_ViewsToRender.PushBack(pView);
+        continue;
+      }
+
       s_ViewsToRender.PushBack(pView);
-      return;
+      newViews.PushBack(pView);
     }
-
-    s_ViewsToRender.PushBack(pView);
   }
 
-  if (CVarMultithreadedRendering)
+  // cull the new views that show the same world together, the ones that are already in the list might be extracted right now
   {
-    ezTaskGroupID extractTaskID = ezTaskSystem::StartSingleTask(pView->GetExtractTask(), ezTaskPriority::EarlyThisFrame);
+    ezHybridArray<const ezView*, 8> batchViews;
+    ezHybridArray<ezRenderPipeline*, 8> batchPipelines;
 
+    for (ezUInt32 i = 0; i < newViews.GetCount(); ++i)
     {
-      EZ_LOCK(s_ExtractTasksMutex);
-      s_ExtractTasks.PushBack(extractTaskID);
+      const ezWorld* pWorld = newViews[i]->GetWorld();
+
+      bool bAlreadyBatched = false;
+      for (ezUInt32 j = 0; j < i; ++j)
+      {
+        bAlreadyBatched |= (newViews[j]->GetWorld() == pWorld);
+      }
+
+      if (bAlreadyBatched || pWorld == nullptr || pWorld->GetSpatialSystem() == nullptr)
+        continue;
+
+      batchViews.Clear();
+      batchPipelines.Clear();
+
+      for (ezUInt32 j = i; j < newViews.GetCount() && batchViews.GetCount() < 32; ++j)
+      {
+        if (newViews[j]->GetWorld() == pWorld)
+        {
+          batchViews.PushBack(newViews[j]);
+          batchPipelines.PushBack(newViews[j]->m_pRenderPipeline.Borrow());
+        }
+      }
+
+      if (batchViews.GetCount() > 1)
+      {
+        ezRenderPipeline::FindVisibleObjects(batchViews, batchPipelines);
+      }
     }
   }
-  else
+
+  for (ezView* pView : newViews)
   {
-    pView->ExtractData();
+    if (CVarMultithreadedRendering)
+    {
+      ezTaskGroupID extractTaskID = ezTaskSystem::StartSingleTask(pView->GetExtractTask(), ezTaskPriority::EarlyThisFrame);
+
+      {
+        EZ_LOCK(s_ExtractTasksMutex);
+        s_ExtractTasks.PushBack(extractTaskID);
+      }
+    }
+    else
+    {
+      pView->ExtractData();
+    }
   }
 }
 
@@ -671,18 +738,27 @@ void ezRenderWorld::RebuildPipelines()
   s_PipelinesToRebuild.Clear();
 }
 
-void ezRenderWorld::OnEngineStartup()
+void ezRenderWorld::OnCoreStartup()
 {
+  // the render data cache does not need a device, so views can be created and extracted without one
   s_pCacheAllocator = EZ_DEFAULT_NEW(ezProxyAllocator, "Cached Render Data", ezFoundation::GetDefaultAllocator());
 
   s_CachedRenderData = ezHashTable<ezComponentHandle, CachedRenderDataPerComponent>(s_pCacheAllocator);
 }
 
-void ezRenderWorld::OnEngineShutdown()
+void ezRenderWorld::OnCoreShutdown()
 {
   ClearRenderDataCache();
 
+  s_CachedRenderData.Clear();
+  s_CachedRenderData.Compact();
+
   EZ_DEFAULT_DELETE(s_pCacheAllocator);
+}
+
+void ezRenderWorld::OnEngineShutdown()
+{
+  ClearRenderDataCache();
 
   s_FilteredRenderPipelines[0].Clear();
   s_FilteredRenderPipelines[1].Clear();
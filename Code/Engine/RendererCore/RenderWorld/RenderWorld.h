@@ -50,6 +50,10 @@ public:
   static void ClearMainViews();
   static ezArrayPtr<ezViewHandle> GetMainViews();
 
+  /// \brief Queues the given entries to be added to the render data cache of the view at the beginning of the next frame.
+  ///
+  /// Can be called from several extraction threads at once. Only a limited number of entries is accepted per view and frame, the rest
+  /// is dropped and has to be cached again in a later frame.
   static void CacheRenderData(const ezView& view, const ezGameObjectHandle& hOwnerObject, const ezComponentHandle& hOwnerComponent,
     ezArrayPtr<ezInternal::RenderDataCacheEntry> cacheEntries);
 
@@ -57,10 +61,16 @@ public:
   static void DeleteCachedRenderData(const ezGameObjectHandle& hOwnerObject, const ezComponentHandle& hOwnerComponent);
   static void DeleteCachedRenderDataRecursive(const ezGameObject* pOwnerObject);
   static void DeleteCachedRenderData(ezView& view);
+  /// \brief Returns the cached entries of the given object. The cache is only modified outside of extraction, so this is safe to call from
+  /// several extraction threads at once.
   static ezArrayPtr<ezInternal::RenderDataCacheEntry> GetCachedRenderData(const ezView& view, const ezGameObjectHandle& hOwner);
 
   static void AddViewToRender(const ezViewHandle& hView);
 
+  /// \brief Same as calling AddViewToRender() for every view, but the visibility culling of views that show the same world
+  /// is done with a single batched query, e.g. for the faces of a point light shadow.
+  static void AddViewsToRender(ezArrayPtr<const ezViewHandle> views);
+
   static void ExtractMainViews();
 
   static void Render(ezRenderContext* pRenderContext);
@@ -117,7 +127,8 @@ private:
   static void AddRenderPipelineToRebuild(ezRenderPipeline* pRenderPipeline, const ezViewHandle& hView);
   static void RebuildPipelines();
 
-  static void OnEngineStartup();
+  static void OnCoreStartup();
+  static void OnCoreShutdown();
   static void OnEngineShutdown();
 
   static ezEvent<const ezRenderWorldExtractionEvent&, ezMutex> s_ExtractionEvent;
@@ -18,6 +18,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_AlwaysVisibleComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_CameraComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_FogComponent);
+  EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_OccluderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderTargetActivatorComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SkyBoxComponent);
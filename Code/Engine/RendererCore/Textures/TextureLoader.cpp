@@ -6,6 +6,7 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
+#include <Texture/Image/Formats/ImageFileFormat.h>
 #include <Texture/Image/ImageConversion.h>
 #include <RendererCore/Textures/Texture2DResource.h>
 #include <RendererCore/Textures/Texture3DResource.h>
@@ -116,36 +117,26 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
     const ezStringBuilder sName = ezPathUtils::GetFileName(sAbsolutePath);
     pData->m_TexFormat.m_bSRGB = (sName.EndsWith_NoCase("_D") || sName.EndsWith_NoCase("_SRGB") || sName.EndsWith_NoCase("_diff"));
 
-    if (sAbsolutePath.HasExtension("ezTexture2D") || sAbsolutePath.HasExtension("ezTexture3D") || sAbsolutePath.HasExtension("ezTextureCube") ||
-        sAbsolutePath.HasExtension("ezRenderTarget") || sAbsolutePath.HasExtension("ezLUT"))
-    {
-      if (LoadTexFile(File, *pData).Failed())
-        return res;
-    }
-    else
-    {
-      // read whatever format, as long as ezImage supports it
-      File.Close();
+    pData->m_bIsTexFile = sAbsolutePath.HasExtension("ezTexture2D") || sAbsolutePath.HasExtension("ezTexture3D") ||
+                          sAbsolutePath.HasExtension("ezTextureCube") || sAbsolutePath.HasExtension("ezRenderTarget") ||
+                          sAbsolutePath.HasExtension("ezLUT");
+    pData->m_sFileExtension = sAbsolutePath.GetFileExtension();
 
-      if (pData->m_Image.LoadFrom(pResource->GetResourceID()).Failed())
-        return res;
-
-      if (pData->m_Image.GetImageFormat() == ezImageFormat::B8G8R8_UNORM)
-      {
-        /// \todo A conversion to B8G8R8X8_UNORM currently fails
+    // only read the file here, parsing and converting the image happens in DecodeData() on a worker thread
+    pData->m_FileData.ReadAll(File);
 
-        ezLog::Warning("Texture resource uses inefficient BGR format, converting to BGRX: '{0}'", sAbsolutePath);
-        if (ezImageConversion::Convert(pData->m_Image, pData->m_Image, ezImageFormat::B8G8R8A8_UNORM).Failed())
-          return res;
-      }
-    }
+    res.m_uiDataSize = pData->m_FileData.GetStorageSize();
+    res.m_bNeedsDecoding = true;
   }
 
-  ezMemoryStreamWriter w(&pData->m_Storage);
+  if (!res.m_bNeedsDecoding)
+  {
+    ezMemoryStreamWriter w(&pData->m_Storage);
+    WriteTextureLoadStream(w, *pData);
 
-  WriteTextureLoadStream(w, *pData);
+    res.m_pDataStream = &pData->m_Reader;
+  }
 
-  res.m_pDataStream = &pData->m_Reader;
   res.m_pCustomLoaderData = pData;
 
   if (CVarTextureLoadingDelay > 0)
@@ -156,6 +147,54 @@ ezResourceLoadData ezTextureResourceLoader::OpenDataStream(const ezResource* pRe
   return res;
 }
 
+void ezTextureResourceLoader::DecodeData(const ezResource* pResource, ezResourceLoadData& inout_LoaderData)
+{
+  LoadedData* pData = (LoadedData*)inout_LoaderData.m_pCustomLoaderData;
+
+  ezMemoryStreamReader FileReader(&pData->m_FileData);
+
+  if (pData->m_bIsTexFile)
+  {
+    if (LoadTexFile(FileReader, *pData).Failed())
+      return;
+  }
+  else
+  {
+    // read whatever format, as long as ezImage supports it
+    ezImageFileFormat* pFormat = ezImageFileFormat::GetReaderFormat(pData->m_sFileExtension);
+
+    if (pFormat == nullptr)
+    {
+      ezLog::Warning("No known image file format for extension '{0}'", pData->m_sFileExtension);
+      return;
+    }
+
+    if (pFormat->ReadImage(FileReader, pData->m_Image, ezLog::GetThreadLocalLogSystem(), pData->m_sFileExtension).Failed())
+    {
+      ezLog::Warning("Failed to read image file '{0}'", inout_LoaderData.m_sResourceDescription);
+      return;
+    }
+
+    if (pData->m_Image.GetImageFormat() == ezImageFormat::B8G8R8_UNORM)
+    {
+      /// \todo A conversion to B8G8R8X8_UNORM currently fails
+
+      ezLog::Warning("Texture resource uses inefficient BGR format, converting to BGRX: '{0}'", inout_LoaderData.m_sResourceDescription);
+      if (ezImageConversion::Convert(pData->m_Image, pData->m_Image, ezImageFormat::B8G8R8A8_UNORM).Failed())
+        return;
+    }
+  }
+
+  // the file data is not needed anymore
+  pData->m_FileData.Clear();
+  pData->m_FileData.Compact();
+
+  ezMemoryStreamWriter w(&pData->m_Storage);
+  WriteTextureLoadStream(w, *pData);
+
+  inout_LoaderData.m_pDataStream = &pData->m_Reader;
+}
+
 void ezTextureResourceLoader::CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData)
 {
   LoadedData* pData = (LoadedData*)LoaderData.m_pCustomLoaderData;
@@ -22,9 +22,15 @@ public:
 
     bool m_bIsFallback = false;
     ezTexFormat m_TexFormat;
+
+    /// The raw file content, read in OpenDataStream() and decoded into m_Image in DecodeData().
+    ezMemoryStreamStorage m_FileData;
+    ezString m_sFileExtension;
+    bool m_bIsTexFile = false;
   };
 
   virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override;
+  virtual void DecodeData(const ezResource* pResource, ezResourceLoadData& inout_LoaderData) override;
   virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override;
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
 
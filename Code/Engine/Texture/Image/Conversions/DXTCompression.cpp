@@ -0,0 +1,992 @@
+#include <TexturePCH.h>
+
+#include <Foundation/Math/Color16f.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Conversions/PixelConversions.h>
+#include <Texture/Image/ImageConversion.h>
+
+namespace
+{
+  static const ezUInt32 s_uiNumTexelsPerBlock = 16;
+
+  // BC6H and BC7 interpolation weights for 4 bit indices
+  static const ezInt32 s_bc67Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+  ezUInt32 GetNumRefinementPasses(ezBlockCompressionQuality::Enum quality)
+  {
+    switch (quality)
+    {
+      case ezBlockCompressionQuality::Fast:
+        return 0;
+      case ezBlockCompressionQuality::Normal:
+        return 2;
+      default:
+        return 6;
+    }
+  }
+
+  class BitWriter
+  {
+  public:
+    BitWriter(ezUInt8* pTarget, ezUInt32 uiNumBytes)
+      : m_pTarget(pTarget)
+    {
+      ezMemoryUtils::ZeroFill(pTarget, uiNumBytes);
+    }
+
+    void Write(ezUInt32 uiValue, ezUInt32 uiNumBits)
+    {
+      for (ezUInt32 i = 0; i < uiNumBits; ++i, ++m_uiBit)
+      {
+        if ((uiValue >> i) & 1u)
+        {
+          m_pTarget[m_uiBit >> 3] |= ezUInt8(1u << (m_uiBit & 7u));
+        }
+      }
+    }
+
+  private:
+    ezUInt8* m_pTarget;
+    ezUInt32 m_uiBit = 0;
+  };
+
+  ezSimdVec4f ComputeMean(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints)
+  {
+    ezSimdVec4f vSum = ezSimdVec4f::ZeroVector();
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      vSum += pPoints[i];
+    }
+
+    return vSum / ezSimdFloat(static_cast<float>(uiNumPoints));
+  }
+
+  /// Returns the direction of the largest variance of the points around their mean, found by power iteration on the covariance matrix.
+  ezSimdVec4f ComputePrincipalAxis(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, const ezSimdVec4f& vMean)
+  {
+    ezSimdVec4f cov0 = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f cov1 = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f cov2 = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f cov3 = ezSimdVec4f::ZeroVector();
+
+    ezSimdVec4f vMin = pPoints[0];
+    ezSimdVec4f vMax = pPoints[0];
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const ezSimdVec4f d = pPoints[i] - vMean;
+      cov0 = ezSimdVec4f::MulAdd(d, d.x(), cov0);
+      cov1 = ezSimdVec4f::MulAdd(d, d.y(), cov1);
+      cov2 = ezSimdVec4f::MulAdd(d, d.z(), cov2);
+      cov3 = ezSimdVec4f::MulAdd(d, d.w(), cov3);
+
+      vMin = vMin.CompMin(pPoints[i]);
+      vMax = vMax.CompMax(pPoints[i]);
+    }
+
+    // the extents of the block are usually already close to the principal axis, which makes the iteration converge quickly
+    ezSimdVec4f vAxis = vMax - vMin;
+
+    for (ezUInt32 uiIteration = 0; uiIteration < 6; ++uiIteration)
+    {
+      ezSimdVec4f v = cov0 * vAxis.x();
+      v = ezSimdVec4f::MulAdd(cov1, vAxis.y(), v);
+      v = ezSimdVec4f::MulAdd(cov2, vAxis.z(), v);
+      v = ezSimdVec4f::MulAdd(cov3, vAxis.w(), v);
+
+      if (v.IsZero<4>(ezMath::SmallEpsilon<float>()))
+        break;
+
+      vAxis = v.GetNormalized<4>();
+    }
+
+    vAxis.NormalizeIfNotZero<4>();
+    return vAxis;
+  }
+
+  /// Projects all points onto the principal axis and returns the two outermost projections as initial endpoints.
+  void ComputeInitialEndpoints(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    const ezSimdVec4f vMean = ComputeMean(pPoints, uiNumPoints);
+    const ezSimdVec4f vAxis = ComputePrincipalAxis(pPoints, uiNumPoints, vMean);
+
+    float fMin = ezMath::MaxValue<float>();
+    float fMax = -ezMath::MaxValue<float>();
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const float t = (pPoints[i] - vMean).Dot<4>(vAxis);
+      fMin = ezMath::Min(fMin, t);
+      fMax = ezMath::Max(fMax, t);
+    }
+
+    out_vEndpoint0 = ezSimdVec4f::MulAdd(vAxis, ezSimdFloat(fMin), vMean);
+    out_vEndpoint1 = ezSimdVec4f::MulAdd(vAxis, ezSimdFloat(fMax), vMean);
+  }
+
+  /// Finds the endpoints that minimize the squared error for the given interpolation weights (0 = endpoint 0, 1 = endpoint 1).
+  bool SolveEndpoints(const ezSimdVec4f* pPoints, const float* pWeights, ezUInt32 uiNumPoints, ezSimdVec4f& out_vEndpoint0, ezSimdVec4f& out_vEndpoint1)
+  {
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    ezSimdVec4f at = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f bt = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      const float b = pWeights[i];
+      const float a = 1.0f - b;
+
+      aa += a * a;
+      ab += a * b;
+      bb += b * b;
+      at = ezSimdVec4f::MulAdd(pPoints[i], ezSimdFloat(a), at);
+      bt = ezSimdVec4f::MulAdd(pPoints[i], ezSimdFloat(b), bt);
+    }
+
+    const float fDet = aa * bb - ab * ab;
+    if (ezMath::Abs(fDet) < ezMath::SmallEpsilon<float>())
+      return false;
+
+    const ezSimdFloat fInvDet = 1.0f / fDet;
+    out_vEndpoint0 = ezSimdVec4f::MulSub(at, ezSimdFloat(bb), bt * ezSimdFloat(ab)) * fInvDet;
+    out_vEndpoint1 = ezSimdVec4f::MulSub(bt, ezSimdFloat(aa), at * ezSimdFloat(ab)) * fInvDet;
+    return true;
+  }
+
+  /// Picks the closest palette entry for every point and returns the summed squared error.
+  float FindClosestIndices(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, const ezSimdVec4f* pPalette, ezUInt32 uiPaletteSize, ezUInt8* out_pIndices)
+  {
+    float fError = 0.0f;
+
+    for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+    {
+      float fBestDistance = ezMath::MaxValue<float>();
+      ezUInt8 uiBestIndex = 0;
+
+      for (ezUInt32 j = 0; j < uiPaletteSize; ++j)
+      {
+        const float fDistance = (pPoints[i] - pPalette[j]).GetLengthSquared<4>();
+        if (fDistance < fBestDistance)
+        {
+          fBestDistance = fDistance;
+          uiBestIndex = static_cast<ezUInt8>(j);
+        }
+      }
+
+      out_pIndices[i] = uiBestIndex;
+      fError += fBestDistance;
+    }
+
+    return fError;
+  }
+
+  ezInt32 RoundAndClamp(float fValue, ezInt32 iMin, ezInt32 iMax)
+  {
+    return ezMath::Clamp(static_cast<ezInt32>(ezMath::Floor(fValue + 0.5f)), iMin, iMax);
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  // BC1
+
+  ezUInt16 QuantizeBC1Endpoint(const ezSimdVec4f& vEndpoint)
+  {
+    float values[4];
+    vEndpoint.Store<4>(values);
+
+    ezColorBaseUB color;
+    color.r = static_cast<ezUInt8>(RoundAndClamp(values[0], 0, 255));
+    color.g = static_cast<ezUInt8>(RoundAndClamp(values[1], 0, 255));
+    color.b = static_cast<ezUInt8>(RoundAndClamp(values[2], 0, 255));
+    color.a = 255;
+
+    return ezCompressB5G6R5(color);
+  }
+
+  float EvaluateBC1(const ezSimdVec4f* pPoints, ezUInt32 uiNumPoints, ezUInt16 uiColor0, ezUInt16 uiColor1, bool bFourColors, ezUInt8* out_pIndices)
+  {
+    const ezColorBaseUB c0 = ezDecompressB5G6R5(uiColor0);
+    const ezColorBaseUB c1 = ezDecompressB5G6R5(uiColor1);
+
+    // same rounding as in ezDecompressBlockBC1()
+    ezSimdVec4f palette[4];
+    palette[0].Set(c0.r, c0.g, c0.b, 0.0f);
+    palette[1].Set(c1.r, c1.g, c1.b, 0.0f);
+
+    if (bFourColors)
+    {
+      palette[2].Set((2 * c0.r + c1.r + 1) / 3, (2 * c0.g + c1.g + 1) / 3, (2 * c0.b + c1.b + 1) / 3, 0.0f);
+      palette[3].Set((c0.r + 2 * c1.r + 1) / 3, (c0.g + 2 * c1.g + 1) / 3, (c0.b + 2 * c1.b + 1) / 3, 0.0f);
+    }
+    else
+    {
+      palette[2].Set((c0.r + c1.r) / 2, (c0.g + c1.g) / 2, (c0.b + c1.b) / 2, 0.0f);
+    }
+
+    return FindClosestIndices(pPoints, uiNumPoints, palette, bFourColors ? 4 : 3, out_pIndices);
+  }
+} // namespace
+
+void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, bool bForceFourColorMode, ezBlockCompressionQuality::Enum quality)
+{
+  ezSimdVec4f points[s_uiNumTexelsPerBlock];
+  bool bTransparent[s_uiNumTexelsPerBlock];
+  ezUInt32 uiNumPoints = 0;
+
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    bTransparent[i] = !bForceFourColorMode && pSource[i].a < 128;
+
+    if (!bTransparent[i])
+    {
+      points[uiNumPoints++].Set(pSource[i].r, pSource[i].g, pSource[i].b, 0.0f);
+    }
+  }
+
+  ezUInt16 uiColor0 = 0;
+  ezUInt16 uiColor1 = 0;
+  ezUInt8 indices[s_uiNumTexelsPerBlock] = {};
+
+  // transparent texels can only be encoded in the three color mode
+  const bool bFourColors = uiNumPoints == s_uiNumTexelsPerBlock;
+
+  if (uiNumPoints > 0)
+  {
+    ezSimdVec4f vEndpoint0, vEndpoint1;
+    ComputeInitialEndpoints(points, uiNumPoints, vEndpoint0, vEndpoint1);
+
+    uiColor0 = QuantizeBC1Endpoint(vEndpoint0);
+    uiColor1 = QuantizeBC1Endpoint(vEndpoint1);
+    float fError = EvaluateBC1(points, uiNumPoints, uiColor0, uiColor1, bFourColors, indices);
+
+    static const float s_FourColorWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    static const float s_ThreeColorWeights[4] = {0.0f, 1.0f, 0.5f, 0.0f};
+    const float* pPaletteWeights = bFourColors ? s_FourColorWeights : s_ThreeColorWeights;
+
+    const ezUInt32 uiNumPasses = GetNumRefinementPasses(quality);
+    for (ezUInt32 uiPass = 0; uiPass < uiNumPasses && fError > 0.0f; ++uiPass)
+    {
+      float weights[s_uiNumTexelsPerBlock];
+      for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+      {
+        weights[i] = pPaletteWeights[indices[i]];
+      }
+
+      if (!SolveEndpoints(points, weights, uiNumPoints, vEndpoint0, vEndpoint1))
+        break;
+
+      const ezUInt16 uiNewColor0 = QuantizeBC1Endpoint(vEndpoint0);
+      const ezUInt16 uiNewColor1 = QuantizeBC1Endpoint(vEndpoint1);
+      if (uiNewColor0 == uiColor0 && uiNewColor1 == uiColor1)
+        break;
+
+      ezUInt8 newIndices[s_uiNumTexelsPerBlock];
+      const float fNewError = EvaluateBC1(points, uiNumPoints, uiNewColor0, uiNewColor1, bFourColors, newIndices);
+      if (fNewError >= fError)
+        break;
+
+      fError = fNewError;
+      uiColor0 = uiNewColor0;
+      uiColor1 = uiNewColor1;
+      ezMemoryUtils::Copy(indices, newIndices, uiNumPoints);
+    }
+
+    // the decoder selects the mode through the order of the endpoints
+    if (bFourColors)
+    {
+      if (uiColor0 < uiColor1)
+      {
+        ezMath::Swap(uiColor0, uiColor1);
+        for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+        {
+          indices[i] ^= 1;
+        }
+      }
+      else if (uiColor0 == uiColor1 && !bForceFourColorMode)
+      {
+        // decoded in the three color mode, where index 3 would be transparent
+        ezMemoryUtils::ZeroFill(indices, uiNumPoints);
+      }
+    }
+    else if (uiColor0 > uiColor1)
+    {
+      ezMath::Swap(uiColor0, uiColor1);
+      for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+      {
+        if (indices[i] < 2)
+        {
+          indices[i] ^= 1;
+        }
+      }
+    }
+  }
+
+  ezUInt32 uiIndexBits = 0;
+  for (ezUInt32 i = 0, uiPoint = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    const ezUInt32 uiIndex = bTransparent[i] ? 3 : indices[uiPoint++];
+    uiIndexBits |= uiIndex << (2 * i);
+  }
+
+  pTarget[0] = static_cast<ezUInt8>(uiColor0 & 0xFF);
+  pTarget[1] = static_cast<ezUInt8>(uiColor0 >> 8);
+  pTarget[2] = static_cast<ezUInt8>(uiColor1 & 0xFF);
+  pTarget[3] = static_cast<ezUInt8>(uiColor1 >> 8);
+  pTarget[4] = static_cast<ezUInt8>(uiIndexBits >> 0);
+  pTarget[5] = static_cast<ezUInt8>(uiIndexBits >> 8);
+  pTarget[6] = static_cast<ezUInt8>(uiIndexBits >> 16);
+  pTarget[7] = static_cast<ezUInt8>(uiIndexBits >> 24);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// BC4
+
+namespace
+{
+  ezUInt32 EvaluateBC4(const ezInt32* pValues, ezUInt32 a0, ezUInt32 a1, ezUInt8* out_pIndices)
+  {
+    ezUInt32 palette[8];
+    ezUnpackPaletteBC4(a0, a1, palette);
+
+    ezUInt32 uiError = 0;
+
+    for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+    {
+      ezUInt32 uiBestDistance = 0xFFFFFFFF;
+
+      for (ezUInt32 j = 0; j < 8; ++j)
+      {
+        const ezInt32 iDiff = pValues[i] - static_cast<ezInt32>(palette[j]);
+        const ezUInt32 uiDistance = static_cast<ezUInt32>(iDiff * iDiff);
+
+        if (uiDistance < uiBestDistance)
+        {
+          uiBestDistance = uiDistance;
+          out_pIndices[i] = static_cast<ezUInt8>(j);
+        }
+      }
+
+      uiError += uiBestDistance;
+    }
+
+    return uiError;
+  }
+
+  struct BC4Encoding
+  {
+    ezUInt32 m_uiA0 = 0;
+    ezUInt32 m_uiA1 = 0;
+    ezUInt32 m_uiError = 0xFFFFFFFF;
+    ezUInt8 m_Indices[s_uiNumTexelsPerBlock] = {};
+
+    bool TryEndpoints(const ezInt32* pValues, ezUInt32 a0, ezUInt32 a1)
+    {
+      ezUInt8 indices[s_uiNumTexelsPerBlock];
+      const ezUInt32 uiError = EvaluateBC4(pValues, a0, a1, indices);
+
+      if (uiError >= m_uiError)
+        return false;
+
+      m_uiA0 = a0;
+      m_uiA1 = a1;
+      m_uiError = uiError;
+      ezMemoryUtils::Copy(m_Indices, indices, s_uiNumTexelsPerBlock);
+      return true;
+    }
+  };
+} // namespace
+
+void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality)
+{
+  ezInt32 values[s_uiNumTexelsPerBlock];
+  ezInt32 iMin = 255;
+  ezInt32 iMax = 0;
+
+  // values close to 0 and 255 can also be covered by the explicit extremes of the six value mode
+  ezInt32 iInnerMin = 255;
+  ezInt32 iInnerMax = 0;
+
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    values[i] = static_cast<ezUInt8>(pSource[i * uiStride] + bias);
+    iMin = ezMath::Min(iMin, values[i]);
+    iMax = ezMath::Max(iMax, values[i]);
+
+    if (values[i] > 8 && values[i] < 247)
+    {
+      iInnerMin = ezMath::Min(iInnerMin, values[i]);
+      iInnerMax = ezMath::Max(iInnerMax, values[i]);
+    }
+  }
+
+  BC4Encoding encoding;
+
+  if (iMin == iMax)
+  {
+    // six value mode with every index pointing at the first endpoint
+    encoding.m_uiA0 = iMax;
+    encoding.m_uiA1 = iMin;
+  }
+  else
+  {
+    encoding.TryEndpoints(values, iMax, iMin);
+
+    if (quality != ezBlockCompressionQuality::Fast && (iMin <= 8 || iMax >= 247) && iInnerMin <= iInnerMax)
+    {
+      encoding.TryEndpoints(values, iInnerMin, iInnerMax);
+    }
+
+    const ezUInt32 uiNumPasses = GetNumRefinementPasses(quality);
+    for (ezUInt32 uiPass = 0; uiPass < uiNumPasses && encoding.m_uiError > 0; ++uiPass)
+    {
+      // only the eight value mode interpolates over the whole palette
+      if (encoding.m_uiA0 <= encoding.m_uiA1)
+        break;
+
+      ezSimdVec4f points[s_uiNumTexelsPerBlock];
+      float weights[s_uiNumTexelsPerBlock];
+      for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+      {
+        const ezUInt32 uiIndex = encoding.m_Indices[i];
+        points[i].Set(static_cast<float>(values[i]));
+        weights[i] = uiIndex < 2 ? static_cast<float>(uiIndex) : (uiIndex - 1) / 7.0f;
+      }
+
+      ezSimdVec4f vEndpoint0, vEndpoint1;
+      if (!SolveEndpoints(points, weights, s_uiNumTexelsPerBlock, vEndpoint0, vEndpoint1))
+        break;
+
+      const ezInt32 a0 = RoundAndClamp(vEndpoint0.x(), 0, 255);
+      const ezInt32 a1 = RoundAndClamp(vEndpoint1.x(), 0, 255);
+      if (a0 <= a1 || !encoding.TryEndpoints(values, a0, a1))
+        break;
+    }
+
+    if (quality == ezBlockCompressionQuality::High && encoding.m_uiError > 0)
+    {
+      const ezInt32 iBestA0 = encoding.m_uiA0;
+      const ezInt32 iBestA1 = encoding.m_uiA1;
+
+      for (ezInt32 a0 = ezMath::Max(0, iBestA0 - 2); a0 <= ezMath::Min(255, iBestA0 + 2); ++a0)
+      {
+        for (ezInt32 a1 = ezMath::Max(0, iBestA1 - 2); a1 <= ezMath::Min(255, iBestA1 + 2); ++a1)
+        {
+          // stay in the mode that was found so far
+          if ((a0 > a1) == (iBestA0 > iBestA1))
+          {
+            encoding.TryEndpoints(values, a0, a1);
+          }
+        }
+      }
+    }
+  }
+
+  pTarget[0] = static_cast<ezUInt8>(encoding.m_uiA0 - bias);
+  pTarget[1] = static_cast<ezUInt8>(encoding.m_uiA1 - bias);
+
+  ezUInt64 uiIndexBits = 0;
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    uiIndexBits |= ezUInt64(encoding.m_Indices[i]) << (3 * i);
+  }
+
+  for (ezUInt32 i = 0; i < 6; ++i)
+  {
+    pTarget[2 + i] = static_cast<ezUInt8>(uiIndexBits >> (8 * i));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// BC6H
+
+namespace
+{
+  // Mode 11 of the format: a single region with two 10 bit endpoints and 4 bit indices.
+
+  ezInt32 UnquantizeBC6(ezInt32 iValue)
+  {
+    // same as the unsigned decoder for 10 bits
+    if (iValue == 0)
+      return 0;
+    if (iValue == 1023)
+      return 0xFFFF;
+    return ((iValue << 16) + 0x8000) >> 10;
+  }
+
+  ezInt32 QuantizeBC6(float fUnquantized)
+  {
+    const ezInt32 iGuess = RoundAndClamp((fUnquantized - 32.0f) / 64.0f, 0, 1023);
+
+    ezInt32 iBest = iGuess;
+    float fBestDistance = ezMath::MaxValue<float>();
+
+    for (ezInt32 i = ezMath::Max(0, iGuess - 1); i <= ezMath::Min(1023, iGuess + 1); ++i)
+    {
+      const float fDistance = ezMath::Abs(UnquantizeBC6(i) - fUnquantized);
+      if (fDistance < fBestDistance)
+      {
+        fBestDistance = fDistance;
+        iBest = i;
+      }
+    }
+
+    return iBest;
+  }
+
+  struct BC6Endpoints
+  {
+    ezInt32 m_Values[2][3];
+  };
+
+  BC6Endpoints QuantizeBC6Endpoints(const ezSimdVec4f& vEndpoint0, const ezSimdVec4f& vEndpoint1)
+  {
+    float values[2][4];
+    vEndpoint0.Store<4>(values[0]);
+    vEndpoint1.Store<4>(values[1]);
+
+    BC6Endpoints endpoints;
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        endpoints.m_Values[e][c] = QuantizeBC6(values[e][c]);
+      }
+    }
+
+    return endpoints;
+  }
+
+  float EvaluateBC6(const ezSimdVec4f* pPoints, const BC6Endpoints& endpoints, ezUInt8* out_pIndices)
+  {
+    ezInt32 unquantized[2][3];
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        unquantized[e][c] = UnquantizeBC6(endpoints.m_Values[e][c]);
+      }
+    }
+
+    // the palette in the final half float bit space, same as the decoder produces it
+    ezSimdVec4f palette[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      ezInt32 rgb[3];
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const ezInt32 iInterpolated = (unquantized[0][c] * (64 - s_bc67Weights4[i]) + unquantized[1][c] * s_bc67Weights4[i] + 32) >> 6;
+        rgb[c] = (iInterpolated * 31) >> 6;
+      }
+
+      palette[i].Set(static_cast<float>(rgb[0]), static_cast<float>(rgb[1]), static_cast<float>(rgb[2]), 0.0f);
+    }
+
+    return FindClosestIndices(pPoints, s_uiNumTexelsPerBlock, palette, 16, out_pIndices);
+  }
+
+  float GetUnsignedHalfBits(ezFloat16 value)
+  {
+    const ezUInt16 uiBits = value.GetRawData();
+
+    // negative values and NaNs can't be represented, infinity becomes the largest finite value
+    if ((uiBits & 0x8000) != 0 || uiBits > 0x7C00)
+      return 0.0f;
+
+    return static_cast<float>(ezMath::Min<ezUInt16>(uiBits, 0x7BFF));
+  }
+} // namespace
+
+void ezCompressBlockBC6(const ezColorLinear16f* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  // Interpolation happens on the bit patterns of the half floats, which is close to a logarithmic scale.
+  // The error is measured in the same space, which weights dark and bright values roughly by their relative error.
+  ezSimdVec4f points[s_uiNumTexelsPerBlock];
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    points[i].Set(GetUnsignedHalfBits(pSource[i].r), GetUnsignedHalfBits(pSource[i].g), GetUnsignedHalfBits(pSource[i].b), 0.0f);
+  }
+
+  // the decoder scales the interpolated values by 31/64, so the endpoints live in a slightly larger range
+  const ezSimdFloat fToUnquantized = 64.0f / 31.0f;
+
+  ezSimdVec4f unquantizedPoints[s_uiNumTexelsPerBlock];
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    unquantizedPoints[i] = points[i] * fToUnquantized;
+  }
+
+  ezSimdVec4f vEndpoint0, vEndpoint1;
+  ComputeInitialEndpoints(unquantizedPoints, s_uiNumTexelsPerBlock, vEndpoint0, vEndpoint1);
+
+  BC6Endpoints endpoints = QuantizeBC6Endpoints(vEndpoint0, vEndpoint1);
+  ezUInt8 indices[s_uiNumTexelsPerBlock];
+  float fError = EvaluateBC6(points, endpoints, indices);
+
+  const ezUInt32 uiNumPasses = GetNumRefinementPasses(quality);
+  for (ezUInt32 uiPass = 0; uiPass < uiNumPasses && fError > 0.0f; ++uiPass)
+  {
+    float weights[s_uiNumTexelsPerBlock];
+    for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+    {
+      weights[i] = s_bc67Weights4[indices[i]] / 64.0f;
+    }
+
+    if (!SolveEndpoints(unquantizedPoints, weights, s_uiNumTexelsPerBlock, vEndpoint0, vEndpoint1))
+      break;
+
+    const BC6Endpoints newEndpoints = QuantizeBC6Endpoints(vEndpoint0, vEndpoint1);
+    ezUInt8 newIndices[s_uiNumTexelsPerBlock];
+    const float fNewError = EvaluateBC6(points, newEndpoints, newIndices);
+    if (fNewError >= fError)
+      break;
+
+    fError = fNewError;
+    endpoints = newEndpoints;
+    ezMemoryUtils::Copy(indices, newIndices, s_uiNumTexelsPerBlock);
+  }
+
+  // the most significant index bit of the first texel is implicitly zero
+  if (indices[0] >= 8)
+  {
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      ezMath::Swap(endpoints.m_Values[0][c], endpoints.m_Values[1][c]);
+    }
+
+    for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+    {
+      indices[i] = 15 - indices[i];
+    }
+  }
+
+  BitWriter writer(pTarget, 16);
+  writer.Write(0x03, 5);
+
+  for (ezUInt32 e = 0; e < 2; ++e)
+  {
+    for (ezUInt32 c = 0; c < 3; ++c)
+    {
+      writer.Write(endpoints.m_Values[e][c], 10);
+    }
+  }
+
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    writer.Write(indices[i], i == 0 ? 3 : 4);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// BC7
+
+namespace
+{
+  // Mode 6 of the format: a single region with RGBA 7 bit endpoints plus one p-bit per endpoint and 4 bit indices.
+
+  struct BC7Endpoints
+  {
+    ezInt32 m_Values[2][4]; // 7 bit values
+    ezUInt32 m_PBits[2];
+
+    ezInt32 GetExpanded(ezUInt32 uiEndpoint, ezUInt32 uiChannel) const { return (m_Values[uiEndpoint][uiChannel] << 1) | m_PBits[uiEndpoint]; }
+  };
+
+  float QuantizeBC7Endpoint(const ezSimdVec4f& vEndpoint, ezUInt32 uiPBit, ezInt32* out_pValues)
+  {
+    float values[4];
+    vEndpoint.Store<4>(values);
+
+    float fError = 0.0f;
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      out_pValues[c] = RoundAndClamp((values[c] - uiPBit) * 0.5f, 0, 127);
+
+      const float fDiff = static_cast<float>((out_pValues[c] << 1) | uiPBit) - values[c];
+      fError += fDiff * fDiff;
+    }
+
+    return fError;
+  }
+
+  BC7Endpoints QuantizeBC7Endpoints(const ezSimdVec4f& vEndpoint0, const ezSimdVec4f& vEndpoint1)
+  {
+    const ezSimdVec4f vEndpoints[2] = {vEndpoint0, vEndpoint1};
+
+    BC7Endpoints endpoints;
+    for (ezUInt32 e = 0; e < 2; ++e)
+    {
+      ezInt32 values[4];
+      const float fError0 = QuantizeBC7Endpoint(vEndpoints[e], 0, endpoints.m_Values[e]);
+      const float fError1 = QuantizeBC7Endpoint(vEndpoints[e], 1, values);
+
+      endpoints.m_PBits[e] = 0;
+      if (fError1 < fError0)
+      {
+        endpoints.m_PBits[e] = 1;
+        ezMemoryUtils::Copy(endpoints.m_Values[e], values, 4);
+      }
+    }
+
+    return endpoints;
+  }
+
+  float EvaluateBC7(const ezSimdVec4f* pPoints, const BC7Endpoints& endpoints, ezUInt8* out_pIndices)
+  {
+    ezSimdVec4f palette[16];
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      ezInt32 rgba[4];
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        rgba[c] = (endpoints.GetExpanded(0, c) * (64 - s_bc67Weights4[i]) + endpoints.GetExpanded(1, c) * s_bc67Weights4[i] + 32) >> 6;
+      }
+
+      palette[i].Set(static_cast<float>(rgba[0]), static_cast<float>(rgba[1]), static_cast<float>(rgba[2]), static_cast<float>(rgba[3]));
+    }
+
+    return FindClosestIndices(pPoints, s_uiNumTexelsPerBlock, palette, 16, out_pIndices);
+  }
+} // namespace
+
+void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality)
+{
+  ezSimdVec4f points[s_uiNumTexelsPerBlock];
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    points[i].Set(pSource[i].r, pSource[i].g, pSource[i].b, pSource[i].a);
+  }
+
+  ezSimdVec4f vEndpoint0, vEndpoint1;
+  ComputeInitialEndpoints(points, s_uiNumTexelsPerBlock, vEndpoint0, vEndpoint1);
+
+  BC7Endpoints endpoints = QuantizeBC7Endpoints(vEndpoint0, vEndpoint1);
+  ezUInt8 indices[s_uiNumTexelsPerBlock];
+  float fError = EvaluateBC7(points, endpoints, indices);
+
+  const ezUInt32 uiNumPasses = GetNumRefinementPasses(quality);
+  for (ezUInt32 uiPass = 0; uiPass < uiNumPasses && fError > 0.0f; ++uiPass)
+  {
+    float weights[s_uiNumTexelsPerBlock];
+    for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+    {
+      weights[i] = s_bc67Weights4[indices[i]] / 64.0f;
+    }
+
+    if (!SolveEndpoints(points, weights, s_uiNumTexelsPerBlock, vEndpoint0, vEndpoint1))
+      break;
+
+    const BC7Endpoints newEndpoints = QuantizeBC7Endpoints(vEndpoint0, vEndpoint1);
+    ezUInt8 newIndices[s_uiNumTexelsPerBlock];
+    const float fNewError = EvaluateBC7(points, newEndpoints, newIndices);
+    if (fNewError >= fError)
+      break;
+
+    fError = fNewError;
+    endpoints = newEndpoints;
+    ezMemoryUtils::Copy(indices, newIndices, s_uiNumTexelsPerBlock);
+  }
+
+  if (quality == ezBlockCompressionQuality::High && fError > 0.0f)
+  {
+    // the p-bits that fit the endpoints best are not necessarily the ones that fit the whole block best
+    for (ezUInt32 uiPBits = 0; uiPBits < 4; ++uiPBits)
+    {
+      BC7Endpoints newEndpoints;
+      newEndpoints.m_PBits[0] = uiPBits & 1u;
+      newEndpoints.m_PBits[1] = uiPBits >> 1;
+      QuantizeBC7Endpoint(vEndpoint0, newEndpoints.m_PBits[0], newEndpoints.m_Values[0]);
+      QuantizeBC7Endpoint(vEndpoint1, newEndpoints.m_PBits[1], newEndpoints.m_Values[1]);
+
+      ezUInt8 newIndices[s_uiNumTexelsPerBlock];
+      const float fNewError = EvaluateBC7(points, newEndpoints, newIndices);
+      if (fNewError < fError)
+      {
+        fError = fNewError;
+        endpoints = newEndpoints;
+        ezMemoryUtils::Copy(indices, newIndices, s_uiNumTexelsPerBlock);
+      }
+    }
+  }
+
+  // the most significant index bit of the first texel is implicitly zero
+  if (indices[0] >= 8)
+  {
+    for (ezUInt32 c = 0; c < 4; ++c)
+    {
+      ezMath::Swap(endpoints.m_Values[0][c], endpoints.m_Values[1][c]);
+    }
+
+    ezMath::Swap(endpoints.m_PBits[0], endpoints.m_PBits[1]);
+
+    for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+    {
+      indices[i] = 15 - indices[i];
+    }
+  }
+
+  BitWriter writer(pTarget, 16);
+  writer.Write(1u << 6, 7);
+
+  for (ezUInt32 c = 0; c < 4; ++c)
+  {
+    writer.Write(endpoints.m_Values[0][c], 7);
+    writer.Write(endpoints.m_Values[1][c], 7);
+  }
+
+  writer.Write(endpoints.m_PBits[0], 1);
+  writer.Write(endpoints.m_PBits[1], 1);
+
+  for (ezUInt32 i = 0; i < s_uiNumTexelsPerBlock; ++i)
+  {
+    writer.Write(indices[i], i == 0 ? 3 : 4);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+#if EZ_ENABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+  // prefer the DirectXTex compressor where it runs on the GPU, but not when it falls back to a software device
+  static const float s_fNativeCompressionPenalty = 100.0f;
+#else
+  static const float s_fNativeCompressionPenalty = 0.0f;
+#endif
+
+  ezImageConversionEntry MakeNativeCompressionEntry(ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, float fAdditionalPenalty = 0.0f)
+  {
+    ezImageConversionEntry entry(sourceFormat, targetFormat, ezImageConversionFlags::Default);
+    entry.m_additionalPenalty = s_fNativeCompressionPenalty + fAdditionalPenalty;
+    return entry;
+  }
+} // namespace
+
+// not in the anonymous namespace, since the parallel for lambda in ezImageConversion_CompressBlocksNative captures it
+struct ezNativeBlockCompressionJob
+{
+  const ezUInt8* m_pSource;
+  ezUInt8* m_pTarget;
+  ezUInt64 m_uiSourceRowPitch;
+  ezUInt32 m_uiSourceTexelSize;
+  ezUInt32 m_uiTargetBlockSize;
+  ezUInt32 m_uiNumBlocksX;
+  ezImageFormat::Enum m_SourceFormat;
+  ezImageFormat::Enum m_TargetFormat;
+  ezBlockCompressionQuality::Enum m_Quality;
+
+  void CompressBlockRows(ezUInt32 uiStartRow, ezUInt32 uiEndRow) const
+  {
+    // large enough for 16 texels of R16G16B16A16_FLOAT
+    ezUInt8 block[s_uiNumTexelsPerBlock * 8];
+
+    for (ezUInt32 uiBlockY = uiStartRow; uiBlockY < uiEndRow; ++uiBlockY)
+    {
+      for (ezUInt32 uiBlockX = 0; uiBlockX < m_uiNumBlocksX; ++uiBlockX)
+      {
+        for (ezUInt32 y = 0; y < 4; ++y)
+        {
+          const ezUInt8* pSourceRow = m_pSource + (4 * uiBlockY + y) * m_uiSourceRowPitch + 4 * uiBlockX * m_uiSourceTexelSize;
+          ezMemoryUtils::Copy(block + 4 * y * m_uiSourceTexelSize, pSourceRow, 4 * m_uiSourceTexelSize);
+        }
+
+        CompressBlock(block, m_pTarget + (uiBlockY * m_uiNumBlocksX + uiBlockX) * m_uiTargetBlockSize);
+      }
+    }
+  }
+
+  void CompressBlock(const ezUInt8* pBlock, ezUInt8* pTarget) const
+  {
+    // signed formats are shifted into the unsigned range, same as in the decoder
+    const ezUInt8 bias = ezImageFormat::GetDataType(m_SourceFormat) == ezImageFormatDataType::SNORM ? 128 : 0;
+
+    switch (m_TargetFormat)
+    {
+      case ezImageFormat::BC1_UNORM:
+      case ezImageFormat::BC1_UNORM_SRGB:
+        ezCompressBlockBC1(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget, false, m_Quality);
+        break;
+
+      case ezImageFormat::BC3_UNORM:
+      case ezImageFormat::BC3_UNORM_SRGB:
+        ezCompressBlockBC4(pBlock + 3, 4, pTarget, 0, m_Quality);
+        ezCompressBlockBC1(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget + 8, true, m_Quality);
+        break;
+
+      case ezImageFormat::BC4_UNORM:
+      case ezImageFormat::BC4_SNORM:
+        ezCompressBlockBC4(pBlock, m_uiSourceTexelSize, pTarget, bias, m_Quality);
+        break;
+
+      case ezImageFormat::BC5_UNORM:
+      case ezImageFormat::BC5_SNORM:
+        ezCompressBlockBC4(pBlock + 0, m_uiSourceTexelSize, pTarget + 0, bias, m_Quality);
+        ezCompressBlockBC4(pBlock + 1, m_uiSourceTexelSize, pTarget + 8, bias, m_Quality);
+        break;
+
+      case ezImageFormat::BC6H_UF16:
+        ezCompressBlockBC6(reinterpret_cast<const ezColorLinear16f*>(pBlock), pTarget, m_Quality);
+        break;
+
+      case ezImageFormat::BC7_UNORM:
+      case ezImageFormat::BC7_UNORM_SRGB:
+        ezCompressBlockBC7(reinterpret_cast<const ezColorBaseUB*>(pBlock), pTarget, m_Quality);
+        break;
+
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+    }
+  }
+};
+
+/// \brief Block compressor that doesn't depend on any platform specific library. Block rows are compressed in parallel.
+class ezImageConversion_CompressBlocksNative : public ezImageConversionStepCompressBlocks
+{
+public:
+  virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
+  {
+    // BC4 and BC5 are slightly penalized, the SSE 4.1 compressor in DXTConversions.cpp does an exhaustive search
+    static ezImageConversionEntry supportedConversions[] = {
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC1_UNORM),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC1_UNORM_SRGB),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC3_UNORM),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC3_UNORM_SRGB),
+      MakeNativeCompressionEntry(ezImageFormat::R8_UNORM, ezImageFormat::BC4_UNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R8_SNORM, ezImageFormat::BC4_SNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC4_UNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8_UNORM, ezImageFormat::BC5_UNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8_SNORM, ezImageFormat::BC5_SNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC5_UNORM, 1.0f),
+      MakeNativeCompressionEntry(ezImageFormat::R16G16B16A16_FLOAT, ezImageFormat::BC6H_UF16),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM, ezImageFormat::BC7_UNORM),
+      MakeNativeCompressionEntry(ezImageFormat::R8G8B8A8_UNORM_SRGB, ezImageFormat::BC7_UNORM_SRGB),
+    };
+    return supportedConversions;
+  }
+
+  virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
+    ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality) const override
+  {
+    ezNativeBlockCompressionJob job;
+    job.m_pSource = source.GetPtr();
+    job.m_pTarget = target.GetPtr();
+    job.m_uiSourceRowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
+    job.m_uiSourceTexelSize = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
+    job.m_uiTargetBlockSize = ezImageFormat::GetBitsPerBlock(targetFormat) / 8;
+    job.m_uiNumBlocksX = numBlocksX;
+    job.m_SourceFormat = sourceFormat;
+    job.m_TargetFormat = targetFormat;
+    job.m_Quality = quality;
+
+    ezTaskSystem::ParallelForIndexed(0, numBlocksY, [&job](ezUInt32 uiStartRow, ezUInt32 uiEndRow) { job.CompressBlockRows(uiStartRow, uiEndRow); },
+      "CompressBlocks");
+
+    return EZ_SUCCESS;
+  }
+};
+
+static ezImageConversion_CompressBlocksNative s_conversion_compressBlocksNative;
+
+EZ_STATICLINK_FILE(Texture, Texture_Image_Conversions_DXTCompression);
@@ -1997,7 +1997,8 @@ class ezImageConversion_CompressBC4 : public ezImageConversionStepCompressBlocks
   }
 
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat,
+                                  ezBlockCompressionQuality::Enum quality) const override
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
@@ -2054,7 +2055,8 @@ class ezImageConversion_CompressBC5 : public ezImageConversionStepCompressBlocks
   }
 
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const override
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat,
+                                  ezBlockCompressionQuality::Enum quality) const override
   {
     ezUInt32 stride = ezImageFormat::GetBitsPerPixel(sourceFormat) / 8;
     ezUInt64 rowPitch = ezImageFormat::GetRowPitch(sourceFormat, 4 * numBlocksX);
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
 
 class ezColorLinear16f;
 
@@ -11,3 +11,22 @@ EZ_TEXTURE_DLL void ezDecompressBlockBC7(const ezUInt8* pSource, ezColorBaseUB*
 
 EZ_TEXTURE_DLL void ezUnpackPaletteBC4(ezUInt32 a0, ezUInt32 a1, ezUInt32* alphas);
 
+/// \brief Compresses 16 texels (4x4, row by row) into an 8 byte BC1 block.
+///
+/// Unless \a bForceFourColorMode is set, texels with an alpha value below 128 are encoded as transparent.
+EZ_TEXTURE_DLL void ezCompressBlockBC1(const ezColorBaseUB* pSource, ezUInt8* pTarget, bool bForceFourColorMode, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 single channel values into an 8 byte BC4 block. Same meaning of \a uiStride and \a bias as in ezDecompressBlockBC4().
+EZ_TEXTURE_DLL void ezCompressBlockBC4(const ezUInt8* pSource, ezUInt32 uiStride, ezUInt8* pTarget, ezUInt8 bias, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 texels into an unsigned 16 byte BC6H block. Negative values and NaNs are encoded as zero.
+///
+/// Only mode 11 (a single region with 10 bit endpoints) is used, so blocks with several distinct colors are approximated by one line segment.
+EZ_TEXTURE_DLL void ezCompressBlockBC6(const ezColorLinear16f* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
+/// \brief Compresses 16 texels into a 16 byte BC7 block.
+///
+/// Only mode 6 (a single subset with RGBA 7 bit endpoints and p-bits) is used. The partitioned modes are not searched, so blocks with
+/// several distinct colors have a higher error than with a full BC7 encoder.
+EZ_TEXTURE_DLL void ezCompressBlockBC7(const ezColorBaseUB* pSource, ezUInt8* pTarget, ezBlockCompressionQuality::Enum quality);
+
@@ -254,6 +254,144 @@ static bool IsAligned(const void* pointer)
 
 #endif
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+
+namespace
+{
+  EZ_ALWAYS_INLINE __m128i SelectInt(__m128i mask, __m128i a, __m128i b)
+  {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+
+  // Packs the lower 16 bits of each lane without saturation (_mm_packus_epi32 would require SSE 4.1)
+  EZ_ALWAYS_INLINE __m128i PackLow16(__m128i a, __m128i b)
+  {
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+  }
+
+  // Same result as ezFloat16::operator float() for the halfs stored in the lower 16 bits of each lane
+  EZ_ALWAYS_INLINE __m128 HalfToFloat(__m128i halfs)
+  {
+    const __m128i exponentMantissa = _mm_and_si128(halfs, _mm_set1_epi32(0x7fff));
+    const __m128i sign = _mm_slli_epi32(_mm_and_si128(halfs, _mm_set1_epi32(0x8000)), 16);
+
+    // Rebias the exponent, infinity and NaN have to end up at the maximum float exponent
+    const __m128i isInfNaN = _mm_cmpgt_epi32(exponentMantissa, _mm_set1_epi32(0x7bff));
+    __m128i result = _mm_add_epi32(_mm_slli_epi32(exponentMantissa, 13), _mm_set1_epi32(112 << 23));
+    result = _mm_add_epi32(result, _mm_and_si128(isInfNaN, _mm_set1_epi32(112 << 23)));
+
+    // Denormalized halfs (and zero) are exactly representable as normalized floats
+    const __m128i isDenormal = _mm_cmplt_epi32(exponentMantissa, _mm_set1_epi32(0x0400));
+    const __m128 denormal = _mm_mul_ps(_mm_cvtepi32_ps(exponentMantissa), _mm_set1_ps(1.0f / 16777216.0f));
+    result = SelectInt(isDenormal, _mm_castps_si128(denormal), result);
+
+    return _mm_castsi128_ps(_mm_or_si128(result, sign));
+  }
+
+  // Same result as ezFloat16::operator=(float), except for values that end up as denormalized halfs.
+  // Those lanes are flagged in out_denormalMask and have to be converted with the scalar code.
+  EZ_ALWAYS_INLINE __m128i FloatToHalf(__m128 floats, __m128i& out_denormalMask)
+  {
+    const __m128i bits = _mm_castps_si128(floats);
+    const __m128i absBits = _mm_and_si128(bits, _mm_set1_epi32(0x7fffffff));
+    const __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+    const __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(absBits, 23), _mm_set1_epi32(112));
+
+    // Normalized halfs, the mantissa is truncated
+    __m128i result = _mm_sub_epi32(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(112 << 10));
+
+    // Overflow goes to infinity, NaN keeps the upper mantissa bits but at least one of them has to be set
+    const __m128i isNaN = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(0x7f800000));
+    const __m128i nanMantissa = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(0x3ff));
+    const __m128i nanBits = _mm_or_si128(nanMantissa, _mm_srli_epi32(_mm_cmpeq_epi32(nanMantissa, _mm_setzero_si128()), 31));
+    const __m128i overflow = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(isNaN, nanBits));
+    result = SelectInt(_mm_cmpgt_epi32(exponent, _mm_set1_epi32(30)), overflow, result);
+
+    result = _mm_or_si128(result, sign);
+
+    // Underflow goes to zero (without sign)
+    const __m128i isSmall = _mm_cmplt_epi32(exponent, _mm_set1_epi32(1));
+    out_denormalMask = _mm_andnot_si128(_mm_cmplt_epi32(exponent, _mm_set1_epi32(-10)), isSmall);
+
+    return _mm_andnot_si128(isSmall, result);
+  }
+} // namespace
+
+#endif
+
+namespace
+{
+  // Lookup tables that produce the same results as the ezColorGammaUB <-> ezColor conversions,
+  // but don't have to evaluate pow() for every channel
+  struct ezSrgbTables
+  {
+    ezSrgbTables()
+    {
+      for (ezUInt32 i = 0; i < 256; ++i)
+      {
+        m_GammaToLinear[i] = ezColor::GammaToLinear(ezMath::ColorByteToFloat(static_cast<ezUInt8>(i)));
+      }
+
+      // m_LinearThresholds[i] is the smallest linear value that is encoded as i or above,
+      // found by bisecting the bit patterns of all floats in [0, 1]
+      m_LinearThresholds[0] = 0.0f;
+      for (ezUInt32 i = 1; i < 256; ++i)
+      {
+        ezUInt32 uiLow = 0;
+        ezUInt32 uiHigh = 0x3f800000;
+        while (uiLow < uiHigh)
+        {
+          const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+          if (Encode(ezIntFloatUnion(uiMid).f) >= i)
+            uiHigh = uiMid;
+          else
+            uiLow = uiMid + 1;
+        }
+
+        m_LinearThresholds[i] = ezIntFloatUnion(uiLow).f;
+      }
+      m_LinearThresholds[256] = ezMath::Infinity<float>();
+
+      // The upper bits of a float select a bucket that spans at most two encoded values
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(m_BucketStart); ++i)
+      {
+        m_BucketStart[i] = Encode(ezIntFloatUnion(i << 16).f);
+      }
+    }
+
+    static ezUInt8 Encode(float linear) { return ezMath::ColorFloatToByte(ezColor::LinearToGamma(linear)); }
+
+    EZ_ALWAYS_INLINE ezUInt8 LinearToGamma(float linear) const
+    {
+      const ezUInt32 uiBits = ezIntFloatUnion(linear).i;
+
+      // Values of one and above saturate, negative values and NaN are encoded as zero
+      if (uiBits >= 0x3f800000)
+        return uiBits <= 0x7f800000 ? 255 : 0;
+
+      ezUInt32 uiIndex = m_BucketStart[uiBits >> 16];
+      while (linear >= m_LinearThresholds[uiIndex + 1])
+      {
+        ++uiIndex;
+      }
+
+      return static_cast<ezUInt8>(uiIndex);
+    }
+
+    float m_GammaToLinear[256];
+    float m_LinearThresholds[257];
+    ezUInt8 m_BucketStart[0x3f80];
+  };
+
+  const ezSrgbTables& GetSrgbTables()
+  {
+    static ezSrgbTables tables;
+    return tables;
+  }
+} // namespace
+
 struct ezImageSwizzleConversion32_2103 : public ezImageConversionStepLinear
 {
   virtual ezArrayPtr<const ezImageConversionEntry> GetSupportedConversions() const override
@@ -523,9 +661,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const ezSrgbTables& tables = GetSrgbTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColorGammaUB*>(targetPointer) = *reinterpret_cast<const ezColor*>(sourcePointer);
+      const float* sourceColor = reinterpret_cast<const float*>(sourcePointer);
+      ezUInt8* targetColor = reinterpret_cast<ezUInt8*>(targetPointer);
+
+      targetColor[0] = tables.LinearToGamma(sourceColor[0]);
+      targetColor[1] = tables.LinearToGamma(sourceColor[1]);
+      targetColor[2] = tables.LinearToGamma(sourceColor[2]);
+      targetColor[3] = ezMath::ColorFloatToByte(sourceColor[3]);
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -562,6 +708,41 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      __m128 zero = _mm_setzero_ps();
+      __m128 one = _mm_set1_ps(1.0f);
+      __m128 scale = _mm_set1_ps(65535.0f);
+      __m128 half = _mm_set1_ps(0.5f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128 float0 = _mm_loadu_ps(static_cast<const float*>(sourcePointer) + 0);
+        __m128 float1 = _mm_loadu_ps(static_cast<const float*>(sourcePointer) + 4);
+
+        // Clamp NaN to zero
+        float0 = _mm_and_ps(_mm_cmpord_ps(float0, zero), float0);
+        float1 = _mm_and_ps(_mm_cmpord_ps(float1, zero), float1);
+
+        // Saturate
+        float0 = _mm_max_ps(zero, _mm_min_ps(one, float0));
+        float1 = _mm_max_ps(zero, _mm_min_ps(one, float1));
+
+        // Scale, add 0.5f and truncate for rounding as required by D3D spec
+        __m128i int0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(float0, scale), half));
+        __m128i int1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(float1, scale), half));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer), PackLow16(int0, int1));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
 
@@ -601,6 +782,36 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i denormal0, denormal1;
+        __m128i half0 = FloatToHalf(_mm_loadu_ps(static_cast<const float*>(sourcePointer) + 0), denormal0);
+        __m128i half1 = FloatToHalf(_mm_loadu_ps(static_cast<const float*>(sourcePointer) + 4), denormal1);
+
+        if (_mm_movemask_epi8(_mm_or_si128(denormal0, denormal1)) == 0)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer), PackLow16(half0, half1));
+        }
+        else
+        {
+          // Denormalized halfs are rare enough to not bother vectorizing them
+          for (ezUInt32 i = 0; i < elementsPerBatch; ++i)
+          {
+            static_cast<ezFloat16*>(targetPointer)[i] = static_cast<const float*>(sourcePointer)[i];
+          }
+        }
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
 
@@ -641,6 +852,47 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 16;
+
+      __m128 zero = _mm_setzero_ps();
+      __m128 minusOne = _mm_set1_ps(-1.0f);
+      __m128 one = _mm_set1_ps(1.0f);
+      __m128 scale = _mm_set1_ps(127.0f);
+      __m128 half = _mm_set1_ps(0.5f);
+      __m128 signMask = _mm_set1_ps(-0.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i ints[4];
+        for (ezUInt32 i = 0; i < 4; ++i)
+        {
+          __m128 value = _mm_loadu_ps(static_cast<const float*>(sourcePointer) + i * 4);
+
+          // Clamp NaN to zero
+          value = _mm_and_ps(_mm_cmpord_ps(value, zero), value);
+
+          value = _mm_mul_ps(_mm_max_ps(minusOne, _mm_min_ps(one, value)), scale);
+
+          // Round away from zero by adding +-0.5f and truncating
+          value = _mm_add_ps(value, _mm_or_ps(half, _mm_and_ps(value, signMask)));
+
+          ints[i] = _mm_cvttps_epi32(value);
+        }
+
+        __m128i short0 = _mm_packs_epi32(ints[0], ints[1]);
+        __m128i short1 = _mm_packs_epi32(ints[2], ints[3]);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(targetPointer), _mm_packs_epi16(short0, short1));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
 
@@ -681,6 +933,33 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 16;
+
+      __m128i zero = _mm_setzero_si128();
+      __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i bytes = _mm_loadu_si128(static_cast<const __m128i*>(sourcePointer));
+
+        __m128i short0 = _mm_unpacklo_epi8(bytes, zero);
+        __m128i short1 = _mm_unpackhi_epi8(bytes, zero);
+
+        float* targetFloats = static_cast<float*>(targetPointer);
+        _mm_storeu_ps(targetFloats + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(short0, zero)), scale));
+        _mm_storeu_ps(targetFloats + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(short0, zero)), scale));
+        _mm_storeu_ps(targetFloats + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(short1, zero)), scale));
+        _mm_storeu_ps(targetFloats + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(short1, zero)), scale));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorByteToFloat(*reinterpret_cast<const ezUInt8*>(sourcePointer));
@@ -714,9 +993,17 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+    const ezSrgbTables& tables = GetSrgbTables();
+
     while (numElements)
     {
-      *reinterpret_cast<ezColor*>(targetPointer) = *reinterpret_cast<const ezColorGammaUB*>(sourcePointer);
+      const ezUInt8* sourceColor = reinterpret_cast<const ezUInt8*>(sourcePointer);
+      float* targetColor = reinterpret_cast<float*>(targetPointer);
+
+      targetColor[0] = tables.m_GammaToLinear[sourceColor[0]];
+      targetColor[1] = tables.m_GammaToLinear[sourceColor[1]];
+      targetColor[2] = tables.m_GammaToLinear[sourceColor[2]];
+      targetColor[3] = ezMath::ColorByteToFloat(sourceColor[3]);
 
       sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride);
       targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride);
@@ -753,6 +1040,28 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      __m128i zero = _mm_setzero_si128();
+      __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i shorts = _mm_loadu_si128(static_cast<const __m128i*>(sourcePointer));
+
+        float* targetFloats = static_cast<float*>(targetPointer);
+        _mm_storeu_ps(targetFloats + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(shorts, zero)), scale));
+        _mm_storeu_ps(targetFloats + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(shorts, zero)), scale));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorShortToFloat(*reinterpret_cast<const ezUInt16*>(sourcePointer));
@@ -791,6 +1100,27 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 8;
+
+      __m128i zero = _mm_setzero_si128();
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i halfs = _mm_loadu_si128(static_cast<const __m128i*>(sourcePointer));
+
+        float* targetFloats = static_cast<float*>(targetPointer);
+        _mm_storeu_ps(targetFloats + 0, HalfToFloat(_mm_unpacklo_epi16(halfs, zero)));
+        _mm_storeu_ps(targetFloats + 4, HalfToFloat(_mm_unpackhi_epi16(halfs, zero)));
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = *reinterpret_cast<const ezFloat16*>(sourcePointer);
@@ -829,6 +1159,46 @@ public:
     const void* sourcePointer = source.GetPtr();
     void* targetPointer = target.GetPtr();
 
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+    {
+      const ezUInt32 elementsPerBatch = 16;
+
+      __m128 scale = _mm_set1_ps(1.0f / 127.0f);
+      __m128i minInt = _mm_set1_epi32(-128);
+      __m128 minusOne = _mm_set1_ps(-1.0f);
+
+      while (numElements >= elementsPerBatch)
+      {
+        __m128i bytes = _mm_loadu_si128(static_cast<const __m128i*>(sourcePointer));
+
+        // Sign extend by moving each byte to the top of its lane and shifting it back down
+        __m128i short0 = _mm_unpacklo_epi8(bytes, bytes);
+        __m128i short1 = _mm_unpackhi_epi8(bytes, bytes);
+
+        __m128i ints[4];
+        ints[0] = _mm_srai_epi32(_mm_unpacklo_epi16(short0, short0), 24);
+        ints[1] = _mm_srai_epi32(_mm_unpackhi_epi16(short0, short0), 24);
+        ints[2] = _mm_srai_epi32(_mm_unpacklo_epi16(short1, short1), 24);
+        ints[3] = _mm_srai_epi32(_mm_unpackhi_epi16(short1, short1), 24);
+
+        float* targetFloats = static_cast<float*>(targetPointer);
+        for (ezUInt32 i = 0; i < 4; ++i)
+        {
+          // -128 and -127 both map to -1
+          __m128 value = _mm_mul_ps(_mm_cvtepi32_ps(ints[i]), scale);
+          __m128 isMin = _mm_castsi128_ps(_mm_cmpeq_epi32(ints[i], minInt));
+          value = _mm_or_ps(_mm_and_ps(isMin, minusOne), _mm_andnot_ps(isMin, value));
+
+          _mm_storeu_ps(targetFloats + i * 4, value);
+        }
+
+        sourcePointer = ezMemoryUtils::AddByteOffset(sourcePointer, sourceStride * elementsPerBatch);
+        targetPointer = ezMemoryUtils::AddByteOffset(targetPointer, targetStride * elementsPerBatch);
+        numElements -= elementsPerBatch;
+      }
+    }
+#endif
+
     while (numElements)
     {
       *reinterpret_cast<float*>(targetPointer) = ezMath::ColorSignedByteToFloat(*reinterpret_cast<const ezInt8*>(sourcePointer));
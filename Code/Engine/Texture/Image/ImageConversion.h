@@ -8,6 +8,21 @@
 
 EZ_DECLARE_FLAGS(ezUInt8, ezImageConversionFlags, InPlace);
 
+/// \brief How much time block compressors spend on searching for better endpoints.
+struct ezBlockCompressionQuality
+{
+  using StorageType = ezUInt8;
+
+  enum Enum
+  {
+    Fast,   ///< Endpoints from the principal axis of the block, no refinement.
+    Normal, ///< A few least squares refinement passes.
+    High,   ///< More refinement passes and an additional search around the found endpoints.
+
+    Default = Normal
+  };
+};
+
 /// A structure describing the pairs of source/target format that may be converted using the conversion routine.
 struct ezImageConversionEntry
 {
@@ -70,9 +85,10 @@ public:
 class EZ_TEXTURE_DLL ezImageConversionStepCompressBlocks : public ezImageConversionStep
 {
 public:
-  /// \brief Compresses the given number of blocks.
+  /// \brief Compresses the given number of blocks. Implementations that have no notion of \a quality may ignore it.
   virtual ezResult CompressBlocks(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numBlocksX, ezUInt32 numBlocksY,
-                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat) const = 0;
+                                  ezImageFormat::Enum sourceFormat, ezImageFormat::Enum targetFormat,
+                                  ezBlockCompressionQuality::Enum quality) const = 0;
 };
 
 
@@ -119,10 +135,14 @@ public:
                             ezHybridArray<ConversionPathNode, 16>& path_out, ezUInt32& numScratchBuffers_out);
 
   /// \brief  Converts the source image into a target image with the given format. Source and target may be the same.
-  static ezResult Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat);
+  ///
+  /// \a quality is passed to the block compressor when the target format is compressed.
+  static ezResult Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat,
+                          ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::Default);
 
   /// \brief Converts the source image into a target image using a precomputed conversion path.
-  static ezResult Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path, ezUInt32 numScratchBuffers);
+  static ezResult Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path, ezUInt32 numScratchBuffers,
+                          ezBlockCompressionQuality::Enum quality = ezBlockCompressionQuality::Default);
 
   /// \brief Converts the raw source data into a target data buffer with the given format. Source and target may be the same.
   static ezResult ConvertRaw(ezConstByteBlobPtr source, ezByteBlobPtr target, ezUInt32 numElements, ezImageFormat::Enum sourceFormat,
@@ -137,13 +157,14 @@ private:
   ezImageConversion(const ezImageConversion&);
 
   static ezResult ConvertSingleStep(const ezImageConversionStep* pStep, const ezImageView& source, ezImage& target,
-                                    ezImageFormat::Enum targetFormat);
+                                    ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality);
 
   static ezResult ConvertSingleStepDecompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
                                               ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
 
   static ezResult ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
-                                            ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep);
+                                            ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep,
+                                            ezBlockCompressionQuality::Enum quality);
 
   static void RebuildConversionTable();
 };
@@ -2,6 +2,8 @@
 
 #include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Math.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
 
 #include <Texture/Image/ImageConversion.h>
 
@@ -140,6 +142,38 @@ namespace
       return scratchBuffers.GetCount() - 1;
     }
   }
+
+  /// \brief Splits a linear conversion into chunks of pixels that are converted in parallel.
+  struct LinearConversionJob
+  {
+    static constexpr ezUInt64 s_uiNumPixelsPerChunk = 64 * 1024;
+
+    const ezImageConversionStepLinear* m_pStep = nullptr;
+    ezConstByteBlobPtr m_Source;
+    ezByteBlobPtr m_Target;
+    ezUInt64 m_uiNumPixels = 0;
+    ezUInt32 m_uiSourceBytesPerPixel = 0;
+    ezUInt32 m_uiTargetBytesPerPixel = 0;
+    ezImageFormat::Enum m_SourceFormat = ezImageFormat::UNKNOWN;
+    ezImageFormat::Enum m_TargetFormat = ezImageFormat::UNKNOWN;
+    ezAtomicInteger32 m_iNumFailedChunks;
+
+    ezUInt32 GetNumChunks() const { return static_cast<ezUInt32>((m_uiNumPixels + s_uiNumPixelsPerChunk - 1) / s_uiNumPixelsPerChunk); }
+
+    void ConvertChunks(ezUInt32 uiStartChunk, ezUInt32 uiEndChunk)
+    {
+      const ezUInt64 uiFirstPixel = uiStartChunk * s_uiNumPixelsPerChunk;
+      const ezUInt64 uiNumPixels = ezMath::Min(uiEndChunk * s_uiNumPixelsPerChunk, m_uiNumPixels) - uiFirstPixel;
+
+      ezConstByteBlobPtr source = m_Source.GetSubArray(uiFirstPixel * m_uiSourceBytesPerPixel, uiNumPixels * m_uiSourceBytesPerPixel);
+      ezByteBlobPtr target = m_Target.GetSubArray(uiFirstPixel * m_uiTargetBytesPerPixel, uiNumPixels * m_uiTargetBytesPerPixel);
+
+      if (m_pStep->ConvertPixels(source, target, uiNumPixels, m_SourceFormat, m_TargetFormat).Failed())
+      {
+        m_iNumFailedChunks.Increment();
+      }
+    }
+  };
 } // namespace
 
 ezImageConversionStep::ezImageConversionStep()
@@ -364,7 +398,8 @@ void ezImageConversion::RebuildConversionTable()
   s_conversionTableValid = true;
 }
 
-ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat)
+ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezImageFormat::Enum targetFormat,
+                                    ezBlockCompressionQuality::Enum quality)
 {
   ezImageFormat::Enum sourceFormat = source.GetImageFormat();
 
@@ -386,11 +421,11 @@ ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target,
     return EZ_FAILURE;
   }
 
-  return Convert(source, target, path, numScratchBuffers);
+  return Convert(source, target, path, numScratchBuffers, quality);
 }
 
 ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target, ezArrayPtr<ConversionPathNode> path,
-                                    ezUInt32 numScratchBuffers)
+                                    ezUInt32 numScratchBuffers, ezBlockCompressionQuality::Enum quality)
 {
   EZ_ASSERT_DEV(path.GetCount() > 0, "Invalid conversion path");
   EZ_ASSERT_DEV(path[0].m_sourceFormat == source.GetImageFormat(), "Invalid conversion path");
@@ -406,7 +441,7 @@ ezResult ezImageConversion::Convert(const ezImageView& source, ezImage& target,
 
     ezImage* pTarget = targetIndex == 0 ? &target : &intermediates[targetIndex - 1];
 
-    if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat).Failed())
+    if (ConvertSingleStep(path[i].m_step, *pSource, *pTarget, path[i].m_targetFormat, quality).Failed())
     {
       return EZ_FAILURE;
     }
@@ -504,7 +539,7 @@ ezResult ezImageConversion::ConvertRaw(ezConstByteBlobPtr source, ezByteBlobPtr
 }
 
 ezResult ezImageConversion::ConvertSingleStep(const ezImageConversionStep* pStep, const ezImageView& source, ezImage& target,
-                                              ezImageFormat::Enum targetFormat)
+                                              ezImageFormat::Enum targetFormat, ezBlockCompressionQuality::Enum quality)
 {
   if (!pStep)
   {
@@ -525,12 +560,36 @@ ezResult ezImageConversion::ConvertSingleStep(const ezImageConversionStep* pStep
       // we have to do the computation in 64-bit otherwise it might overflow for very large textures (8k x 4k or bigger).
       ezUInt64 numElements =
           ezUInt64(8) * target.GetByteBlobPtr().GetCount() / (ezUInt64)ezImageFormat::GetBitsPerPixel(targetFormat);
-      return static_cast<const ezImageConversionStepLinear*>(pStep)->ConvertPixels(source.GetByteBlobPtr(), target.GetByteBlobPtr(),
-                                                                                   (ezUInt32)numElements, sourceFormat, targetFormat);
+
+      const ezUInt32 sourceBpp = ezImageFormat::GetBitsPerPixel(sourceFormat);
+      const ezUInt32 targetBpp = ezImageFormat::GetBitsPerPixel(targetFormat);
+
+      // Chunks have to start at byte boundaries
+      if (numElements <= LinearConversionJob::s_uiNumPixelsPerChunk || sourceBpp % 8 != 0 || targetBpp % 8 != 0)
+      {
+        return static_cast<const ezImageConversionStepLinear*>(pStep)->ConvertPixels(
+          source.GetByteBlobPtr(), target.GetByteBlobPtr(), numElements, sourceFormat, targetFormat);
+      }
+
+      LinearConversionJob job;
+      job.m_pStep = static_cast<const ezImageConversionStepLinear*>(pStep);
+      job.m_Source = source.GetByteBlobPtr();
+      job.m_Target = target.GetByteBlobPtr();
+      job.m_uiNumPixels = numElements;
+      job.m_uiSourceBytesPerPixel = sourceBpp / 8;
+      job.m_uiTargetBytesPerPixel = targetBpp / 8;
+      job.m_SourceFormat = sourceFormat;
+      job.m_TargetFormat = targetFormat;
+
+      ezTaskSystem::ParallelForIndexed(
+        0, job.GetNumChunks(), [&job](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) { job.ConvertChunks(uiStartChunk, uiEndChunk); },
+        "ConvertImage");
+
+      return job.m_iNumFailedChunks == 0 ? EZ_SUCCESS : EZ_FAILURE;
     }
     else
     {
-      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep);
+      return ConvertSingleStepCompress(source, target, sourceFormat, targetFormat, pStep, quality);
     }
   }
   else
@@ -604,7 +663,8 @@ ezResult ezImageConversion::ConvertSingleStepDecompress(const ezImageView& sourc
 }
 
 ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source, ezImage& target, ezImageFormat::Enum sourceFormat,
-                                                      ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep)
+                                                      ezImageFormat::Enum targetFormat, const ezImageConversionStep* pStep,
+                                                      ezBlockCompressionQuality::Enum quality)
 {
   for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
   {
@@ -651,7 +711,7 @@ ezResult ezImageConversion::ConvertSingleStepCompress(const ezImageView& source,
 
           ezResult result = static_cast<const ezImageConversionStepCompressBlocks*>(pStep)->CompressBlocks(
               paddedSlice.GetByteBlobPtr(), target.GetSliceView(mipLevel, face, arrayIndex, slice).GetByteBlobPtr(), numBlocksX, numBlocksY,
-              sourceFormat, targetFormat);
+              sourceFormat, targetFormat, quality);
 
           if (result.Failed())
           {
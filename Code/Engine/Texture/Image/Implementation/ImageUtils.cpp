@@ -3,6 +3,7 @@
 #include <Texture/Image/ImageUtils.h>
 
 #include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Texture/Image/ImageConversion.h>
 #include <Texture/Image/ImageEnums.h>
 #include <Texture/Image/ImageFilter.h>
@@ -648,6 +649,127 @@ inline static void FilterLine(ezUInt32 numSourceElements, const ezSimdVec4f* __r
   }
 }
 
+namespace
+{
+  /// \brief Below this number of pixels a task isn't worth its overhead, smaller images are filtered on the calling thread.
+  static constexpr ezUInt32 s_uiMinNumPixelsPerTask = 16 * 1024;
+
+  /// \brief One separable filter pass of Scale3D. The passes are executed in parallel over the rows of the pass' target image.
+  struct FilterPass
+  {
+    const ezImageView* m_pSource = nullptr;
+    ezImage* m_pTarget = nullptr;
+    const ezImageFilterWeights* m_pWeights = nullptr;
+    ezArrayPtr<const ezInt32> m_FirstSampleIndices;
+    ezImageAddressMode::Enum m_AddressMode = ezImageAddressMode::Clamp;
+    ezSimdVec4f m_BorderColor;
+
+    ezUInt32 GetNumRows() const
+    {
+      return m_pTarget->GetHeight() * m_pTarget->GetDepth() * m_pTarget->GetNumFaces() * m_pTarget->GetNumArrayIndices();
+    }
+
+    ezParallelForParams GetParallelForParams() const
+    {
+      ezParallelForParams params;
+      params.uiBinSize = ezMath::Max(1u, s_uiMinNumPixelsPerTask / m_pTarget->GetWidth());
+      return params;
+    }
+
+    void GetRowCoordinates(ezUInt32 uiRow, ezUInt32& out_uiY, ezUInt32& out_uiZ, ezUInt32& out_uiFace, ezUInt32& out_uiArrayIndex) const
+    {
+      out_uiY = uiRow % m_pTarget->GetHeight();
+      uiRow /= m_pTarget->GetHeight();
+      out_uiZ = uiRow % m_pTarget->GetDepth();
+      uiRow /= m_pTarget->GetDepth();
+      out_uiFace = uiRow % m_pTarget->GetNumFaces();
+      out_uiArrayIndex = uiRow / m_pTarget->GetNumFaces();
+    }
+
+    /// \brief Filters along x, every target row is computed from the source row at the same position.
+    void FilterRowsX(ezUInt32 uiStartRow, ezUInt32 uiEndRow) const
+    {
+      ezUInt32 y, z, face, arrayIndex;
+
+      for (ezUInt32 uiRow = uiStartRow; uiRow < uiEndRow; ++uiRow)
+      {
+        GetRowCoordinates(uiRow, y, z, face, arrayIndex);
+
+        const ezSimdVec4f* filterSource = m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+        ezSimdVec4f* filterTarget = m_pTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+        FilterLine(m_pSource->GetWidth(), filterSource, filterTarget, 1, *m_pWeights, m_FirstSampleIndices, m_AddressMode, m_BorderColor);
+      }
+    }
+
+    /// \brief Filters along y or z. Every target row is a weighted sum of whole source rows, which keeps all memory accesses linear
+    /// instead of walking down the columns of the image.
+    void FilterRowsYZ(ezUInt32 uiStartRow, ezUInt32 uiEndRow, bool bFilterDepth) const
+    {
+      const ezUInt32 uiNumWeights = m_pWeights->GetNumWeights();
+      const ezUInt32 uiNumSourceElements = bFilterDepth ? m_pSource->GetDepth() : m_pSource->GetHeight();
+      const ezUInt32 uiWidth = m_pTarget->GetWidth();
+
+      ezHybridArray<const ezSimdVec4f*, 16> sourceRows;
+      ezHybridArray<float, 16> sourceRowWeights;
+      sourceRows.SetCountUninitialized(uiNumWeights);
+      sourceRowWeights.SetCountUninitialized(uiNumWeights);
+
+      ezUInt32 y, z, face, arrayIndex;
+
+      for (ezUInt32 uiRow = uiStartRow; uiRow < uiEndRow; ++uiRow)
+      {
+        GetRowCoordinates(uiRow, y, z, face, arrayIndex);
+
+        const ezUInt32 uiTargetIndex = bFilterDepth ? z : y;
+        const ezInt32 iFirstSourceIndex = m_FirstSampleIndices[uiTargetIndex];
+
+        // resolve the address mode once per row, samples outside of the image that use the border color are folded into a constant
+        ezSimdFloat borderWeight = 0.0f;
+        ezUInt32 uiNumSourceRows = 0;
+
+        for (ezUInt32 weightIdx = 0; weightIdx < uiNumWeights; ++weightIdx)
+        {
+          bool bUseBorderColor = false;
+          const ezUInt32 uiSourceIndex =
+            ezImageUtils::GetSampleIndex(uiNumSourceElements, iFirstSourceIndex + static_cast<ezInt32>(weightIdx), m_AddressMode, bUseBorderColor);
+          const ezSimdFloat weight = m_pWeights->GetWeight(uiTargetIndex, weightIdx);
+
+          if (bUseBorderColor)
+          {
+            borderWeight += weight;
+            continue;
+          }
+
+          sourceRows[uiNumSourceRows] = bFilterDepth ? m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, uiSourceIndex)
+                                                     : m_pSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, uiSourceIndex, z);
+          sourceRowWeights[uiNumSourceRows] = weight;
+          ++uiNumSourceRows;
+        }
+
+        const ezSimdVec4f borderContribution = m_BorderColor * borderWeight;
+        ezSimdVec4f* __restrict filterTarget = m_pTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
+
+        for (ezUInt32 x = 0; x < uiWidth; ++x)
+        {
+          filterTarget[x] = borderContribution;
+        }
+
+        // accumulate one source row at a time, the target row stays in the cache
+        for (ezUInt32 i = 0; i < uiNumSourceRows; ++i)
+        {
+          const ezSimdVec4f* __restrict sourceRow = sourceRows[i];
+          const ezSimdVec4f weight(sourceRowWeights[i]);
+
+          for (ezUInt32 x = 0; x < uiWidth; ++x)
+          {
+            filterTarget[x] = ezSimdVec4f::MulAdd(sourceRow[x], weight, filterTarget[x]);
+          }
+        }
+      }
+    }
+  };
+} // namespace
+
 static void DownScaleFastLine(
   ezUInt32 pixelStride, const ezUInt8* src, ezUInt8* dest, ezUInt32 lengthIn, ezUInt32 strideIn, ezUInt32 lengthOut, ezUInt32 strideOut)
 {
@@ -715,7 +837,7 @@ static void DownScaleFast(const ezImageView& image, ezImage& out_Result, ezUInt3
   outHeader.SetWidth(width);
   outHeader.SetHeight(height);
   outHeader.SetNumArrayIndices(numArrayElements);
-  outHeader.SetNumArrayIndices(numFaces);
+  outHeader.SetNumFaces(numFaces);
   outHeader.SetImageFormat(format);
 
   out_Result.ResetAndAlloc(outHeader);
@@ -915,6 +1037,9 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
   ezHybridArray<ezInt32, 256> firstSampleIndices;
   firstSampleIndices.Reserve(ezMath::Max(width, height, depth));
 
+  FilterPass pass;
+  pass.m_BorderColor = ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a);
+
   if (width != originalWidth)
   {
     ezImageFilterWeights weights(*filter, originalWidth, width);
@@ -938,22 +1063,15 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetWidth(width);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 y = 0; y < originalHeight; ++y)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, 0, y, z);
-            FilterLine(originalWidth, filterSource, filterTarget, 1, weights, firstSampleIndices, addressModeU,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    pass.m_pSource = stepSource;
+    pass.m_pTarget = stepTarget;
+    pass.m_pWeights = &weights;
+    pass.m_FirstSampleIndices = firstSampleIndices;
+    pass.m_AddressMode = addressModeU;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, pass.GetNumRows(), [&pass](ezUInt32 uiStartRow, ezUInt32 uiEndRow) { pass.FilterRowsX(uiStartRow, uiEndRow); }, "ScaleImageX",
+      pass.GetParallelForParams());
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -982,22 +1100,15 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetHeight(height);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 z = 0; z < originalDepth; ++z)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, 0, z);
-            FilterLine(originalHeight, filterSource, filterTarget, width, weights, firstSampleIndices, addressModeV,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    pass.m_pSource = stepSource;
+    pass.m_pTarget = stepTarget;
+    pass.m_pWeights = &weights;
+    pass.m_FirstSampleIndices = firstSampleIndices;
+    pass.m_AddressMode = addressModeV;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, pass.GetNumRows(), [&pass](ezUInt32 uiStartRow, ezUInt32 uiEndRow) { pass.FilterRowsYZ(uiStartRow, uiEndRow, false); },
+      "ScaleImageY", pass.GetParallelForParams());
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1026,22 +1137,15 @@ ezResult ezImageUtils::Scale3D(const ezImageView& source, ezImage& target, ezUIn
     stepHeader.SetDepth(depth);
     stepTarget->ResetAndAlloc(stepHeader);
 
-    for (ezUInt32 arrayIndex = 0; arrayIndex < numArrayElements; ++arrayIndex)
-    {
-      for (ezUInt32 face = 0; face < numFaces; ++face)
-      {
-        for (ezUInt32 y = 0; y < height; ++y)
-        {
-          for (ezUInt32 x = 0; x < width; ++x)
-          {
-            const ezSimdVec4f* filterSource = stepSource->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            ezSimdVec4f* filterTarget = stepTarget->GetPixelPointer<ezSimdVec4f>(0, face, arrayIndex, x, y, 0);
-            FilterLine(originalHeight, filterSource, filterTarget, width * height, weights, firstSampleIndices, addressModeW,
-              ezSimdVec4f(borderColor.r, borderColor.g, borderColor.b, borderColor.a));
-          }
-        }
-      }
-    }
+    pass.m_pSource = stepSource;
+    pass.m_pTarget = stepTarget;
+    pass.m_pWeights = &weights;
+    pass.m_FirstSampleIndices = firstSampleIndices;
+    pass.m_AddressMode = addressModeW;
+
+    ezTaskSystem::ParallelForIndexed(
+      0, pass.GetNumRows(), [&pass](ezUInt32 uiStartRow, ezUInt32 uiEndRow) { pass.FilterRowsYZ(uiStartRow, uiEndRow, true); },
+      "ScaleImageZ", pass.GetParallelForParams());
 
     releaseScratch(*stepSource);
     stepSource = stepTarget;
@@ -1079,17 +1183,25 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
 
   target.ResetAndAlloc(header);
 
-  for (ezUInt32 arrayIndex = 0; arrayIndex < source.GetNumArrayIndices(); arrayIndex++)
+  struct MipChainJob
   {
-    for (ezUInt32 face = 0; face < source.GetNumFaces(); face++)
+    const ezImageView* m_pSource;
+    ezImage* m_pTarget;
+    const ezImageUtils::MipMapOptions* m_pOptions;
+    ezImageHeader m_Header;
+    ezUInt32 m_uiNumMipMaps;
+
+    void GenerateMipChain(ezUInt32 face, ezUInt32 arrayIndex) const
     {
-      ezImageHeader currentMipMapHeader = header;
+      const ezImageUtils::MipMapOptions& mipMapOptions = *m_pOptions;
+
+      ezImageHeader currentMipMapHeader = m_Header;
       currentMipMapHeader.SetNumMipLevels(1);
       currentMipMapHeader.SetNumFaces(1);
       currentMipMapHeader.SetNumArrayIndices(1);
 
-      auto sourceView = source.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
-      auto targetView = target.GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+      auto sourceView = m_pSource->GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
+      auto targetView = m_pTarget->GetSubImageView(0, face, arrayIndex).GetByteBlobPtr();
 
       memcpy(targetView.GetPtr(), sourceView.GetPtr(), targetView.GetCount());
 
@@ -1097,21 +1209,21 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
       if (mipMapOptions.m_preserveCoverage)
       {
         targetCoverage =
-          EvaluateAverageCoverage(source.GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
+          EvaluateAverageCoverage(m_pSource->GetSubImageView(0, face, arrayIndex).GetBlobPtr<ezColor>(), mipMapOptions.m_alphaThreshold);
       }
 
-      for (ezUInt32 mipMapLevel = 0; mipMapLevel < numMipMaps - 1; mipMapLevel++)
+      for (ezUInt32 mipMapLevel = 0; mipMapLevel < m_uiNumMipMaps - 1; mipMapLevel++)
       {
         ezImageHeader nextMipMapHeader = currentMipMapHeader;
         nextMipMapHeader.SetWidth(ezMath::Max(1u, nextMipMapHeader.GetWidth() / 2));
         nextMipMapHeader.SetHeight(ezMath::Max(1u, nextMipMapHeader.GetHeight() / 2));
         nextMipMapHeader.SetDepth(ezMath::Max(1u, nextMipMapHeader.GetDepth() / 2));
 
-        auto sourceData = target.GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
+        auto sourceData = m_pTarget->GetSubImageView(mipMapLevel, face, arrayIndex).GetByteBlobPtr();
         ezImage currentMipMap;
         currentMipMap.ResetAndUseExternalStorage(currentMipMapHeader, sourceData);
 
-        auto dstData = target.GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
+        auto dstData = m_pTarget->GetSubImageView(mipMapLevel + 1, face, arrayIndex).GetByteBlobPtr();
         ezImage nextMipMap;
         nextMipMap.ResetAndUseExternalStorage(nextMipMapHeader, dstData);
 
@@ -1132,7 +1244,38 @@ void ezImageUtils::GenerateMipMaps(const ezImageView& source, ezImage& target, c
         currentMipMapHeader = nextMipMapHeader;
       }
     }
+  };
+
+  MipChainJob job;
+  job.m_pSource = &source;
+  job.m_pTarget = &target;
+  job.m_pOptions = &mipMapOptions;
+  job.m_Header = header;
+  job.m_uiNumMipMaps = numMipMaps;
+
+  const ezUInt32 uiNumFaces = source.GetNumFaces();
+  const ezUInt32 uiNumMipChains = source.GetNumArrayIndices() * uiNumFaces;
+
+  if (uiNumMipChains == 1)
+  {
+    job.GenerateMipChain(0, 0);
+    return;
   }
+
+  // The mip chains of all faces and array slices are independent of each other. Scale3D distributes the rows of each mip level
+  // across the worker threads as well, so the tasks for the chains have to allow nesting.
+  ezParallelForParams params;
+  params.nestingMode = ezTaskNesting::Maybe;
+
+  ezTaskSystem::ParallelForIndexed(
+    0, uiNumMipChains,
+    [&job, uiNumFaces](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+      for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+      {
+        job.GenerateMipChain(i % uiNumFaces, i / uiNumFaces);
+      }
+    },
+    "GenerateMipMaps", params);
 }
 
 void ezImageUtils::ReconstructNormalZ(ezImage& image)
@@ -26,6 +26,7 @@ EZ_STATICLINK_LIBRARY(Texture)
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexTGA);
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexUtil);
   EZ_STATICLINK_REFERENCE(Texture_DirectXTex_DirectXTexWIC);
+  EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_DXTCompression);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_DXTConversions);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_DXTexConversions);
   EZ_STATICLINK_REFERENCE(Texture_Image_Conversions_PixelConversions);
@@ -52,12 +52,16 @@ void RemoveTelemetryAssertHandler()
 void SetAppStats()
 {
   ezStringBuilder sOut;
-  const ezSystemInformation info = ezSystemInformation::Get();
+  const ezSystemInformation& info = ezSystemInformation::Get();
 
   ezStats::SetStat("Platform/Name", info.GetPlatformName());
 
   ezStats::SetStat("Hardware/CPU Cores", info.GetCPUCoreCount());
 
+  ezStats::SetStat("Hardware/CPU Physical Cores", info.GetPhysicalCPUCoreCount());
+
+  ezStats::SetStat("Hardware/NUMA Nodes", info.GetNumaNodeCount());
+
   ezStats::SetStat("Hardware/RAM[GB]", info.GetInstalledMainMemory() / 1024.0f / 1024.0f / 1024.0f);
 
   sOut = info.Is64BitOS() ? "64 Bit" : "32 Bit";
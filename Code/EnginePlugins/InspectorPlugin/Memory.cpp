@@ -28,11 +28,12 @@ namespace MemoryDetail
       msg.GetWriter() << it.Id().m_Data;
       msg.GetWriter() << it.Name();
       msg.GetWriter() << (it.ParentId().IsInvalidated() ? ezInvalidIndex : it.ParentId().m_Data);
-      msg.GetWriter() << it.Stats();
+      const ezAllocatorBase::Stats stats = it.Stats();
+      msg.GetWriter() << stats;
 
-      uiTotalAllocations += it.Stats().m_uiNumAllocations;
-      uiTotalPerFrameAllocationSize += it.Stats().m_uiPerFrameAllocationSize;
-      TotalPerFrameAllocationTime += it.Stats().m_PerFrameAllocationTime;
+      uiTotalAllocations += stats.m_uiNumAllocations;
+      uiTotalPerFrameAllocationSize += stats.m_uiPerFrameAllocationSize;
+      TotalPerFrameAllocationTime += stats.m_PerFrameAllocationTime;
 
       ezTelemetry::Broadcast(ezTelemetry::Unreliable, msg);
     }
@@ -6,6 +6,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_ColorGradient.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleBehaviorFactory_ColorGradient, 1, ezRTTIDefaultAllocator<ezParticleBehaviorFactory_ColorGradient>)
@@ -110,7 +111,7 @@ void ezParticleBehavior_ColorGradient::CreateRequiredStreams()
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
   {
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
   }
 }
 
@@ -212,16 +213,16 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
   }
   else if (m_GradientMode == ezParticleColorGradientMode::Speed)
   {
-    ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+    ezParticleStreamFloat3SoA velocity(m_pStreamVelocity);
 
     // skip the first n particles
-    itVelocity.Advance(m_uiFirstToUpdate);
+    ezUInt64 i = m_uiFirstToUpdate;
 
-    while (!itVelocity.HasReachedEnd())
+    while (i < uiNumElements)
     {
       // if (itLifeTime.Current().y > 0)
       {
-        const float fSpeed = itVelocity.Current().GetLength();
+        const float fSpeed = velocity.Get(i).GetLength();
         const float posx = fSpeed / m_fMaxSpeed; // no need to clamp the range, the color lookup will already do that
 
         ezColor rgba;
@@ -236,7 +237,7 @@ void ezParticleBehavior_ColorGradient::Process(ezUInt64 uiNumElements)
       // skip the next n items
       // this is to reduce the number of particles that need to be fully evaluated,
       // since sampling the color gradient is pretty expensive
-      itVelocity.Advance(m_uiCurrentUpdateInterval);
+      i += m_uiCurrentUpdateInterval;
       itColor.Advance(m_uiCurrentUpdateInterval);
     }
   }
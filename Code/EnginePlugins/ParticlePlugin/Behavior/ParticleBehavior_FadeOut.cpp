@@ -59,6 +59,26 @@ void ezParticleBehavior_FadeOut::CreateRequiredStreams()
   CreateStream("Color", ezProcessingStream::DataType::Half4, &m_pStreamColor, false);
 }
 
+namespace
+{
+  template <typename FadeFunc>
+  void FadeOutParticles(ezProcessingStreamIterator<ezFloat16Vec2>& itLifeTime, ezProcessingStreamIterator<ezColorLinear16f>& itColor,
+    ezUInt32 uiUpdateInterval, FadeFunc fade)
+  {
+    while (!itLifeTime.HasReachedEnd())
+    {
+      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
+      itColor.Current().a = fade(fLifeTimeFraction);
+
+      for (ezUInt32 i = 0; i < uiUpdateInterval; ++i)
+      {
+        itLifeTime.Advance();
+        itColor.Advance();
+      }
+    }
+  }
+} // namespace
+
 void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
 {
   if (!GetOwnerEffect()->IsVisible())
@@ -88,34 +108,29 @@ void ezParticleBehavior_FadeOut::Process(ezUInt64 uiNumElements)
       m_uiFirstToUpdate = 0;
   }
 
-  if (m_fStartAlpha <= 1.0f)
-  {
-    while (!itLifeTime.HasReachedEnd())
-    {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent);
+  // ezMath::Pow is by far the most expensive part, avoid it for the common exponents
+  const float fStartAlpha = m_fStartAlpha;
+  const float fExponent = m_fExponent;
 
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
-    }
+  if (fStartAlpha <= 1.0f)
+  {
+    if (fExponent == 1.0f)
+      FadeOutParticles(itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return fStartAlpha * x; });
+    else if (fExponent == 2.0f)
+      FadeOutParticles(itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return fStartAlpha * x * x; });
+    else
+      FadeOutParticles(itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return fStartAlpha * ezMath::Pow(x, fExponent); });
   }
   else
   {
     // this case has to clamp alpha to 1
-    while (!itLifeTime.HasReachedEnd())
-    {
-      const float fLifeTimeFraction = itLifeTime.Current().x * itLifeTime.Current().y;
-      itColor.Current().a = ezMath::Min(1.0f, m_fStartAlpha * ezMath::Pow(fLifeTimeFraction, m_fExponent));
-
-      for (ezUInt32 i = 0; i < m_uiCurrentUpdateInterval; ++i)
-      {
-        itLifeTime.Advance();
-        itColor.Advance();
-      }
-    }
+    if (fExponent == 1.0f)
+      FadeOutParticles(itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return ezMath::Min(1.0f, fStartAlpha * x); });
+    else if (fExponent == 2.0f)
+      FadeOutParticles(itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return ezMath::Min(1.0f, fStartAlpha * x * x); });
+    else
+      FadeOutParticles(
+        itLifeTime, itColor, m_uiCurrentUpdateInterval, [=](float x) { return ezMath::Min(1.0f, fStartAlpha * ezMath::Pow(x, fExponent)); });
   }
 
   /// \todo Use level of detail to reduce the update interval further
@@ -7,6 +7,7 @@
 #include <Foundation/Time/Clock.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Flies.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 
 // clang-format off
@@ -87,7 +88,7 @@ void ezParticleBehaviorFactory_Flies::Load(ezStreamReader& stream)
 void ezParticleBehavior_Flies::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
 
   m_TimeToChangeDir.SetZero();
 }
@@ -108,17 +109,18 @@ void ezParticleBehavior_Flies::Process(ezUInt64 uiNumElements)
   const float fMaxDistanceToEmitterSquared = ezMath::Square(m_fMaxEmitterDistance);
 
   ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezParticleStreamFloat3SoA velocity(m_pStreamVelocity);
 
   ezQuat qRot;
 
+  ezUInt64 i = 0;
   while (!itPosition.HasReachedEnd())
   {
     // if (pLifeArray[i] == pMaxLifeArray[i])
 
     const ezVec3 vPartToEm = vEmitterPos - itPosition.Current().GetAsVec3();
     const float fDist = vPartToEm.GetLengthSquared();
-    const ezVec3 vVelocity = itVelocity.Current();
+    const ezVec3 vVelocity = velocity.Get(i);
     ezVec3 vDir = vVelocity;
     vDir.NormalizeIfNotZero();
 
@@ -130,14 +132,14 @@ void ezParticleBehavior_Flies::Process(ezUInt64 uiNumElements)
 
       qRot.SetFromAxisAndAngle(vPivot, m_MaxSteeringAngle);
 
-      itVelocity.Current() = qRot * vVelocity;
+      velocity.Set(i, qRot * vVelocity);
     }
     else
     {
-      itVelocity.Current() = ezVec3::CreateRandomDeviation(GetRNG(), m_MaxSteeringAngle, vDir) * m_fSpeed;
+      velocity.Set(i, ezVec3::CreateRandomDeviation(GetRNG(), m_MaxSteeringAngle, vDir) * m_fSpeed);
     }
 
     itPosition.Advance();
-    itVelocity.Advance();
+    ++i;
   }
 }
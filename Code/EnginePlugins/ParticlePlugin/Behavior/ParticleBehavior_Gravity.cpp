@@ -2,12 +2,12 @@
 
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Gravity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <WorldModule/ParticleWorldModule.h>
 
@@ -70,7 +70,7 @@ void ezParticleBehaviorFactory_Gravity::QueryFinalizerDependencies(ezSet<const e
 
 void ezParticleBehavior_Gravity::CreateRequiredStreams()
 {
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
 }
 
 void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
@@ -82,14 +82,7 @@ void ezParticleBehavior_Gravity::Process(ezUInt64 uiNumElements)
   const float tDiff = (float)m_TimeDiff.GetSeconds();
   const ezVec3 addGravity = vGravity * m_fGravityFactor * tDiff;
 
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
-
-  while (!itVelocity.HasReachedEnd())
-  {
-    itVelocity.Current() += addGravity;
-
-    itVelocity.Advance();
-  }
+  ezParticleStreamSimd::AddToFloat3SoA(m_pStreamVelocity, uiNumElements, addGravity);
 }
 
 void ezParticleBehavior_Gravity::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
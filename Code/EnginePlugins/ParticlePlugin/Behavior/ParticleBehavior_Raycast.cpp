@@ -11,6 +11,7 @@
 #include <ParticlePlugin/Events/ParticleEvent.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_LastPosition.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 
@@ -124,7 +125,7 @@ void ezParticleBehavior_Raycast::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
   CreateStream("LastPosition", ezProcessingStream::DataType::Float3, &m_pStreamLastPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
 }
 
 void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
@@ -135,7 +136,7 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 
   ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
   ezProcessingStreamIterator<const ezVec3> itLastPosition(m_pStreamLastPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
+  ezParticleStreamFloat3SoA velocity(m_pStreamVelocity);
 
   ezPhysicsCastResult hitResult;
 
@@ -162,7 +163,7 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
             const ezVec3 vNewDir = vChange.GetReflectedVector(hitResult.m_vNormal) * m_fBounceFactor;
 
             itPosition.Current() = ezVec3(hitResult.m_vPosition + hitResult.m_vNormal * 0.05f + vNewDir).GetAsVec4(0);
-            itVelocity.Current() = vNewDir / tDiff;
+            velocity.Set(i, vNewDir / tDiff);
           }
           else if (m_Reaction == ezParticleRaycastHitReaction::Die)
           {
@@ -171,7 +172,7 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
           }
           else if (m_Reaction == ezParticleRaycastHitReaction::Stop)
           {
-            itVelocity.Current().SetZero();
+            velocity.Set(i, ezVec3::ZeroVector());
           }
 
           if (m_sOnCollideEvent.GetHash() != 0)
@@ -190,7 +191,6 @@ void ezParticleBehavior_Raycast::Process(ezUInt64 uiNumElements)
 
     itPosition.Advance();
     itLastPosition.Advance();
-    itVelocity.Advance();
 
     ++i;
   }
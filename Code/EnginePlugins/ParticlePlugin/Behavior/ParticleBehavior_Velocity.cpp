@@ -2,13 +2,13 @@
 
 #include <Core/World/World.h>
 #include <Core/World/WorldModule.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <Foundation/Time/Clock.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <GameEngine/Interfaces/WindWorldModule.h>
 #include <ParticlePlugin/Behavior/ParticleBehavior_Velocity.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 
@@ -102,7 +102,7 @@ void ezParticleBehaviorFactory_Velocity::QueryFinalizerDependencies(ezSet<const
 void ezParticleBehavior_Velocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
 }
 
 void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
@@ -127,17 +127,8 @@ void ezParticleBehavior_Velocity::Process(ezUInt64 uiNumElements)
   const float fFriction = ezMath::Clamp(m_fFriction, 0.0f, 100.0f);
   const float fFrictionFactor = ezMath::Pow(0.5f, tDiff * fFriction);
 
-  ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
-
-  while (!itPosition.HasReachedEnd())
-  {
-    itPosition.Current() += vAddPos;
-    itVelocity.Current() *= fFrictionFactor;
-
-    itPosition.Advance();
-    itVelocity.Advance();
-  }
+  ezParticleStreamSimd::AddToFloat4(m_pStreamPosition->GetWritableData<ezVec4>(), uiNumElements, vAddPos);
+  ezParticleStreamSimd::ScaleFloat3SoA(m_pStreamVelocity, uiNumElements, fFrictionFactor);
 }
 
 void ezParticleBehavior_Velocity::RequestRequiredWorldModulesForCache(ezParticleWorldModule* pParticleModule)
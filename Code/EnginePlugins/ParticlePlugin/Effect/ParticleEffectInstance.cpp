@@ -2,7 +2,9 @@
 
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Time/Clock.h>
 #include <ParticlePlugin/Effect/ParticleEffectDescriptor.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
@@ -15,6 +17,8 @@
 #include <ParticlePlugin/WorldModule/ParticleWorldModule.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 
+ezCVarBool CVarParallelSystemUpdates("pfx_ParallelSystemUpdates", false, ezCVarFlags::Default, "Updates the systems of an effect in separate tasks. Effects created while this is enabled use different random numbers.");
+
 ezParticleEffectInstance::ezParticleEffectInstance()
   : m_Task(this)
 {
@@ -52,6 +56,8 @@ void ezParticleEffectInstance::Construct(ezParticleEffectHandle hEffectHandle, c
   m_TotalEffectLifeTime.SetZero();
   m_pVisibleIf = nullptr;
   m_uiRandomSeed = uiRandomSeed;
+  m_bUpdateSystemsInParallel = CVarParallelSystemUpdates;
+  m_bInterruptAfterSystemUpdates = false;
 
   if (uiRandomSeed == 0)
     m_Random.InitializeFromCurrentTime();
@@ -406,61 +412,83 @@ void ezParticleEffectInstance::Reconfigure(bool bFirstTime, ezArrayPtr<ezParticl
   }
 }
 
-bool ezParticleEffectInstance::Update(const ezTime& tDiff)
+namespace
 {
-  EZ_PROFILE_SCOPE("PFX: Effect Update");
+  EZ_ALWAYS_INLINE ezTime GetMaxTimeStep()
+  {
+    return ezTime::Milliseconds(200); // in sync with Max5fps
+  }
+} // namespace
 
-  ezTime tMinStep = ezTime::Seconds(0);
+bool ezParticleEffectInstance::ComputeMinTimeStep(ezTime& out_MinStep, bool& out_bIsAlive)
+{
+  out_MinStep.SetZero();
+  out_bIsAlive = true;
 
-  if (!IsVisible() && m_iMinSimStepsToDo == 0)
-  {
-    // shared effects always get paused when they are invisible
-    if (IsSharedEffect())
-      return true;
+  if (IsVisible() || m_iMinSimStepsToDo > 0)
+    return true;
 
-    switch (m_InvisibleUpdateRate)
-    {
-      case ezEffectInvisibleUpdateRate::FullUpdate:
-        tMinStep = ezTime::Seconds(1.0 / 60.0);
-        break;
+  // shared effects always get paused when they are invisible
+  if (IsSharedEffect())
+    return false;
 
-      case ezEffectInvisibleUpdateRate::Max20fps:
-        tMinStep = ezTime::Milliseconds(50);
-        break;
+  switch (m_InvisibleUpdateRate)
+  {
+    case ezEffectInvisibleUpdateRate::FullUpdate:
+      out_MinStep = ezTime::Seconds(1.0 / 60.0);
+      break;
 
-      case ezEffectInvisibleUpdateRate::Max10fps:
-        tMinStep = ezTime::Milliseconds(100);
-        break;
+    case ezEffectInvisibleUpdateRate::Max20fps:
+      out_MinStep = ezTime::Milliseconds(50);
+      break;
 
-      case ezEffectInvisibleUpdateRate::Max5fps:
-        tMinStep = ezTime::Milliseconds(200);
-        break;
+    case ezEffectInvisibleUpdateRate::Max10fps:
+      out_MinStep = ezTime::Milliseconds(100);
+      break;
+
+    case ezEffectInvisibleUpdateRate::Max5fps:
+      out_MinStep = ezTime::Milliseconds(200);
+      break;
 
-      case ezEffectInvisibleUpdateRate::Pause:
+    case ezEffectInvisibleUpdateRate::Pause:
+    {
+      if (m_bEmitterEnabled)
       {
-        if (m_bEmitterEnabled)
-        {
-          // during regular operation, pause
-          return m_uiReviveTimeout > 0;
-        }
-
-        // otherwise do infrequent updates to shut the effect down
-        tMinStep = ezTime::Milliseconds(200);
-        break;
+        // during regular operation, pause
+        out_bIsAlive = m_uiReviveTimeout > 0;
+        return false;
       }
 
-      case ezEffectInvisibleUpdateRate::Discard:
-        Interrupt();
-        return false;
+      // otherwise do infrequent updates to shut the effect down
+      out_MinStep = ezTime::Milliseconds(200);
+      break;
     }
+
+    case ezEffectInvisibleUpdateRate::Discard:
+      Interrupt();
+      out_bIsAlive = false;
+      return false;
   }
 
+  return true;
+}
+
+bool ezParticleEffectInstance::Update(const ezTime& tDiff)
+{
+  EZ_PROFILE_SCOPE("PFX: Effect Update");
+
+  ezTime tMinStep;
+  bool bIsAlive = true;
+
+  if (!ComputeMinTimeStep(tMinStep, bIsAlive))
+    return bIsAlive;
+
   m_ElapsedTimeSinceUpdate += tDiff;
   PassTransformToSystems();
 
   // if the time step is too big, iterate multiple times
   {
-    const ezTime tMaxTimeStep = ezTime::Milliseconds(200); // in sync with Max5fps
+    const ezTime tMaxTimeStep = GetMaxTimeStep();
     while (m_ElapsedTimeSinceUpdate > tMaxTimeStep)
     {
       m_ElapsedTimeSinceUpdate -= tMaxTimeStep;
@@ -488,22 +516,118 @@ bool ezParticleEffectInstance::StepSimulation(const ezTime& tDiff)
   {
     if (m_ParticleSystems[i] != nullptr)
     {
-      auto state = m_ParticleSystems[i]->Update(tDiff);
+      ApplySystemState(i, m_ParticleSystems[i]->Update(tDiff));
+    }
+  }
 
-      if (state == ezParticleSystemState::Inactive)
-      {
-        ClearParticleSystem(i);
-      }
-      else if (state != ezParticleSystemState::OnlyReacting)
-      {
-        // this is used to delay particle effect death by a couple of frames
-        // that way, if an event is in the pipeline that might trigger a reacting emitter,
-        // or particles are in the spawn queue, but not yet created, we don't kill the effect too early
-        m_uiReviveTimeout = 3;
-      }
+  return FinishSimulationStep();
+}
+
+bool ezParticleEffectInstance::CanUpdateSystemsInParallel(const ezTime& tDiff) const
+{
+  if (!m_bUpdateSystemsInParallel)
+    return false;
+
+  // pre-simulation and catching up after large time steps need several consecutive steps, that is left to the effect task
+  // the effect task also skips the update entirely when no time has passed
+  if (!tDiff.IsPositive() || m_PreSimulateDuration.IsPositive() || m_ElapsedTimeSinceUpdate + tDiff > GetMaxTimeStep())
+    return false;
+
+  ezUInt32 uiNumSystems = 0;
+  for (const ezParticleSystemInstance* pSystem : m_ParticleSystems)
+  {
+    if (pSystem != nullptr)
+      ++uiNumSystems;
+  }
+
+  return uiNumSystems > 1;
+}
+
+bool ezParticleEffectInstance::BeginSystemUpdates(const ezTime& tDiff, ezTaskGroupID taskGroup)
+{
+  EZ_ASSERT_DEBUG(!m_bSystemUpdatesPending, "The previous system updates have not been finished");
+
+  ezTime tMinStep;
+  bool bIsAlive = true;
+
+  if (!ComputeMinTimeStep(tMinStep, bIsAlive))
+    return bIsAlive;
+
+  m_ElapsedTimeSinceUpdate += tDiff;
+  PassTransformToSystems();
+
+  if (m_ElapsedTimeSinceUpdate < tMinStep)
+    return m_uiReviveTimeout > 0;
+
+  const ezTime tUpdateDiff = m_ElapsedTimeSinceUpdate;
+  m_ElapsedTimeSinceUpdate.SetZero();
+
+  // the modules read the effect life time during the update, so it is advanced before any system task runs
+  m_TotalEffectLifeTime += tUpdateDiff;
+
+  for (ezParticleSystemInstance* pSystem : m_ParticleSystems)
+  {
+    if (pSystem != nullptr)
+    {
+      ezParticleSystemUpdateTask* pTask = pSystem->GetUpdateTask();
+      pTask->m_UpdateDiff = tUpdateDiff;
+
+      ezTaskSystem::AddTaskToGroup(taskGroup, pTask);
+    }
+  }
+
+  m_bSystemUpdatesPending = true;
+  return true;
+}
+
+bool ezParticleEffectInstance::EndSystemUpdates()
+{
+  if (!m_bSystemUpdatesPending)
+    return true;
+
+  m_bSystemUpdatesPending = false;
+
+  if (m_bInterruptAfterSystemUpdates)
+  {
+    m_bInterruptAfterSystemUpdates = false;
+    Interrupt();
+  }
+
+  for (ezUInt32 i = 0; i < m_ParticleSystems.GetCount(); ++i)
+  {
+    if (m_ParticleSystems[i] == nullptr)
+      continue;
+
+    ezParticleSystemUpdateTask* pTask = m_ParticleSystems[i]->GetUpdateTask();
+
+    // systems that were created after the tasks had been started have not been updated
+    if (pTask->m_UpdateDiff.IsPositive())
+    {
+      pTask->m_UpdateDiff.SetZero();
+      ApplySystemState(i, pTask->m_State);
     }
   }
 
+  return FinishSimulationStep();
+}
+
+void ezParticleEffectInstance::ApplySystemState(ezUInt32 uiSystem, ezParticleSystemState::Enum state)
+{
+  if (state == ezParticleSystemState::Inactive)
+  {
+    ClearParticleSystem(uiSystem);
+  }
+  else if (state != ezParticleSystemState::OnlyReacting)
+  {
+    // this is used to delay particle effect death by a couple of frames
+    // that way, if an event is in the pipeline that might trigger a reacting emitter,
+    // or particles are in the spawn queue, but not yet created, we don't kill the effect too early
+    m_uiReviveTimeout = 3;
+  }
+}
+
+bool ezParticleEffectInstance::FinishSimulationStep()
+{
   if (NeedsBoundingVolumeUpdate())
   {
     CombineSystemBoundingVolumes();
@@ -518,6 +642,8 @@ bool ezParticleEffectInstance::StepSimulation(const ezTime& tDiff)
 
 void ezParticleEffectInstance::AddParticleEvent(const ezParticleEvent& pe)
 {
+  EZ_LOCK(m_EventQueueMutex);
+
   // drop events when the capacity is full
   if (m_EventQueue.GetCount() == m_EventQueue.GetCapacity())
     return;
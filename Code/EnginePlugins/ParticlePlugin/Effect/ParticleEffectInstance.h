@@ -2,6 +2,7 @@
 
 #include <Foundation/Containers/StaticArray.h>
 #include <Foundation/Math/Transform.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <ParticlePlugin/ParticlePluginDLL.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
@@ -67,6 +68,12 @@ public:
 
   ezUInt64 GetRandomSeed() const { return m_uiRandomSeed; }
 
+  /// \brief Whether the systems of this effect may be updated in separate tasks.
+  ///
+  /// This is decided once, when the effect is created, through the CVar 'pfx_ParallelSystemUpdates'.
+  /// In that case every system uses its own random number generator, so the effect looks different than with sequential updates.
+  bool UpdatesSystemsInParallel() const { return m_bUpdateSystemsInParallel; }
+
   /// @name Transform Related
   /// @{
 public:
@@ -109,6 +116,17 @@ private: // friend ezParticleWorldModule
   /// \brief Returns the task that is used to update the effect
   ezParticleffectUpdateTask* GetUpdateTask() { return &m_Task; }
 
+  /// \brief Whether this frame's update is a single simulation step of several systems, in which case each system can be updated by its
+  /// own task instead of running the whole effect update in one task.
+  bool CanUpdateSystemsInParallel(const ezTime& tDiff) const;
+
+  /// \brief Adds one update task per particle system to the given group, unless the effect is not simulated this frame.
+  /// Returns false when the effect is finished.
+  bool BeginSystemUpdates(const ezTime& tDiff, ezTaskGroupID taskGroup);
+
+  /// \brief Evaluates the results of the system tasks once they are finished. Returns false when the effect is finished.
+  bool EndSystemUpdates();
+
 private: // friend ezParticleffectUpdateTask
   friend class ezParticleEffectController;
   /// \brief If the effect wants to skip all the initial behavior, this simulates it multiple times before it is shown the first time.
@@ -118,8 +136,18 @@ private: // friend ezParticleffectUpdateTask
   bool StepSimulation(const ezTime& tDiff);
 
 private:
+  /// \brief Applies the update rate of invisible effects. Returns false, if the effect must not be simulated this frame,
+  /// in which case out_bIsAlive tells whether the effect is still alive.
+  bool ComputeMinTimeStep(ezTime& out_MinStep, bool& out_bIsAlive);
+
+  void ApplySystemState(ezUInt32 uiSystem, ezParticleSystemState::Enum state);
+  bool FinishSimulationStep();
+
   ezTime m_TotalEffectLifeTime = ezTime::Zero();
   ezTime m_ElapsedTimeSinceUpdate = ezTime::Zero();
+  bool m_bUpdateSystemsInParallel = false;
+  bool m_bSystemUpdatesPending = false;
+  bool m_bInterruptAfterSystemUpdates = false;
 
 
   /// @}
@@ -239,5 +267,6 @@ private:
 
   ezParticleffectUpdateTask m_Task;
 
+  ezMutex m_EventQueueMutex; // systems of the same effect may be updated in parallel
   ezStaticArray<ezParticleEvent, 16> m_EventQueue;
 };
@@ -7,6 +7,7 @@
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Events/ParticleEvent.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_Age.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 
 // clang-format off
@@ -65,7 +66,7 @@ void ezParticleFinalizer_Age::CreateRequiredStreams()
   if (m_sOnDeathEvent.GetHash() != 0)
   {
     CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
   }
 }
 
@@ -107,33 +108,20 @@ void ezParticleFinalizer_Age::Process(ezUInt64 uiNumElements)
 {
   EZ_PROFILE_SCOPE("PFX: Age");
 
-  ezFloat16Vec2* pLifeTime = m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>();
-
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  for (ezUInt32 i = 0; i < uiNumElements; ++i)
-  {
-    pLifeTime[i].x = pLifeTime[i].x - tDiff;
-
-    if (pLifeTime[i].x <= 0)
-    {
-      pLifeTime[i].x = 0;
-
-      /// \todo Get current element index from iterator ?
-      m_pStreamGroup->RemoveElement(i);
-    }
-  }
+  ezParticleStreamSimd::DecreaseLifeTime(m_pStreamLifeTime->GetWritableData<ezFloat16Vec2>(), uiNumElements, tDiff, m_pStreamGroup);
 }
 
 void ezParticleFinalizer_Age::OnParticleDeath(const ezStreamGroupElementRemovedEvent& e)
 {
   const ezVec4* pPosition = m_pStreamPosition->GetData<ezVec4>();
-  const ezVec3* pVelocity = m_pStreamVelocity->GetData<ezVec3>();
+  const ezParticleStreamFloat3SoA velocity(m_pStreamVelocity);
 
   ezParticleEvent pe;
   pe.m_EventType = m_sOnDeathEvent;
   pe.m_vPosition = pPosition[e.m_uiElementIndex].GetAsVec3();
-  pe.m_vDirection = pVelocity[e.m_uiElementIndex];
+  pe.m_vDirection = velocity.Get(e.m_uiElementIndex);
   pe.m_vNormal.SetZero();
 
   GetOwnerEffect()->AddParticleEvent(pe);
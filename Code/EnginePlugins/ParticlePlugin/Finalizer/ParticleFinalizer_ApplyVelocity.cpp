@@ -1,10 +1,10 @@
 #include <ParticlePluginPCH.h>
 
 #include <Core/World/World.h>
-#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
 #include <Foundation/Math/Declarations.h>
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleFinalizerFactory_ApplyVelocity, 1, ezRTTIDefaultAllocator<ezParticleFinalizerFactory_ApplyVelocity>)
@@ -37,7 +37,7 @@ ezParticleFinalizer_ApplyVelocity::~ezParticleFinalizer_ApplyVelocity() {}
 void ezParticleFinalizer_ApplyVelocity::CreateRequiredStreams()
 {
   CreateStream("Position", ezProcessingStream::DataType::Float4, &m_pStreamPosition, false);
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, false);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, false);
 }
 
 void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
@@ -46,16 +46,5 @@ void ezParticleFinalizer_ApplyVelocity::Process(ezUInt64 uiNumElements)
 
   const float tDiff = (float)m_TimeDiff.GetSeconds();
 
-  ezProcessingStreamIterator<ezVec4> itPosition(m_pStreamPosition, uiNumElements, 0);
-  ezProcessingStreamIterator<ezVec3> itVelocity(m_pStreamVelocity, uiNumElements, 0);
-
-  while (!itPosition.HasReachedEnd())
-  {
-    ezVec3& pos = reinterpret_cast<ezVec3&>(itPosition.Current());
-
-    pos += itVelocity.Current() * tDiff;
-
-    itPosition.Advance();
-    itVelocity.Advance();
-  }
+  ezParticleStreamSimd::MulAddFloat3SoAToFloat4(m_pStreamPosition->GetWritableData<ezVec4>(), m_pStreamVelocity, uiNumElements, tDiff);
 }
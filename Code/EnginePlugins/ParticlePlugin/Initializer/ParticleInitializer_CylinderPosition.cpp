@@ -5,6 +5,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
 #include <ParticlePlugin/Initializer/ParticleInitializer_CylinderPosition.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 
 // clang-format off
@@ -147,7 +148,7 @@ void ezParticleInitializer_CylinderPosition::CreateRequiredStreams()
 
   if (m_bSetVelocity)
   {
-    CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true);
+    CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, true);
   }
 }
 
@@ -158,7 +159,6 @@ void ezParticleInitializer_CylinderPosition::InitializeElements(ezUInt64 uiStart
   const ezVec3 startVel = GetOwnerSystem()->GetParticleStartVelocity();
 
   ezVec4* pPosition = m_pStreamPosition->GetWritableData<ezVec4>();
-  ezVec3* pVelocity = m_bSetVelocity ? m_pStreamVelocity->GetWritableData<ezVec3>() : nullptr;
 
   ezRandom& rng = GetRNG();
 
@@ -203,7 +203,7 @@ void ezParticleInitializer_CylinderPosition::InitializeElements(ezUInt64 uiStart
     {
       const float fSpeed = (float)rng.DoubleVariance(m_Speed.m_Value, m_Speed.m_fVariance);
 
-      pVelocity[i] = startVel + trans.m_qRotation * normalPos * fSpeed;
+      ezParticleStreamFloat3SoA(m_pStreamVelocity).Set(i, startVel + trans.m_qRotation * normalPos * fSpeed);
     }
 
     pPosition[i] = (trans * pos).GetAsVec4(0);
@@ -5,6 +5,7 @@
 #include <Foundation/Profiling/Profiling.h>
 #include <ParticlePlugin/Finalizer/ParticleFinalizer_ApplyVelocity.h>
 #include <ParticlePlugin/Initializer/ParticleInitializer_VelocityCone.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 
 // clang-format off
@@ -75,7 +76,7 @@ void ezParticleInitializerFactory_VelocityCone::QueryFinalizerDependencies(ezSet
 
 void ezParticleInitializer_VelocityCone::CreateRequiredStreams()
 {
-  CreateStream("Velocity", ezProcessingStream::DataType::Float3, &m_pStreamVelocity, true);
+  CreateStream("Velocity", ezProcessingStream::DataType::Float3SoA, &m_pStreamVelocity, true);
 }
 
 void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
@@ -84,7 +85,7 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
 
   const ezVec3 startVel = GetOwnerSystem()->GetParticleStartVelocity();
 
-  ezVec3* pVelocity = m_pStreamVelocity->GetWritableData<ezVec3>();
+  const ezParticleStreamFloat3SoA velocity(m_pStreamVelocity);
 
   ezRandom& rng = GetRNG();
 
@@ -111,7 +112,7 @@ void ezParticleInitializer_VelocityCone::InitializeElements(ezUInt64 uiStartInde
 
     const float fSpeed = (float)rng.DoubleVariance(m_Speed.m_Value, m_Speed.m_fVariance);
 
-    pVelocity[i] = startVel + GetOwnerSystem()->GetTransform().m_qRotation * dir * fSpeed;
+    velocity.Set(i, startVel + GetOwnerSystem()->GetTransform().m_qRotation * dir * fSpeed);
   }
 }
 
@@ -53,7 +53,7 @@ protected:
     return EZ_SUCCESS;
   }
 
-  ezRandom& GetRNG() const { return GetOwnerEffect()->GetRNG(); }
+  ezRandom& GetRNG() const { return m_pOwnerSystem->GetRNG(); }
 
 private:
   ezParticleSystemInstance* m_pOwnerSystem;
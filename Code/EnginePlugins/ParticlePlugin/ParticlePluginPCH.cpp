@@ -91,6 +91,7 @@ EZ_STATICLINK_LIBRARY(ParticlePlugin)
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Startup);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Streams_DefaultParticleStreams);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Streams_ParticleStream);
+  EZ_STATICLINK_REFERENCE(ParticlePlugin_Streams_ParticleStreamSimd);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_System_ParticleSystemDescriptor);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_System_ParticleSystemInstance);
   EZ_STATICLINK_REFERENCE(ParticlePlugin_Type_Effect_ParticleTypeEffect);
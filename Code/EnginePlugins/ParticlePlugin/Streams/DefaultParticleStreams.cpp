@@ -5,6 +5,7 @@
 #include <Foundation/Math/Float16.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Streams/DefaultParticleStreams.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
 #include <ParticlePlugin/System/ParticleSystemInstance.h>
 
 //////////////////////////////////////////////////////////////////////////
@@ -113,7 +114,7 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleStream_Velocity, 1, ezRTTIDefaultAlloc
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
 ezParticleStreamFactory_Velocity::ezParticleStreamFactory_Velocity()
-    : ezParticleStreamFactory("Velocity", ezProcessingStream::DataType::Float3, ezGetStaticRTTI<ezParticleStream_Velocity>())
+    : ezParticleStreamFactory("Velocity", ezProcessingStream::DataType::Float3SoA, ezGetStaticRTTI<ezParticleStream_Velocity>())
 {
 }
 
@@ -124,14 +125,13 @@ void ezParticleStream_Velocity::Initialize(ezParticleSystemInstance* pOwner)
 
 void ezParticleStream_Velocity::InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements)
 {
-  ezProcessingStreamIterator<ezVec3> itData(m_pStream, uiNumElements, uiStartIndex);
+  const ezParticleStreamFloat3SoA velocity(m_pStream);
 
   const ezVec3 startVel = m_pOwner->GetParticleStartVelocity();
 
-  while (!itData.HasReachedEnd())
+  for (ezUInt64 i = uiStartIndex; i < uiStartIndex + uiNumElements; ++i)
   {
-    itData.Current() = startVel;
-    itData.Advance();
+    velocity.Set(i, startVel);
   }
 }
 
@@ -264,7 +264,7 @@ void ezParticleStream_Variation::InitializeElements(ezUInt64 uiStartIndex, ezUIn
 
   const ezVec3 startVel = m_pOwner->GetParticleStartVelocity();
 
-  ezRandom& rng = m_pOwner->GetOwnerEffect()->GetRNG();
+  ezRandom& rng = m_pOwner->GetRNG();
 
   while (!itData.HasReachedEnd())
   {
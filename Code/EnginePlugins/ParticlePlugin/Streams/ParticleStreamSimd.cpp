@@ -0,0 +1,233 @@
+#include <ParticlePluginPCH.h>
+
+#include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
+#include <Foundation/Math/Float16.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+#  include <emmintrin.h>
+#endif
+
+namespace
+{
+  template <typename Op>
+  EZ_ALWAYS_INLINE void ProcessFloat3SoA(const ezProcessingStream* pStream, ezUInt64 uiNumElements, Op op)
+  {
+    EZ_ASSERT_DEBUG(pStream->GetDataType() == ezProcessingStream::DataType::Float3SoA, "Stream '{0}' is not a Float3SoA stream", pStream->GetName());
+
+    // the component arrays are padded, so the last packet may contain unused elements
+    const ezUInt64 uiNumPackets = (uiNumElements + 3) / 4;
+
+    for (ezUInt32 uiComponent = 0; uiComponent < 3; ++uiComponent)
+    {
+      float* pFloats = pStream->GetWritableComponentData<float>(uiComponent);
+
+      for (ezUInt64 i = 0; i < uiNumPackets; ++i)
+      {
+        ezSimdVec4f v;
+        v.Load<4>(pFloats);
+
+        const ezSimdVec4f result = op(v, uiComponent);
+        result.Store<4>(pFloats);
+
+        pFloats += 4;
+      }
+    }
+  }
+
+  void DecreaseLifeTimeScalar(ezFloat16Vec2* pLifeTime, ezUInt64 uiStartIndex, ezUInt64 uiEndIndex, float fTimeDiff, ezProcessingStreamGroup* pStreamGroup)
+  {
+    for (ezUInt64 i = uiStartIndex; i < uiEndIndex; ++i)
+    {
+      pLifeTime[i].x = pLifeTime[i].x - fTimeDiff;
+
+      if (pLifeTime[i].x <= 0)
+      {
+        pLifeTime[i].x = 0;
+
+        pStreamGroup->RemoveElement(i);
+      }
+    }
+  }
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+
+  EZ_ALWAYS_INLINE __m128i SelectInt(__m128i mask, __m128i a, __m128i b)
+  {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  }
+
+  // Same result as ezFloat16::operator float() for the finite halfs stored in the lower 16 bits of each lane
+  EZ_ALWAYS_INLINE __m128 FiniteHalfToFloat(__m128i halfs)
+  {
+    const __m128i exponentMantissa = _mm_and_si128(halfs, _mm_set1_epi32(0x7fff));
+    const __m128i sign = _mm_slli_epi32(_mm_and_si128(halfs, _mm_set1_epi32(0x8000)), 16);
+
+    __m128i result = _mm_add_epi32(_mm_slli_epi32(exponentMantissa, 13), _mm_set1_epi32(112 << 23));
+
+    // Denormalized halfs (and zero) are exactly representable as normalized floats
+    const __m128i isDenormal = _mm_cmplt_epi32(exponentMantissa, _mm_set1_epi32(0x0400));
+    const __m128 denormal = _mm_mul_ps(_mm_cvtepi32_ps(exponentMantissa), _mm_set1_ps(1.0f / 16777216.0f));
+    result = SelectInt(isDenormal, _mm_castps_si128(denormal), result);
+
+    return _mm_castsi128_ps(_mm_or_si128(result, sign));
+  }
+
+  // Same result as ezFloat16::operator=(float) for positive values below 65536, in the lower 16 bits of each lane
+  EZ_ALWAYS_INLINE __m128i PositiveFloatToHalf(__m128 floats)
+  {
+    // Normalized halfs, the mantissa is truncated
+    const __m128i normal = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(floats), 13), _mm_set1_epi32(112 << 10));
+
+    // Denormalized halfs are the value in units of 2^-24, truncated as well
+    const __m128i denormal = _mm_cvttps_epi32(_mm_mul_ps(floats, _mm_set1_ps(16777216.0f)));
+    const __m128i isDenormal = _mm_castps_si128(_mm_cmplt_ps(floats, _mm_set1_ps(1.0f / 16384.0f)));
+
+    return SelectInt(isDenormal, denormal, normal);
+  }
+
+#endif
+} // namespace
+
+// static
+void ezParticleStreamSimd::AddToFloat3SoA(const ezProcessingStream* pStream, ezUInt64 uiNumElements, const ezVec3& vAdd)
+{
+  const ezSimdVec4f vAddComponents[3] = {ezSimdVec4f(vAdd.x), ezSimdVec4f(vAdd.y), ezSimdVec4f(vAdd.z)};
+
+  ProcessFloat3SoA(pStream, uiNumElements, [&](const ezSimdVec4f& v, ezUInt32 uiComponent) { return v + vAddComponents[uiComponent]; });
+}
+
+// static
+void ezParticleStreamSimd::ScaleFloat3SoA(const ezProcessingStream* pStream, ezUInt64 uiNumElements, float fFactor)
+{
+  const ezSimdFloat factor(fFactor);
+
+  ProcessFloat3SoA(pStream, uiNumElements, [&](const ezSimdVec4f& v, ezUInt32 uiComponent) { return v * factor; });
+}
+
+// static
+void ezParticleStreamSimd::AddToFloat4(ezVec4* pData, ezUInt64 uiNumElements, const ezSimdVec4f& vAdd)
+{
+  float* pFloats = &pData->x;
+
+  for (ezUInt64 i = 0; i < uiNumElements; ++i)
+  {
+    ezSimdVec4f v;
+    v.Load<4>(pFloats);
+
+    (v + vAdd).Store<4>(pFloats);
+
+    pFloats += 4;
+  }
+}
+
+// static
+void ezParticleStreamSimd::MulAddFloat3SoAToFloat4(ezVec4* pData, const ezProcessingStream* pVectors, ezUInt64 uiNumElements, float fFactor)
+{
+  EZ_ASSERT_DEBUG(pVectors->GetDataType() == ezProcessingStream::DataType::Float3SoA, "Stream '{0}' is not a Float3SoA stream", pVectors->GetName());
+
+  const float* pX = pVectors->GetComponentData<float>(0);
+  const float* pY = pVectors->GetComponentData<float>(1);
+  const float* pZ = pVectors->GetComponentData<float>(2);
+
+  float* pFloats = &pData->x;
+  const ezSimdFloat factor(fFactor);
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+  // the Float4 data is not padded, so only whole packets are processed here
+  ezUInt64 i = 0;
+  for (; i + 4 <= uiNumElements; i += 4)
+  {
+    ezSimdVec4f x, y, z;
+    x.Load<4>(pX + i);
+    y.Load<4>(pY + i);
+    z.Load<4>(pZ + i);
+
+    // transpose into one register per particle, w is zero and thus keeps the w component of the data
+    const ezSimdVec4f xy01 = x.GetCombined<ezSwizzle::XYXY>(y); // x0 x1 y0 y1
+    const ezSimdVec4f xy23 = x.GetCombined<ezSwizzle::ZWZW>(y); // x2 x3 y2 y3
+    const ezSimdVec4f z01 = z.GetCombined<ezSwizzle::XYXY>(zero); // z0 z1 0 0
+    const ezSimdVec4f z23 = z.GetCombined<ezSwizzle::ZWZW>(zero); // z2 z3 0 0
+
+    const ezSimdVec4f vec0 = xy01.GetCombined<ezSwizzle::XZXZ>(z01);
+    const ezSimdVec4f vec1 = xy01.GetCombined<ezSwizzle::YWYW>(z01);
+    const ezSimdVec4f vec2 = xy23.GetCombined<ezSwizzle::XZXZ>(z23);
+    const ezSimdVec4f vec3 = xy23.GetCombined<ezSwizzle::YWYW>(z23);
+
+    ezSimdVec4f p0, p1, p2, p3;
+    p0.Load<4>(pFloats + 0);
+    p1.Load<4>(pFloats + 4);
+    p2.Load<4>(pFloats + 8);
+    p3.Load<4>(pFloats + 12);
+
+    ezSimdVec4f::MulAdd(vec0, factor, p0).Store<4>(pFloats + 0);
+    ezSimdVec4f::MulAdd(vec1, factor, p1).Store<4>(pFloats + 4);
+    ezSimdVec4f::MulAdd(vec2, factor, p2).Store<4>(pFloats + 8);
+    ezSimdVec4f::MulAdd(vec3, factor, p3).Store<4>(pFloats + 12);
+
+    pFloats += 16;
+  }
+
+  for (; i < uiNumElements; ++i)
+  {
+    const ezSimdVec4f v(pX[i], pY[i], pZ[i], 0.0f);
+
+    ezSimdVec4f p;
+    p.Load<4>(pFloats);
+
+    ezSimdVec4f::MulAdd(v, factor, p).Store<4>(pFloats);
+
+    pFloats += 4;
+  }
+}
+
+// static
+void ezParticleStreamSimd::DecreaseLifeTime(ezFloat16Vec2* pLifeTime, ezUInt64 uiNumElements, float fTimeDiff, ezProcessingStreamGroup* pStreamGroup)
+{
+  ezUInt64 i = 0;
+
+#if EZ_SIMD_IMPLEMENTATION == EZ_SIMD_IMPLEMENTATION_SSE && EZ_SSE_LEVEL >= EZ_SSE_20
+
+  // four particles per packet, the life time is in the lower and its inverse in the upper 16 bits of each lane
+  const __m128 timeDiff = _mm_set1_ps(fTimeDiff);
+  const __m128i lowerHalf = _mm_set1_epi32(0xffff);
+
+  for (; i + 4 <= uiNumElements; i += 4)
+  {
+    __m128i* pPacket = reinterpret_cast<__m128i*>(pLifeTime + i);
+
+    const __m128i packet = _mm_loadu_si128(pPacket);
+    const __m128i halfs = _mm_and_si128(packet, lowerHalf);
+    const __m128 remaining = _mm_sub_ps(FiniteHalfToFloat(halfs), timeDiff);
+
+    // infinity, NaN and overflow are rare enough to leave them to the scalar code
+    const __m128i isInfNaN = _mm_cmpgt_epi32(_mm_and_si128(halfs, _mm_set1_epi32(0x7fff)), _mm_set1_epi32(0x7bff));
+    const __m128 isOverflow = _mm_cmpge_ps(remaining, _mm_set1_ps(65536.0f));
+    if (_mm_movemask_ps(_mm_or_ps(_mm_castsi128_ps(isInfNaN), isOverflow)) != 0)
+    {
+      DecreaseLifeTimeScalar(pLifeTime, i, i + 4, fTimeDiff, pStreamGroup);
+      continue;
+    }
+
+    // particles expire when their life time as a half is zero or negative, it is then stored as zero
+    __m128i newHalfs = PositiveFloatToHalf(remaining);
+    const __m128i isExpired =
+      _mm_or_si128(_mm_castps_si128(_mm_cmple_ps(remaining, _mm_setzero_ps())), _mm_cmpeq_epi32(newHalfs, _mm_setzero_si128()));
+    newHalfs = _mm_andnot_si128(isExpired, newHalfs);
+
+    _mm_storeu_si128(pPacket, _mm_or_si128(_mm_andnot_si128(lowerHalf, packet), newHalfs));
+
+    ezUInt32 uiExpiredMask = static_cast<ezUInt32>(_mm_movemask_ps(_mm_castsi128_ps(isExpired)));
+    while (uiExpiredMask != 0)
+    {
+      pStreamGroup->RemoveElement(i + ezMath::FirstBitLow(uiExpiredMask));
+      uiExpiredMask &= uiExpiredMask - 1;
+    }
+  }
+
+#endif
+
+  DecreaseLifeTimeScalar(pLifeTime, i, uiNumElements, fTimeDiff, pStreamGroup);
+}
+
+EZ_STATICLINK_FILE(ParticlePlugin, ParticlePlugin_Streams_ParticleStreamSimd);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Foundation/DataProcessing/Stream/ProcessingStream.h>
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <ParticlePlugin/ParticlePluginDLL.h>
+
+class ezFloat16Vec2;
+class ezProcessingStreamGroup;
+
+/// \brief SIMD kernels that process a whole particle stream at once.
+///
+/// Vector streams that are only ever processed as a whole, like the velocity, use the Float3SoA layout, so that four particles fit into
+/// one ezSimdVec4f per component. The component arrays are padded to a multiple of four, the kernels always process whole packets there.
+struct EZ_PARTICLEPLUGIN_DLL ezParticleStreamSimd
+{
+  /// \brief Adds vAdd to the first uiNumElements elements of a Float3SoA stream.
+  static void AddToFloat3SoA(const ezProcessingStream* pStream, ezUInt64 uiNumElements, const ezVec3& vAdd);
+
+  /// \brief Multiplies the first uiNumElements elements of a Float3SoA stream with fFactor.
+  static void ScaleFloat3SoA(const ezProcessingStream* pStream, ezUInt64 uiNumElements, float fFactor);
+
+  /// \brief pData[i] += vAdd
+  static void AddToFloat4(ezVec4* pData, ezUInt64 uiNumElements, const ezSimdVec4f& vAdd);
+
+  /// \brief pData[i].xyz += vectors[i] * fFactor, where the vectors come from a Float3SoA stream. The w component of pData is not modified.
+  static void MulAddFloat3SoAToFloat4(ezVec4* pData, const ezProcessingStream* pVectors, ezUInt64 uiNumElements, float fFactor);
+
+  /// \brief Subtracts fTimeDiff from the remaining life time (x) of each particle. Particles whose life time reaches zero are removed from
+  /// the group.
+  ///
+  /// The result is exactly the same as with the per element ezFloat16 conversion.
+  static void DecreaseLifeTime(ezFloat16Vec2* pLifeTime, ezUInt64 uiNumElements, float fTimeDiff, ezProcessingStreamGroup* pStreamGroup);
+};
+
+/// \brief Per particle access to a Float3SoA stream, for code that can't process the stream with ezParticleStreamSimd.
+class ezParticleStreamFloat3SoA
+{
+public:
+  explicit ezParticleStreamFloat3SoA(const ezProcessingStream* pStream)
+  {
+    EZ_ASSERT_DEBUG(pStream->GetDataType() == ezProcessingStream::DataType::Float3SoA, "Stream '{0}' is not a Float3SoA stream", pStream->GetName());
+
+    m_pX = pStream->GetWritableComponentData<float>(0);
+    m_pY = pStream->GetWritableComponentData<float>(1);
+    m_pZ = pStream->GetWritableComponentData<float>(2);
+  }
+
+  ezVec3 Get(ezUInt64 uiIndex) const { return ezVec3(m_pX[uiIndex], m_pY[uiIndex], m_pZ[uiIndex]); }
+
+  void Set(ezUInt64 uiIndex, const ezVec3& v) const
+  {
+    m_pX[uiIndex] = v.x;
+    m_pY[uiIndex] = v.y;
+    m_pZ[uiIndex] = v.z;
+  }
+
+private:
+  float* m_pX;
+  float* m_pY;
+  float* m_pZ;
+};
@@ -337,7 +337,9 @@ void ezParticleSystemInstance::ReinitializeStreamProcessors(const ezParticleSyst
 }
 
 ezParticleSystemInstance::ezParticleSystemInstance()
+  : m_Task(this)
 {
+  m_Task.ConfigureTask("Particle System Update", ezTaskNesting::Maybe);
   m_BoundingVolume = ezBoundingSphere(ezVec3::ZeroVector(), 0.25f);
 }
 
@@ -350,6 +352,15 @@ void ezParticleSystemInstance::Construct(ezUInt32 uiMaxParticles, ezWorld* pWorl
   m_bVisible = true;
   m_pWorld = pWorld;
   m_fSpawnCountMultiplier = fSpawnCountMultiplier;
+  m_SimulationTime.SetZero();
+  m_Task.m_UpdateDiff.SetZero();
+
+  // derived from the effect's generator, to stay deterministic for a given effect seed
+  // sequentially updated effects keep using the effect's generator, so their random sequence is not affected
+  if (pOwnerEffect->UpdatesSystemsInParallel())
+  {
+    m_Random.Initialize(static_cast<ezUInt64>(pOwnerEffect->GetRNG().UInt()) + 1);
+  }
 
   m_StreamInfo.Clear();
   m_StreamGroup.SetSize(uiMaxParticles);
@@ -371,6 +382,8 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& tDiff
 {
   EZ_PROFILE_SCOPE("PFX: System Update");
 
+  const ezTime tStart = ezTime::Now();
+
   ezUInt32 uiSpawnedParticles = 0;
 
   if (m_bEmitterEnabled)
@@ -453,6 +466,8 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& tDiff
     m_StreamGroup.Process();
   }
 
+  m_SimulationTime += ezTime::Now() - tStart;
+
   if (m_bEmitterEnabled)
     return ezParticleSystemState::Active;
 
@@ -463,6 +478,32 @@ ezParticleSystemState::Enum ezParticleSystemInstance::Update(const ezTime& tDiff
   return bHasReactingEmitters ? ezParticleSystemState::OnlyReacting : ezParticleSystemState::Inactive;
 }
 
+ezRandom& ezParticleSystemInstance::GetRNG()
+{
+  return m_pOwnerEffect->UpdatesSystemsInParallel() ? m_Random : m_pOwnerEffect->GetRNG();
+}
+
+ezTime ezParticleSystemInstance::TakeSimulationTime()
+{
+  const ezTime result = m_SimulationTime;
+  m_SimulationTime.SetZero();
+  return result;
+}
+
+ezParticleSystemUpdateTask::ezParticleSystemUpdateTask(ezParticleSystemInstance* pSystem)
+{
+  m_pSystem = pSystem;
+  m_UpdateDiff.SetZero();
+}
+
+void ezParticleSystemUpdateTask::Execute()
+{
+  if (HasBeenCanceled())
+    return;
+
+  m_State = m_pSystem->Update(m_UpdateDiff);
+}
+
 ezProcessingStream* ezParticleSystemInstance::QueryStream(const char* szName, ezProcessingStream::DataType Type) const
 {
   ezStringBuilder fullName;
@@ -4,12 +4,29 @@
 #include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
 #include <Foundation/Math/BoundingBoxSphere.h>
 #include <Foundation/Math/Random.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <ParticlePlugin/ParticlePluginDLL.h>
 #include <ParticlePlugin/Declarations.h>
 #include <ParticlePlugin/Events/ParticleEvent.h>
 
 class ezView;
 class ezExtractedRenderData;
+class ezParticleSystemInstance;
+
+/// \brief Steps a single particle system, such that the systems of one effect can be simulated in parallel
+class ezParticleSystemUpdateTask final : public ezTask
+{
+public:
+  ezParticleSystemUpdateTask(ezParticleSystemInstance* pSystem);
+
+  ezTime m_UpdateDiff;
+  ezParticleSystemState::Enum m_State = ezParticleSystemState::Active;
+
+private:
+  virtual void Execute() override;
+
+  ezParticleSystemInstance* m_pSystem;
+};
 
 /// \brief A particle system stores all data for one 'layer' of a running particle effect
 class EZ_PARTICLEPLUGIN_DLL ezParticleSystemInstance
@@ -76,6 +93,15 @@ public:
 
   float GetSpawnCountMultiplier() const { return m_fSpawnCountMultiplier; }
 
+  /// \brief Returns the random number generator of the owner effect, or this system's own one if the effect updates its systems in parallel.
+  ezRandom& GetRNG();
+
+  /// \brief Returns the task that is used when the owner effect updates its systems in parallel.
+  ezParticleSystemUpdateTask* GetUpdateTask() { return &m_Task; }
+
+  /// \brief Returns the time spent in Update() since the last call and resets it.
+  ezTime TakeSimulationTime();
+
 private:
   bool IsEmitterConfigEqual(const ezParticleSystemDescriptor* pTemplate) const;
   bool IsInitializerConfigEqual(const ezParticleSystemDescriptor* pTemplate) const;
@@ -98,6 +124,9 @@ private:
   ezTransform m_Transform;
   ezVec3 m_vParticleStartVelocity;
   float m_fSpawnCountMultiplier = 1.0f;
+  ezRandom m_Random;
+  ezTime m_SimulationTime;
+  ezParticleSystemUpdateTask m_Task;
 
   ezProcessingStreamGroup m_StreamGroup;
 
@@ -116,7 +116,16 @@ void ezParticleWorldModule::DestroyEffectInstance(const ezParticleEffectHandle&
 
     if (bInterruptImmediately)
     {
-      pInstance->Interrupt();
+      if (pInstance->m_bSystemUpdatesPending)
+      {
+        // the system tasks may still be running, clearing the systems has to wait until EnsureUpdatesFinished()
+        // this function is also called from within tasks and while m_Mutex is held, so it must not block on other tasks here
+        pInstance->m_bInterruptAfterSystemUpdates = true;
+      }
+      else
+      {
+        pInstance->Interrupt();
+      }
     }
   }
 }
@@ -134,6 +143,7 @@ void ezParticleWorldModule::UpdateEffects(const ezWorldModule::UpdateContext& co
 
   EZ_LOCK(m_Mutex);
 
+  PublishStats();
   DestroyFinishedEffects();
   ReconfigureEffects();
 
@@ -147,6 +157,21 @@ void ezParticleWorldModule::UpdateEffects(const ezWorldModule::UpdateContext& co
 
     m_ParticleEffects[i].ProcessEventQueues();
 
+    if (m_ParticleEffects[i].CanUpdateSystemsInParallel(tDiff))
+    {
+      // each system gets its own task, the effect is finished up in EnsureUpdatesFinished()
+      if (m_ParticleEffects[i].BeginSystemUpdates(tDiff, m_EffectUpdateTaskGroup))
+      {
+        m_EffectsWithSystemUpdates.PushBack(&m_ParticleEffects[i]);
+      }
+      else
+      {
+        DestroyEffectInstance(m_ParticleEffects[i].GetHandle(), true, nullptr);
+      }
+
+      continue;
+    }
+
     ezParticleffectUpdateTask* pTask = m_ParticleEffects[i].GetUpdateTask();
     pTask->m_UpdateDiff = tDiff;
 
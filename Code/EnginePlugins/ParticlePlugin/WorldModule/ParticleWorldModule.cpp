@@ -3,8 +3,10 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/Threading/Lock.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Utilities/Stats.h>
 #include <GameEngine/Interfaces/PhysicsWorldModule.h>
 #include <Module/ParticleModule.h>
 #include <ParticlePlugin/Components/ParticleComponent.h>
@@ -22,6 +24,8 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParticleWorldModule, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezCVarBool CVarParticleStats("pfx_Stats", false, ezCVarFlags::Default, "Publishes the number of particles and the simulation time per effect");
+
 ezParticleWorldModule::ezParticleWorldModule(ezWorld* pWorld)
   : ezWorldModule(pWorld)
 {
@@ -93,6 +97,16 @@ void ezParticleWorldModule::EnsureUpdatesFinished(const ezWorldModule::UpdateCon
   {
     EZ_LOCK(m_Mutex);
 
+    for (ezParticleEffectInstance* pEffect : m_EffectsWithSystemUpdates)
+    {
+      if (!pEffect->EndSystemUpdates())
+      {
+        DestroyEffectInstance(pEffect->GetHandle(), true, nullptr);
+      }
+    }
+
+    m_EffectsWithSystemUpdates.Clear();
+
     for (ezUInt32 i = 0; i < m_NeedFinisherComponent.GetCount(); ++i)
     {
       CreateFinisherComponent(m_NeedFinisherComponent[i]);
@@ -102,6 +116,101 @@ void ezParticleWorldModule::EnsureUpdatesFinished(const ezWorldModule::UpdateCon
   }
 }
 
+namespace
+{
+  static const char* s_szEffectStatNames[] = {"Instances", "Systems", "Particles", "Simulation Time"};
+
+  void RemoveEffectStats(const ezString& sEffect)
+  {
+    ezStringBuilder sStatName;
+    for (const char* szStat : s_szEffectStatNames)
+    {
+      sStatName.Format("Particles/{0}/{1}", sEffect, szStat);
+      ezStats::RemoveStat(sStatName);
+    }
+  }
+} // namespace
+
+void ezParticleWorldModule::PublishStats()
+{
+  if (!CVarParticleStats)
+  {
+    if (m_bPublishStats)
+    {
+      for (auto it = m_PublishedStatEffects.GetIterator(); it.IsValid(); ++it)
+      {
+        RemoveEffectStats(it.Key());
+      }
+
+      m_PublishedStatEffects.Clear();
+      m_bPublishStats = false;
+    }
+
+    return;
+  }
+
+  struct EffectStats
+  {
+    ezUInt32 m_uiNumInstances = 0;
+    ezUInt32 m_uiNumSystems = 0;
+    ezUInt64 m_uiNumParticles = 0;
+    ezTime m_SimulationTime;
+  };
+
+  ezMap<ezString, EffectStats> effectStats;
+
+  for (auto it = m_ActiveEffects.GetIterator(); it.IsValid(); ++it)
+  {
+    const ezParticleEffectInstance* pEffect = it.Value();
+
+    EffectStats& stats = effectStats[pEffect->GetResource().GetResourceID()];
+    ++stats.m_uiNumInstances;
+
+    for (ezParticleSystemInstance* pSystem : pEffect->GetParticleSystems())
+    {
+      if (pSystem == nullptr)
+        continue;
+
+      ++stats.m_uiNumSystems;
+      stats.m_uiNumParticles += pSystem->GetNumActiveParticles();
+      stats.m_SimulationTime += pSystem->TakeSimulationTime();
+    }
+  }
+
+  // the first frame only resets the simulation times that have accumulated while the stats were disabled
+  if (!m_bPublishStats)
+  {
+    m_bPublishStats = true;
+    return;
+  }
+
+  ezStringBuilder sStatName;
+  ezHashSet<ezString> publishedEffects;
+
+  for (auto it = effectStats.GetIterator(); it.IsValid(); ++it)
+  {
+    const EffectStats& stats = it.Value();
+    const ezVariant values[] = {stats.m_uiNumInstances, stats.m_uiNumSystems, stats.m_uiNumParticles, stats.m_SimulationTime};
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(s_szEffectStatNames); ++i)
+    {
+      sStatName.Format("Particles/{0}/{1}", it.Key(), s_szEffectStatNames[i]);
+      ezStats::SetStat(sStatName, values[i]);
+    }
+
+    publishedEffects.Insert(it.Key());
+    m_PublishedStatEffects.Remove(it.Key());
+  }
+
+  // remove the stats of effects that are not active anymore
+  for (auto it = m_PublishedStatEffects.GetIterator(); it.IsValid(); ++it)
+  {
+    RemoveEffectStats(it.Key());
+  }
+
+  m_PublishedStatEffects.Swap(publishedEffects);
+}
+
 void ezParticleWorldModule::ExtractRenderData(const ezView& view, ezExtractedRenderData& extractedRenderData) const
 {
   EZ_ASSERT_RELEASE(ezTaskSystem::IsTaskGroupFinished(m_EffectUpdateTaskGroup), "Particle Effect Update Task is not finished!");
@@ -268,6 +377,7 @@ void ezParticleWorldModule::WorldClear()
 
   m_FinishingEffects.Clear();
   m_NeedFinisherComponent.Clear();
+  m_EffectsWithSystemUpdates.Clear();
 
   m_ActiveEffects.Clear();
   m_ParticleEffects.Clear();
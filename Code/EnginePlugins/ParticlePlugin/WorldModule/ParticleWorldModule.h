@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/Containers/HashSet.h>
 #include <Foundation/Containers/IdTable.h>
 #include <ParticlePlugin/Effect/ParticleEffectInstance.h>
 #include <ParticlePlugin/Events/ParticleEvent.h>
@@ -22,6 +23,12 @@ class ezParticleStreamFactory;
 /// When an effect is stopped, it only stops emitting new particles, but it lives on until all particles are dead.
 /// Therefore particle effects need to be managed outside of components. When a component dies, it only tells the
 /// world module to 'destroy' it's effect, the rest is handled behind the scenes.
+///
+/// Effects are updated in parallel. When an effect only needs a single simulation step in a frame, each of its particle systems is
+/// updated by a separate task. Effects that are not visible in any view are simulated at their configured reduced update rate and
+/// catch up once they become visible again.
+/// With the CVar 'pfx_Stats' enabled, the number of instances, systems, particles and the simulation time per effect are published
+/// through ezStats.
 class EZ_PARTICLEPLUGIN_DLL ezParticleWorldModule final : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
@@ -71,6 +78,7 @@ private:
 
   void UpdateEffects(const ezWorldModule::UpdateContext& context);
   void EnsureUpdatesFinished(const ezWorldModule::UpdateContext& context);
+  void PublishStats();
 
   void DestroyFinishedEffects();
   void ResourceEventHandler(const ezResourceEvent& e);
@@ -95,6 +103,9 @@ private:
   ezDeque<ezParticleSystemInstance> m_ParticleSystems;
   ezDynamicArray<ezParticleSystemInstance*> m_ParticleSystemFreeList;
   ezTaskGroupID m_EffectUpdateTaskGroup;
+  ezDynamicArray<ezParticleEffectInstance*> m_EffectsWithSystemUpdates;
+  ezHashSet<ezString> m_PublishedStatEffects;
+  bool m_bPublishStats = false;
   ezMap<ezString, ezParticleStreamFactory*> m_StreamFactories;
   ezHashTable<const ezRTTI*, ezWorldModule*> m_WorldModuleCache;
 };
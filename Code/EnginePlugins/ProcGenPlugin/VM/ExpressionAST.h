@@ -44,6 +44,9 @@ public:
       // Ternary
       Select,
 
+      // Fused, only created by the compiler
+      MultiplyAdd,
+
       // Constant
       FloatConstant,
 
@@ -60,6 +63,7 @@ public:
 
     static bool IsUnary(Enum nodeType);
     static bool IsBinary(Enum nodeType);
+    static bool IsCommutative(Enum nodeType);
     static bool IsConstant(Enum nodeType);
     static bool IsInput(Enum nodeType);
     static bool IsOutput(Enum nodeType);
@@ -90,6 +94,14 @@ public:
     Node* m_pFalseOperand = nullptr;
   };
 
+  /// \brief Left * Right + Addend
+  struct MultiplyAdd : public Node
+  {
+    Node* m_pLeftOperand = nullptr;
+    Node* m_pRightOperand = nullptr;
+    Node* m_pAddend = nullptr;
+  };
+
   struct Constant : public Node
   {
     ezVariant m_Value;
@@ -119,6 +131,7 @@ public:
   UnaryOperator* CreateUnaryOperator(NodeType::Enum type, Node* pOperand);
   BinaryOperator* CreateBinaryOperator(NodeType::Enum type, Node* pLeftOperand, Node* pRightOperand);
   Select* CreateSelect(Node* pCondition, Node* pTrueOperand, Node* pFalseOperand);
+  MultiplyAdd* CreateMultiplyAdd(Node* pLeftOperand, Node* pRightOperand, Node* pAddend);
   Constant* CreateConstant(const ezVariant& value);
   Input* CreateInput(const ezHashedString& sName);
   Output* CreateOutput(const ezHashedString& sName, Node* pExpression);
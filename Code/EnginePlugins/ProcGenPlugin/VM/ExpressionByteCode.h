@@ -56,6 +56,14 @@ public:
 
       Call,
 
+      // Ternary, fused instructions
+      FirstTernary,
+
+      MulAdd_RRR,
+      MulAdd_CRR,
+
+      LastTernary,
+
       Count
     };
   };
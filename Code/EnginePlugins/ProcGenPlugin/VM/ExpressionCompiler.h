@@ -10,9 +10,24 @@ public:
   ezExpressionCompiler();
   ~ezExpressionCompiler();
 
-  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode);
+  /// \brief Compiles the given AST to byte code.
+  ///
+  /// If \a bOptimize is set, the AST is optimized in place first: constants are folded, identical sub expressions are merged, outputs that
+  /// are overwritten later are removed and operations are rewritten to cheaper forms, e.g. constants are moved to the left operand so
+  /// they can be encoded in place and divisions by constants become multiplications. Finally multiplications that are only used by an
+  /// addition are fused into a single multiply add instruction.
+  ezResult Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize = true);
 
 private:
+  ezResult OptimizeAST(ezExpressionAST& ast);
+  ezExpressionAST::Node* SimplifyNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* CreateConstant(ezExpressionAST& ast, float fValue);
+  ezExpressionAST::Node* DeduplicateNode(ezExpressionAST::Node* pNode);
+  ezExpressionAST::Node* FuseNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode);
+
+  template <typename Func>
+  ezResult TransformAST(ezExpressionAST& ast, Func func);
+
   ezResult BuildNodeInstructions(const ezExpressionAST& ast);
   ezResult UpdateRegisterLifetime(const ezExpressionAST& ast);
   ezResult AssignRegisters();
@@ -22,6 +37,26 @@ private:
   ezHybridArray<const ezExpressionAST::Node*, 64> m_NodeInstructions;
   ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeToRegisterIndex;
 
+  /// \brief Hashes and compares nodes by their type, value and children, so that identical sub expressions can be found.
+  struct NodeHashHelper
+  {
+    static ezUInt32 Hash(const ezExpressionAST::Node* pNode);
+    static bool Equal(const ezExpressionAST::Node* a, const ezExpressionAST::Node* b);
+  };
+
+  struct NodeToOptimize
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezExpressionAST::Node* m_pNode;
+    bool m_bChildrenDone;
+  };
+
+  ezHybridArray<NodeToOptimize, 64> m_NodesToOptimize;
+  ezHashTable<const ezExpressionAST::Node*, ezExpressionAST::Node*> m_OptimizedNodes;
+  ezHashTable<const ezExpressionAST::Node*, ezExpressionAST::Node*, NodeHashHelper> m_UniqueNodes;
+  ezHashTable<const ezExpressionAST::Node*, ezUInt32> m_NodeUseCount;
+
   ezHashTable<ezHashedString, ezUInt32> m_InputToIndex;
   ezHashTable<ezHashedString, ezUInt32> m_OutputToIndex;
   ezHashTable<ezHashedString, ezUInt32> m_FunctionToIndex;
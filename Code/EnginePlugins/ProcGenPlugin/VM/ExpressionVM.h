@@ -68,6 +68,9 @@ public:
     ezUInt32 uiNumInstances, const ezExpression::GlobalData& globalData = ezExpression::GlobalData());
 
 private:
+  ezResult ExecuteBatch(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezExpression::Stream> outputs,
+    ezUInt32 uiFirstInstance, ezUInt32 uiNumRegisters, const ezExpression::GlobalData& globalData);
+
   ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Registers;
 
   ezDynamicArray<ezUInt32> m_InputMapping;
@@ -15,6 +15,12 @@ bool ezExpressionAST::NodeType::IsBinary(Enum nodeType)
   return nodeType > FirstBinary && nodeType < LastBinary;
 }
 
+// static
+bool ezExpressionAST::NodeType::IsCommutative(Enum nodeType)
+{
+  return nodeType == Add || nodeType == Multiply || nodeType == Min || nodeType == Max;
+}
+
 // static
 bool ezExpressionAST::NodeType::IsConstant(Enum nodeType)
 {
@@ -46,6 +52,9 @@ namespace
     // Ternary
     "Select",
 
+    // Fused
+    "MultiplyAdd",
+
     // Constant
     "FloatConstant",
 
@@ -96,6 +105,17 @@ ezExpressionAST::BinaryOperator* ezExpressionAST::CreateBinaryOperator(NodeType:
   return pBinaryOperator;
 }
 
+ezExpressionAST::MultiplyAdd* ezExpressionAST::CreateMultiplyAdd(Node* pLeftOperand, Node* pRightOperand, Node* pAddend)
+{
+  auto pMultiplyAdd = EZ_NEW(&m_Allocator, MultiplyAdd);
+  pMultiplyAdd->m_Type = NodeType::MultiplyAdd;
+  pMultiplyAdd->m_pLeftOperand = pLeftOperand;
+  pMultiplyAdd->m_pRightOperand = pRightOperand;
+  pMultiplyAdd->m_pAddend = pAddend;
+
+  return pMultiplyAdd;
+}
+
 ezExpressionAST::Constant* ezExpressionAST::CreateConstant(const ezVariant& value)
 {
   EZ_ASSERT_DEV(value.IsA<float>(), "value needs to be float");
@@ -149,6 +169,11 @@ ezArrayPtr<ezExpressionAST::Node*> ezExpressionAST::GetChildren(Node* pNode)
     auto& pChildren = static_cast<BinaryOperator*>(pNode)->m_pLeftOperand;
     return ezMakeArrayPtr(&pChildren, 2);
   }
+  else if (nodeType == NodeType::MultiplyAdd)
+  {
+    auto& pChildren = static_cast<MultiplyAdd*>(pNode)->m_pLeftOperand;
+    return ezMakeArrayPtr(&pChildren, 3);
+  }
   else if (NodeType::IsOutput(nodeType))
   {
     auto& pChild = static_cast<Output*>(pNode)->m_pExpression;
@@ -177,6 +202,11 @@ ezArrayPtr<const ezExpressionAST::Node*> ezExpressionAST::GetChildren(const Node
     auto& pChildren = static_cast<const BinaryOperator*>(pNode)->m_pLeftOperand;
     return ezMakeArrayPtr((const Node**)&pChildren, 2);
   }
+  else if (nodeType == NodeType::MultiplyAdd)
+  {
+    auto& pChildren = static_cast<const MultiplyAdd*>(pNode)->m_pLeftOperand;
+    return ezMakeArrayPtr((const Node**)&pChildren, 3);
+  }
   else if (NodeType::IsOutput(nodeType))
   {
     auto& pChild = static_cast<const Output*>(pNode)->m_pExpression;
@@ -58,6 +58,14 @@ namespace
     "",
 
     "Call",
+
+    // Ternary
+    "",
+
+    "MulAdd_RRR",
+    "MulAdd_CRR",
+
+    "",
   };
 
   EZ_CHECK_AT_COMPILETIME_MSG(
@@ -68,7 +76,7 @@ namespace
     return opCode == ezExpressionByteCode::OpCode::Mov_C || opCode == ezExpressionByteCode::OpCode::Add_CR ||
            opCode == ezExpressionByteCode::OpCode::Sub_CR || opCode == ezExpressionByteCode::OpCode::Mul_CR ||
            opCode == ezExpressionByteCode::OpCode::Div_CR || opCode == ezExpressionByteCode::OpCode::Min_CR ||
-           opCode == ezExpressionByteCode::OpCode::Max_CR;
+           opCode == ezExpressionByteCode::OpCode::Max_CR || opCode == ezExpressionByteCode::OpCode::MulAdd_CRR;
   }
 } // namespace
 
@@ -144,6 +152,22 @@ void ezExpressionByteCode::Disassemble(ezStringBuilder& out_sDisassembly) const
         out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3}\n", szOpCode, r, a, b);
       }
     }
+    else if (opCode > OpCode::FirstTernary && opCode < OpCode::LastTernary)
+    {
+      ezUInt32 r = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 a = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 b = GetRegisterIndex(pByteCode, 1);
+      ezUInt32 c = GetRegisterIndex(pByteCode, 1);
+
+      if (FirstArgIsConstant(opCode))
+      {
+        out_sDisassembly.AppendFormat("{0} r{1} {2} r{3} r{4}\n", szOpCode, r, ezArgF(*reinterpret_cast<float*>(&a), 6), b, c);
+      }
+      else
+      {
+        out_sDisassembly.AppendFormat("{0} r{1} r{2} r{3} r{4}\n", szOpCode, r, a, b, c);
+      }
+    }
     else if (opCode == OpCode::Call)
     {
       ezUInt32 uiIndex = GetFunctionIndex(pByteCode);
@@ -1,5 +1,6 @@
 #include <ProcGenPluginPCH.h>
 
+#include <Foundation/SimdMath/SimdMath.h>
 #include <ProcGenPlugin/VM/ExpressionByteCode.h>
 #include <ProcGenPlugin/VM/ExpressionCompiler.h>
 
@@ -45,13 +46,106 @@ namespace
         return ezExpressionByteCode::OpCode::FirstUnary;
     }
   }
+
+  // Folding uses the same SIMD functions as the VM, so folded constants are bit identical to the values the VM would compute.
+  static float FoldUnary(ezExpressionAST::NodeType::Enum nodeType, float fOperand)
+  {
+    const ezSimdVec4f x(fOperand);
+    ezSimdVec4f r;
+
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Negate:
+        r = -x;
+        break;
+      case ezExpressionAST::NodeType::Absolute:
+        r = x.Abs();
+        break;
+      case ezExpressionAST::NodeType::Sqrt:
+        r = x.GetSqrt();
+        break;
+      case ezExpressionAST::NodeType::Sin:
+        r = ezSimdMath::Sin(x);
+        break;
+      case ezExpressionAST::NodeType::Cos:
+        r = ezSimdMath::Cos(x);
+        break;
+      case ezExpressionAST::NodeType::Tan:
+        r = ezSimdMath::Tan(x);
+        break;
+      case ezExpressionAST::NodeType::ASin:
+        r = ezSimdMath::ASin(x);
+        break;
+      case ezExpressionAST::NodeType::ACos:
+        r = ezSimdMath::ACos(x);
+        break;
+      case ezExpressionAST::NodeType::ATan:
+        r = ezSimdMath::ATan(x);
+        break;
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+    }
+
+    return r.x();
+  }
+
+  static float FoldBinary(ezExpressionAST::NodeType::Enum nodeType, float fLeft, float fRight)
+  {
+    const ezSimdVec4f a(fLeft);
+    const ezSimdVec4f b(fRight);
+    ezSimdVec4f r;
+
+    switch (nodeType)
+    {
+      case ezExpressionAST::NodeType::Add:
+        r = a + b;
+        break;
+      case ezExpressionAST::NodeType::Subtract:
+        r = a - b;
+        break;
+      case ezExpressionAST::NodeType::Multiply:
+        r = a.CompMul(b);
+        break;
+      case ezExpressionAST::NodeType::Divide:
+        r = a.CompDiv(b);
+        break;
+      case ezExpressionAST::NodeType::Min:
+        r = a.CompMin(b);
+        break;
+      case ezExpressionAST::NodeType::Max:
+        r = a.CompMax(b);
+        break;
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+    }
+
+    return r.x();
+  }
+
+  EZ_ALWAYS_INLINE bool IsConstant(const ezExpressionAST::Node* pNode)
+  {
+    return ezExpressionAST::NodeType::IsConstant(pNode->m_Type);
+  }
+
+  EZ_ALWAYS_INLINE float GetConstantValue(const ezExpressionAST::Node* pNode)
+  {
+    return static_cast<const ezExpressionAST::Constant*>(pNode)->m_Value.Get<float>();
+  }
+
+  EZ_ALWAYS_INLINE bool IsConstantValue(const ezExpressionAST::Node* pNode, float fValue)
+  {
+    return IsConstant(pNode) && GetConstantValue(pNode) == fValue;
+  }
 } // namespace
 
 ezExpressionCompiler::ezExpressionCompiler() = default;
 ezExpressionCompiler::~ezExpressionCompiler() = default;
 
-ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode)
+ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCode& out_byteCode, bool bOptimize /*= true*/)
 {
+  if (bOptimize && OptimizeAST(ast).Failed())
+    return EZ_FAILURE;
+
   if (BuildNodeInstructions(ast).Failed())
     return EZ_FAILURE;
 
@@ -67,6 +161,327 @@ ezResult ezExpressionCompiler::Compile(ezExpressionAST& ast, ezExpressionByteCod
   return EZ_SUCCESS;
 }
 
+ezResult ezExpressionCompiler::OptimizeAST(ezExpressionAST& ast)
+{
+  // Dead code elimination: an output that is written again later never reaches the caller.
+  // Nodes that are not reachable from any output are skipped by BuildNodeInstructions anyway.
+  for (ezUInt32 i = 0; i < ast.m_OutputNodes.GetCount(); ++i)
+  {
+    if (ast.m_OutputNodes[i] == nullptr)
+      continue;
+
+    for (ezUInt32 j = i + 1; j < ast.m_OutputNodes.GetCount(); ++j)
+    {
+      if (ast.m_OutputNodes[j] != nullptr && ast.m_OutputNodes[j]->m_sName == ast.m_OutputNodes[i]->m_sName)
+      {
+        ast.m_OutputNodes[i] = nullptr;
+        break;
+      }
+    }
+  }
+
+  m_UniqueNodes.Clear();
+  EZ_SUCCEED_OR_RETURN(TransformAST(ast, [&](ezExpressionAST::Node* pNode) { return SimplifyNode(ast, pNode); }));
+
+  // Fusing needs to know whether the result of a multiplication is used anywhere else
+  m_NodeUseCount.Clear();
+  for (ezExpressionAST::Output* pOutputNode : ast.m_OutputNodes)
+  {
+    if (pOutputNode != nullptr)
+    {
+      m_NodeUseCount[pOutputNode->m_pExpression]++;
+    }
+  }
+
+  EZ_SUCCEED_OR_RETURN(TransformAST(ast, [&](ezExpressionAST::Node* pNode) {
+    for (auto pChild : ezExpressionAST::GetChildren(pNode))
+    {
+      m_NodeUseCount[pChild]++;
+    }
+    return pNode;
+  }));
+
+  EZ_SUCCEED_OR_RETURN(TransformAST(ast, [&](ezExpressionAST::Node* pNode) { return FuseNode(ast, pNode); }));
+
+  return EZ_SUCCESS;
+}
+
+template <typename Func>
+ezResult ezExpressionCompiler::TransformAST(ezExpressionAST& ast, Func func)
+{
+  m_NodesToOptimize.Clear();
+  m_OptimizedNodes.Clear();
+
+  // Post order traversal, so that the children of a node are already transformed when the node itself is visited.
+  // Every node is only visited once, even if it is referenced by several parents.
+  for (ezExpressionAST::Output* pOutputNode : ast.m_OutputNodes)
+  {
+    if (pOutputNode == nullptr)
+      continue;
+
+    if (pOutputNode->m_pExpression == nullptr)
+      return EZ_FAILURE;
+
+    m_NodesToOptimize.PushBack({pOutputNode->m_pExpression, false});
+
+    while (!m_NodesToOptimize.IsEmpty())
+    {
+      ezExpressionAST::Node* pCurrentNode = m_NodesToOptimize.PeekBack().m_pNode;
+
+      if (m_OptimizedNodes.Contains(pCurrentNode))
+      {
+        m_NodesToOptimize.PopBack();
+        continue;
+      }
+
+      auto children = ezExpressionAST::GetChildren(pCurrentNode);
+
+      if (!m_NodesToOptimize.PeekBack().m_bChildrenDone)
+      {
+        m_NodesToOptimize.PeekBack().m_bChildrenDone = true;
+
+        for (auto pChild : children)
+        {
+          if (pChild == nullptr)
+            return EZ_FAILURE;
+
+          if (!m_OptimizedNodes.Contains(pChild))
+          {
+            m_NodesToOptimize.PushBack({pChild, false});
+          }
+        }
+
+        continue;
+      }
+
+      m_NodesToOptimize.PopBack();
+
+      for (auto& pChild : children)
+      {
+        pChild = m_OptimizedNodes[pChild];
+      }
+
+      m_OptimizedNodes.Insert(pCurrentNode, func(pCurrentNode));
+    }
+
+    pOutputNode->m_pExpression = m_OptimizedNodes[pOutputNode->m_pExpression];
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::SimplifyNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  // All children of pNode are simplified and unique at this point. Every rewrite below creates a new node which is simplified again.
+  const ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+
+  if (ezExpressionAST::NodeType::IsUnary(nodeType))
+  {
+    auto pUnary = static_cast<ezExpressionAST::UnaryOperator*>(pNode);
+    ezExpressionAST::Node* pOperand = pUnary->m_pOperand;
+
+    if (IsConstant(pOperand))
+    {
+      return CreateConstant(ast, FoldUnary(nodeType, GetConstantValue(pOperand)));
+    }
+
+    if (nodeType == ezExpressionAST::NodeType::Negate)
+    {
+      // the operand has been simplified already, so a nested negate shows up as 0 - x
+      if (pOperand->m_Type == ezExpressionAST::NodeType::Subtract)
+      {
+        auto pSubtract = static_cast<ezExpressionAST::BinaryOperator*>(pOperand);
+        if (IsConstantValue(pSubtract->m_pLeftOperand, 0.0f))
+        {
+          return pSubtract->m_pRightOperand;
+        }
+      }
+
+      // there is no negate instruction, 0 - x encodes the constant in place
+      return SimplifyNode(ast, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract, CreateConstant(ast, 0.0f), pOperand));
+    }
+
+    if (nodeType == ezExpressionAST::NodeType::Absolute && pOperand->m_Type == ezExpressionAST::NodeType::Absolute)
+    {
+      return pOperand;
+    }
+  }
+  else if (ezExpressionAST::NodeType::IsBinary(nodeType))
+  {
+    auto pBinary = static_cast<ezExpressionAST::BinaryOperator*>(pNode);
+    ezExpressionAST::Node* pLeft = pBinary->m_pLeftOperand;
+    ezExpressionAST::Node* pRight = pBinary->m_pRightOperand;
+
+    if (IsConstant(pLeft) && IsConstant(pRight))
+    {
+      return CreateConstant(ast, FoldBinary(nodeType, GetConstantValue(pLeft), GetConstantValue(pRight)));
+    }
+
+    // Constants can only be encoded in place as the left operand, anywhere else they need a separate mov instruction and a register.
+    if (IsConstant(pRight))
+    {
+      const float fRight = GetConstantValue(pRight);
+
+      if (ezExpressionAST::NodeType::IsCommutative(nodeType))
+      {
+        return SimplifyNode(ast, ast.CreateBinaryOperator(nodeType, pRight, pLeft));
+      }
+      else if (nodeType == ezExpressionAST::NodeType::Subtract)
+      {
+        return SimplifyNode(ast, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, CreateConstant(ast, -fRight), pLeft));
+      }
+      else if (nodeType == ezExpressionAST::NodeType::Divide && fRight != 0.0f)
+      {
+        // strength reduction, multiplications are a lot cheaper than divisions
+        return SimplifyNode(ast, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, CreateConstant(ast, 1.0f / fRight), pLeft));
+      }
+    }
+
+    if (IsConstant(pLeft))
+    {
+      // algebraic identities
+      if ((nodeType == ezExpressionAST::NodeType::Add && IsConstantValue(pLeft, 0.0f)) ||
+          (nodeType == ezExpressionAST::NodeType::Multiply && IsConstantValue(pLeft, 1.0f)))
+      {
+        return pRight;
+      }
+
+      // merge constants of chained operations, e.g. 2 * (3 * x) = 6 * x
+      if (ezExpressionAST::NodeType::IsCommutative(nodeType) && pRight->m_Type == nodeType)
+      {
+        auto pRightBinary = static_cast<ezExpressionAST::BinaryOperator*>(pRight);
+        if (IsConstant(pRightBinary->m_pLeftOperand))
+        {
+          const float fMerged = FoldBinary(nodeType, GetConstantValue(pLeft), GetConstantValue(pRightBinary->m_pLeftOperand));
+          return SimplifyNode(ast, ast.CreateBinaryOperator(nodeType, CreateConstant(ast, fMerged), pRightBinary->m_pRightOperand));
+        }
+      }
+    }
+
+    if (pLeft == pRight && (nodeType == ezExpressionAST::NodeType::Min || nodeType == ezExpressionAST::NodeType::Max))
+    {
+      return pLeft;
+    }
+  }
+
+  return DeduplicateNode(pNode);
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::FuseNode(ezExpressionAST& ast, ezExpressionAST::Node* pNode)
+{
+  if (pNode->m_Type != ezExpressionAST::NodeType::Add)
+    return pNode;
+
+  // a * b + c, if the multiplication result is not needed on its own. A constant addend would need a separate mov instruction,
+  // so this would not save anything in that case.
+  auto pAdd = static_cast<ezExpressionAST::BinaryOperator*>(pNode);
+  ezExpressionAST::Node* operands[] = {pAdd->m_pRightOperand, pAdd->m_pLeftOperand};
+
+  for (ezUInt32 i = 0; i < 2; ++i)
+  {
+    ezExpressionAST::Node* pMultiply = operands[i];
+    ezExpressionAST::Node* pAddend = operands[1 - i];
+
+    if (pMultiply->m_Type == ezExpressionAST::NodeType::Multiply && !IsConstant(pAddend) && m_NodeUseCount[pMultiply] == 1)
+    {
+      auto pMultiplyBinary = static_cast<ezExpressionAST::BinaryOperator*>(pMultiply);
+      return ast.CreateMultiplyAdd(pMultiplyBinary->m_pLeftOperand, pMultiplyBinary->m_pRightOperand, pAddend);
+    }
+  }
+
+  return pNode;
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::CreateConstant(ezExpressionAST& ast, float fValue)
+{
+  return DeduplicateNode(ast.CreateConstant(fValue));
+}
+
+ezExpressionAST::Node* ezExpressionCompiler::DeduplicateNode(ezExpressionAST::Node* pNode)
+{
+  ezExpressionAST::Node* pUniqueNode = nullptr;
+  if (m_UniqueNodes.TryGetValue(pNode, pUniqueNode))
+  {
+    return pUniqueNode;
+  }
+
+  m_UniqueNodes.Insert(pNode, pNode);
+  return pNode;
+}
+
+// static
+ezUInt32 ezExpressionCompiler::NodeHashHelper::Hash(const ezExpressionAST::Node* pNode)
+{
+  const ezExpressionAST::NodeType::Enum nodeType = pNode->m_Type;
+  ezUInt32 uiHash = ezHashingUtils::xxHash32(&nodeType, sizeof(nodeType));
+
+  if (ezExpressionAST::NodeType::IsConstant(nodeType))
+  {
+    const float fValue = GetConstantValue(pNode);
+    uiHash = ezHashingUtils::xxHash32(&fValue, sizeof(fValue), uiHash);
+  }
+  else if (ezExpressionAST::NodeType::IsInput(nodeType))
+  {
+    uiHash ^= static_cast<const ezExpressionAST::Input*>(pNode)->m_sName.GetHash();
+  }
+  else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+  {
+    uiHash ^= static_cast<const ezExpressionAST::FunctionCall*>(pNode)->m_sName.GetHash();
+  }
+
+  // the children are unique already, so their addresses identify them
+  auto children = ezExpressionAST::GetChildren(pNode);
+  if (ezExpressionAST::NodeType::IsCommutative(nodeType))
+  {
+    // has to be independent of the operand order
+    uiHash ^= ezHashHelper<const ezExpressionAST::Node*>::Hash(children[0]) + ezHashHelper<const ezExpressionAST::Node*>::Hash(children[1]);
+  }
+  else if (!children.IsEmpty())
+  {
+    uiHash = ezHashingUtils::xxHash32(children.GetPtr(), children.GetCount() * sizeof(const ezExpressionAST::Node*), uiHash);
+  }
+
+  return uiHash;
+}
+
+// static
+bool ezExpressionCompiler::NodeHashHelper::Equal(const ezExpressionAST::Node* a, const ezExpressionAST::Node* b)
+{
+  const ezExpressionAST::NodeType::Enum nodeType = a->m_Type;
+  if (nodeType != b->m_Type)
+    return false;
+
+  if (ezExpressionAST::NodeType::IsConstant(nodeType))
+  {
+    // compare the bits, 0 and -0 are different constants
+    const float fA = GetConstantValue(a);
+    const float fB = GetConstantValue(b);
+    return ezMemoryUtils::IsEqual(&fA, &fB);
+  }
+  else if (ezExpressionAST::NodeType::IsInput(nodeType))
+  {
+    return static_cast<const ezExpressionAST::Input*>(a)->m_sName == static_cast<const ezExpressionAST::Input*>(b)->m_sName;
+  }
+  else if (nodeType == ezExpressionAST::NodeType::FunctionCall)
+  {
+    // expression functions are required to be state-less, so the same arguments always give the same result
+    if (static_cast<const ezExpressionAST::FunctionCall*>(a)->m_sName != static_cast<const ezExpressionAST::FunctionCall*>(b)->m_sName)
+      return false;
+  }
+  else if (!ezExpressionAST::NodeType::IsUnary(nodeType) && !ezExpressionAST::NodeType::IsBinary(nodeType))
+  {
+    return a == b;
+  }
+
+  auto childrenA = ezExpressionAST::GetChildren(a);
+  auto childrenB = ezExpressionAST::GetChildren(b);
+
+  if (ezExpressionAST::NodeType::IsCommutative(nodeType) && childrenA[0] == childrenB[1] && childrenA[1] == childrenB[0])
+    return true;
+
+  return childrenA == childrenB;
+}
+
 ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 {
   m_NodeStack.Clear();
@@ -94,18 +509,21 @@ ezResult ezExpressionCompiler::BuildNodeInstructions(const ezExpressionAST& ast)
 
       m_NodeStack.PushBack(pCurrentNode);
 
-      if (ezExpressionAST::NodeType::IsBinary(pCurrentNode->m_Type))
+      if (ezExpressionAST::NodeType::IsBinary(pCurrentNode->m_Type) || pCurrentNode->m_Type == ezExpressionAST::NodeType::MultiplyAdd)
       {
         // Do not push the left operand if it is a constant, we don't want a separate mov instruction for it
-        // since all binary operators can take a constant as left operand in place.
-        auto pBinary = static_cast<const ezExpressionAST::BinaryOperator*>(pCurrentNode);
-        bool bLeftIsConstant = ezExpressionAST::NodeType::IsConstant(pBinary->m_pLeftOperand->m_Type);
+        // since all binary operators and multiply add can take a constant as left operand in place.
+        auto children = ezExpressionAST::GetChildren(pCurrentNode);
+        bool bLeftIsConstant = ezExpressionAST::NodeType::IsConstant(children[0]->m_Type);
         if (!bLeftIsConstant)
         {
-          m_NodeInstructions.PushBack(pBinary->m_pLeftOperand);
+          m_NodeInstructions.PushBack(children[0]);
         }
 
-        m_NodeInstructions.PushBack(pBinary->m_pRightOperand);
+        for (ezUInt32 i = 1; i < children.GetCount(); ++i)
+        {
+          m_NodeInstructions.PushBack(children[i]);
+        }
       }
       else
       {
@@ -274,6 +692,24 @@ ezResult ezExpressionCompiler::GenerateByteCode(const ezExpressionAST& ast, ezEx
       byteCode.PushBack(bLeftIsConstant ? uiConstantValue : m_NodeToRegisterIndex[pBinary->m_pLeftOperand]);
       byteCode.PushBack(m_NodeToRegisterIndex[pBinary->m_pRightOperand]);
     }
+    else if (nodeType == ezExpressionAST::NodeType::MultiplyAdd)
+    {
+      auto pMultiplyAdd = static_cast<const ezExpressionAST::MultiplyAdd*>(pCurrentNode);
+      bool bLeftIsConstant = ezExpressionAST::NodeType::IsConstant(pMultiplyAdd->m_pLeftOperand->m_Type);
+      ezUInt32 uiConstantValue = 0;
+
+      if (bLeftIsConstant)
+      {
+        auto pConstant = static_cast<const ezExpressionAST::Constant*>(pMultiplyAdd->m_pLeftOperand);
+        uiConstantValue = *reinterpret_cast<const ezUInt32*>(&pConstant->m_Value.Get<float>());
+      }
+
+      byteCode.PushBack(bLeftIsConstant ? ezExpressionByteCode::OpCode::MulAdd_CRR : ezExpressionByteCode::OpCode::MulAdd_RRR);
+      byteCode.PushBack(uiTargetRegister);
+      byteCode.PushBack(bLeftIsConstant ? uiConstantValue : m_NodeToRegisterIndex[pMultiplyAdd->m_pLeftOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pMultiplyAdd->m_pRightOperand]);
+      byteCode.PushBack(m_NodeToRegisterIndex[pMultiplyAdd->m_pAddend]);
+    }
     else if (ezExpressionAST::NodeType::IsConstant(nodeType))
     {
       EZ_ASSERT_DEV(nodeType == ezExpressionAST::NodeType::FloatConstant, "Only floats are supported");
@@ -14,6 +14,14 @@ namespace
 #  define VM_INLINE EZ_ALWAYS_INLINE
 #endif
 
+  // The register count per batch is always a multiple of s_uiRegisterGroupSize, so the loops below can process a group of registers
+  // per iteration. The operations within a group are independent of each other which keeps more of them in flight at once.
+  static constexpr ezUInt32 s_uiRegisterGroupSize = 4;
+
+  // Instances are processed in batches, so the registers of one batch fit into the cache instead of streaming every instruction
+  // through memory for all instances.
+  static constexpr ezUInt32 s_uiMaxNumInstancesPerBatch = 1024;
+
   template <typename Func>
   VM_INLINE void VMOperation1(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
     Func func)
@@ -25,9 +33,13 @@ namespace
 
     while (r != re)
     {
-      *r = func(*x);
-      ++r;
-      ++x;
+      r[0] = func(x[0]);
+      r[1] = func(x[1]);
+      r[2] = func(x[2]);
+      r[3] = func(x[3]);
+
+      r += s_uiRegisterGroupSize;
+      x += s_uiRegisterGroupSize;
     }
   }
 
@@ -38,12 +50,16 @@ namespace
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
-    ezSimdVec4f x = ezExpressionByteCode::GetConstant(pByteCode);
+    const ezSimdVec4f x = func(ezExpressionByteCode::GetConstant(pByteCode));
 
     while (r != re)
     {
-      *r = func(x);
-      ++r;
+      r[0] = x;
+      r[1] = x;
+      r[2] = x;
+      r[3] = x;
+
+      r += s_uiRegisterGroupSize;
     }
   }
 
@@ -59,10 +75,14 @@ namespace
 
     while (r != re)
     {
-      *r = func(*a, *b);
-      ++r;
-      ++a;
-      ++b;
+      r[0] = func(a[0], b[0]);
+      r[1] = func(a[1], b[1]);
+      r[2] = func(a[2], b[2]);
+      r[3] = func(a[3], b[3]);
+
+      r += s_uiRegisterGroupSize;
+      a += s_uiRegisterGroupSize;
+      b += s_uiRegisterGroupSize;
     }
   }
 
@@ -73,21 +93,74 @@ namespace
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
 
-    ezSimdVec4f a = ezExpressionByteCode::GetConstant(pByteCode);
+    const ezSimdVec4f a = ezExpressionByteCode::GetConstant(pByteCode);
     ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
 
     while (r != re)
     {
-      *r = func(a, *b);
-      ++r;
-      ++b;
+      r[0] = func(a, b[0]);
+      r[1] = func(a, b[1]);
+      r[2] = func(a, b[2]);
+      r[3] = func(a, b[3]);
+
+      r += s_uiRegisterGroupSize;
+      b += s_uiRegisterGroupSize;
+    }
+  }
+
+  template <typename Func>
+  VM_INLINE void VMOperation3(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    Func func)
+  {
+    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* re = r + uiNumRegisters;
+
+    ezSimdVec4f* a = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* c = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+    while (r != re)
+    {
+      r[0] = func(a[0], b[0], c[0]);
+      r[1] = func(a[1], b[1], c[1]);
+      r[2] = func(a[2], b[2], c[2]);
+      r[3] = func(a[3], b[3], c[3]);
+
+      r += s_uiRegisterGroupSize;
+      a += s_uiRegisterGroupSize;
+      b += s_uiRegisterGroupSize;
+      c += s_uiRegisterGroupSize;
+    }
+  }
+
+  template <typename Func>
+  VM_INLINE void VMOperation3_C(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
+    Func func)
+  {
+    ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* re = r + uiNumRegisters;
+
+    const ezSimdVec4f a = ezExpressionByteCode::GetConstant(pByteCode);
+    ezSimdVec4f* b = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+    ezSimdVec4f* c = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
+
+    while (r != re)
+    {
+      r[0] = func(a, b[0], c[0]);
+      r[1] = func(a, b[1], c[1]);
+      r[2] = func(a, b[2], c[2]);
+      r[3] = func(a, b[3], c[3]);
+
+      r += s_uiRegisterGroupSize;
+      b += s_uiRegisterGroupSize;
+      c += s_uiRegisterGroupSize;
     }
   }
 
   VM_INLINE float ReadInputData(const ezUInt8* pData) { return *reinterpret_cast<const float*>(pData); }
 
   void VMLoadInput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezUInt32> inputMapping)
+    ezArrayPtr<const ezExpression::Stream> inputs, ezArrayPtr<ezUInt32> inputMapping, ezUInt32 uiFirstInstance)
   {
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
@@ -96,8 +169,8 @@ namespace
     uiInputIndex = inputMapping[uiInputIndex];
     auto& input = inputs[uiInputIndex];
     ezUInt32 uiByteStride = input.m_uiByteStride;
-    const ezUInt8* pInputData = input.m_Data.GetPtr();
-    const ezUInt8* pInputDataEnd = pInputData + input.m_Data.GetCount() - uiByteStride;
+    const ezUInt8* pInputDataEnd = input.m_Data.GetPtr() + input.m_Data.GetCount() - uiByteStride;
+    const ezUInt8* pInputData = input.m_Data.GetPtr() + uiFirstInstance * uiByteStride;
 
     while (r != re)
     {
@@ -118,14 +191,14 @@ namespace
   VM_INLINE void StoreOutputData(ezUInt8* pData, float fData) { *reinterpret_cast<float*>(pData) = fData; }
 
   void VMStoreOutput(const ezExpressionByteCode::StorageType*& pByteCode, ezSimdVec4f* pRegisters, ezUInt32 uiNumRegisters,
-    ezArrayPtr<ezExpression::Stream> outputs, ezArrayPtr<ezUInt32> outputMapping)
+    ezArrayPtr<ezExpression::Stream> outputs, ezArrayPtr<ezUInt32> outputMapping, ezUInt32 uiFirstInstance)
   {
     ezUInt32 uiOutputIndex = ezExpressionByteCode::GetRegisterIndex(pByteCode, 1);
     uiOutputIndex = outputMapping[uiOutputIndex];
     auto& output = outputs[uiOutputIndex];
     ezUInt32 uiByteStride = output.m_uiByteStride;
-    ezUInt8* pOutputData = output.m_Data.GetPtr();
-    ezUInt8* pOutputDataEnd = pOutputData + output.m_Data.GetCount() - uiByteStride;
+    ezUInt8* pOutputDataEnd = output.m_Data.GetPtr() + output.m_Data.GetCount() - uiByteStride;
+    ezUInt8* pOutputData = output.m_Data.GetPtr() + uiFirstInstance * uiByteStride;
 
     ezSimdVec4f* r = pRegisters + ezExpressionByteCode::GetRegisterIndex(pByteCode, uiNumRegisters);
     ezSimdVec4f* re = r + uiNumRegisters;
@@ -344,12 +417,25 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
     }
   }
 
-  const ezUInt32 uiNumRegisters = (uiNumInstances + 3) / 4;
-  const ezUInt32 uiLastInstanceIndex = uiNumInstances - 1;
+  const ezUInt32 uiMaxNumRegisters = ezMemoryUtils::AlignSize(ezMath::Min(uiNumInstances, s_uiMaxNumInstancesPerBatch), 4 * s_uiRegisterGroupSize) / 4;
 
-  const ezUInt32 uiTotalNumRegisters = byteCode.GetNumTempRegisters() * uiNumRegisters;
+  const ezUInt32 uiTotalNumRegisters = byteCode.GetNumTempRegisters() * uiMaxNumRegisters;
   m_Registers.SetCountUninitialized(uiTotalNumRegisters);
 
+  for (ezUInt32 uiFirstInstance = 0; uiFirstInstance < uiNumInstances; uiFirstInstance += s_uiMaxNumInstancesPerBatch)
+  {
+    const ezUInt32 uiNumBatchInstances = ezMath::Min(uiNumInstances - uiFirstInstance, s_uiMaxNumInstancesPerBatch);
+    const ezUInt32 uiNumRegisters = ezMemoryUtils::AlignSize(uiNumBatchInstances, 4 * s_uiRegisterGroupSize) / 4;
+
+    EZ_SUCCEED_OR_RETURN(ExecuteBatch(byteCode, inputs, outputs, uiFirstInstance, uiNumRegisters, globalData));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezExpressionVM::ExecuteBatch(const ezExpressionByteCode& byteCode, ezArrayPtr<const ezExpression::Stream> inputs,
+  ezArrayPtr<ezExpression::Stream> outputs, ezUInt32 uiFirstInstance, ezUInt32 uiNumRegisters, const ezExpression::GlobalData& globalData)
+{
   ezSimdVec4f* pRegisters = m_Registers.GetData();
 
   // Execute bytecode
@@ -404,11 +490,11 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
         break;
 
       case ezExpressionByteCode::OpCode::Mov_I:
-        VMLoadInput(pByteCode, pRegisters, uiNumRegisters, inputs, m_InputMapping);
+        VMLoadInput(pByteCode, pRegisters, uiNumRegisters, inputs, m_InputMapping, uiFirstInstance);
         break;
 
       case ezExpressionByteCode::OpCode::Mov_O:
-        VMStoreOutput(pByteCode, pRegisters, uiNumRegisters, outputs, m_OutputMapping);
+        VMStoreOutput(pByteCode, pRegisters, uiNumRegisters, outputs, m_OutputMapping, uiFirstInstance);
         break;
 
         // binary
@@ -460,6 +546,17 @@ ezResult ezExpressionVM::Execute(const ezExpressionByteCode& byteCode, ezArrayPt
         VMOperation2_C(pByteCode, pRegisters, uiNumRegisters, [](const ezSimdVec4f& a, const ezSimdVec4f& b) { return a.CompMax(b); });
         break;
 
+        // ternary
+      case ezExpressionByteCode::OpCode::MulAdd_RRR:
+        VMOperation3(pByteCode, pRegisters, uiNumRegisters,
+          [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) { return ezSimdVec4f::MulAdd(a, b, c); });
+        break;
+
+      case ezExpressionByteCode::OpCode::MulAdd_CRR:
+        VMOperation3_C(pByteCode, pRegisters, uiNumRegisters,
+          [](const ezSimdVec4f& a, const ezSimdVec4f& b, const ezSimdVec4f& c) { return ezSimdVec4f::MulAdd(a, b, c); });
+        break;
+
         // call
       case ezExpressionByteCode::OpCode::Call:
       {
@@ -1,6 +1,8 @@
 #include <CoreTestPCH.h>
 
 #include <Core/ResourceManager/ResourceManager.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(ResourceManager);
@@ -28,6 +30,9 @@ namespace
       ld.m_uiQualityLevelsDiscardable = 0;
       ld.m_uiQualityLevelsLoadable = 0;
 
+      m_Data.Clear();
+      m_Data.Compact();
+
       return ld;
     }
 
@@ -69,7 +74,7 @@ namespace
 
     virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override
     {
-      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(TestResource);
+      out_NewMemoryUsage.m_uiMemoryCPU = sizeof(TestResource) + static_cast<ezUInt32>(m_Data.GetHeapMemoryUsage());
       out_NewMemoryUsage.m_uiMemoryGPU = 0;
     }
 
@@ -79,6 +84,8 @@ namespace
       EZ_TEST_BOOL(!m_Data.IsEmpty());
     }
 
+    ezUInt32 GetNumElements() const { return m_Data.GetCount(); }
+
   private:
     TestResourceHandle m_Nested;
     ezDynamicArray<ezUInt32> m_Data;
@@ -87,6 +94,17 @@ namespace
   class TestResourceTypeLoader : public ezResourceTypeLoader
   {
   public:
+    /// How many elements every loaded TestResource contains. The streaming tests use many small resources.
+    ezUInt32 m_uiNumElements = 1024 * 10;
+
+    /// If set, OpenDataStream() only allocates the data and DecodeData() generates it.
+    bool m_bUseDecodeStage = false;
+    ezAtomicInteger32 m_iNumDecodedOnFileAccessThread;
+
+    /// While set, OpenDataStream() waits, as if the storage was very slow.
+    ezAtomicBool m_bBlockReads;
+    ezAtomicInteger32 m_iNumBlockedReads;
+
     struct LoadedData
     {
       ezMemoryStreamStorage m_StreamData;
@@ -95,29 +113,62 @@ namespace
 
     virtual ezResourceLoadData OpenDataStream(const ezResource* pResource) override
     {
+      if (m_bBlockReads)
+      {
+        m_iNumBlockedReads.Increment();
+
+        while (m_bBlockReads)
+        {
+          ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+        }
+
+        m_iNumBlockedReads.Decrement();
+      }
+
       LoadedData* pData = EZ_DEFAULT_NEW(LoadedData);
 
-      const ezUInt32 uiNumElements = 1024 * 10;
+      const ezUInt32 uiNumElements = m_uiNumElements;
       pData->m_StreamData.Reserve(uiNumElements * sizeof(ezUInt32) + 1);
 
-      ezMemoryStreamWriter writer(&pData->m_StreamData);
       pData->m_Reader.SetStorage(&pData->m_StreamData);
 
-      writer << uiNumElements;
-
-      for (ezUInt32 i = 0; i < uiNumElements; ++i)
-      {
-        writer << i;
-      }
-
       ezResourceLoadData ld;
       ld.m_pCustomLoaderData = pData;
       ld.m_pDataStream = &pData->m_Reader;
       ld.m_sResourceDescription = pResource->GetResourceID();
+      ld.m_bNeedsDecoding = m_bUseDecodeStage;
+
+      if (!m_bUseDecodeStage)
+      {
+        WriteData(*pData);
+      }
 
       return ld;
     }
 
+    virtual void DecodeData(const ezResource* pResource, ezResourceLoadData& inout_LoaderData) override
+    {
+      if (ezTaskSystem::GetCurrentThreadWorkerType() == ezWorkerThreadType::FileAccess)
+      {
+        m_iNumDecodedOnFileAccessThread.Increment();
+      }
+
+      WriteData(*static_cast<LoadedData*>(inout_LoaderData.m_pCustomLoaderData));
+    }
+
+    void WriteData(LoadedData& data) const
+    {
+      const ezUInt32 uiNumElements = m_uiNumElements;
+      ezMemoryStreamWriter writer(&data.m_StreamData);
+
+      writer << uiNumElements;
+
+      for (ezUInt32 i = 0; i < uiNumElements; ++i)
+      {
+        writer << i;
+      }
+    }
+
     virtual void CloseDataStream(const ezResource* pResource, const ezResourceLoadData& LoaderData) override
     {
       LoadedData* pData = static_cast<LoadedData*>(LoaderData.m_pCustomLoaderData);
@@ -193,6 +244,107 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, Basics)
   }
 }
 
+EZ_CREATE_SIMPLE_TEST(ResourceManager, DecodeData)
+{
+  TestResourceTypeLoader TypeLoader;
+  TypeLoader.m_bUseDecodeStage = true;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Decode On Worker Thread")
+  {
+    const ezUInt32 uiNumResources = 50;
+
+    const ezResourceManager::LoadingStats statsBefore = ezResourceManager::GetLoadingStats();
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Decode-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+      EZ_TEST_INT(pTestResource->GetNumElements(), TypeLoader.m_uiNumElements);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    const ezResourceManager::LoadingStats stats = ezResourceManager::GetLoadingStats();
+    EZ_TEST_BOOL(stats.m_uiNumResourcesDecoded - statsBefore.m_uiNumResourcesDecoded >= uiNumResources);
+    EZ_TEST_INT(TypeLoader.m_iNumDecodedOnFileAccessThread, 0);
+
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, DataLoadsInFlight)
+{
+  TestResourceTypeLoader TypeLoader;
+  TypeLoader.m_uiNumElements = 16;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Independent Of File Access Threads")
+  {
+    const ezUInt32 uiMaxDataLoads = ezResourceManager::GetMaxConcurrentDataLoads();
+    EZ_TEST_INT(uiMaxDataLoads, 16);
+
+    const ezUInt32 uiNumResources = uiMaxDataLoads * 2;
+
+    TypeLoader.m_bBlockReads = true;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("InFlight-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+      ezResourceManager::PreloadResource(hResources.PeekBack());
+    }
+
+    // the worker threads are started with the first task
+    const ezUInt32 uiNumFileAccessThreads = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::FileAccess);
+
+    // more data loads are in flight than there are threads to read, the others wait in the task queue without a thread
+    const ezResourceManager::LoadingStats stats = ezResourceManager::GetLoadingStats();
+    EZ_TEST_INT(stats.m_uiNumDataLoadsInFlight, uiMaxDataLoads);
+    EZ_TEST_BOOL(stats.m_uiNumDataLoadsInFlight > uiNumFileAccessThreads);
+    EZ_TEST_BOOL(static_cast<ezUInt32>(TypeLoader.m_iNumBlockedReads) <= uiNumFileAccessThreads);
+
+    TypeLoader.m_bBlockReads = false;
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    EZ_TEST_INT(ezResourceManager::GetLoadingStats().m_uiNumDataLoadsInFlight, 0);
+
+    hResources.Clear();
+    ezResourceManager::FreeAllUnusedResources();
+  }
+}
+
 EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
 {
   TestResourceTypeLoader TypeLoader;
@@ -289,3 +441,196 @@ EZ_CREATE_SIMPLE_TEST(ResourceManager, NestedLoading)
     EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, MemoryBudget)
+{
+  TestResourceTypeLoader TypeLoader;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "EnforceMemoryBudgets")
+  {
+    const ezUInt32 uiNumResources = 50;
+    const ezUInt32 uiNumRecentlyUsed = 5;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezUInt64 uiResourceSize = 0;
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Budget-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[0], ezResourceAcquireMode::PointerOnly);
+      uiResourceSize = pTestResource->GetMemoryUsage().m_uiMemoryCPU;
+    }
+
+    // the last few resources are used more recently than all others and should be kept
+    ezThreadUtils::Sleep(ezTime::Milliseconds(10));
+    ezResourceManager::PerFrameUpdate();
+
+    for (ezUInt32 i = uiNumResources - uiNumRecentlyUsed; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::BlockTillLoaded);
+    }
+
+    const ezResourceManager::ResidencyStats statsBefore = ezResourceManager::GetResidencyStats();
+
+    // the memory usage is summed up while the resources are loaded, not only once a budget is set
+    EZ_TEST_BOOL(statsBefore.m_uiMemoryCPU >= uiResourceSize * uiNumResources);
+    EZ_TEST_BOOL(statsBefore.m_uiNumResidentResources >= uiNumResources);
+
+    ezResourceManager::SetMemoryBudget(0, 0, ezTime::Zero());
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(uiResourceSize * (uiNumRecentlyUsed * 2), 0);
+    EZ_SCOPE_EXIT(ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(0, 0); ezResourceManager::SetMemoryBudget(0, 0));
+
+    const ezUInt32 uiNumEvicted = ezResourceManager::EnforceMemoryBudgets();
+    EZ_TEST_BOOL(uiNumEvicted >= uiNumResources - uiNumRecentlyUsed * 2);
+
+    const ezResourceManager::ResidencyStats stats = ezResourceManager::GetResidencyStats();
+    EZ_TEST_INT(stats.m_uiNumEvictions - statsBefore.m_uiNumEvictions, uiNumEvicted);
+    EZ_TEST_BOOL(stats.m_uiNumEvictedBytes > statsBefore.m_uiNumEvictedBytes);
+
+    ezUInt32 uiNumLoaded = 0;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[i], ezResourceAcquireMode::PointerOnly);
+
+      if (pTestResource->GetLoadingState() == ezResourceState::Loaded)
+        ++uiNumLoaded;
+
+      if (i >= uiNumResources - uiNumRecentlyUsed)
+      {
+        EZ_TEST_BOOL(pTestResource->GetLoadingState() == ezResourceState::Loaded);
+      }
+    }
+
+    EZ_TEST_BOOL(uiNumLoaded <= uiNumRecentlyUsed * 2);
+
+    // nothing left to do once the budget is met
+    EZ_TEST_INT(ezResourceManager::EnforceMemoryBudgets(), 0);
+
+    // evicted resources are loaded again on demand, which shows up as churn
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[0], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+      pTestResource->Test();
+    }
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    EZ_TEST_INT(ezResourceManager::GetResidencyStats().m_uiNumReloadsAfterEviction - stats.m_uiNumReloadsAfterEviction, 1);
+
+    // unreferenced resources are deallocated
+    hResources.Clear();
+    ezResourceManager::SetMemoryBudgetForResourceType<TestResource>(1, 0);
+    ezResourceManager::EnforceMemoryBudgets();
+
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ResourceManager, Profile_Streaming)
+{
+  TestResourceTypeLoader TypeLoader;
+  TypeLoader.m_uiNumElements = 16;
+  ezResourceManager::SetResourceTypeLoader<TestResource>(&TypeLoader);
+  EZ_SCOPE_EXIT(ezResourceManager::SetResourceTypeLoader<TestResource>(nullptr));
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Time To First Needed Resource")
+  {
+    // similar to a level transition, which requests all of its content at once
+    const ezUInt32 uiNumResources = 20000;
+
+    ezDynamicArray<TestResourceHandle> hResources;
+    hResources.Reserve(uiNumResources);
+
+    ezStringBuilder sResourceID;
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      sResourceID.Format("Streaming-{}", i);
+      hResources.PushBack(ezResourceManager::LoadResource<TestResource>(sResourceID));
+
+      ezResourceLock<TestResource> pTestResource(hResources.PeekBack(), ezResourceAcquireMode::PointerOnly);
+      pTestResource->SetPriority(ezResourcePriority::VeryLow);
+    }
+
+    const ezResourceManager::LoadingStats statsBefore = ezResourceManager::GetLoadingStats();
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumResources; ++i)
+    {
+      ezResourceManager::PreloadResource(hResources[i]);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Queueing %u resources: %.2fms", uiNumResources, sw.Checkpoint().GetMilliseconds());
+
+    // a resource that is suddenly needed, e.g. because it came into view, must not wait for the whole queue
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[uiNumResources - 1], ezResourceAcquireMode::PointerOnly);
+      pTestResource->SetPriority(ezResourcePriority::VeryHigh);
+
+      while (pTestResource->GetLoadingState() != ezResourceState::Loaded)
+      {
+        ezThreadUtils::YieldTimeSlice();
+      }
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Time until re-prioritized resource is loaded: %.2fms", sw.Checkpoint().GetMilliseconds());
+
+    {
+      ezResourceLock<TestResource> pTestResource(hResources[uiNumResources / 2], ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pTestResource.GetAcquireResult() == ezResourceAcquireResult::Final);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Time until blocking acquired resource is loaded: %.2fms", sw.Checkpoint().GetMilliseconds());
+
+    while (ezResourceManager::IsAnyLoadingInProgress())
+    {
+      ezThreadUtils::YieldTimeSlice();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Loading remaining resources: %.2fms", sw.Checkpoint().GetMilliseconds());
+
+    {
+      const ezResourceManager::LoadingStats stats = ezResourceManager::GetLoadingStats();
+      EZ_TEST_INT(stats.m_uiNumQueued, 0);
+      EZ_TEST_INT(stats.m_uiNumDataLoadsInFlight, 0);
+      EZ_TEST_BOOL(stats.m_uiNumResourcesRead - statsBefore.m_uiNumResourcesRead >= uiNumResources);
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Read time (all threads): %.2fms, update content time (all threads): %.2fms",
+        (stats.m_ReadTime - statsBefore.m_ReadTime).GetMilliseconds(), (stats.m_UpdateContentTime - statsBefore.m_UpdateContentTime).GetMilliseconds());
+    }
+
+    hResources.Clear();
+
+    for (ezUInt32 tries = 0; tries < 3; ++tries)
+    {
+      ezResourceManager::FreeAllUnusedResources();
+
+      if (ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount() == 0)
+        break;
+
+      ezThreadUtils::Sleep(ezTime::Milliseconds(100));
+    }
+
+    EZ_TEST_INT(ezResourceManager::GetAllResourcesOfType<TestResource>()->GetCount(), 0);
+  }
+}
@@ -0,0 +1,207 @@
+#include <CoreTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Core/Messages/UpdateLocalBoundsMessage.h>
+#include <Core/World/OcclusionBuffer.h>
+#include <Core/World/World.h>
+#include <Foundation/Containers/HashSet.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+
+namespace
+{
+  typedef ezComponentManager<class OccludeeTestComponent, ezBlockStorageType::Compact> OccludeeTestComponentManager;
+
+  class OccludeeTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(OccludeeTestComponent, ezComponent, OccludeeTestComponentManager);
+
+  public:
+    virtual void Initialize() override { GetOwner()->UpdateLocalBounds(); }
+
+    void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg)
+    {
+      ezBoundingBox bounds;
+      bounds.SetCenterAndHalfExtents(ezVec3::ZeroVector(), ezVec3(1.0f));
+
+      msg.AddBounds(bounds, ezDefaultSpatialDataCategories::RenderStatic);
+    }
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(OccludeeTestComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgUpdateLocalBounds, OnUpdateLocalBounds)
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  static ezSimdBBox MakeBox(const ezVec3& vCenter, float fHalfExtent)
+  {
+    ezSimdBBox box;
+    box.SetCenterAndHalfExtents(ezSimdConversion::ToVec3(vCenter), ezSimdVec4f(fHalfExtent));
+    return box;
+  }
+
+  // a camera at the origin looking along +x with a 90 degree horizontal field of view and an aspect ratio of 2
+  static ezMat4 GetTestViewProjection()
+  {
+    ezCamera camera;
+    camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 1000.0f);
+    camera.LookAt(ezVec3::ZeroVector(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+
+    ezMat4 projection;
+    camera.GetProjectionMatrix(2.0f, projection);
+
+    return projection * camera.GetViewMatrix();
+  }
+
+  // at a distance of 10 the wall covers the middle half of the screen horizontally and everything vertically
+  static const ezBoundingBox s_WallBox(ezVec3(-0.5f, -5.0f, -20.0f), ezVec3(0.5f, 5.0f, 20.0f));
+  static const ezVec3 s_vWallPosition(10.0f, 0.0f, 0.0f);
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, OcclusionBuffer)
+{
+  const ezMat4 viewProjection = GetTestViewProjection();
+  const ezSimdTransform wallTransform(ezSimdConversion::ToVec3(s_vWallPosition));
+
+  ezOcclusionBuffer buffer(256, 128);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty")
+  {
+    buffer.Clear(viewProjection);
+
+    EZ_TEST_BOOL(!buffer.HasOccluders());
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(50, 0, 0), 1.0f)));
+    EZ_TEST_FLOAT(buffer.GetDepth(128, 64), ezMath::MaxValue<float>(), 0.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RasterizeOccluder Box")
+  {
+    buffer.Clear(viewProjection);
+    buffer.RasterizeOccluder(s_WallBox, wallTransform);
+
+    EZ_TEST_BOOL(buffer.HasOccluders());
+    EZ_TEST_BOOL(buffer.GetNumRasterizedTriangles() > 0);
+
+    // covered center, uncovered left and right border
+    EZ_TEST_BOOL(buffer.GetDepth(128, 64) < ezMath::MaxValue<float>());
+    EZ_TEST_FLOAT(buffer.GetDepth(0, 64), ezMath::MaxValue<float>(), 0.0f);
+    EZ_TEST_FLOAT(buffer.GetDepth(255, 64), ezMath::MaxValue<float>(), 0.0f);
+
+    // directly behind the wall
+    EZ_TEST_BOOL(!buffer.IsVisible(MakeBox(ezVec3(50, 0, 0), 1.0f)));
+    EZ_TEST_BOOL(!buffer.IsVisible(MakeBox(ezVec3(500, 0, 100), 10.0f)));
+
+    // in front of the wall
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(5, 0, 0), 1.0f)));
+
+    // next to the wall or peeking out behind it
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(50, 40, 0), 1.0f)));
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(50, -24, 0), 2.0f)));
+
+    // intersecting the wall
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(10, 0, 0), 1.0f)));
+
+    // crossing the near plane or behind the camera
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(0, 0, 0), 1.0f)));
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(-50, 0, 0), 1.0f)));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "RasterizeOccluder Triangles")
+  {
+    // only the front face of the wall
+    const ezVec3 triangles[] = {
+      ezVec3(-0.5f, -5.0f, -20.0f),
+      ezVec3(-0.5f, 5.0f, -20.0f),
+      ezVec3(-0.5f, 5.0f, 20.0f),
+      ezVec3(-0.5f, -5.0f, -20.0f),
+      ezVec3(-0.5f, -5.0f, 20.0f),
+      ezVec3(-0.5f, 5.0f, 20.0f),
+    };
+
+    buffer.Clear(viewProjection);
+    buffer.RasterizeOccluder(ezMakeArrayPtr(triangles), wallTransform);
+
+    EZ_TEST_INT(buffer.GetNumRasterizedTriangles(), 2);
+    EZ_TEST_BOOL(!buffer.IsVisible(MakeBox(ezVec3(50, 0, 0), 1.0f)));
+    EZ_TEST_BOOL(buffer.IsVisible(MakeBox(ezVec3(50, 40, 0), 1.0f)));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezFrustum frustum;
+    frustum.SetFrustum(viewProjection);
+
+    buffer.Clear(viewProjection);
+    buffer.RasterizeOccluder(s_WallBox, wallTransform);
+
+    for (ezUInt32 uiType = 0; uiType < 2; ++uiType)
+    {
+      ezWorldDesc worldDesc("Test");
+      worldDesc.m_SpatialSystemType = uiType == 0 ? ezSpatialSystemType::RegularGrid : ezSpatialSystemType::LooseOctree;
+
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      // rows of small objects behind the wall, some of them hidden by it
+      for (ezInt32 x = 0; x < 10; ++x)
+      {
+        for (ezInt32 y = -10; y <= 10; ++y)
+        {
+          ezGameObjectDesc desc;
+          desc.m_LocalPosition = ezVec3(40.0f + x * 10.0f, y * 8.0f, 0.0f);
+
+          ezGameObject* pObject = nullptr;
+          world.CreateObject(desc, pObject);
+
+          OccludeeTestComponent* pComponent = nullptr;
+          OccludeeTestComponent::CreateComponent(pObject, pComponent);
+        }
+      }
+
+      world.Update();
+
+      const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+      ezSpatialSystem::QueryStats stats;
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects, &stats);
+
+      EZ_TEST_INT(stats.m_uiNumObjectsOccluded, 0);
+
+      ezDynamicArray<const ezGameObject*> unoccludedObjects;
+      ezSpatialSystem::QueryStats occlusionStats;
+      world.GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, unoccludedObjects, &occlusionStats, &buffer);
+
+      ezHashSet<const ezGameObject*> unoccludedSet;
+      for (auto pObject : unoccludedObjects)
+      {
+        EZ_TEST_BOOL(buffer.IsVisible(pObject->GetGlobalBoundsSimd().GetBox()));
+        unoccludedSet.Insert(pObject);
+      }
+
+      ezUInt32 uiNumOccluded = 0;
+      for (auto pObject : visibleObjects)
+      {
+        if (!unoccludedSet.Contains(pObject))
+        {
+          EZ_TEST_BOOL(!buffer.IsVisible(pObject->GetGlobalBoundsSimd().GetBox()));
+          ++uiNumOccluded;
+        }
+      }
+
+      EZ_TEST_BOOL(uiNumOccluded > 0);
+      EZ_TEST_INT(unoccludedObjects.GetCount() + uiNumOccluded, visibleObjects.GetCount());
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+      EZ_TEST_INT(occlusionStats.m_uiNumObjectsOccluded, uiNumOccluded);
+      EZ_TEST_INT(occlusionStats.m_uiNumObjectsPassed, stats.m_uiNumObjectsPassed - uiNumOccluded);
+#endif
+    }
+  }
+}
@@ -7,6 +7,7 @@
 #include <Foundation/IO/FileSystem/FileSystem.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 
 namespace
 {
@@ -57,10 +58,11 @@ namespace
   // clang-format on
 } // namespace
 
-EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+static void TestSpatialSystem(ezSpatialSystemType::Enum spatialSystemType)
 {
   ezWorldDesc worldDesc("Test");
   worldDesc.m_uiRandomNumberGeneratorSeed = 5;
+  worldDesc.m_SpatialSystemType = spatialSystemType;
 
   ezWorld world(worldDesc);
   EZ_LOCK(world.GetWriteMarker());
@@ -207,6 +209,193 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects")
+  {
+    ezFrustum testFrustum;
+    testFrustum.SetFrustum(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(1.0f, 0.2f, 0.1f).GetNormalized(), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f),
+      ezAngle::Degree(70.0f), 1.0f, 8000.0f);
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezHashSet<const ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindVisibleObjects(testFrustum, uiCategoryBitmask, visibleObjects);
+
+    for (auto pObject : visibleObjects)
+    {
+      const ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+      EZ_TEST_BOOL(testFrustum.Overlaps(ezSimdBSphere(ezSimdConversion::ToVec3(objSphere.m_vCenter), objSphere.m_fRadius)));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsStatic());
+    }
+
+    // Check for missing objects
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      const ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+      if (testFrustum.Overlaps(ezSimdBSphere(ezSimdConversion::ToVec3(objSphere.m_vCenter), objSphere.m_fRadius)))
+      {
+        EZ_TEST_BOOL(it->IsDynamic() || uniqueObjects.Contains(it));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindVisibleObjects Batched")
+  {
+    ezFrustum testFrusta[3];
+    testFrusta[0].SetFrustum(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(1.0f, 0.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f),
+      ezAngle::Degree(90.0f), 0.1f, 5000.0f);
+    testFrusta[1].SetFrustum(ezVec3(100.0f, 60.0f, 400.0f), ezVec3(-1.0f, 0.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(90.0f),
+      ezAngle::Degree(90.0f), 0.1f, 5000.0f);
+    testFrusta[2].SetFrustum(ezVec3(-5000.0f, 2000.0f, 0.0f), ezVec3(0.0f, 1.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree(60.0f),
+      ezAngle::Degree(40.0f), 1.0f, 9000.0f);
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    ezDynamicArray<ezUInt32> visibilityMasks;
+    world.GetSpatialSystem()->FindVisibleObjects(ezMakeArrayPtr(testFrusta), uiCategoryBitmask, visibleObjects, visibilityMasks);
+
+    EZ_TEST_INT(visibleObjects.GetCount(), visibilityMasks.GetCount());
+
+    // the batched query must return the same objects per frustum as the individual queries
+    for (ezUInt32 uiFrustum = 0; uiFrustum < EZ_ARRAY_SIZE(testFrusta); ++uiFrustum)
+    {
+      ezDynamicArray<const ezGameObject*> singleObjects;
+      world.GetSpatialSystem()->FindVisibleObjects(testFrusta[uiFrustum], uiCategoryBitmask, singleObjects);
+
+      ezHashSet<const ezGameObject*> singleSet;
+      for (auto pObject : singleObjects)
+      {
+        singleSet.Insert(pObject);
+      }
+
+      ezHashSet<const ezGameObject*> batchedSet;
+      for (ezUInt32 i = 0; i < visibleObjects.GetCount(); ++i)
+      {
+        EZ_TEST_BOOL(visibilityMasks[i] != 0);
+
+        if ((visibilityMasks[i] & EZ_BIT(uiFrustum)) != 0)
+        {
+          EZ_TEST_BOOL(!batchedSet.Insert(visibleObjects[i]));
+          EZ_TEST_BOOL(singleSet.Contains(visibleObjects[i]));
+        }
+      }
+
+      EZ_TEST_INT(batchedSet.GetCount(), singleSet.GetCount());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Far Away Objects")
+  {
+    // far outside of the usual world bounds, the loose octree keeps these in a separate overflow node
+    ezGameObjectDesc desc;
+    desc.m_LocalPosition = ezVec3(200000.0f, 0.0f, 0.0f);
+
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    TestBoundsComponent* pComponent = nullptr;
+    TestBoundsComponent::CreateComponent(pObject, pComponent);
+
+    world.Update();
+
+    ezDynamicArray<ezGameObject*> objectsInSphere;
+    world.GetSpatialSystem()->FindObjectsInSphere(ezBoundingSphere(desc.m_LocalPosition, 10.0f), uiCategoryBitmask, objectsInSphere);
+
+    EZ_TEST_INT(objectsInSphere.GetCount(), 1);
+    EZ_TEST_BOOL(objectsInSphere.GetCount() == 1 && objectsInSphere[0] == pObject);
+
+    objects.PushBack(pObject);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Moving Dynamic Objects")
+  {
+    // moves the dynamic objects around, the spatial data is then updated in parallel during the next world update
+    for (ezUInt32 i = 500; i < 1000; ++i)
+    {
+      float x = (float)rng.DoubleMinMax(-range, range);
+      float y = (float)rng.DoubleMinMax(-range, range);
+      float z = (float)rng.DoubleMinMax(-range, range);
+
+      objects[i]->SetLocalPosition(ezVec3(x, y, z));
+    }
+
+    world.Update();
+
+    const ezUInt32 uiDynamicCategoryBitmask = ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+    ezBoundingSphere testSphere(ezVec3(100.0f, 60.0f, 400.0f), 5000.0f);
+
+    ezDynamicArray<ezGameObject*> objectsInSphere;
+    ezHashSet<ezGameObject*> uniqueObjects;
+    world.GetSpatialSystem()->FindObjectsInSphere(testSphere, uiDynamicCategoryBitmask, objectsInSphere);
+
+    for (auto pObject : objectsInSphere)
+    {
+      ezBoundingSphere objSphere = pObject->GetGlobalBounds().GetSphere();
+
+      EZ_TEST_BOOL(testSphere.Overlaps(objSphere));
+      EZ_TEST_BOOL(!uniqueObjects.Insert(pObject));
+      EZ_TEST_BOOL(pObject->IsDynamic());
+    }
+
+    // Check for missing objects
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      ezBoundingSphere objSphere = it->GetGlobalBounds().GetSphere();
+      if (testSphere.Overlaps(objSphere))
+      {
+        EZ_TEST_BOOL(it->IsStatic() || uniqueObjects.Contains(it));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Dynamic Hierarchy Transforms")
+  {
+    // the world updates four objects of a hierarchy level at once, compare that against the regular transform and bounds math
+    ezDynamicArray<ezGameObject*> hierarchy;
+    ezGameObjectHandle hParent[3];
+
+    for (ezUInt32 i = 0; i < 61; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+      desc.m_hParent = hParent[i % 3];
+      desc.m_LocalPosition = ezVec3((float)rng.DoubleMinMax(-100.0, 100.0), (float)rng.DoubleMinMax(-100.0, 100.0), (float)rng.DoubleMinMax(-100.0, 100.0));
+      desc.m_LocalRotation.SetFromAxisAndAngle(ezVec3(1.0f, 2.0f, 3.0f).GetNormalized(), ezAngle::Degree((float)rng.DoubleMinMax(0.0, 360.0)));
+      desc.m_LocalScaling = ezVec3((float)rng.DoubleMinMax(0.5, 2.0), (float)rng.DoubleMinMax(0.5, 2.0), (float)rng.DoubleMinMax(0.5, 2.0));
+      desc.m_LocalUniformScaling = (float)rng.DoubleMinMax(0.5, 2.0);
+
+      ezGameObject* pObject = nullptr;
+      const ezGameObjectHandle hObject = world.CreateObject(desc, pObject);
+      hierarchy.PushBack(pObject);
+
+      TestBoundsComponent* pComponent = nullptr;
+      TestBoundsComponent::CreateComponent(pObject, pComponent);
+
+      // builds a few deep chains and many siblings
+      if (i % 5 == 0)
+        hParent[i % 3] = hObject;
+    }
+
+    world.Update();
+
+    for (ezGameObject* pObject : hierarchy)
+    {
+      ezSimdTransform expectedTransform = pObject->GetLocalTransformSimd();
+      if (const ezGameObject* pParent = pObject->GetParent())
+      {
+        expectedTransform = pParent->GetGlobalTransformSimd() * expectedTransform;
+      }
+
+      EZ_TEST_BOOL(pObject->GetGlobalTransformSimd().IsEqual(expectedTransform, 0.001f));
+
+      ezSimdBBoxSphere expectedBounds = pObject->GetLocalBoundsSimd();
+      expectedBounds.Transform(expectedTransform);
+
+      const ezSimdBBoxSphere& globalBounds = pObject->GetGlobalBoundsSimd();
+      EZ_TEST_BOOL(globalBounds.m_CenterAndRadius.IsEqual(expectedBounds.m_CenterAndRadius, 0.01f).AllSet<4>());
+      EZ_TEST_BOOL(globalBounds.m_BoxHalfExtents.IsEqual(expectedBounds.m_BoxHalfExtents, 0.01f).AllSet<3>());
+    }
+  }
+
   if (false)
   {
     ezStringBuilder outputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
@@ -248,3 +437,13 @@ EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
 
   world.Update();
 }
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem)
+{
+  TestSpatialSystem(ezSpatialSystemType::RegularGrid);
+}
+
+EZ_CREATE_SIMPLE_TEST(World, SpatialSystem_LooseOctree)
+{
+  TestSpatialSystem(ezSpatialSystemType::LooseOctree);
+}
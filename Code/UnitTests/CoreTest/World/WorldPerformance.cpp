@@ -1,6 +1,9 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/SpatialSystem_LooseOctree.h>
+#include <Core/World/SpatialSystem_RegularGrid.h>
 #include <Core/World/World.h>
+#include <Foundation/Math/Random.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -114,6 +117,118 @@ namespace
     }
   }
 
+  ezSimdBBoxSphere GetRandomBounds(ezRandom& rng, float fWorldHalfSize)
+  {
+    // mostly small objects, some medium sized ones and a few very large ones
+    const double fSizeClass = rng.DoubleZeroToOneExclusive();
+    const double fMaxHalfExtent = fSizeClass < 0.9 ? 5.0 : (fSizeClass < 0.99 ? 50.0 : 1000.0);
+
+    const ezVec3 vCenter((float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize), (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize),
+      (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize));
+    const ezVec3 vHalfExtents((float)rng.DoubleMinMax(0.5, fMaxHalfExtent), (float)rng.DoubleMinMax(0.5, fMaxHalfExtent), (float)rng.DoubleMinMax(0.5, fMaxHalfExtent));
+
+    ezBoundingBox box;
+    box.SetCenterAndHalfExtents(vCenter, vHalfExtents);
+
+    return ezSimdConversion::ToBBoxSphere(ezBoundingBoxSphere(box));
+  }
+
+  void MeasureSpatialSystem(const char* szName, ezSpatialSystem& spatialSystem)
+  {
+    const ezUInt32 uiNumObjects = 100000;
+    const float fWorldHalfSize = 4000.0f;
+    const ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask();
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezDynamicArray<ezSpatialDataHandle> handles;
+    handles.Reserve(uiNumObjects);
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      handles.PushBack(spatialSystem.CreateSpatialData(GetRandomBounds(rng, fWorldHalfSize), nullptr, uiCategoryBitmask));
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: Creating %u objects: %.2fms", szName, uiNumObjects, sw.Checkpoint().GetMilliseconds());
+
+    ezUInt32 uiNumFound = 0;
+    auto countCallback = [&](ezGameObject*) {
+      ++uiNumFound;
+      return ezVisitorExecution::Continue;
+    };
+
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      const ezVec3 vCenter((float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize), (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize),
+        (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize));
+      spatialSystem.FindObjectsInSphere(ezBoundingSphere(vCenter, (float)rng.DoubleMinMax(50.0, 500.0)), uiCategoryBitmask, countCallback);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: 1000 sphere queries (%u objects found): %.2fms", szName, uiNumFound, sw.Checkpoint().GetMilliseconds());
+
+    uiNumFound = 0;
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      const ezVec3 vCenter((float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize), (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize),
+        (float)rng.DoubleMinMax(-fWorldHalfSize, fWorldHalfSize));
+
+      ezBoundingBox box;
+      box.SetCenterAndHalfExtents(vCenter, ezVec3((float)rng.DoubleMinMax(50.0, 500.0)));
+      spatialSystem.FindObjectsInBox(box, uiCategoryBitmask, countCallback);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: 1000 box queries (%u objects found): %.2fms", szName, uiNumFound, sw.Checkpoint().GetMilliseconds());
+
+    ezDynamicArray<const ezGameObject*> visibleObjects;
+    uiNumFound = 0;
+    for (ezUInt32 i = 0; i < 100; ++i)
+    {
+      const ezAngle rotation = ezAngle::Degree(i * 3.6f);
+      const ezVec3 vForward(ezMath::Cos(rotation), ezMath::Sin(rotation), 0.0f);
+
+      ezFrustum frustum;
+      frustum.SetFrustum(ezVec3::ZeroVector(), vForward, ezVec3(0, 0, 1), ezAngle::Degree(90.0f), ezAngle::Degree(60.0f), 0.1f, 3000.0f);
+
+      visibleObjects.Clear();
+      spatialSystem.FindVisibleObjects(frustum, uiCategoryBitmask, visibleObjects);
+      uiNumFound += visibleObjects.GetCount();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: 100 frustum queries (%u objects found): %.2fms", szName, uiNumFound, sw.Checkpoint().GetMilliseconds());
+
+    // moves every tenth object a little bit, like a typical frame of dynamic objects would
+    ezDynamicArray<ezSpatialSystem::SpatialDataUpdate> updates;
+    for (ezUInt32 i = 0; i < uiNumObjects; i += 10)
+    {
+      const ezSpatialData* pData = nullptr;
+      spatialSystem.TryGetSpatialData(handles[i], pData);
+
+      auto& update = updates.ExpandAndGetRef();
+      update.m_Bounds = pData->m_Bounds;
+      update.m_Bounds.m_CenterAndRadius += ezSimdVec4f((float)rng.DoubleMinMax(-1.0, 1.0), (float)rng.DoubleMinMax(-1.0, 1.0), 0.0f, 0.0f);
+      update.m_hData = handles[i];
+      update.m_pObject = nullptr;
+      update.m_uiCategoryBitmask = uiCategoryBitmask;
+    }
+
+    sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      spatialSystem.UpdateSpatialDataBatch(updates);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s: 10x updating %u objects: %.2fms", szName, updates.GetCount(), sw.Checkpoint().GetMilliseconds());
+
+    for (auto& hData : handles)
+    {
+      spatialSystem.DeleteSpatialData(hData);
+    }
+  }
+
 } // namespace
 
 
@@ -288,3 +403,18 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_SpatialSystem)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "RegularGrid")
+  {
+    ezUniquePtr<ezSpatialSystem> pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_RegularGrid);
+    MeasureSpatialSystem("RegularGrid", *pSpatialSystem);
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "LooseOctree")
+  {
+    ezUniquePtr<ezSpatialSystem> pSpatialSystem = EZ_NEW(ezFoundation::GetAlignedAllocator(), ezSpatialSystem_LooseOctree);
+    MeasureSpatialSystem("LooseOctree", *pSpatialSystem);
+  }
+}
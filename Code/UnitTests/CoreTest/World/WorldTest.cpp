@@ -3,6 +3,7 @@
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
+#include <Foundation/Utilities/Stats.h>
 
 EZ_CREATE_SIMPLE_TEST_GROUP(World);
 
@@ -167,6 +168,55 @@ EZ_CREATE_SIMPLE_TEST(World, World)
     TestTransforms(o, offset);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms dynamic skip unchanged")
+  {
+    ezWorldDesc worldDesc("DirtyTransforms");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto GetNumUpdated = []() { return ezStats::GetStat("World Update/DirtyTransforms/Transforms Updated").ConvertTo<ezInt32>(); };
+    auto GetNumSkipped = []() { return ezStats::GetStat("World Update/DirtyTransforms/Transforms Skipped").ConvertTo<ezInt32>(); };
+
+    TestWorldObjects o = CreateTestWorld(world, true);
+
+    // new objects are updated until their velocity has settled
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_INT(GetNumUpdated(), 0);
+    EZ_TEST_INT(GetNumSkipped(), 4);
+
+    ezVec3 offset = ezVec3(200.0f, 0.0f, 0.0f);
+    o.pParent1->SetLocalPosition(offset);
+
+    world.Update();
+
+    // only the moved object and its child
+    EZ_TEST_INT(GetNumUpdated(), 2);
+    EZ_TEST_INT(GetNumSkipped(), 2);
+
+    const float eps = ezMath::DefaultEpsilon<float>();
+    EZ_TEST_VEC3(o.pParent1->GetGlobalPosition(), offset, 0);
+    EZ_TEST_VEC3(o.pChild11->GetGlobalPosition(), offset + ezVec3(0.0f, 150.0f, 0.0f), eps * 2.0f);
+    EZ_TEST_VEC3(o.pParent2->GetGlobalPosition(), ezVec3(100.0f, 0.0f, 0.0f), 0);
+    EZ_TEST_VEC3(o.pChild21->GetGlobalPosition(), ezVec3(100.0f, 150.0f, 0.0f), eps * 2.0f);
+
+    for (ezUInt32 i = 0; i < 2; ++i)
+    {
+      world.Update();
+    }
+
+    EZ_TEST_INT(GetNumUpdated(), 0);
+    EZ_TEST_INT(GetNumSkipped(), 4);
+
+#if EZ_ENABLED(EZ_GAMEOBJECT_VELOCITY)
+    EZ_TEST_VEC3(o.pParent1->GetVelocity(), ezVec3::ZeroVector(), 0);
+    EZ_TEST_VEC3(o.pChild11->GetVelocity(), ezVec3::ZeroVector(), 0);
+#endif
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "Transforms static")
   {
     ezWorldDesc worldDesc("Test");
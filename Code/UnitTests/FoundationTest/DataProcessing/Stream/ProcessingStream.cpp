@@ -52,6 +52,54 @@ protected:
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(AddOneStreamProcessor, 1, ezRTTIDefaultAllocator<AddOneStreamProcessor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
+// Writes the element index into all components of a SoA stream
+
+class IndexSoAStreamInitializer : public ezProcessingStreamProcessor
+{
+  EZ_ADD_DYNAMIC_REFLECTION(IndexSoAStreamInitializer, ezProcessingStreamProcessor);
+
+public:
+  IndexSoAStreamInitializer()
+      : m_pStream(nullptr)
+      , m_fNextValue(0.0f)
+  {
+  }
+
+  void SetStreamName(ezHashedString StreamName) { m_StreamName = StreamName; }
+
+protected:
+  virtual ezResult UpdateStreamBindings() override
+  {
+    m_pStream = m_pStreamGroup->GetStreamByName(m_StreamName);
+
+    return m_pStream ? EZ_SUCCESS : EZ_FAILURE;
+  }
+
+  virtual void InitializeElements(ezUInt64 uiStartIndex, ezUInt64 uiNumElements) override
+  {
+    for (ezUInt32 uiComponent = 0; uiComponent < m_pStream->GetNumComponentArrays(); ++uiComponent)
+    {
+      float* pData = m_pStream->GetWritableComponentData<float>(uiComponent);
+
+      for (ezUInt64 i = 0; i < uiNumElements; ++i)
+      {
+        pData[uiStartIndex + i] = (m_fNextValue + i) * (uiComponent + 1);
+      }
+    }
+
+    m_fNextValue += uiNumElements;
+  }
+
+  virtual void Process(ezUInt64 uiNumElements) override {}
+
+  ezHashedString m_StreamName;
+  ezProcessingStream* m_pStream;
+  float m_fNextValue;
+};
+
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(IndexSoAStreamInitializer, 1, ezRTTIDefaultAllocator<IndexSoAStreamInitializer>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
 {
   ezProcessingStreamGroup Group;
@@ -157,3 +205,86 @@ EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStream)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(DataProcessing, ProcessingStreamSoA)
+{
+  ezProcessingStreamGroup Group;
+  ezProcessingStream* pStream = Group.AddStream("Stream", ezProcessingStream::DataType::Float3SoA);
+
+  EZ_TEST_BOOL(pStream != nullptr);
+  EZ_TEST_INT(pStream->GetNumComponentArrays(), 3);
+  EZ_TEST_INT(pStream->GetElementSize(), 12);
+  EZ_TEST_INT(pStream->GetElementStride(), 4);
+
+  IndexSoAStreamInitializer* pInitializer = EZ_DEFAULT_NEW(IndexSoAStreamInitializer);
+  pInitializer->SetStreamName(pStream->GetName());
+  Group.AddProcessor(pInitializer);
+
+  // not a multiple of four, the component arrays are padded
+  Group.SetSize(13);
+  Group.InitializeElements(13);
+  Group.Process();
+
+  EZ_TEST_INT(Group.GetNumActiveElements(), 13);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Component Arrays")
+  {
+    for (ezUInt32 uiComponent = 0; uiComponent < 3; ++uiComponent)
+    {
+      const float* pData = pStream->GetComponentData<float>(uiComponent);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pData, 16));
+
+      for (ezUInt32 i = 0; i < 13; ++i)
+      {
+        EZ_TEST_FLOAT(pData[i], static_cast<float>(i * (uiComponent + 1)), 0.0f);
+      }
+    }
+
+    EZ_TEST_INT(pStream->GetComponentData<float>(1) - pStream->GetComponentData<float>(0), 16);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Remove Elements")
+  {
+    // the last element is moved into each gap, in all component arrays
+    Group.RemoveElement(2);
+    Group.RemoveElement(12);
+    Group.RemoveElement(5);
+    Group.Process();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), 10);
+
+    const float expected[] = {0, 1, 10, 3, 4, 11, 6, 7, 8, 9};
+
+    for (ezUInt32 uiComponent = 0; uiComponent < 3; ++uiComponent)
+    {
+      const float* pData = pStream->GetComponentData<float>(uiComponent);
+
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(expected); ++i)
+      {
+        EZ_TEST_FLOAT(pData[i], expected[i] * (uiComponent + 1), 0.0f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Zero Initializer")
+  {
+    ezProcessingStreamSpawnerZeroInitialized* pSpawner = EZ_DEFAULT_NEW(ezProcessingStreamSpawnerZeroInitialized);
+    pSpawner->SetStreamName(pStream->GetName());
+    pSpawner->m_fPriority = 1.0f; // runs after the index initializer
+    Group.AddProcessor(pSpawner);
+
+    Group.InitializeElements(2);
+    Group.Process();
+
+    EZ_TEST_INT(Group.GetNumActiveElements(), 12);
+
+    for (ezUInt32 uiComponent = 0; uiComponent < 3; ++uiComponent)
+    {
+      const float* pData = pStream->GetComponentData<float>(uiComponent);
+
+      EZ_TEST_FLOAT(pData[9], 9.0f * (uiComponent + 1), 0.0f);
+      EZ_TEST_FLOAT(pData[10], 0.0f, 0.0f);
+      EZ_TEST_FLOAT(pData[11], 0.0f, 0.0f);
+    }
+  }
+}
@@ -0,0 +1,364 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Math/Color16f.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Texture/Image/Conversions/DXTConversions.h>
+#include <Texture/Image/Image.h>
+#include <Texture/Image/ImageConversion.h>
+
+namespace
+{
+  static const ezBlockCompressionQuality::Enum s_Qualities[] = {
+    ezBlockCompressionQuality::Fast, ezBlockCompressionQuality::Normal, ezBlockCompressionQuality::High};
+
+  static const char* s_szQualityNames[] = {"Fast", "Normal", "High"};
+
+  struct TestBlockGenerator
+  {
+    ezUInt32 m_uiRandom = 42;
+
+    ezUInt32 Random(ezUInt32 uiRange)
+    {
+      m_uiRandom = m_uiRandom * 1664525u + 1013904223u;
+      return (m_uiRandom >> 8) % uiRange;
+    }
+
+    /// \brief Fills the block with a random gradient plus a bit of noise, which is roughly what blocks of real textures look like.
+    void CreateBlock(ezColorBaseUB* pBlock)
+    {
+      ezInt32 start[4];
+      ezInt32 end[4];
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        start[c] = Random(256);
+        end[c] = ezMath::Clamp<ezInt32>(start[c] + Random(97) - 48, 0, 255);
+      }
+
+      const ezUInt32 uiNoise = Random(9) + 1;
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        const ezInt32 t = (i % 4) + (i / 4);
+        ezUInt8* pTexel = &pBlock[i].r;
+
+        for (ezUInt32 c = 0; c < 4; ++c)
+        {
+          const ezInt32 iValue = start[c] + (end[c] - start[c]) * t / 6 + Random(uiNoise) - uiNoise / 2;
+          pTexel[c] = static_cast<ezUInt8>(ezMath::Clamp(iValue, 0, 255));
+        }
+      }
+    }
+  };
+
+  double ComputePSNR(double fSquaredError, ezUInt32 uiNumValues)
+  {
+    const double fMSE = ezMath::Max(fSquaredError / uiNumValues, 1e-6);
+    return 10.0 * ezMath::Log10(static_cast<float>(255.0 * 255.0 / fMSE));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, BlockCompression)
+{
+  const ezUInt32 uiNumBlocks = 256;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1")
+  {
+    double fPreviousPSNR = 0.0;
+
+    for (ezUInt32 q = 0; q < EZ_ARRAY_SIZE(s_Qualities); ++q)
+    {
+      TestBlockGenerator generator;
+      double fSquaredError = 0.0;
+
+      for (ezUInt32 b = 0; b < uiNumBlocks; ++b)
+      {
+        ezColorBaseUB source[16];
+        generator.CreateBlock(source);
+
+        ezUInt8 compressed[8];
+        ezCompressBlockBC1(source, compressed, true, s_Qualities[q]);
+
+        ezColorBaseUB decompressed[16];
+        ezDecompressBlockBC1(compressed, decompressed, true);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          fSquaredError += ezMath::Square<double>(source[i].r - decompressed[i].r);
+          fSquaredError += ezMath::Square<double>(source[i].g - decompressed[i].g);
+          fSquaredError += ezMath::Square<double>(source[i].b - decompressed[i].b);
+        }
+      }
+
+      const double fPSNR = ComputePSNR(fSquaredError, uiNumBlocks * 16 * 3);
+      ezTestFramework::Output(ezTestOutput::Message, "BC1 %s: %.2f dB", s_szQualityNames[q], fPSNR);
+
+      EZ_TEST_BOOL(fPSNR > 35.0);
+      EZ_TEST_BOOL(fPSNR >= fPreviousPSNR - 0.01);
+      fPreviousPSNR = fPSNR;
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC1 Transparency")
+  {
+    TestBlockGenerator generator;
+
+    for (ezUInt32 b = 0; b < 32; ++b)
+    {
+      ezColorBaseUB source[16];
+      generator.CreateBlock(source);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        source[i].a = (i + b) % 3 == 0 ? 0 : 255;
+      }
+
+      ezUInt8 compressed[8];
+      ezCompressBlockBC1(source, compressed, false, ezBlockCompressionQuality::Default);
+
+      ezColorBaseUB decompressed[16];
+      ezDecompressBlockBC1(compressed, decompressed, false);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_INT(decompressed[i].a, source[i].a);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC4")
+  {
+    for (ezUInt8 bias : {0, 128})
+    {
+      double fPreviousPSNR = 0.0;
+
+      for (ezUInt32 q = 0; q < EZ_ARRAY_SIZE(s_Qualities); ++q)
+      {
+        TestBlockGenerator generator;
+        double fSquaredError = 0.0;
+
+        for (ezUInt32 b = 0; b < uiNumBlocks; ++b)
+        {
+          ezColorBaseUB block[16];
+          generator.CreateBlock(block);
+
+          // shift the gradient into the signed range for SNORM, so that it doesn't wrap around between 127 and -128
+          ezUInt8 source[16];
+          for (ezUInt32 i = 0; i < 16; ++i)
+          {
+            source[i] = static_cast<ezUInt8>(block[i].g - bias);
+          }
+
+          ezUInt8 compressed[8];
+          ezCompressBlockBC4(source, 1, compressed, bias, s_Qualities[q]);
+
+          ezUInt8 decompressed[16];
+          ezDecompressBlockBC4(compressed, decompressed, 1, bias);
+
+          for (ezUInt32 i = 0; i < 16; ++i)
+          {
+            const ezInt32 iSource = bias != 0 ? static_cast<ezInt8>(source[i]) : source[i];
+            const ezInt32 iDecompressed = bias != 0 ? static_cast<ezInt8>(decompressed[i]) : decompressed[i];
+            fSquaredError += ezMath::Square<double>(iSource - iDecompressed);
+          }
+        }
+
+        const double fPSNR = ComputePSNR(fSquaredError, uiNumBlocks * 16);
+        ezTestFramework::Output(ezTestOutput::Message, "BC4 %s %s: %.2f dB", bias != 0 ? "SNORM" : "UNORM", s_szQualityNames[q], fPSNR);
+
+        EZ_TEST_BOOL(fPSNR > 40.0);
+        EZ_TEST_BOOL(fPSNR >= fPreviousPSNR - 0.01);
+        fPreviousPSNR = fPSNR;
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC4 Constant")
+  {
+    for (ezUInt32 uiValue = 0; uiValue < 256; uiValue += 15)
+    {
+      ezUInt8 source[16];
+      ezMemoryUtils::PatternFill(source, static_cast<ezUInt8>(uiValue), 16);
+
+      ezUInt8 compressed[8];
+      ezCompressBlockBC4(source, 1, compressed, 0, ezBlockCompressionQuality::Fast);
+
+      ezUInt8 decompressed[16];
+      ezDecompressBlockBC4(compressed, decompressed, 1, 0);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_INT(decompressed[i], uiValue);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC6H")
+  {
+    TestBlockGenerator generator;
+    double fSquaredLogError = 0.0;
+
+    for (ezUInt32 b = 0; b < uiNumBlocks; ++b)
+    {
+      ezColorBaseUB ldr[16];
+      generator.CreateBlock(ldr);
+
+      // spread the values over a HDR range of [0; 16]
+      const float fScale = 16.0f / 255.0f * (1 + generator.Random(4)) / 4.0f;
+
+      ezColorLinear16f source[16];
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        source[i] = ezColor(ldr[i].r * fScale, ldr[i].g * fScale, ldr[i].b * fScale, 1.0f);
+      }
+
+      ezUInt8 compressed[16];
+      ezCompressBlockBC6(source, compressed, ezBlockCompressionQuality::Default);
+
+      ezColorLinear16f decompressed[16];
+      ezDecompressBlockBC6(compressed, decompressed, false);
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        const ezColor sourceColor = source[i].ToLinearFloat();
+        const ezColor decompressedColor = decompressed[i].ToLinearFloat();
+
+        fSquaredLogError += ezMath::Square<double>(ezMath::Log2(1.0f + sourceColor.r) - ezMath::Log2(1.0f + decompressedColor.r));
+        fSquaredLogError += ezMath::Square<double>(ezMath::Log2(1.0f + sourceColor.g) - ezMath::Log2(1.0f + decompressedColor.g));
+        fSquaredLogError += ezMath::Square<double>(ezMath::Log2(1.0f + sourceColor.b) - ezMath::Log2(1.0f + decompressedColor.b));
+      }
+    }
+
+    const double fLogRMSE = ezMath::Sqrt(fSquaredLogError / (uiNumBlocks * 16 * 3));
+    ezTestFramework::Output(ezTestOutput::Message, "BC6H: log RMSE %.4f", fLogRMSE);
+
+    EZ_TEST_BOOL(fLogRMSE < 0.05);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "BC7")
+  {
+    double fPreviousPSNR = 0.0;
+
+    for (ezUInt32 q = 0; q < EZ_ARRAY_SIZE(s_Qualities); ++q)
+    {
+      TestBlockGenerator generator;
+      double fSquaredError = 0.0;
+
+      for (ezUInt32 b = 0; b < uiNumBlocks; ++b)
+      {
+        ezColorBaseUB source[16];
+        generator.CreateBlock(source);
+
+        ezUInt8 compressed[16];
+        ezCompressBlockBC7(source, compressed, s_Qualities[q]);
+
+        ezColorBaseUB decompressed[16];
+        ezDecompressBlockBC7(compressed, decompressed);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          fSquaredError += ezMath::Square<double>(source[i].r - decompressed[i].r);
+          fSquaredError += ezMath::Square<double>(source[i].g - decompressed[i].g);
+          fSquaredError += ezMath::Square<double>(source[i].b - decompressed[i].b);
+          fSquaredError += ezMath::Square<double>(source[i].a - decompressed[i].a);
+        }
+      }
+
+      const double fPSNR = ComputePSNR(fSquaredError, uiNumBlocks * 16 * 4);
+      ezTestFramework::Output(ezTestOutput::Message, "BC7 %s: %.2f dB", s_szQualityNames[q], fPSNR);
+
+      EZ_TEST_BOOL(fPSNR > 35.0);
+      EZ_TEST_BOOL(fPSNR >= fPreviousPSNR - 0.01);
+      fPreviousPSNR = fPSNR;
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Image Conversion")
+  {
+    // odd sizes, so that the conversion has to deal with partial blocks at the border
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(70);
+    header.SetHeight(37);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+      {
+        *source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y) = ezColorBaseUB(x * 3, y * 6, 128, 255);
+      }
+    }
+
+    const ezImageFormat::Enum formats[] = {ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM, ezImageFormat::BC7_UNORM};
+
+    for (ezImageFormat::Enum format : formats)
+    {
+      ezImage compressed;
+      EZ_TEST_BOOL(ezImageConversion::Convert(source, compressed, format).Succeeded());
+      EZ_TEST_INT(compressed.GetImageFormat(), format);
+
+      ezImage decompressed;
+      EZ_TEST_BOOL(ezImageConversion::Convert(compressed, decompressed, ezImageFormat::R8G8B8A8_UNORM).Succeeded());
+
+      for (ezUInt32 y = 0; y < header.GetHeight(); ++y)
+      {
+        for (ezUInt32 x = 0; x < header.GetWidth(); ++x)
+        {
+          const ezColorBaseUB sourceColor = *source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+          const ezColorBaseUB decompressedColor = *decompressed.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x, y);
+
+          EZ_TEST_INT_MSG(ezMath::Abs(sourceColor.r - decompressedColor.r) <= 16, 1, "%s at %u|%u", ezImageFormat::GetName(format), x, y);
+          EZ_TEST_INT_MSG(ezMath::Abs(sourceColor.g - decompressedColor.g) <= 16, 1, "%s at %u|%u", ezImageFormat::GetName(format), x, y);
+        }
+      }
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Image, Profile_BlockCompression)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "1024x1024")
+  {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R8G8B8A8_UNORM);
+    header.SetWidth(1024);
+    header.SetHeight(1024);
+
+    ezImage source;
+    source.ResetAndAlloc(header);
+
+    TestBlockGenerator generator;
+    for (ezUInt32 y = 0; y < header.GetHeight(); y += 4)
+    {
+      for (ezUInt32 x = 0; x < header.GetWidth(); x += 4)
+      {
+        ezColorBaseUB block[16];
+        generator.CreateBlock(block);
+
+        for (ezUInt32 i = 0; i < 16; ++i)
+        {
+          *source.GetPixelPointer<ezColorBaseUB>(0, 0, 0, x + i % 4, y + i / 4) = block[i];
+        }
+      }
+    }
+
+    const ezImageFormat::Enum formats[] = {ezImageFormat::BC1_UNORM, ezImageFormat::BC3_UNORM, ezImageFormat::BC7_UNORM};
+
+    for (ezImageFormat::Enum format : formats)
+    {
+      for (ezUInt32 q = 0; q < EZ_ARRAY_SIZE(s_Qualities); ++q)
+      {
+        ezImage compressed;
+
+        ezStopwatch sw;
+        EZ_TEST_BOOL(ezImageConversion::Convert(source, compressed, format, s_Qualities[q]).Succeeded());
+        const ezTime tCompress = sw.Checkpoint();
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%s (%s): %.2fms (%.1f MPixel/s)", ezImageFormat::GetName(format), s_szQualityNames[q],
+          tCompress.GetMilliseconds(), header.GetWidth() * header.GetHeight() / tCompress.GetMicroseconds());
+      }
+    }
+  }
+}
@@ -5,6 +5,9 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Math/Float16.h>
+#include <Foundation/Math/Random.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Texture/Image/Formats/BmpFileFormat.h>
 #include <Texture/Image/Formats/DdsFileFormat.h>
 #include <Texture/Image/Formats/ImageFileFormat.h>
@@ -206,6 +209,11 @@ private:
 
     ezFileSystem::AddDataDirectory(">eztest/", "ImageComparisonDataDir", "imgout", ezFileSystem::AllowWrites);
 
+#if EZ_DISABLED(EZ_PLATFORM_WINDOWS_DESKTOP)
+    // Without DirectXTex the block compressed formats are encoded by the native compressor, which produces different (but valid) blocks
+    ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName("Images_Reference_NativeBC");
+#endif
+
     return EZ_SUCCESS;
   }
 
@@ -214,6 +222,8 @@ private:
     ezFileSystem::RemoveDataDirectoryGroup("ImageConversionTest");
     ezFileSystem::RemoveDataDirectoryGroup("ImageComparisonDataDir");
 
+    ezTestFramework::GetInstance()->SetImageReferenceOverrideFolderName("");
+
     ezStartup::ShutdownCoreSystems();
     ezMemoryTracker::DumpMemoryLeaks();
 
@@ -229,3 +239,217 @@ private:
 
 static ezImageConversionTest s_ImageConversionTest;
 
+
+namespace
+{
+  // Not a multiple of the SIMD batch sizes or of the number of pixels that are converted per task
+  void AllocPixelConversionTestImage(ezImage& out_Image, ezImageFormat::Enum format)
+  {
+    ezImageHeader header;
+    header.SetImageFormat(format);
+    header.SetWidth(397);
+    header.SetHeight(301);
+    out_Image.ResetAndAlloc(header);
+  }
+
+  void FillWithFloats(ezImage& out_Image)
+  {
+    const float specialValues[] = {0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1e-6f, -1e-6f, 1e-30f, 65504.0f, 70000.0f, -70000.0f,
+      ezMath::Infinity<float>(), -ezMath::Infinity<float>(), ezMath::NaN<float>()};
+
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezBlobPtr<float> values = out_Image.GetBlobPtr<float>();
+    for (ezUInt64 i = 0; i < values.GetCount(); ++i)
+    {
+      if (rng.UIntInRange(8) == 0)
+        values[i] = specialValues[rng.UIntInRange(EZ_ARRAY_SIZE(specialValues))];
+      else
+        values[i] = rng.FloatMinMax(-1.5f, 1.5f);
+    }
+  }
+
+  void FillWithBits(ezImage& out_Image)
+  {
+    ezRandom rng;
+    rng.Initialize(42);
+
+    ezBlobPtr<ezUInt8> values = out_Image.GetBlobPtr<ezUInt8>();
+    for (ezUInt64 i = 0; i < values.GetCount(); ++i)
+    {
+      values[i] = static_cast<ezUInt8>(rng.UInt());
+    }
+  }
+
+  /// \brief Converts the image and compares every channel against the scalar conversion function.
+  template <typename SourceType, typename TargetType, typename Reference>
+  void TestPixelConversion(const ezImage& source, ezImageFormat::Enum targetFormat, Reference reference)
+  {
+    ezImage target;
+    EZ_TEST_BOOL(ezImageConversion::Convert(source, target, targetFormat).Succeeded());
+
+    ezBlobPtr<const SourceType> sourceValues = source.GetBlobPtr<SourceType>();
+    ezBlobPtr<TargetType> targetValues = target.GetBlobPtr<TargetType>();
+    EZ_TEST_INT(sourceValues.GetCount(), targetValues.GetCount());
+
+    ezUInt32 uiNumMismatches = 0;
+    for (ezUInt64 i = 0; i < sourceValues.GetCount(); ++i)
+    {
+      const TargetType expected = reference(sourceValues[i], static_cast<ezUInt32>(i % 4));
+      if (ezMemoryUtils::Compare(&expected, &targetValues[i]) != 0)
+      {
+        ++uiNumMismatches;
+      }
+    }
+
+    EZ_TEST_INT(uiNumMismatches, 0);
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Image, PixelConversion)
+{
+  ezImage floatImage;
+  AllocPixelConversionTestImage(floatImage, ezImageFormat::R32G32B32A32_FLOAT);
+  FillWithFloats(floatImage);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F32 to U8")
+  {
+    TestPixelConversion<float, ezUInt8>(
+      floatImage, ezImageFormat::R8G8B8A8_UNORM, [](float value, ezUInt32) { return ezMath::ColorFloatToByte(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F32 to U16")
+  {
+    TestPixelConversion<float, ezUInt16>(
+      floatImage, ezImageFormat::R16G16B16A16_UNORM, [](float value, ezUInt32) { return ezMath::ColorFloatToShort(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F32 to S8")
+  {
+    TestPixelConversion<float, ezInt8>(
+      floatImage, ezImageFormat::R8G8B8A8_SNORM, [](float value, ezUInt32) { return ezMath::ColorFloatToSignedByte(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F32 to F16")
+  {
+    TestPixelConversion<float, ezFloat16>(floatImage, ezImageFormat::R16G16B16A16_FLOAT, [](float value, ezUInt32) { return ezFloat16(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F32 to sRGB")
+  {
+    TestPixelConversion<float, ezUInt8>(floatImage, ezImageFormat::R8G8B8A8_UNORM_SRGB, [](float value, ezUInt32 uiChannel) {
+      return ezMath::ColorFloatToByte(uiChannel == 3 ? value : ezColor::LinearToGamma(value));
+    });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "U8 to F32")
+  {
+    ezImage source;
+    AllocPixelConversionTestImage(source, ezImageFormat::R8G8B8A8_UNORM);
+    FillWithBits(source);
+
+    TestPixelConversion<ezUInt8, float>(
+      source, ezImageFormat::R32G32B32A32_FLOAT, [](ezUInt8 value, ezUInt32) { return ezMath::ColorByteToFloat(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "U16 to F32")
+  {
+    ezImage source;
+    AllocPixelConversionTestImage(source, ezImageFormat::R16G16B16A16_UNORM);
+    FillWithBits(source);
+
+    TestPixelConversion<ezUInt16, float>(
+      source, ezImageFormat::R32G32B32A32_FLOAT, [](ezUInt16 value, ezUInt32) { return ezMath::ColorShortToFloat(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "S8 to F32")
+  {
+    ezImage source;
+    AllocPixelConversionTestImage(source, ezImageFormat::R8G8B8A8_SNORM);
+    FillWithBits(source);
+
+    TestPixelConversion<ezInt8, float>(
+      source, ezImageFormat::R32G32B32A32_FLOAT, [](ezInt8 value, ezUInt32) { return ezMath::ColorSignedByteToFloat(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "F16 to F32")
+  {
+    ezImage source;
+    AllocPixelConversionTestImage(source, ezImageFormat::R16G16B16A16_FLOAT);
+    FillWithBits(source);
+
+    TestPixelConversion<ezFloat16, float>(source, ezImageFormat::R32G32B32A32_FLOAT, [](ezFloat16 value, ezUInt32) { return static_cast<float>(value); });
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "sRGB to F32")
+  {
+    ezImage source;
+    AllocPixelConversionTestImage(source, ezImageFormat::R8G8B8A8_UNORM_SRGB);
+    FillWithBits(source);
+
+    TestPixelConversion<ezUInt8, float>(source, ezImageFormat::R32G32B32A32_FLOAT, [](ezUInt8 value, ezUInt32 uiChannel) {
+      const float gamma = ezMath::ColorByteToFloat(value);
+      return uiChannel == 3 ? gamma : ezColor::GammaToLinear(gamma);
+    });
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Image, Profile_ImageConversion)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "All Single Step Conversions")
+  {
+    const ezUInt32 uiSize = 2048;
+    const double fMegaPixels = uiSize * uiSize / 1000000.0;
+
+    ezImage floatImage;
+    {
+      ezImageHeader header;
+      header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+      header.SetWidth(uiSize);
+      header.SetHeight(uiSize);
+      floatImage.ResetAndAlloc(header);
+
+      for (ezUInt32 y = 0; y < uiSize; ++y)
+      {
+        ezColor* pRow = floatImage.GetPixelPointer<ezColor>(0, 0, 0, 0, y);
+        for (ezUInt32 x = 0; x < uiSize; ++x)
+        {
+          pRow[x] = ezColor(static_cast<float>(x) / uiSize, static_cast<float>(y) / uiSize, static_cast<float>((x ^ y) & 255) / 255.0f, 1.0f);
+        }
+      }
+    }
+
+    for (ezUInt32 sourceIndex = 0; sourceIndex < ezImageFormat::NUM_FORMATS; ++sourceIndex)
+    {
+      const ezImageFormat::Enum sourceFormat = static_cast<ezImageFormat::Enum>(sourceIndex);
+      if (ezImageFormat::IsCompressed(sourceFormat) || !ezImageConversion::IsConvertible(ezImageFormat::R32G32B32A32_FLOAT, sourceFormat))
+        continue;
+
+      ezImage source;
+      if (ezImageConversion::Convert(floatImage, source, sourceFormat).Failed())
+        continue;
+
+      for (ezUInt32 targetIndex = 0; targetIndex < ezImageFormat::NUM_FORMATS; ++targetIndex)
+      {
+        const ezImageFormat::Enum targetFormat = static_cast<ezImageFormat::Enum>(targetIndex);
+        if (targetFormat == sourceFormat || ezImageFormat::IsCompressed(targetFormat))
+          continue;
+
+        // Only measure the routes that are implemented by a single registered conversion step
+        ezHybridArray<ezImageConversion::ConversionPathNode, 16> path;
+        ezUInt32 uiNumScratchBuffers = 0;
+        if (ezImageConversion::BuildPath(sourceFormat, targetFormat, false, path, uiNumScratchBuffers).Failed() || path.GetCount() != 1)
+          continue;
+
+        ezImage target;
+        ezStopwatch sw;
+        EZ_TEST_BOOL(ezImageConversion::Convert(source, target, targetFormat).Succeeded());
+        const ezTime tDuration = sw.Checkpoint();
+
+        ezTestFramework::Output(ezTestOutput::Duration, "%s -> %s: %.2fms (%.0f MPixel/s)", ezImageFormat::GetName(sourceFormat),
+          ezImageFormat::GetName(targetFormat), tDuration.GetMilliseconds(), fMegaPixels / tDuration.GetSeconds());
+      }
+    }
+  }
+}
@@ -3,8 +3,134 @@
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 #include <Texture/Image/ImageUtils.h>
 
+namespace
+{
+  struct ReferenceImage
+  {
+    ezUInt32 m_uiSize[3] = {};
+    ezDynamicArray<ezColor> m_Pixels;
+
+    ezColor& GetPixel(ezUInt32 x, ezUInt32 y, ezUInt32 z) { return m_Pixels[(z * m_uiSize[1] + y) * m_uiSize[0] + x]; }
+
+    void Create(ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth)
+    {
+      m_uiSize[0] = uiWidth;
+      m_uiSize[1] = uiHeight;
+      m_uiSize[2] = uiDepth;
+      m_Pixels.SetCount(uiWidth * uiHeight * uiDepth);
+    }
+
+    void ToImage(ezImage& out_Image)
+    {
+      ezImageHeader header;
+      header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+      header.SetWidth(m_uiSize[0]);
+      header.SetHeight(m_uiSize[1]);
+      header.SetDepth(m_uiSize[2]);
+      out_Image.ResetAndAlloc(header);
+
+      for (ezUInt32 z = 0; z < m_uiSize[2]; ++z)
+        for (ezUInt32 y = 0; y < m_uiSize[1]; ++y)
+          for (ezUInt32 x = 0; x < m_uiSize[0]; ++x)
+            *out_Image.GetPixelPointer<ezColor>(0, 0, 0, x, y, z) = GetPixel(x, y, z);
+    }
+  };
+
+  /// \brief Straight forward implementation of one filter pass along the given axis, which the optimized Scale3D is compared against.
+  void ReferenceFilterPass(ReferenceImage& source, ezUInt32 uiAxis, ezUInt32 uiTargetSize, const ezImageFilter& filter,
+    ezImageAddressMode::Enum addressMode, const ezColor& borderColor, ReferenceImage& out_Target)
+  {
+    ezUInt32 targetSize[3] = {source.m_uiSize[0], source.m_uiSize[1], source.m_uiSize[2]};
+    targetSize[uiAxis] = uiTargetSize;
+    out_Target.Create(targetSize[0], targetSize[1], targetSize[2]);
+
+    if (source.m_uiSize[uiAxis] == uiTargetSize)
+    {
+      out_Target.m_Pixels = source.m_Pixels;
+      return;
+    }
+
+    ezImageFilterWeights weights(filter, source.m_uiSize[uiAxis], uiTargetSize);
+
+    for (ezUInt32 z = 0; z < targetSize[2]; ++z)
+    {
+      for (ezUInt32 y = 0; y < targetSize[1]; ++y)
+      {
+        for (ezUInt32 x = 0; x < targetSize[0]; ++x)
+        {
+          const ezUInt32 targetPos[3] = {x, y, z};
+          const ezInt32 iFirstSourceIndex = weights.GetFirstSourceSampleIndex(targetPos[uiAxis]);
+
+          ezColor total(0, 0, 0, 0);
+          for (ezUInt32 w = 0; w < weights.GetNumWeights(); ++w)
+          {
+            bool bUseBorderColor = false;
+            ezUInt32 sourcePos[3] = {x, y, z};
+            sourcePos[uiAxis] =
+              ezImageUtils::GetSampleIndex(source.m_uiSize[uiAxis], iFirstSourceIndex + static_cast<ezInt32>(w), addressMode, bUseBorderColor);
+
+            const ezColor sample = bUseBorderColor ? borderColor : source.GetPixel(sourcePos[0], sourcePos[1], sourcePos[2]);
+            total += sample * static_cast<float>(weights.GetWeight(targetPos[uiAxis], w));
+          }
+
+          out_Target.GetPixel(x, y, z) = total;
+        }
+      }
+    }
+  }
+
+  void TestScale3D(ezUInt32 uiWidth, ezUInt32 uiHeight, ezUInt32 uiDepth, ezUInt32 uiTargetWidth, ezUInt32 uiTargetHeight,
+    ezUInt32 uiTargetDepth, const ezImageFilter& filter, ezImageAddressMode::Enum addressMode)
+  {
+    const ezColor borderColor(0.25f, 0.5f, 0.75f, 1.0f);
+
+    ReferenceImage reference[4];
+    reference[0].Create(uiWidth, uiHeight, uiDepth);
+
+    ezUInt32 uiRandom = uiWidth * 31 + uiHeight * 7 + uiDepth;
+    for (ezColor& pixel : reference[0].m_Pixels)
+    {
+      float* pChannels = pixel.GetData();
+      for (ezUInt32 c = 0; c < 4; ++c)
+      {
+        uiRandom = uiRandom * 1664525u + 1013904223u;
+        pChannels[c] = static_cast<float>(uiRandom >> 8) / static_cast<float>(1 << 24);
+      }
+    }
+
+    ezImage source, target;
+    reference[0].ToImage(source);
+
+    EZ_TEST_BOOL(ezImageUtils::Scale3D(source, target, uiTargetWidth, uiTargetHeight, uiTargetDepth, &filter, addressMode, addressMode,
+                   addressMode, borderColor)
+                   .Succeeded());
+
+    ReferenceFilterPass(reference[0], 0, uiTargetWidth, filter, addressMode, borderColor, reference[1]);
+    ReferenceFilterPass(reference[1], 1, uiTargetHeight, filter, addressMode, borderColor, reference[2]);
+    ReferenceFilterPass(reference[2], 2, uiTargetDepth, filter, addressMode, borderColor, reference[3]);
+
+    EZ_TEST_INT(target.GetWidth(), uiTargetWidth);
+    EZ_TEST_INT(target.GetHeight(), uiTargetHeight);
+    EZ_TEST_INT(target.GetDepth(), uiTargetDepth);
+
+    for (ezUInt32 z = 0; z < uiTargetDepth; ++z)
+    {
+      for (ezUInt32 y = 0; y < uiTargetHeight; ++y)
+      {
+        for (ezUInt32 x = 0; x < uiTargetWidth; ++x)
+        {
+          const ezColor expected = reference[3].GetPixel(x, y, z);
+          const ezColor actual = *target.GetPixelPointer<ezColor>(0, 0, 0, x, y, z);
+          EZ_TEST_BOOL_MSG(actual.IsEqualRGBA(expected, 0.0001f), "Mismatch at %u|%u|%u with address mode %i", x, y, z, addressMode);
+        }
+      }
+    }
+  }
+} // namespace
+
 
 EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
 {
@@ -116,5 +242,97 @@ EZ_CREATE_SIMPLE_TEST(Image, ImageUtils)
     EZ_TEST_INT(uiError, 1433);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Scale3D")
+  {
+    ezImageFilterTriangle triangleFilter;
+    ezImageFilterSincWithKaiserWindow kaiserFilter;
+
+    const ezImageAddressMode::Enum addressModes[] = {
+      ezImageAddressMode::Clamp, ezImageAddressMode::Repeat, ezImageAddressMode::Mirror, ezImageAddressMode::ClampBorder};
+
+    for (ezImageAddressMode::Enum addressMode : addressModes)
+    {
+      // down in x, up in y
+      TestScale3D(37, 23, 1, 16, 50, 1, triangleFilter, addressMode);
+      TestScale3D(37, 23, 1, 16, 50, 1, kaiserFilter, addressMode);
+
+      // large enough to be split into several tasks
+      TestScale3D(300, 200, 1, 150, 100, 1, triangleFilter, addressMode);
+
+      // volume, only depth and all axes
+      TestScale3D(6, 5, 8, 6, 5, 3, triangleFilter, addressMode);
+      TestScale3D(6, 5, 8, 4, 9, 3, kaiserFilter, addressMode);
+    }
+  }
+
   ezFileSystem::RemoveDataDirectoryGroup("ImageTest");
 }
+
+EZ_CREATE_SIMPLE_TEST(Image, Profile_ImageUtils)
+{
+  auto CreateTestImage = [](ezImage& out_Image, ezUInt32 uiSize, ezUInt32 uiNumFaces) {
+    ezImageHeader header;
+    header.SetImageFormat(ezImageFormat::R32G32B32A32_FLOAT);
+    header.SetWidth(uiSize);
+    header.SetHeight(uiSize);
+    header.SetNumFaces(uiNumFaces);
+    out_Image.ResetAndAlloc(header);
+
+    for (ezUInt32 face = 0; face < uiNumFaces; ++face)
+    {
+      for (ezUInt32 y = 0; y < uiSize; ++y)
+      {
+        ezColor* pRow = out_Image.GetPixelPointer<ezColor>(0, face, 0, 0, y);
+        for (ezUInt32 x = 0; x < uiSize; ++x)
+        {
+          pRow[x] = ezColor(static_cast<float>(x) / uiSize, static_cast<float>(y) / uiSize, static_cast<float>((x ^ y) & 255) / 255.0f, 1.0f);
+        }
+      }
+    }
+  };
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "GenerateMipMaps")
+  {
+    ezImage source;
+    CreateTestImage(source, 4096, 1);
+
+    ezImage target;
+    ezStopwatch sw;
+    ezImageUtils::GenerateMipMaps(source, target, ezImageUtils::MipMapOptions());
+    ezTestFramework::Output(ezTestOutput::Duration, "GenerateMipMaps 4096x4096: %.2fms", sw.Checkpoint().GetMilliseconds());
+
+    ezImageFilterSincWithKaiserWindow kaiserFilter;
+    ezImageUtils::MipMapOptions options;
+    options.m_filter = &kaiserFilter;
+
+    ezImageUtils::GenerateMipMaps(source, target, options);
+    ezTestFramework::Output(ezTestOutput::Duration, "GenerateMipMaps 4096x4096 (Kaiser): %.2fms", sw.Checkpoint().GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "GenerateMipMaps Cubemap")
+  {
+    ezImage source;
+    CreateTestImage(source, 1024, 6);
+
+    ezImage target;
+    ezStopwatch sw;
+    ezImageUtils::GenerateMipMaps(source, target, ezImageUtils::MipMapOptions());
+    ezTestFramework::Output(ezTestOutput::Duration, "GenerateMipMaps 6x1024x1024: %.2fms", sw.Checkpoint().GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Scale")
+  {
+    ezImage source;
+    CreateTestImage(source, 4096, 1);
+
+    ezImageFilterSincWithKaiserWindow kaiserFilter;
+
+    ezImage target;
+    ezStopwatch sw;
+    EZ_TEST_BOOL(ezImageUtils::Scale(source, target, 2560, 1440, &kaiserFilter).Succeeded());
+    ezTestFramework::Output(ezTestOutput::Duration, "Scale 4096x4096 to 2560x1440 (Kaiser): %.2fms", sw.Checkpoint().GetMilliseconds());
+
+    EZ_TEST_BOOL(ezImageUtils::Scale(source, target, 3000, 3000).Succeeded());
+    ezTestFramework::Output(ezTestOutput::Duration, "Scale 4096x4096 to 3000x3000: %.2fms", sw.Checkpoint().GetMilliseconds());
+  }
+}
@@ -2,7 +2,11 @@
 
 #include <Foundation/Memory/CommonAllocators.h>
 #include <Foundation/Memory/LargeBlockAllocator.h>
+#include <Foundation/Memory/MemoryTracker.h>
+#include <Foundation/Memory/PageAllocator.h>
 #include <Foundation/Memory/StackAllocator.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
 
 struct EZ_ALIGN(NonAlignedVector, EZ_ALIGNMENT_MINIMUM)
 {
@@ -235,4 +239,348 @@ EZ_CREATE_SIMPLE_TEST(Memory, Allocator)
 
     EZ_TEST_BOOL(ezConstructionCounter::HasDestructed(50));
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ThreadCachingAllocator")
+  {
+    ezThreadCachingAllocator allocator("ThreadCaching", ezFoundation::GetDefaultAllocator());
+
+    // every size class and the transition to large allocations
+    ezDynamicArray<ezUInt8*> allocations;
+    for (ezUInt32 uiSize = 1; uiSize <= 10000; uiSize += (uiSize < 256) ? 1 : 37)
+    {
+      ezUInt8* pData = static_cast<ezUInt8*>(allocator.Allocate(uiSize, EZ_ALIGNMENT_MINIMUM));
+      EZ_TEST_BOOL(pData != nullptr);
+      EZ_TEST_BOOL(ezMemoryUtils::IsAligned(pData, EZ_ALIGNMENT_MINIMUM));
+
+      ezMemoryUtils::PatternFill(pData, static_cast<ezUInt8>(uiSize), uiSize);
+      allocations.PushBack(pData);
+    }
+
+    // no allocation may have overwritten another one
+    ezUInt32 uiNumCorrupted = 0;
+    ezUInt32 uiIndex = 0;
+    for (ezUInt32 uiSize = 1; uiSize <= 10000; uiSize += (uiSize < 256) ? 1 : 37, ++uiIndex)
+    {
+      ezUInt8* pData = allocations[uiIndex];
+      for (ezUInt32 i = 0; i < uiSize; ++i)
+      {
+        if (pData[i] != static_cast<ezUInt8>(uiSize))
+        {
+          ++uiNumCorrupted;
+          break;
+        }
+      }
+
+      allocator.Deallocate(pData);
+    }
+
+    EZ_TEST_INT(uiNumCorrupted, 0);
+
+    EZ_TEST_INT(allocator.GetStats().m_uiNumAllocations - allocator.GetStats().m_uiNumDeallocations, 0);
+
+    // reallocate keeps the contents when growing into larger size classes and into the heap and back
+    ezUInt8* pData = static_cast<ezUInt8*>(allocator.Allocate(16, EZ_ALIGNMENT_MINIMUM));
+    for (ezUInt32 i = 0; i < 16; ++i)
+    {
+      pData[i] = static_cast<ezUInt8>(i);
+    }
+
+    ezUInt32 uiCurrentSize = 16;
+    const ezUInt32 newSizes[] = {20, 100, 4000, 8192, 50000, 200, 32};
+    for (ezUInt32 uiNewSize : newSizes)
+    {
+      pData = static_cast<ezUInt8*>(allocator.Reallocate(pData, uiCurrentSize, uiNewSize, EZ_ALIGNMENT_MINIMUM));
+      uiCurrentSize = uiNewSize;
+
+      for (ezUInt32 i = 0; i < 16; ++i)
+      {
+        EZ_TEST_INT(pData[i], i);
+      }
+    }
+
+    allocator.Deallocate(pData);
+
+    // memory that is allocated on one thread and freed on another goes back through the central free lists
+    constexpr ezUInt32 uiNumAllocations = 1024 * 32;
+    ezDynamicArray<void*> crossThreadAllocations;
+    crossThreadAllocations.SetCount(uiNumAllocations);
+
+    ezParallelForParams params;
+    params.uiBinSize = 256;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumAllocations,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          const ezUInt32 uiSize = 8 + (i * 7) % 512;
+          crossThreadAllocations[i] = allocator.Allocate(uiSize, EZ_ALIGNMENT_MINIMUM);
+          ezMemoryUtils::PatternFill(static_cast<ezUInt8*>(crossThreadAllocations[i]), static_cast<ezUInt8>(i), uiSize);
+        }
+      },
+      "AllocateOnManyThreads", params);
+
+    ezAtomicInteger32 iNumCorrupted = 0;
+    ezTaskSystem::ParallelForIndexed(0, uiNumAllocations,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        // the reversed order makes it likely that another thread frees the memory
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          const ezUInt32 uiAllocation = uiNumAllocations - 1 - i;
+          const ezUInt32 uiSize = 8 + (uiAllocation * 7) % 512;
+          const ezUInt8* pAllocation = static_cast<const ezUInt8*>(crossThreadAllocations[uiAllocation]);
+
+          if (pAllocation[0] != static_cast<ezUInt8>(uiAllocation) || pAllocation[uiSize - 1] != static_cast<ezUInt8>(uiAllocation))
+          {
+            iNumCorrupted.Increment();
+          }
+
+          allocator.Deallocate(crossThreadAllocations[uiAllocation]);
+        }
+      },
+      "DeallocateOnManyThreads", params);
+
+    EZ_TEST_INT(iNumCorrupted, 0);
+    EZ_TEST_INT(allocator.GetStats().m_uiNumAllocations - allocator.GetStats().m_uiNumDeallocations, 0);
+
+    // chunks of spans that are no longer used go back to the page allocator
+    {
+      const ezUInt64 uiPageMemoryBefore = ezMemoryTracker::GetAllocatorStats(ezPageAllocator::GetId()).m_uiAllocationSize;
+
+      // 16 MB in blocks of the 4 KB size class
+      ezDynamicArray<void*> blocks;
+      blocks.SetCount(4096);
+      for (void*& pBlock : blocks)
+      {
+        pBlock = allocator.Allocate(4000, EZ_ALIGNMENT_MINIMUM);
+      }
+
+      const ezUInt64 uiPageMemoryPeak = ezMemoryTracker::GetAllocatorStats(ezPageAllocator::GetId()).m_uiAllocationSize;
+      EZ_TEST_BOOL(uiPageMemoryPeak >= uiPageMemoryBefore + 8 * 1024 * 1024);
+
+      for (void* pBlock : blocks)
+      {
+        allocator.Deallocate(pBlock);
+      }
+
+      // other threads use the same heap, the thread cache keeps a few blocks and the depot keeps one empty chunk
+      const ezUInt64 uiPageMemoryAfter = ezMemoryTracker::GetAllocatorStats(ezPageAllocator::GetId()).m_uiAllocationSize;
+      EZ_TEST_BOOL(uiPageMemoryAfter <= uiPageMemoryBefore + 4 * 1024 * 1024);
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(Memory, MemoryTracker)
+{
+  typedef ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>
+    TrackedAllocator;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Multi-threaded tracking")
+  {
+    TrackedAllocator allocator("TrackerTest");
+
+    constexpr ezUInt32 uiNumAllocations = 1024 * 16;
+    ezDynamicArray<void*> allocations;
+    allocations.SetCount(uiNumAllocations);
+
+    ezParallelForParams params;
+    params.uiBinSize = 256;
+
+    ezTaskSystem::ParallelForIndexed(0, uiNumAllocations,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          allocations[i] = allocator.Allocate(1 + i % 100, EZ_ALIGNMENT_MINIMUM);
+        }
+      },
+      "TrackAllocations", params);
+
+    ezUInt64 uiExpectedSize = 0;
+    for (ezUInt32 i = 0; i < uiNumAllocations; ++i)
+    {
+      uiExpectedSize += 1 + i % 100;
+    }
+
+    ezAllocatorBase::Stats stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, uiNumAllocations);
+    EZ_TEST_INT(stats.m_uiNumDeallocations, 0);
+    EZ_TEST_INT(stats.m_uiAllocationSize, uiExpectedSize);
+
+    ezAtomicInteger32 iNumWrongSizes = 0;
+    ezTaskSystem::ParallelForIndexed(0, uiNumAllocations,
+      [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+        {
+          if (allocator.AllocatedSize(allocations[i]) != 1 + i % 100)
+          {
+            iNumWrongSizes.Increment();
+          }
+
+          allocator.Deallocate(allocations[i]);
+        }
+      },
+      "UntrackAllocations", params);
+
+    EZ_TEST_INT(iNumWrongSizes, 0);
+
+    stats = allocator.GetStats();
+    EZ_TEST_INT(stats.m_uiNumAllocations, uiNumAllocations);
+    EZ_TEST_INT(stats.m_uiNumDeallocations, uiNumAllocations);
+    EZ_TEST_INT(stats.m_uiAllocationSize, 0);
+
+    // the iterator reports the same stats
+    bool bFound = false;
+    for (auto it = ezMemoryTracker::GetIterator(); it.IsValid(); ++it)
+    {
+      if (it.Id() == allocator.GetId())
+      {
+        bFound = true;
+        EZ_TEST_INT(it.Stats().m_uiNumAllocations, uiNumAllocations);
+        EZ_TEST_INT(it.Stats().m_uiAllocationSize, 0);
+      }
+    }
+
+    EZ_TEST_BOOL(bFound);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Stack trace sampling")
+  {
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::All> allocator("TrackerSamplingTest");
+
+    const ezUInt32 uiPrevRate = ezMemoryTracker::GetStackTraceSamplingRate();
+    ezMemoryTracker::SetStackTraceSamplingRate(8);
+    EZ_TEST_INT(ezMemoryTracker::GetStackTraceSamplingRate(), 8);
+
+    void* allocations[64];
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(allocations); ++i)
+    {
+      allocations[i] = allocator.Allocate(32, EZ_ALIGNMENT_MINIMUM);
+    }
+
+    ezMemoryTracker::SetStackTraceSamplingRate(uiPrevRate);
+
+    // all allocations are tracked, but only every 8th one on this thread has a stack trace (if the platform supports them)
+    ezUInt32 uiNumStackTraces = 0;
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(allocations); ++i)
+    {
+      const ezMemoryTracker::AllocationInfo& info = ezMemoryTracker::GetAllocationInfo(allocator.GetId(), allocations[i]);
+      EZ_TEST_INT(info.m_uiSize, 32);
+
+      if (info.m_uiStackTraceLength > 0)
+      {
+        ++uiNumStackTraces;
+      }
+    }
+
+    EZ_TEST_BOOL(uiNumStackTraces <= EZ_ARRAY_SIZE(allocations) / 8 + 1);
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(allocations); ++i)
+    {
+      allocator.Deallocate(allocations[i]);
+    }
+
+    EZ_TEST_INT(allocator.GetStats().m_uiAllocationSize, 0);
+  }
+}
+
+namespace
+{
+  /// \brief Allocates and frees many small blocks on all worker threads, half of them are freed by another task than the one
+  /// that allocated them.
+  ezTime MeasureMultiThreadedAllocations(ezAllocatorBase* pAllocator)
+  {
+    constexpr ezUInt32 uiNumTasks = 64;
+    constexpr ezUInt32 uiNumAllocationsPerTask = 2048;
+    constexpr ezUInt32 uiNumIterations = 50;
+
+    ezDynamicArray<void*> allocations;
+    allocations.SetCount(uiNumTasks * uiNumAllocationsPerTask);
+
+    for (ezUInt32 i = 0; i < allocations.GetCount(); ++i)
+    {
+      allocations[i] = pAllocator->Allocate(16 + (i * 13) % 240, EZ_ALIGNMENT_MINIMUM);
+    }
+
+    ezParallelForParams params;
+    params.uiBinSize = 1;
+    params.uiMaxTasksPerThread = 0xFFFF;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 uiIteration = 0; uiIteration < uiNumIterations; ++uiIteration)
+    {
+      ezTaskSystem::ParallelForIndexed(0, uiNumTasks,
+        [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 uiTask = uiStartIndex; uiTask < uiEndIndex; ++uiTask)
+          {
+            void** pTaskAllocations = allocations.GetData() + uiTask * uiNumAllocationsPerTask;
+
+            // free the allocations of another task from the previous iteration
+            void** pOtherAllocations = allocations.GetData() + (uiNumTasks - 1 - uiTask) * uiNumAllocationsPerTask;
+            for (ezUInt32 i = 0; i < uiNumAllocationsPerTask / 2; ++i)
+            {
+              pAllocator->Deallocate(pOtherAllocations[i]);
+            }
+
+            for (ezUInt32 i = uiNumAllocationsPerTask / 2; i < uiNumAllocationsPerTask; ++i)
+            {
+              pAllocator->Deallocate(pTaskAllocations[i]);
+            }
+
+            for (ezUInt32 i = uiNumAllocationsPerTask / 2; i < uiNumAllocationsPerTask; ++i)
+            {
+              pTaskAllocations[i] = pAllocator->Allocate(16 + (i * 13) % 240, EZ_ALIGNMENT_MINIMUM);
+            }
+          }
+        },
+        "AllocatorBenchmark", params);
+
+      // the first half of every task is reallocated serially, so that the tasks above free memory from other threads
+      for (ezUInt32 uiTask = 0; uiTask < uiNumTasks; ++uiTask)
+      {
+        for (ezUInt32 i = 0; i < uiNumAllocationsPerTask / 2; ++i)
+        {
+          allocations[uiTask * uiNumAllocationsPerTask + i] = pAllocator->Allocate(16 + (i * 13) % 240, EZ_ALIGNMENT_MINIMUM);
+        }
+      }
+    }
+
+    const ezTime duration = sw.GetRunningTotal();
+
+    for (void* ptr : allocations)
+    {
+      pAllocator->Deallocate(ptr);
+    }
+
+    return duration;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Memory, Profile_Allocator)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Multi-threaded small allocations")
+  {
+    ezHeapAllocator heapAllocator("ProfileHeap", ezFoundation::GetDefaultAllocator());
+    ezThreadCachingAllocator threadCachingAllocator("ProfileThreadCaching", ezFoundation::GetDefaultAllocator());
+
+    const ezTime heapTime = MeasureMultiThreadedAllocations(&heapAllocator);
+    const ezTime threadCachingTime = MeasureMultiThreadedAllocations(&threadCachingAllocator);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "ezHeapAllocator: %.2f ms", heapTime.GetMilliseconds());
+    ezTestFramework::Output(ezTestOutput::Duration, "ezThreadCachingAllocator: %.2f ms (%.1fx)", threadCachingTime.GetMilliseconds(),
+      heapTime.GetSeconds() / ezMath::Max(threadCachingTime.GetSeconds(), 0.0001));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Multi-threaded tracked allocations")
+  {
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator> untrackedAllocator(
+      "ProfileUntracked", ezFoundation::GetDefaultAllocator());
+    ezAllocator<ezMemoryPolicies::ezHeapAllocation, ezMemoryTrackingFlags::RegisterAllocator | ezMemoryTrackingFlags::EnableAllocationTracking>
+      trackedAllocator("ProfileTracked", ezFoundation::GetDefaultAllocator());
+
+    const ezTime untrackedTime = MeasureMultiThreadedAllocations(&untrackedAllocator);
+    const ezTime trackedTime = MeasureMultiThreadedAllocations(&trackedAllocator);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Without tracking: %.2f ms", untrackedTime.GetMilliseconds());
+    ezTestFramework::Output(ezTestOutput::Duration, "With tracking: %.2f ms", trackedTime.GetMilliseconds());
+  }
 }
@@ -0,0 +1,108 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Strings/HashedString.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace
+{
+  enum HashedStringConstants
+  {
+    NUM_STRINGS = 2000,
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_ITERATIONS = 2,
+#else
+    NUM_ITERATIONS = 20,
+#endif
+  };
+
+  class AssignThread : public ezThread
+  {
+  public:
+    AssignThread(const ezDynamicArray<ezString>& strings)
+      : ezThread("HashedString Assign Thread")
+      , m_Strings(strings)
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      ezHashedString s;
+
+      for (ezUInt32 i = 0; i < NUM_ITERATIONS; ++i)
+      {
+        for (const ezString& str : m_Strings)
+        {
+          s.Assign(str.GetData());
+        }
+      }
+
+      return 0;
+    }
+
+  private:
+    const ezDynamicArray<ezString>& m_Strings;
+  };
+
+  ezTime RunAssignThreads(const ezDynamicArray<ezDynamicArray<ezString>>& strings, ezUInt32 uiNumThreads)
+  {
+    ezDynamicArray<ezUniquePtr<AssignThread>> threads;
+    for (ezUInt32 t = 0; t < uiNumThreads; ++t)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(AssignThread, strings[t]));
+    }
+
+    ezStopwatch sw;
+
+    for (auto& pThread : threads)
+    {
+      pThread->Start();
+    }
+
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+    }
+
+    return sw.GetRunningTotal();
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Performance, HashedString)
+{
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Assign Contention")
+  {
+    const ezUInt32 uiMaxThreads = ezMath::Clamp(ezSystemInformation::Get().GetCPUCoreCount(), 1u, 32u);
+
+    // half of the strings are shared between all threads, which is the common case for the names of types, properties and resources
+    ezDynamicArray<ezDynamicArray<ezString>> strings;
+    strings.SetCount(uiMaxThreads);
+
+    for (ezUInt32 t = 0; t < uiMaxThreads; ++t)
+    {
+      for (ezUInt32 i = 0; i < NUM_STRINGS; ++i)
+      {
+        ezStringBuilder sb;
+        sb.Format("ContentionTestString_{0}_{1}", (i % 2 == 0) ? 0 : t + 1, i);
+        strings[t].PushBack(sb);
+      }
+    }
+
+    // create all strings up front, this measures the lookup of existing strings
+    RunAssignThreads(strings, uiMaxThreads);
+
+    // 1, 2, 4, ... up to the number of CPU cores
+    for (ezUInt32 uiThreads = 1;; uiThreads = ezMath::Min(uiThreads * 2, uiMaxThreads))
+    {
+      const ezTime t = RunAssignThreads(strings, uiThreads);
+      const double fNanosecondsPerAssign = t.GetNanoseconds() / (NUM_ITERATIONS * NUM_STRINGS);
+
+      ezLog::Info("[test]{0} Threads: {1}ms, {2}ns per Assign and thread", uiThreads, ezArgF(t.GetMilliseconds(), 2), ezArgF(fNanosecondsPerAssign, 1));
+
+      if (uiThreads == uiMaxThreads)
+        break;
+    }
+  }
+}
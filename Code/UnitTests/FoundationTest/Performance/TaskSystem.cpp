@@ -0,0 +1,268 @@
+#include <FoundationTestPCH.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/System/SystemInformation.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Time.h>
+
+namespace
+{
+  enum TaskSystemConstants
+  {
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+    NUM_ROUNDS = 20,
+#else
+    NUM_ROUNDS = 200,
+#endif
+    TASKS_PER_ROUND = 512,
+    NUM_SPAWNERS = 8
+  };
+
+  /// Does a tiny amount of work per invocation, so that the scheduling overhead dominates.
+  class ezTinyTask final : public ezTask
+  {
+  public:
+    ezTinyTask() { ConfigureTask("ezTinyTask", ezTaskNesting::Never); }
+
+    mutable ezUInt32 m_Results[TASKS_PER_ROUND];
+
+  private:
+    virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override
+    {
+      ezUInt32 x = uiInvocation;
+      for (ezUInt32 i = 0; i < 64; ++i)
+      {
+        x = x * 1664525u + 1013904223u;
+      }
+
+      m_Results[uiInvocation] = x;
+    }
+  };
+
+  /// Schedules its tiny tasks from inside a worker thread, which is where work stealing pays off.
+  class ezFanOutTask final : public ezTask
+  {
+  public:
+    ezFanOutTask() { ConfigureTask("ezFanOutTask", ezTaskNesting::Maybe); }
+
+    ezTinyTask m_Children;
+
+  private:
+    virtual void Execute() override
+    {
+      m_Children.SetMultiplicity(TASKS_PER_ROUND / NUM_SPAWNERS);
+      ezTaskGroupID tg = ezTaskSystem::StartSingleTask(&m_Children, ezTaskPriority::EarlyThisFrame);
+      ezTaskSystem::WaitForGroup(tg);
+    }
+  };
+
+  double MeasureTasksPerSecond(ezTaskSchedulerMode::Enum mode, ezUInt32 uiWorkers, bool bFanOut)
+  {
+    ezTaskSystem::SetSchedulerMode(mode);
+    ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiWorkers), 2);
+
+    ezTinyTask tiny;
+    ezFanOutTask fanOut[NUM_SPAWNERS];
+    ezTaskGroupID tg[NUM_SPAWNERS];
+
+    ezUInt32 uiNumTasks = 0;
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 round = 0; round < NUM_ROUNDS; ++round)
+    {
+      if (bFanOut)
+      {
+        for (ezUInt32 i = 0; i < NUM_SPAWNERS; ++i)
+        {
+          tg[i] = ezTaskSystem::StartSingleTask(&fanOut[i], ezTaskPriority::EarlyThisFrame);
+        }
+
+        for (ezUInt32 i = 0; i < NUM_SPAWNERS; ++i)
+        {
+          ezTaskSystem::WaitForGroup(tg[i]);
+        }
+
+        uiNumTasks += NUM_SPAWNERS * (1 + TASKS_PER_ROUND / NUM_SPAWNERS);
+      }
+      else
+      {
+        tiny.SetMultiplicity(TASKS_PER_ROUND);
+        tg[0] = ezTaskSystem::StartSingleTask(&tiny, ezTaskPriority::EarlyThisFrame);
+        ezTaskSystem::WaitForGroup(tg[0]);
+
+        uiNumTasks += TASKS_PER_ROUND;
+      }
+    }
+
+    const ezTime tDiff = ezTime::Now() - tStart;
+
+    EZ_TEST_BOOL(tiny.IsTaskFinished());
+
+    return uiNumTasks / ezMath::Max(tDiff.GetSeconds(), 0.000001);
+  }
+
+  enum class ezSkew
+  {
+    None,       ///< All items cost the same.
+    FrontHeavy, ///< The first few percent of the items are 100 times as expensive as the rest.
+    Random,     ///< Every 16th item (in a pseudo random pattern) is 50 times as expensive.
+  };
+
+  EZ_FORCE_INLINE ezUInt32 SimulateWork(ezUInt32 uiIndex, ezSkew skew)
+  {
+    ezUInt32 uiIterations = 16;
+
+    if (skew == ezSkew::FrontHeavy && uiIndex < 1024)
+      uiIterations *= 100;
+    else if (skew == ezSkew::Random && ((uiIndex * 2654435761u) >> 28) == 0)
+      uiIterations *= 50;
+
+    ezUInt32 x = uiIndex;
+    for (ezUInt32 i = 0; i < uiIterations; ++i)
+    {
+      x = x * 1664525u + 1013904223u;
+    }
+
+    return x;
+  }
+
+  ezTime MeasureParallelFor(ezParallelForPartitioning::Enum partitioning, ezSkew skew, ezArrayPtr<ezUInt32> results)
+  {
+    ezParallelForParams params;
+    params.uiBinSize = 64;
+    params.partitioning = partitioning;
+
+    const ezTime tStart = ezTime::Now();
+
+    for (ezUInt32 round = 0; round < NUM_ROUNDS / 4; ++round)
+    {
+      ezTaskSystem::ParallelForIndexed(0, results.GetCount(),
+        [&results, skew](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+          for (ezUInt32 i = uiStartIndex; i < uiEndIndex; ++i)
+          {
+            results[i] = SimulateWork(i, skew);
+          }
+        },
+        "SkewedParallelFor", params);
+    }
+
+    return ezTime::Now() - tStart;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Performance, TaskSystem)
+{
+  const ezUInt32 uiPrevShortWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks);
+  const ezUInt32 uiPrevLongWorkers = ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks);
+  const ezTaskSchedulerMode::Enum prevMode = ezTaskSystem::GetSchedulerMode();
+
+  // 1, 2, 4, ... up to the number of CPU cores
+  const ezUInt32 uiMaxWorkers = ezMath::Clamp(ezSystemInformation::Get().GetCPUCoreCount(), 1u, 32u);
+  ezHybridArray<ezUInt32, 8> workerCounts;
+  for (ezUInt32 uiWorkers = 1; uiWorkers < uiMaxWorkers; uiWorkers *= 2)
+  {
+    workerCounts.PushBack(uiWorkers);
+  }
+  workerCounts.PushBack(uiMaxWorkers);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Tasks per Second")
+  {
+    for (ezUInt32 uiWorkers : workerCounts)
+    {
+      const double fShared = MeasureTasksPerSecond(ezTaskSchedulerMode::SharedQueues, uiWorkers, false);
+      const double fStealing = MeasureTasksPerSecond(ezTaskSchedulerMode::WorkStealing, uiWorkers, false);
+
+      ezLog::Info("[test]{0} Workers, Main Thread Tasks: {1} tasks/sec (shared queues), {2} tasks/sec (work stealing)", uiWorkers, ezArgF(fShared, 0), ezArgF(fStealing, 0));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Tasks per Second (Fan Out)")
+  {
+    for (ezUInt32 uiWorkers : workerCounts)
+    {
+      const double fShared = MeasureTasksPerSecond(ezTaskSchedulerMode::SharedQueues, uiWorkers, true);
+      const double fStealing = MeasureTasksPerSecond(ezTaskSchedulerMode::WorkStealing, uiWorkers, true);
+
+      ezLog::Info("[test]{0} Workers, Nested Tasks: {1} tasks/sec (shared queues), {2} tasks/sec (work stealing)", uiWorkers, ezArgF(fShared, 0), ezArgF(fStealing, 0));
+    }
+  }
+
+  ezTaskSystem::SetSchedulerMode(prevMode);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelFor (Skewed Workload)")
+  {
+    ezDynamicArray<ezUInt32> results;
+    results.SetCount(64 * 1024);
+
+    const char* szSkewNames[] = {"uniform", "front heavy", "random"};
+
+    for (ezUInt32 uiWorkers : workerCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiWorkers), 2);
+
+      for (ezUInt32 skew = 0; skew < EZ_ARRAY_SIZE(szSkewNames); ++skew)
+      {
+        const ezTime tStatic = MeasureParallelFor(ezParallelForPartitioning::Static, static_cast<ezSkew>(skew), results.GetArrayPtr());
+        const ezTime tAdaptive = MeasureParallelFor(ezParallelForPartitioning::Adaptive, static_cast<ezSkew>(skew), results.GetArrayPtr());
+
+        ezLog::Info("[test]{0} Workers, {1} items: {2}ms (static), {3}ms (adaptive)", uiWorkers, szSkewNames[skew], ezArgF(tStatic.GetMilliseconds(), 2), ezArgF(tAdaptive.GetMilliseconds(), 2));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ParallelReduce / ParallelPrefixSum")
+  {
+    ezDynamicArray<ezUInt32> input;
+    ezDynamicArray<ezUInt32> output;
+    input.SetCount(4 * 1024 * 1024);
+    output.SetCount(input.GetCount());
+
+    for (ezUInt32 i = 0; i < input.GetCount(); ++i)
+    {
+      input[i] = i & 0xFF;
+    }
+
+    ezParallelForParams params;
+    params.uiBinSize = 4096;
+
+    for (ezUInt32 uiWorkers : workerCounts)
+    {
+      ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiWorkers), 2);
+
+      ezUInt64 uiSum = 0;
+      ezTime tStart = ezTime::Now();
+      for (ezUInt32 round = 0; round < NUM_ROUNDS / 4; ++round)
+      {
+        uiSum += ezTaskSystem::ParallelReduce<ezUInt64, ezUInt32>(
+          input.GetArrayPtr(), 0,
+          [](ezArrayPtr<ezUInt32> taskItemSlice, ezUInt64& inout_uiSum) {
+            for (ezUInt32 uiValue : taskItemSlice)
+            {
+              inout_uiSum += uiValue;
+            }
+          },
+          [](ezUInt64 a, ezUInt64 b) { return a + b; }, "BenchmarkReduce", params);
+      }
+      const ezTime tReduce = ezTime::Now() - tStart;
+
+      tStart = ezTime::Now();
+      for (ezUInt32 round = 0; round < NUM_ROUNDS / 4; ++round)
+      {
+        ezTaskSystem::ParallelPrefixSum(input.GetArrayPtr(), output.GetArrayPtr(), 0, [](ezUInt32 a, ezUInt32 b) { return a + b; }, "BenchmarkPrefixSum", params);
+      }
+      const ezTime tPrefixSum = ezTime::Now() - tStart;
+
+      EZ_TEST_BOOL(uiSum > 0);
+
+      ezLog::Info("[test]{0} Workers, {1} items: {2}ms (reduce), {3}ms (prefix sum)", uiWorkers, input.GetCount(), ezArgF(tReduce.GetMilliseconds(), 2), ezArgF(tPrefixSum.GetMilliseconds(), 2));
+    }
+  }
+
+  if (uiPrevShortWorkers > 0)
+  {
+    ezTaskSystem::SetWorkerThreadCount(static_cast<ezInt8>(uiPrevShortWorkers), static_cast<ezInt8>(uiPrevLongWorkers));
+  }
+}
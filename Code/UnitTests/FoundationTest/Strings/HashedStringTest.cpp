@@ -1,6 +1,41 @@
 #include <FoundationTestPCH.h>
 
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Thread.h>
+#include <Foundation/Types/UniquePtr.h>
+
+namespace
+{
+  class HashedStringTestThread : public ezThread
+  {
+  public:
+    HashedStringTestThread(const ezDynamicArray<ezString>& strings, ezUInt32 uiNumIterations)
+      : ezThread("HashedString Test Thread")
+      , m_Strings(strings)
+      , m_uiNumIterations(uiNumIterations)
+    {
+    }
+
+    virtual ezUInt32 Run() override
+    {
+      ezHashedString s;
+
+      for (ezUInt32 i = 0; i < m_uiNumIterations; ++i)
+      {
+        for (const ezString& str : m_Strings)
+        {
+          s.Assign(str.GetData());
+        }
+      }
+
+      return 0;
+    }
+
+  private:
+    const ezDynamicArray<ezString>& m_Strings;
+    ezUInt32 m_uiNumIterations;
+  };
+} // namespace
 
 EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
 {
@@ -45,6 +80,58 @@ EZ_CREATE_SIMPLE_TEST(Strings, HashedString)
     EZ_TEST_INT(ts.GetHash(), 0x77e1287c);
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "EZ_HASHED_STRING")
+  {
+    const ezHashedString& s = EZ_HASHED_STRING("Test");
+    EZ_TEST_STRING(s.GetString().GetData(), "Test");
+    EZ_TEST_INT(s.GetHash(), 0x949e89d1);
+
+    ezHashedString s2;
+    s2.Assign("Test");
+    EZ_TEST_BOOL(s == s2);
+
+    // every call site has its own static, but they all reference the same string
+    for (ezUInt32 i = 0; i < 2; ++i)
+    {
+      EZ_TEST_BOOL(EZ_HASHED_STRING("Test") == s2);
+      EZ_TEST_BOOL(&EZ_HASHED_STRING("Test") != &s);
+    }
+
+    EZ_TEST_BOOL(EZ_HASHED_STRING("").IsEmpty());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Assign from several threads")
+  {
+    ezDynamicArray<ezString> strings;
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      ezStringBuilder sb;
+      sb.Format("MultiThreadedString{0}", i);
+      strings.PushBack(sb);
+    }
+
+    ezDynamicArray<ezUniquePtr<HashedStringTestThread>> threads;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      threads.PushBack(EZ_DEFAULT_NEW(HashedStringTestThread, strings, 10));
+      threads.PeekBack()->Start();
+    }
+
+    for (auto& pThread : threads)
+    {
+      pThread->Join();
+    }
+
+    // all threads have to end up with the same data
+    for (const ezString& str : strings)
+    {
+      ezHashedString s;
+      s.Assign(str.GetData());
+      EZ_TEST_STRING(s.GetData(), str.GetData());
+      EZ_TEST_BOOL(s == ezTempHashedString(str.GetData()));
+    }
+  }
+
   EZ_TEST_BLOCK(ezTestBlock::Enabled, "operator== / operator!=")
   {
     ezHashedString s1, s2, s3, s4;
@@ -1,7 +1,9 @@
 #include <FoundationTestPCH.h>
 
+#include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/StaticArray.h>
 #include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Threading/ThreadUtils.h>
 
 namespace
 {
@@ -204,4 +206,137 @@ EZ_CREATE_SIMPLE_TEST(Threading, ParallelFor)
     // check the resulting sum
     EZ_TEST_INT(uiNumbersSum, 4 * uiNumbersCheckSum);
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Indexed, Adaptive)")
+  {
+    ezDynamicArray<ezUInt32> visits;
+    visits.SetCount(10000, 0);
+
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.uiBinSize = 16;
+    adaptiveParams.partitioning = ezParallelForPartitioning::Adaptive;
+
+    // every index must be visited exactly once, no matter how the ranges get split
+    ezTaskSystem::ParallelForIndexed(0, visits.GetCount(),
+      [&visits](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) {
+        EZ_TEST_BOOL(uiStartIndex < uiEndIndex);
+
+        for (ezUInt32 uiIndex = uiStartIndex; uiIndex < uiEndIndex; ++uiIndex)
+        {
+          // make the items at the start very expensive, so that the other ranges have to take over
+          if (uiIndex < 64)
+          {
+            ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+          }
+
+          visits[uiIndex] += 1;
+        }
+      },
+      "ParallelForIndexed Adaptive Test", adaptiveParams);
+
+    for (ezUInt32 uiIndex = 0; uiIndex < visits.GetCount(); ++uiIndex)
+    {
+      EZ_TEST_INT(visits[uiIndex], 1);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel For (Array, Single, Index, Adaptive)")
+  {
+    // reset
+    ResetSharedVariables();
+
+    ezParallelForParams adaptiveParams;
+    adaptiveParams.partitioning = ezParallelForPartitioning::Adaptive;
+
+    ezTaskSystem::ParallelForSingleIndex(numbers.GetArrayPtr(),
+      [&dataAccessMutex, &uiNumbersSum](ezUInt32 uiIndex, ezUInt32 uiNumber) {
+        EZ_LOCK(dataAccessMutex);
+        uiNumbersSum += uiNumber + (uiIndex + 1);
+      },
+      "ParallelFor Array Single Index Adaptive Test", adaptiveParams);
+
+    // check the resulting sum
+    EZ_TEST_INT(uiNumbersSum, 2 * uiNumbersCheckSum);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Reduce")
+  {
+    // reset
+    ResetSharedVariables();
+
+    const ezUInt32 uiSum = ezTaskSystem::ParallelReduce<ezUInt32, ezUInt32>(
+      numbers.GetArrayPtr(), 0u,
+      [](ezArrayPtr<ezUInt32> taskItemSlice, ezUInt32& inout_uiSum) {
+        for (ezUInt32 uiNumber : taskItemSlice)
+        {
+          inout_uiSum += uiNumber;
+        }
+      },
+      [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelReduce Test");
+
+    EZ_TEST_INT(uiSum, uiNumbersCheckSum);
+
+    const ezUInt32 uiMax = ezTaskSystem::ParallelReduce<ezUInt32, ezUInt32>(
+      numbers.GetArrayPtr(), 0u,
+      [](ezArrayPtr<ezUInt32> taskItemSlice, ezUInt32& inout_uiMax) {
+        for (ezUInt32 uiNumber : taskItemSlice)
+        {
+          inout_uiMax = ezMath::Max(inout_uiMax, uiNumber);
+        }
+      },
+      [](ezUInt32 a, ezUInt32 b) { return ezMath::Max(a, b); }, "ParallelReduce Max Test");
+
+    EZ_TEST_INT(uiMax, ::s_uiTotalNumberOfTaskItems);
+
+    // an empty range results in the identity
+    const ezUInt32 uiEmpty = ezTaskSystem::ParallelReduce<ezUInt32, ezUInt32>(
+      ezArrayPtr<ezUInt32>(), 42u, [](ezArrayPtr<ezUInt32> taskItemSlice, ezUInt32& inout_uiSum) {}, [](ezUInt32 a, ezUInt32 b) { return a + b; });
+
+    EZ_TEST_INT(uiEmpty, 42);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Parallel Prefix Sum")
+  {
+    ezDynamicArray<ezUInt32> input;
+    ezDynamicArray<ezUInt32> output;
+
+    for (ezUInt32 uiNumItems : {0u, 1u, 7u, 1000u, 12345u})
+    {
+      input.SetCount(uiNumItems);
+      output.SetCount(uiNumItems);
+
+      for (ezUInt32 i = 0; i < uiNumItems; ++i)
+      {
+        input[i] = (i * 7) % 13;
+      }
+
+      ezTaskSystem::ParallelPrefixSum(input.GetArrayPtr(), output.GetArrayPtr(), 0, [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelPrefixSum Test");
+
+      ezUInt32 uiExpected = 0;
+      for (ezUInt32 i = 0; i < uiNumItems; ++i)
+      {
+        uiExpected += input[i];
+        EZ_TEST_INT(output[i], uiExpected);
+      }
+
+      // const input
+      const ezDynamicArray<ezUInt32>& constInput = input;
+      ezDynamicArray<ezUInt64> output64;
+      output64.SetCount(uiNumItems);
+      ezTaskSystem::ParallelPrefixSum(constInput.GetArrayPtr(), output64.GetArrayPtr(), 0, [](ezUInt64 a, ezUInt32 b) { return a + b; }, "ParallelPrefixSum Const Test");
+
+      for (ezUInt32 i = 0; i < uiNumItems; ++i)
+      {
+        EZ_TEST_INT(output64[i], output[i]);
+      }
+
+      // in place
+      ezTaskSystem::ParallelPrefixSum(input.GetArrayPtr(), input.GetArrayPtr(), 0, [](ezUInt32 a, ezUInt32 b) { return a + b; }, "ParallelPrefixSum In-Place Test");
+
+      for (ezUInt32 i = 0; i < uiNumItems; ++i)
+      {
+        EZ_TEST_INT(input[i], output[i]);
+      }
+    }
+  }
 }
@@ -2,6 +2,7 @@
 
 #include <Foundation/IO/FileSystem/DataDirTypeFolder.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/System/SystemInformation.h>
 #include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Time.h>
 #include <Foundation/Utilities/DGMLWriter.h>
@@ -66,6 +67,84 @@ private:
   }
 };
 
+class ezSpawnerTask final : public ezTask
+{
+public:
+  ezSpawnerTask() { ConfigureTask("ezSpawnerTask", ezTaskNesting::Maybe); }
+
+  ezTestTask m_Children;
+
+private:
+  virtual void Execute() override
+  {
+    // the children get scheduled on the worker thread that executes this task
+    ezTaskGroupID tg = ezTaskSystem::StartSingleTask(&m_Children, ezTaskPriority::EarlyThisFrame);
+    ezTaskSystem::WaitForGroup(tg);
+  }
+};
+
+class ezCancelingSpawnerTask final : public ezTask
+{
+public:
+  ezCancelingSpawnerTask() { ConfigureTask("ezCancelingSpawnerTask", ezTaskNesting::Maybe); }
+
+  ezTestTask m_Children[16];
+  bool m_bChildCanceled[16] = {};
+
+private:
+  virtual void Execute() override
+  {
+    ezTaskGroupID tg[EZ_ARRAY_SIZE(m_Children)];
+
+    // with work stealing, the children end up in the deque of the worker that executes this task
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(m_Children); ++i)
+    {
+      m_Children[i].m_uiIterations = 5;
+      tg[i] = ezTaskSystem::StartSingleTask(&m_Children[i], ezTaskPriority::EarlyThisFrame);
+    }
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(m_Children); ++i)
+    {
+      m_bChildCanceled[i] = ezTaskSystem::CancelTask(&m_Children[i], ezOnTaskRunning::ReturnWithoutBlocking).Succeeded();
+    }
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(m_Children); ++i)
+    {
+      ezTaskSystem::WaitForGroup(tg[i]);
+    }
+  }
+};
+
+class ezChainTask final : public ezTask
+{
+public:
+  ezChainTask() { ConfigureTask("ezChainTask", ezTaskNesting::Maybe); }
+
+  ezChainTask* m_pNext = nullptr;
+  ezTaskPriority::Enum m_Priority = ezTaskPriority::LongRunning;
+  bool m_bNextWasDone = false;
+  bool m_bSameThreadAfterWait = true;
+
+private:
+  virtual void Execute() override
+  {
+    if (m_pNext == nullptr)
+    {
+      ezThreadUtils::Sleep(ezTime::Milliseconds(1));
+      return;
+    }
+
+    // every task in the chain waits for the next one, which needs as many threads as the chain is long, unless waiting tasks get suspended
+    const ezThreadID threadID = ezThreadUtils::GetCurrentThreadID();
+
+    ezTaskGroupID tg = ezTaskSystem::StartSingleTask(m_pNext, m_Priority);
+    ezTaskSystem::WaitForGroup(tg);
+
+    m_bNextWasDone = m_pNext->IsTaskFinished();
+    m_bSameThreadAfterWait = threadID == ezThreadUtils::GetCurrentThreadID();
+  }
+};
+
 class TaskCallbacks
 {
 public:
@@ -557,6 +636,274 @@ EZ_CREATE_SIMPLE_TEST(Threading, TaskSystem)
     EZ_TEST_BOOL(t[2].IsMultiplicityDone());
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Many Groups with Dependencies")
+  {
+    const ezUInt32 uiNumGroups = 2000;
+
+    ezArrayPtr<ezTestTask> tasks = EZ_DEFAULT_NEW_ARRAY(ezTestTask, uiNumGroups);
+    ezDynamicArray<ezTaskGroupID> groups;
+    groups.SetCount(uiNumGroups);
+
+    for (ezUInt32 i = 0; i < uiNumGroups; ++i)
+    {
+      tasks[i].m_uiIterations = 0;
+
+      groups[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(groups[i], &tasks[i]);
+
+      if (i > 0)
+      {
+        // some groups share a dependency, others form chains
+        const ezUInt32 uiDependency = (i * 7919u) % i;
+        tasks[i].m_pDependency = &tasks[uiDependency];
+        ezTaskSystem::AddTaskGroupDependency(groups[i], groups[uiDependency]);
+      }
+    }
+
+    // start in reverse order, so that most dependencies are still pending when the dependent group gets started
+    for (ezUInt32 i = uiNumGroups; i > 0; --i)
+    {
+      ezTaskSystem::StartTaskGroup(groups[i - 1]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumGroups; ++i)
+    {
+      ezTaskSystem::WaitForGroup(groups[i]);
+      EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(groups[i]));
+      EZ_TEST_BOOL(tasks[i].IsDone());
+    }
+
+    EZ_DEFAULT_DELETE_ARRAY(tasks);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "More Groups than Indices")
+  {
+    // the pool can hand out 0xFFFF indexed groups, all further groups are allocated without an index
+    const ezUInt32 uiNumEmptyGroups = 0xFFFF + 100;
+    const ezUInt32 uiNumTaskGroups = 100;
+
+    ezDynamicArray<ezTaskGroupID> emptyGroups;
+    emptyGroups.SetCount(uiNumEmptyGroups);
+
+    for (ezUInt32 i = 0; i < uiNumEmptyGroups; ++i)
+    {
+      emptyGroups[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+    }
+
+    ezArrayPtr<ezTestTask> tasks = EZ_DEFAULT_NEW_ARRAY(ezTestTask, uiNumTaskGroups);
+    ezDynamicArray<ezTaskGroupID> taskGroups;
+    taskGroups.SetCount(uiNumTaskGroups);
+
+    for (ezUInt32 i = 0; i < uiNumTaskGroups; ++i)
+    {
+      tasks[i].m_uiIterations = 0;
+
+      taskGroups[i] = ezTaskSystem::CreateTaskGroup(ezTaskPriority::ThisFrame);
+      ezTaskSystem::AddTaskToGroup(taskGroups[i], &tasks[i]);
+
+      // groups without an index waiting for groups with and without an index
+      ezTaskSystem::AddTaskGroupDependency(taskGroups[i], emptyGroups[i]);
+
+      if (i > 0)
+      {
+        const ezUInt32 uiDependency = (i * 7919u) % i;
+        tasks[i].m_pDependency = &tasks[uiDependency];
+        ezTaskSystem::AddTaskGroupDependency(taskGroups[i], taskGroups[uiDependency]);
+      }
+
+      // groups with an index waiting for groups without one
+      ezTaskSystem::AddTaskGroupDependency(emptyGroups[uiNumTaskGroups + i], taskGroups[i]);
+    }
+
+    for (ezUInt32 i = uiNumTaskGroups; i > 0; --i)
+    {
+      ezTaskSystem::StartTaskGroup(taskGroups[i - 1]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumEmptyGroups; ++i)
+    {
+      ezTaskSystem::StartTaskGroup(emptyGroups[i]);
+    }
+
+    for (ezUInt32 i = 0; i < uiNumTaskGroups; ++i)
+    {
+      ezTaskSystem::WaitForGroup(taskGroups[i]);
+      EZ_TEST_BOOL(tasks[i].IsDone());
+    }
+
+    for (ezUInt32 i = 0; i < uiNumEmptyGroups; ++i)
+    {
+      ezTaskSystem::WaitForGroup(emptyGroups[i]);
+    }
+
+    EZ_DEFAULT_DELETE_ARRAY(tasks);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Work Stealing")
+  {
+    ezTaskSystem::SetSchedulerMode(ezTaskSchedulerMode::WorkStealing);
+    EZ_TEST_BOOL(ezTaskSystem::GetSchedulerMode() == ezTaskSchedulerMode::WorkStealing);
+    EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), iWorkersShort);
+    EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::LongTasks), iWorkersLong);
+
+    ezSpawnerTask spawner[8];
+    ezTaskGroupID tgSpawner[8];
+
+    ezTestTask t[2];
+    ezTaskGroupID tg[2];
+
+    t[0].SetMultiplicity(1000);
+    t[1].SetMultiplicity(100);
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(spawner); ++i)
+    {
+      spawner[i].m_Children.SetMultiplicity(500);
+      tgSpawner[i] = ezTaskSystem::StartSingleTask(&spawner[i], (i % 2 == 0) ? ezTaskPriority::ThisFrame : ezTaskPriority::LongRunning);
+    }
+
+    tg[0] = ezTaskSystem::StartSingleTask(&t[0], ezTaskPriority::EarlyThisFrame);
+    tg[1] = ezTaskSystem::StartSingleTask(&t[1], ezTaskPriority::LateThisFrame, tg[0]);
+
+    ezTaskSystem::FinishFrameTasks();
+
+    for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(spawner); ++i)
+    {
+      ezTaskSystem::WaitForGroup(tgSpawner[i]);
+      EZ_TEST_BOOL(spawner[i].m_Children.IsMultiplicityDone());
+    }
+
+    ezTaskSystem::WaitForGroup(tg[1]);
+
+    EZ_TEST_BOOL(ezTaskSystem::IsTaskGroupFinished(tg[0]));
+    EZ_TEST_BOOL(t[0].IsMultiplicityDone());
+    EZ_TEST_BOOL(t[1].IsMultiplicityDone());
+
+    // canceling tasks that sit in a worker's deque
+    {
+      ezCancelingSpawnerTask cancelingSpawner;
+      ezTaskSystem::WaitForGroup(ezTaskSystem::StartSingleTask(&cancelingSpawner, ezTaskPriority::ThisFrame));
+
+      ezUInt32 uiCanceled = 0;
+      for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(cancelingSpawner.m_Children); ++i)
+      {
+        EZ_TEST_BOOL(cancelingSpawner.m_Children[i].IsTaskFinished());
+
+        if (cancelingSpawner.m_bChildCanceled[i])
+        {
+          EZ_TEST_BOOL(!cancelingSpawner.m_Children[i].IsStarted());
+          ++uiCanceled;
+        }
+      }
+
+      EZ_TEST_BOOL_MSG(uiCanceled > 0, "This test can fail when the PC is under heavy load.");
+    }
+
+    ezTaskSystem::SetSchedulerMode(ezTaskSchedulerMode::SharedQueues);
+    EZ_TEST_BOOL(ezTaskSystem::GetSchedulerMode() == ezTaskSchedulerMode::SharedQueues);
+    EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), iWorkersShort);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Suspend Waiting Tasks on Fibers")
+  {
+    ezTaskSystem::SetTaskWaitMode(ezTaskWaitMode::SuspendOnFibers);
+
+    if (ezTaskSystem::GetTaskWaitMode() == ezTaskWaitMode::SuspendOnFibers)
+    {
+      const ezUInt32 uiChainLength = 32;
+      ezChainTask chains[4][uiChainLength];
+      ezTaskGroupID tg[4];
+
+      for (ezUInt32 c = 0; c < EZ_ARRAY_SIZE(chains); ++c)
+      {
+        for (ezUInt32 i = 0; i + 1 < uiChainLength; ++i)
+        {
+          chains[c][i].m_pNext = &chains[c][i + 1];
+          chains[c][i].m_Priority = (c % 2 == 0) ? ezTaskPriority::LongRunning : ezTaskPriority::ThisFrame;
+        }
+
+        tg[c] = ezTaskSystem::StartSingleTask(&chains[c][0], chains[c][0].m_Priority);
+      }
+
+      for (ezUInt32 c = 0; c < EZ_ARRAY_SIZE(chains); ++c)
+      {
+        ezTaskSystem::WaitForGroup(tg[c]);
+
+        for (ezUInt32 i = 0; i < uiChainLength; ++i)
+        {
+          EZ_TEST_BOOL(chains[c][i].IsTaskFinished());
+          EZ_TEST_BOOL(chains[c][i].m_bNextWasDone || i + 1 == uiChainLength);
+          EZ_TEST_BOOL(chains[c][i].m_bSameThreadAfterWait);
+        }
+      }
+    }
+
+    ezTaskSystem::SetTaskWaitMode(ezTaskWaitMode::HelpExecuting);
+    EZ_TEST_BOOL(ezTaskSystem::GetTaskWaitMode() == ezTaskWaitMode::HelpExecuting);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Worker Affinity / NUMA Node Queues")
+  {
+    const ezSystemInformation& si = ezSystemInformation::Get();
+    EZ_TEST_BOOL(si.GetLogicalCPUCount() >= 1);
+    EZ_TEST_BOOL(si.GetPhysicalCPUCoreCount() >= 1);
+    EZ_TEST_BOOL(si.GetPhysicalCPUCoreCount() <= si.GetLogicalCPUCount());
+    EZ_TEST_BOOL(si.GetCPUPackageCount() >= 1);
+    EZ_TEST_BOOL(si.GetNumaNodeCount() >= 1);
+
+    ezTaskSystem::SetWorkerThreadAffinity(ezTaskWorkerAffinity::PhysicalCore);
+    EZ_TEST_BOOL(ezTaskSystem::GetWorkerThreadAffinity() == ezTaskWorkerAffinity::PhysicalCore);
+    EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), iWorkersShort);
+
+    ezTaskSystem::SetWorkerThreadAffinity(ezTaskWorkerAffinity::NumaNode);
+    ezTaskSystem::SetUseNumaNodeQueues(true);
+    EZ_TEST_BOOL(ezTaskSystem::GetUseNumaNodeQueues());
+
+    ezTestTask t[2];
+    t[0].SetMultiplicity(200);
+    t[0].SetPreferredNumaNode(0);
+    t[1].SetMultiplicity(200);
+    t[1].SetPreferredNumaNode(si.GetNumaNodeCount() - 1);
+
+    ezTaskGroupID tg[2];
+    tg[0] = ezTaskSystem::StartSingleTask(&t[0], ezTaskPriority::ThisFrame);
+    tg[1] = ezTaskSystem::StartSingleTask(&t[1], ezTaskPriority::LongRunning);
+
+    ezDynamicArray<ezUInt32> items;
+    items.SetCount(10000, 0);
+
+    ezParallelForParams params;
+    params.bPreferNumaNodeOfData = true;
+    ezTaskSystem::ParallelFor<ezUInt32>(
+      items.GetArrayPtr(), [](ezArrayPtr<ezUInt32> slice) {
+        for (ezUInt32& item : slice)
+        {
+          item += 1;
+        }
+      },
+      "NumaParallelFor", params);
+
+    ezTaskSystem::WaitForGroup(tg[0]);
+    ezTaskSystem::WaitForGroup(tg[1]);
+
+    EZ_TEST_BOOL(t[0].IsMultiplicityDone());
+    EZ_TEST_BOOL(t[1].IsMultiplicityDone());
+
+    ezUInt32 uiNumProcessed = 0;
+    for (ezUInt32 item : items)
+    {
+      uiNumProcessed += item;
+    }
+
+    EZ_TEST_INT(uiNumProcessed, items.GetCount());
+
+    ezTaskSystem::SetUseNumaNodeQueues(false);
+    EZ_TEST_BOOL(!ezTaskSystem::GetUseNumaNodeQueues());
+
+    ezTaskSystem::SetWorkerThreadAffinity(ezTaskWorkerAffinity::None);
+    EZ_TEST_BOOL(ezTaskSystem::GetWorkerThreadAffinity() == ezTaskWorkerAffinity::None);
+    EZ_TEST_INT(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), iWorkersShort);
+  }
+
   // capture profiling info for testing
   /*ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
 
@@ -0,0 +1,254 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/DataProcessing/Stream/ProcessingStreamGroup.h>
+#include <Foundation/DataProcessing/Stream/ProcessingStreamIterator.h>
+#include <Foundation/Math/Float16.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <ParticlePlugin/Streams/ParticleStreamSimd.h>
+
+// these tests don't need a GPU, they only run the particle stream kernels
+EZ_CREATE_SIMPLE_TEST_GROUP(ParticleStreams);
+
+namespace
+{
+  struct TestParticles
+  {
+    void Create(ezUInt32 uiCount, ezProcessingStream::DataType velocityType, float fMaxLifeTime)
+    {
+      m_pPosition = m_Group.AddStream("Position", ezProcessingStream::DataType::Float4);
+      m_pVelocity = m_Group.AddStream("Velocity", velocityType);
+      m_pLifeTime = m_Group.AddStream("LifeTime", ezProcessingStream::DataType::Half2);
+
+      m_Group.SetSize(uiCount);
+      m_Group.InitializeElements(uiCount);
+      m_Group.Process();
+
+      ezUInt32 uiRandom = 42;
+      auto Random = [&]() {
+        uiRandom = uiRandom * 1664525u + 1013904223u;
+        return (uiRandom >> 8) / 16777216.0f;
+      };
+
+      ezVec4* pPosition = m_pPosition->GetWritableData<ezVec4>();
+      ezFloat16Vec2* pLifeTime = m_pLifeTime->GetWritableData<ezFloat16Vec2>();
+
+      for (ezUInt32 i = 0; i < uiCount; ++i)
+      {
+        pPosition[i].Set(Random() * 100.0f, Random() * 100.0f, Random() * 100.0f, static_cast<float>(i));
+        SetVelocity(i, ezVec3(Random() - 0.5f, Random() - 0.5f, Random() - 0.5f) * 20.0f);
+
+        pLifeTime[i].x = Random() * fMaxLifeTime;
+        pLifeTime[i].y = 1.0f / fMaxLifeTime;
+      }
+    }
+
+    ezVec3 GetVelocity(ezUInt64 uiIndex) const
+    {
+      if (m_pVelocity->GetDataType() == ezProcessingStream::DataType::Float3SoA)
+        return ezParticleStreamFloat3SoA(m_pVelocity).Get(uiIndex);
+
+      return m_pVelocity->GetData<ezVec3>()[uiIndex];
+    }
+
+    void SetVelocity(ezUInt64 uiIndex, const ezVec3& v)
+    {
+      if (m_pVelocity->GetDataType() == ezProcessingStream::DataType::Float3SoA)
+        ezParticleStreamFloat3SoA(m_pVelocity).Set(uiIndex, v);
+      else
+        m_pVelocity->GetWritableData<ezVec3>()[uiIndex] = v;
+    }
+
+    // what the particle behaviors did per element before the SoA kernels
+    void UpdateVectorsAoS(const ezVec3& vGravity, float fFrictionFactor, const ezSimdVec4f& vAddPos, float tDiff)
+    {
+      const ezUInt64 uiNumElements = m_Group.GetNumActiveElements();
+
+      {
+        ezProcessingStreamIterator<ezVec3> itVelocity(m_pVelocity, uiNumElements, 0);
+        while (!itVelocity.HasReachedEnd())
+        {
+          itVelocity.Current() += vGravity;
+          itVelocity.Advance();
+        }
+      }
+
+      {
+        ezProcessingStreamIterator<ezSimdVec4f> itPosition(m_pPosition, uiNumElements, 0);
+        ezProcessingStreamIterator<ezVec3> itVelocity(m_pVelocity, uiNumElements, 0);
+        while (!itPosition.HasReachedEnd())
+        {
+          itPosition.Current() += vAddPos;
+          itVelocity.Current() *= fFrictionFactor;
+
+          itPosition.Advance();
+          itVelocity.Advance();
+        }
+      }
+
+      {
+        ezProcessingStreamIterator<ezVec4> itPosition(m_pPosition, uiNumElements, 0);
+        ezProcessingStreamIterator<ezVec3> itVelocity(m_pVelocity, uiNumElements, 0);
+        while (!itPosition.HasReachedEnd())
+        {
+          ezVec3& pos = reinterpret_cast<ezVec3&>(itPosition.Current());
+          pos += itVelocity.Current() * tDiff;
+
+          itPosition.Advance();
+          itVelocity.Advance();
+        }
+      }
+    }
+
+    void UpdateAgeAoS(float tDiff)
+    {
+      const ezUInt64 uiNumElements = m_Group.GetNumActiveElements();
+
+      ezFloat16Vec2* pLifeTime = m_pLifeTime->GetWritableData<ezFloat16Vec2>();
+      for (ezUInt64 i = 0; i < uiNumElements; ++i)
+      {
+        pLifeTime[i].x = pLifeTime[i].x - tDiff;
+
+        if (pLifeTime[i].x <= 0)
+        {
+          pLifeTime[i].x = 0;
+          m_Group.RemoveElement(i);
+        }
+      }
+    }
+
+    void UpdateVectorsSoA(const ezVec3& vGravity, float fFrictionFactor, const ezSimdVec4f& vAddPos, float tDiff)
+    {
+      const ezUInt64 uiNumElements = m_Group.GetNumActiveElements();
+
+      ezParticleStreamSimd::AddToFloat3SoA(m_pVelocity, uiNumElements, vGravity);
+      ezParticleStreamSimd::AddToFloat4(m_pPosition->GetWritableData<ezVec4>(), uiNumElements, vAddPos);
+      ezParticleStreamSimd::ScaleFloat3SoA(m_pVelocity, uiNumElements, fFrictionFactor);
+      ezParticleStreamSimd::MulAddFloat3SoAToFloat4(m_pPosition->GetWritableData<ezVec4>(), m_pVelocity, uiNumElements, tDiff);
+    }
+
+    void UpdateAgeSoA(float tDiff)
+    {
+      ezParticleStreamSimd::DecreaseLifeTime(m_pLifeTime->GetWritableData<ezFloat16Vec2>(), m_Group.GetNumActiveElements(), tDiff, &m_Group);
+    }
+
+    ezProcessingStreamGroup m_Group;
+    ezProcessingStream* m_pPosition = nullptr;
+    ezProcessingStream* m_pVelocity = nullptr;
+    ezProcessingStream* m_pLifeTime = nullptr;
+  };
+
+  const ezVec3 s_vGravity(0.0f, 0.0f, -10.0f / 60.0f);
+  const ezSimdVec4f s_vAddPos(0.01f, 0.02f, 0.03f, 0.0f);
+  const float s_fFrictionFactor = 0.99f;
+  const float s_fTimeDiff = 1.0f / 60.0f;
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ParticleStreams, Kernels)
+{
+  // not a multiple of four, so that the packet tails are exercised
+  const ezUInt32 uiNumParticles = 1001;
+
+  TestParticles aos;
+  aos.Create(uiNumParticles, ezProcessingStream::DataType::Float3, 0.5f);
+
+  TestParticles soa;
+  soa.Create(uiNumParticles, ezProcessingStream::DataType::Float3SoA, 0.5f);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Float3SoA Stream")
+  {
+    const ezProcessingStream* pVelocity = soa.m_pVelocity;
+
+    // each component array starts at a 16 byte boundary and is padded to a multiple of four elements
+    EZ_TEST_INT(pVelocity->GetNumComponentArrays(), 3);
+    EZ_TEST_BOOL(reinterpret_cast<size_t>(pVelocity->GetComponentData(1)) % 16 == 0);
+    EZ_TEST_INT(static_cast<ezInt64>(pVelocity->GetComponentData<float>(1) - pVelocity->GetComponentData<float>(0)), 1004);
+
+    for (ezUInt32 i = 0; i < uiNumParticles; ++i)
+    {
+      EZ_TEST_VEC3(soa.GetVelocity(i), aos.GetVelocity(i), 0.0f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Update")
+  {
+    // run until about half of the particles have died
+    for (ezUInt32 uiFrame = 0; uiFrame < 15; ++uiFrame)
+    {
+      aos.UpdateVectorsAoS(s_vGravity, s_fFrictionFactor, s_vAddPos, s_fTimeDiff);
+      aos.UpdateAgeAoS(s_fTimeDiff);
+      aos.m_Group.Process();
+
+      soa.UpdateVectorsSoA(s_vGravity, s_fFrictionFactor, s_vAddPos, s_fTimeDiff);
+      soa.UpdateAgeSoA(s_fTimeDiff);
+      soa.m_Group.Process();
+
+      // the same particles must have died in the same order
+      EZ_TEST_INT(soa.m_Group.GetNumActiveElements(), aos.m_Group.GetNumActiveElements());
+      if (soa.m_Group.GetNumActiveElements() != aos.m_Group.GetNumActiveElements())
+        break;
+
+      const ezVec4* pPositionAoS = aos.m_pPosition->GetData<ezVec4>();
+      const ezVec4* pPositionSoA = soa.m_pPosition->GetData<ezVec4>();
+      const ezUInt16* pLifeTimeAoS = aos.m_pLifeTime->GetData<ezUInt16>();
+      const ezUInt16* pLifeTimeSoA = soa.m_pLifeTime->GetData<ezUInt16>();
+
+      for (ezUInt32 i = 0; i < soa.m_Group.GetNumActiveElements(); ++i)
+      {
+        EZ_TEST_VEC4(pPositionSoA[i], pPositionAoS[i], 0.0001f);
+        EZ_TEST_VEC3(soa.GetVelocity(i), aos.GetVelocity(i), 0.0001f);
+
+        // the life time has to be bit exact, otherwise particles would die in different frames
+        EZ_TEST_INT(pLifeTimeSoA[i * 2 + 0], pLifeTimeAoS[i * 2 + 0]);
+        EZ_TEST_INT(pLifeTimeSoA[i * 2 + 1], pLifeTimeAoS[i * 2 + 1]);
+      }
+    }
+
+    EZ_TEST_BOOL(soa.m_Group.GetNumActiveElements() > 0);
+    EZ_TEST_BOOL(soa.m_Group.GetNumActiveElements() < uiNumParticles);
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(ParticleStreams, Profile_Update)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "64k Particles")
+  {
+    const ezUInt32 uiNumParticles = 64 * 1024;
+    const ezUInt32 uiNumFrames = 100;
+
+    // long enough that no particle dies, so that both versions do the same work in every frame
+    TestParticles aos;
+    aos.Create(uiNumParticles, ezProcessingStream::DataType::Float3, 1000.0f);
+
+    TestParticles soa;
+    soa.Create(uiNumParticles, ezProcessingStream::DataType::Float3SoA, 1000.0f);
+
+    ezTime tVectorsAoS, tAgeAoS;
+    ezTime tVectorsSoA, tAgeSoA;
+
+    for (ezUInt32 i = 0; i < uiNumFrames; ++i)
+    {
+      ezStopwatch sw;
+      aos.UpdateVectorsAoS(s_vGravity, s_fFrictionFactor, s_vAddPos, s_fTimeDiff);
+      tVectorsAoS += sw.Checkpoint();
+
+      aos.UpdateAgeAoS(s_fTimeDiff);
+      tAgeAoS += sw.Checkpoint();
+
+      soa.UpdateVectorsSoA(s_vGravity, s_fFrictionFactor, s_vAddPos, s_fTimeDiff);
+      tVectorsSoA += sw.Checkpoint();
+
+      soa.UpdateAgeSoA(s_fTimeDiff);
+      tAgeSoA += sw.Checkpoint();
+    }
+
+    // the kernels only use SSE where ezSimdVec4f does, with the FPU implementation there is no speedup to expect
+    ezTestFramework::Output(ezTestOutput::Duration, "Gravity, friction and velocity, per element (%u particles): %.3fms", uiNumParticles,
+      tVectorsAoS.GetMilliseconds() / uiNumFrames);
+    ezTestFramework::Output(ezTestOutput::Duration, "Gravity, friction and velocity, SoA kernels (%u particles): %.3fms (%.1fx)", uiNumParticles,
+      tVectorsSoA.GetMilliseconds() / uiNumFrames, tVectorsAoS.GetSeconds() / tVectorsSoA.GetSeconds());
+    ezTestFramework::Output(
+      ezTestOutput::Duration, "Age, per element (%u particles): %.3fms", uiNumParticles, tAgeAoS.GetMilliseconds() / uiNumFrames);
+    ezTestFramework::Output(ezTestOutput::Duration, "Age, SoA kernel (%u particles): %.3fms (%.1fx)", uiNumParticles,
+      tAgeSoA.GetMilliseconds() / uiNumFrames, tAgeAoS.GetSeconds() / tAgeSoA.GetSeconds());
+  }
+}
@@ -2,6 +2,7 @@
 
 #include "ParticlesTest.h"
 #include <Core/WorldSerializer/WorldReader.h>
+#include <Foundation/Configuration/CVar.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <ParticlePlugin/Components/ParticleComponent.h>
 
@@ -51,6 +52,7 @@ void ezGameEngineTestParticles::SetupSubTests()
   AddSubTest("DistanceEmitter", SubTests::DistanceEmitter);
   AddSubTest("SharedInstances", SubTests::SharedInstances);
   AddSubTest("LocalSpaceSim", SubTests::LocalSpaceSim);
+  AddSubTest("ParallelSystemUpdates", SubTests::ParallelSystemUpdates);
 }
 
 ezResult ezGameEngineTestParticles::InitializeSubTest(ezInt32 iIdentifier)
@@ -89,6 +91,19 @@ ezResult ezGameEngineTestParticles::InitializeSubTest(ezInt32 iIdentifier)
     m_pOwnApplication->SetupSceneSubTest("Particles/AssetCache/Common/LocalSpaceSim.ezObjectGraph");
     return EZ_SUCCESS;
   }
+  else if (iIdentifier == SubTests::ParallelSystemUpdates)
+  {
+    // only effects created while the cvar is set update their systems in parallel
+    ezCVarBool* pCVar = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("pfx_ParallelSystemUpdates"));
+    if (EZ_TEST_BOOL(pCVar != nullptr).Failed())
+      return EZ_FAILURE;
+
+    *pCVar = true;
+
+    // the event emitter effect has several systems that communicate through the effect's event queue
+    m_pOwnApplication->SetupParticleSubTest("{ 5a8acf94-76da-4f67-8ba4-ac2693e747f5 }");
+    return EZ_SUCCESS;
+  }
   else
   {
     const char* szEffects[] = {
@@ -125,10 +140,28 @@ ezResult ezGameEngineTestParticles::InitializeSubTest(ezInt32 iIdentifier)
   return EZ_FAILURE;
 }
 
+ezResult ezGameEngineTestParticles::DeInitializeSubTest(ezInt32 iIdentifier)
+{
+  if (iIdentifier == SubTests::ParallelSystemUpdates)
+  {
+    if (ezCVarBool* pCVar = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("pfx_ParallelSystemUpdates")))
+    {
+      *pCVar = false;
+    }
+  }
+
+  return SUPER::DeInitializeSubTest(iIdentifier);
+}
+
 ezTestAppRun ezGameEngineTestParticles::RunSubTest(ezInt32 iIdentifier, ezUInt32 uiInvocationCount)
 {
   ++m_iFrame;
 
+  if (iIdentifier == SubTests::ParallelSystemUpdates)
+  {
+    return m_pOwnApplication->ExecParallelSystemUpdatesSubTest(m_iFrame);
+  }
+
   return m_pOwnApplication->ExecParticleSubTest(m_iFrame);
 }
 
@@ -183,3 +216,34 @@ ezTestAppRun ezGameEngineTestApplication_Particles::ExecParticleSubTest(ezInt32
 
   return ezTestAppRun::Continue;
 }
+
+ezTestAppRun ezGameEngineTestApplication_Particles::ExecParallelSystemUpdatesSubTest(ezInt32 iCurFrame)
+{
+  if (Run() == ezApplication::Quit)
+    return ezTestAppRun::Quit;
+
+  // the random sequence differs from the sequential update, so there are no reference images for this one
+  // instead the effect has to stay alive, be interruptible and keep running once it was restarted
+  if (iCurFrame == 30)
+  {
+    EZ_LOCK(m_pWorld->GetWriteMarker());
+
+    ezGameObject* pObject;
+    if (EZ_TEST_BOOL(m_pWorld->TryGetObjectWithGlobalKey("Effect", pObject)).Failed())
+      return ezTestAppRun::Quit;
+
+    ezParticleComponent* pEffect;
+    if (EZ_TEST_BOOL(pObject->TryGetComponentOfBaseType(pEffect)).Failed())
+      return ezTestAppRun::Quit;
+
+    EZ_TEST_BOOL(pEffect->IsEffectActive());
+
+    pEffect->InterruptEffect();
+    EZ_TEST_BOOL(!pEffect->IsEffectActive());
+  }
+
+  if (iCurFrame == 60)
+    return ezTestAppRun::Quit;
+
+  return ezTestAppRun::Continue;
+}
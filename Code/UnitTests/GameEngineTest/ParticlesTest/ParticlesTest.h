@@ -12,6 +12,7 @@ public:
   void SetupSceneSubTest(const char* szFile);
   void SetupParticleSubTest(const char* szFile);
   ezTestAppRun ExecParticleSubTest(ezInt32 iCurFrame);
+  ezTestAppRun ExecParallelSystemUpdatesSubTest(ezInt32 iCurFrame);
 };
 
 class ezGameEngineTestParticles : public ezGameEngineTest
@@ -56,10 +57,12 @@ private:
     SharedInstances,
     EventReactionEffect,
     LocalSpaceSim,
+    ParallelSystemUpdates,
   };
 
   virtual void SetupSubTests() override;
   virtual ezResult InitializeSubTest(ezInt32 iIdentifier) override;
+  virtual ezResult DeInitializeSubTest(ezInt32 iIdentifier) override;
   virtual ezTestAppRun RunSubTest(ezInt32 iIdentifier, ezUInt32 uiInvocationCount) override;
 
   ezInt32 m_iFrame = 0;
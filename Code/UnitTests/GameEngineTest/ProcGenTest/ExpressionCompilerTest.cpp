@@ -0,0 +1,153 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <ProcGenPlugin/VM/ExpressionAST.h>
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+#include <ProcGenPlugin/VM/ExpressionCompiler.h>
+#include <ProcGenPlugin/VM/ExpressionVM.h>
+
+EZ_CREATE_SIMPLE_TEST_GROUP(ProcGen);
+
+namespace
+{
+  // Builds the kind of redundant expressions a node graph typically produces:
+  // x = max((a * 2 + b)^2 / 4 + sin(0.5) * -(-a), b - 1)
+  // y = (a * 2 + b) * 3 - (1 + 2)
+  void BuildTestAST(ezExpressionAST& ast)
+  {
+    auto Const = [&](float fValue) { return ast.CreateConstant(fValue); };
+    auto Sum = [&](ezExpressionAST::Node* pInputA) {
+      // a new node every time, like separate graph nodes would create
+      return ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add,
+        ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pInputA, Const(2.0f)), ast.CreateInput(EZ_HASHED_STRING("b")));
+    };
+
+    auto pA = ast.CreateInput(EZ_HASHED_STRING("a"));
+
+    auto pSquare = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, Sum(pA), Sum(ast.CreateInput(EZ_HASHED_STRING("a"))));
+    auto pQuarter = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Divide, pSquare, Const(4.0f));
+    auto pSin = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sin, Const(0.5f));
+    auto pNegNeg = ast.CreateUnaryOperator(ezExpressionAST::NodeType::Negate, ast.CreateUnaryOperator(ezExpressionAST::NodeType::Negate, pA));
+    auto pLeft = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, pQuarter, ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, pSin, pNegNeg));
+    auto pRight = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract, ast.CreateInput(EZ_HASHED_STRING("b")), Const(1.0f));
+    auto pX = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Max, pLeft, pRight);
+
+    auto pY = ast.CreateBinaryOperator(ezExpressionAST::NodeType::Subtract,
+      ast.CreateBinaryOperator(ezExpressionAST::NodeType::Multiply, Sum(pA), Const(3.0f)),
+      ast.CreateBinaryOperator(ezExpressionAST::NodeType::Add, Const(1.0f), Const(2.0f)));
+
+    // overwritten below, so it is never visible to the caller
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(EZ_HASHED_STRING("x"), ast.CreateUnaryOperator(ezExpressionAST::NodeType::Sqrt, pY)));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(EZ_HASHED_STRING("x"), pX));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(EZ_HASHED_STRING("y"), pY));
+  }
+
+  struct TestData
+  {
+    TestData(ezUInt32 uiNumInstances)
+    {
+      m_A.SetCountUninitialized(uiNumInstances);
+      m_B.SetCountUninitialized(uiNumInstances);
+      m_X.SetCount(uiNumInstances);
+      m_Y.SetCount(uiNumInstances);
+
+      for (ezUInt32 i = 0; i < uiNumInstances; ++i)
+      {
+        m_A[i] = (i % 100) * 0.1f - 5.0f;
+        m_B[i] = (i % 37) * 0.5f - 9.0f;
+      }
+
+      m_Inputs.PushBack(ezExpression::MakeStream(m_A.GetArrayPtr(), 0, EZ_HASHED_STRING("a")));
+      m_Inputs.PushBack(ezExpression::MakeStream(m_B.GetArrayPtr(), 0, EZ_HASHED_STRING("b")));
+      m_Outputs.PushBack(ezExpression::MakeStream(m_X.GetArrayPtr(), 0, EZ_HASHED_STRING("x")));
+      m_Outputs.PushBack(ezExpression::MakeStream(m_Y.GetArrayPtr(), 0, EZ_HASHED_STRING("y")));
+    }
+
+    ezResult Execute(ezExpressionVM& vm, const ezExpressionByteCode& byteCode)
+    {
+      return vm.Execute(byteCode, m_Inputs, m_Outputs, m_A.GetCount());
+    }
+
+    ezDynamicArray<float> m_A;
+    ezDynamicArray<float> m_B;
+    ezDynamicArray<float> m_X;
+    ezDynamicArray<float> m_Y;
+
+    ezHybridArray<ezExpression::Stream, 2> m_Inputs;
+    ezHybridArray<ezExpression::Stream, 2> m_Outputs;
+  };
+
+  void CompileTestAST(ezExpressionByteCode& out_byteCode, bool bOptimize)
+  {
+    ezExpressionAST ast;
+    BuildTestAST(ast);
+
+    ezExpressionCompiler compiler;
+    EZ_TEST_BOOL(compiler.Compile(ast, out_byteCode, bOptimize).Succeeded());
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, ExpressionCompiler)
+{
+  ezExpressionByteCode unoptimizedByteCode;
+  CompileTestAST(unoptimizedByteCode, false);
+
+  ezExpressionByteCode optimizedByteCode;
+  CompileTestAST(optimizedByteCode, true);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Instruction Count")
+  {
+    EZ_TEST_BOOL(optimizedByteCode.GetNumInstructions() < unoptimizedByteCode.GetNumInstructions());
+    EZ_TEST_BOOL(optimizedByteCode.GetNumTempRegisters() <= unoptimizedByteCode.GetNumTempRegisters());
+
+    // the streams are mapped by name, only their order may change
+    EZ_TEST_INT(optimizedByteCode.GetInputs().GetCount(), unoptimizedByteCode.GetInputs().GetCount());
+    EZ_TEST_INT(optimizedByteCode.GetOutputs().GetCount(), unoptimizedByteCode.GetOutputs().GetCount());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Results")
+  {
+    ezExpressionVM vm;
+
+    TestData unoptimizedData(1000);
+    EZ_TEST_BOOL(unoptimizedData.Execute(vm, unoptimizedByteCode).Succeeded());
+
+    TestData optimizedData(1000);
+    EZ_TEST_BOOL(optimizedData.Execute(vm, optimizedByteCode).Succeeded());
+
+    for (ezUInt32 i = 0; i < 1000; ++i)
+    {
+      // divisions are replaced by multiplications with the reciprocal, so the results are allowed to differ slightly
+      EZ_TEST_FLOAT(optimizedData.m_X[i], unoptimizedData.m_X[i], ezMath::Max(ezMath::Abs(unoptimizedData.m_X[i]), 1.0f) * 0.0001f);
+      EZ_TEST_FLOAT(optimizedData.m_Y[i], unoptimizedData.m_Y[i], ezMath::Max(ezMath::Abs(unoptimizedData.m_Y[i]), 1.0f) * 0.0001f);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Throughput")
+  {
+    const ezUInt32 uiNumInstances = 64 * 1024;
+    const ezUInt32 uiNumIterations = 20;
+
+    ezExpressionVM vm;
+    TestData testData(uiNumInstances);
+
+    ezTime tUnoptimized;
+    ezTime tOptimized;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      ezStopwatch sw;
+      testData.Execute(vm, unoptimizedByteCode);
+      tUnoptimized += sw.Checkpoint();
+
+      testData.Execute(vm, optimizedByteCode);
+      tOptimized += sw.Checkpoint();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Unoptimized (%u instructions, %u instances): %.2fms", unoptimizedByteCode.GetNumInstructions(),
+      uiNumInstances, tUnoptimized.GetMilliseconds() / uiNumIterations);
+    ezTestFramework::Output(ezTestOutput::Duration, "Optimized (%u instructions, %u instances): %.2fms", optimizedByteCode.GetNumInstructions(),
+      uiNumInstances, tOptimized.GetMilliseconds() / uiNumIterations);
+  }
+}
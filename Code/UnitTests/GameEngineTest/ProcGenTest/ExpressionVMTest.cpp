@@ -0,0 +1,182 @@
+#include <GameEngineTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <ProcGenPlugin/VM/ExpressionAST.h>
+#include <ProcGenPlugin/VM/ExpressionByteCode.h>
+#include <ProcGenPlugin/VM/ExpressionCompiler.h>
+#include <ProcGenPlugin/VM/ExpressionVM.h>
+
+namespace
+{
+  // Similar to what a placement graph computes per point:
+  // density = saturate(noise(pos * 0.1, 3) * 2 - 0.5) * random(seed) + height * 0.01
+  // scale = height * 0.5 + pos.x * 0.25
+  void BuildPlacementAST(ezExpressionAST& ast)
+  {
+    auto Binary = [&](ezExpressionAST::NodeType::Enum type, ezExpressionAST::Node* pLeft, ezExpressionAST::Node* pRight) {
+      return ast.CreateBinaryOperator(type, pLeft, pRight);
+    };
+
+    auto pPosX = ast.CreateInput(EZ_HASHED_STRING("pos_x"));
+    auto pPosY = ast.CreateInput(EZ_HASHED_STRING("pos_y"));
+    auto pHeight = ast.CreateInput(EZ_HASHED_STRING("height"));
+    auto pSeed = ast.CreateInput(EZ_HASHED_STRING("seed"));
+
+    auto pNoise = ast.CreateFunctionCall(EZ_HASHED_STRING("PerlinNoise"));
+    pNoise->m_Arguments.PushBack(Binary(ezExpressionAST::NodeType::Multiply, pPosX, ast.CreateConstant(0.1f)));
+    pNoise->m_Arguments.PushBack(Binary(ezExpressionAST::NodeType::Multiply, pPosY, ast.CreateConstant(0.1f)));
+    pNoise->m_Arguments.PushBack(ast.CreateConstant(0.0f));
+    pNoise->m_Arguments.PushBack(ast.CreateConstant(3.0f));
+
+    auto pRandom = ast.CreateFunctionCall(EZ_HASHED_STRING("Random"));
+    pRandom->m_Arguments.PushBack(pSeed);
+
+    auto pRemapped = Binary(ezExpressionAST::NodeType::Subtract, Binary(ezExpressionAST::NodeType::Multiply, pNoise, ast.CreateConstant(2.0f)),
+      ast.CreateConstant(0.5f));
+    auto pSaturated = Binary(ezExpressionAST::NodeType::Min, Binary(ezExpressionAST::NodeType::Max, pRemapped, ast.CreateConstant(0.0f)),
+      ast.CreateConstant(1.0f));
+    auto pDensity = Binary(ezExpressionAST::NodeType::Add, Binary(ezExpressionAST::NodeType::Multiply, pSaturated, pRandom),
+      Binary(ezExpressionAST::NodeType::Multiply, pHeight, ast.CreateConstant(0.01f)));
+    auto pScale = Binary(ezExpressionAST::NodeType::Add, Binary(ezExpressionAST::NodeType::Multiply, pHeight, ast.CreateConstant(0.5f)),
+      Binary(ezExpressionAST::NodeType::Multiply, pPosX, ast.CreateConstant(0.25f)));
+
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(EZ_HASHED_STRING("density"), pDensity));
+    ast.m_OutputNodes.PushBack(ast.CreateOutput(EZ_HASHED_STRING("scale"), pScale));
+  }
+
+  struct PlacementData
+  {
+    struct Point
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      float m_fPosX;
+      float m_fPosY;
+      float m_fHeight;
+      float m_fSeed;
+      float m_fDensity;
+      float m_fScale;
+    };
+
+    PlacementData(ezUInt32 uiNumPoints)
+    {
+      m_Points.SetCountUninitialized(uiNumPoints);
+
+      for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+      {
+        auto& point = m_Points[i];
+        point.m_fPosX = (i % 512) * 0.5f;
+        point.m_fPosY = (i / 512) * 0.5f;
+        point.m_fHeight = (i % 97) * 0.25f;
+        point.m_fSeed = static_cast<float>(i);
+        point.m_fDensity = -1.0f;
+        point.m_fScale = -1.0f;
+      }
+
+      // interleaved data with a stride, like the placement task uses
+      auto points = m_Points.GetArrayPtr();
+      m_Inputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fPosX), EZ_HASHED_STRING("pos_x")));
+      m_Inputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fPosY), EZ_HASHED_STRING("pos_y")));
+      m_Inputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fHeight), EZ_HASHED_STRING("height")));
+      m_Inputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fSeed), EZ_HASHED_STRING("seed")));
+      m_Outputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fDensity), EZ_HASHED_STRING("density")));
+      m_Outputs.PushBack(ezExpression::MakeStream(points, offsetof(Point, m_fScale), EZ_HASHED_STRING("scale")));
+    }
+
+    ezResult Execute(ezExpressionVM& vm, const ezExpressionByteCode& byteCode)
+    {
+      return vm.Execute(byteCode, m_Inputs, m_Outputs, m_Points.GetCount());
+    }
+
+    ezDynamicArray<Point> m_Points;
+    ezHybridArray<ezExpression::Stream, 4> m_Inputs;
+    ezHybridArray<ezExpression::Stream, 2> m_Outputs;
+  };
+
+  void CompilePlacementAST(ezExpressionByteCode& out_byteCode, bool bOptimize)
+  {
+    ezExpressionAST ast;
+    BuildPlacementAST(ast);
+
+    ezExpressionCompiler compiler;
+    EZ_TEST_BOOL(compiler.Compile(ast, out_byteCode, bOptimize).Succeeded());
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(ProcGen, ExpressionVM)
+{
+  ezExpressionByteCode unoptimizedByteCode;
+  CompilePlacementAST(unoptimizedByteCode, false);
+
+  ezExpressionByteCode optimizedByteCode;
+  CompilePlacementAST(optimizedByteCode, true);
+
+  ezExpressionVM vm;
+  vm.RegisterDefaultFunctions();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "MulAdd")
+  {
+    ezStringBuilder sDisassembly;
+    optimizedByteCode.Disassemble(sDisassembly);
+
+    EZ_TEST_BOOL(sDisassembly.FindSubString("MulAdd_CRR") != nullptr);
+    EZ_TEST_BOOL(optimizedByteCode.GetNumInstructions() < unoptimizedByteCode.GetNumInstructions());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Batches")
+  {
+    // smaller than a register group, not a multiple of the batch size and several batches
+    const ezUInt32 counts[] = {1, 7, 1000, 1024, 1025, 5000};
+
+    for (ezUInt32 uiNumPoints : counts)
+    {
+      PlacementData data(uiNumPoints);
+      EZ_TEST_BOOL(data.Execute(vm, optimizedByteCode).Succeeded());
+
+      PlacementData referenceData(uiNumPoints);
+      EZ_TEST_BOOL(referenceData.Execute(vm, unoptimizedByteCode).Succeeded());
+
+      for (ezUInt32 i = 0; i < uiNumPoints; ++i)
+      {
+        const auto& point = data.m_Points[i];
+        const auto& referencePoint = referenceData.m_Points[i];
+
+        // the inputs must not have been touched
+        EZ_TEST_FLOAT(point.m_fSeed, static_cast<float>(i), 0.0f);
+
+        EZ_TEST_FLOAT(point.m_fScale, point.m_fHeight * 0.5f + point.m_fPosX * 0.25f, 0.0001f);
+        EZ_TEST_FLOAT(point.m_fDensity, referencePoint.m_fDensity, 0.0001f);
+        EZ_TEST_FLOAT(point.m_fScale, referencePoint.m_fScale, 0.0001f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "Throughput")
+  {
+    const ezUInt32 uiNumPoints = 1024 * 1024;
+    const ezUInt32 uiNumIterations = 5;
+
+    PlacementData data(uiNumPoints);
+
+    ezTime tUnoptimized;
+    ezTime tOptimized;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      ezStopwatch sw;
+      data.Execute(vm, unoptimizedByteCode);
+      tUnoptimized += sw.Checkpoint();
+
+      data.Execute(vm, optimizedByteCode);
+      tOptimized += sw.Checkpoint();
+    }
+
+    const double fUnoptimizedMs = tUnoptimized.GetMilliseconds() / uiNumIterations;
+    const double fOptimizedMs = tOptimized.GetMilliseconds() / uiNumIterations;
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Placement graph, unoptimized (%u instructions, %u points): %.2fms (%.1f MPoints/s)",
+      unoptimizedByteCode.GetNumInstructions(), uiNumPoints, fUnoptimizedMs, uiNumPoints / (fUnoptimizedMs * 1000.0));
+    ezTestFramework::Output(ezTestOutput::Duration, "Placement graph, optimized (%u instructions, %u points): %.2fms (%.1f MPoints/s)",
+      optimizedByteCode.GetNumInstructions(), uiNumPoints, fOptimizedMs, uiNumPoints / (fOptimizedMs * 1000.0));
+  }
+}
@@ -0,0 +1,203 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Memory/FrameAllocator.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/Extractor.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+
+namespace
+{
+  class ExtractionTestRenderData : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ExtractionTestRenderData, ezRenderData);
+
+  public:
+    ezUInt32 m_uiObjectIndex;
+  };
+
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ExtractionTestRenderData, 1, ezRTTIDefaultAllocator<ExtractionTestRenderData>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  class ExtractionTestComponent;
+  typedef ezComponentManager<ExtractionTestComponent, ezBlockStorageType::FreeList> ExtractionTestComponentManager;
+
+  class ExtractionTestComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ExtractionTestComponent, ezComponent, ExtractionTestComponentManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override {}
+    virtual void DeserializeComponent(ezWorldReader& stream) override {}
+
+    void OnMsgExtractRenderData(ezMsgExtractRenderData& msg) const
+    {
+      // a few objects add several render data in different categories to check that the order within a category is kept
+      const ezUInt32 uiNumRenderData = (m_uiObjectIndex % 7 == 0) ? 3 : 1;
+      for (ezUInt32 i = 0; i < uiNumRenderData; ++i)
+      {
+        ExtractionTestRenderData* pRenderData = ezCreateRenderDataForThisFrame<ExtractionTestRenderData>(GetOwner());
+        pRenderData->m_GlobalTransform = GetOwner()->GetGlobalTransform();
+        pRenderData->m_uiBatchId = m_uiObjectIndex % 16;
+        pRenderData->m_uiObjectIndex = m_uiObjectIndex;
+
+        msg.AddRenderData(pRenderData, i == 1 ? ezDefaultRenderDataCategories::LitTransparent : ezDefaultRenderDataCategories::LitOpaque,
+          ezRenderData::Caching::Never);
+      }
+    }
+
+    ezUInt32 m_uiObjectIndex = 0;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(ExtractionTestComponent, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_MESSAGEHANDLERS
+    {
+      EZ_MESSAGE_HANDLER(ezMsgExtractRenderData, OnMsgExtractRenderData),
+    }
+    EZ_END_MESSAGEHANDLERS;
+  }
+  EZ_END_COMPONENT_TYPE;
+  // clang-format on
+
+  // does not handle the extract message, so static objects get a dummy entry in the render data cache
+  class ExtractionTestDummyComponent;
+  typedef ezComponentManager<ExtractionTestDummyComponent, ezBlockStorageType::FreeList> ExtractionTestDummyComponentManager;
+
+  class ExtractionTestDummyComponent : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ExtractionTestDummyComponent, ezComponent, ExtractionTestDummyComponentManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override {}
+    virtual void DeserializeComponent(ezWorldReader& stream) override {}
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ExtractionTestDummyComponent, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE;
+
+  struct ExtractedEntry
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiBatch;
+    ezUInt32 m_uiObjectIndex;
+    ezUInt32 m_uiBatchId;
+    ezVec3 m_vPosition;
+
+    bool operator==(const ExtractedEntry& other) const
+    {
+      return m_uiBatch == other.m_uiBatch && m_uiObjectIndex == other.m_uiObjectIndex && m_uiBatchId == other.m_uiBatchId &&
+             m_vPosition == other.m_vPosition;
+    }
+  };
+
+  void ExtractAndCollect(ezVisibleObjectsExtractor& extractor, const ezView& view, const ezDynamicArray<const ezGameObject*>& visibleObjects,
+    ezDynamicArray<ExtractedEntry>& out_Entries)
+  {
+    const ezRenderData::Category categories[] = {ezDefaultRenderDataCategories::LitOpaque, ezDefaultRenderDataCategories::LitTransparent};
+
+    ezExtractedRenderData extractedData;
+    extractedData.SetCamera(*view.GetCamera());
+    extractor.Extract(view, visibleObjects, extractedData);
+    extractedData.SortAndBatch();
+
+    out_Entries.Clear();
+    ezUInt32 uiBatchOffset = 0;
+    for (const ezRenderData::Category& category : categories)
+    {
+      ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+      for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+      {
+        ezRenderDataBatch batch = batchList.GetBatch(uiBatch);
+        for (auto it = batch.GetIterator<ExtractionTestRenderData>(); it.IsValid(); ++it)
+        {
+          ExtractedEntry& entry = out_Entries.ExpandAndGetRef();
+          entry.m_uiBatch = uiBatchOffset + uiBatch;
+          entry.m_uiObjectIndex = it->m_uiObjectIndex;
+          entry.m_uiBatchId = it->m_uiBatchId;
+          entry.m_vPosition = it->m_GlobalTransform.m_vPosition;
+        }
+      }
+
+      uiBatchOffset += batchList.GetBatchCount();
+    }
+  }
+} // namespace
+
+// the render world's views and cache only need the core systems, so this runs without a device
+EZ_CREATE_SIMPLE_TEST(RenderPipeline, ParallelExtraction)
+{
+  ezCVarBool* pParallelExtraction = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("r_ParallelExtraction"));
+  if (EZ_TEST_BOOL(pParallelExtraction != nullptr).Failed())
+    return;
+
+  EZ_TEST_BOOL_MSG(pParallelExtraction->GetValue() == false, "Parallel extraction should be opt-in");
+
+  ezWorldDesc worldDesc("Test");
+  ezWorld world(worldDesc);
+
+  // enough objects for several extraction chunks, half of them static so the render data cache is filled from several threads
+  const ezUInt32 uiNumObjects = 3000;
+  ezDynamicArray<const ezGameObject*> visibleObjects;
+
+  {
+    EZ_LOCK(world.GetWriteMarker());
+
+    ExtractionTestComponentManager* pManager = world.GetOrCreateComponentManager<ExtractionTestComponentManager>();
+    ExtractionTestDummyComponentManager* pDummyManager = world.GetOrCreateComponentManager<ExtractionTestDummyComponentManager>();
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = (i % 2) == 0;
+      desc.m_LocalPosition.Set(static_cast<float>(i % 100), static_cast<float>(i / 100), 0.0f);
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      ExtractionTestComponent* pComponent = nullptr;
+      pManager->CreateComponent(pObject, pComponent);
+      pComponent->m_uiObjectIndex = i;
+
+      ExtractionTestDummyComponent* pDummyComponent = nullptr;
+      pDummyManager->CreateComponent(pObject, pDummyComponent);
+
+      visibleObjects.PushBack(pObject);
+    }
+
+    // initializes the components, messages are not delivered before that
+    world.Update();
+  }
+
+  ezCamera camera;
+  camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 2000.0f);
+  camera.LookAt(ezVec3(50, -100, 50), ezVec3(50, 0, 0), ezVec3(0, 0, 1));
+
+  ezView* pView = nullptr;
+  ezViewHandle hView = ezRenderWorld::CreateView("ExtractionTest", pView);
+  pView->SetWorld(&world);
+  pView->SetCamera(&camera);
+
+  ezVisibleObjectsExtractor extractor;
+
+  ezDynamicArray<ExtractedEntry> serialEntries;
+  ezDynamicArray<ExtractedEntry> parallelEntries;
+
+  *pParallelExtraction = false;
+  ExtractAndCollect(extractor, *pView, visibleObjects, serialEntries);
+
+  *pParallelExtraction = true;
+  ExtractAndCollect(extractor, *pView, visibleObjects, parallelEntries);
+
+  *pParallelExtraction = false;
+
+  EZ_TEST_INT(serialEntries.GetCount(), uiNumObjects + 2 * ((uiNumObjects + 6) / 7));
+  EZ_TEST_BOOL(serialEntries == parallelEntries);
+
+  ezRenderWorld::DeleteView(hView);
+  ezFrameAllocator::Reset();
+}
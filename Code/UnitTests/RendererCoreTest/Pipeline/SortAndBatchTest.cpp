@@ -0,0 +1,172 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+
+// these tests don't need a GPU, they only exercise the CPU side of the render pipeline
+EZ_CREATE_SIMPLE_TEST_GROUP(RenderPipeline);
+
+namespace
+{
+  class SortTestRenderDataA : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(SortTestRenderDataA, ezRenderData);
+  };
+
+  class SortTestRenderDataB : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(SortTestRenderDataB, ezRenderData);
+  };
+
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(SortTestRenderDataA, 1, ezRTTIDefaultAllocator<SortTestRenderDataA>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(SortTestRenderDataB, 1, ezRTTIDefaultAllocator<SortTestRenderDataB>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  struct SortTestData
+  {
+    ezDynamicArray<SortTestRenderDataA> m_RenderDataA;
+    ezDynamicArray<SortTestRenderDataB> m_RenderDataB;
+
+    void Create(ezUInt32 uiCount, ezUInt32 uiSeed)
+    {
+      m_RenderDataA.SetCount(uiCount / 2);
+      m_RenderDataB.SetCount(uiCount - uiCount / 2);
+
+      // a small number of materials and meshes, so that there are batches to find
+      ezUInt32 uiRandom = uiSeed;
+      auto Init = [&](ezRenderData& renderData) {
+        uiRandom = uiRandom * 1664525u + 1013904223u;
+
+        renderData.m_uiBatchId = (uiRandom >> 8) % 64;
+        renderData.m_uiSortingKey = (uiRandom >> 16) % 16;
+        renderData.m_GlobalTransform.SetIdentity();
+        renderData.m_GlobalTransform.m_vPosition.Set(static_cast<float>((uiRandom >> 4) % 1000), 0, 0);
+      };
+
+      for (auto& renderData : m_RenderDataA)
+        Init(renderData);
+
+      for (auto& renderData : m_RenderDataB)
+        Init(renderData);
+    }
+
+    void Fill(ezExtractedRenderData& extractedData) const
+    {
+      // interleave the types and categories like several extractors would
+      for (ezUInt32 i = 0; i < m_RenderDataB.GetCount(); ++i)
+      {
+        if (i < m_RenderDataA.GetCount())
+        {
+          extractedData.AddRenderData(&m_RenderDataA[i], i % 4 == 0 ? ezDefaultRenderDataCategories::LitMasked : ezDefaultRenderDataCategories::LitOpaque);
+        }
+
+        extractedData.AddRenderData(&m_RenderDataB[i], i % 4 == 0 ? ezDefaultRenderDataCategories::LitTransparent : ezDefaultRenderDataCategories::LitOpaque);
+      }
+    }
+  };
+
+  ezCamera GetTestCamera()
+  {
+    ezCamera camera;
+    camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, 2000.0f);
+    camera.LookAt(ezVec3::ZeroVector(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+    return camera;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(RenderPipeline, SortAndBatch)
+{
+  const ezCamera camera = GetTestCamera();
+
+  const ezRenderData::Category categories[] = {
+    ezDefaultRenderDataCategories::LitOpaque, ezDefaultRenderDataCategories::LitMasked, ezDefaultRenderDataCategories::LitTransparent};
+
+  // once below and once above the sizes at which the radix sort and the parallel sort kick in
+  const ezUInt32 counts[] = {100, 20000};
+
+  for (ezUInt32 uiCount : counts)
+  {
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, uiCount < 1000 ? "Small" : "Large")
+    {
+      SortTestData testData;
+      testData.Create(uiCount, uiCount);
+
+      ezExtractedRenderData extractedData;
+      extractedData.SetCamera(camera);
+      testData.Fill(extractedData);
+      extractedData.SortAndBatch();
+
+      ezUInt32 uiNumRenderData = 0;
+
+      for (const ezRenderData::Category& category : categories)
+      {
+        ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+
+        ezUInt64 uiLastSortingKey = 0;
+        ezUInt32 uiLastBatchId = 0;
+
+        for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+        {
+          ezRenderDataBatch batch = batchList.GetBatch(uiBatch);
+          EZ_TEST_BOOL(batch.GetCount() > 0);
+
+          const ezRenderData* pFirst = batch.GetFirstData<ezRenderData>();
+
+          for (auto it = batch.GetIterator<ezRenderData>(); it.IsValid(); ++it)
+          {
+            const ezRenderData* pRenderData = it;
+
+            // all data in a batch shares the type and the batch id
+            EZ_TEST_BOOL(pRenderData->GetDynamicRTTI() == pFirst->GetDynamicRTTI());
+            EZ_TEST_INT(pRenderData->m_uiBatchId, pFirst->m_uiBatchId);
+
+            // the whole category is ordered by sorting key, then batch id
+            const ezUInt64 uiSortingKey = pRenderData->GetCategorySortingKey(category, camera);
+            EZ_TEST_BOOL(uiSortingKey > uiLastSortingKey || (uiSortingKey == uiLastSortingKey && pRenderData->m_uiBatchId >= uiLastBatchId));
+
+            uiLastSortingKey = uiSortingKey;
+            uiLastBatchId = pRenderData->m_uiBatchId;
+            ++uiNumRenderData;
+          }
+        }
+      }
+
+      EZ_TEST_INT(uiNumRenderData, uiCount);
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(RenderPipeline, Profile_SortAndBatch)
+{
+  EZ_TEST_BLOCK(ezTestBlock::EnableInRelease, "100k Render Data")
+  {
+    const ezUInt32 uiCount = 100000;
+    const ezUInt32 uiNumIterations = 10;
+
+    SortTestData testData;
+    testData.Create(uiCount, 42);
+
+    ezExtractedRenderData extractedData;
+    extractedData.SetCamera(GetTestCamera());
+
+    ezTime tAdd;
+    ezTime tSortAndBatch;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      extractedData.Clear();
+
+      ezStopwatch sw;
+      testData.Fill(extractedData);
+      tAdd += sw.Checkpoint();
+
+      extractedData.SortAndBatch();
+      tSortAndBatch += sw.Checkpoint();
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "AddRenderData (%u items): %.2fms", uiCount, tAdd.GetMilliseconds() / uiNumIterations);
+    ezTestFramework::Output(ezTestOutput::Duration, "SortAndBatch (%u items): %.2fms", uiCount, tSortAndBatch.GetMilliseconds() / uiNumIterations);
+  }
+}
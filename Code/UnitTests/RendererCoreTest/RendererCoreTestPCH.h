@@ -0,0 +1,13 @@
+#pragma once
+
+#include <TestFramework/Framework/TestFramework.h>
+
+#include <Foundation/Basics.h>
+#include <Foundation/Basics/Assert.h>
+#include <Foundation/Types/Types.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HybridArray.h>
+
+#include <Foundation/Strings/String.h>
+#include <Foundation/Strings/StringBuilder.h>
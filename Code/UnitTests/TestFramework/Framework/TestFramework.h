@@ -310,6 +310,13 @@ struct ezTestBlock
     Disabled,          ///< The test block will be skipped. The test framework will print a warning message, that some block is deactivated.
     DisabledNoWarning, ///< The test block will be skipped, but no warning printed. Used to deactivate 'on demand/optional' tests.
   };
+
+  /// \brief For performance tests that take too long in debug builds and only produce meaningful numbers in release builds.
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+  static constexpr Enum EnableInRelease = DisabledNoWarning;
+#else
+  static constexpr Enum EnableInRelease = Enabled;
+#endif
 };
 
 #define safeprintf ezStringUtils::snprintf